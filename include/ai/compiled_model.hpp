@@ -0,0 +1,103 @@
+#pragma once
+
+#include "../core/buffer_view.hpp"
+#include "../detection/protocol_detection.hpp"
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace protocol_parser::ai {
+
+// 单条特征向量的分类结果
+struct ModelPrediction {
+    uint16_t class_index = 0;
+    float score = 0.0f;        // 线性得分
+    float confidence = 0.0f;   // softmax 概率
+};
+
+/**
+ * 编译后的线性分类模型
+ * 固定特征数（detection::kMLFeatureCount），每类权重连续存放并补齐到 8 的倍数，
+ * 支持 float32 与 int8（每类一个反量化系数）两种权重，使用 AVX2 点积打分
+ *
+ * 二进制文件格式（小端序）：
+ *   u32 magic "PPML" | u16 version | u8 weight_type | u8 reserved
+ *   u16 feature_count | u16 class_count
+ *   class_count × (u8 name_len, name bytes)
+ *   f32 biases[class_count]
+ *   INT8:    f32 scales[class_count], i8 weights[class_count × feature_count]
+ *   FLOAT32: f32 weights[class_count × feature_count]
+ */
+class CompiledModel {
+public:
+    using FeatureVector = detection::MLFeatureVector;
+
+    static constexpr size_t kFeatureCount = detection::kMLFeatureCount;
+    static constexpr size_t kPaddedFeatureCount = (kFeatureCount + 7) / 8 * 8;
+    static constexpr size_t kMaxClasses = 256;
+    static constexpr size_t kBlockRows = 8;      // 批量打分每块行数（一个 AVX2 寄存器）
+    static constexpr uint32_t kFileMagic = 0x4C4D5050;  // "PPML"
+    static constexpr uint16_t kFileVersion = 1;
+
+    enum class WeightType : uint8_t {
+        FLOAT32 = 0,
+        INT8 = 1
+    };
+
+    CompiledModel() = default;
+
+    /**
+     * 由浮点权重构建模型
+     * @param class_names 类别名称
+     * @param biases 每类偏置
+     * @param weights 按类别行优先的权重，每类 kFeatureCount 个
+     * @param type 存储类型；INT8 时按每类最大绝对值对称量化
+     */
+    bool build(std::vector<std::string> class_names,
+               std::span<const float> biases,
+               std::span<const float> weights,
+               WeightType type);
+
+    // 加载紧凑二进制模型
+    bool load_from_buffer(const protocol_parser::core::BufferView& buffer);
+    bool load_from_file(const std::string& path);
+
+    // 序列化为二进制格式
+    [[nodiscard]] std::vector<uint8_t> serialize() const;
+
+    [[nodiscard]] bool empty() const noexcept { return class_count_ == 0; }
+    [[nodiscard]] size_t class_count() const noexcept { return class_count_; }
+    [[nodiscard]] WeightType weight_type() const noexcept { return weight_type_; }
+    [[nodiscard]] const std::string& class_name(size_t index) const noexcept;
+    [[nodiscard]] const std::string& get_error_message() const noexcept { return error_message_; }
+
+    // 单条分类
+    [[nodiscard]] ModelPrediction classify(const FeatureVector& features) const noexcept;
+
+    // 批量分类（AoS 输入，按 8 行转置成小块），输出 min(features.size(), out.size()) 条
+    void classify(std::span<const FeatureVector> features, std::span<ModelPrediction> out) const noexcept;
+
+    // 批量分类（SoA 输入，按 8 行一组向量化），输出 min(features.rows(), out.size()) 条
+    void classify(const detection::FeatureMatrix& features, std::span<ModelPrediction> out) const noexcept;
+
+private:
+    WeightType weight_type_ = WeightType::FLOAT32;
+    size_t class_count_ = 0;
+    std::vector<std::string> class_names_;
+    std::vector<float> biases_;
+    std::vector<float> scales_;           // INT8 反量化系数
+    std::vector<float> float_weights_;    // class_count × kPaddedFeatureCount
+    std::vector<int8_t> int8_weights_;    // class_count × kPaddedFeatureCount
+    std::string error_message_;
+
+    [[nodiscard]] float weight(size_t class_index, size_t feature) const noexcept;
+    [[nodiscard]] float dot(size_t class_index, const float* padded_features) const noexcept;
+    [[nodiscard]] ModelPrediction finalize(const float* scores) const noexcept;
+    // 特征 f 的第 lane 行位于 block[f * stride + lane]，stride 后至少有 8 个可读元素
+    void classify_block(const float* block, size_t stride, size_t lanes,
+                        ModelPrediction* out) const noexcept;
+    void clear() noexcept;
+};
+
+} // namespace protocol_parser::ai
@@ -1,11 +1,14 @@
 #pragma once
 
 #include "../core/buffer_view.hpp"
+#include "compiled_model.hpp"
 #include <vector>
 #include <string>
 #include <unordered_map>
 #include <chrono>
 #include <array>
+#include <span>
+#include <string_view>
 
 namespace protocol_parser::ai {
 
@@ -17,9 +20,13 @@ struct ClassificationResult {
     std::unordered_map<std::string, std::string> additional_info;
 };
 
+// 基础特征数（包大小、源/目的端口、熵、ASCII比例、前两字节）
+inline constexpr size_t kBasicFeatureCount = 7;
+using BasicFeatures = std::array<double, kBasicFeatureCount>;
+
 // 简化的协议统计信息
 struct ProtocolStats {
-    std::vector<double> feature_means;
+    BasicFeatures feature_means{};
     size_t sample_count = 0;
 };
 
@@ -39,6 +46,17 @@ public:
     
     // DGA检测
     bool is_suspicious_domain(const std::string& domain) const;
+    
+    // 编译模型：加载后 detect_protocol 会附加模型分类结果
+    bool load_model(const std::string& path);
+    void set_model(CompiledModel model);
+    [[nodiscard]] const CompiledModel& model() const noexcept { return model_; }
+    
+    // 批量模型分类（特征由 detection::MLFeatureExtractor 提取）
+    void classify(std::span<const CompiledModel::FeatureVector> features,
+                  std::span<ModelPrediction> out) const noexcept;
+    void classify(const detection::FeatureMatrix& features,
+                  std::span<ModelPrediction> out) const noexcept;
 
 private:
     // 基础配置
@@ -50,6 +68,10 @@ private:
     double smoothing_factor_;
     std::unordered_map<std::string, ProtocolStats> protocol_stats_;
     
+    // 编译模型与特征提取
+    CompiledModel model_;
+    detection::MLFeatureExtractor feature_extractor_;
+    
     // 协议模式和端口映射
     std::unordered_map<std::string, std::vector<std::string>> protocol_patterns_;
     std::unordered_map<uint16_t, std::string> port_mappings_;
@@ -59,12 +81,13 @@ private:
     void load_basic_signatures();
     
     // 特征提取
-    std::vector<double> extract_basic_features(
+    BasicFeatures extract_basic_features(
         const protocol_parser::core::BufferView& buffer,
         uint16_t src_port, uint16_t dst_port) const;
     
     // 分类方法
-    ClassificationResult classify_naive_bayes(const std::vector<double>& features) const;
+    ClassificationResult classify_naive_bayes(const BasicFeatures& features) const;
+    ClassificationResult classify_by_model(const protocol_parser::core::BufferView& buffer) const;
     ClassificationResult classify_by_port(uint16_t src_port, uint16_t dst_port) const;
     ClassificationResult classify_by_patterns(const protocol_parser::core::BufferView& buffer) const;
     
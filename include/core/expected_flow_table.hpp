@@ -0,0 +1,160 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace protocol_parser::core {
+
+/**
+ * 流端点地址：IPv6 地址，IPv4 使用 ::ffff:a.b.c.d 映射形式（与 SipMediaEndpoint、PassiveDNSAddress 一致）
+ * 全零为未指定地址
+ */
+struct FlowAddress {
+    std::array<uint8_t, 16> bytes{};
+
+    // IPv4 为主机字节序的数值（1.2.3.4 -> 0x01020304），0 得到未指定地址
+    [[nodiscard]] static FlowAddress from_ipv4(uint32_t address) noexcept;
+    [[nodiscard]] static FlowAddress from_ipv6(std::span<const uint8_t, 16> address) noexcept;
+    // 点分 IPv4 或 RFC 4291 文本形式的 IPv6（可带点分 IPv4 结尾）；0.0.0.0 得到未指定地址
+    [[nodiscard]] static bool from_text(std::string_view text, FlowAddress& out) noexcept;
+
+    [[nodiscard]] bool is_unspecified() const noexcept { return bytes == std::array<uint8_t, 16>{}; }
+    [[nodiscard]] bool operator==(const FlowAddress& other) const noexcept = default;
+};
+
+/**
+ * 控制连接预告的一条数据连接（FTP PORT/PASV、SIP/SDP、H.245 等）
+ * 端点为连接将到达的一端，peer 为另一端的约束，未指定地址或端口 0 表示任意
+ */
+struct ExpectedFlow {
+    std::string_view protocol;       // 协议名，须指向静态存储（如 "FTP-DATA"）
+    uint64_t session = 0;            // 所属控制会话，由调用方定义
+    FlowAddress address;
+    uint16_t port = 0;
+    bool is_tcp = true;
+    FlowAddress peer;
+    uint16_t peer_port = 0;
+    uint64_t timeout_us = 0;         // 0 表示使用 Config::expect_timeout_us
+};
+
+struct ExpectedFlowMatch {
+    std::string_view protocol;
+    uint64_t session = 0;
+    bool to_endpoint = true;         // 目的端点命中；false 表示按源端点（反方向的包）命中
+    bool first = false;              // 本次命中把预期绑定到了具体的连接
+};
+
+/**
+ * 预期流表：控制信道登记即将出现的数据连接，检测器在特征与行为分析之前直接识别
+ *
+ * - 每个端点（地址、端口、TCP/UDP）至多一条预期，再次登记替换原有预期
+ * - 首个命中的连接把预期绑定为该连接的五元组，此后只有这条连接（两个方向）继续命中，
+ *   空闲超过 idle_timeout_us 过期；未被使用的预期在 timeout_us 后过期
+ * - 固定容量的开放寻址表（线性探测、后移删除），负载上限 3/4；
+ *   每次登记顺带清扫 sweep_step 个槽，expire() 做一次完整清扫
+ * 时间戳由调用方提供（抓包时间，微秒）；now() 为最近一次传入的时间
+ * 控制信道与检测可能在不同线程，各操作由内部互斥量串行化
+ */
+class ExpectedFlowTable {
+public:
+    struct Config {
+        size_t capacity = 16384;                 // 槽位，向上取整为 2 的幂
+        uint64_t expect_timeout_us = 60'000'000;
+        uint64_t idle_timeout_us = 300'000'000;
+        size_t sweep_step = 8;
+    };
+
+    struct Statistics {
+        uint64_t expectations = 0;
+        uint64_t replaced = 0;                   // 同一端点的预期被重新登记
+        uint64_t bound = 0;                      // 预期被连接使用
+        uint64_t hits = 0;
+        uint64_t expired = 0;
+        uint64_t dropped = 0;                    // 表满，未能登记
+    };
+
+    ExpectedFlowTable();
+    explicit ExpectedFlowTable(const Config& config);
+
+    /**
+     * 登记一条预期
+     * @return 表满或端点无效时返回 false
+     */
+    bool expect(const ExpectedFlow& flow, uint64_t now_us) noexcept;
+
+    /**
+     * 按目的端点、再按源端点查找预期，命中时绑定或刷新
+     */
+    bool match(const FlowAddress& src, const FlowAddress& dst, uint16_t src_port, uint16_t dst_port, bool is_tcp,
+               uint64_t now_us, ExpectedFlowMatch& out) noexcept;
+
+    // 只查找，不绑定也不刷新
+    [[nodiscard]] bool lookup(const FlowAddress& src, const FlowAddress& dst, uint16_t src_port, uint16_t dst_port,
+                              bool is_tcp, uint64_t now_us, ExpectedFlowMatch& out) const noexcept;
+
+    // 控制会话结束时撤销它的全部预期，返回撤销的条数
+    size_t erase_session(uint64_t session) noexcept;
+
+    // 撤销端点上属于 session 的预期；端点已被其它会话重新登记时保持不动
+    bool erase_endpoint(const FlowAddress& address, uint16_t port, bool is_tcp, uint64_t session) noexcept;
+
+    void advance(uint64_t now_us) noexcept;
+    [[nodiscard]] uint64_t now() const noexcept;
+
+    void expire(uint64_t now_us) noexcept;
+
+    [[nodiscard]] size_t size() const noexcept;
+    [[nodiscard]] Statistics statistics() const noexcept;
+
+    void clear() noexcept;
+
+private:
+    struct Slot {
+        uint64_t hash = 0;
+        FlowAddress address;
+        FlowAddress peer;
+        uint64_t session = 0;
+        uint64_t expires_us = 0;
+        std::string_view protocol;
+        uint16_t port = 0;
+        uint16_t peer_port = 0;
+        bool is_tcp = false;
+        bool bound = false;
+        bool occupied = false;
+    };
+
+    Config config_;
+    mutable std::mutex mutex_;
+    std::vector<Slot> slots_;
+    size_t mask_ = 0;
+    size_t size_ = 0;
+    size_t sweep_cursor_ = 0;
+    uint64_t now_us_ = 0;
+
+    Statistics stats_;
+
+    [[nodiscard]] static uint64_t hash_endpoint(const FlowAddress& address, uint16_t port, bool is_tcp) noexcept;
+    // 以下在持有 mutex_ 时调用
+    void advance_locked(uint64_t now_us) noexcept {
+        if (now_us > now_us_) {
+            now_us_ = now_us;
+        }
+    }
+    [[nodiscard]] bool lookup_locked(const FlowAddress& src, const FlowAddress& dst, uint16_t src_port,
+                                     uint16_t dst_port, bool is_tcp, uint64_t now_us, ExpectedFlowMatch& out,
+                                     size_t& index) const noexcept;
+    // slots_.size() 表示不存在
+    [[nodiscard]] size_t find(const FlowAddress& address, uint16_t port, bool is_tcp, uint64_t hash) const noexcept;
+    // 端点的预期对另一端 (peer, peer_port) 有效时返回槽下标
+    [[nodiscard]] size_t find_valid(const FlowAddress& address, uint16_t port, bool is_tcp,
+                                    const FlowAddress& peer, uint16_t peer_port, uint64_t now_us) const noexcept;
+    void erase(size_t index) noexcept;
+    void sweep(uint64_t now_us, size_t budget) noexcept;
+};
+
+} // namespace protocol_parser::core
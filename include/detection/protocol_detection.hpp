@@ -1,6 +1,7 @@
 #pragma once
 
 #include "core/buffer_view.hpp"
+#include "core/expected_flow_table.hpp"
 #include <vector>
 #include <string>
 #include <unordered_map>
@@ -14,6 +15,16 @@
 #include <chrono>
 #include <mutex>
 #include <shared_mutex>
+#include <atomic>
+
+namespace protocol_parser::ai {
+class CompiledModel;
+}
+
+namespace protocol_parser::parsers {
+class PassiveDNSCache;
+struct PassiveDNSAddress;
+}
 
 namespace protocol_parser::detection {
 
@@ -35,6 +46,8 @@ struct DetectionResult {
     std::string detection_method;  // 检测方法描述
     std::vector<std::string> evidence;  // 检测证据
     size_t bytes_analyzed{0};
+    std::string server_name;            // 被动 DNS 得到的服务端域名（未命中为空）
+    uint64_t related_session{0};        // 预期流命中时所属的控制会话（0 表示无）
     
     [[nodiscard]] bool is_reliable() const noexcept {
         return confidence >= ConfidenceLevel::HIGH;
@@ -45,6 +58,15 @@ struct DetectionResult {
     }
 };
 
+// 流的五元组（IPv4 使用映射地址，见 core::FlowAddress::from_ipv4）
+struct FlowTuple {
+    protocol_parser::core::FlowAddress src;
+    protocol_parser::core::FlowAddress dst;
+    uint16_t src_port{0};
+    uint16_t dst_port{0};
+    bool is_tcp{true};
+};
+
 // 协议签名匹配器
 class ProtocolSignature {
 public:
@@ -69,6 +91,29 @@ public:
     explicit ProtocolSignature(std::string name) : protocol_name(std::move(name)) {}
     
     [[nodiscard]] double calculate_match_score(const protocol_parser::core::BufferView& buffer) const noexcept;
+    
+    // 仅按各模式的固定偏移匹配（不搜索），开销远低于 calculate_match_score
+    [[nodiscard]] double calculate_anchored_score(const protocol_parser::core::BufferView& buffer) const noexcept;
+};
+
+// 检测流水线阶段（按开销从低到高排列）
+enum class DetectionStage : uint8_t {
+    PORT = 0,              // 端口映射
+    ANCHORED_SIGNATURE,    // 固定偏移签名
+    MULTI_PATTERN,         // 签名模式搜索
+    HEURISTIC,             // 统计启发式
+    DEEP_INSPECTION,       // DPI 正则/状态机
+    ML_MODEL,              // 编译模型分类
+    COUNT
+};
+
+inline constexpr size_t kDetectionStageCount = static_cast<size_t>(DetectionStage::COUNT);
+
+// 流级 CPU 预算（周期），由调用方随流保存并在每个包检测时传入
+struct DetectionBudget {
+    uint64_t remaining_cycles{UINT64_MAX};
+    
+    [[nodiscard]] bool exhausted() const noexcept { return remaining_cycles == 0; }
 };
 
 // 端口基础的检测器
@@ -93,18 +138,25 @@ public:
     struct PacketFeatures {
         size_t packet_size{0};
         double entropy{0.0};                    // 数据熵
-        std::array<uint8_t, 256> byte_frequency{};  // 字节频率分布
+        std::array<uint32_t, 256> byte_frequency{};  // 字节频率分布
         size_t printable_chars{0};             // 可打印字符数量
         size_t null_bytes{0};                  // 空字节数量
+        size_t control_chars{0};               // 控制字符数量
         size_t consecutive_zeros{0};           // 连续零字节
         bool has_common_headers{false};        // 是否有常见头部
-        std::vector<std::string> detected_strings;  // 检测到的字符串
+        std::vector<std::string> detected_strings;  // 检测到的字符串（需显式启用）
     };
     
     [[nodiscard]] PacketFeatures extract_features(const protocol_parser::core::BufferView& buffer) const noexcept;
     [[nodiscard]] std::vector<DetectionResult> detect_by_heuristics(const PacketFeatures& features) const noexcept;
     
+    // 字符串提取会分配内存，默认关闭
+    void set_string_extraction(bool enabled) noexcept { extract_strings_enabled_ = enabled; }
+    [[nodiscard]] bool string_extraction_enabled() const noexcept { return extract_strings_enabled_; }
+    
 private:
+    bool extract_strings_enabled_{false};
+    
     [[nodiscard]] double calculate_entropy(const uint8_t* data, size_t size) const noexcept;
     [[nodiscard]] bool is_likely_text_protocol(const PacketFeatures& features) const noexcept;
     [[nodiscard]] bool is_likely_binary_protocol(const PacketFeatures& features) const noexcept;
@@ -152,7 +204,78 @@ private:
     [[nodiscard]] bool match_regex_patterns(const std::vector<std::regex>& patterns, const protocol_parser::core::BufferView& buffer) const noexcept;
 };
 
-// 机器学习特征提取器 (为未来ML集成做准备)
+// 机器学习特征布局（固定长度，数值大致归一化到 [0, 1]）
+enum class MLFeatureIndex : size_t {
+    ENTROPY = 0,            // 字节熵 / 8
+    COMPRESSION_RATIO,      // LZ 匹配估算的压缩比（估算压缩大小 / 原始大小）
+    PRINTABLE_RATIO,        // 可打印 ASCII 占比
+    NULL_RATIO,             // 0x00 占比
+    CONTROL_RATIO,          // 控制字符占比
+    HIGH_BYTE_RATIO,        // >= 0x80 占比
+    ZERO_RUN_RATIO,         // 最长零字节游程 / 总字节数
+    HEADER_LIKE_RATIO,      // 含头部分隔符的包占比
+    LENGTH_FIELDS,          // 平均每包长度字段候选数 / 4
+    CHECKSUM_RATIO,         // 含校验和特征的包占比
+    STRUCTURED_RATIO,       // 以 JSON/XML/BER 起始的包占比
+    BINARY_RATIO,           // 空字节占比超过 10% 的包占比
+    PACKET_COUNT,           // log2(1 + 包数) / 16
+    MEAN_SIZE,              // 平均包长 / 1500
+    STDDEV_SIZE,            // 包长标准差 / 1500
+    MIN_SIZE,               // 最小包长 / 1500
+    MAX_SIZE,               // 最大包长 / 1500
+    FIRST_SIZE_0,           // 前 4 个包的包长 / 1500
+    FIRST_SIZE_1,
+    FIRST_SIZE_2,
+    FIRST_SIZE_3,
+    BYTE_BIN_0,             // 8 段字节分布（按高 3 位分段）
+    BYTE_BIN_1,
+    BYTE_BIN_2,
+    BYTE_BIN_3,
+    BYTE_BIN_4,
+    BYTE_BIN_5,
+    BYTE_BIN_6,
+    BYTE_BIN_7,
+    LEADING_BYTE_0,         // 首包前 4 字节 / 255
+    LEADING_BYTE_1,
+    LEADING_BYTE_2,
+    LEADING_BYTE_3,
+    COUNT
+};
+
+inline constexpr size_t kMLFeatureCount = static_cast<size_t>(MLFeatureIndex::COUNT);
+using MLFeatureVector = std::array<float, kMLFeatureCount>;
+
+/**
+ * 稠密特征矩阵（SoA 布局）
+ * 每个特征一列连续存储，行数补齐到 kRowAlignment 的倍数便于 SIMD 批量计算；
+ * 第 r 行即第 r 条流的固定长度特征向量
+ */
+class FeatureMatrix {
+public:
+    static constexpr size_t kRowAlignment = 8;
+    
+    FeatureMatrix() = default;
+    explicit FeatureMatrix(size_t rows) { resize(rows); }
+    
+    // 调整行数并清零；容量足够时不重新分配
+    void resize(size_t rows);
+    
+    [[nodiscard]] size_t rows() const noexcept { return rows_; }
+    [[nodiscard]] size_t stride() const noexcept { return stride_; }
+    [[nodiscard]] static constexpr size_t columns() noexcept { return kMLFeatureCount; }
+    
+    [[nodiscard]] float* column(size_t feature) noexcept { return data_.data() + feature * stride_; }
+    [[nodiscard]] const float* column(size_t feature) const noexcept { return data_.data() + feature * stride_; }
+    [[nodiscard]] float at(size_t row, size_t feature) const noexcept { return data_[feature * stride_ + row]; }
+    [[nodiscard]] MLFeatureVector row(size_t row) const noexcept;
+    
+private:
+    std::vector<float> data_;
+    size_t rows_{0};
+    size_t stride_{0};
+};
+
+// 机器学习特征提取器
 class MLFeatureExtractor {
 public:
     struct MLFeatures {
@@ -174,14 +297,35 @@ public:
         size_t ascii_percentage{0};
         size_t binary_patterns{0};
         size_t structured_data_indicators{0};
+        size_t longest_zero_run{0};
+        std::array<uint8_t, 4> leading_bytes{};
     };
     
     [[nodiscard]] MLFeatures extract_features(const std::vector<protocol_parser::core::BufferView>& packet_sequence) const noexcept;
     
-    // 特征向量转换 (为ML算法准备)
+    // 特征向量转换 (为ML算法准备)，长度为 kMLFeatureCount
     [[nodiscard]] std::vector<double> to_feature_vector(const MLFeatures& features) const noexcept;
     
+    // 无分配快速路径：一条流直接写入固定长度特征向量
+    void extract_feature_vector(std::span<const protocol_parser::core::BufferView> packets,
+                                MLFeatureVector& out) const noexcept;
+    
+    // 批量：每条流一行
+    [[nodiscard]] bool extract_batch(std::span<const std::vector<protocol_parser::core::BufferView>> flows,
+                                     FeatureMatrix& out) const noexcept;
+    
+    // 批量：每个数据包视为单包流，一包一行
+    [[nodiscard]] bool extract_batch(std::span<const protocol_parser::core::BufferView> packets,
+                                     FeatureMatrix& out) const noexcept;
+    
 private:
+    struct FlowSummary;
+    
+    void summarize_flow(std::span<const protocol_parser::core::BufferView> packets,
+                        FlowSummary& summary,
+                        std::array<double, 256>* normalized_frequency) const noexcept;
+    static void write_features(const FlowSummary& summary, float* out, size_t stride) noexcept;
+    
     [[nodiscard]] double calculate_compression_ratio(const protocol_parser::core::BufferView& buffer) const noexcept;
     [[nodiscard]] size_t detect_length_fields(const protocol_parser::core::BufferView& buffer) const noexcept;
     [[nodiscard]] size_t detect_checksum_patterns(const protocol_parser::core::BufferView& buffer) const noexcept;
@@ -204,7 +348,17 @@ public:
     [[nodiscard]] DetectionResult detect_protocol_with_ports(const protocol_parser::core::BufferView& buffer, 
                                                            uint16_t src_port, uint16_t dst_port) const noexcept;
     
-    // 批量检测
+    /**
+     * 分阶段检测：按 DetectionStage 顺序执行已启用的检测器，
+     * 合并置信度达到 early_exit_confidence 即提前结束；
+     * 预计开销超出单包/流预算或超过 detection_timeout 的阶段将被跳过
+     * @param flow_budget 可选的流级预算，检测后扣除实际消耗的周期
+     */
+    [[nodiscard]] DetectionResult detect_protocol_staged(const protocol_parser::core::BufferView& buffer,
+                                                         uint16_t src_port, uint16_t dst_port,
+                                                         DetectionBudget* flow_budget = nullptr) const noexcept;
+    
+    // 批量检测（在常驻线程池上按 batch_worker_threads 并行，结果顺序与输入一致）
     [[nodiscard]] std::vector<DetectionResult> detect_multiple(std::span<const protocol_parser::core::BufferView> buffers) const noexcept;
     
     // 流级别检测
@@ -212,6 +366,37 @@ public:
                                                       const std::vector<protocol_parser::core::BufferView>& packets,
                                                       uint16_t src_port, uint16_t dst_port) const;
     
+    /**
+     * 同上，并用被动 DNS 缓存为结果标注服务端域名（无需解析载荷）
+     * @param now_us 与写入缓存时一致的时间基准（微秒）
+     */
+    [[nodiscard]] DetectionResult detect_flow_protocol(const std::string& flow_id,
+                                                      const std::vector<protocol_parser::core::BufferView>& packets,
+                                                      uint16_t src_port, uint16_t dst_port,
+                                                      uint32_t server_ip, uint64_t now_us) const;
+    
+    /**
+     * 先查预期流表：控制信道已预告的连接直接给出结果，不执行特征与行为检测；
+     * 未命中时按目的地址标注服务端域名，与上一重载相同
+     */
+    [[nodiscard]] DetectionResult detect_flow_protocol(const std::string& flow_id,
+                                                      const std::vector<protocol_parser::core::BufferView>& packets,
+                                                      const FlowTuple& tuple, uint64_t now_us) const;
+    
+    // 同上，服务端为 IPv6（或 IPv4 映射）地址
+    [[nodiscard]] DetectionResult detect_flow_protocol(const std::string& flow_id,
+                                                      const std::vector<protocol_parser::core::BufferView>& packets,
+                                                      uint16_t src_port, uint16_t dst_port,
+                                                      const parsers::PassiveDNSAddress& server, uint64_t now_us) const;
+    
+    // 按服务端 IPv4（主机字节序）查询被动 DNS 缓存并写入 server_name，命中返回 true
+    bool tag_server_name(DetectionResult& result, uint32_t server_ip, uint64_t now_us) const noexcept;
+    // 同上，按 IPv6 地址查询（缓存同时保存 AAAA 应答）
+    bool tag_server_name(DetectionResult& result, const parsers::PassiveDNSAddress& server, uint64_t now_us) const noexcept;
+    
+    // 在预期流表中查找该连接，命中时写入结果并绑定预期，返回 true
+    bool detect_expected_flow(const FlowTuple& tuple, uint64_t now_us, DetectionResult& result) const noexcept;
+    
     // 配置和管理
     void add_signature(const ProtocolSignature& signature);
     void remove_signature(const std::string& protocol_name);
@@ -219,22 +404,45 @@ public:
     void enable_detector(const std::string& detector_name);
     void disable_detector(const std::string& detector_name);
     
+    // ML 阶段使用的编译模型（为空时跳过该阶段）
+    void set_ml_model(std::shared_ptr<const ai::CompiledModel> model);
+    
+    // 流标注使用的被动 DNS 缓存（为空时不标注）
+    void set_passive_dns(std::shared_ptr<const parsers::PassiveDNSCache> cache);
+    
+    // 控制信道登记数据连接的预期流表（FTPParser、SipDialogTable 写入；为空时不查询）
+    void set_expected_flows(std::shared_ptr<protocol_parser::core::ExpectedFlowTable> table);
+    
     // 检测策略配置
     struct DetectionConfig {
         bool use_port_based{true};
         bool use_signature_based{true};
         bool use_heuristic_based{true};
         bool use_deep_inspection{true};
+        bool use_ml_model{true};
         bool enable_flow_analysis{false};
         double min_confidence_threshold{0.3};
+        double early_exit_confidence{0.95};       // 合并置信度达到该值后不再执行后续阶段
+        uint64_t packet_cycle_budget{0};          // 单包 CPU 预算（周期），0 表示不限
+        uint64_t flow_cycle_budget{0};            // 单流 CPU 预算（周期），0 表示不限
         size_t max_signatures_per_protocol{10};
         std::chrono::milliseconds detection_timeout{100};
+        size_t batch_worker_threads{0};           // 批量检测线程数（含调用线程），0 表示使用硬件并发数；
+                                                  // 线程在首次批量检测时创建并常驻，configure() 改变该值时重建
+        size_t batch_chunk_size{256};             // 工作线程每次领取的缓冲区数量
     };
     
     void configure(const DetectionConfig& config);
     [[nodiscard]] DetectionConfig get_configuration() const noexcept;
     
     // 性能和统计
+    struct StageStatistics {
+        uint64_t invocations{0};      // 执行次数
+        uint64_t hits{0};             // 产生候选结果的次数
+        uint64_t skipped{0};          // 因预算/超时跳过的次数
+        uint64_t cycles{0};           // 累计消耗周期
+    };
+    
     struct DetectionStatistics {
         uint64_t total_detections{0};
         uint64_t successful_detections{0};
@@ -242,6 +450,11 @@ public:
         uint64_t signature_based_detections{0};
         uint64_t heuristic_detections{0};
         uint64_t deep_inspection_detections{0};
+        uint64_t ml_detections{0};
+        uint64_t expected_flow_detections{0};    // 由预期流表直接识别
+        uint64_t early_exits{0};                 // 达到提前退出置信度的检测次数
+        uint64_t budget_exhausted{0};            // 因预算/超时跳过阶段的检测次数
+        std::array<StageStatistics, kDetectionStageCount> stage_statistics{};
         std::unordered_map<std::string, uint64_t> protocol_detection_count;
         std::chrono::nanoseconds total_detection_time{0};
         std::chrono::nanoseconds avg_detection_time{0};
@@ -275,14 +488,43 @@ private:
     std::unique_ptr<DeepPacketInspector> deep_inspector_;
     std::unique_ptr<MLFeatureExtractor> ml_extractor_;
     
-    // 签名数据库
-    std::unordered_map<std::string, ProtocolSignature> signatures_;
-    mutable std::shared_mutex signatures_mutex_;
+    // 签名数据库（写时复制：读者原子地获取快照，写者串行替换）
+    using SignatureTable = std::unordered_map<std::string, ProtocolSignature>;
+    std::atomic<std::shared_ptr<const SignatureTable>> signatures_;
+    mutable std::mutex signatures_write_mutex_;
     
-    // 配置和状态
+    // 配置
     DetectionConfig config_;
-    mutable DetectionStatistics statistics_;
-    mutable std::mutex stats_mutex_;
+    
+    // 统计分片：每个线程固定写入一个分片，读取时合并
+    static constexpr size_t kStatisticsShardCount = 64;
+    struct alignas(64) StatisticsShard {
+        std::mutex mutex;
+        DetectionStatistics statistics;
+    };
+    std::unique_ptr<StatisticsShard[]> statistics_shards_;
+    
+    // ML 阶段模型
+    std::atomic<std::shared_ptr<const ai::CompiledModel>> ml_model_;
+    
+    // 被动 DNS 缓存（读者无锁，写入由 DNS 解析侧完成）
+    std::atomic<std::shared_ptr<const parsers::PassiveDNSCache>> passive_dns_;
+    
+    // 预期流表（命中时绑定预期，故为可写；表内部加锁）
+    std::atomic<std::shared_ptr<protocol_parser::core::ExpectedFlowTable>> expected_flows_;
+    
+    // detect_multiple 的常驻工作线程（按需创建；调用方持有引用，重建时旧线程池在批次结束后释放）
+    class BatchWorkerPool;
+    mutable std::mutex batch_pool_mutex_;
+    mutable std::shared_ptr<BatchWorkerPool> batch_pool_;
+    mutable size_t batch_pool_threads_{0};       // batch_pool_ 对应的线程数（含调用线程），受 batch_pool_mutex_ 保护
+    
+    // 单次检测的阶段记录
+    struct PipelineTrace {
+        std::array<StageStatistics, kDetectionStageCount> stages{};
+        bool early_exit{false};
+        bool budget_exhausted{false};
+    };
     
     // 内部方法
     [[nodiscard]] DetectionResult combine_results(const std::vector<DetectionResult>& results) const noexcept;
@@ -290,7 +532,26 @@ private:
     [[nodiscard]] std::string select_best_protocol(const std::vector<DetectionResult>& results) const noexcept;
 
 private:
-    void update_statistics(const DetectionResult& result, std::chrono::nanoseconds detection_time) const noexcept;
+    // 一次调用内使用的签名表与模型：每个 detect_* 入口只原子加载一次，逐包、逐阶段直接引用
+    struct DetectionSnapshot {
+        std::shared_ptr<const SignatureTable> signatures;
+        std::shared_ptr<const ai::CompiledModel> model;
+    };
+    
+    [[nodiscard]] DetectionSnapshot load_snapshot() const noexcept;
+    // 取得与当前 batch_worker_threads 匹配的线程池（按需创建或重建）
+    [[nodiscard]] std::shared_ptr<BatchWorkerPool> acquire_batch_pool() const noexcept;
+    [[nodiscard]] DetectionResult detect_staged(const protocol_parser::core::BufferView& buffer,
+                                                uint16_t src_port, uint16_t dst_port, DetectionBudget* flow_budget,
+                                                const DetectionSnapshot& snapshot) const noexcept;
+    void update_statistics(const DetectionResult& result, std::chrono::nanoseconds detection_time,
+                           const PipelineTrace& trace) const noexcept;
+    [[nodiscard]] bool stage_enabled(DetectionStage stage, uint16_t src_port, uint16_t dst_port,
+                                     const ai::CompiledModel* model) const noexcept;
+    void run_stage(DetectionStage stage, const protocol_parser::core::BufferView& buffer,
+                   uint16_t src_port, uint16_t dst_port, const DetectionSnapshot& snapshot,
+                   std::vector<DetectionResult>& results) const;
+    [[nodiscard]] StatisticsShard& local_statistics_shard() const noexcept;
     void initialize_builtin_signatures();
 };
 
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "core/buffer_view.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <span>
+
+namespace protocol_parser::parsers {
+
+/**
+ * 一个 BER TLV：value 不含标签与长度字节，encoded 包含
+ */
+struct BERElement {
+    uint8_t tag = 0;
+    std::span<const uint8_t> value;
+    std::span<const uint8_t> encoded;
+
+    [[nodiscard]] bool is_constructed() const noexcept { return (tag & 0x20) != 0; }
+};
+
+/**
+ * BER/DER 元素遍历器（X.690），零拷贝
+ *
+ * - 只接受单字节标签与定长编码（SNMP 与 DER 均不使用多字节标签和不定长）
+ * - 长度字段的短/长格式用掩码选择，剩余字节足够时整段一次读出，不按字节循环
+ * - next() 从前端取出一个元素；构造类型的子元素用 BERWalker(element.value) 继续遍历
+ * - 也可用于 range-for：for (const BERElement& e : BERWalker(view))，遇到错误即停止，
+ *   之后可检查 failed()
+ */
+class BERWalker {
+public:
+    static constexpr uint8_t kInteger = 0x02;
+    static constexpr uint8_t kOctetString = 0x04;
+    static constexpr uint8_t kNull = 0x05;
+    static constexpr uint8_t kOID = 0x06;
+    static constexpr uint8_t kSequence = 0x30;
+
+    BERWalker() noexcept = default;
+    explicit BERWalker(std::span<const uint8_t> input) noexcept : input_(input) {}
+    explicit BERWalker(const core::BufferView& input) noexcept : input_(input.data(), input.size()) {}
+
+    /**
+     * 读取下一个元素
+     * @return 已到末尾或编码错误时返回 false（错误时 failed() 为 true，之后不再前进）
+     */
+    bool next(BERElement& out) noexcept;
+
+    // 读取下一个元素并要求其标签
+    bool expect(uint8_t tag, BERElement& out) noexcept {
+        return next(out) && out.tag == tag;
+    }
+
+    [[nodiscard]] bool at_end() const noexcept { return input_.empty(); }
+    [[nodiscard]] bool failed() const noexcept { return failed_; }
+    [[nodiscard]] std::span<const uint8_t> remaining() const noexcept { return input_; }
+
+    class iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = BERElement;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() noexcept = default;
+        explicit iterator(BERWalker* walker) noexcept : walker_(walker) { ++*this; }
+
+        const BERElement& operator*() const noexcept { return current_; }
+        const BERElement* operator->() const noexcept { return &current_; }
+        iterator& operator++() noexcept {
+            if (walker_ != nullptr && !walker_->next(current_)) {
+                walker_ = nullptr;
+            }
+            return *this;
+        }
+        void operator++(int) noexcept { ++*this; }
+        bool operator==(std::default_sentinel_t) const noexcept { return walker_ == nullptr; }
+
+    private:
+        BERWalker* walker_ = nullptr;
+        BERElement current_;
+    };
+
+    [[nodiscard]] iterator begin() noexcept { return iterator(this); }
+    [[nodiscard]] std::default_sentinel_t end() const noexcept { return {}; }
+
+    // 二进制补码整数，最多 8 字节
+    [[nodiscard]] static bool decode_integer(std::span<const uint8_t> value, int64_t& out) noexcept;
+    // 无符号整数（Counter64 等），允许 9 字节且首字节为 0
+    [[nodiscard]] static bool decode_unsigned(std::span<const uint8_t> value, uint64_t& out) noexcept;
+
+private:
+    std::span<const uint8_t> input_;
+    bool failed_ = false;
+};
+
+} // namespace protocol_parser::parsers
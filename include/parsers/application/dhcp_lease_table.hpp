@@ -0,0 +1,113 @@
+#pragma once
+
+#include "parsers/application/dhcp_parser.hpp"
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace ProtocolParser::Parsers::Application {
+
+/**
+ * 一条租约：MAC <-> IP <-> 主机名
+ */
+struct DHCPLease {
+    static constexpr size_t kMaxHostname = 31;
+
+    uint64_t mac = 0;                        // 48 位 MAC，首字节在高位
+    uint32_t ip = 0;                         // 主机字节序，0 表示尚未绑定地址
+    uint32_t server = 0;                     // 分配该租约的服务器标识（选项 54）
+    uint64_t expires_us = 0;                 // UINT64_MAX 表示无限期
+    uint64_t last_seen_us = 0;
+    std::array<char, kMaxHostname> hostname{};   // 超长时截断
+    uint8_t hostname_length = 0;
+
+    [[nodiscard]] std::string_view get_hostname() const noexcept {
+        return {hostname.data(), hostname_length};
+    }
+};
+
+static_assert(sizeof(DHCPLease) == 64, "DHCPLease 应占一条缓存行");
+
+/**
+ * DHCP 租约表：由 DHCP 报文学习 MAC、IP 与主机名的对应关系，供其它子系统为流补充终端信息
+ *
+ * - 租约存放在定长槽中，MAC 索引与 IP 索引为两张开放寻址表（线性探测、后移删除），负载不超过 1/2
+ * - 客户端的 DISCOVER/REQUEST 登记 MAC 与主机名（选项 12，缺省时取选项 81 的 FQDN），
+ *   ACK 按 yiaddr 与租期（选项 51）绑定地址；INFORM 的 ACK 绑定 ciaddr，租期取 inform_lease_us
+ * - RELEASE、DECLINE、NAK 解除绑定；地址被另一 MAC 取得时从原租约上摘除
+ * - 租约到期或未绑定地址的条目空闲超过 pending_timeout_us 即过期；
+ *   每次观察顺带清扫 sweep_step 个槽，expire() 做一次完整清扫
+ * 只跟踪硬件地址长度为 6 的客户端；时间戳由调用方提供（抓包时间，微秒）
+ */
+class DHCPLeaseTable {
+public:
+    struct Config {
+        size_t max_leases = 65536;
+        uint64_t pending_timeout_us = 300'000'000;
+        uint64_t inform_lease_us = 3'600'000'000;
+        size_t sweep_step = 8;
+    };
+
+    struct Statistics {
+        uint64_t leases_bound = 0;
+        uint64_t leases_renewed = 0;
+        uint64_t leases_released = 0;        // RELEASE、DECLINE、NAK
+        uint64_t leases_expired = 0;
+        uint64_t address_moves = 0;          // 地址改由另一 MAC 持有
+        uint64_t hostnames_learned = 0;
+        uint64_t dropped = 0;                // 表满，未能登记
+    };
+
+    DHCPLeaseTable();
+    explicit DHCPLeaseTable(const Config& config);
+
+    /**
+     * 处理一条已解析的 DHCP 报文
+     * @return 报文改变了租约表时返回 true
+     */
+    bool observe(const DHCPMessage& message, uint64_t now_us);
+
+    // 已到期的租约视为不存在
+    [[nodiscard]] const DHCPLease* find_by_ip(uint32_t ip, uint64_t now_us) const noexcept;
+    [[nodiscard]] const DHCPLease* find_by_mac(uint64_t mac) const noexcept;
+
+    // 报文头部中的客户端 MAC；硬件地址长度不为 6 时返回 0
+    [[nodiscard]] static uint64_t mac_key(const DHCPHeader& header) noexcept;
+
+    void expire(uint64_t now_us);
+
+    [[nodiscard]] size_t size() const noexcept { return size_; }
+    [[nodiscard]] const Statistics& statistics() const noexcept { return stats_; }
+
+    void clear();
+
+private:
+    static constexpr uint32_t kEmpty = UINT32_MAX;
+
+    Config config_;
+    std::vector<DHCPLease> leases_;          // mac == 0 的槽空闲
+    std::vector<uint32_t> free_;
+    std::vector<uint32_t> by_mac_;           // 租约下标
+    std::vector<uint32_t> by_ip_;
+    size_t mask_ = 0;
+    size_t size_ = 0;
+    size_t sweep_cursor_ = 0;
+
+    Statistics stats_;
+
+    [[nodiscard]] size_t find_mac(uint64_t mac) const noexcept;     // by_mac_.size() 表示不存在
+    [[nodiscard]] size_t find_ip(uint32_t ip) const noexcept;       // by_ip_.size() 表示不存在
+    void insert(std::vector<uint32_t>& table, uint64_t hash, uint32_t lease) noexcept;
+    template <typename Key>
+    void erase(std::vector<uint32_t>& table, size_t index, Key key) noexcept;
+
+    [[nodiscard]] uint32_t acquire(uint64_t mac, uint64_t now_us);
+    void bind(uint32_t index, uint32_t ip, uint64_t expires_us);
+    void unbind(uint32_t index) noexcept;
+    void remove(uint32_t index) noexcept;
+    [[nodiscard]] bool is_expired(const DHCPLease& lease, uint64_t now_us) const noexcept;
+    void sweep(uint64_t now_us, size_t budget);
+};
+
+} // namespace ProtocolParser::Parsers::Application
@@ -6,6 +6,8 @@
 #include <vector>
 #include <optional>
 #include <array>
+#include <bit>
+#include <span>
 #include <string_view>
 
 using namespace protocol_parser::parsers;
@@ -166,6 +168,77 @@ struct DHCPOption {
     [[nodiscard]] std::vector<uint32_t> as_ip_list() const;
 };
 
+/**
+ * DHCP 选项偏移索引：按选项码记录选项值在报文中的位置，不复制数据
+ *
+ * - 一次遍历 options 字段；选项 52（overload）指定时依次继续遍历 file 与 sname 字段
+ * - 同一选项码多次出现时按 RFC 3396 依次拼接（options、file、sname 的顺序），
+ *   每次出现记为一段，段按出现顺序链接
+ * - 出现过的选项码记在 256 位的位图中，clear() 只清位图
+ */
+class DHCPOptionIndex {
+public:
+    static constexpr size_t kMaxSegments = 256;
+
+    struct Segment {
+        uint16_t offset = 0;            // 选项值在报文中的偏移
+        uint8_t length = 0;
+        uint16_t next = 0;              // 下一段的下标，kEnd 表示最后一段
+    };
+    static constexpr uint16_t kEnd = UINT16_MAX;
+
+    /**
+     * 建立索引
+     * @param packet 完整的 DHCP 报文（236 字节头部 + 魔数 + 选项）
+     * @return 选项越界或段数超过 kMaxSegments 时返回 false
+     */
+    bool build(std::span<const uint8_t> packet) noexcept;
+    void clear() noexcept;
+
+    [[nodiscard]] bool has(uint8_t code) const noexcept {
+        return ((present_[code >> 6] >> (code & 63)) & 1) != 0;
+    }
+    // 拼接后的总长度，未出现时为 0
+    [[nodiscard]] size_t length(uint8_t code) const noexcept { return has(code) ? entries_[code].length : 0; }
+    [[nodiscard]] size_t segments(uint8_t code) const noexcept { return has(code) ? entries_[code].count : 0; }
+
+    // 只有一段时直接返回报文中的视图；未出现或分为多段时返回空
+    [[nodiscard]] std::span<const uint8_t> view(std::span<const uint8_t> packet, uint8_t code) const noexcept;
+    // 按段拼接复制到 out，返回总长度（可能大于 out.size()，超出部分不复制）
+    size_t copy(std::span<const uint8_t> packet, uint8_t code, std::span<uint8_t> out) const noexcept;
+
+    // 按选项码升序访问出现过的选项码
+    template <typename Fn>
+    void for_each(Fn&& fn) const {
+        for (size_t word = 0; word < present_.size(); ++word) {
+            for (uint64_t bits = present_[word]; bits != 0; bits &= bits - 1) {
+                fn(static_cast<uint8_t>(word * 64 + static_cast<size_t>(std::countr_zero(bits))));
+            }
+        }
+    }
+
+    [[nodiscard]] size_t option_count() const noexcept { return option_count_; }
+    [[nodiscard]] size_t segment_count() const noexcept { return segment_count_; }
+    [[nodiscard]] uint8_t overload() const noexcept { return overload_; }
+
+private:
+    struct Entry {
+        uint16_t head = 0;
+        uint16_t tail = 0;
+        uint16_t length = 0;
+        uint16_t count = 0;
+    };
+
+    std::array<uint64_t, 4> present_{};
+    std::array<Entry, 256> entries_{};
+    std::array<Segment, kMaxSegments> segments_{};
+    uint16_t segment_count_ = 0;
+    uint16_t option_count_ = 0;
+    uint8_t overload_ = 0;
+
+    bool scan(std::span<const uint8_t> packet, size_t begin, size_t end) noexcept;
+};
+
 // DHCP报文头部结构 (RFC 2131)
 struct DHCPHeader {
     DHCPMessageType op;              // 操作码
@@ -187,7 +260,16 @@ struct DHCPHeader {
 // 完整的DHCP消息
 struct DHCPMessage {
     DHCPHeader header;
-    std::vector<DHCPOption> options;
+    std::vector<DHCPOption> options;        // 懒解码模式下为空
+    DHCPOptionIndex option_index;
+    std::span<const uint8_t> packet;        // 懒解码模式下指向被解析的缓冲区，访问器从这里解码
+    
+    [[nodiscard]] bool is_lazy() const noexcept { return !packet.empty(); }
+    [[nodiscard]] bool has_option(DHCPOptionType type) const noexcept;
+    // 选项值视图：懒模式下只对未分段的选项有效；未出现时返回空
+    [[nodiscard]] std::span<const uint8_t> option_view(DHCPOptionType type) const noexcept;
+    // 复制（拼接后的）选项值，返回总长度，未出现时返回 0
+    size_t copy_option(DHCPOptionType type, std::span<uint8_t> out) const noexcept;
     
     // 便捷方法
     [[nodiscard]] std::optional<DHCPOpcode> get_message_type() const noexcept;
@@ -205,6 +287,13 @@ public:
     explicit DHCPParser() = default;
     ~DHCPParser() override = default;
 
+    /**
+     * 懒解码模式：只建立选项偏移索引，不复制选项；DHCPMessage 的访问器按需从报文解码，
+     * 解析结果在被解析的缓冲区释放前有效
+     */
+    void set_lazy_options(bool lazy) noexcept { lazy_options_ = lazy; }
+    [[nodiscard]] bool lazy_options() const noexcept { return lazy_options_; }
+
     // 基类接口实现
     [[nodiscard]] ParseResult parse(ParseContext& context) noexcept override;
     [[nodiscard]] const ProtocolInfo& get_protocol_info() const noexcept override;
@@ -269,16 +358,19 @@ private:
     DHCPMessage dhcp_message_;
     bool parsed_successfully_{false};
     bool is_malformed_{false};
+    bool lazy_options_{false};
     DHCPStatistics statistics_;
     
     // 私有解析方法
     [[nodiscard]] bool parse_header(const uint8_t* data, size_t size) noexcept;
     [[nodiscard]] bool parse_options(const uint8_t* data, size_t size, size_t offset) noexcept;
+    // 选项 52 指定的 file、sname 字段中的选项（立即解码模式）
+    [[nodiscard]] bool parse_overloaded_options(const uint8_t* data) noexcept;
     [[nodiscard]] bool parse_single_option(const uint8_t* data, size_t size, size_t& offset) noexcept;
     
     // 验证方法
     [[nodiscard]] bool validate_header(const DHCPHeader& header) const noexcept;
-    [[nodiscard]] bool validate_option(const DHCPOption& option) const noexcept;
+    [[nodiscard]] static bool is_valid_option_length(DHCPOptionType type, size_t length) noexcept;
     
     // 安全检查
     void perform_security_analysis() noexcept;
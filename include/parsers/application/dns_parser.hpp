@@ -2,7 +2,9 @@
 
 #include "parsers/base_parser.hpp"
 #include "core/buffer_view.hpp"
+#include <array>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <cstdint>
 #include <memory>
@@ -48,6 +50,103 @@ struct DNSMessage {
     std::vector<DNSResourceRecord> additional;
 };
 
+// Reference to a name inside the message, still in wire format.
+// Decoded on demand through DNSMessageView; valid while the message buffer is alive.
+struct DNSName {
+    uint16_t offset = 0;   // Where the name starts in the message
+    uint8_t labels = 0;    // Label count after following compression pointers (0 = root)
+    uint8_t length = 0;    // Presentation length without the trailing dot
+};
+
+struct DNSQuestionView {
+    DNSName qname;
+    uint16_t qtype = 0;
+    uint16_t qclass = 0;
+};
+
+struct DNSRecordView {
+    DNSName name;
+    uint16_t type = 0;
+    uint16_t rr_class = 0;
+    uint32_t ttl = 0;
+    uint16_t rdata_offset = 0;  // Offset of rdata in the message, for names embedded in rdata
+    BufferView rdata;
+};
+
+/**
+ * Zero-copy view of a DNS message.
+ * parse() validates every name once (compression pointers must point backwards, so loops are
+ * impossible) and records only offsets. A per-message cache maps each validated label
+ * position to the label count and length of the suffix starting there, so names that
+ * point at an already seen suffix are resolved without walking it again.
+ */
+class DNSMessageView {
+public:
+    static constexpr size_t kMaxNameLength = 253;
+    static constexpr size_t kMaxLabels = 127;
+
+    [[nodiscard]] bool parse(const BufferView& buffer) noexcept;
+    void clear() noexcept;
+
+    [[nodiscard]] const DNSHeader& header() const noexcept { return header_; }
+    [[nodiscard]] const BufferView& buffer() const noexcept { return buffer_; }
+    [[nodiscard]] size_t message_length() const noexcept { return message_length_; }   // Bytes up to the last record
+    [[nodiscard]] const std::vector<DNSQuestionView>& questions() const noexcept { return questions_; }
+    [[nodiscard]] const std::vector<DNSRecordView>& answers() const noexcept { return answers_; }
+    [[nodiscard]] const std::vector<DNSRecordView>& authority() const noexcept { return authority_; }
+    [[nodiscard]] const std::vector<DNSRecordView>& additional() const noexcept { return additional_; }
+
+    // Validates the name at offset (e.g. inside CNAME/NS/MX rdata); end receives the offset after it
+    [[nodiscard]] bool decode_name_at(size_t offset, DNSName& name, size_t& end) noexcept;
+
+    // Name embedded in rdata for NS/CNAME/PTR/DNAME (offset 0), MX (2) and SRV (6)
+    [[nodiscard]] bool rdata_name(const DNSRecordView& record, DNSName& name) noexcept;
+
+    // Allocation-free name access; comparisons are ASCII case-insensitive
+    [[nodiscard]] bool name_equals(const DNSName& name, std::string_view dotted) const noexcept;
+    [[nodiscard]] bool name_equals(const DNSName& lhs, const DNSName& rhs) const noexcept;
+    [[nodiscard]] uint64_t name_hash(const DNSName& name) const noexcept;
+    [[nodiscard]] static uint64_t name_hash(std::string_view dotted) noexcept;   // Same value as the wire form
+    size_t copy_name(const DNSName& name, char* out, size_t capacity) const noexcept;
+    [[nodiscard]] std::string name_to_string(const DNSName& name) const;     // Root is "."
+
+    template <typename Fn>
+    void for_each_label(const DNSName& name, Fn&& fn) const {
+        size_t pos = name.offset;
+        std::string_view label;
+        while (next_label(pos, label)) {
+            fn(label);
+        }
+    }
+
+    [[nodiscard]] size_t pointer_cache_hits() const noexcept { return cache_hits_; }
+
+private:
+    struct SuffixEntry {
+        uint32_t generation = 0;
+        uint16_t offset = 0;
+        uint8_t labels = 0;
+        uint8_t label_bytes = 0;   // Sum of label lengths
+    };
+    static constexpr size_t kCacheSize = 64;
+
+    BufferView buffer_;
+    size_t message_length_ = 0;
+    DNSHeader header_{};
+    std::vector<DNSQuestionView> questions_;
+    std::vector<DNSRecordView> answers_;
+    std::vector<DNSRecordView> authority_;
+    std::vector<DNSRecordView> additional_;
+    std::array<SuffixEntry, kCacheSize> suffix_cache_{};
+    uint32_t generation_ = 0;
+    size_t cache_hits_ = 0;
+
+    [[nodiscard]] bool parse_records(size_t& offset, uint16_t count, std::vector<DNSRecordView>& records) noexcept;
+    [[nodiscard]] bool next_label(size_t& pos, std::string_view& label) const noexcept;
+    [[nodiscard]] const SuffixEntry* find_suffix(size_t offset) const noexcept;
+    void remember_suffix(size_t offset, uint8_t labels, uint8_t label_bytes) noexcept;
+};
+
 // DNS Record Types
 enum class DNSRecordType : uint16_t {
     A = 1,          // IPv4 address
@@ -102,7 +201,12 @@ public:
     [[nodiscard]] uint16_t get_protocol_id() const { return 53; } // DNS port
 
     // DNS-specific methods
-    [[nodiscard]] const DNSMessage& get_dns_message() const { return dns_message_; }
+    // In zero-copy mode the owning DNSMessage is built on first access and is only
+    // valid while the parsed buffer is alive; get_message_view() never copies
+    [[nodiscard]] const DNSMessage& get_dns_message() const;
+    [[nodiscard]] const DNSMessageView& get_message_view() const noexcept { return message_view_; }
+    void set_zero_copy(bool enabled) noexcept { zero_copy_ = enabled; }
+    [[nodiscard]] bool zero_copy_enabled() const noexcept { return zero_copy_; }
     [[nodiscard]] bool is_query() const;
     [[nodiscard]] bool is_response() const;
     [[nodiscard]] DNSResponseCode get_response_code() const;
@@ -118,14 +222,15 @@ public:
 
 private:
     static const ProtocolInfo protocol_info_;
-    DNSMessage dns_message_;
+    DNSMessageView message_view_;
+    mutable DNSMessage dns_message_;
+    mutable bool dns_message_ready_ = false;
+    bool zero_copy_ = false;
     
     // Helper methods
-    [[nodiscard]] ParseResult parse_header(const BufferView& buffer, size_t& offset);
-    [[nodiscard]] ParseResult parse_questions(const BufferView& buffer, size_t& offset);
-    [[nodiscard]] ParseResult parse_resource_records(const BufferView& buffer, size_t& offset,
-                                                      std::vector<DNSResourceRecord>& records, uint16_t count);
-    [[nodiscard]] std::string parse_domain_name(const BufferView& buffer, size_t& offset) const;
+    void materialize_message() const;
+    void materialize_records(const std::vector<DNSRecordView>& views,
+                             std::vector<DNSResourceRecord>& records) const;
     [[nodiscard]] bool validate_dns_packet(const BufferView& buffer) const;
 };
 
@@ -0,0 +1,215 @@
+#pragma once
+
+#include "parsers/application/dns_parser.hpp"
+#include "core/expected_flow_table.hpp"
+#include "core/tcp_reassembler.hpp"
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace protocol_parser::parsers {
+
+/**
+ * Log-linear latency histogram (microseconds).
+ * Values below 8 get exact buckets; every power of two above that is split into
+ * 8 linear sub-buckets, so the relative error stays under 12.5% from 8us to ~71 min.
+ */
+class DNSLatencyHistogram {
+public:
+    static constexpr unsigned kSubBucketBits = 3;
+    static constexpr size_t kSubBuckets = size_t{1} << kSubBucketBits;
+    static constexpr unsigned kMaxMagnitude = 32;    // Values >= 2^32 us land in the last bucket
+    static constexpr size_t kBucketCount = (kMaxMagnitude - kSubBucketBits + 1) * kSubBuckets;
+
+    void record(uint64_t value) noexcept;
+    void merge(const DNSLatencyHistogram& other) noexcept;
+    void reset() noexcept { *this = DNSLatencyHistogram{}; }
+
+    [[nodiscard]] uint64_t count() const noexcept { return count_; }
+    [[nodiscard]] uint64_t sum() const noexcept { return sum_; }
+    [[nodiscard]] uint64_t min() const noexcept { return count_ ? min_ : 0; }
+    [[nodiscard]] uint64_t max() const noexcept { return max_; }
+    [[nodiscard]] double mean() const noexcept { return count_ ? static_cast<double>(sum_) / count_ : 0.0; }
+
+    // Upper bound of the bucket holding the given percentile (0-100), clamped to max()
+    [[nodiscard]] uint64_t percentile(double percent) const noexcept;
+
+    [[nodiscard]] std::span<const uint64_t> buckets() const noexcept { return buckets_; }
+    [[nodiscard]] static size_t bucket_index(uint64_t value) noexcept;
+    [[nodiscard]] static uint64_t bucket_lower_bound(size_t index) noexcept;
+    [[nodiscard]] static uint64_t bucket_upper_bound(size_t index) noexcept;
+
+private:
+    std::array<uint64_t, kBucketCount> buckets_{};
+    uint64_t count_ = 0;
+    uint64_t sum_ = 0;
+    uint64_t min_ = UINT64_MAX;
+    uint64_t max_ = 0;
+};
+
+// A completed (answered or timed out) query/response pair
+struct DNSTransaction {
+    core::FlowAddress client_ip;   // IPv4 in ::ffff:a.b.c.d form
+    core::FlowAddress server_ip;
+    uint16_t client_port = 0;
+    uint16_t server_port = 0;
+    uint16_t id = 0;
+    uint16_t qtype = 0;
+    uint64_t name_hash = 0;        // DNSMessageView::name_hash of the first question
+    uint64_t query_time_us = 0;
+    uint64_t latency_us = 0;       // 0 when unanswered
+    uint8_t rcode = 0;
+    bool answered = false;
+    bool tcp = false;
+};
+
+/**
+ * Matches DNS queries with their responses.
+ * Pending queries live in a fixed-capacity open-addressing table (linear probing,
+ * backward-shift deletion) keyed by (client, server, client port, txid, qname hash);
+ * addresses are 16-byte core::FlowAddress values, so IPv4 and IPv6 share one table.
+ * Each processed message also sweeps a few slots for timed-out queries, so no
+ * separate timer is needed; expire() forces a full sweep.
+ * Timestamps are supplied by the caller (packet capture time) in microseconds.
+ */
+class DNSTransactionTracker {
+public:
+    struct Config {
+        size_t capacity = 65536;              // Pending query slots, rounded up to a power of two
+        uint64_t timeout_us = 5'000'000;      // Queries unanswered for this long count as lost
+        size_t max_servers = 1024;            // Servers beyond this only feed the global histograms
+        size_t sweep_step = 8;                // Slots checked for timeouts per processed message
+    };
+
+    struct Statistics {
+        uint64_t queries = 0;
+        uint64_t responses = 0;
+        uint64_t matched = 0;
+        uint64_t unmatched_responses = 0;
+        uint64_t unanswered = 0;              // Timed out
+        uint64_t retransmissions = 0;         // Same key seen again while pending
+        uint64_t dropped_queries = 0;         // Table at its load limit
+        uint64_t malformed = 0;
+        uint64_t tcp_messages = 0;
+    };
+
+    struct ServerStatistics {
+        uint64_t queries = 0;
+        uint64_t responses = 0;
+        uint64_t unanswered = 0;
+        DNSLatencyHistogram latency;
+    };
+
+    struct ServerKey {
+        core::FlowAddress address;
+        uint16_t port = 0;
+        [[nodiscard]] bool operator==(const ServerKey& other) const noexcept = default;
+    };
+
+    struct ServerKeyHash {
+        [[nodiscard]] size_t operator()(const ServerKey& key) const noexcept;
+    };
+
+    using ServerMap = std::unordered_map<ServerKey, ServerStatistics, ServerKeyHash>;
+
+    // response is null for timed-out queries
+    using TransactionCallback = std::function<void(const DNSTransaction&, const DNSMessageView* response)>;
+
+    DNSTransactionTracker();
+    explicit DNSTransactionTracker(const Config& config);
+
+    void set_callback(TransactionCallback callback) { callback_ = std::move(callback); }
+
+    // Message already parsed by the caller
+    void process_message(const DNSMessageView& message, const core::FlowAddress& src_ip, const core::FlowAddress& dst_ip,
+                         uint16_t src_port, uint16_t dst_port, uint64_t timestamp_us, bool tcp = false);
+
+    // One UDP payload; returns false if it is not a well-formed DNS message
+    bool process_datagram(const BufferView& payload, const core::FlowAddress& src_ip, const core::FlowAddress& dst_ip,
+                          uint16_t src_port, uint16_t dst_port, uint64_t timestamp_us);
+
+    /**
+     * DNS over TCP: consumes every complete 2-byte length-prefixed message available in
+     * the reassembled stream and leaves a partial trailing message in place.
+     * @return Number of messages processed
+     */
+    size_t process_tcp_stream(core::TcpReassembler& reassembler, const core::FlowAddress& src_ip,
+                              const core::FlowAddress& dst_ip, uint16_t src_port, uint16_t dst_port,
+                              uint64_t timestamp_us);
+
+    // IPv4 convenience overloads; addresses in host byte order
+    void process_message(const DNSMessageView& message, uint32_t src_ip, uint32_t dst_ip,
+                         uint16_t src_port, uint16_t dst_port, uint64_t timestamp_us, bool tcp = false) {
+        process_message(message, core::FlowAddress::from_ipv4(src_ip), core::FlowAddress::from_ipv4(dst_ip),
+                        src_port, dst_port, timestamp_us, tcp);
+    }
+    bool process_datagram(const BufferView& payload, uint32_t src_ip, uint32_t dst_ip,
+                          uint16_t src_port, uint16_t dst_port, uint64_t timestamp_us) {
+        return process_datagram(payload, core::FlowAddress::from_ipv4(src_ip), core::FlowAddress::from_ipv4(dst_ip),
+                                src_port, dst_port, timestamp_us);
+    }
+    size_t process_tcp_stream(core::TcpReassembler& reassembler, uint32_t src_ip, uint32_t dst_ip,
+                              uint16_t src_port, uint16_t dst_port, uint64_t timestamp_us) {
+        return process_tcp_stream(reassembler, core::FlowAddress::from_ipv4(src_ip), core::FlowAddress::from_ipv4(dst_ip),
+                                  src_port, dst_port, timestamp_us);
+    }
+
+    // Times out every pending query older than the configured timeout
+    void expire(uint64_t now_us);
+
+    [[nodiscard]] size_t pending() const noexcept { return pending_; }
+    [[nodiscard]] size_t capacity() const noexcept { return slots_.size(); }
+    [[nodiscard]] const Statistics& statistics() const noexcept { return stats_; }
+    [[nodiscard]] const DNSLatencyHistogram& latency() const noexcept { return latency_; }
+    [[nodiscard]] const DNSLatencyHistogram& rcode_latency(uint8_t rcode) const noexcept {
+        return rcode_latency_[rcode & 0x0F];
+    }
+    [[nodiscard]] const ServerStatistics* find_server(const core::FlowAddress& ip, uint16_t port) const noexcept;
+    [[nodiscard]] const ServerStatistics* find_server(uint32_t ip, uint16_t port) const noexcept {
+        return find_server(core::FlowAddress::from_ipv4(ip), port);
+    }
+    [[nodiscard]] const ServerMap& servers() const noexcept { return servers_; }
+
+    void reset();
+
+private:
+    struct Slot {
+        uint64_t hash = 0;
+        uint64_t name_hash = 0;
+        uint64_t query_time_us = 0;
+        core::FlowAddress client_ip;
+        core::FlowAddress server_ip;
+        uint16_t client_port = 0;
+        uint16_t server_port = 0;
+        uint16_t id = 0;
+        uint16_t qtype = 0;
+        bool occupied = false;
+        bool tcp = false;
+    };
+
+    Config config_;
+    std::vector<Slot> slots_;
+    size_t mask_ = 0;
+    size_t pending_ = 0;
+    size_t sweep_cursor_ = 0;
+
+    Statistics stats_;
+    DNSLatencyHistogram latency_;
+    std::array<DNSLatencyHistogram, 16> rcode_latency_;
+    ServerMap servers_;
+    TransactionCallback callback_;
+    DNSMessageView scratch_view_;
+
+    [[nodiscard]] static uint64_t hash_key(const core::FlowAddress& client_ip, const core::FlowAddress& server_ip,
+                                           uint16_t client_port, uint16_t id, uint64_t name_hash) noexcept;
+    [[nodiscard]] size_t find_slot(const Slot& probe) const noexcept;   // slots_.size() if absent
+    void erase_slot(size_t index) noexcept;
+    void sweep(uint64_t now_us, size_t budget);
+    void time_out(size_t index);
+    ServerStatistics* server_stats(const core::FlowAddress& ip, uint16_t port, bool create);
+};
+
+} // namespace protocol_parser::parsers
@@ -1,9 +1,13 @@
 #pragma once
 
 #include "../base_parser.hpp"
+#include "core/expected_flow_table.hpp"
 #include <string>
+#include <string_view>
 #include <vector>
 #include <cstdint>
+#include <memory>
+#include <optional>
 
 namespace protocol_parser::parsers {
 
@@ -47,6 +51,8 @@ enum class FTPCommand {
     AUTH,       // Authentication
     PBSZ,       // Protection buffer size
     PROT,       // Data channel protection
+    EPRT,       // Extended data port (RFC 2428)
+    EPSV,       // Extended passive mode (RFC 2428)
     UNKNOWN
 };
 
@@ -71,6 +77,7 @@ enum class FTPResponseCode {
     DATA_CONNECTION_OPEN_NO_TRANSFER = 225,
     DATA_CONNECTION_CLOSED = 226,
     PASSIVE_MODE = 227,
+    EXTENDED_PASSIVE_MODE = 229,
     USER_LOGGED_IN = 230,
     FILE_ACTION_OK = 250,
     PATHNAME_CREATED = 257,
@@ -166,11 +173,28 @@ struct FTPMessage {
     }
 };
 
+// Data connection endpoint announced on the control channel
+struct FTPDataEndpoint {
+    core::FlowAddress address;  // Unspecified when the reply omits it (229)
+    uint16_t port = 0;
+    bool passive = false;       // Announced by the server (227/229) rather than the client (PORT/EPRT)
+};
+
+// Addresses of the control connection (IPv4 or IPv6) and the session id
+// that data connections registered in the expected-flow table are linked to
+struct FTPControlFlow {
+    core::FlowAddress client;
+    core::FlowAddress server;
+    uint64_t session = 0;
+};
+
 class FTPParser : public BaseParser {
 public:
     FTPParser() = default;
     ~FTPParser() override = default;
 
+    [[nodiscard]] const ProtocolInfo& get_protocol_info() const noexcept override;
+    [[nodiscard]] bool can_parse(const BufferView& buffer) const noexcept override;
     [[nodiscard]] ParseResult parse(ParseContext& context) noexcept override;
     void reset() noexcept override;
     [[nodiscard]] std::string get_error_message() const noexcept override;
@@ -197,6 +221,27 @@ public:
     [[nodiscard]] bool is_multiline_response() const;
     [[nodiscard]] const std::vector<std::string>& get_response_lines() const;
     
+    // Data endpoint announced by the message of the last parse() call (PORT, EPRT, 227 or 229);
+    // empty when that call did not produce one
+    [[nodiscard]] const std::optional<FTPDataEndpoint>& get_data_endpoint() const noexcept { return data_endpoint_; }
+    
+    // Every announced data endpoint is registered in the table as an "FTP-DATA" expected flow
+    // linked to control.session, so the data connection is classified without inspection.
+    // A null table stops the registration
+    void set_expected_flows(std::shared_ptr<core::ExpectedFlowTable> table, const FTPControlFlow& control) noexcept {
+        expected_flows_ = std::move(table);
+        control_flow_ = control;
+    }
+    
+    // Capture time of the next parse() input, in microseconds; used for expected-flow timeouts
+    void set_timestamp(uint64_t now_us) noexcept { now_us_ = now_us; }
+    
+    // "h1,h2,h3,h4,p1,p2" as used by PORT and the 227 reply; surrounding text is skipped
+    [[nodiscard]] static bool parse_host_port(std::string_view text, FTPDataEndpoint& out) noexcept;
+    // "<d>proto<d>address<d>port<d>" as used by EPRT and the 229 reply (RFC 2428);
+    // proto is 1 (IPv4), 2 (IPv6) or empty, and the address may be empty
+    [[nodiscard]] static bool parse_extended_port(std::string_view text, FTPDataEndpoint& out) noexcept;
+    
     // Status check methods
     [[nodiscard]] bool is_positive_preliminary() const;
     [[nodiscard]] bool is_positive_completion() const;
@@ -212,6 +257,10 @@ public:
 
 private:
     FTPMessage ftp_message_;
+    std::optional<FTPDataEndpoint> data_endpoint_;
+    std::shared_ptr<core::ExpectedFlowTable> expected_flows_;
+    FTPControlFlow control_flow_;
+    uint64_t now_us_ = 0;
     
     // Helper methods
     [[nodiscard]] ParseResult parse_command(const std::string& line);
@@ -221,6 +270,7 @@ private:
     [[nodiscard]] std::string to_upper(const std::string& str) const;
     [[nodiscard]] bool validate_ftp_message(const BufferView& buffer) const;
     [[nodiscard]] bool is_complete_line(const BufferView& buffer) const;
+    void track_data_endpoint() noexcept;
 };
 
 } // namespace protocol_parser::parsers
\ No newline at end of file
@@ -2,14 +2,17 @@
 
 #include "../base_parser.hpp"
 #include "../../core/buffer_view.hpp"
+#include "http2_demuxer.hpp"
+#include "protobuf_scanner.hpp"
+#include <array>
+#include <functional>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <unordered_map>
 #include <cstdint>
 
-using namespace protocol_parser::parsers;
-using namespace protocol_parser::core;
-
 namespace ProtocolParser::Parsers::Application {
 
 /// gRPC消息类型
@@ -57,20 +60,6 @@ enum class GRPCStreamType {
     BIDIRECTIONAL      ///< 双向流
 };
 
-/// HTTP/2帧类型（gRPC基于HTTP/2）
-enum class HTTP2FrameType : uint8_t {
-    DATA = 0x0,         ///< 数据帧
-    HEADERS = 0x1,      ///< 头部帧
-    PRIORITY = 0x2,     ///< 优先级帧
-    RST_STREAM = 0x3,   ///< 重置流帧
-    SETTINGS = 0x4,     ///< 设置帧
-    PUSH_PROMISE = 0x5, ///< 推送承诺帧
-    PING = 0x6,         ///< Ping帧
-    GOAWAY = 0x7,       ///< GoAway帧
-    WINDOW_UPDATE = 0x8, ///< 窗口更新帧
-    CONTINUATION = 0x9   ///< 继续帧
-};
-
 /// gRPC消息头部
 struct GRPCMessageHeader {
     bool compressed = false;        ///< 是否压缩
@@ -78,14 +67,6 @@ struct GRPCMessageHeader {
     GRPCCompression compression = GRPCCompression::NONE; ///< 压缩类型
 };
 
-/// HTTP/2帧头部
-struct HTTP2FrameHeader {
-    uint32_t length = 0;           ///< 帧长度
-    HTTP2FrameType type = HTTP2FrameType::DATA; ///< 帧类型
-    uint8_t flags = 0;             ///< 标志位
-    uint32_t stream_id = 0;        ///< 流ID
-};
-
 /// gRPC头部字段
 struct GRPCHeaders {
     std::string method;                          ///< 方法名
@@ -101,6 +82,14 @@ struct GRPCHeaders {
     std::unordered_map<std::string, std::string> custom_headers; ///< 自定义头部
 };
 
+/// 字段投影提取的值（从消息中拷贝，调用结束后仍有效）
+struct GRPCFieldValue {
+    size_t slot = 0;                            ///< ProtobufProjection 槽位
+    protocol_parser::parsers::ProtobufWireType wire_type = protocol_parser::parsers::ProtobufWireType::VARINT; ///< 线格式类型
+    uint64_t value = 0;                         ///< 数值字段的原始值
+    std::string bytes;                          ///< LENGTH_DELIMITED 字段内容
+};
+
 /// gRPC调用信息
 struct GRPCCall {
     std::string service;                        ///< 服务名
@@ -119,18 +108,23 @@ struct GRPCCall {
     GRPCStatusCode status_code = GRPCStatusCode::OK; ///< 状态码
     std::string status_message;                 ///< 状态消息
     
+    // 投影字段（各方向第一个未压缩消息）
+    std::vector<GRPCFieldValue> request_fields;  ///< 请求投影字段
+    std::vector<GRPCFieldValue> response_fields; ///< 响应投影字段
+    
     // 统计信息
     uint64_t request_size = 0;                  ///< 请求大小
     uint64_t response_size = 0;                 ///< 响应大小
-    uint64_t start_time = 0;                    ///< 开始时间
-    uint64_t end_time = 0;                      ///< 结束时间
+    uint64_t start_time = 0;                    ///< 开始时间（微秒，单调时钟）
+    uint64_t end_time = 0;                      ///< 结束时间（微秒，单调时钟）
     uint32_t message_count = 0;                 ///< 消息数量
+    bool reset = false;                         ///< 是否被 RST_STREAM 终止
 };
 
 /// gRPC消息
 struct GRPCMessage {
     GRPCMessageType type = GRPCMessageType::REQUEST; ///< 消息类型
-    HTTP2FrameHeader frame_header;              ///< HTTP/2帧头
+    protocol_parser::parsers::HTTP2FrameHeader frame_header; ///< HTTP/2帧头
     GRPCMessageHeader message_header;           ///< gRPC消息头
     GRPCCall call_info;                        ///< 调用信息
     std::vector<uint8_t> payload;              ///< 载荷数据
@@ -147,7 +141,7 @@ struct GRPCMetrics {
     uint64_t failed_calls = 0;                ///< 失败调用数
     uint64_t total_request_bytes = 0;          ///< 总请求字节数
     uint64_t total_response_bytes = 0;         ///< 总响应字节数
-    double average_latency = 0.0;              ///< 平均延迟
+    double average_latency = 0.0;              ///< 平均延迟（微秒）
     uint32_t concurrent_streams = 0;           ///< 并发流数
     std::unordered_map<std::string, uint64_t> method_counts; ///< 方法调用统计
     std::unordered_map<uint32_t, uint64_t> status_counts;    ///< 状态码统计
@@ -173,9 +167,15 @@ struct GRPCMetrics {
  * - 压缩和编码检测
  * - 现代C++23实现
  * - 高性能零拷贝设计
+ *
+ * parse() 将字节流交给 HTTP2Demuxer：帧可以跨 parse() 调用切分，
+ * HPACK 动态表按连接方向保持，调用按流 ID 跟踪直到两端结束或被重置
  */
-class GRPCParser : public BaseParser {
+class GRPCParser : public protocol_parser::parsers::BaseParser {
 public:
+    /// 调用结束回调（两端 END_STREAM 或 RST_STREAM）
+    using CallCallback = std::function<void(const GRPCCall&)>;
+
     /**
      * @brief 构造函数
      */
@@ -191,26 +191,49 @@ public:
      * @param context 解析上下文
      * @return 解析结果
      */
-    ParseResult parse(ParseContext& context) noexcept override;
+    protocol_parser::parsers::ParseResult parse(protocol_parser::parsers::ParseContext& context) noexcept override;
     
     /**
      * @brief 获取协议信息
      * @return 协议信息结构
      */
-    [[nodiscard]] const ProtocolInfo& get_protocol_info() const noexcept override;
+    [[nodiscard]] const protocol_parser::parsers::ProtocolInfo& get_protocol_info() const noexcept override;
     
     /**
      * @brief 检查是否可以解析给定的缓冲区  
      * @param buffer 数据缓冲区
      * @return 如果可以解析返回true，否则返回false
      */
-    [[nodiscard]] bool can_parse(const BufferView& buffer) const noexcept override;
+    [[nodiscard]] bool can_parse(const protocol_parser::core::BufferView& buffer) const noexcept override;
     
     /**
      * @brief 重置解析器状态
      */
     void reset() noexcept override;
     
+    /**
+     * @brief 设置后续 parse() 输入的字节流方向
+     * 遇到连接前导时自动切换为客户端方向
+     */
+    void set_direction(protocol_parser::parsers::HTTP2Direction direction) noexcept { direction_ = direction; }
+    [[nodiscard]] protocol_parser::parsers::HTTP2Direction get_direction() const noexcept { return direction_; }
+
+    void set_call_callback(CallCallback callback) { call_callback_ = std::move(callback); }
+
+    /**
+     * @brief 设置字段投影
+     * 每个方向的第一个消息按投影提取字段到 request_fields/response_fields，
+     * 只扫描登记路径上的字段，不做完整解码
+     */
+    void set_field_projection(protocol_parser::parsers::ProtobufProjection projection) { projection_ = std::move(projection); }
+
+    /// 查找进行中的调用
+    [[nodiscard]] const GRPCCall* find_call(uint32_t stream_id) const noexcept;
+    [[nodiscard]] size_t active_calls() const noexcept { return calls_.size(); }
+    [[nodiscard]] const GRPCMetrics& get_metrics() const noexcept { return metrics_; }
+    [[nodiscard]] const protocol_parser::parsers::HTTP2Demuxer& get_demuxer() const noexcept { return demuxer_; }
+    [[nodiscard]] std::string get_error_message() const noexcept override;
+
     /**
      * @brief 检测是否为gRPC流量
      * @param buffer 数据缓冲区
@@ -231,7 +254,7 @@ public:
      * @param message gRPC消息输出
      * @return 解析结果
      */
-    ParseResult parse_http2_frame(const protocol_parser::core::BufferView& buffer, 
+    protocol_parser::parsers::ParseResult parse_http2_frame(const protocol_parser::core::BufferView& buffer, 
                                  GRPCMessage& message) const;
     
     /**
@@ -240,7 +263,7 @@ public:
      * @param message gRPC消息输出
      * @return 解析结果
      */
-    ParseResult parse_grpc_message(const protocol_parser::core::BufferView& buffer, 
+    protocol_parser::parsers::ParseResult parse_grpc_message(const protocol_parser::core::BufferView& buffer, 
                                   GRPCMessage& message) const;
     
     /**
@@ -249,7 +272,7 @@ public:
      * @param message gRPC消息输出
      * @return 解析结果
      */
-    ParseResult parse_headers_frame(const protocol_parser::core::BufferView& buffer, 
+    protocol_parser::parsers::ParseResult parse_headers_frame(const protocol_parser::core::BufferView& buffer, 
                                    GRPCMessage& message) const;
     
     /**
@@ -258,7 +281,7 @@ public:
      * @param message gRPC消息输出
      * @return 解析结果
      */
-    ParseResult parse_data_frame(const protocol_parser::core::BufferView& buffer, 
+    protocol_parser::parsers::ParseResult parse_data_frame(const protocol_parser::core::BufferView& buffer, 
                                 GRPCMessage& message) const;
     
     /**
@@ -267,7 +290,7 @@ public:
      * @param header 消息头部输出
      * @return 解析结果
      */
-    ParseResult parse_message_header(const protocol_parser::core::BufferView& buffer, 
+    protocol_parser::parsers::ParseResult parse_message_header(const protocol_parser::core::BufferView& buffer, 
                                     GRPCMessageHeader& header) const;
     
     /**
@@ -279,10 +302,11 @@ public:
     
     /**
      * @brief 检测是否为Protocol Buffers消息
+     * 按线格式遍历全部顶层字段，不复制数据
      * @param data 数据
      * @return true if protobuf message
      */
-    bool is_protobuf_message(const std::vector<uint8_t>& data) const;
+    bool is_protobuf_message(std::span<const uint8_t> data) const;
     
     /**
      * @brief 提取服务和方法名
@@ -307,7 +331,7 @@ public:
      * @param type 帧类型
      * @return 帧类型名称
      */
-    std::string frame_type_to_string(HTTP2FrameType type) const;
+    std::string frame_type_to_string(protocol_parser::parsers::HTTP2FrameType type) const;
     
     /**
      * @brief 获取gRPC状态码字符串
@@ -337,16 +361,16 @@ private:
      * @param header 帧头部输出
      * @return 解析结果
      */
-    ParseResult parse_frame_header(const protocol_parser::core::BufferView& buffer, 
-                                  HTTP2FrameHeader& header) const;
+    protocol_parser::parsers::ParseResult parse_frame_header(const protocol_parser::core::BufferView& buffer, 
+                                  protocol_parser::parsers::HTTP2FrameHeader& header) const;
     
     /**
-     * @brief 简化的HPACK解码
+     * @brief 单个头部块的HPACK解码（无连接上下文，引用动态表的块会失败）
      * @param data 编码数据
      * @param headers 头部输出
      * @return 解析结果
      */
-    ParseResult simple_hpack_decode(const std::vector<uint8_t>& data, 
+    protocol_parser::parsers::ParseResult simple_hpack_decode(const std::vector<uint8_t>& data, 
                                    GRPCHeaders& headers) const;
     
     /**
@@ -355,9 +379,14 @@ private:
      * @param value 头部值
      * @param headers 头部信息
      */
-    void parse_pseudo_header(const std::string& name, 
-                            const std::string& value, 
+    void parse_pseudo_header(std::string_view name,
+                            std::string_view value,
                             GRPCHeaders& headers) const;
+
+    /**
+     * @brief 将解码后的头部列表映射到 gRPC 头部字段
+     */
+    void apply_headers(std::span<const protocol_parser::parsers::HPACKHeader> fields, GRPCHeaders& headers) const;
     
     /**
      * @brief 检测流类型
@@ -372,6 +401,27 @@ private:
      */
     void collect_metrics(const GRPCMessage& message) const;
 
+    /// gRPC 长度前缀消息的分帧状态（每个方向一份，跨 DATA 帧）
+    struct MessageFramer {
+        std::array<uint8_t, 5> prefix{};
+        uint8_t prefix_bytes = 0;
+        uint32_t remaining = 0;
+        uint32_t messages = 0;
+        bool projection_pending = false;    ///< 首个消息的载荷尚未到达，待投影
+    };
+
+    struct CallState {
+        GRPCCall call;
+        std::array<MessageFramer, 2> framers;
+    };
+
+    void on_headers(protocol_parser::parsers::HTTP2Direction direction, uint32_t stream_id,
+                    std::span<const protocol_parser::parsers::HPACKHeader> fields, bool end_stream);
+    void on_data(protocol_parser::parsers::HTTP2Direction direction, uint32_t stream_id, std::span<const uint8_t> data);
+    void project_fields(std::span<const uint8_t> message, std::vector<GRPCFieldValue>& out);
+    void finish_call(uint32_t stream_id, bool reset);
+    CallState& track_call(uint32_t stream_id);
+
 private:
     /// HTTP/2连接前导
     static constexpr const char* HTTP2_PREFACE = "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n";
@@ -385,8 +435,18 @@ private:
     /// 最大头部表大小
     static constexpr size_t MAX_HEADER_TABLE_SIZE = 4096;
     
+    /// 每方向最多保留的消息载荷字节数
+    static constexpr size_t MAX_CAPTURED_PAYLOAD = 4096;
+    
     /// 性能指标
     mutable GRPCMetrics metrics_;
+
+    protocol_parser::parsers::HTTP2Demuxer demuxer_;
+    protocol_parser::parsers::HTTP2StreamMap<CallState> calls_;
+    protocol_parser::parsers::HTTP2Direction direction_ = protocol_parser::parsers::HTTP2Direction::CLIENT_TO_SERVER;
+    CallCallback call_callback_;
+    protocol_parser::parsers::ProtobufProjection projection_;
+    std::vector<protocol_parser::parsers::ProtobufField> projected_;
 };
 
 } // namespace ProtocolParser::Application
\ No newline at end of file
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace protocol_parser::parsers {
+
+/**
+ * 解码后的头部字段
+ * 视图指向解码器内部暂存区，在同一解码器下一次 decode() 之前有效
+ */
+struct HPACKHeader {
+    std::string_view name;
+    std::string_view value;
+    bool never_indexed = false;    // 字面量"永不索引"表示（敏感字段）
+};
+
+/**
+ * HPACK 解码器（RFC 7541）
+ * 每个连接的每个方向各持有一个实例：
+ * - 61 项静态表
+ * - 动态表：条目描述符存放在环形队列中，名称与值连续存放在字节区，
+ *   空间不足时将存活数据整体前移，不按条目分配内存
+ * - Huffman 解码使用按 4 位查表的状态机，每次处理半个字节
+ */
+class HPACKDecoder {
+public:
+    static constexpr size_t kDefaultTableSize = 4096;
+    static constexpr size_t kStaticTableSize = 61;
+    static constexpr size_t kEntryOverhead = 32;               // RFC 7541 4.1 每条目额外开销
+    static constexpr size_t kMaxTableSizeLimit = 1 << 20;      // 接受的 SETTINGS_HEADER_TABLE_SIZE 上限
+
+    explicit HPACKDecoder(size_t max_table_size = kDefaultTableSize);
+
+    /**
+     * 设置协商的动态表上限（对端 SETTINGS_HEADER_TABLE_SIZE）
+     * 头部块中的动态表大小更新不得超过该值
+     */
+    void set_max_table_size(size_t size);
+
+    /**
+     * 解码一个完整头部块（HEADERS/PUSH_PROMISE 与其 CONTINUATION 拼接后）
+     * @param block 头部块
+     * @param out 输出头部列表，先清空后填充
+     * @return 成功返回 true；失败后动态表状态与编码端不再同步
+     */
+    [[nodiscard]] bool decode(std::span<const uint8_t> block, std::vector<HPACKHeader>& out);
+
+    /**
+     * Huffman 解码并追加到 out
+     * @return 编码非法（含 EOS 或填充不合法）时返回 false
+     */
+    [[nodiscard]] static bool huffman_decode(std::span<const uint8_t> data, std::string& out);
+
+    void reset() noexcept;
+
+    [[nodiscard]] size_t dynamic_table_size() const noexcept { return table_size_; }
+    [[nodiscard]] size_t dynamic_table_entries() const noexcept { return entry_count_; }
+    [[nodiscard]] size_t max_table_size() const noexcept { return max_table_size_; }
+    [[nodiscard]] const std::string& get_error_message() const noexcept { return error_message_; }
+
+private:
+    struct DynamicEntry {
+        uint32_t offset = 0;          // 在 arena_ 中的起始位置
+        uint32_t name_length = 0;
+        uint32_t value_length = 0;    // 值紧跟名称存放
+    };
+
+    // 暂存区中的字段位置，解码结束后统一转换为视图（暂存区扩容会使视图失效）
+    struct PendingField {
+        uint32_t name_offset = 0;
+        uint32_t name_length = 0;
+        uint32_t value_offset = 0;
+        uint32_t value_length = 0;
+        bool never_indexed = false;
+    };
+
+    // 动态表：entries_ 为容量 2 的幂的环形队列，head_ 为下一个写入位置
+    std::vector<DynamicEntry> entries_;
+    size_t head_ = 0;
+    size_t entry_count_ = 0;
+    std::vector<char> arena_;
+    size_t arena_begin_ = 0;          // 最旧条目的起始位置
+    size_t arena_end_ = 0;            // 最新条目的结束位置
+    size_t table_size_ = 0;           // 按 RFC 计算的大小（含每条目开销）
+    size_t max_table_size_;           // 当前动态表上限（由大小更新指令设置）
+    size_t settings_max_table_size_;  // 协商上限
+
+    std::string scratch_;
+    std::vector<PendingField> pending_;
+    std::string error_message_;
+
+    [[nodiscard]] bool decode_integer(std::span<const uint8_t> block, size_t& pos,
+                                      uint8_t prefix_bits, uint64_t& value);
+    [[nodiscard]] bool decode_string(std::span<const uint8_t> block, size_t& pos);
+    [[nodiscard]] bool lookup(uint64_t index, std::string_view& name, std::string_view& value);
+    [[nodiscard]] std::string_view entry_name(const DynamicEntry& entry) const noexcept;
+    [[nodiscard]] std::string_view entry_value(const DynamicEntry& entry) const noexcept;
+    [[nodiscard]] const DynamicEntry& entry_at(size_t age) const noexcept;  // 0 为最新条目
+    void insert(std::string_view name, std::string_view value);
+    void evict_to(size_t limit) noexcept;
+};
+
+} // namespace protocol_parser::parsers
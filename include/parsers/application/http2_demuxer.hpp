@@ -0,0 +1,204 @@
+#pragma once
+
+#include "../base_parser.hpp"
+#include "hpack_decoder.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace protocol_parser::parsers {
+
+/// HTTP/2帧类型（RFC 9113 第 6 节）
+enum class HTTP2FrameType : uint8_t {
+    DATA = 0x0,         ///< 数据帧
+    HEADERS = 0x1,      ///< 头部帧
+    PRIORITY = 0x2,     ///< 优先级帧
+    RST_STREAM = 0x3,   ///< 重置流帧
+    SETTINGS = 0x4,     ///< 设置帧
+    PUSH_PROMISE = 0x5, ///< 推送承诺帧
+    PING = 0x6,         ///< Ping帧
+    GOAWAY = 0x7,       ///< GoAway帧
+    WINDOW_UPDATE = 0x8, ///< 窗口更新帧
+    CONTINUATION = 0x9   ///< 继续帧
+};
+
+/// HTTP/2帧头部
+struct HTTP2FrameHeader {
+    uint32_t length = 0;           ///< 帧长度
+    HTTP2FrameType type = HTTP2FrameType::DATA; ///< 帧类型
+    uint8_t flags = 0;             ///< 标志位
+    uint32_t stream_id = 0;        ///< 流ID
+};
+
+/// HTTP/2帧标志位
+namespace HTTP2Flags {
+    inline constexpr uint8_t END_STREAM = 0x01;
+    inline constexpr uint8_t ACK = 0x01;
+    inline constexpr uint8_t END_HEADERS = 0x04;
+    inline constexpr uint8_t PADDED = 0x08;
+    inline constexpr uint8_t PRIORITY = 0x20;
+}
+
+/// 字节流方向
+enum class HTTP2Direction : uint8_t {
+    CLIENT_TO_SERVER = 0,
+    SERVER_TO_CLIENT = 1
+};
+
+/**
+ * 按流 ID 排序的小型平铺映射
+ * 活跃流通常只有几个到几十个，且新流 ID 单调递增，插入多为尾部追加；
+ * 连续存储避免节点分配，查找为二分
+ */
+template <typename T>
+class HTTP2StreamMap {
+public:
+    [[nodiscard]] T* find(uint32_t stream_id) noexcept {
+        auto it = lower_bound(stream_id);
+        return (it != entries_.end() && it->first == stream_id) ? &it->second : nullptr;
+    }
+
+    [[nodiscard]] const T* find(uint32_t stream_id) const noexcept {
+        auto it = std::lower_bound(entries_.begin(), entries_.end(), stream_id,
+                                   [](const auto& entry, uint32_t id) { return entry.first < id; });
+        return (it != entries_.end() && it->first == stream_id) ? &it->second : nullptr;
+    }
+
+    T& get_or_insert(uint32_t stream_id) {
+        if (entries_.empty() || entries_.back().first < stream_id) {
+            return entries_.emplace_back(stream_id, T{}).second;
+        }
+        auto it = lower_bound(stream_id);
+        if (it != entries_.end() && it->first == stream_id) {
+            return it->second;
+        }
+        return entries_.emplace(it, stream_id, T{})->second;
+    }
+
+    void erase(uint32_t stream_id) noexcept {
+        auto it = lower_bound(stream_id);
+        if (it != entries_.end() && it->first == stream_id) {
+            entries_.erase(it);
+        }
+    }
+
+    void clear() noexcept { entries_.clear(); }
+    [[nodiscard]] size_t size() const noexcept { return entries_.size(); }
+    [[nodiscard]] bool empty() const noexcept { return entries_.empty(); }
+
+    [[nodiscard]] auto begin() noexcept { return entries_.begin(); }
+    [[nodiscard]] auto end() noexcept { return entries_.end(); }
+    [[nodiscard]] auto begin() const noexcept { return entries_.begin(); }
+    [[nodiscard]] auto end() const noexcept { return entries_.end(); }
+
+private:
+    std::vector<std::pair<uint32_t, T>> entries_;
+
+    auto lower_bound(uint32_t stream_id) noexcept {
+        return std::lower_bound(entries_.begin(), entries_.end(), stream_id,
+                                [](const auto& entry, uint32_t id) { return entry.first < id; });
+    }
+};
+
+/// 流状态（被动观测视角）
+struct HTTP2StreamInfo {
+    bool client_closed = false;    ///< 客户端已发送 END_STREAM
+    bool server_closed = false;    ///< 服务端已发送 END_STREAM
+    uint32_t header_blocks = 0;    ///< 已解码头部块数
+    uint64_t client_bytes = 0;     ///< 客户端 DATA 载荷字节数
+    uint64_t server_bytes = 0;     ///< 服务端 DATA 载荷字节数
+};
+
+/**
+ * HTTP/2 帧解复用器（单连接）
+ * 两个方向的字节流分别输入，可在任意位置切分；
+ * 每个方向维护独立的 HPACK 解码器、未完成帧缓存与 HEADERS/CONTINUATION 累积，
+ * 完整帧在输入缓冲区内时直接解析不复制
+ */
+class HTTP2Demuxer {
+public:
+    static constexpr size_t kFrameHeaderSize = 9;
+    static constexpr size_t kPrefaceSize = 24;
+    static constexpr uint32_t kDefaultMaxFrameSize = 16384;
+    static constexpr uint32_t kMaxFrameSizeLimit = 16777215;
+    static constexpr size_t kMaxHeaderBlockSize = 256 * 1024;   ///< 累积头部块上限
+    static constexpr size_t kMaxTrackedStreams = 1024;          ///< 超出时丢弃最旧的流（只观测到单向结束的流）
+
+    /// 事件回调，视图仅在回调期间有效
+    struct Handlers {
+        std::function<void(HTTP2Direction, const HTTP2FrameHeader&)> on_frame;
+        std::function<void(HTTP2Direction, uint32_t stream_id,
+                           std::span<const HPACKHeader> headers, bool end_stream)> on_headers;
+        std::function<void(HTTP2Direction, uint32_t stream_id,
+                           std::span<const uint8_t> data, bool end_stream)> on_data;
+        std::function<void(uint32_t stream_id, uint32_t error_code)> on_stream_reset;
+        std::function<void(uint32_t stream_id)> on_stream_closed;
+    };
+
+    HTTP2Demuxer();
+
+    void set_handlers(Handlers handlers) { handlers_ = std::move(handlers); }
+
+    /**
+     * 输入一个方向的字节流片段
+     * @return Success 表示片段已全部消费（末尾不完整的帧已缓存）；
+     *         InvalidFormat 表示协议错误，之后该连接不再解析
+     */
+    [[nodiscard]] ParseResult feed(HTTP2Direction direction, const BufferView& data);
+
+    [[nodiscard]] static bool is_preface(const BufferView& data) noexcept;
+
+    [[nodiscard]] const HTTP2StreamInfo* find_stream(uint32_t stream_id) const noexcept { return streams_.find(stream_id); }
+    [[nodiscard]] size_t active_streams() const noexcept { return streams_.size(); }
+    [[nodiscard]] uint64_t frames_parsed() const noexcept { return frames_parsed_; }
+    [[nodiscard]] const HPACKDecoder& decoder(HTTP2Direction direction) const noexcept {
+        return directions_[static_cast<size_t>(direction)].decoder;
+    }
+    [[nodiscard]] const std::string& get_error_message() const noexcept { return error_message_; }
+
+    void reset();
+
+private:
+    struct DirectionState {
+        HPACKDecoder decoder{};
+        std::vector<uint8_t> partial_frame;      ///< 跨片段的不完整帧
+        std::vector<uint8_t> header_block;       ///< HEADERS/PUSH_PROMISE + CONTINUATION 累积
+        uint32_t header_stream_id = 0;           ///< 正在累积的头部块所属流（PUSH_PROMISE 为承诺流）
+        uint32_t continuation_stream_id = 0;     ///< CONTINUATION 帧必须携带的流 ID
+        bool header_end_stream = false;
+        bool expecting_continuation = false;
+        size_t preface_matched = 0;              ///< 已匹配的连接前导字节数（仅客户端方向）
+        bool preface_done = false;
+        uint32_t max_frame_size = kDefaultMaxFrameSize;
+    };
+
+    std::array<DirectionState, 2> directions_;
+    HTTP2StreamMap<HTTP2StreamInfo> streams_;
+    std::vector<HPACKHeader> headers_;
+    Handlers handlers_;
+    uint64_t frames_parsed_ = 0;
+    bool failed_ = false;
+    std::string error_message_;
+
+    [[nodiscard]] size_t consume_preface(DirectionState& state, std::span<const uint8_t> data);
+    [[nodiscard]] bool process_frame(HTTP2Direction direction, const HTTP2FrameHeader& header,
+                                     std::span<const uint8_t> payload);
+    [[nodiscard]] bool process_header_fragment(HTTP2Direction direction, uint32_t stream_id,
+                                               std::span<const uint8_t> fragment, bool end_headers,
+                                               bool end_stream);
+    [[nodiscard]] bool decode_header_block(HTTP2Direction direction, uint32_t stream_id,
+                                           std::span<const uint8_t> block, bool end_stream);
+    void process_settings(HTTP2Direction direction, std::span<const uint8_t> payload);
+    HTTP2StreamInfo& track_stream(uint32_t stream_id);
+    void mark_end_stream(HTTP2Direction direction, uint32_t stream_id);
+    [[nodiscard]] bool fail(std::string message);
+    [[nodiscard]] static bool strip_padding(const HTTP2FrameHeader& header, std::span<const uint8_t>& payload,
+                                            size_t prefix_bytes);
+};
+
+} // namespace protocol_parser::parsers
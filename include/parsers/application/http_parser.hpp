@@ -1,7 +1,10 @@
 #pragma once
 
 #include "../base_parser.hpp"
+#include <array>
+#include <functional>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 #include <cstdint>
@@ -71,11 +74,43 @@ struct HTTPMessage {
     HTTPMessage& operator=(HTTPMessage&&) = default;
 };
 
+// Zero-copy header field, viewing into the packet
+struct HTTPHeaderView {
+    std::string_view name;
+    std::string_view value;
+};
+
+// Zero-copy parse result. Start line, URI, headers and body are views into the
+// parsed buffer and must not outlive it. Headers live in a fixed inline array,
+// so parsing does not allocate.
+struct HTTPMessageView {
+    static constexpr size_t kMaxHeaders = 64;
+
+    HTTPMessageType type = HTTPMessageType::UNKNOWN;
+    HTTPMethod method = HTTPMethod::UNKNOWN;
+    HTTPVersion version = HTTPVersion::UNKNOWN;
+    uint16_t status_code = 0;
+    std::string_view start_line;
+    std::string_view uri;
+    std::string_view reason_phrase;
+    std::array<HTTPHeaderView, kMaxHeaders> headers{};
+    size_t header_count = 0;
+    size_t header_length = 0;      // bytes of start line + headers + empty line
+    std::string_view body;         // Content-Length bodies only
+
+    // Case-insensitive lookup, returns an empty view if absent
+    [[nodiscard]] std::string_view find_header(std::string_view name) const noexcept;
+};
+
 class HTTPParser : public BaseParser {
 public:
     HTTPParser() = default;
     ~HTTPParser() = default;
 
+    // Parses one message starting at context.offset and advances the offset past it,
+    // so pipelined and keep-alive messages in the same buffer are parsed by calling
+    // parse() again. An incomplete body returns NeedMoreData with all bytes consumed;
+    // the next parse() call continues the body from the new buffer's offset.
     [[nodiscard]] ParseResult parse(ParseContext& context) noexcept override;
     [[nodiscard]] const ProtocolInfo& get_protocol_info() const noexcept override;
     [[nodiscard]] bool can_parse(const BufferView& buffer) const noexcept override;
@@ -89,6 +124,28 @@ public:
     [[nodiscard]] bool is_response() const;
     [[nodiscard]] bool is_complete() const;
 
+    // Zero-copy mode: results are kept as views in get_message_view() and nothing is written to
+    // ParseContext::metadata; the accessors above copy on demand
+    void set_zero_copy(bool enabled) noexcept { zero_copy_ = enabled; }
+    [[nodiscard]] bool zero_copy_enabled() const noexcept { return zero_copy_; }
+    [[nodiscard]] const HTTPMessageView& get_message_view() const noexcept { return message_view_; }
+
+    // Streaming bodies: chunks are passed as views valid only during the call and
+    // are not buffered. Content-Length, chunked (with trailers) and close-delimited
+    // bodies are all delivered this way.
+    using BodyCallback = std::function<void(std::string_view chunk)>;
+    void set_body_callback(BodyCallback callback) { body_callback_ = std::move(callback); }
+
+    // Without a callback the copying mode keeps at most this many body bytes; the rest is
+    // counted in get_body_bytes() but dropped, and is_body_truncated() reports it
+    static constexpr size_t kDefaultMaxBufferedBody = 1 << 20;
+    void set_max_buffered_body(size_t limit) noexcept { max_buffered_body_ = limit; }
+    [[nodiscard]] bool is_body_truncated() const noexcept { return body_truncated_; }
+
+    // Signals end of stream; completes a close-delimited body, fails a truncated one
+    [[nodiscard]] ParseResult finish_stream() noexcept;
+    [[nodiscard]] uint64_t get_body_bytes() const noexcept { return body_bytes_; }
+
     // Request-specific methods
     [[nodiscard]] HTTPMethod get_method() const;
     [[nodiscard]] std::string get_uri() const;
@@ -119,12 +176,58 @@ private:
     bool is_chunked_ = false;
     std::string error_message_;
 
+    // Resumable body state
+    enum class BodyState : uint8_t {
+        NONE,
+        FIXED,              // Content-Length
+        CHUNK_SIZE,
+        CHUNK_EXTENSION,    // chunk extensions up to the end of the size line
+        CHUNK_DATA,
+        CHUNK_DATA_END,     // CRLF after chunk data
+        TRAILER_START,
+        TRAILER_FIELD,
+        TRAILER_END,
+        UNTIL_CLOSE,        // close-delimited response
+        DONE
+    };
+
+    static constexpr size_t kMaxTrailerLine = 8192;
+    bool has_content_length_ = false;
+    BodyState body_state_ = BodyState::NONE;
+    uint64_t body_remaining_ = 0;     // bytes left in the fixed body or current chunk
+    uint64_t body_bytes_ = 0;
+    size_t chunk_size_digits_ = 0;
+    std::string trailer_line_;        // trailer line split across buffers (copying mode only)
+    size_t max_buffered_body_ = kDefaultMaxBufferedBody;
+    bool body_truncated_ = false;
+    BodyCallback body_callback_;
+
+    // Zero-copy mode state
+    bool zero_copy_ = false;
+    HTTPMessageView message_view_;
+    mutable std::unordered_map<std::string, std::string> view_headers_;  // built lazily by get_headers()
+    mutable bool view_headers_ready_ = false;
+
     // Private parsing methods
     [[nodiscard]] ParseResult parse_request_line(const std::string& line);
     [[nodiscard]] ParseResult parse_status_line(const std::string& line);
     [[nodiscard]] ParseResult parse_headers(const std::vector<std::string>& header_lines);
-    [[nodiscard]] ParseResult parse_body(const BufferView& buffer, size_t headers_end_pos);
-    [[nodiscard]] ParseResult parse_chunked_body(const BufferView& buffer, size_t start_pos);
+    [[nodiscard]] ParseResult parse_header_block(const BufferView& buffer, size_t& header_length) noexcept;
+    void store_metadata(ParseContext& context) const;
+
+    // Body state machine; pos is advanced past the consumed bytes
+    void begin_body() noexcept;
+    [[nodiscard]] bool body_in_progress() const noexcept {
+        return body_state_ != BodyState::NONE && body_state_ != BodyState::DONE;
+    }
+    [[nodiscard]] ParseResult parse_body(const BufferView& buffer, size_t& pos) noexcept;
+    [[nodiscard]] ParseResult parse_chunked_body(const BufferView& buffer, size_t& pos);
+    void emit_body(std::string_view chunk);
+    void record_trailer(std::string_view line);
+
+    // Zero-copy parsing path
+    [[nodiscard]] ParseResult parse_zero_copy(const BufferView& buffer, size_t& header_length) noexcept;
+    [[nodiscard]] ParseResult parse_view_start_line(std::string_view line) noexcept;
 
     [[nodiscard]] std::vector<std::string> split_lines(const std::string& data) const;
     [[nodiscard]] size_t find_headers_end(const BufferView& buffer) const;
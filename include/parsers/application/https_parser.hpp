@@ -2,6 +2,10 @@
 #define HTTPS_PARSER_HPP
 
 #include "../base_parser.hpp"
+#include "tls_fingerprint.hpp"
+#include "tls_record_layer.hpp"
+#include "x509_certificate.hpp"
+#include <memory>
 #include <string>
 #include <vector>
 #include <map>
@@ -176,6 +180,8 @@ struct Certificate {
     std::string not_before;
     std::string not_after;
     std::vector<std::string> san_dns_names;  // Subject Alternative Names
+    utils::SHA256::Digest sha256{};          // Fingerprint of raw_data
+    std::shared_ptr<const X509CacheEntry> parsed;  // Decoded view (key type/size, signature algorithm, ...)
     
     Certificate() {}
 };
@@ -198,6 +204,7 @@ struct TLSSession {
     std::string server_name;  // SNI
     std::vector<Certificate> certificates;
     bool is_resumed_session;
+    TLSFingerprints fingerprints;  // JA3/JA4 from ClientHello, JA3S from ServerHello
     
     TLSSession() : state(TLSConnectionState::INITIAL), 
                   negotiated_version(TLSVersion::UNKNOWN),
@@ -284,23 +291,49 @@ public:
     TLSConnectionState get_connection_state() const { return current_session_.state; }
     TLSVersion get_negotiated_version() const { return current_session_.negotiated_version; }
     std::string get_server_name() const { return current_session_.server_name; }
+    const TLSFingerprints& get_fingerprints() const noexcept { return current_session_.fingerprints; }
+    
+    // Fingerprint-only mode: hellos are only scanned (SNI, version, cipher, fingerprints),
+    // the ClientHello/ServerHello structs stay empty and no HTTPSMessage is published;
+    // context.metadata["tls_fingerprints"] holds the session's TLSFingerprints instead
+    void set_fingerprint_only(bool enabled) noexcept { fingerprint_only_ = enabled; }
+    bool fingerprint_only_enabled() const noexcept { return fingerprint_only_; }
+    
+    // Shared across parsers so repeated certificates are decoded once; without a cache
+    // every certificate is decoded on its own
+    void set_certificate_cache(std::shared_ptr<X509CertificateCache> cache) { certificate_cache_ = std::move(cache); }
+    
+    // Direction of the next parse() input; a hello at a message boundary sets it automatically
+    void set_direction(TLSDirection direction) noexcept { direction_ = direction; }
+    TLSDirection get_direction() const noexcept { return direction_; }
+    
+    // Handshake is over; the rest of the flow can bypass inspection
+    bool is_handshake_done() const noexcept { return record_layer_.handshake_done(); }
+    const TLSRecordLayer& get_record_layer() const noexcept { return record_layer_; }
     
     // Statistics
     size_t get_handshake_messages_parsed() const { return handshake_messages_parsed_; }
-    size_t get_application_data_records() const { return application_data_records_; }
+    size_t get_application_data_records() const { return record_layer_.statistics().application_records; }
     size_t get_alert_messages() const { return alert_messages_; }
     
 private:
     TLSSession current_session_;
-    std::vector<uint8_t> buffer_;  // For handling fragmented records
+    TLSRecordLayer record_layer_;   // Reassembles handshake messages across records and segments
+    TLSDirection direction_ = TLSDirection::CLIENT_TO_SERVER;
+    ParseContext* active_context_ = nullptr;
+    std::shared_ptr<X509CertificateCache> certificate_cache_;
+    bool fingerprint_only_ = false;
     
     // Statistics
     size_t handshake_messages_parsed_;
-    size_t application_data_records_;
     size_t alert_messages_;
     
     // Helper methods
     void reset_session();
+    void on_handshake(std::span<const uint8_t> message);
+    void on_alert(uint8_t level, uint8_t description);
+    void on_handshake_done(uint16_t version);
+    void publish(HTTPSMessage& message);
     uint16_t read_uint16(const uint8_t* data);
     uint32_t read_uint24(const uint8_t* data);
     uint32_t read_uint32(const uint8_t* data);
@@ -1,12 +1,17 @@
 #pragma once
 
 #include "../base_parser.hpp"
+#include "mqtt_usage_collector.hpp"
+#include <algorithm>
 #include <vector>
 #include <string>
+#include <string_view>
+#include <span>
 #include <optional>
 #include <variant>
-#include <unordered_map>
+#include <functional>
 #include <memory>
+#include <unordered_map>
 
 // 简化类型别名
 using BufferView = protocol_parser::core::BufferView;
@@ -169,11 +174,13 @@ struct MQTTConnackMessage {
 };
 
 // MQTT PUBLISH消息
+// topic 与 payload 指向输入缓冲区（或解析器内部的跨片段缓冲），在下一次 parse() 前有效
 struct MQTTPublishMessage {
-    std::string topic;
+    std::string_view topic;        // MQTT 5.0 只带主题别名时为别名登记的主题，别名未知时为空
+    uint16_t topic_alias{0};       // MQTT 5.0 Topic Alias 属性，0 表示未使用
     uint16_t packet_id{0};         // QoS > 0时需要
     std::vector<MQTTProperty> properties;  // MQTT 5.0
-    std::vector<uint8_t> payload;
+    std::span<const uint8_t> payload;
 
     [[nodiscard]] bool validate() const noexcept;
     [[nodiscard]] std::string payload_as_string() const;
@@ -218,9 +225,24 @@ struct MQTTPacket {
     }
 };
 
-// MQTT解析器
+/**
+ * MQTT解析器
+ *
+ * parse() 按字节流处理：一个 TCP 片段中的多个控制包逐个解析，
+ * 跨片段的不完整包缓存在解析器内，下个片段到来后补全；片段总是被整体消费。
+ * 每个完整的包通过 PacketCallback 回调，get_mqtt_packet() 返回最后一个包。
+ * 剩余长度给出了包边界，单个包内容错误时跳过该包继续解析；
+ * 剩余长度编码错误或超出 max_packet_size 时流失去同步，需 reset()。
+ *
+ * 流中出现 CONNECT 后按其协议版本解析 MQTT 5.0 属性；
+ * 只看到服务端方向或连接中途开始抓包时用 set_protocol_version() 指定。
+ * MQTT 5.0 主题别名按本解析器的字节流方向记录（至多 MAX_TOPIC_ALIASES 个），
+ * 只带别名的 PUBLISH 在统计与回调前换成登记的主题。
+ */
 class MQTTParser : public BaseParser {
 public:
+    using PacketCallback = std::function<void(const MQTTPacket&)>;
+
     explicit MQTTParser() = default;
     ~MQTTParser() override = default;
 
@@ -239,6 +261,21 @@ public:
     [[nodiscard]] const MQTTPacket& get_mqtt_packet() const noexcept;
     [[nodiscard]] bool is_mqtt_packet() const noexcept;
 
+    // 流式解析配置
+    void set_packet_callback(PacketCallback callback) { packet_callback_ = std::move(callback); }
+    void set_protocol_version(MQTTVersion version) noexcept { protocol_version_ = version; }
+    [[nodiscard]] MQTTVersion get_protocol_version() const noexcept { return protocol_version_; }
+    // 单个包（含固定头部）的上限，也是跨片段缓存的上限
+    void set_max_packet_size(size_t size) noexcept { max_packet_size_ = std::min(size, MAX_PACKET_SIZE + 5); }
+    [[nodiscard]] size_t buffered_bytes() const noexcept { return partial_packet_.size(); }
+
+    // 高频主题/客户端与订阅匹配的汇总：同一采集点的解析器应共享一个实例；
+    // 未设置时在首次 CONNECT/PUBLISH/SUBSCRIBE 时创建解析器私有的实例；SUBSCRIBE 的过滤器自动登记
+    void set_usage_collector(std::shared_ptr<MQTTUsageCollector> collector) noexcept {
+        usage_collector_ = std::move(collector);
+    }
+    [[nodiscard]] const std::shared_ptr<MQTTUsageCollector>& usage_collector() const noexcept { return usage_collector_; }
+
     // 验证和安全检查
     [[nodiscard]] bool validate_packet() const noexcept;
     [[nodiscard]] bool is_malformed() const noexcept;
@@ -278,11 +315,12 @@ public:
         uint64_t v3_1_count{0};
         uint64_t v3_1_1_count{0};
         uint64_t v5_0_count{0};
-        std::unordered_map<std::string, uint64_t> topic_usage;
-        std::unordered_map<std::string, uint64_t> client_usage;
+        uint64_t publish_bytes{0};         // PUBLISH 载荷字节数
+        uint64_t unmatched_publish{0};     // 未匹配任何订阅的 PUBLISH（未登记订阅时不计）
     };
 
     [[nodiscard]] const MQTTStatistics& get_statistics() const noexcept;
+    // 只重置本解析器的计数，用量汇总通过 usage_collector()->reset_counters() 重置
     void reset_statistics() noexcept;
 
     // 工具方法
@@ -290,8 +328,8 @@ public:
     [[nodiscard]] static std::string version_to_string(MQTTVersion version) noexcept;
     [[nodiscard]] static std::string qos_to_string(MQTTQoS qos) noexcept;
     [[nodiscard]] static std::string return_code_to_string(MQTTConnectReturnCode code) noexcept;
-    [[nodiscard]] static bool is_valid_topic(const std::string& topic) noexcept;
-    [[nodiscard]] static bool is_wildcard_topic(const std::string& topic) noexcept;
+    [[nodiscard]] static bool is_valid_topic(std::string_view topic) noexcept;
+    [[nodiscard]] static bool is_wildcard_topic(std::string_view topic) noexcept;
 
     // 公开常量
     static constexpr uint16_t MQTT_DEFAULT_PORT = 1883;     // 标准MQTT端口
@@ -301,6 +339,8 @@ public:
     static constexpr size_t MAX_PACKET_SIZE = 268435455;    // 最大包大小 (256MB - 1)
     static constexpr size_t MAX_TOPIC_LENGTH = 65535;       // 最大主题长度
     static constexpr size_t MAX_CLIENT_ID_LENGTH = 23;      // 推荐客户端ID长度
+    static constexpr size_t DEFAULT_MAX_PACKET_SIZE = 16 * 1024 * 1024;
+    static constexpr size_t MAX_TOPIC_ALIASES = 1024;       // 记录的主题别名上限
 
 private:
     MQTTPacket mqtt_packet_;
@@ -308,6 +348,22 @@ private:
     bool is_malformed_{false};
     MQTTStatistics statistics_;
 
+    // 流状态
+    MQTTVersion protocol_version_{MQTTVersion::MQTT_3_1_1};
+    size_t max_packet_size_{DEFAULT_MAX_PACKET_SIZE};
+    std::vector<uint8_t> partial_packet_;      // 跨片段的不完整包
+    std::vector<uint8_t> completed_packet_;    // 由 partial_packet_ 补全的包，视图在下一次 parse() 前有效
+    bool stream_failed_{false};
+    PacketCallback packet_callback_;
+    std::shared_ptr<MQTTUsageCollector> usage_collector_;
+    std::unordered_map<uint16_t, std::string> topic_aliases_;  // 主题别名 -> 主题
+
+    MQTTUsageCollector& usage_collector_for_update();
+
+    // 流式处理
+    [[nodiscard]] ParseResult measure_packet(std::span<const uint8_t> data, size_t& total) const noexcept;
+    bool process_packet(std::span<const uint8_t> packet);
+
     // 私有解析方法
     [[nodiscard]] ParseResult parse_fixed_header(const uint8_t* data, size_t size, size_t& offset) noexcept;
     [[nodiscard]] ParseResult parse_variable_header(const uint8_t* data, size_t size, size_t& offset) noexcept;
@@ -320,21 +376,30 @@ private:
     [[nodiscard]] ParseResult parse_subscribe_message(const uint8_t* data, size_t size, size_t& offset) noexcept;
 
     // 工具方法
-    [[nodiscard]] uint32_t decode_remaining_length(const uint8_t* data, size_t size, size_t& offset) noexcept;
-    [[nodiscard]] std::string read_utf8_string(const uint8_t* data, size_t size, size_t& offset) noexcept;
+    // 可变字节整数（剩余长度、属性长度）：最多 4 字节
+    [[nodiscard]] static ParseResult decode_remaining_length(const uint8_t* data, size_t size, size_t& offset,
+                                                             uint32_t& value) noexcept;
+    // 2 字节长度前缀的字符串/二进制数据，返回的视图指向 data
+    [[nodiscard]] static bool read_utf8_string(const uint8_t* data, size_t size, size_t& offset,
+                                               std::string_view& value) noexcept;
     [[nodiscard]] ParseResult parse_properties(const uint8_t* data, size_t size, size_t& offset,
                                               std::vector<MQTTProperty>& properties) noexcept;
+    // 在 [begin, end) 的属性列表中查找 Topic Alias；已知属性截断或别名为 0 时返回 false
+    [[nodiscard]] static bool find_topic_alias(const uint8_t* data, size_t begin, size_t end,
+                                               uint16_t& alias) noexcept;
+    // 登记 PUBLISH 带来的主题别名，或把只带别名的主题换成登记的主题
+    void resolve_topic_alias(MQTTPublishMessage& publish);
 
     // 验证方法
     [[nodiscard]] bool validate_fixed_header() const noexcept;
-    [[nodiscard]] bool validate_topic_name(const std::string& topic) const noexcept;
+    [[nodiscard]] bool validate_topic_name(std::string_view topic) const noexcept;
     [[nodiscard]] bool validate_client_id(const std::string& client_id) const noexcept;
 
     // 安全检查
     void perform_security_analysis() noexcept;
 
     // 统计更新
-    void update_statistics(const MQTTPacket& packet) noexcept;
+    void update_statistics(const MQTTPacket& packet);
 };
 
 } // namespace protocol_parser::parsers
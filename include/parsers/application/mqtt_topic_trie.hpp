@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace protocol_parser::parsers {
+
+/**
+ * MQTT 订阅过滤器前缀树（MQTT 3.1.1 4.7 / MQTT 5.0 4.7）
+ *
+ * - 过滤器按 '/' 分层；'+' 匹配单层，'#' 只能位于末层，匹配本层及以下所有层级
+ *   （"a/#" 同样匹配 "a"）；根层通配符不匹配以 '$' 开头的主题
+ * - 共享订阅 "$share/<组>/<过滤器>" 按其中的过滤器登记
+ * - add() 写入构建树，compile() 把它展平为节点/边数组：
+ *   各节点的子边按层名排序、层名存放在同一字符串池中，匹配时二分查找，不分配内存
+ * - 每个订阅累计匹配到的消息数与载荷字节数
+ */
+class MQTTTopicTrie {
+public:
+    static constexpr uint32_t kNone = UINT32_MAX;
+
+    struct Subscription {
+        std::string filter;
+        uint64_t messages = 0;
+        uint64_t bytes = 0;
+    };
+
+    /**
+     * 登记过滤器，重复的过滤器返回已有编号
+     * @return 过滤器格式错误时返回 false
+     */
+    bool add(std::string_view filter, uint32_t& id);
+
+    // 构建树有变化时重新展平
+    void compile();
+    [[nodiscard]] bool needs_compile() const noexcept { return dirty_; }
+
+    /**
+     * 对每个匹配 topic 的订阅调用 fn(id)，使用最近一次 compile() 的结果
+     */
+    template <typename Fn>
+    void match(std::string_view topic, Fn&& fn) const;
+
+    /**
+     * 匹配并累计一条 PUBLISH，必要时先 compile()
+     * @return 匹配到的订阅数
+     */
+    size_t record(std::string_view topic, size_t payload_bytes);
+
+    [[nodiscard]] const std::vector<Subscription>& subscriptions() const noexcept { return subscriptions_; }
+    [[nodiscard]] bool empty() const noexcept { return subscriptions_.empty(); }
+
+    void reset_counters() noexcept;
+    void clear();
+
+    [[nodiscard]] static bool is_valid_filter(std::string_view filter) noexcept;
+
+private:
+    struct BuildNode {
+        std::map<std::string, uint32_t, std::less<>> children;
+        uint32_t plus = kNone;       // '+' 子节点
+        uint32_t exact = kNone;      // 在此结束的过滤器
+        uint32_t multi = kNone;      // 以此为前缀、末层为 '#' 的过滤器
+    };
+
+    struct Node {
+        uint32_t first_edge = 0;
+        uint32_t edge_count = 0;
+        uint32_t plus = kNone;
+        uint32_t exact = kNone;
+        uint32_t multi = kNone;
+    };
+
+    struct Edge {
+        uint32_t text_offset = 0;
+        uint32_t text_length = 0;
+        uint32_t node = 0;
+    };
+
+    std::vector<BuildNode> build_;
+    std::vector<Subscription> subscriptions_;
+
+    std::vector<Node> nodes_;
+    std::vector<Edge> edges_;
+    std::string text_;
+    bool dirty_ = false;
+
+    [[nodiscard]] uint32_t find_child(const Node& node, std::string_view level) const noexcept;
+
+    template <typename Fn>
+    void match_node(uint32_t index, std::string_view topic, size_t position, bool root, Fn& fn) const;
+};
+
+template <typename Fn>
+void MQTTTopicTrie::match(std::string_view topic, Fn&& fn) const {
+    if (nodes_.empty() || topic.empty()) {
+        return;
+    }
+    match_node(0, topic, 0, true, fn);
+}
+
+template <typename Fn>
+void MQTTTopicTrie::match_node(uint32_t index, std::string_view topic, size_t position, bool root, Fn& fn) const {
+    const Node& node = nodes_[index];
+    // 根层的 '+'/'#' 不匹配 "$SYS/..." 这类主题
+    const bool wildcards = !(root && topic[0] == '$');
+
+    if (node.multi != kNone && wildcards) {
+        fn(node.multi);
+    }
+    // position 越过末尾表示所有层都已消耗
+    if (position > topic.size()) {
+        if (node.exact != kNone) {
+            fn(node.exact);
+        }
+        return;
+    }
+
+    const size_t slash = topic.find('/', position);
+    const size_t end = slash == std::string_view::npos ? topic.size() : slash;
+    const size_t next = end + 1;
+
+    const uint32_t child = find_child(node, topic.substr(position, end - position));
+    if (child != kNone) {
+        match_node(child, topic, next, false, fn);
+    }
+    if (node.plus != kNone && wildcards) {
+        match_node(node.plus, topic, next, false, fn);
+    }
+}
+
+} // namespace protocol_parser::parsers
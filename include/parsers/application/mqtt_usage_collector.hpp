@@ -0,0 +1,68 @@
+#pragma once
+
+#include "mqtt_topic_trie.hpp"
+#include "utils/heavy_hitters.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+namespace protocol_parser::parsers {
+
+/**
+ * MQTT 用量汇总：高频主题/客户端与订阅过滤器的匹配计数
+ *
+ * 每个连接一个 MQTTParser，而汇总应跨连接：同一采集点的所有解析器通过
+ * MQTTParser::set_usage_collector() 共享一个实例，内存只占一份且发布方与订阅方的计数合并。
+ * 未注入时解析器在首次需要时创建自己的实例。
+ * - 高频统计为固定内存的 Space-Saving，不同键再多也不增长
+ * - 解析器把 SUBSCRIBE 中的过滤器自动登记，也可调用 add_subscription() 预先登记；
+ *   超过 max_subscriptions 的新过滤器不再登记
+ * 解析器可能位于不同线程，各操作由内部互斥量串行化
+ */
+class MQTTUsageCollector {
+public:
+    struct Config {
+        size_t top_k_capacity = 1024;        // 高频主题/客户端各自跟踪的键数
+        size_t max_subscriptions = 4096;     // 登记的订阅过滤器上限
+    };
+
+    MQTTUsageCollector();
+    explicit MQTTUsageCollector(const Config& config);
+
+    MQTTUsageCollector(const MQTTUsageCollector&) = delete;
+    MQTTUsageCollector& operator=(const MQTTUsageCollector&) = delete;
+
+    void record_connect(std::string_view client_id);
+
+    /**
+     * 累计一条 PUBLISH：主题计入高频统计，并与已登记的过滤器匹配
+     * @return 匹配到的订阅数；未登记任何过滤器时返回 kNoSubscriptions
+     */
+    size_t record_publish(std::string_view topic, size_t payload_bytes);
+    static constexpr size_t kNoSubscriptions = SIZE_MAX;
+
+    /**
+     * 登记订阅过滤器，重复的过滤器不重复登记
+     * @return 过滤器格式错误或已达 max_subscriptions 时返回 false
+     */
+    bool add_subscription(std::string_view filter);
+
+    // 以下查询返回副本，调用结束后仍有效
+    [[nodiscard]] std::vector<utils::HeavyHitterSketch::Entry> top_topics(size_t k) const;
+    [[nodiscard]] std::vector<utils::HeavyHitterSketch::Entry> top_clients(size_t k) const;
+    [[nodiscard]] std::vector<MQTTTopicTrie::Subscription> subscriptions() const;
+
+    void reset_counters();
+    void clear();
+
+private:
+    Config config_;
+    mutable std::mutex mutex_;
+    utils::HeavyHitterSketch topic_usage_;
+    utils::HeavyHitterSketch client_usage_;
+    MQTTTopicTrie subscriptions_;
+};
+
+} // namespace protocol_parser::parsers
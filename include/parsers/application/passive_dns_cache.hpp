@@ -0,0 +1,123 @@
+#pragma once
+
+#include "parsers/application/dns_parser.hpp"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string_view>
+#include <unordered_map>
+
+namespace protocol_parser::parsers {
+
+// IPv6 address or IPv4-mapped IPv6 address (::ffff:a.b.c.d)
+struct PassiveDNSAddress {
+    std::array<uint8_t, 16> bytes{};
+
+    // ipv4 in host byte order: a.b.c.d == (a << 24) | (b << 16) | (c << 8) | d
+    [[nodiscard]] static PassiveDNSAddress from_ipv4(uint32_t ipv4) noexcept;
+    [[nodiscard]] static PassiveDNSAddress from_ipv6(std::span<const uint8_t, 16> ipv6) noexcept;
+    [[nodiscard]] bool operator==(const PassiveDNSAddress& other) const noexcept = default;
+};
+
+// Result of a lookup, copied out so it stays valid after the cache moves on
+struct PassiveDNSName {
+    std::array<char, DNSMessageView::kMaxNameLength> data{};
+    uint8_t length = 0;
+    uint64_t expires_at_us = 0;
+
+    [[nodiscard]] std::string_view view() const noexcept { return {data.data(), length}; }
+    [[nodiscard]] bool empty() const noexcept { return length == 0; }
+};
+
+/**
+ * Passive DNS store: resolved address -> queried name.
+ * - Fixed-capacity table; an address probes a window of kProbeWindow slots and, when the
+ *   window is full, replaces the entry that expires first.
+ * - Each slot is a seqlock. Readers never block and never touch freed memory: a lookup
+ *   retries a few times if it races with a writer and reports a miss after that.
+ * - Names are interned in a byte ring. An entry whose name has been overwritten by newer
+ *   names reads as a miss, so memory stays bounded regardless of TTLs.
+ * - Entry lifetime is the record TTL clamped to [min_ttl, max_ttl].
+ * Writers (observe/insert/clear) are serialized internally.
+ */
+class PassiveDNSCache {
+public:
+    static constexpr size_t kProbeWindow = 8;
+
+    struct Config {
+        size_t capacity = 65536;                  // Address slots, rounded up to a power of two
+        size_t name_arena_bytes = 4 * 1024 * 1024; // Interned name ring, rounded up to a power of two
+        uint32_t min_ttl_seconds = 60;
+        uint32_t max_ttl_seconds = 86400;
+    };
+
+    struct Statistics {
+        uint64_t responses_observed = 0;
+        uint64_t records_inserted = 0;
+        uint64_t records_refreshed = 0;
+        uint64_t evictions = 0;                   // Live entry replaced because its window was full
+        uint64_t names_interned = 0;
+    };
+
+    PassiveDNSCache();
+    explicit PassiveDNSCache(const Config& config);
+
+    PassiveDNSCache(const PassiveDNSCache&) = delete;
+    PassiveDNSCache& operator=(const PassiveDNSCache&) = delete;
+
+    /**
+     * Records the A/AAAA answers of a successful response under the first question's name
+     * (CNAME chains collapse onto the name the client asked for).
+     */
+    void observe(const DNSMessageView& response, uint64_t now_us);
+
+    void insert(const PassiveDNSAddress& address, std::string_view name, uint32_t ttl_seconds, uint64_t now_us);
+
+    [[nodiscard]] bool lookup(uint32_t ipv4, uint64_t now_us, PassiveDNSName& out) const noexcept {
+        return lookup(PassiveDNSAddress::from_ipv4(ipv4), now_us, out);
+    }
+    [[nodiscard]] bool lookup(const PassiveDNSAddress& address, uint64_t now_us, PassiveDNSName& out) const noexcept;
+
+    [[nodiscard]] size_t capacity() const noexcept { return mask_ + 1; }
+    [[nodiscard]] Statistics statistics() const;
+
+    void clear();
+
+private:
+    static constexpr int kReadAttempts = 4;
+
+    struct Slot {
+        std::atomic<uint32_t> sequence{0};        // Odd while a writer is updating the slot
+        std::array<std::atomic<uint32_t>, 4> address{};
+        std::atomic<uint64_t> name_position{0};   // Absolute position in the name ring
+        std::atomic<uint32_t> name_length{0};
+        std::atomic<uint64_t> expires_at_us{0};   // 0 = empty
+    };
+
+    struct InternedName {
+        uint64_t position = 0;
+        uint32_t length = 0;
+    };
+
+    std::unique_ptr<Slot[]> slots_;
+    size_t mask_ = 0;
+
+    std::unique_ptr<std::atomic<char>[]> arena_;
+    size_t arena_mask_ = 0;
+    std::atomic<uint64_t> arena_head_{0};         // Bytes ever written to the ring
+
+    Config config_;
+    mutable std::mutex writer_mutex_;
+    std::unordered_map<uint64_t, InternedName> interned_;   // Writer-only: name hash -> latest copy
+    Statistics stats_;
+
+    [[nodiscard]] size_t home_slot(const PassiveDNSAddress& address) const noexcept;
+    [[nodiscard]] InternedName intern(std::string_view name);
+    [[nodiscard]] bool arena_contains(uint64_t position, uint32_t length) const noexcept;
+    void insert_locked(const PassiveDNSAddress& address, const InternedName& name, uint64_t expires_at_us, uint64_t now_us);
+};
+
+} // namespace protocol_parser::parsers
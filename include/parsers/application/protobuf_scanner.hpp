@@ -0,0 +1,141 @@
+#pragma once
+
+#include "../../core/buffer_view.hpp"
+#include <cstdint>
+#include <initializer_list>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace protocol_parser::parsers {
+
+using protocol_parser::core::BufferView;
+
+/// Protocol Buffers 线格式类型
+enum class ProtobufWireType : uint8_t {
+    VARINT = 0,             ///< int32/int64/uint*/sint*/bool/enum
+    FIXED64 = 1,            ///< fixed64/sfixed64/double
+    LENGTH_DELIMITED = 2,   ///< string/bytes/嵌套消息/packed repeated
+    START_GROUP = 3,        ///< 已废弃的 group 开始
+    END_GROUP = 4,          ///< 已废弃的 group 结束
+    FIXED32 = 5             ///< fixed32/sfixed32/float
+};
+
+/**
+ * 扫描得到的单个字段
+ * bytes 指向原始缓冲区，不复制；数值类字段的值在 value 中
+ */
+struct ProtobufField {
+    uint32_t number = 0;                            ///< 字段号，0 表示无效
+    ProtobufWireType wire_type = ProtobufWireType::VARINT;
+    uint64_t value = 0;                             ///< VARINT/FIXED64/FIXED32 的原始值
+    std::span<const uint8_t> bytes;                 ///< LENGTH_DELIMITED/START_GROUP 的内容
+    size_t offset = 0;                              ///< 标签在消息中的偏移
+
+    [[nodiscard]] bool valid() const noexcept { return number != 0; }
+    [[nodiscard]] int64_t as_sint64() const noexcept {   // ZigZag 解码
+        return static_cast<int64_t>((value >> 1) ^ (~(value & 1) + 1));
+    }
+    [[nodiscard]] std::string_view as_string() const noexcept {
+        return {reinterpret_cast<const char*>(bytes.data()), bytes.size()};
+    }
+};
+
+/**
+ * 无模式的 Protocol Buffers 线格式惰性扫描器
+ * 每次 next() 只解码一个标签和它的值，嵌套消息以视图返回，
+ * 需要时再用新的扫描器下钻
+ */
+class ProtobufScanner {
+public:
+    static constexpr size_t kMaxDepth = 32;             ///< 嵌套消息/group 的最大深度
+    static constexpr size_t kMaxVarintLength = 10;
+
+    explicit ProtobufScanner(const BufferView& buffer) noexcept
+        : data_(buffer.data()), size_(buffer.size()) {}
+    explicit ProtobufScanner(std::span<const uint8_t> data) noexcept
+        : data_(data.data()), size_(data.size()) {}
+
+    /**
+     * 读取下一个字段
+     * @return 到达末尾或遇到非法编码时返回 false，二者由 failed() 区分
+     */
+    [[nodiscard]] bool next(ProtobufField& field) noexcept;
+
+    [[nodiscard]] bool done() const noexcept { return position_ >= size_ && !failed_; }
+    [[nodiscard]] bool failed() const noexcept { return failed_; }
+    [[nodiscard]] size_t position() const noexcept { return position_; }
+
+    /**
+     * 解码 varint
+     * 剩余字节不少于 8 个时一次读入 8 字节，用停止位掩码确定长度并无分支地拼接 7 位分组
+     * @param length 输出消耗的字节数
+     * @return 截断或超过 10 字节时返回 false
+     */
+    [[nodiscard]] static bool decode_varint(const uint8_t* data, size_t size,
+                                            uint64_t& value, size_t& length) noexcept;
+
+    /**
+     * 遍历顶层字段，检查缓冲区是否恰好由合法的 protobuf 字段组成
+     * LENGTH_DELIMITED 内容不下钻：子消息与 bytes 在线格式上无法区分
+     */
+    [[nodiscard]] static bool is_valid_message(std::span<const uint8_t> data) noexcept;
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    size_t position_ = 0;
+    bool failed_ = false;
+
+    [[nodiscard]] bool fail() noexcept { failed_ = true; return false; }
+    [[nodiscard]] bool read_tag(uint32_t& number, ProtobufWireType& wire_type) noexcept;
+    [[nodiscard]] bool skip_group(uint32_t number, size_t depth, size_t& content_end) noexcept;
+    [[nodiscard]] bool read_value(ProtobufWireType wire_type, ProtobufField& field, size_t depth) noexcept;
+};
+
+/**
+ * 字段投影：只提取预先登记的字段路径
+ * 路径是逐层的字段号，例如 {2, 1} 表示字段 2 子消息中的字段 1；
+ * 只下钻路径前缀上的子消息，所有路径命中后立即停止扫描
+ */
+class ProtobufProjection {
+public:
+    ProtobufProjection();
+
+    /**
+     * 登记字段路径
+     * @return 结果槽位下标；路径为空或过深时返回 SIZE_MAX
+     */
+    size_t add_path(std::initializer_list<uint32_t> path);
+    size_t add_path(std::span<const uint32_t> path);
+
+    [[nodiscard]] size_t slot_count() const noexcept { return slot_count_; }
+
+    /**
+     * 提取字段，每个槽位记录首次出现的值；未命中的槽位 number 为 0
+     * 消息被截断时返回截断前已命中的字段
+     * @return 命中的槽位数
+     */
+    size_t extract(std::span<const uint8_t> message, std::vector<ProtobufField>& values) const;
+    size_t extract(const BufferView& message, std::vector<ProtobufField>& values) const {
+        return extract(message.as_span(), values);
+    }
+
+private:
+    static constexpr size_t kNoSlot = SIZE_MAX;
+
+    // 路径按字段号组织成前缀树，节点平铺存放
+    struct Node {
+        uint32_t number = 0;
+        size_t slot = kNoSlot;
+        std::vector<uint32_t> children;
+    };
+
+    std::vector<Node> nodes_;
+    size_t slot_count_ = 0;
+
+    void extract_node(std::span<const uint8_t> message, const Node& node, size_t depth,
+                      std::vector<ProtobufField>& values, size_t& found) const;
+};
+
+} // namespace protocol_parser::parsers
@@ -0,0 +1,232 @@
+#pragma once
+
+#include "core/expected_flow_table.hpp"
+#include "parsers/application/sip_parser.hpp"
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace protocol_parser::parsers {
+
+/**
+ * 媒体端点：IPv6 地址（IPv4 使用 ::ffff:a.b.c.d 映射形式）+ UDP 端口
+ */
+struct SipMediaEndpoint {
+    std::array<uint8_t, 16> address{};
+    uint16_t port = 0;
+
+    // IPv4 地址为主机字节序的数值（1.2.3.4 -> 0x01020304）
+    [[nodiscard]] static SipMediaEndpoint from_ipv4(uint32_t address, uint16_t port) noexcept;
+    [[nodiscard]] static SipMediaEndpoint from_ipv6(std::span<const uint8_t, 16> address, uint16_t port) noexcept;
+    // 点分 IPv4 或 RFC 4291 文本形式的 IPv6；主机名返回 false
+    [[nodiscard]] static bool from_text(std::string_view address, uint16_t port, SipMediaEndpoint& out) noexcept;
+
+    [[nodiscard]] bool operator==(const SipMediaEndpoint& other) const noexcept = default;
+};
+
+enum class SipDialogState : uint8_t {
+    Early,          // INVITE 已发出，尚无 2xx
+    Confirmed,      // 收到 INVITE 的 2xx
+    Terminated      // BYE、CANCEL 或 INVITE 的失败终结响应
+};
+
+// SDP 的发送方：与初始 INVITE 的 From tag 比较得出
+enum class SipParty : uint8_t {
+    Caller = 0,
+    Callee = 1
+};
+
+/**
+ * 一个 SDP 媒体段协商出的接收端点与按端点累计的媒体流量
+ */
+struct SipMediaStream {
+    static constexpr size_t kMaxFormats = 8;
+
+    struct Format {
+        uint8_t payload_type = 0;
+        uint32_t clock_rate = 0;
+    };
+
+    SipParty owner = SipParty::Caller;   // 声明该端点的一方
+    SdpMediaType type = SdpMediaType::Other;
+    SipMediaEndpoint rtp;
+    SipMediaEndpoint rtcp;               // rtcp-mux 时与 rtp 相同；RTCP 端口未知时端口为 0，不登记
+    std::array<Format, kMaxFormats> formats{};
+    uint8_t format_count = 0;
+
+    uint64_t rtp_packets = 0;
+    uint64_t rtp_bytes = 0;
+    uint64_t rtcp_packets = 0;
+    uint64_t rtcp_bytes = 0;
+
+    // 载荷类型对应的时钟频率，未协商时返回 0
+    [[nodiscard]] uint32_t clock_rate(uint8_t payload_type) const noexcept;
+};
+
+struct SipDialog {
+    static constexpr size_t kMaxStreams = 8;
+
+    uint64_t id = 0;                     // 代数 << 32 | (槽下标 + 1)，非 0 且不复用
+    std::string call_id;
+    std::string caller_tag;              // 初始 INVITE 的 From tag
+    SipDialogState state = SipDialogState::Early;
+    uint16_t final_status = 0;           // INVITE 的终结响应码
+    uint64_t created_us = 0;
+    uint64_t answered_us = 0;
+    uint64_t ended_us = 0;
+    uint64_t last_seen_us = 0;
+    std::array<SipMediaStream, kMaxStreams> streams{};
+    uint8_t stream_count = 0;
+};
+
+/**
+ * RTP/RTCP 包归属到的呼叫与媒体流
+ */
+struct SipMediaMatch {
+    uint64_t dialog = 0;
+    uint8_t stream = 0;
+    bool rtcp = false;
+    bool to_endpoint = true;             // 目的端点命中；false 表示按源端点（对称 RTP）命中
+    SdpMediaType type = SdpMediaType::Other;
+    const SipMediaStream* media = nullptr;   // 在表下一次修改前有效
+};
+
+/**
+ * SIP 会话表：Call-ID -> 对话，并登记 SDP 协商出的 RTP/RTCP 端点
+ *
+ * - INVITE 建立对话；请求与 2xx 响应中的 SDP 按发送方替换该方的媒体端点
+ *   （re-INVITE、UPDATE 同理），端口为 0 的媒体段不登记
+ * - 端点索引为固定容量的开放寻址表（线性探测、后移删除），负载上限 3/4；
+ *   同一端点被新对话声明时归属新对话；同一方的新 SDP 沿用端点未变的媒体流的计数
+ * - classify() 对每个 UDP 包只做一到两次端点查找，命中即确定为 RTP/RTCP 并计入呼叫
+ * - 对话结束后保留 linger_us 以归属尾随的媒体，空闲超过 idle_timeout_us 即过期；
+ *   每次观察顺带清扫 sweep_step 个对话槽，expire() 做一次完整清扫
+ * - 设置预期流表后，登记的端点同时作为 UDP 预期流（"RTP"/"RTCP"，rtcp-mux 端点为 "RTP"，
+ *   会话为对话编号）写入该表，端点撤销时一并撤销；ProtocolDetectionEngine 据此在特征与行为检测之前
+ *   识别媒体流，检测线程不必访问本表
+ * 时间戳由调用方提供（抓包时间，微秒）
+ */
+class SipDialogTable {
+public:
+    struct Config {
+        size_t max_dialogs = 65536;
+        size_t endpoint_capacity = 262144;       // 端点槽位，向上取整为 2 的幂
+        uint64_t idle_timeout_us = 600'000'000;
+        uint64_t linger_us = 5'000'000;
+        size_t sweep_step = 8;
+    };
+
+    struct Statistics {
+        uint64_t dialogs_created = 0;
+        uint64_t dialogs_answered = 0;
+        uint64_t dialogs_failed = 0;             // INVITE 以 3xx-6xx 或 CANCEL 结束
+        uint64_t dialogs_expired = 0;
+        uint64_t offers = 0;                     // 登记过的 SDP
+        uint64_t endpoints_registered = 0;
+        uint64_t media_hits = 0;
+        uint64_t media_misses = 0;
+        uint64_t dropped = 0;                    // 表满，未能创建对话或登记端点
+    };
+
+    SipDialogTable();
+    explicit SipDialogTable(const Config& config);
+
+    /**
+     * 处理一条已解析的 SIP 消息
+     * @return 所属对话编号，不属于任何 INVITE 对话时返回 0
+     */
+    uint64_t observe(const SipParseResult& message, uint64_t now_us);
+
+    /**
+     * 按目的端点、再按源端点查找媒体流，命中时累计包数与字节数
+     * rtcp-mux 端点上按 RFC 5761 4 的包类型范围（192-223）区分 RTCP
+     * @param payload UDP 载荷
+     */
+    bool classify(const SipMediaEndpoint& source, const SipMediaEndpoint& destination,
+                  std::span<const uint8_t> payload, uint64_t now_us, SipMediaMatch& out);
+
+    // 之后登记的端点同时写入预期流表；传入 nullptr 停止写入（已写入的预期按超时过期）
+    void set_expected_flows(std::shared_ptr<core::ExpectedFlowTable> table) noexcept {
+        expected_flows_ = std::move(table);
+    }
+
+    // 只查找不累计；rtcp-mux 端点的 out.rtcp 为 false
+    [[nodiscard]] bool lookup(const SipMediaEndpoint& endpoint, SipMediaMatch& out) const noexcept;
+
+    // RFC 5761 4：第二字节落在 192-223 的包为 RTCP
+    [[nodiscard]] static bool is_rtcp_payload(std::span<const uint8_t> payload) noexcept {
+        return payload.size() >= 2 && payload[1] >= 192 && payload[1] <= 223;
+    }
+
+    [[nodiscard]] const SipDialog* find(uint64_t dialog) const noexcept;
+    [[nodiscard]] const SipDialog* find_by_call_id(std::string_view call_id) const noexcept;
+
+    void expire(uint64_t now_us);
+
+    [[nodiscard]] size_t dialog_count() const noexcept { return call_ids_.size(); }
+    [[nodiscard]] size_t endpoint_count() const noexcept { return live_endpoints_; }
+    [[nodiscard]] const Statistics& statistics() const noexcept { return stats_; }
+
+    void clear();
+
+private:
+    static constexpr uint32_t kNoDialog = UINT32_MAX;
+
+    struct EndpointSlot {
+        uint64_t hash = 0;
+        SipMediaEndpoint endpoint;
+        uint32_t dialog = kNoDialog;             // 对话槽下标
+        uint32_t generation = 0;                 // 登记时对话槽的代数
+        uint8_t stream = 0;
+        bool rtcp = false;
+        bool mux = false;                        // RTP 与 RTCP 共用该端点
+        bool occupied = false;
+    };
+
+    struct Slot {
+        SipDialog dialog;
+        uint32_t generation = 0;
+        bool live = false;
+    };
+
+    Config config_;
+    std::vector<EndpointSlot> endpoints_;
+    size_t mask_ = 0;
+    size_t live_endpoints_ = 0;
+
+    std::vector<Slot> dialogs_;
+    std::vector<uint32_t> free_dialogs_;
+    struct CallIdHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view value) const noexcept { return std::hash<std::string_view>{}(value); }
+    };
+    std::unordered_map<std::string, uint32_t, CallIdHash, std::equal_to<>> call_ids_;
+    size_t sweep_cursor_ = 0;
+    std::shared_ptr<core::ExpectedFlowTable> expected_flows_;
+
+    Statistics stats_;
+
+    [[nodiscard]] static uint64_t hash_endpoint(const SipMediaEndpoint& endpoint) noexcept;
+    [[nodiscard]] size_t find_endpoint(const SipMediaEndpoint& endpoint, uint64_t hash) const noexcept;   // endpoints_.size() 表示不存在
+    [[nodiscard]] bool endpoint_is_live(const EndpointSlot& slot) const noexcept;
+    [[nodiscard]] bool resolve(const SipMediaEndpoint& endpoint, const EndpointSlot*& slot) const noexcept;
+    [[nodiscard]] uint32_t index_of(uint64_t dialog) const noexcept;
+    [[nodiscard]] uint32_t create_dialog(std::string_view call_id, std::string_view caller_tag, uint64_t now_us);
+    void release_dialog(uint32_t index);
+    void register_endpoint(uint32_t index, uint8_t stream, bool rtcp, bool mux, const SipMediaEndpoint& endpoint,
+                           uint64_t now_us);
+    void unregister_endpoint(uint32_t index, const SipMediaEndpoint& endpoint) noexcept;
+    void withdraw_expected(const EndpointSlot& slot) noexcept;
+    void erase_endpoint(size_t index) noexcept;
+    void apply_sdp(uint32_t index, SipParty owner, const SdpSession& sdp, uint64_t now_us);
+    [[nodiscard]] bool is_expired(const SipDialog& dialog, uint64_t now_us) const noexcept;
+    void sweep(uint64_t now_us, size_t budget);
+};
+
+} // namespace protocol_parser::parsers
@@ -1,10 +1,12 @@
 #pragma once
 
 #include "parsers/base_parser.hpp"
-#include <string>
-#include <vector>
-#include <map>
+#include <array>
+#include <cstdint>
 #include <optional>
+#include <span>
+#include <string>
+#include <string_view>
 
 namespace protocol_parser::parsers {
 
@@ -115,51 +117,168 @@ enum class SipResponseCode : uint16_t {
 };
 
 /**
- * SIP 头部字段
+ * 已知 SIP 头部，紧凑形式（RFC 3261 7.3.3 及扩展）映射到同一标识
+ */
+enum class SipHeaderId : uint8_t {
+    Other,
+    Via,                 // v
+    From,                // f
+    To,                  // t
+    CallId,              // i
+    CSeq,
+    Contact,             // m
+    ContentType,         // c
+    ContentLength,       // l
+    ContentEncoding,     // e
+    Supported,           // k
+    Subject,             // s
+    Event,               // o
+    ReferTo,             // r
+    ReferredBy,          // b
+    AllowEvents,         // u
+    SessionExpires,      // x
+    AcceptContact,       // a
+    RejectContact,       // j
+    RequestDisposition,  // d
+    Identity,            // y
+    MaxForwards,
+    UserAgent,
+    Server,
+    Allow,
+    Expires
+};
+
+/**
+ * SIP 头部字段（指向被解析的缓冲区）
+ * 折行的值包含中间的 CRLF 与空白
  */
 struct SipHeader {
-    std::string name;
-    std::string value;
+    std::string_view name;
+    std::string_view value;
+    SipHeaderId id = SipHeaderId::Other;
 };
 
 /**
- * SIP 消息体
+ * SIP 消息体（指向被解析的缓冲区）
  */
 struct SipBody {
-    std::string content_type;
-    std::vector<uint8_t> data;
+    std::string_view content_type;
+    std::span<const uint8_t> data;
+};
+
+// ============================================================================
+// SDP（RFC 8866）
+// ============================================================================
+
+enum class SdpMediaType : uint8_t {
+    Audio,
+    Video,
+    Text,
+    Application,
+    Message,
+    Other
+};
+
+enum class SdpDirection : uint8_t {
+    SendRecv,
+    SendOnly,
+    RecvOnly,
+    Inactive
+};
+
+/**
+ * m= 行中的一个格式；RTP 媒体的静态载荷类型按 RFC 3551 预填，a=rtpmap 覆盖
+ */
+struct SdpRtpMap {
+    uint8_t payload_type = 0;
+    uint8_t channels = 1;
+    uint32_t clock_rate = 0;     // 0 = 未知
+    std::string_view encoding;
+};
+
+struct SdpMedia {
+    static constexpr size_t kMaxFormats = 16;
+
+    SdpMediaType type = SdpMediaType::Other;
+    std::string_view media;          // m= 媒体名
+    std::string_view protocol;       // RTP/AVP、RTP/SAVPF、UDP/TLS/RTP/SAVPF ...
+    std::string_view address;        // 媒体级 c=，没有则继承会话级
+    uint16_t port = 0;               // 0 = 媒体流被拒绝或禁用
+    uint16_t port_count = 1;
+    uint16_t rtcp_port = 0;          // a=rtcp:，没有则为 port + 1；0 = 未知
+    std::string_view rtcp_address;   // a=rtcp: 带地址时
+    bool rtcp_mux = false;           // a=rtcp-mux：RTCP 与 RTP 共用端口
+    SdpDirection direction = SdpDirection::SendRecv;
+    std::array<SdpRtpMap, kMaxFormats> formats{};
+    size_t format_count = 0;         // 超过 kMaxFormats 的格式被忽略
+
+    [[nodiscard]] bool is_rtp() const noexcept;
+    [[nodiscard]] const SdpRtpMap* find_format(uint8_t payload_type) const noexcept;
+};
+
+/**
+ * SDP 会话描述，字段指向 SDP 文本；解析不分配内存
+ */
+struct SdpSession {
+    static constexpr size_t kMaxMedia = 8;
+
+    std::string_view origin_address;       // o= 中的地址
+    std::string_view session_name;         // s=
+    std::string_view connection_address;   // 会话级 c=
+    SdpDirection direction = SdpDirection::SendRecv;
+    std::array<SdpMedia, kMaxMedia> media{};
+    size_t media_count = 0;                // 超过 kMaxMedia 的媒体被忽略
 };
 
 /**
  * SIP 解析结果
+ * 起始行、头部与消息体都指向被解析的缓冲区，不能比它活得更久；
+ * 头部存放在固定的内联数组中，解析不分配内存
  */
 struct SipParseResult {
-    bool is_request;
-    SipMethod method;
-    SipResponseCode response_code;
+    static constexpr size_t kMaxHeaders = 64;
+
+    bool is_request = true;
+    SipMethod method = SipMethod::INVITE;
+    SipResponseCode response_code{};
 
     // 请求行
-    std::string request_uri;
-    std::string sip_version;  // SIP/2.0
+    std::string_view request_uri;
+    std::string_view sip_version;  // SIP/2.0
 
     // 响应行
-    std::string reason_phrase;
+    std::string_view reason_phrase;
 
-    // 头部
-    std::vector<SipHeader> headers;
+    // 头部（超过 kMaxHeaders 的头部仍参与下面的关键头部提取，但不保存）
+    std::array<SipHeader, kMaxHeaders> headers{};
+    size_t header_count = 0;
 
-    // 关键头部（快速访问）
-    std::string from;
-    std::string to;
-    std::string call_id;
-    std::string cseq;
-    std::string via;
-    std::string contact;
-    std::string content_type;
-    size_t content_length;
+    // 关键头部（快速访问，重复出现时取第一个）
+    std::string_view from;
+    std::string_view to;
+    std::string_view call_id;
+    std::string_view cseq;
+    std::string_view via;
+    std::string_view contact;
+    std::string_view content_type;
+    size_t content_length = 0;
+    uint32_t cseq_number = 0;
+    SipMethod cseq_method = SipMethod::INVITE;   // 响应据此关联到请求方法
+    bool cseq_valid = false;
 
     // 消息体
     std::optional<SipBody> body;
+    bool has_sdp = false;
+    SdpSession sdp;
+
+    size_t message_length = 0;     // 起始行到消息体末尾的字节数
+
+    // 按名称查找（不区分大小写，紧凑形式与完整形式等价），不存在时返回空视图
+    [[nodiscard]] std::string_view find_header(std::string_view name) const noexcept;
+    [[nodiscard]] std::string_view find_header(SipHeaderId id) const noexcept;
+
+    [[nodiscard]] std::string_view from_tag() const noexcept;
+    [[nodiscard]] std::string_view to_tag() const noexcept;
 };
 
 /**
@@ -173,6 +292,10 @@ struct SipParseResult {
  * - 视频会议
  * - 即时消息
  * - 在线游戏
+ *
+ * parse() 从 context.offset 解析一个消息并把偏移推进到其后，
+ * 同一 TCP 缓冲区中的后续消息再次调用 parse() 即可；
+ * 头部或 Content-Length 指定的消息体不完整时返回 NeedMoreData 且不移动偏移
  */
 class SipParser : public BaseParser {
 public:
@@ -197,44 +320,50 @@ public:
      */
     [[nodiscard]] static bool is_sip_message(const BufferView& buffer) noexcept;
 
-private:
     /**
-     * 解析请求行
-     * METHOD Request-URI SIP-Version
+     * 头部名称（完整或紧凑形式，不区分大小写）对应的标识
      */
-    [[nodiscard]] bool parse_request_line(const std::string& line);
+    [[nodiscard]] static SipHeaderId header_id(std::string_view name) noexcept;
 
     /**
-     * 解析响应行
-     * SIP-Version Status-Code Reason-Phrase
+     * 取头部值中的参数，如 From 的 tag；name-addr 形式只看 '>' 之后的参数
      */
-    [[nodiscard]] bool parse_response_line(const std::string& line);
+    [[nodiscard]] static std::string_view header_parameter(std::string_view value, std::string_view name) noexcept;
 
     /**
-     * 解析头部
+     * 解析 SDP（会话描述协议）
+     * @return 缺少 v= 行或 m= 行格式错误时返回 false
      */
-    [[nodiscard]] bool parse_headers(const std::vector<std::string>& lines);
+    [[nodiscard]] static bool parse_sdp(std::string_view sdp, SdpSession& session) noexcept;
 
+private:
     /**
-     * 解析消息体
+     * 解析请求行
+     * METHOD Request-URI SIP-Version
      */
-    [[nodiscard]] bool parse_body(const BufferView& buffer, size_t offset);
+    [[nodiscard]] bool parse_request_line(std::string_view line) noexcept;
 
     /**
-     * 查找头部值
+     * 解析响应行
+     * SIP-Version Status-Code Reason-Phrase
      */
-    [[nodiscard]] std::optional<std::string> find_header(
-        const std::string& name) const;
+    [[nodiscard]] bool parse_response_line(std::string_view line) noexcept;
 
     /**
-     * 解析 SDP（会话描述协议）
+     * 记录一个头部并提取关键头部
+     */
+    void add_header(std::string_view name, std::string_view value) noexcept;
+
+    /**
+     * 折行：把上一个头部的值延伸到本行末尾
      */
-    void parse_sdp(const std::string& sdp);
+    void extend_header(const char* line_end) noexcept;
 
     ProtocolInfo protocol_info_;
     SipParseResult result_;
     ParserState state_;
-    std::vector<std::string> header_lines_;
+    SipHeader* last_header_ = nullptr;          // 上一个保存的头部（折行用）
+    std::string_view* last_field_ = nullptr;    // 上一个头部赋值的关键头部字段
 };
 
 } // namespace protocol_parser::parsers
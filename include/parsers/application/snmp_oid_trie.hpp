@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace protocol_parser::parsers {
+
+/**
+ * BER 编码形式的 OID（X.690 8.19，不含标签与长度），零拷贝
+ *
+ * 编码唯一，相等与前缀判断直接比较字节：合法编码的每个子标识符以最高位为 0 的字节结束，
+ * 字节前缀即子标识符前缀。只在展示时才转换为点分十进制
+ */
+struct EncodedOID {
+    std::span<const uint8_t> bytes;
+
+    [[nodiscard]] bool operator==(const EncodedOID& other) const noexcept {
+        return bytes.size() == other.bytes.size() &&
+               (bytes.empty() || std::memcmp(bytes.data(), other.bytes.data(), bytes.size()) == 0);
+    }
+    [[nodiscard]] bool starts_with(const EncodedOID& prefix) const noexcept {
+        return prefix.bytes.size() <= bytes.size() &&
+               (prefix.bytes.empty() || std::memcmp(bytes.data(), prefix.bytes.data(), prefix.bytes.size()) == 0);
+    }
+    [[nodiscard]] size_t hash() const noexcept {
+        return std::hash<std::string_view>{}(
+            std::string_view(reinterpret_cast<const char*>(bytes.data()), bytes.size()));
+    }
+
+    // 弧的个数（首字节编码前两个弧）
+    [[nodiscard]] size_t arc_count() const noexcept;
+    [[nodiscard]] std::string to_string() const;
+
+    // 非空、每个子标识符最小编码且不超过 32 位、以完整子标识符结束
+    [[nodiscard]] static bool is_valid(std::span<const uint8_t> encoded) noexcept;
+    // 点分十进制 -> 编码，至少两个弧
+    [[nodiscard]] static bool encode(std::string_view dotted, std::vector<uint8_t>& out);
+};
+
+struct EncodedOIDHash {
+    size_t operator()(const EncodedOID& oid) const noexcept { return oid.hash(); }
+};
+
+/**
+ * 编码 OID 前缀树（按字节的基数树，边标签做路径压缩）
+ *
+ * - 登记的 OID 视为子树根；match() 按从浅到深的顺序报告查询 OID 所属的全部子树，
+ *   longest_match() 给出最深的一个（MIB 查找），record() 为全部所属子树累计计数
+ * - 查找只做字节比较，不解码弧、不格式化字符串、不分配内存
+ */
+class SNMPOIDTrie {
+public:
+    static constexpr uint32_t kNone = UINT32_MAX;
+
+    struct Subtree {
+        std::vector<uint8_t> oid;            // 编码形式
+        uint64_t hits = 0;
+    };
+
+    /**
+     * 登记子树，重复登记返回已有编号
+     * @return 编码不合法时返回 false
+     */
+    bool add(std::span<const uint8_t> encoded, uint32_t& id);
+    bool add(std::string_view dotted, uint32_t& id);
+
+    template <typename Fn>
+    void match(std::span<const uint8_t> encoded, Fn&& fn) const;
+
+    [[nodiscard]] uint32_t find(std::span<const uint8_t> encoded) const noexcept;
+    [[nodiscard]] uint32_t longest_match(std::span<const uint8_t> encoded) const noexcept;
+
+    /**
+     * 为 encoded 所属的每个子树累计一次
+     * @return 最深的子树编号，不属于任何子树时返回 kNone
+     */
+    uint32_t record(std::span<const uint8_t> encoded) noexcept;
+
+    [[nodiscard]] const std::vector<Subtree>& subtrees() const noexcept { return subtrees_; }
+    [[nodiscard]] bool empty() const noexcept { return subtrees_.empty(); }
+
+    void reset_counters() noexcept;
+    void clear();
+
+private:
+    struct Node {
+        uint32_t label_offset = 0;           // 边标签在 labels_ 中的位置
+        uint32_t label_length = 0;
+        uint32_t subtree = kNone;
+        std::vector<uint32_t> children;      // 按标签首字节排序
+    };
+
+    std::vector<Node> nodes_;
+    std::vector<uint8_t> labels_;
+    std::vector<Subtree> subtrees_;
+
+    [[nodiscard]] uint32_t find_child(const Node& node, uint8_t byte) const noexcept;
+};
+
+template <typename Fn>
+void SNMPOIDTrie::match(std::span<const uint8_t> encoded, Fn&& fn) const {
+    if (nodes_.empty()) {
+        return;
+    }
+    const Node* node = &nodes_[0];
+    size_t position = 0;
+    for (;;) {
+        if (node->subtree != kNone) {
+            fn(node->subtree);
+        }
+        if (position == encoded.size()) {
+            return;
+        }
+        const uint32_t child = find_child(*node, encoded[position]);
+        if (child == kNone) {
+            return;
+        }
+        node = &nodes_[child];
+        if (node->label_length > encoded.size() - position ||
+            std::memcmp(labels_.data() + node->label_offset, encoded.data() + position, node->label_length) != 0) {
+            return;
+        }
+        position += node->label_length;
+    }
+}
+
+} // namespace protocol_parser::parsers
@@ -2,6 +2,9 @@
 
 #include "parsers/base_parser.hpp"
 #include "../base_parser.hpp"
+#include "parsers/application/ber_walker.hpp"
+#include "parsers/application/snmp_oid_trie.hpp"
+#include <span>
 #include <vector>
 #include <string>
 #include <optional>
@@ -75,11 +78,14 @@ public:
     OID() = default;
     explicit OID(const std::vector<uint32_t>& components);
     explicit OID(const std::string& dotted_notation);
+    // 由 BER 编码形式解码
+    explicit OID(std::span<const uint8_t> encoded);
     
     [[nodiscard]] const std::vector<uint32_t>& components() const noexcept;
     [[nodiscard]] std::string to_string() const;
     [[nodiscard]] bool is_valid() const noexcept;
     [[nodiscard]] bool is_prefix_of(const OID& other) const noexcept;
+    [[nodiscard]] std::vector<uint8_t> encode() const;
     
     bool operator==(const OID& other) const noexcept;
     bool operator<(const OID& other) const noexcept;
@@ -113,18 +119,28 @@ struct VarBind {
     [[nodiscard]] bool is_exception() const noexcept;
 };
 
+// 变量绑定的零拷贝视图，指向被解析的缓冲区；需要取值时再 decode()
+struct SNMPVarBindView {
+    std::span<const uint8_t> oid;       // 编码形式
+    uint8_t tag{static_cast<uint8_t>(BERType::NULL_TYPE)};
+    std::span<const uint8_t> value;
+
+    [[nodiscard]] EncodedOID encoded_oid() const noexcept { return EncodedOID{oid}; }
+    [[nodiscard]] VarBind decode() const;
+};
+
 // SNMP PDU结构
 struct SNMPPDU {
     SNMPPDUType type{SNMPPDUType::GET_REQUEST};
     uint32_t request_id{0};
     SNMPErrorStatus error_status{SNMPErrorStatus::NO_ERROR};
     uint32_t error_index{0};
-    std::vector<VarBind> variable_bindings;
+    std::vector<SNMPVarBindView> variable_bindings;
     
     // 特殊字段（用于某些PDU类型）
     uint32_t non_repeaters{0};      // GetBulk
     uint32_t max_repetitions{0};    // GetBulk
-    uint32_t enterprise{0};         // Trap v1
+    std::span<const uint8_t> enterprise;  // Trap v1（编码形式的 OID）
     uint32_t agent_addr{0};         // Trap v1  
     uint32_t generic_trap{0};       // Trap v1
     uint32_t specific_trap{0};      // Trap v1
@@ -201,7 +217,7 @@ struct SNMPMessage {
 
 class SNMPParser : public BaseParser {
 public:
-    explicit SNMPParser() = default;
+    SNMPParser();
     ~SNMPParser() override = default;
 
     // 基类接口实现
@@ -250,8 +266,20 @@ public:
         bool is_writable{false};
     };
     
+    // 按最长前缀查找 MIB 对象（实例 OID 如 sysDescr.0 命中 sysDescr）
     [[nodiscard]] std::optional<MIBInfo> lookup_oid(const OID& oid) const noexcept;
+    [[nodiscard]] std::optional<MIBInfo> lookup_oid(std::span<const uint8_t> encoded) const noexcept;
     void load_mib_database(const std::string& mib_file_path);
+    bool add_mib_object(std::string_view dotted, const MIBInfo& info);
+
+    /**
+     * 登记需要按子树统计访问次数的 OID 前缀；MIB 对象自动登记
+     * @return 子树编号，对应 get_oid_subtrees() 的下标
+     */
+    std::optional<uint32_t> add_oid_subtree(std::string_view dotted);
+    [[nodiscard]] const std::vector<SNMPOIDTrie::Subtree>& get_oid_subtrees() const noexcept {
+        return oid_trie_.subtrees();
+    }
     
     // 统计信息
     struct SNMPStatistics {
@@ -267,8 +295,9 @@ public:
         uint64_t malformed_messages{0};
         uint64_t authentication_failures{0};
         uint64_t authorization_failures{0};
+        uint64_t variable_bindings{0};
+        uint64_t unclassified_oids{0};      // 不属于任何已登记子树
         std::unordered_map<std::string, uint64_t> community_usage;
-        std::unordered_map<std::string, uint64_t> oid_access_count;
         std::unordered_map<SNMPErrorStatus, uint64_t> error_distribution;
     };
     
@@ -289,21 +318,16 @@ private:
     bool is_malformed_{false};
     SNMPStatistics statistics_;
     
-    // MIB数据库
-    std::unordered_map<std::string, MIBInfo> mib_database_;
+    // MIB数据库：编码 OID 前缀树，子树编号 -> mib_objects_ 下标
+    SNMPOIDTrie oid_trie_;
+    std::vector<uint32_t> subtree_mib_;
+    std::vector<MIBInfo> mib_objects_;
     
     // 私有解析方法
-    [[nodiscard]] bool parse_ber_sequence(const uint8_t* data, size_t size, size_t& offset) noexcept;
-    [[nodiscard]] bool parse_ber_length(const uint8_t* data, size_t size, size_t& offset, size_t& length) noexcept;
-    [[nodiscard]] bool parse_ber_integer(const uint8_t* data, size_t size, size_t& offset, int64_t& value) noexcept;
-    [[nodiscard]] bool parse_ber_octet_string(const uint8_t* data, size_t size, size_t& offset, std::string& value) noexcept;
-    [[nodiscard]] bool parse_ber_oid(const uint8_t* data, size_t size, size_t& offset, OID& oid) noexcept;
-    [[nodiscard]] bool parse_snmp_value(const uint8_t* data, size_t size, size_t& offset, BERType type, SNMPValue& value) noexcept;
-    
-    [[nodiscard]] bool parse_v1_v2c_message(const uint8_t* data, size_t size, size_t& offset) noexcept;
-    [[nodiscard]] bool parse_v3_message(const uint8_t* data, size_t size, size_t& offset) noexcept;
-    [[nodiscard]] bool parse_pdu(const uint8_t* data, size_t size, size_t& offset, SNMPPDU& pdu) noexcept;
-    [[nodiscard]] bool parse_variable_bindings(const uint8_t* data, size_t size, size_t& offset, std::vector<VarBind>& bindings) noexcept;
+    [[nodiscard]] bool parse_v1_v2c_message(BERWalker& fields) noexcept;
+    [[nodiscard]] bool parse_v3_message(BERWalker& fields) noexcept;
+    [[nodiscard]] bool parse_pdu(const BERElement& element, SNMPPDU& pdu) noexcept;
+    [[nodiscard]] bool parse_variable_bindings(std::span<const uint8_t> data, std::vector<SNMPVarBindView>& bindings) noexcept;
     
     // 验证方法
     [[nodiscard]] bool validate_ber_encoding(const uint8_t* data, size_t size) const noexcept;
@@ -320,7 +344,8 @@ private:
     
     // MIB处理
     void initialize_standard_mibs() noexcept;
-    [[nodiscard]] std::string classify_oid_by_prefix(const OID& oid) const noexcept;
+    [[nodiscard]] const MIBInfo* find_mib_object(std::span<const uint8_t> encoded) const noexcept;
+    [[nodiscard]] std::string classify_oid_by_prefix(std::span<const uint8_t> encoded) const noexcept;
     
     // 常量定义
     static constexpr size_t MAX_MESSAGE_SIZE = 65507;    // RFC 3411
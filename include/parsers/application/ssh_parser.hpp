@@ -6,6 +6,8 @@
 #include <cstdint>
 #include <array>
 #include <optional>
+#include <span>
+#include <string_view>
 
 namespace protocol_parser::parsers {
 
@@ -91,44 +93,123 @@ enum class SSHDisconnectReason : uint32_t {
     SSH_DISCONNECT_ILLEGAL_USER_NAME = 15
 };
 
-// SSH Version exchange structure
+// Byte stream direction of an SSH connection
+enum class SSHDirection : uint8_t {
+    CLIENT_TO_SERVER = 0,
+    SERVER_TO_CLIENT = 1
+};
+
+// Identification string (RFC 4253 4.2), copied once into fixed storage
 struct SSHVersionExchange {
-    SSHVersion version;
-    std::string version_string;
-    std::string software_version;
-    std::string comments;
+    static constexpr size_t kMaxLength = 253;   // 255 including CR LF
+
+    SSHVersion version = SSHVersion::UNKNOWN;
+    std::array<char, kMaxLength> line{};        // Whole line without CR LF
+    uint8_t length = 0;
+    uint8_t version_length = 0;                 // "SSH-protoversion-softwareversion"
+    uint8_t software_offset = 0;
+
+    [[nodiscard]] bool empty() const noexcept { return length == 0; }
+    [[nodiscard]] std::string_view version_string() const noexcept { return {line.data(), version_length}; }
+    [[nodiscard]] std::string_view software_version() const noexcept {
+        return {line.data() + software_offset, static_cast<size_t>(version_length - software_offset)};
+    }
+    [[nodiscard]] std::string_view comments() const noexcept {
+        return version_length < length
+            ? std::string_view(line.data() + version_length + 1, static_cast<size_t>(length - version_length - 1))
+            : std::string_view{};
+    }
 };
 
-// SSH Binary packet structure
+// SSH Binary packet (RFC 4253 6), payload is a view into the parsed buffer
 struct SSHBinaryPacket {
-    uint32_t packet_length;
-    uint8_t padding_length;
-    std::vector<uint8_t> payload;
-    std::vector<uint8_t> padding;
-    std::array<uint8_t, 20> mac; // Maximum MAC size
-    bool has_mac;
-};
-
-// SSH Key exchange init structure
-struct SSHKeyExchangeInit {
-    std::array<uint8_t, 16> cookie;
-    std::vector<std::string> kex_algorithms;
-    std::vector<std::string> server_host_key_algorithms;
-    std::vector<std::string> encryption_algorithms_client_to_server;
-    std::vector<std::string> encryption_algorithms_server_to_client;
-    std::vector<std::string> mac_algorithms_client_to_server;
-    std::vector<std::string> mac_algorithms_server_to_client;
-    std::vector<std::string> compression_algorithms_client_to_server;
-    std::vector<std::string> compression_algorithms_server_to_client;
-    std::vector<std::string> languages_client_to_server;
-    std::vector<std::string> languages_server_to_client;
-    bool first_kex_packet_follows;
-    uint32_t reserved;
+    uint32_t packet_length = 0;
+    uint8_t padding_length = 0;
+    std::span<const uint8_t> payload;
+};
+
+// KEXINIT name-lists (RFC 4253 7.1), in wire order
+enum class SSHNameList : uint8_t {
+    KEX_ALGORITHMS = 0,
+    SERVER_HOST_KEY_ALGORITHMS,
+    ENCRYPTION_CLIENT_TO_SERVER,
+    ENCRYPTION_SERVER_TO_CLIENT,
+    MAC_CLIENT_TO_SERVER,
+    MAC_SERVER_TO_CLIENT,
+    COMPRESSION_CLIENT_TO_SERVER,
+    COMPRESSION_SERVER_TO_CLIENT,
+    LANGUAGES_CLIENT_TO_SERVER,
+    LANGUAGES_SERVER_TO_CLIENT,
+    COUNT
+};
+
+/**
+ * SSH_MSG_KEXINIT decoded in a single pass.
+ * Every field is a view into the packet payload, so the payload must outlive the view.
+ */
+struct SSHKexInitView {
+    std::span<const uint8_t> cookie;
+    std::array<std::string_view, static_cast<size_t>(SSHNameList::COUNT)> name_lists{};
+    bool first_kex_packet_follows = false;
+    uint32_t reserved = 0;
+
+    [[nodiscard]] std::string_view list(SSHNameList which) const noexcept {
+        return name_lists[static_cast<size_t>(which)];
+    }
+
+    // Calls fn(name) for every non-empty name of a comma-separated name-list
+    template <typename Fn>
+    static void for_each_name(std::string_view list, Fn&& fn) {
+        while (!list.empty()) {
+            const size_t comma = list.find(',');
+            const auto name = list.substr(0, comma);
+            if (!name.empty()) {
+                fn(name);
+            }
+            if (comma == std::string_view::npos) {
+                break;
+            }
+            list.remove_prefix(comma + 1);
+        }
+    }
+};
+
+using HASSHDigest = std::array<char, 32>;      // Lowercase hex MD5
+
+// HASSH fingerprints of one connection, fixed size so they can live in per-flow state
+struct SSHFingerprints {
+    HASSHDigest hassh{};
+    HASSHDigest hassh_server{};
+    bool has_client = false;
+    bool has_server = false;
+
+    [[nodiscard]] std::string_view hassh_view() const noexcept {
+        return has_client ? std::string_view(hassh.data(), hassh.size()) : std::string_view{};
+    }
+    [[nodiscard]] std::string_view hassh_server_view() const noexcept {
+        return has_server ? std::string_view(hassh_server.data(), hassh_server.size()) : std::string_view{};
+    }
+};
+
+// Per-direction traffic once the stream is encrypted: sizes are those of the parse() inputs
+struct SSHTrafficCounters {
+    static constexpr size_t kSizeBuckets = 8;  // <=64, <=128, ..., <=4096, larger
+
+    uint64_t packets = 0;
+    uint64_t bytes = 0;
+    uint32_t min_size = 0;
+    uint32_t max_size = 0;
+    uint64_t first_us = 0;
+    uint64_t last_us = 0;
+    uint64_t max_gap_us = 0;
+    std::array<uint64_t, kSizeBuckets> size_histogram{};
+
+    void record(size_t size, uint64_t now_us) noexcept;
 };
 
 // SSH Message structures
 struct SSHDisconnectMessage {
-    uint32_t reason_code;
+    uint32_t reason_code = 0;
     std::string description;
     std::string language_tag;
 };
@@ -137,29 +218,39 @@ struct SSHServiceMessage {
     std::string service_name;
 };
 
-// SSH Message structure
+// Summary of one clear-text SSH message; payloads are not kept
 struct SSHMessage {
-    SSHMessageType type;
-    std::vector<uint8_t> data;
+    SSHMessageType type = SSHMessageType::UNKNOWN_MESSAGE;
+    uint32_t payload_length = 0;               // Excluding the message type byte
+    SSHDirection direction = SSHDirection::CLIENT_TO_SERVER;
     
     // Parsed message data based on type (using optional for type safety)
-    std::optional<SSHKeyExchangeInit> kex_init;
     std::optional<SSHDisconnectMessage> disconnect;
     std::optional<SSHServiceMessage> service_request;
     std::optional<SSHServiceMessage> service_accept;
-    
-    SSHMessage() : type(SSHMessageType::UNKNOWN_MESSAGE) {}
 };
 
 // SSH Connection information
+// Memory is bounded: at most kMaxMessages clear-text messages are kept, and once a direction
+// has sent NEWKEYS its packets only update that direction's counters
 struct SSHConnection {
-    SSHConnectionState state;
+    static constexpr size_t kMaxMessages = 32;
+
+    SSHConnectionState state = SSHConnectionState::VERSION_EXCHANGE;
     SSHVersionExchange client_version;
     SSHVersionExchange server_version;
-    bool version_exchange_complete;
-    bool key_exchange_complete;
-    bool authentication_complete;
+    bool version_exchange_complete = false;
+    bool key_exchange_complete = false;
+    bool authentication_complete = false;
     std::vector<SSHMessage> messages;
+    uint64_t messages_dropped = 0;             // Clear-text messages beyond kMaxMessages
+    SSHFingerprints fingerprints;
+    std::array<bool, 2> encrypted{};           // NEWKEYS seen, by SSHDirection
+    std::array<SSHTrafficCounters, 2> traffic{};   // By SSHDirection
+
+    [[nodiscard]] const SSHTrafficCounters& counters(SSHDirection direction) const noexcept {
+        return traffic[static_cast<size_t>(direction)];
+    }
 };
 
 class SSHParser : public BaseParser {
@@ -167,16 +258,34 @@ public:
     SSHParser() = default;
     ~SSHParser() override = default;
 
+    [[nodiscard]] const ProtocolInfo& get_protocol_info() const noexcept override;
+    [[nodiscard]] bool can_parse(const BufferView& buffer) const noexcept override;
     [[nodiscard]] ParseResult parse(ParseContext& context) noexcept override;
+    void reset() noexcept override;
     [[nodiscard]] std::string get_protocol_name() const { return "SSH"; }
     [[nodiscard]] uint16_t get_protocol_id() const { return 22; } // SSH port
 
+    // Direction of the next parse() input. Without it, the first identification string and
+    // KEXINIT are taken as the client's, the second as the server's, and the first NEWKEYS
+    // switches both directions to counters-only mode.
+    // parse() consumes every complete identification string and packet from context.offset,
+    // advances the offset past them and leaves a trailing partial element for the next call
+    void set_direction(SSHDirection direction) noexcept {
+        direction_ = direction;
+        direction_known_ = true;
+    }
+    [[nodiscard]] SSHDirection get_direction() const noexcept { return direction_; }
+
+    // Capture time of the next parse() input, in microseconds; used by the traffic counters
+    void set_timestamp(uint64_t now_us) noexcept { now_us_ = now_us; }
+
     // SSH-specific methods
     [[nodiscard]] const SSHConnection& get_ssh_connection() const { return ssh_connection_; }
     [[nodiscard]] SSHConnectionState get_connection_state() const { return ssh_connection_.state; }
     [[nodiscard]] const SSHVersionExchange& get_client_version() const { return ssh_connection_.client_version; }
     [[nodiscard]] const SSHVersionExchange& get_server_version() const { return ssh_connection_.server_version; }
     [[nodiscard]] const std::vector<SSHMessage>& get_messages() const { return ssh_connection_.messages; }
+    [[nodiscard]] const SSHFingerprints& get_fingerprints() const noexcept { return ssh_connection_.fingerprints; }
     
     // State check methods
     [[nodiscard]] bool is_version_exchange_complete() const { return ssh_connection_.version_exchange_complete; }
@@ -195,29 +304,40 @@ public:
     
     // Utility methods
     [[nodiscard]] std::string version_to_string(SSHVersion version) const;
-    [[nodiscard]] SSHVersion string_to_version(const std::string& version_str) const;
+    [[nodiscard]] SSHVersion string_to_version(std::string_view version_str) const;
     [[nodiscard]] std::string message_type_to_string(SSHMessageType type) const;
     [[nodiscard]] std::string disconnect_reason_to_string(SSHDisconnectReason reason) const;
 
+    /**
+     * @param payload KEXINIT payload starting at the message type byte
+     * @return false if the payload is truncated
+     */
+    [[nodiscard]] static bool parse_kex_init(std::span<const uint8_t> payload, SSHKexInitView& out) noexcept;
+
+    // HASSH: MD5 of "kex;encryption;mac;compression" using the sender's own direction lists,
+    // streamed straight from the name-lists
+    [[nodiscard]] static HASSHDigest hassh(const SSHKexInitView& kex_init, SSHDirection sender) noexcept;
+
 private:
     SSHConnection ssh_connection_;
+    SSHDirection direction_ = SSHDirection::CLIENT_TO_SERVER;
+    bool direction_known_ = false;
+    uint64_t now_us_ = 0;
     
     // Helper methods
-    [[nodiscard]] ParseResult parse_version_exchange(const BufferView& buffer);
-    [[nodiscard]] ParseResult parse_binary_packet(const BufferView& buffer);
+    // Both parse one element at the start of buffer and report its length in consumed
+    [[nodiscard]] ParseResult parse_version_exchange(const BufferView& buffer, size_t& consumed);
+    [[nodiscard]] ParseResult parse_binary_packet(const BufferView& buffer, size_t& consumed);
     [[nodiscard]] ParseResult parse_ssh_message(const SSHBinaryPacket& packet);
-    [[nodiscard]] ParseResult parse_kex_init(const std::vector<uint8_t>& payload, SSHKeyExchangeInit& kex_init);
     
+    [[nodiscard]] bool expects_version_line(const BufferView& buffer) const noexcept;
     [[nodiscard]] bool is_version_line_complete(const BufferView& buffer) const;
-    [[nodiscard]] bool validate_version_string(const std::string& version_str) const;
+    [[nodiscard]] bool validate_version_string(std::string_view version_str) const;
     [[nodiscard]] bool validate_ssh_packet(const BufferView& buffer) const;
     
-    [[nodiscard]] std::vector<std::string> parse_name_list(const std::vector<uint8_t>& data, size_t& offset) const;
-    [[nodiscard]] std::string read_string(const std::vector<uint8_t>& data, size_t& offset) const;
-    [[nodiscard]] uint32_t read_uint32(const std::vector<uint8_t>& data, size_t& offset) const;
-    [[nodiscard]] uint8_t read_uint8(const std::vector<uint8_t>& data, size_t& offset) const;
+    [[nodiscard]] static bool read_string(std::span<const uint8_t> data, size_t& offset, std::string_view& out) noexcept;
+    [[nodiscard]] static bool read_uint32(std::span<const uint8_t> data, size_t& offset, uint32_t& out) noexcept;
     
-    void reset() noexcept;
     void update_connection_state();
 };
 
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+namespace protocol_parser::parsers {
+
+/**
+ * ClientHello / ServerHello decoded in a single pass.
+ * Every field is a view into the handshake message, so the message must outlive the view.
+ * List fields hold the raw wire bytes (big-endian uint16 entries unless noted).
+ */
+struct TLSHelloView {
+    bool is_client = false;
+    uint16_t legacy_version = 0;
+    uint16_t version = 0;              // Highest supported_versions entry (client) / selected version (server),
+                                       // legacy_version when the extension is absent
+    uint16_t cipher_suite = 0;         // ServerHello only
+    uint16_t extension_count = 0;      // All extensions, GREASE included
+
+    std::span<const uint8_t> random;
+    std::span<const uint8_t> session_id;
+    std::span<const uint8_t> cipher_suites;        // ClientHello only
+    std::span<const uint8_t> compression_methods;  // uint8 entries
+    std::span<const uint8_t> extensions;           // Raw extension block, in wire order
+
+    bool has_server_name = false;
+    std::string_view server_name;                  // First host_name entry of SNI
+    std::span<const uint8_t> alpn;                 // ProtocolNameList contents (uint8-length-prefixed names)
+    std::span<const uint8_t> supported_groups;
+    std::span<const uint8_t> ec_point_formats;     // uint8 entries
+    std::span<const uint8_t> signature_algorithms;
+    std::span<const uint8_t> supported_versions;   // ClientHello list; ServerHello holds the selected version
+
+    [[nodiscard]] size_t cipher_count() const noexcept { return cipher_suites.size() / 2; }
+    [[nodiscard]] uint16_t cipher_at(size_t index) const noexcept {
+        return static_cast<uint16_t>((cipher_suites[index * 2] << 8) | cipher_suites[index * 2 + 1]);
+    }
+    [[nodiscard]] std::string_view first_alpn() const noexcept;
+
+    // Calls fn(type, data) for every extension in wire order
+    template <typename Fn>
+    void for_each_extension(Fn&& fn) const {
+        size_t offset = 0;
+        while (offset + 4 <= extensions.size()) {
+            const uint16_t type = static_cast<uint16_t>((extensions[offset] << 8) | extensions[offset + 1]);
+            const size_t length = static_cast<size_t>((extensions[offset + 2] << 8) | extensions[offset + 3]);
+            fn(type, extensions.subspan(offset + 4, length));
+            offset += 4 + length;
+        }
+    }
+};
+
+using JA3Digest = std::array<char, 32>;        // Lowercase hex MD5
+using JA4Fingerprint = std::array<char, 36>;   // e.g. t13d1516h2_8daaf6152771_e5627efa2ab1
+
+// Fingerprints of one connection, fixed size so they can live in per-flow state
+struct TLSFingerprints {
+    JA3Digest ja3{};
+    JA3Digest ja3s{};
+    JA4Fingerprint ja4{};
+    bool has_client = false;
+    bool has_server = false;
+
+    [[nodiscard]] std::string_view ja3_view() const noexcept {
+        return has_client ? std::string_view(ja3.data(), ja3.size()) : std::string_view{};
+    }
+    [[nodiscard]] std::string_view ja3s_view() const noexcept {
+        return has_server ? std::string_view(ja3s.data(), ja3s.size()) : std::string_view{};
+    }
+    [[nodiscard]] std::string_view ja4_view() const noexcept {
+        return has_client ? std::string_view(ja4.data(), ja4.size()) : std::string_view{};
+    }
+};
+
+/**
+ * Single-pass hello scanner and JA3/JA3S/JA4 fingerprinting.
+ * Nothing is allocated: the scanner only records views, and the fingerprint strings are
+ * streamed straight into MD5/SHA-256 from a small stack buffer.
+ */
+class TLSHelloScanner {
+public:
+    static constexpr size_t kRecordHeaderSize = 5;
+    static constexpr size_t kHandshakeHeaderSize = 4;
+    static constexpr size_t kMaxSortedEntries = 512;   // JA4 sorts at most this many ciphers/extensions
+
+    /**
+     * @param message Handshake message starting at the type byte; must hold the whole hello
+     * @return false if it is not a well-formed ClientHello/ServerHello
+     */
+    [[nodiscard]] static bool scan_handshake(std::span<const uint8_t> message, TLSHelloView& out) noexcept;
+
+    // Same, for a TLS record that carries the whole hello in its first handshake message
+    [[nodiscard]] static bool scan_record(std::span<const uint8_t> record, TLSHelloView& out) noexcept;
+
+    [[nodiscard]] static constexpr bool is_grease(uint16_t value) noexcept {
+        return (value & 0x0F0F) == 0x0A0A && (value >> 8) == (value & 0xFF);
+    }
+
+    [[nodiscard]] static JA3Digest ja3(const TLSHelloView& client_hello) noexcept;
+    [[nodiscard]] static JA3Digest ja3s(const TLSHelloView& server_hello) noexcept;
+
+    // transport: 't' TCP, 'q' QUIC, 'd' DTLS
+    [[nodiscard]] static JA4Fingerprint ja4(const TLSHelloView& client_hello, char transport = 't') noexcept;
+
+    // Scans the hello and fills the client or server half of fingerprints
+    static bool fingerprint(std::span<const uint8_t> message, TLSFingerprints& fingerprints,
+                            TLSHelloView* view = nullptr, char transport = 't') noexcept;
+
+private:
+    static bool scan_extensions(std::span<const uint8_t> block, TLSHelloView& out) noexcept;
+};
+
+} // namespace protocol_parser::parsers
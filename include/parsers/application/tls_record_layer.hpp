@@ -0,0 +1,115 @@
+#pragma once
+
+#include "../base_parser.hpp"
+#include "core/tcp_reassembler.hpp"
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace protocol_parser::parsers {
+
+// Byte stream direction of a TLS connection
+enum class TLSDirection : uint8_t {
+    CLIENT_TO_SERVER = 0,
+    SERVER_TO_CLIENT = 1
+};
+
+/**
+ * Per-flow TLS record layer on top of the two reassembled TCP byte streams.
+ * - Records may be split anywhere across feed() calls.
+ * - Handshake messages are reassembled across records. A complete message that sits in
+ *   the input is delivered in place; only messages split across segments are copied into
+ *   a per-direction buffer bounded by max_handshake_size (larger messages are skipped).
+ * - Application data, heartbeat and encrypted handshake records are skipped by count,
+ *   without copying.
+ * - The handshake is done once nothing more is visible in clear text: a TLS 1.3
+ *   ServerHello (not a HelloRetryRequest), ChangeCipherSpec in both directions, or the
+ *   first application data record. After that only record headers are framed.
+ */
+class TLSRecordLayer {
+public:
+    static constexpr size_t kRecordHeaderSize = 5;
+    static constexpr size_t kHandshakeHeaderSize = 4;
+    static constexpr size_t kMaxRecordLength = 16384 + 2048;       // TLSCiphertext limit
+    static constexpr size_t kDefaultMaxHandshakeSize = 64 * 1024;
+
+    // Views are only valid during the callback
+    struct Handlers {
+        // message starts at the 4-byte handshake header
+        std::function<void(TLSDirection, std::span<const uint8_t> message)> on_handshake;
+        std::function<void(TLSDirection, uint8_t level, uint8_t description)> on_alert;
+        std::function<void(uint16_t version)> on_handshake_done;
+    };
+
+    struct Statistics {
+        uint64_t records = 0;
+        uint64_t handshake_messages = 0;
+        uint64_t reassembled_messages = 0;     // Handshake messages that spanned segments or records
+        uint64_t oversized_messages = 0;       // Skipped for exceeding max_handshake_size
+        uint64_t application_records = 0;
+        uint64_t skipped_bytes = 0;            // Payload bytes passed over without inspection
+    };
+
+    explicit TLSRecordLayer(size_t max_handshake_size = kDefaultMaxHandshakeSize);
+
+    void set_handlers(Handlers handlers) { handlers_ = std::move(handlers); }
+
+    /**
+     * Feeds a fragment of one direction's byte stream.
+     * @return Success once the fragment is consumed; InvalidFormat if the stream is not
+     *         TLS, after which the flow is no longer parsed
+     */
+    [[nodiscard]] ParseResult feed(TLSDirection direction, const BufferView& data);
+
+    // Feeds and consumes all contiguous data of a reassembled stream
+    [[nodiscard]] ParseResult feed(TLSDirection direction, core::TcpReassembler& reassembler);
+
+    [[nodiscard]] bool handshake_done() const noexcept { return handshake_done_; }
+    [[nodiscard]] bool failed() const noexcept { return failed_; }
+    [[nodiscard]] uint16_t negotiated_version() const noexcept { return negotiated_version_; }
+    // Next byte of the direction starts a record that also starts a handshake message
+    [[nodiscard]] bool at_message_boundary(TLSDirection direction) const noexcept {
+        const auto& state = directions_[static_cast<size_t>(direction)];
+        return state.header_bytes == 0 && state.handshake.empty() && state.discard_remaining == 0;
+    }
+    [[nodiscard]] const Statistics& statistics() const noexcept { return stats_; }
+    [[nodiscard]] const std::string& get_error_message() const noexcept { return error_message_; }
+
+    void reset();
+
+private:
+    struct DirectionState {
+        std::array<uint8_t, kRecordHeaderSize> header{};
+        size_t header_bytes = 0;
+        uint8_t content_type = 0;
+        size_t record_remaining = 0;           // Payload bytes left in the current record
+        std::vector<uint8_t> handshake;        // Partial handshake message
+        size_t discard_remaining = 0;          // Bytes left of an oversized handshake message
+        std::array<uint8_t, 2> alert{};
+        size_t alert_bytes = 0;
+        bool encrypted = false;                // Further handshake/alert records are ciphertext
+        bool change_cipher_spec = false;
+    };
+
+    std::array<DirectionState, 2> directions_;
+    Handlers handlers_;
+    Statistics stats_;
+    size_t max_handshake_size_;
+    uint16_t negotiated_version_ = 0;
+    bool handshake_done_ = false;
+    bool failed_ = false;
+    std::string error_message_;
+
+    [[nodiscard]] bool begin_record(DirectionState& state);
+    void end_record(TLSDirection direction, DirectionState& state);
+    void consume_handshake(TLSDirection direction, DirectionState& state, std::span<const uint8_t> bytes);
+    void consume_alert(TLSDirection direction, DirectionState& state, std::span<const uint8_t> bytes);
+    void deliver_handshake(TLSDirection direction, std::span<const uint8_t> message);
+    void finish_handshake();
+    [[nodiscard]] bool fail(std::string message);
+};
+
+} // namespace protocol_parser::parsers
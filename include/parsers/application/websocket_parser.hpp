@@ -2,7 +2,10 @@
 
 #include "../base_parser.hpp"
 #include "../../core/buffer_view.hpp"
+#include "../../utils/simd_utils.hpp"
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <unordered_map>
 #include <cstdint>
@@ -86,13 +89,24 @@ struct WebSocketHandshake {
 /// WebSocket帧信息
 struct WebSocketFrame {
     WebSocketFrameHeader header;         ///< 帧头
-    std::vector<uint8_t> payload;        ///< 载荷数据
+    BufferView payload;                  ///< 载荷数据（已去掩码），指向输入缓冲区或解析器的去掩码缓冲区
     bool is_valid = false;               ///< 帧是否有效
-    std::string text_data;               ///< 文本数据（如果是文本帧）
+    std::string_view text_data;          ///< 文本数据（如果是文本帧），指向 payload
     WebSocketCloseCode close_code = WebSocketCloseCode::NORMAL_CLOSURE; ///< 关闭代码
     std::string close_reason;            ///< 关闭原因
 };
 
+/// 完整的数据消息：各分片载荷按顺序组成的视图链，不拼接
+struct WebSocketMessageChain {
+    WebSocketOpcode opcode = WebSocketOpcode::CONTINUATION; ///< TEXT 或 BINARY
+    std::vector<BufferView> fragments;   ///< 各分片载荷（已去掩码）
+    size_t size = 0;                     ///< 消息总长度
+    bool complete = false;               ///< 刚解析的帧是否完成了一条消息
+
+    /// 需要连续数据时拷贝一次
+    void copy_to(std::vector<uint8_t>& out) const;
+};
+
 /// WebSocket消息
 struct WebSocketMessage {
     WebSocketHandshake handshake;        ///< 握手信息
@@ -131,11 +145,16 @@ struct WebSocketExtension {
  * - 实时流量统计
  * 
  * 特性：
- * - 零拷贝解析
+ * - 零拷贝解析：未掩码的载荷直接指向输入；有掩码的载荷用 AVX2 一次异或去掩码，
+ *   写入复用的缓冲区，或用 parse_frame_in_place 原地改写调用方缓冲区
+ * - 分片消息重组为视图链，TEXT 消息跨分片做 SIMD UTF-8 流式校验
  * - 高性能帧处理
  * - 完整的错误检测
  * - 现代C++23实现
  * - 跨平台兼容
+ *
+ * 视图的有效期：指向输入缓冲区的视图随输入有效（分片消息完成前须保持各分片的输入有效）；
+ * 指向解析器内部缓冲区的视图在下一次解析前有效
  */
 class WebSocketParser : public BaseParser {
 public:
@@ -198,13 +217,33 @@ public:
                                WebSocketHandshake& handshake) const;
     
     /**
-     * @brief 解析WebSocket帧
+     * @brief 解析WebSocket帧，并把数据帧加入当前消息
      * @param buffer 数据缓冲区
      * @param frame 帧信息输出
      * @return 解析结果
      */
     ParseResult parse_frame(const BufferView& buffer, 
-                           WebSocketFrame& frame) const;
+                           WebSocketFrame& frame);
+
+    /**
+     * @brief 解析WebSocket帧并在调用方缓冲区内原地去掩码
+     * @param buffer 可写的数据缓冲区；成功后载荷已被改写为明文，不能再次解析
+     * @param frame 帧信息输出，载荷指向 buffer
+     * @return 解析结果
+     */
+    ParseResult parse_frame_in_place(std::span<uint8_t> buffer,
+                                    WebSocketFrame& frame);
+
+    /**
+     * @brief 最近一次解析的帧
+     */
+    [[nodiscard]] const WebSocketFrame& get_frame() const noexcept { return frame_; }
+
+    /**
+     * @brief 最近一次解析的帧完成的消息（complete 为 false 表示没有）
+     */
+    [[nodiscard]] const WebSocketMessageChain& get_message() const noexcept { return message_; }
+    [[nodiscard]] bool has_message() const noexcept { return message_.complete; }
     
     /**
      * @brief 验证WebSocket密钥
@@ -214,18 +253,18 @@ public:
     std::string calculate_accept_key(const std::string& key) const;
     
     /**
-     * @brief 应用掩码
+     * @brief 原地应用掩码
      * @param data 数据
-     * @param mask 掩码
+     * @param mask 掩码（最高字节为线路上的第一个字节）
      */
-    void apply_mask(std::vector<uint8_t>& data, uint32_t mask) const;
+    void apply_mask(std::span<uint8_t> data, uint32_t mask) const;
     
     /**
-     * @brief 验证UTF-8编码
+     * @brief 验证UTF-8编码（严格，SIMD 加速）
      * @param data 数据
      * @return true if valid UTF-8
      */
-    bool is_valid_utf8(const std::vector<uint8_t>& data) const;
+    bool is_valid_utf8(std::span<const uint8_t> data) const;
     
     /**
      * @brief 解析扩展头
@@ -311,12 +350,29 @@ private:
     /**
      * @brief 解析载荷长度
      * @param buffer 数据缓冲区
-     * @param offset 偏移量
+     * @param offset 扩展长度字段的偏移量，成功后移到其后
      * @param length 长度输出
-     * @return 使用的字节数
+     * @return 数据不足返回 false
      */
-    size_t parse_payload_length(const BufferView& buffer, 
-                               size_t offset, uint64_t& length) const;
+    bool parse_payload_length(const BufferView& buffer, 
+                             size_t& offset, uint64_t& length) const;
+
+    /**
+     * @brief 解析帧并去掩码
+     * @param writable 非空时原地去掩码（与 buffer 指向同一数据）
+     */
+    ParseResult decode_frame(const BufferView& buffer, uint8_t* writable,
+                            WebSocketFrame& frame);
+
+    /**
+     * @brief 把数据帧加入当前消息
+     */
+    ParseResult reassemble(const WebSocketFrame& frame);
+
+    /**
+     * @brief 丢弃未完成的消息
+     */
+    void reset_message() noexcept;
     
     /**
      * @brief 验证握手
@@ -343,6 +399,25 @@ private:
     
     /// 支持的WebSocket版本
     static constexpr int WEBSOCKET_VERSION = 13;
+
+    /// 最大消息大小（分片合计）
+    static constexpr size_t MAX_MESSAGE_SIZE = 64 * 1024 * 1024; // 64MB
+
+    /// 未完成消息中的分片：指向输入缓冲区，或位于 message_arena_ 中
+    struct PendingFragment {
+        BufferView view;
+        size_t arena_offset = SIZE_MAX;
+        size_t size = 0;
+    };
+
+    WebSocketFrame frame_;
+    WebSocketMessageChain message_;
+    bool message_in_progress_ = false;
+    std::vector<PendingFragment> pending_fragments_;
+    std::vector<uint8_t> unmask_buffer_;     ///< 非分片帧的去掩码缓冲区，跨帧复用
+    std::vector<uint8_t> message_arena_;     ///< 分片消息中有掩码分片的明文，跨消息复用
+    size_t arena_offset_ = SIZE_MAX;         ///< 刚解析的帧在 message_arena_ 中的位置
+    protocol_parser::utils::UTF8Validator utf8_validator_;
 };
 
 } // namespace ProtocolParser::Application
@@ -0,0 +1,262 @@
+#pragma once
+
+#include "utils/digest.hpp"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <shared_mutex>
+#include <span>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace protocol_parser::parsers {
+
+// One DER TLV: value excludes the tag/length octets, encoded includes them
+struct DERElement {
+    uint8_t tag = 0;
+    std::span<const uint8_t> value;
+    std::span<const uint8_t> encoded;
+};
+
+/**
+ * Minimal DER reader: single-octet tags, definite lengths up to 4 octets.
+ * read() consumes one element from the front of input.
+ */
+class DERReader {
+public:
+    static constexpr uint8_t kBoolean = 0x01;
+    static constexpr uint8_t kInteger = 0x02;
+    static constexpr uint8_t kBitString = 0x03;
+    static constexpr uint8_t kOctetString = 0x04;
+    static constexpr uint8_t kNull = 0x05;
+    static constexpr uint8_t kOID = 0x06;
+    static constexpr uint8_t kUTF8String = 0x0C;
+    static constexpr uint8_t kPrintableString = 0x13;
+    static constexpr uint8_t kIA5String = 0x16;
+    static constexpr uint8_t kUTCTime = 0x17;
+    static constexpr uint8_t kGeneralizedTime = 0x18;
+    static constexpr uint8_t kSequence = 0x30;
+    static constexpr uint8_t kSet = 0x31;
+
+    [[nodiscard]] static bool read(std::span<const uint8_t>& input, DERElement& out) noexcept;
+
+    // Reads one element and requires the given tag
+    [[nodiscard]] static bool expect(std::span<const uint8_t>& input, uint8_t tag, DERElement& out) noexcept {
+        return read(input, out) && out.tag == tag;
+    }
+};
+
+enum class X509KeyType : uint8_t {
+    UNKNOWN = 0,
+    RSA,
+    RSA_PSS,
+    EC,
+    ED25519,
+    ED448,
+    DSA
+};
+
+/**
+ * Lazy X.509 certificate decoder.
+ * parse() only splits the certificate into its top-level fields; names, validity, key
+ * size and extensions are decoded when asked for. All results are views into the DER
+ * buffer, which must outlive the view.
+ */
+class X509CertificateView {
+public:
+    [[nodiscard]] bool parse(std::span<const uint8_t> der) noexcept;
+    [[nodiscard]] bool valid() const noexcept { return valid_; }
+
+    [[nodiscard]] std::span<const uint8_t> der() const noexcept { return der_; }
+    [[nodiscard]] std::span<const uint8_t> tbs() const noexcept { return tbs_; }
+    [[nodiscard]] uint8_t version() const noexcept { return version_; }   // 1-3
+    [[nodiscard]] std::span<const uint8_t> serial() const noexcept { return serial_; }
+    [[nodiscard]] std::span<const uint8_t> issuer() const noexcept { return issuer_; }     // Name, DER encoded
+    [[nodiscard]] std::span<const uint8_t> subject() const noexcept { return subject_; }   // Name, DER encoded
+    [[nodiscard]] std::span<const uint8_t> extensions() const noexcept { return extensions_; }
+
+    // Validity as the raw UTCTime/GeneralizedTime text and as Unix seconds (0 if malformed)
+    [[nodiscard]] std::string_view not_before_text() const noexcept { return as_text(not_before_.value); }
+    [[nodiscard]] std::string_view not_after_text() const noexcept { return as_text(not_after_.value); }
+    [[nodiscard]] int64_t not_before() const noexcept { return parse_time(not_before_); }
+    [[nodiscard]] int64_t not_after() const noexcept { return parse_time(not_after_); }
+
+    [[nodiscard]] std::span<const uint8_t> signature_algorithm_oid() const noexcept { return signature_oid_; }
+    [[nodiscard]] std::string_view signature_algorithm() const noexcept;
+
+    [[nodiscard]] std::span<const uint8_t> public_key_algorithm_oid() const noexcept { return key_oid_; }
+    [[nodiscard]] X509KeyType key_type() const noexcept;
+    [[nodiscard]] uint32_t key_bits() const noexcept;   // RSA/DSA modulus bits, EC curve size; 0 if unknown
+    [[nodiscard]] static std::string_view key_type_name(X509KeyType type) noexcept;
+
+    [[nodiscard]] std::string_view subject_common_name() const noexcept { return name_attribute(subject_, kCommonName); }
+    [[nodiscard]] std::string_view issuer_common_name() const noexcept { return name_attribute(issuer_, kCommonName); }
+
+    // First value of an attribute (e.g. kCommonName) in a Name; empty if absent
+    [[nodiscard]] static std::string_view name_attribute(std::span<const uint8_t> name,
+                                                         std::span<const uint8_t> oid) noexcept;
+
+    /**
+     * Writes a Name as "CN=a, O=b" (known short attributes only) without allocating.
+     * @return Characters written (truncated to out.size())
+     */
+    static size_t format_name(std::span<const uint8_t> name, std::span<char> out) noexcept;
+
+    /**
+     * Calls fn(type, value) for every subjectAltName entry; type is the GeneralName
+     * tag number (2 = dNSName, 7 = iPAddress).
+     * @return false if the extension is malformed
+     */
+    template <typename Fn>
+    bool for_each_subject_alt_name(Fn&& fn) const {
+        const auto value = find_extension(kSubjectAltName);
+        if (value.empty()) {
+            return true;
+        }
+        auto input = value;
+        DERElement names;
+        if (!DERReader::expect(input, DERReader::kSequence, names)) {
+            return false;
+        }
+        auto entries = names.value;
+        while (!entries.empty()) {
+            DERElement entry;
+            if (!DERReader::read(entries, entry)) {
+                return false;
+            }
+            fn(static_cast<uint8_t>(entry.tag & 0x1F), entry.value);
+        }
+        return true;
+    }
+
+    [[nodiscard]] bool is_ca() const noexcept;
+
+    // Value (OCTET STRING contents) of an extension; empty if absent
+    [[nodiscard]] std::span<const uint8_t> find_extension(std::span<const uint8_t> oid) const noexcept;
+
+    static constexpr std::array<uint8_t, 3> kCommonName = {0x55, 0x04, 0x03};
+    static constexpr std::array<uint8_t, 3> kOrganization = {0x55, 0x04, 0x0A};
+    static constexpr std::array<uint8_t, 3> kSubjectAltName = {0x55, 0x1D, 0x11};
+    static constexpr std::array<uint8_t, 3> kBasicConstraints = {0x55, 0x1D, 0x13};
+
+private:
+    std::span<const uint8_t> der_;
+    std::span<const uint8_t> tbs_;
+    std::span<const uint8_t> serial_;
+    std::span<const uint8_t> issuer_;
+    std::span<const uint8_t> subject_;
+    std::span<const uint8_t> extensions_;
+    std::span<const uint8_t> signature_oid_;
+    std::span<const uint8_t> key_oid_;
+    std::span<const uint8_t> key_parameters_;   // Encoded AlgorithmIdentifier parameters
+    std::span<const uint8_t> public_key_;       // BIT STRING contents without the unused-bits octet
+    DERElement not_before_;
+    DERElement not_after_;
+    uint8_t version_ = 0;
+    bool valid_ = false;
+
+    [[nodiscard]] static std::string_view as_text(std::span<const uint8_t> bytes) noexcept {
+        return {reinterpret_cast<const char*>(bytes.data()), bytes.size()};
+    }
+    [[nodiscard]] static int64_t parse_time(const DERElement& time) noexcept;
+};
+
+// Parsed certificate owned by the cache; the view points into der
+struct X509CacheEntry {
+    utils::SHA256::Digest fingerprint{};
+    std::vector<uint8_t> der;
+    X509CertificateView view;
+
+    X509CacheEntry() = default;
+    X509CacheEntry(const X509CacheEntry&) = delete;
+    X509CacheEntry& operator=(const X509CacheEntry&) = delete;
+};
+
+/**
+ * Certificate cache keyed by SHA-256 of the DER encoding.
+ * Leaf and intermediate certificates repeat across connections, so each distinct
+ * certificate is decoded once. Sharded by fingerprint; lookups take a shared lock and
+ * only misses take the shard's exclusive lock. Each shard evicts with CLOCK
+ * (second chance). Malformed certificates are cached too, so they are not re-parsed.
+ */
+class X509CertificateCache {
+public:
+    struct Config {
+        size_t capacity = 8192;   // Entries over all shards
+        size_t shards = 16;
+    };
+
+    struct Statistics {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        uint64_t parse_failures = 0;
+        size_t entries = 0;
+
+        [[nodiscard]] double hit_rate() const noexcept {
+            const uint64_t lookups = hits + misses;
+            return lookups > 0 ? static_cast<double>(hits) / lookups : 0.0;
+        }
+    };
+
+    X509CertificateCache();
+    explicit X509CertificateCache(const Config& config);
+
+    X509CertificateCache(const X509CertificateCache&) = delete;
+    X509CertificateCache& operator=(const X509CertificateCache&) = delete;
+
+    // Never null; check entry->view.valid() for malformed certificates
+    [[nodiscard]] std::shared_ptr<const X509CacheEntry> get_or_parse(std::span<const uint8_t> der);
+    [[nodiscard]] std::shared_ptr<const X509CacheEntry> find(const utils::SHA256::Digest& fingerprint) const;
+
+    // Uncached decode, same result type
+    [[nodiscard]] static std::shared_ptr<const X509CacheEntry> parse_entry(std::span<const uint8_t> der,
+                                                                           const utils::SHA256::Digest& fingerprint);
+
+    [[nodiscard]] Statistics statistics() const noexcept;
+    void clear();
+
+private:
+    struct DigestHash {
+        size_t operator()(const utils::SHA256::Digest& digest) const noexcept {
+            size_t value;
+            std::memcpy(&value, digest.data(), sizeof(value));
+            return value;
+        }
+    };
+
+    struct Slot {
+        std::shared_ptr<const X509CacheEntry> entry;
+        mutable std::atomic<bool> referenced{true};
+
+        explicit Slot(std::shared_ptr<const X509CacheEntry> e) : entry(std::move(e)) {}
+    };
+
+    struct alignas(64) Shard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<utils::SHA256::Digest, Slot, DigestHash> entries;
+        std::vector<utils::SHA256::Digest> clock;   // Insertion ring scanned by the CLOCK hand
+        size_t hand = 0;
+    };
+
+    std::unique_ptr<Shard[]> shards_;
+    size_t shard_count_;
+    size_t shard_capacity_;
+
+    mutable std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<uint64_t> evictions_{0};
+    std::atomic<uint64_t> parse_failures_{0};
+
+    [[nodiscard]] Shard& shard_for(const utils::SHA256::Digest& fingerprint) const noexcept {
+        return shards_[fingerprint[8] % shard_count_];
+    }
+    void insert_locked(Shard& shard, const utils::SHA256::Digest& fingerprint,
+                       std::shared_ptr<const X509CacheEntry> entry);
+};
+
+} // namespace protocol_parser::parsers
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace protocol_parser::parsers {
+
+/**
+ * QUIC 连接 ID（0-20 字节）
+ */
+struct QuicConnectionId {
+    static constexpr size_t kMaxLength = 20;
+
+    std::array<uint8_t, kMaxLength> bytes{};
+    uint8_t length = 0;
+
+    [[nodiscard]] static QuicConnectionId from(std::span<const uint8_t> data) noexcept {
+        QuicConnectionId id;
+        id.length = static_cast<uint8_t>(std::min(data.size(), kMaxLength));
+        std::copy_n(data.begin(), id.length, id.bytes.begin());
+        return id;
+    }
+    [[nodiscard]] std::span<const uint8_t> view() const noexcept { return {bytes.data(), length}; }
+    [[nodiscard]] bool operator==(const QuicConnectionId& other) const noexcept = default;
+};
+
+// 连接 ID 的发布方；对端把它作为 DCID 使用，因此 DCID 的发布方的对端就是包的发送方
+enum class QuicEndpoint : uint8_t {
+    Client = 0,
+    Server = 1
+};
+
+/**
+ * 一个 QUIC 连接的汇总信息，连接 ID 更换与路径迁移后保持不变
+ */
+struct QuicConnectionInfo {
+    uint64_t id = 0;                    // 连接编号：代数 << 32 | (槽下标 + 1)，非 0 且不复用
+    uint32_t version = 0;
+    uint64_t first_seen_us = 0;
+    uint64_t last_seen_us = 0;
+    uint64_t packets = 0;
+    uint64_t bytes = 0;
+    uint64_t path_key = 0;              // 最近一次的路径（调用方提供的五元组哈希），0 = 未知
+    uint64_t path_changes = 0;          // NAT 重绑定或连接迁移次数
+    uint32_t active_ids = 0;            // 表中指向该连接的连接 ID 数
+    std::string server_name;            // Initial 中 ClientHello 的 SNI
+
+    // 自旋位 RTT（RFC 9000 17.4，RFC 9312 3.8）
+    uint64_t rtt_samples = 0;
+    uint64_t latest_rtt_us = 0;
+    uint64_t min_rtt_us = 0;
+    uint64_t smoothed_rtt_us = 0;       // EWMA，权重 1/8
+};
+
+/**
+ * QUIC 连接表：连接 ID -> 连接
+ *
+ * - 长包头的 DCID/SCID 都登记到同一连接；之后的短包头只能靠 DCID 归属，
+ *   短包头不携带 DCID 长度，按表中已学到的长度（出现次数多的优先）逐个尝试
+ * - 连接 ID 槽位为固定容量的开放寻址表（线性探测、后移删除），负载上限 3/4；
+ *   连接记录存放在固定容量的槽中，编号带代数，被回收的连接对应的旧 ID 自然失效
+ * - 连接空闲超过 idle_timeout_us 即过期；每次观察顺带清扫 sweep_step 个槽位，
+ *   expire() 做一次完整清扫
+ * - NEW_CONNECTION_ID / RETIRE_CONNECTION_ID 位于 1-RTT 加密载荷中，被动观察者看不到，
+ *   能解密的部署（或端点侧）通过 add_connection_id / retire_connection_id 告知
+ * 时间戳由调用方提供（抓包时间，微秒）
+ */
+class QuicConnectionTable {
+public:
+    struct Config {
+        size_t id_capacity = 65536;            // 连接 ID 槽位，向上取整为 2 的幂
+        size_t max_connections = 16384;
+        uint64_t idle_timeout_us = 120'000'000;
+        size_t sweep_step = 8;
+    };
+
+    struct Statistics {
+        uint64_t connections_created = 0;
+        uint64_t connections_expired = 0;
+        uint64_t ids_added = 0;
+        uint64_t ids_retired = 0;
+        uint64_t short_header_hits = 0;
+        uint64_t short_header_misses = 0;
+        uint64_t path_changes = 0;
+        uint64_t rtt_samples = 0;
+        uint64_t dropped = 0;                  // 表满，未能创建连接或登记 ID
+    };
+
+    // 一次观察的结果
+    struct Observation {
+        uint64_t connection = 0;               // 0 = 未归属到任何连接
+        QuicEndpoint sender = QuicEndpoint::Client;
+        uint8_t dcid_length = 0;               // 短包头：匹配到的 DCID 长度
+        bool created = false;
+        bool path_changed = false;
+        uint64_t rtt_sample_us = 0;            // 本包产生的自旋位 RTT 样本，0 = 无
+    };
+
+    QuicConnectionTable();
+    explicit QuicConnectionTable(const Config& config);
+
+    /**
+     * 长包头包：DCID 或 SCID 已知则归属到该连接，否则视为客户端发起的新连接
+     * @param initial 客户端的 Initial/0-RTT 包才允许新建连接
+     */
+    bool observe_long_header(uint32_t version, std::span<const uint8_t> dcid, std::span<const uint8_t> scid,
+                             bool initial, size_t packet_bytes, uint64_t path_key, uint64_t now_us,
+                             Observation& out);
+
+    /**
+     * 短包头包：packet 从首字节开始，用已学到的长度在表中查找 DCID；命中后更新自旋位
+     */
+    bool observe_short_header(std::span<const uint8_t> packet, uint64_t path_key, uint64_t now_us,
+                              Observation& out);
+
+    // NEW_CONNECTION_ID：issuer 发布的新 ID 归属到连接
+    bool add_connection_id(uint64_t connection, QuicEndpoint issuer, std::span<const uint8_t> id, uint64_t now_us);
+    // RETIRE_CONNECTION_ID 或已知失效；连接的最后一个 ID 被移除时连接一并释放
+    bool retire_connection_id(std::span<const uint8_t> id);
+
+    void set_server_name(uint64_t connection, std::string_view name);
+
+    [[nodiscard]] const QuicConnectionInfo* find(uint64_t connection) const noexcept;
+    [[nodiscard]] const QuicConnectionInfo* find_by_id(std::span<const uint8_t> id) const noexcept;
+
+    void expire(uint64_t now_us);
+
+    [[nodiscard]] size_t connection_count() const noexcept { return live_connections_; }
+    [[nodiscard]] size_t id_count() const noexcept { return live_ids_; }
+    [[nodiscard]] const Statistics& statistics() const noexcept { return stats_; }
+
+    void clear();
+
+private:
+    static constexpr uint32_t kNoConnection = UINT32_MAX;
+
+    struct IdSlot {
+        uint64_t hash = 0;
+        QuicConnectionId id;
+        uint32_t connection = kNoConnection;   // 连接槽下标
+        uint32_t generation = 0;               // 登记时连接槽的代数
+        QuicEndpoint issuer = QuicEndpoint::Client;
+        bool occupied = false;
+    };
+
+    struct SpinState {
+        bool seen = false;
+        bool value = false;
+        uint64_t last_edge_us = 0;
+    };
+
+    struct Connection {
+        QuicConnectionInfo info;
+        std::array<SpinState, 2> spin{};       // 按发送方
+        uint32_t generation = 0;
+        bool live = false;
+    };
+
+    Config config_;
+    std::vector<IdSlot> slots_;
+    size_t mask_ = 0;
+    size_t live_ids_ = 0;
+    size_t sweep_cursor_ = 0;
+
+    std::vector<Connection> connections_;
+    std::vector<uint32_t> free_connections_;
+    size_t live_connections_ = 0;
+
+    // 各长度的活动 ID 数，以及按数量排序的候选长度（短包头查找用）
+    std::array<uint32_t, QuicConnectionId::kMaxLength + 1> length_counts_{};
+    std::vector<uint8_t> candidate_lengths_;
+    bool candidates_dirty_ = false;
+
+    Statistics stats_;
+
+    [[nodiscard]] static uint64_t hash_id(std::span<const uint8_t> id) noexcept;
+    [[nodiscard]] size_t find_slot(std::span<const uint8_t> id, uint64_t hash) const noexcept;   // slots_.size() 表示不存在
+    [[nodiscard]] bool is_live(const IdSlot& slot) const noexcept;
+    [[nodiscard]] bool is_dead(const IdSlot& slot, uint64_t now_us);   // 连接已释放或已过期（过期的连接在此释放）
+    [[nodiscard]] uint32_t resolve(std::span<const uint8_t> id, uint64_t now_us, QuicEndpoint& issuer);
+    [[nodiscard]] uint32_t index_of(uint64_t connection) const noexcept;
+    [[nodiscard]] uint32_t create_connection(uint32_t version, uint64_t now_us);
+    void release_connection(uint32_t index);
+    bool insert_id(uint32_t connection, QuicEndpoint issuer, std::span<const uint8_t> id);
+    void erase_slot(size_t index) noexcept;
+    void touch(Connection& connection, size_t packet_bytes, uint64_t path_key, uint64_t now_us, Observation& out);
+    void update_spin(Connection& connection, QuicEndpoint sender, bool spin, uint64_t now_us, Observation& out);
+    void refresh_candidates();
+    void sweep(uint64_t now_us, size_t budget);
+};
+
+} // namespace protocol_parser::parsers
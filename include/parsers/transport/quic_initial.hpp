@@ -0,0 +1,232 @@
+#pragma once
+
+#include "parsers/application/tls_fingerprint.hpp"
+#include "utils/aes_gcm.hpp"
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace protocol_parser::parsers {
+
+inline constexpr uint32_t kQuicVersion1 = 0x00000001;   // RFC 9000
+inline constexpr uint32_t kQuicVersion2 = 0x6B3343CF;   // RFC 9369
+
+/**
+ * 一个方向的 Initial 包保护密钥（RFC 9001 5.2）
+ */
+struct QuicPacketProtection {
+    utils::AES128GCM aead;
+    utils::AES128 header_protection;
+    std::array<uint8_t, utils::AES128GCM::kNonceSize> iv{};
+};
+
+/**
+ * Initial 密钥，由客户端首个 Initial 包的目的连接 ID 派生
+ */
+struct QuicInitialKeys {
+    QuicPacketProtection client;
+    QuicPacketProtection server;
+
+    /**
+     * HKDF-Extract(salt, DCID) 后按版本的标签展开
+     * @return 版本不支持时返回 false
+     */
+    [[nodiscard]] static bool derive(uint32_t version, std::span<const uint8_t> dcid, QuicInitialKeys& out) noexcept;
+};
+
+/**
+ * 去除头部保护并原地解密一个长包头 Initial 包
+ * @param packet 从首字节到 Length 字段覆盖的末尾
+ * @param pn_offset 包号字段的偏移
+ * @param packet_number 输出截断的包号
+ * @param payload 输出明文帧（指向 packet 内部）
+ * @return AEAD 标签校验失败返回 false
+ */
+[[nodiscard]] bool unprotect_quic_initial(const QuicPacketProtection& keys,
+                                          std::span<uint8_t> packet,
+                                          size_t pn_offset,
+                                          uint64_t& packet_number,
+                                          std::span<const uint8_t>& payload) noexcept;
+
+/**
+ * 从 Initial CRYPTO 帧重组出的 ClientHello 信息
+ */
+struct QuicClientHello {
+    std::string server_name;
+    std::vector<std::string> alpn;
+    TLSFingerprints fingerprints;   // JA4 的传输标记为 'q'
+};
+
+/**
+ * 被动 Initial 解密与 ClientHello 重组
+ *
+ * - 按 (版本, DCID) 缓存派生出的密钥；同一连接的后续 Initial 包不再做 HKDF
+ * - CRYPTO 帧可乱序、可跨多个 Initial 包，按偏移拼接，连续部分覆盖完整 ClientHello 后扫描
+ * - 连接数有上限，超出后按插入顺序淘汰最旧的连接
+ *
+ * 只处理客户端方向：服务端 Initial 的 DCID 是客户端选择的源连接 ID，
+ * 无法仅凭单个包推出原始 DCID，标签校验失败的包会被计入 decrypt_failures
+ */
+class QuicInitialTracker {
+public:
+    struct Config {
+        size_t max_connections = 4096;
+        size_t max_crypto_bytes = 64 * 1024;   // 单个连接重组 CRYPTO 数据的上限
+    };
+
+    struct Statistics {
+        uint64_t packets_decrypted = 0;
+        uint64_t decrypt_failures = 0;
+        uint64_t key_derivations = 0;
+        uint64_t key_cache_hits = 0;
+        uint64_t client_hellos = 0;
+        uint64_t evictions = 0;
+    };
+
+    enum class Status : uint8_t {
+        Unsupported,       // 版本或包格式不支持
+        DecryptFailed,     // 标签校验失败（服务端包、损坏或非 Initial）
+        NeedMoreData,      // 已解密，ClientHello 尚未完整
+        ClientHello        // ClientHello 已完整（本包或之前的包）
+    };
+
+    QuicInitialTracker();
+    explicit QuicInitialTracker(const Config& config);
+
+    /**
+     * 处理一个 Initial 包
+     * @param packet 从首字节到 Length 覆盖的末尾，会被原地改写
+     * @param payload 解密成功时输出明文帧
+     * @param hello 状态为 ClientHello 时指向该连接的结果，在下次调用前有效
+     */
+    [[nodiscard]] Status process(uint32_t version,
+                                 std::span<const uint8_t> dcid,
+                                 std::span<uint8_t> packet,
+                                 size_t pn_offset,
+                                 uint64_t& packet_number,
+                                 std::span<const uint8_t>& payload,
+                                 const QuicClientHello*& hello);
+
+    [[nodiscard]] const Statistics& statistics() const noexcept { return stats_; }
+    [[nodiscard]] size_t connection_count() const noexcept { return connections_.size(); }
+    void clear();
+
+    /**
+     * 遍历 Initial 包中的帧，调用 fn(type, crypto_offset, data)
+     * CRYPTO 帧的 data 为其数据，其他帧为类型之后的帧体，crypto_offset 为 0
+     * 只接受 Initial 包中允许的帧类型（PADDING/PING/ACK/CRYPTO/CONNECTION_CLOSE）
+     * @return 帧格式错误或出现其他帧类型时返回 false
+     */
+    template <typename Fn>
+    static bool for_each_frame(std::span<const uint8_t> payload, Fn&& fn);
+
+    // RFC 9000 16：可变长度整数，失败返回 false 且不移动 offset
+    [[nodiscard]] static bool read_varint(std::span<const uint8_t> data, size_t& offset, uint64_t& value) noexcept;
+
+private:
+    struct ConnectionKey {
+        uint32_t version = 0;
+        uint8_t length = 0;
+        std::array<uint8_t, 20> dcid{};
+
+        bool operator==(const ConnectionKey&) const = default;
+    };
+
+    struct ConnectionKeyHash {
+        size_t operator()(const ConnectionKey& key) const noexcept;
+    };
+
+    // 连续覆盖的前缀之外的乱序区间，按起点排序且互不重叠
+    struct Range {
+        uint32_t begin;
+        uint32_t end;
+    };
+
+    struct Connection {
+        QuicInitialKeys keys;
+        std::vector<uint8_t> crypto;
+        std::vector<Range> ranges;
+        uint32_t contiguous = 0;
+        bool complete = false;
+        bool failed = false;            // CRYPTO 数据超限或 ClientHello 无法解析
+        QuicClientHello hello;
+    };
+
+    Config config_;
+    Statistics stats_;
+    std::unordered_map<ConnectionKey, std::unique_ptr<Connection>, ConnectionKeyHash> connections_;
+    std::deque<ConnectionKey> insertion_order_;
+
+    [[nodiscard]] Connection* find_or_create(uint32_t version, std::span<const uint8_t> dcid, bool& created);
+    [[nodiscard]] bool add_crypto(Connection& connection, uint64_t offset, std::span<const uint8_t> data);
+    void try_complete(Connection& connection);
+};
+
+template <typename Fn>
+bool QuicInitialTracker::for_each_frame(std::span<const uint8_t> payload, Fn&& fn) {
+    size_t offset = 0;
+    while (offset < payload.size()) {
+        uint64_t type;
+        if (!read_varint(payload, offset, type)) {
+            return false;
+        }
+        const size_t body = offset;
+
+        uint64_t a, b, c;
+        switch (type) {
+            case 0x00:   // PADDING，连续的填充合并为一帧
+                while (offset < payload.size() && payload[offset] == 0) {
+                    ++offset;
+                }
+                break;
+            case 0x01:   // PING
+                break;
+            case 0x02:   // ACK
+            case 0x03: { // ACK_ECN
+                uint64_t range_count;
+                if (!read_varint(payload, offset, a) || !read_varint(payload, offset, b) ||
+                    !read_varint(payload, offset, range_count) || !read_varint(payload, offset, c)) {
+                    return false;
+                }
+                for (uint64_t i = 0; i < range_count; ++i) {
+                    if (!read_varint(payload, offset, a) || !read_varint(payload, offset, b)) {
+                        return false;
+                    }
+                }
+                if (type == 0x03 && (!read_varint(payload, offset, a) || !read_varint(payload, offset, b) ||
+                                     !read_varint(payload, offset, c))) {
+                    return false;
+                }
+                break;
+            }
+            case 0x06: { // CRYPTO
+                if (!read_varint(payload, offset, a) || !read_varint(payload, offset, b) ||
+                    b > payload.size() - offset) {
+                    return false;
+                }
+                fn(type, a, payload.subspan(offset, static_cast<size_t>(b)));
+                offset += static_cast<size_t>(b);
+                continue;
+            }
+            case 0x1C: { // CONNECTION_CLOSE
+                if (!read_varint(payload, offset, a) || !read_varint(payload, offset, b) ||
+                    !read_varint(payload, offset, c) || c > payload.size() - offset) {
+                    return false;
+                }
+                offset += static_cast<size_t>(c);
+                break;
+            }
+            default:
+                return false;
+        }
+        fn(type, uint64_t{0}, payload.subspan(body, offset - body));
+    }
+    return true;
+}
+
+} // namespace protocol_parser::parsers
@@ -1,7 +1,10 @@
 #pragma once
 
 #include "parsers/base_parser.hpp"
+#include "parsers/transport/quic_connection_table.hpp"
+#include "parsers/transport/quic_initial.hpp"
 #include <cstdint>
+#include <span>
 #include <vector>
 #include <optional>
 
@@ -30,7 +33,9 @@ struct QuicLongHeader {
     uint8_t source_id_length;      // 源连接 ID 长度
     std::vector<uint8_t> source_id;       // 源连接 ID
     QuicPacketType packet_type;
-    std::optional<uint64_t> packet_number;  // 包号（可选，取决于类型）
+    std::optional<uint64_t> packet_number;  // 包号（仅在去除头部保护后可知，即已解密的 Initial 包）
+    std::vector<uint8_t> token;             // Initial 包的地址验证令牌
+    uint64_t length = 0;                    // Length 字段：包号与载荷的总长度
 };
 
 /**
@@ -76,14 +81,20 @@ struct QuicParseResult {
     bool is_long_header;
     QuicLongHeader long_header;
     QuicShortHeader short_header;
-    std::vector<uint8_t> payload;  // 帧数据
+    std::vector<uint8_t> payload;  // 帧数据；Initial 包解密成功时为明文，否则为受保护的密文
 
-    // 解析的帧
+    // 解析的帧（仅已解密的 Initial 包）
     struct Frame {
         QuicFrameType type;
-        std::vector<uint8_t> data;
+        std::vector<uint8_t> data;   // CRYPTO 帧为其数据，其他帧为帧体
     };
     std::vector<Frame> frames;
+
+    bool decrypted = false;
+    std::optional<QuicClientHello> client_hello;   // 客户端 Initial 中重组出的 ClientHello（SNI、ALPN、JA4）
+
+    size_t packet_size = 0;                        // 本包在数据报中占用的字节数
+    QuicConnectionTable::Observation connection;   // 连接表归属结果（connection 为 0 表示未归属）
 };
 
 /**
@@ -110,10 +121,26 @@ public:
     void reset() noexcept override;
 
     /**
-     * 获取解析结果
+     * 获取解析结果（数据报中的第一个包）
      */
     [[nodiscard]] const QuicParseResult& get_result() const {
-        return result_;
+        return packets_.empty() ? result_ : packets_.front();
+    }
+
+    /**
+     * 数据报中合并的全部包（RFC 9000 12.2），按出现顺序
+     */
+    [[nodiscard]] const std::vector<QuicParseResult>& get_packets() const noexcept {
+        return packets_;
+    }
+
+    /**
+     * 设置下一个数据报的抓包时间与路径（调用方计算的五元组哈希，0 = 未知）
+     * 连接表据此做过期、自旋位 RTT 与路径变化检测
+     */
+    void set_packet_info(uint64_t timestamp_us, uint64_t path_key = 0) noexcept {
+        timestamp_us_ = timestamp_us;
+        path_key_ = path_key;
     }
 
     /**
@@ -122,17 +149,40 @@ public:
      */
     [[nodiscard]] static bool is_quic_packet(const BufferView& buffer) noexcept;
 
+    /**
+     * Initial 解密状态：按 DCID 缓存的密钥与跨包重组的 CRYPTO 数据
+     */
+    [[nodiscard]] const QuicInitialTracker& get_initial_tracker() const noexcept {
+        return initial_tracker_;
+    }
+
+    /**
+     * 连接 ID -> 连接；连接 ID 更换与路径迁移后仍归属到同一连接
+     */
+    [[nodiscard]] QuicConnectionTable& get_connection_table() noexcept {
+        return connection_table_;
+    }
+    [[nodiscard]] const QuicConnectionTable& get_connection_table() const noexcept {
+        return connection_table_;
+    }
+
 private:
     /**
      * 解析长包头
+     * @param packet_end 输出本包的末尾（Length 字段覆盖的末尾，或数据报末尾）
      */
-    [[nodiscard]] bool parse_long_header(const BufferView& buffer, size_t& offset);
+    [[nodiscard]] bool parse_long_header(const BufferView& buffer, size_t& offset, size_t& packet_end);
 
     /**
      * 解析短包头
      */
     [[nodiscard]] bool parse_short_header(const BufferView& buffer, size_t& offset);
 
+    /**
+     * 把长包头包的连接 ID 登记到连接表
+     */
+    void track_long_header(size_t packet_size);
+
     /**
      * 解析连接 ID
      */
@@ -140,14 +190,6 @@ private:
                                           size_t& offset,
                                           std::vector<uint8_t>& conn_id);
 
-    /**
-     * 解析包号
-     * QUIC 使用可变长度整数编码
-     */
-    [[nodiscard]] std::optional<uint64_t> parse_packet_number(
-        const BufferView& buffer,
-        size_t& offset);
-
     /**
      * 解析可变长度整数（Variable-Length Integer）
      * RFC 9000 Section 16
@@ -157,12 +199,24 @@ private:
         size_t& offset);
 
     /**
-     * 解析帧
+     * 解密 Initial 包并提取 ClientHello
+     * @param packet_end Length 字段覆盖的末尾
+     */
+    void decrypt_initial(const BufferView& buffer, size_t pn_offset, size_t packet_end);
+
+    /**
+     * 解析帧（明文载荷）
      */
-    [[nodiscard]] bool parse_frames(const BufferView& buffer, size_t offset);
+    [[nodiscard]] bool parse_frames(std::span<const uint8_t> payload);
 
     ProtocolInfo protocol_info_;
     QuicParseResult result_;
+    std::vector<QuicParseResult> packets_;
+    QuicInitialTracker initial_tracker_;
+    QuicConnectionTable connection_table_;
+    uint64_t timestamp_us_ = 0;
+    uint64_t path_key_ = 0;
+    std::vector<uint8_t> packet_buffer_;   // 原地解密用的包副本
     ParserState state_;
     size_t current_offset_;
 };
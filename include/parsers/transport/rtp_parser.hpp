@@ -1,6 +1,7 @@
 #pragma once
 
 #include "parsers/base_parser.hpp"
+#include "parsers/application/sip_dialog_table.hpp"
 #include <cstdint>
 #include <vector>
 #include <optional>
@@ -36,6 +37,10 @@ struct RtpParseResult {
     // 载荷
     std::vector<uint8_t> payload;
 
+    // 经 SIP 会话表绑定时：所属对话编号与 SDP 协商的时钟频率（未绑定或未协商时为 0）
+    uint64_t call = 0;
+    uint32_t clock_rate = 0;
+
     // 常见载荷类型解释
     enum class PayloadType : uint8_t {
         PCMU = 0,          // G.711 μ-law
@@ -71,6 +76,7 @@ struct RtcpParseResult {
     uint8_t version;
     uint16_t length;
     std::vector<uint8_t> data;
+    uint64_t call = 0;         // 经 SIP 会话表绑定时的对话编号
 };
 
 /**
@@ -112,6 +118,14 @@ public:
         return rtcp_result_;
     }
 
+    /**
+     * 绑定下一次 parse() 的数据包到 SipDialogTable::classify() 的结果
+     * 按绑定的 rtcp 标志解析，不再做 RTP/RTCP 启发式判断；只作用于一次 parse()
+     */
+    void set_media_binding(const SipMediaMatch& match) noexcept {
+        binding_ = match;
+    }
+
     /**
      * 检查是否是 RTP 包
      */
@@ -151,6 +165,7 @@ private:
     RtcpParseResult rtcp_result_;
     ParserState state_;
     bool is_rtcp_;
+    std::optional<SipMediaMatch> binding_;
 };
 
 } // namespace protocol_parser::parsers
@@ -0,0 +1,205 @@
+#pragma once
+
+#include "parsers/transport/rtp_parser.hpp"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace protocol_parser::parsers {
+
+/**
+ * 单个 RTP 流（五元组 + SSRC）的接收状态，固定 128 字节以内
+ *
+ * 序列号按 RFC 3550 A.1 扩展并校验，抖动按 A.8 计算；
+ * 重复包用最近 64 个序列号的到达位图识别，不计入 received
+ */
+struct RtpStreamState {
+    uint64_t flow = 0;                   // 调用方提供的五元组键
+    uint64_t first_arrival_us = 0;
+    uint64_t last_arrival_us = 0;
+    uint64_t bytes = 0;                  // RTP 载荷字节数
+    uint64_t history = 0;                // 位 i：扩展序列号 (cycles + max_seq - i) 已到达
+    uint32_t ssrc = 0;
+    uint32_t clock_rate = 0;             // 0 表示未知，不计算抖动
+    uint32_t cycles = 0;                 // 序列号回绕次数 << 16
+    uint32_t base_seq = 0;
+    uint32_t bad_seq = 0;
+    uint32_t received = 0;
+    uint32_t duplicates = 0;
+    uint32_t reordered = 0;
+    int32_t transit = 0;
+    uint32_t jitter = 0;                 // 时间戳单位 × 16
+    uint32_t last_timestamp = 0;
+
+    // 来自 RTCP 的对照数据
+    uint32_t sender_packets = 0;         // 最近一个 SR 中发送方自报的发送包数
+    uint32_t sr_ntp = 0;                 // 最近一个 SR 的 NTP 时间戳中间 32 位
+    uint32_t sr_arrival = 0;             // 该 SR 经过观测点的时间（1/65536 秒）
+    uint32_t rtt = 0;                    // 观测点到接收端的往返时间（1/65536 秒），0 表示未知
+    int32_t reported_lost = 0;           // 接收端 RR 报告的累计丢包
+    uint32_t reported_max_seq = 0;
+    uint32_t reported_jitter = 0;        // 时间戳单位
+
+    uint16_t max_seq = 0;
+    uint8_t payload_type = 0;
+    uint8_t probation = 0;
+    uint8_t reported_fraction = 0;       // 最近一个 RR 的丢包率（1/256）
+    uint8_t flags = 0;
+
+    static constexpr uint8_t kLive = 0x01;
+    static constexpr uint8_t kHasTransit = 0x02;
+    static constexpr uint8_t kHasSenderReport = 0x04;
+    static constexpr uint8_t kHasReceiverReport = 0x08;
+
+    [[nodiscard]] uint32_t extended_max() const noexcept { return cycles + max_seq; }
+    [[nodiscard]] uint32_t expected() const noexcept {
+        return received == 0 ? 0 : extended_max() - base_seq + 1;
+    }
+    [[nodiscard]] int64_t lost() const noexcept {
+        return static_cast<int64_t>(expected()) - received;
+    }
+};
+
+static_assert(sizeof(RtpStreamState) <= 128, "RtpStreamState must stay within two cache lines");
+
+/**
+ * 由 RtpStreamState 换算出的质量指标
+ */
+struct RtpStreamQuality {
+    uint64_t duration_us = 0;
+    uint64_t expected = 0;
+    int64_t lost = 0;
+    double loss_ratio = 0.0;
+    double jitter_ms = 0.0;
+    double rtt_ms = 0.0;                 // 0 表示未知
+
+    // 接收端 RR 报告的累计丢包减去观测点之前的丢包：观测点之后的丢包
+    bool has_report = false;
+    int64_t downstream_lost = 0;
+    double reported_jitter_ms = 0.0;
+
+    // ITU-T G.107 E 模型的简化形式，未计编解码器损伤
+    double r_factor = 0.0;
+    double mos = 0.0;
+};
+
+/**
+ * 每次 RTP 包更新的结果
+ */
+struct RtpPacketInfo {
+    const RtpStreamState* stream = nullptr;  // 在表下一次修改前有效
+    bool new_stream = false;
+    bool counted = false;                // 通过 RFC 3550 A.1 的序列号校验
+    bool duplicate = false;
+    bool reordered = false;
+    // 按序到达时与上一个包相比：时间戳差按时钟频率换算成微秒，以及实际到达间隔
+    int64_t timestamp_delta_us = 0;
+    int64_t arrival_delta_us = 0;
+};
+
+/**
+ * RTP 流质量跟踪表：(五元组, SSRC) -> RtpStreamState
+ *
+ * - 状态存放在连续数组中，按五元组键 + SSRC 与单独按 SSRC 的两个开放寻址索引
+ *   （线性探测、后移删除）查找；每包 O(1)，不分配内存
+ * - RTCP SR/RR 不与 RTP 同端口，按 SSRC 关联（同一 SSRC 以最近建立的流为准）：
+ *   SR 记录发送包数与时间，RR 报告块记录接收端的丢包与抖动，
+ *   并用 LSR/DLSR 算出观测点到接收端的往返时间
+ * - 空闲超过 idle_timeout_us 的流被清扫；时间戳由调用方提供（抓包时间，微秒）
+ */
+class RtpStreamTracker {
+public:
+    struct Config {
+        size_t max_streams = 524288;             // 20 万路通话的双向流
+        uint64_t idle_timeout_us = 60'000'000;
+        size_t sweep_step = 8;
+    };
+
+    struct Statistics {
+        uint64_t streams_created = 0;
+        uint64_t streams_expired = 0;
+        uint64_t packets = 0;
+        uint64_t rtcp_packets = 0;
+        uint64_t report_blocks = 0;
+        uint64_t report_matches = 0;             // 找到对应流的 SR 与报告块
+        uint64_t dropped = 0;                    // 表满，未能建立流
+    };
+
+    RtpStreamTracker();
+    explicit RtpStreamTracker(const Config& config);
+
+    // 由源、目的端点算出五元组键（协议固定为 UDP）
+    [[nodiscard]] static uint64_t flow_key(const SipMediaEndpoint& source,
+                                           const SipMediaEndpoint& destination) noexcept;
+
+    /**
+     * 处理一个已解析的 RTP 包
+     * 时钟频率依次取 rtp.clock_rate（SDP 协商）与 RFC 3551 的静态载荷类型
+     * @return 表满时返回 false
+     */
+    bool observe(uint64_t flow, const RtpParseResult& rtp, uint64_t now_us, RtpPacketInfo& out);
+
+    /**
+     * 处理一个 RTCP 复合包，逐个读取其中的 SR 与 RR
+     * @return 找到对应流的 SR 与报告块数
+     */
+    size_t observe_rtcp(std::span<const uint8_t> compound, uint64_t now_us);
+
+    [[nodiscard]] const RtpStreamState* find(uint64_t flow, uint32_t ssrc) const noexcept;
+    [[nodiscard]] const RtpStreamState* find_by_ssrc(uint32_t ssrc) const noexcept;
+
+    template <typename Fn>
+    void for_each(Fn&& fn) const {
+        for (const auto& state : states_) {
+            if (state.flags & RtpStreamState::kLive) {
+                fn(state);
+            }
+        }
+    }
+
+    [[nodiscard]] static RtpStreamQuality quality(const RtpStreamState& state) noexcept;
+
+    // RFC 3551 静态载荷类型的时钟频率，动态或未知类型返回 0
+    [[nodiscard]] static uint32_t static_clock_rate(uint8_t payload_type) noexcept;
+
+    void expire(uint64_t now_us);
+
+    [[nodiscard]] size_t stream_count() const noexcept { return live_streams_; }
+    [[nodiscard]] const Statistics& statistics() const noexcept { return stats_; }
+
+    void clear();
+
+private:
+    static constexpr uint32_t kNone = UINT32_MAX;
+
+    struct IndexSlot {
+        uint64_t hash = 0;
+        uint32_t stream = kNone;
+    };
+
+    Config config_;
+    std::vector<RtpStreamState> states_;
+    std::vector<uint32_t> free_states_;
+    size_t live_streams_ = 0;
+
+    std::vector<IndexSlot> flow_index_;          // (flow, ssrc)
+    std::vector<IndexSlot> ssrc_index_;          // ssrc -> 最近建立的流
+    size_t mask_ = 0;
+    size_t sweep_cursor_ = 0;
+
+    Statistics stats_;
+
+    [[nodiscard]] size_t find_flow(uint64_t flow, uint32_t ssrc, uint64_t hash) const noexcept;
+    [[nodiscard]] size_t find_ssrc(uint32_t ssrc, uint64_t hash) const noexcept;
+    void insert_slot(std::vector<IndexSlot>& index, uint64_t hash, uint32_t stream) noexcept;
+    void erase_slot(std::vector<IndexSlot>& index, size_t slot) noexcept;
+
+    [[nodiscard]] uint32_t create_stream(uint64_t flow, uint32_t ssrc, uint64_t now_us);
+    void release_stream(uint32_t stream) noexcept;
+    void sweep(uint64_t now_us, size_t budget) noexcept;
+
+    [[nodiscard]] RtpStreamState* stream_by_ssrc(uint32_t ssrc) noexcept;
+    bool apply_report_block(std::span<const uint8_t> block, uint32_t now_ntp) noexcept;
+};
+
+} // namespace protocol_parser::parsers
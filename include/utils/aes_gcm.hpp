@@ -0,0 +1,95 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace protocol_parser::utils {
+
+/**
+ * AES-128 分组加密（FIPS 197），只实现加密方向（CTR/GCM 与 QUIC 头部保护只需要加密）
+ * CPU 支持 AES-NI 时使用硬件指令，否则使用查表的可移植实现
+ */
+class AES128 {
+public:
+    static constexpr size_t kKeySize = 16;
+    static constexpr size_t kBlockSize = 16;
+    static constexpr size_t kRounds = 10;
+    using Block = std::array<uint8_t, kBlockSize>;
+
+    AES128() noexcept = default;
+    explicit AES128(std::span<const uint8_t, kKeySize> key) noexcept { set_key(key); }
+
+    void set_key(std::span<const uint8_t, kKeySize> key) noexcept;
+
+    // in 与 out 可以相同
+    void encrypt_block(const uint8_t* in, uint8_t* out) const noexcept;
+
+    /**
+     * CTR 模式：data ^= E(counter), E(counter + 1), ...，计数器为低 32 位大端递增（GCM 约定）
+     */
+    void ctr32_xor(const Block& counter, std::span<uint8_t> data) const noexcept;
+
+    [[nodiscard]] static bool hardware_accelerated() noexcept;
+
+private:
+    alignas(16) std::array<uint8_t, kBlockSize * (kRounds + 1)> round_keys_{};
+};
+
+/**
+ * AES-NI/PCLMULQDQ 实现，定义在单独以 -maes -mpclmul -msse4.1 编译的 aes_gcm_ni.cpp；
+ * 仅在 AES128::hardware_accelerated() 为 true 时调用
+ */
+namespace aes_ni {
+    void encrypt_block(const uint8_t* round_keys, const uint8_t* in, uint8_t* out) noexcept;
+    void ctr32_xor(const uint8_t* round_keys, const AES128::Block& counter, std::span<uint8_t> data) noexcept;
+    // hash_key 为大端的 H，结果以大端写入 out（16 字节）
+    void ghash(const uint8_t* hash_key, std::span<const uint8_t> aad, std::span<const uint8_t> ciphertext,
+               std::span<const uint8_t, 16> lengths, uint8_t* out) noexcept;
+}
+
+/**
+ * AES-128-GCM（NIST SP 800-38D），96 位 nonce、128 位认证标签
+ * GHASH 在支持 PCLMULQDQ 时使用无进位乘法，否则使用 4 位查表（Shoup）
+ */
+class AES128GCM {
+public:
+    static constexpr size_t kKeySize = AES128::kKeySize;
+    static constexpr size_t kNonceSize = 12;
+    static constexpr size_t kTagSize = 16;
+
+    AES128GCM() noexcept = default;
+    explicit AES128GCM(std::span<const uint8_t, kKeySize> key) noexcept { set_key(key); }
+
+    void set_key(std::span<const uint8_t, kKeySize> key) noexcept;
+
+    /**
+     * 解密并校验标签
+     * @param ciphertext 密文，末尾 16 字节为标签
+     * @param plaintext 输出，至少 ciphertext.size() - kTagSize 字节，可与 ciphertext 原地重叠（同一起点）
+     * @return 标签校验通过返回 true；失败时 plaintext 内容无意义
+     */
+    [[nodiscard]] bool decrypt(std::span<const uint8_t, kNonceSize> nonce,
+                               std::span<const uint8_t> aad,
+                               std::span<const uint8_t> ciphertext,
+                               std::span<uint8_t> plaintext) const noexcept;
+
+    /**
+     * 加密，out 至少 plaintext.size() + kTagSize 字节，可与 plaintext 原地重叠
+     */
+    void encrypt(std::span<const uint8_t, kNonceSize> nonce,
+                 std::span<const uint8_t> aad,
+                 std::span<const uint8_t> plaintext,
+                 std::span<uint8_t> out) const noexcept;
+
+private:
+    AES128 aes_;
+    std::array<uint8_t, 16> hash_key_{};            // H = E(K, 0)，大端
+    std::array<uint64_t, 32> hash_table_{};         // 可移植 GHASH 的 H 倍数表（高/低 64 位交替）
+
+    [[nodiscard]] AES128::Block ghash(std::span<const uint8_t> aad, std::span<const uint8_t> ciphertext) const noexcept;
+    [[nodiscard]] AES128::Block initial_counter(std::span<const uint8_t, kNonceSize> nonce) const noexcept;
+};
+
+} // namespace protocol_parser::utils
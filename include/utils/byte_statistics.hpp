@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+namespace protocol_parser::utils {
+
+/**
+ * 单遍字节统计结果
+ * 直方图、可打印/空/控制字符计数与最长零字节游程在一次扫描中得到
+ */
+struct ByteStatistics {
+    std::array<uint32_t, 256> histogram{};  // 字节直方图
+    size_t total_bytes{0};                  // 统计的字节数
+    size_t printable_count{0};              // 可打印 ASCII (0x20-0x7E)
+    size_t null_count{0};                   // 0x00
+    size_t control_count{0};                // 0x01-0x1F 与 0x7F
+    size_t longest_zero_run{0};             // 最长连续 0x00
+
+    /**
+     * 香农熵（比特/字节），使用查表 log2
+     */
+    [[nodiscard]] double entropy() const noexcept;
+
+    [[nodiscard]] double printable_ratio() const noexcept {
+        return total_bytes > 0 ? static_cast<double>(printable_count) / total_bytes : 0.0;
+    }
+};
+
+/**
+ * 字节统计 SIMD 内核
+ * 供 HeuristicDetector 与 AIProtocolDetector 共享
+ *
+ * - 直方图使用 4 个子直方图交错累加，避免相邻相同字节的存储冲突
+ * - 分类计数与零字节游程使用 AVX2 比较 + movemask（无 AVX2 时回退标量）
+ */
+class ByteStatisticsKernel {
+public:
+    /**
+     * 单遍计算全部统计量
+     * @param data 数据指针
+     * @param size 数据大小
+     * @param out 输出（会被完全覆盖）
+     */
+    static void compute(const uint8_t* data, size_t size, ByteStatistics& out) noexcept;
+
+    /**
+     * 由直方图计算熵：H = log2(N) - (1/N) * Σ c·log2(c)
+     * c·log2(c) 对小计数查表，大计数回退 std::log2
+     */
+    [[nodiscard]] static double entropy(const std::array<uint32_t, 256>& histogram,
+                                        size_t total) noexcept;
+
+    /**
+     * 查表 n·log2(n)
+     */
+    [[nodiscard]] static double n_log2_n(uint32_t n) noexcept;
+
+    // 查表覆盖的计数上限（覆盖 Jumbo 帧以内的绝大多数字节计数）
+    static constexpr uint32_t kLog2TableSize = 4096;
+};
+
+} // namespace protocol_parser::utils
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+namespace protocol_parser::utils {
+
+/**
+ * MD5（RFC 1321），仅用于指纹（JA3/JA3S），不用于安全场景
+ * 增量接口：update 可多次调用，finalize 后对象需 reset 才能复用
+ */
+class MD5 {
+public:
+    static constexpr size_t kDigestSize = 16;
+    using Digest = std::array<uint8_t, kDigestSize>;
+
+    MD5() noexcept { reset(); }
+
+    void reset() noexcept;
+    void update(std::span<const uint8_t> data) noexcept;
+    void update(std::string_view text) noexcept {
+        update(std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(text.data()), text.size()));
+    }
+    [[nodiscard]] Digest finalize() noexcept;
+
+    [[nodiscard]] static Digest hash(std::span<const uint8_t> data) noexcept {
+        MD5 md5;
+        md5.update(data);
+        return md5.finalize();
+    }
+
+private:
+    std::array<uint32_t, 4> state_{};
+    std::array<uint8_t, 64> block_{};
+    uint64_t total_bytes_ = 0;
+
+    void compress(const uint8_t* block) noexcept;
+};
+
+/**
+ * SHA-256（FIPS 180-4）
+ * 用于 JA4 指纹、证书指纹与 HKDF
+ */
+class SHA256 {
+public:
+    static constexpr size_t kDigestSize = 32;
+    static constexpr size_t kBlockSize = 64;
+    using Digest = std::array<uint8_t, kDigestSize>;
+
+    SHA256() noexcept { reset(); }
+
+    void reset() noexcept;
+    void update(std::span<const uint8_t> data) noexcept;
+    void update(std::string_view text) noexcept {
+        update(std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(text.data()), text.size()));
+    }
+    [[nodiscard]] Digest finalize() noexcept;
+
+    [[nodiscard]] static Digest hash(std::span<const uint8_t> data) noexcept {
+        SHA256 sha;
+        sha.update(data);
+        return sha.finalize();
+    }
+
+private:
+    std::array<uint32_t, 8> state_{};
+    std::array<uint8_t, kBlockSize> block_{};
+    uint64_t total_bytes_ = 0;
+
+    void compress(const uint8_t* block) noexcept;
+};
+
+/**
+ * HMAC-SHA256（RFC 2104）
+ */
+class HMACSHA256 {
+public:
+    explicit HMACSHA256(std::span<const uint8_t> key) noexcept;
+
+    void update(std::span<const uint8_t> data) noexcept { inner_.update(data); }
+    [[nodiscard]] SHA256::Digest finalize() noexcept;
+
+    [[nodiscard]] static SHA256::Digest mac(std::span<const uint8_t> key, std::span<const uint8_t> data) noexcept {
+        HMACSHA256 hmac(key);
+        hmac.update(data);
+        return hmac.finalize();
+    }
+
+private:
+    SHA256 inner_;
+    SHA256 outer_;
+};
+
+/**
+ * HKDF-SHA256（RFC 5869）
+ * extract 得到 PRK；expand 输出 out.size() 字节，最多 255 * 32 字节，超出返回 false
+ */
+[[nodiscard]] SHA256::Digest hkdf_extract(std::span<const uint8_t> salt, std::span<const uint8_t> ikm) noexcept;
+[[nodiscard]] bool hkdf_expand(std::span<const uint8_t> prk, std::span<const uint8_t> info, std::span<uint8_t> out) noexcept;
+
+/**
+ * 小写十六进制编码，输出长度为 2 * data.size()，out 不足时截断
+ * @return 写入的字符数
+ */
+size_t to_hex(std::span<const uint8_t> data, std::span<char> out) noexcept;
+
+} // namespace protocol_parser::utils
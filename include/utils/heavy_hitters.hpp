@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace protocol_parser::utils {
+
+/**
+ * 固定内存的高频项统计（Space-Saving，Metwally 等 2005）
+ *
+ * - 最多跟踪 capacity 个键；表满时新键顶替计数最小的项，继承其计数作为误差
+ * - 任何真实频次超过 total / capacity 的键一定在表中；
+ *   count 为频次上界，count - error 为下界
+ * - 最小计数用二叉小顶堆维护，键索引为开放寻址表（线性探测、后移删除），
+ *   每次 add 为 O(log capacity)，不随不同键的数量增长
+ * - 键超过 max_key_length 时截断后再统计
+ */
+class HeavyHitterSketch {
+public:
+    struct Entry {
+        std::string key;
+        uint64_t count = 0;
+        uint64_t error = 0;
+    };
+
+    explicit HeavyHitterSketch(size_t capacity = 1024, size_t max_key_length = 256);
+
+    void add(std::string_view key, uint64_t weight = 1);
+
+    // 频次上界；未被跟踪的键返回 0
+    [[nodiscard]] uint64_t estimate(std::string_view key) const noexcept;
+
+    // 计数最高的 k 项，按计数降序
+    [[nodiscard]] std::vector<Entry> top(size_t k) const;
+
+    [[nodiscard]] size_t size() const noexcept { return size_; }
+    [[nodiscard]] size_t capacity() const noexcept { return entries_.size(); }
+    [[nodiscard]] uint64_t total() const noexcept { return total_; }
+
+    void clear() noexcept;
+
+private:
+    static constexpr uint32_t kEmpty = UINT32_MAX;
+
+    struct Slot {
+        uint64_t hash = 0;
+        uint32_t entry = kEmpty;
+    };
+
+    std::vector<Entry> entries_;
+    std::vector<uint64_t> hashes_;         // 按项
+    std::vector<uint32_t> heap_;           // 项下标的小顶堆（按 count）
+    std::vector<uint32_t> heap_position_;  // 项在堆中的位置
+    std::vector<Slot> slots_;
+    size_t mask_ = 0;
+    size_t size_ = 0;
+    size_t max_key_length_ = 0;
+    uint64_t total_ = 0;
+
+    [[nodiscard]] std::string_view clamp(std::string_view key) const noexcept {
+        return key.substr(0, max_key_length_);
+    }
+    [[nodiscard]] size_t find_slot(std::string_view key, uint64_t hash) const noexcept;   // slots_.size() 表示不存在
+    void insert_slot(uint64_t hash, uint32_t entry) noexcept;
+    void erase_slot(size_t index) noexcept;
+    void sift_down(size_t position) noexcept;
+    void sift_up(size_t position) noexcept;
+};
+
+} // namespace protocol_parser::utils
@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <cstddef>
+#include <array>
 #include <cstring>
 #include <immintrin.h>
 
@@ -134,6 +135,25 @@ public:
                                 uint32_t* values,
                                 size_t count);
 
+    // ========================================================================
+    // 掩码与文本校验（WebSocket 等）
+    // ========================================================================
+
+    /**
+     * 按 4 字节循环掩码异或（RFC 6455 5.3），AVX2 每次处理 32 字节
+     * @param dst 输出，可与 src 相同（原地去掩码）
+     * @param mask 掩码键，最高字节为线路上的第一个字节
+     * @param phase 起始字节在掩码中的位置（0-3），用于分段处理
+     * @return 处理完后的位置，作为下一段的 phase
+     */
+    static size_t xor_mask(uint8_t* dst, const uint8_t* src, size_t size, uint32_t mask, size_t phase = 0) noexcept;
+
+    /**
+     * 严格的 UTF-8 校验（RFC 3629：拒绝过长编码、代理项与 U+10FFFF 以上的码点）
+     * AVX2 路径按 Keiser-Lemire 查表法每次检查 32 字节，纯 ASCII 块只做一次 movemask
+     */
+    static bool validate_utf8(const uint8_t* data, size_t size) noexcept;
+
 private:
     // CRC32 查找表（用于无硬件加速的情况）
     static uint32_t crc32_table_[256];
@@ -143,6 +163,34 @@ private:
 
     // 软件实现 CRC32（回退）
     static uint32_t crc32_software(const uint8_t* data, size_t size);
+
+    static bool validate_utf8_scalar(const uint8_t* data, size_t size) noexcept;
+    static bool validate_utf8_avx2(const uint8_t* data, size_t size) noexcept;
+};
+
+/**
+ * 分段 UTF-8 校验：数据按片段到达（如 WebSocket 分片消息），码点可能跨片段
+ * 片段末尾不完整的序列（至多 3 字节）暂存到下一段拼接，其余部分直接交给 validate_utf8
+ */
+class UTF8Validator {
+public:
+    /**
+     * @return 已出现非法序列时返回 false，之后的调用都返回 false
+     */
+    bool update(const uint8_t* data, size_t size) noexcept;
+
+    /**
+     * 结束校验：不能停在序列中间
+     */
+    [[nodiscard]] bool finish() const noexcept { return valid_ && pending_size_ == 0; }
+
+    void reset() noexcept { *this = UTF8Validator{}; }
+
+private:
+    std::array<uint8_t, 4> pending_{};
+    uint8_t pending_size_ = 0;
+    uint8_t pending_need_ = 0;
+    bool valid_ = true;
 };
 
 // ============================================================================
@@ -162,7 +210,7 @@ inline bool SIMDUtils::equals_avx2(const uint8_t* a,
         __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
         __m256i cmp = _mm256_cmpeq_epi8(va, vb);
 
-        if (_mm256_movemask_epi8(cmp) != 0xFFFFFFFF) {
+        if (static_cast<uint32_t>(_mm256_movemask_epi8(cmp)) != 0xFFFFFFFFu) {
             return false;
         }
         i += 32;
@@ -0,0 +1,520 @@
+#include "ai/compiled_model.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace protocol_parser::ai {
+
+namespace {
+    // 快速 exp（x <= 0），2^x = 2^i · 2^f，2^f 用 4 阶多项式近似，相对误差约 1e-4
+    inline float fast_exp(float x) {
+        x = std::max(x, -80.0f);
+        const float t = x * 1.44269504f;
+        const float i = std::floor(t);
+        const float f = t - i;
+        const float p = 1.0f + f * (0.6931472f + f * (0.2402265f + f * (0.0555041f + f * 0.0096181f)));
+        int32_t bits;
+        std::memcpy(&bits, &p, sizeof(bits));
+        bits += static_cast<int32_t>(i) << 23;
+        float result;
+        std::memcpy(&result, &bits, sizeof(result));
+        return result;
+    }
+
+#ifdef __AVX2__
+    inline __m256 multiply_add(__m256 a, __m256 b, __m256 c) {
+        #ifdef __FMA__
+            return _mm256_fmadd_ps(a, b, c);
+        #else
+            return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+        #endif
+    }
+
+    inline float horizontal_sum(__m256 v) {
+        __m128 low = _mm256_castps256_ps128(v);
+        __m128 high = _mm256_extractf128_ps(v, 1);
+        __m128 sum = _mm_add_ps(low, high);
+        sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+        sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 0x55));
+        return _mm_cvtss_f32(sum);
+    }
+
+    inline __m256 load_int8x8(const int8_t* data) {
+        __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(data));
+        return _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(bytes));
+    }
+
+    // 8 路 fast_exp，算法同标量版本
+    inline __m256 fast_exp_ps(__m256 x) {
+        x = _mm256_max_ps(x, _mm256_set1_ps(-80.0f));
+        const __m256 t = _mm256_mul_ps(x, _mm256_set1_ps(1.44269504f));
+        const __m256 i = _mm256_floor_ps(t);
+        const __m256 f = _mm256_sub_ps(t, i);
+        __m256 p = _mm256_set1_ps(0.0096181f);
+        p = multiply_add(p, f, _mm256_set1_ps(0.0555041f));
+        p = multiply_add(p, f, _mm256_set1_ps(0.2402265f));
+        p = multiply_add(p, f, _mm256_set1_ps(0.6931472f));
+        p = multiply_add(p, f, _mm256_set1_ps(1.0f));
+        const __m256i exponent = _mm256_slli_epi32(_mm256_cvtps_epi32(i), 23);
+        return _mm256_castsi256_ps(_mm256_add_epi32(_mm256_castps_si256(p), exponent));
+    }
+#endif
+
+    void append_u8(std::vector<uint8_t>& out, uint8_t value) {
+        out.push_back(value);
+    }
+
+    void append_u16(std::vector<uint8_t>& out, uint16_t value) {
+        out.push_back(static_cast<uint8_t>(value));
+        out.push_back(static_cast<uint8_t>(value >> 8));
+    }
+
+    void append_u32(std::vector<uint8_t>& out, uint32_t value) {
+        for (int shift = 0; shift < 32; shift += 8) {
+            out.push_back(static_cast<uint8_t>(value >> shift));
+        }
+    }
+
+    void append_f32(std::vector<uint8_t>& out, float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        append_u32(out, bits);
+    }
+
+    float read_f32(const protocol_parser::core::BufferView& buffer, size_t offset) {
+        uint32_t bits = buffer.read_le32(offset);
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+}
+
+// ============================================================================
+// 构建与加载
+// ============================================================================
+
+void CompiledModel::clear() noexcept {
+    class_count_ = 0;
+    class_names_.clear();
+    biases_.clear();
+    scales_.clear();
+    float_weights_.clear();
+    int8_weights_.clear();
+}
+
+bool CompiledModel::build(std::vector<std::string> class_names,
+                          std::span<const float> biases,
+                          std::span<const float> weights,
+                          WeightType type) {
+    clear();
+    error_message_.clear();
+
+    const size_t classes = class_names.size();
+    if (classes == 0 || classes > kMaxClasses) {
+        error_message_ = "Invalid class count";
+        return false;
+    }
+    if (biases.size() != classes || weights.size() != classes * kFeatureCount) {
+        error_message_ = "Weight dimensions do not match class count";
+        return false;
+    }
+
+    weight_type_ = type;
+    class_names_ = std::move(class_names);
+    biases_.assign(biases.begin(), biases.end());
+
+    if (type == WeightType::FLOAT32) {
+        float_weights_.assign(classes * kPaddedFeatureCount, 0.0f);
+        for (size_t c = 0; c < classes; ++c) {
+            std::copy_n(weights.data() + c * kFeatureCount, kFeatureCount,
+                        float_weights_.data() + c * kPaddedFeatureCount);
+        }
+    } else {
+        // 每类对称量化：scale = max|w| / 127
+        int8_weights_.assign(classes * kPaddedFeatureCount, 0);
+        scales_.assign(classes, 0.0f);
+        for (size_t c = 0; c < classes; ++c) {
+            const float* row = weights.data() + c * kFeatureCount;
+            float max_abs = 0.0f;
+            for (size_t f = 0; f < kFeatureCount; ++f) {
+                max_abs = std::max(max_abs, std::fabs(row[f]));
+            }
+            const float scale = max_abs > 0.0f ? max_abs / 127.0f : 1.0f;
+            scales_[c] = scale;
+            for (size_t f = 0; f < kFeatureCount; ++f) {
+                float q = std::round(row[f] / scale);
+                int8_weights_[c * kPaddedFeatureCount + f] =
+                    static_cast<int8_t>(std::clamp(q, -127.0f, 127.0f));
+            }
+        }
+    }
+
+    class_count_ = classes;
+    return true;
+}
+
+bool CompiledModel::load_from_buffer(const protocol_parser::core::BufferView& buffer) {
+    clear();
+    error_message_.clear();
+
+    constexpr size_t kHeaderSize = 12;
+    if (!buffer.can_read(kHeaderSize)) {
+        error_message_ = "Model file too small";
+        return false;
+    }
+    if (buffer.read_le32(0) != kFileMagic) {
+        error_message_ = "Invalid model magic";
+        return false;
+    }
+    if (buffer.read_le16(4) != kFileVersion) {
+        error_message_ = "Unsupported model version";
+        return false;
+    }
+
+    const uint8_t raw_type = buffer[6];
+    if (raw_type > static_cast<uint8_t>(WeightType::INT8)) {
+        error_message_ = "Unknown weight type";
+        return false;
+    }
+    const auto type = static_cast<WeightType>(raw_type);
+
+    if (buffer.read_le16(8) != kFeatureCount) {
+        error_message_ = "Feature count mismatch";
+        return false;
+    }
+    const size_t classes = buffer.read_le16(10);
+    if (classes == 0 || classes > kMaxClasses) {
+        error_message_ = "Invalid class count";
+        return false;
+    }
+
+    size_t offset = kHeaderSize;
+    std::vector<std::string> names;
+    names.reserve(classes);
+    for (size_t c = 0; c < classes; ++c) {
+        if (!buffer.can_read(1, offset)) {
+            error_message_ = "Truncated class names";
+            return false;
+        }
+        const size_t length = buffer[offset++];
+        if (!buffer.can_read(length, offset)) {
+            error_message_ = "Truncated class names";
+            return false;
+        }
+        names.emplace_back(reinterpret_cast<const char*>(buffer.data() + offset), length);
+        offset += length;
+    }
+
+    const size_t weight_bytes = classes * kFeatureCount * (type == WeightType::INT8 ? 1 : 4);
+    const size_t scale_bytes = type == WeightType::INT8 ? classes * 4 : 0;
+    if (!buffer.can_read(classes * 4 + scale_bytes + weight_bytes, offset)) {
+        error_message_ = "Truncated weights";
+        return false;
+    }
+
+    weight_type_ = type;
+    class_names_ = std::move(names);
+
+    biases_.resize(classes);
+    for (size_t c = 0; c < classes; ++c, offset += 4) {
+        biases_[c] = read_f32(buffer, offset);
+    }
+
+    if (type == WeightType::INT8) {
+        scales_.resize(classes);
+        for (size_t c = 0; c < classes; ++c, offset += 4) {
+            scales_[c] = read_f32(buffer, offset);
+        }
+        int8_weights_.assign(classes * kPaddedFeatureCount, 0);
+        for (size_t c = 0; c < classes; ++c) {
+            std::memcpy(int8_weights_.data() + c * kPaddedFeatureCount,
+                        buffer.data() + offset, kFeatureCount);
+            offset += kFeatureCount;
+        }
+    } else {
+        float_weights_.assign(classes * kPaddedFeatureCount, 0.0f);
+        for (size_t c = 0; c < classes; ++c) {
+            for (size_t f = 0; f < kFeatureCount; ++f, offset += 4) {
+                float_weights_[c * kPaddedFeatureCount + f] = read_f32(buffer, offset);
+            }
+        }
+    }
+
+    class_count_ = classes;
+    return true;
+}
+
+bool CompiledModel::load_from_file(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        clear();
+        error_message_ = "Cannot open model file: " + path;
+        return false;
+    }
+
+    std::vector<uint8_t> content((std::istreambuf_iterator<char>(file)),
+                                 std::istreambuf_iterator<char>());
+    return load_from_buffer(protocol_parser::core::BufferView(content.data(), content.size()));
+}
+
+std::vector<uint8_t> CompiledModel::serialize() const {
+    std::vector<uint8_t> out;
+    if (empty()) {
+        return out;
+    }
+
+    append_u32(out, kFileMagic);
+    append_u16(out, kFileVersion);
+    append_u8(out, static_cast<uint8_t>(weight_type_));
+    append_u8(out, 0);
+    append_u16(out, static_cast<uint16_t>(kFeatureCount));
+    append_u16(out, static_cast<uint16_t>(class_count_));
+
+    for (const auto& name : class_names_) {
+        const size_t length = std::min<size_t>(name.size(), 255);
+        append_u8(out, static_cast<uint8_t>(length));
+        out.insert(out.end(), name.begin(), name.begin() + length);
+    }
+
+    for (float bias : biases_) {
+        append_f32(out, bias);
+    }
+
+    if (weight_type_ == WeightType::INT8) {
+        for (float scale : scales_) {
+            append_f32(out, scale);
+        }
+        for (size_t c = 0; c < class_count_; ++c) {
+            const int8_t* row = int8_weights_.data() + c * kPaddedFeatureCount;
+            for (size_t f = 0; f < kFeatureCount; ++f) {
+                append_u8(out, static_cast<uint8_t>(row[f]));
+            }
+        }
+    } else {
+        for (size_t c = 0; c < class_count_; ++c) {
+            for (size_t f = 0; f < kFeatureCount; ++f) {
+                append_f32(out, float_weights_[c * kPaddedFeatureCount + f]);
+            }
+        }
+    }
+
+    return out;
+}
+
+const std::string& CompiledModel::class_name(size_t index) const noexcept {
+    static const std::string unknown = "UNKNOWN";
+    return index < class_names_.size() ? class_names_[index] : unknown;
+}
+
+// ============================================================================
+// 打分
+// ============================================================================
+
+float CompiledModel::weight(size_t class_index, size_t feature) const noexcept {
+    const size_t index = class_index * kPaddedFeatureCount + feature;
+    return weight_type_ == WeightType::INT8
+        ? static_cast<float>(int8_weights_[index]) * scales_[class_index]
+        : float_weights_[index];
+}
+
+float CompiledModel::dot(size_t class_index, const float* padded_features) const noexcept {
+#ifdef __AVX2__
+    __m256 acc = _mm256_setzero_ps();
+    if (weight_type_ == WeightType::INT8) {
+        const int8_t* row = int8_weights_.data() + class_index * kPaddedFeatureCount;
+        for (size_t f = 0; f < kPaddedFeatureCount; f += 8) {
+            acc = multiply_add(load_int8x8(row + f), _mm256_loadu_ps(padded_features + f), acc);
+        }
+        return horizontal_sum(acc) * scales_[class_index];
+    }
+    const float* row = float_weights_.data() + class_index * kPaddedFeatureCount;
+    for (size_t f = 0; f < kPaddedFeatureCount; f += 8) {
+        acc = multiply_add(_mm256_loadu_ps(row + f), _mm256_loadu_ps(padded_features + f), acc);
+    }
+    return horizontal_sum(acc);
+#else
+    float sum = 0.0f;
+    if (weight_type_ == WeightType::INT8) {
+        const int8_t* row = int8_weights_.data() + class_index * kPaddedFeatureCount;
+        for (size_t f = 0; f < kFeatureCount; ++f) {
+            sum += static_cast<float>(row[f]) * padded_features[f];
+        }
+        return sum * scales_[class_index];
+    }
+    const float* row = float_weights_.data() + class_index * kPaddedFeatureCount;
+    for (size_t f = 0; f < kFeatureCount; ++f) {
+        sum += row[f] * padded_features[f];
+    }
+    return sum;
+#endif
+}
+
+ModelPrediction CompiledModel::finalize(const float* scores) const noexcept {
+    ModelPrediction prediction;
+
+    size_t best = 0;
+    float best_score = scores[0];
+    for (size_t c = 1; c < class_count_; ++c) {
+        if (scores[c] > best_score) {
+            best_score = scores[c];
+            best = c;
+        }
+    }
+
+    // softmax 置信度（减去最大值保证数值稳定）
+    float denominator = 0.0f;
+    size_t c = 0;
+#ifdef __AVX2__
+    const __m256 max_score = _mm256_set1_ps(best_score);
+    __m256 sum = _mm256_setzero_ps();
+    for (; c + 8 <= class_count_; c += 8) {
+        sum = _mm256_add_ps(sum, fast_exp_ps(_mm256_sub_ps(_mm256_loadu_ps(scores + c), max_score)));
+    }
+    denominator = horizontal_sum(sum);
+#endif
+    for (; c < class_count_; ++c) {
+        denominator += fast_exp(scores[c] - best_score);
+    }
+
+    prediction.class_index = static_cast<uint16_t>(best);
+    prediction.score = best_score;
+    prediction.confidence = denominator > 0.0f ? 1.0f / denominator : 0.0f;
+    return prediction;
+}
+
+ModelPrediction CompiledModel::classify(const FeatureVector& features) const noexcept {
+    if (empty()) {
+        return ModelPrediction{};
+    }
+
+    alignas(32) std::array<float, kPaddedFeatureCount> padded{};
+    std::copy(features.begin(), features.end(), padded.begin());
+
+    std::array<float, kMaxClasses> scores;
+    for (size_t c = 0; c < class_count_; ++c) {
+        scores[c] = biases_[c] + dot(c, padded.data());
+    }
+    return finalize(scores.data());
+}
+
+void CompiledModel::classify(std::span<const FeatureVector> features,
+                             std::span<ModelPrediction> out) const noexcept {
+    const size_t rows = std::min(features.size(), out.size());
+    if (empty() || rows == 0) {
+        return;
+    }
+
+    // 每 8 行转置为 SoA 小块后复用块打分
+    alignas(32) std::array<float, kFeatureCount * kBlockRows> block{};
+    for (size_t row = 0; row < rows; row += kBlockRows) {
+        const size_t lanes = std::min(kBlockRows, rows - row);
+        for (size_t lane = 0; lane < lanes; ++lane) {
+            const auto& vector = features[row + lane];
+            for (size_t f = 0; f < kFeatureCount; ++f) {
+                block[f * kBlockRows + lane] = vector[f];
+            }
+        }
+        classify_block(block.data(), kBlockRows, lanes, out.data() + row);
+    }
+}
+
+void CompiledModel::classify(const detection::FeatureMatrix& features,
+                             std::span<ModelPrediction> out) const noexcept {
+    static_assert(detection::FeatureMatrix::kRowAlignment == kBlockRows,
+                  "FeatureMatrix rows must be padded to the scoring block size");
+
+    const size_t rows = std::min(features.rows(), out.size());
+    if (empty() || rows == 0) {
+        return;
+    }
+
+    for (size_t row = 0; row < rows; row += kBlockRows) {
+        classify_block(features.column(0) + row, features.stride(),
+                       std::min(kBlockRows, rows - row), out.data() + row);
+    }
+}
+
+void CompiledModel::classify_block(const float* block, size_t stride, size_t lanes,
+                                   ModelPrediction* out) const noexcept {
+    constexpr size_t kBlock = kBlockRows;
+
+    // scores[c * kBlock + lane]
+    alignas(32) std::array<float, kMaxClasses * kBlock> scores;
+
+    for (size_t c = 0; c < class_count_; ++c) {
+#ifdef __AVX2__
+        __m256 acc = _mm256_setzero_ps();
+        if (weight_type_ == WeightType::INT8) {
+            const int8_t* weights = int8_weights_.data() + c * kPaddedFeatureCount;
+            for (size_t f = 0; f < kFeatureCount; ++f) {
+                acc = multiply_add(_mm256_set1_ps(static_cast<float>(weights[f])),
+                                   _mm256_loadu_ps(block + f * stride), acc);
+            }
+            acc = _mm256_mul_ps(acc, _mm256_set1_ps(scales_[c]));
+        } else {
+            const float* weights = float_weights_.data() + c * kPaddedFeatureCount;
+            for (size_t f = 0; f < kFeatureCount; ++f) {
+                acc = multiply_add(_mm256_set1_ps(weights[f]),
+                                   _mm256_loadu_ps(block + f * stride), acc);
+            }
+        }
+        acc = _mm256_add_ps(acc, _mm256_set1_ps(biases_[c]));
+        _mm256_store_ps(scores.data() + c * kBlock, acc);
+#else
+        for (size_t lane = 0; lane < kBlock; ++lane) {
+            float sum = biases_[c];
+            for (size_t f = 0; f < kFeatureCount; ++f) {
+                sum += weight(c, f) * block[f * stride + lane];
+            }
+            scores[c * kBlock + lane] = sum;
+        }
+#endif
+    }
+
+#ifdef __AVX2__
+    // 8 行同时求 argmax 与 softmax
+    __m256 best = _mm256_load_ps(scores.data());
+    __m256i best_index = _mm256_setzero_si256();
+    for (size_t c = 1; c < class_count_; ++c) {
+        const __m256 score = _mm256_load_ps(scores.data() + c * kBlock);
+        const __m256 greater = _mm256_cmp_ps(score, best, _CMP_GT_OQ);
+        best = _mm256_blendv_ps(best, score, greater);
+        best_index = _mm256_blendv_epi8(best_index, _mm256_set1_epi32(static_cast<int>(c)),
+                                        _mm256_castps_si256(greater));
+    }
+    __m256 denominator = _mm256_setzero_ps();
+    for (size_t c = 0; c < class_count_; ++c) {
+        denominator = _mm256_add_ps(denominator,
+            fast_exp_ps(_mm256_sub_ps(_mm256_load_ps(scores.data() + c * kBlock), best)));
+    }
+    const __m256 confidence = _mm256_div_ps(_mm256_set1_ps(1.0f), denominator);
+
+    alignas(32) float best_scores[kBlock];
+    alignas(32) float confidences[kBlock];
+    alignas(32) int32_t indices[kBlock];
+    _mm256_store_ps(best_scores, best);
+    _mm256_store_ps(confidences, confidence);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(indices), best_index);
+    for (size_t lane = 0; lane < lanes; ++lane) {
+        out[lane] = ModelPrediction{static_cast<uint16_t>(indices[lane]),
+                                    best_scores[lane], confidences[lane]};
+    }
+#else
+    std::array<float, kMaxClasses> row_scores;
+    for (size_t lane = 0; lane < lanes; ++lane) {
+        for (size_t c = 0; c < class_count_; ++c) {
+            row_scores[c] = scores[c * kBlock + lane];
+        }
+        out[lane] = finalize(row_scores.data());
+    }
+#endif
+}
+
+} // namespace protocol_parser::ai
@@ -1,4 +1,5 @@
 #include "ai/protocol_detector.hpp"
+#include "utils/byte_statistics.hpp"
 #include <algorithm>
 #include <cmath>
 #include <random>
@@ -43,6 +44,14 @@ std::vector<ClassificationResult> AIProtocolDetector::detect_protocol(
         results.push_back(pattern_result);
     }
     
+    // 编译模型分类
+    if (!model_.empty()) {
+        auto model_result = classify_by_model(buffer);
+        if (model_result.confidence >= confidence_threshold_) {
+            results.push_back(model_result);
+        }
+    }
+    
     // DGA检测（简化版）
     if (dga_detection_enabled_) {
         std::string payload(reinterpret_cast<const char*>(buffer.data()), 
@@ -90,16 +99,35 @@ void AIProtocolDetector::update_online_classifier(
     
     // 简单的在线学习：更新协议特征统计
     auto& stats = protocol_stats_[true_label];
-    if (stats.feature_means.empty()) {
-        stats.feature_means = features;
-        stats.sample_count = 1;
-    } else {
-        for (size_t i = 0; i < features.size() && i < stats.feature_means.size(); ++i) {
-            stats.feature_means[i] = (stats.feature_means[i] * stats.sample_count + features[i]) 
-                                   / (stats.sample_count + 1);
-        }
-        stats.sample_count++;
+    const size_t count = std::min(features.size(), kBasicFeatureCount);
+    for (size_t i = 0; i < count; ++i) {
+        stats.feature_means[i] = (stats.feature_means[i] * stats.sample_count + features[i]) 
+                               / (stats.sample_count + 1);
     }
+    stats.sample_count++;
+}
+
+bool AIProtocolDetector::load_model(const std::string& path) {
+    CompiledModel model;
+    if (!model.load_from_file(path)) {
+        return false;
+    }
+    model_ = std::move(model);
+    return true;
+}
+
+void AIProtocolDetector::set_model(CompiledModel model) {
+    model_ = std::move(model);
+}
+
+void AIProtocolDetector::classify(std::span<const CompiledModel::FeatureVector> features,
+                                  std::span<ModelPrediction> out) const noexcept {
+    model_.classify(features, out);
+}
+
+void AIProtocolDetector::classify(const detection::FeatureMatrix& features,
+                                  std::span<ModelPrediction> out) const noexcept {
+    model_.classify(features, out);
 }
 
 void AIProtocolDetector::initialize_basic_classifiers() {
@@ -139,40 +167,27 @@ void AIProtocolDetector::load_basic_signatures() {
     port_mappings_[995] = "POP3S";
 }
 
-std::vector<double> AIProtocolDetector::extract_basic_features(
+BasicFeatures AIProtocolDetector::extract_basic_features(
     const protocol_parser::core::BufferView& buffer,
     uint16_t src_port, uint16_t dst_port) const {
     
-    std::vector<double> features;
-    
-    // 基础特征
-    features.push_back(static_cast<double>(buffer.size()));     // 包大小
-    features.push_back(static_cast<double>(src_port));          // 源端口
-    features.push_back(static_cast<double>(dst_port));          // 目标端口
-    features.push_back(calculate_entropy(buffer));              // 熵
-    features.push_back(calculate_ascii_ratio(buffer));          // ASCII比例
-    
-    // 简单的字节统计特征
-    if (buffer.size() > 0) {
-        uint8_t first_byte = buffer[0];
-        features.push_back(static_cast<double>(first_byte));
-        
-        if (buffer.size() > 1) {
-            uint8_t second_byte = buffer[1];
-            features.push_back(static_cast<double>(second_byte));
-        } else {
-            features.push_back(0.0);
-        }
-    } else {
-        features.push_back(0.0);
-        features.push_back(0.0);
-    }
-    
-    return features;
+    // 熵与ASCII比例共享一次 SIMD 扫描
+    utils::ByteStatistics stats;
+    utils::ByteStatisticsKernel::compute(buffer.data(), buffer.size(), stats);
+    
+    return BasicFeatures{
+        static_cast<double>(buffer.size()),                          // 包大小
+        static_cast<double>(src_port),                               // 源端口
+        static_cast<double>(dst_port),                               // 目标端口
+        stats.entropy(),                                             // 熵
+        stats.printable_ratio(),                                     // ASCII比例
+        buffer.size() > 0 ? static_cast<double>(buffer[0]) : 0.0,    // 首字节
+        buffer.size() > 1 ? static_cast<double>(buffer[1]) : 0.0     // 第二字节
+    };
 }
 
 ClassificationResult AIProtocolDetector::classify_naive_bayes(
-    const std::vector<double>& features) const {
+    const BasicFeatures& features) const {
     
     ClassificationResult result;
     result.classification_method = "NAIVE_BAYES";
@@ -181,10 +196,10 @@ ClassificationResult AIProtocolDetector::classify_naive_bayes(
     std::string best_protocol;
     
     for (const auto& [protocol, stats] : protocol_stats_) {
-        if (stats.feature_means.empty() || stats.sample_count == 0) continue;
+        if (stats.sample_count == 0) continue;
         
         double score = 0.0;
-        for (size_t i = 0; i < features.size() && i < stats.feature_means.size(); ++i) {
+        for (size_t i = 0; i < features.size(); ++i) {
             // 简化的高斯朴素贝叶斯
             double diff = features[i] - stats.feature_means[i];
             score -= diff * diff; // 简化的概率计算
@@ -240,8 +255,8 @@ ClassificationResult AIProtocolDetector::classify_by_patterns(
     ClassificationResult result;
     result.classification_method = "PATTERN_MATCHING";
     
-    std::string payload(reinterpret_cast<const char*>(buffer.data()), 
-                       std::min(buffer.size(), size_t(256)));
+    std::string_view payload(reinterpret_cast<const char*>(buffer.data()), 
+                            std::min(buffer.size(), size_t(256)));
     
     for (const auto& [protocol, patterns] : protocol_patterns_) {
         for (const auto& pattern : patterns) {
@@ -258,40 +273,35 @@ ClassificationResult AIProtocolDetector::classify_by_patterns(
     return result;
 }
 
-double AIProtocolDetector::calculate_entropy(
+ClassificationResult AIProtocolDetector::classify_by_model(
     const protocol_parser::core::BufferView& buffer) const {
     
-    if (buffer.size() == 0) return 0.0;
+    ClassificationResult result;
+    result.classification_method = "COMPILED_MODEL";
     
-    std::array<size_t, 256> byte_counts = {};
-    for (size_t i = 0; i < buffer.size(); ++i) {
-        byte_counts[buffer[i]]++;
-    }
+    CompiledModel::FeatureVector features;
+    feature_extractor_.extract_feature_vector(std::span<const protocol_parser::core::BufferView>(&buffer, 1), features);
     
-    double entropy = 0.0;
-    for (size_t count : byte_counts) {
-        if (count > 0) {
-            double probability = static_cast<double>(count) / buffer.size();
-            entropy -= probability * std::log2(probability);
-        }
-    }
+    auto prediction = model_.classify(features);
+    result.protocol_name = model_.class_name(prediction.class_index);
+    result.confidence = prediction.confidence;
+    return result;
+}
+
+double AIProtocolDetector::calculate_entropy(
+    const protocol_parser::core::BufferView& buffer) const {
     
-    return entropy;
+    utils::ByteStatistics stats;
+    utils::ByteStatisticsKernel::compute(buffer.data(), buffer.size(), stats);
+    return stats.entropy();
 }
 
 double AIProtocolDetector::calculate_ascii_ratio(
     const protocol_parser::core::BufferView& buffer) const {
     
-    if (buffer.size() == 0) return 0.0;
-    
-    size_t ascii_count = 0;
-    for (size_t i = 0; i < buffer.size(); ++i) {
-        if (buffer[i] >= 32 && buffer[i] <= 126) {
-            ascii_count++;
-        }
-    }
-    
-    return static_cast<double>(ascii_count) / buffer.size();
+    utils::ByteStatistics stats;
+    utils::ByteStatisticsKernel::compute(buffer.data(), buffer.size(), stats);
+    return stats.printable_ratio();
 }
 
 double AIProtocolDetector::calculate_string_entropy(const std::string& str) const {
@@ -0,0 +1,358 @@
+#include "core/expected_flow_table.hpp"
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cstring>
+
+namespace protocol_parser::core {
+
+namespace {
+    inline uint64_t mix64(uint64_t value) noexcept {
+        value ^= value >> 33;
+        value *= 0xff51afd7ed558ccdULL;
+        value ^= value >> 33;
+        value *= 0xc4ceb9fe1a85ec53ULL;
+        value ^= value >> 33;
+        return value;
+    }
+
+    bool parse_ipv4(std::string_view text, uint8_t* out) noexcept {
+        for (int i = 0; i < 4; ++i) {
+            const size_t dot = i < 3 ? text.find('.') : text.size();
+            if (dot == std::string_view::npos || dot == 0 || dot > 3) {
+                return false;
+            }
+            unsigned value = 0;
+            const auto [ptr, ec] = std::from_chars(text.data(), text.data() + dot, value);
+            if (ec != std::errc{} || ptr != text.data() + dot || value > 255) {
+                return false;
+            }
+            out[i] = static_cast<uint8_t>(value);
+            text.remove_prefix(std::min(dot + 1, text.size()));
+        }
+        return text.empty();
+    }
+
+    // 以 ':' 分隔的 16 位组，末组可以是点分 IPv4（占两组）
+    bool parse_groups(std::string_view text, uint8_t* out, size_t& count, size_t limit) noexcept {
+        count = 0;
+        if (text.empty()) {
+            return true;
+        }
+        for (;;) {
+            const size_t colon = text.find(':');
+            const auto group = text.substr(0, colon);
+            if (colon == std::string_view::npos && group.find('.') != std::string_view::npos) {
+                if (count + 2 > limit || !parse_ipv4(group, out + 2 * count)) {
+                    return false;
+                }
+                count += 2;
+                return true;
+            }
+            unsigned value = 0;
+            const auto [ptr, ec] = std::from_chars(group.data(), group.data() + group.size(), value, 16);
+            if (group.empty() || group.size() > 4 || ec != std::errc{} || ptr != group.data() + group.size() ||
+                count == limit) {
+                return false;
+            }
+            out[2 * count] = static_cast<uint8_t>(value >> 8);
+            out[2 * count + 1] = static_cast<uint8_t>(value);
+            ++count;
+            if (colon == std::string_view::npos) {
+                return true;
+            }
+            text.remove_prefix(colon + 1);
+        }
+    }
+
+    bool parse_ipv6(std::string_view text, uint8_t* out) noexcept {
+        uint8_t head[16] = {};
+        uint8_t tail[16] = {};
+        size_t head_count = 0;
+        size_t tail_count = 0;
+
+        const size_t gap = text.find("::");
+        if (gap == std::string_view::npos) {
+            if (!parse_groups(text, head, head_count, 8) || head_count != 8) {
+                return false;
+            }
+            std::memcpy(out, head, 16);
+            return true;
+        }
+        if (text.find("::", gap + 1) != std::string_view::npos ||
+            !parse_groups(text.substr(0, gap), head, head_count, 7) ||
+            !parse_groups(text.substr(gap + 2), tail, tail_count, 7) ||
+            head_count + tail_count > 7) {
+            return false;
+        }
+        std::memset(out, 0, 16);
+        std::memcpy(out, head, 2 * head_count);
+        std::memcpy(out + 16 - 2 * tail_count, tail, 2 * tail_count);
+        return true;
+    }
+}
+
+ExpectedFlowTable::ExpectedFlowTable() : ExpectedFlowTable(Config{}) {}
+
+ExpectedFlowTable::ExpectedFlowTable(const Config& config) : config_(config) {
+    slots_.resize(std::bit_ceil(std::max<size_t>(config_.capacity, 16)));
+    mask_ = slots_.size() - 1;
+}
+
+FlowAddress FlowAddress::from_ipv4(uint32_t address) noexcept {
+    FlowAddress result;
+    if (address == 0) {
+        return result;
+    }
+    result.bytes[10] = 0xff;
+    result.bytes[11] = 0xff;
+    result.bytes[12] = static_cast<uint8_t>(address >> 24);
+    result.bytes[13] = static_cast<uint8_t>(address >> 16);
+    result.bytes[14] = static_cast<uint8_t>(address >> 8);
+    result.bytes[15] = static_cast<uint8_t>(address);
+    return result;
+}
+
+FlowAddress FlowAddress::from_ipv6(std::span<const uint8_t, 16> address) noexcept {
+    FlowAddress result;
+    std::copy(address.begin(), address.end(), result.bytes.begin());
+    return result;
+}
+
+bool FlowAddress::from_text(std::string_view text, FlowAddress& out) noexcept {
+    out = FlowAddress{};
+    if (text.find(':') != std::string_view::npos) {
+        return parse_ipv6(text, out.bytes.data());
+    }
+    uint8_t octets[4];
+    if (!parse_ipv4(text, octets)) {
+        return false;
+    }
+    out = from_ipv4((static_cast<uint32_t>(octets[0]) << 24) | (static_cast<uint32_t>(octets[1]) << 16) |
+                    (static_cast<uint32_t>(octets[2]) << 8) | octets[3]);
+    return true;
+}
+
+uint64_t ExpectedFlowTable::hash_endpoint(const FlowAddress& address, uint16_t port, bool is_tcp) noexcept {
+    uint64_t high;
+    uint64_t low;
+    std::memcpy(&high, address.bytes.data(), 8);
+    std::memcpy(&low, address.bytes.data() + 8, 8);
+    return mix64(high ^ mix64(low ^ ((static_cast<uint64_t>(port) << 1) | (is_tcp ? 1u : 0u))));
+}
+
+size_t ExpectedFlowTable::find(const FlowAddress& address, uint16_t port, bool is_tcp, uint64_t hash) const noexcept {
+    for (size_t index = hash & mask_;; index = (index + 1) & mask_) {
+        const Slot& slot = slots_[index];
+        if (!slot.occupied) {
+            return slots_.size();
+        }
+        if (slot.hash == hash && slot.port == port && slot.is_tcp == is_tcp && slot.address == address) {
+            return index;
+        }
+    }
+}
+
+size_t ExpectedFlowTable::find_valid(const FlowAddress& address, uint16_t port, bool is_tcp,
+                                     const FlowAddress& peer, uint16_t peer_port, uint64_t now_us) const noexcept {
+    const size_t index = find(address, port, is_tcp, hash_endpoint(address, port, is_tcp));
+    if (index == slots_.size()) {
+        return index;
+    }
+    const Slot& slot = slots_[index];
+    const bool valid = slot.expires_us > now_us &&
+                       (slot.peer.is_unspecified() || slot.peer == peer) &&
+                       (slot.peer_port == 0 || slot.peer_port == peer_port);
+    return valid ? index : slots_.size();
+}
+
+void ExpectedFlowTable::erase(size_t index) noexcept {
+    // 后移删除，不留墓碑
+    size_t hole = index;
+    for (size_t next = (hole + 1) & mask_; slots_[next].occupied; next = (next + 1) & mask_) {
+        const size_t home = slots_[next].hash & mask_;
+        // home 循环落在 (hole, next] 内的条目保持不动
+        const bool stays = (hole <= next) ? (home > hole && home <= next) : (home > hole || home <= next);
+        if (!stays) {
+            slots_[hole] = slots_[next];
+            hole = next;
+        }
+    }
+    slots_[hole] = Slot{};
+    --size_;
+}
+
+void ExpectedFlowTable::advance(uint64_t now_us) noexcept {
+    std::lock_guard lock(mutex_);
+    advance_locked(now_us);
+}
+
+uint64_t ExpectedFlowTable::now() const noexcept {
+    std::lock_guard lock(mutex_);
+    return now_us_;
+}
+
+size_t ExpectedFlowTable::size() const noexcept {
+    std::lock_guard lock(mutex_);
+    return size_;
+}
+
+ExpectedFlowTable::Statistics ExpectedFlowTable::statistics() const noexcept {
+    std::lock_guard lock(mutex_);
+    return stats_;
+}
+
+bool ExpectedFlowTable::expect(const ExpectedFlow& flow, uint64_t now_us) noexcept {
+    std::lock_guard lock(mutex_);
+    advance_locked(now_us);
+    sweep(now_us, config_.sweep_step);
+    if (flow.address.is_unspecified() || flow.port == 0) {
+        return false;
+    }
+
+    const uint64_t hash = hash_endpoint(flow.address, flow.port, flow.is_tcp);
+    size_t index = find(flow.address, flow.port, flow.is_tcp, hash);
+    if (index != slots_.size()) {
+        ++stats_.replaced;
+    } else {
+        if ((size_ + 1) * 4 > slots_.size() * 3) {
+            ++stats_.dropped;
+            return false;
+        }
+        index = hash & mask_;
+        while (slots_[index].occupied) {
+            index = (index + 1) & mask_;
+        }
+        ++size_;
+    }
+
+    Slot& slot = slots_[index];
+    slot.hash = hash;
+    slot.address = flow.address;
+    slot.port = flow.port;
+    slot.is_tcp = flow.is_tcp;
+    slot.session = flow.session;
+    slot.expires_us = now_us + (flow.timeout_us != 0 ? flow.timeout_us : config_.expect_timeout_us);
+    slot.protocol = flow.protocol;
+    slot.peer = flow.peer;
+    slot.peer_port = flow.peer_port;
+    slot.bound = false;
+    slot.occupied = true;
+    ++stats_.expectations;
+    return true;
+}
+
+bool ExpectedFlowTable::lookup(const FlowAddress& src, const FlowAddress& dst, uint16_t src_port, uint16_t dst_port,
+                               bool is_tcp, uint64_t now_us, ExpectedFlowMatch& out) const noexcept {
+    std::lock_guard lock(mutex_);
+    size_t index = 0;
+    return lookup_locked(src, dst, src_port, dst_port, is_tcp, now_us, out, index);
+}
+
+bool ExpectedFlowTable::lookup_locked(const FlowAddress& src, const FlowAddress& dst, uint16_t src_port,
+                                      uint16_t dst_port, bool is_tcp, uint64_t now_us, ExpectedFlowMatch& out,
+                                      size_t& index) const noexcept {
+    if (size_ == 0) {
+        return false;
+    }
+    bool to_endpoint = true;
+    index = find_valid(dst, dst_port, is_tcp, src, src_port, now_us);
+    if (index == slots_.size()) {
+        to_endpoint = false;
+        index = find_valid(src, src_port, is_tcp, dst, dst_port, now_us);
+        if (index == slots_.size()) {
+            return false;
+        }
+    }
+    const Slot& slot = slots_[index];
+    out.protocol = slot.protocol;
+    out.session = slot.session;
+    out.to_endpoint = to_endpoint;
+    out.first = !slot.bound;
+    return true;
+}
+
+bool ExpectedFlowTable::match(const FlowAddress& src, const FlowAddress& dst, uint16_t src_port, uint16_t dst_port,
+                              bool is_tcp, uint64_t now_us, ExpectedFlowMatch& out) noexcept {
+    std::lock_guard lock(mutex_);
+    advance_locked(now_us);
+    size_t index = 0;
+    if (!lookup_locked(src, dst, src_port, dst_port, is_tcp, now_us, out, index)) {
+        return false;
+    }
+
+    // 绑定到这条连接的另一端，此后其它连接不再命中
+    Slot& slot = slots_[index];
+    if (!slot.bound) {
+        slot.bound = true;
+        slot.peer = out.to_endpoint ? src : dst;
+        slot.peer_port = out.to_endpoint ? src_port : dst_port;
+        ++stats_.bound;
+    }
+    slot.expires_us = now_us + config_.idle_timeout_us;
+    ++stats_.hits;
+    return true;
+}
+
+size_t ExpectedFlowTable::erase_session(uint64_t session) noexcept {
+    std::lock_guard lock(mutex_);
+    size_t erased = 0;
+    for (size_t index = 0; index < slots_.size();) {
+        // 删除后当前槽可能被后面的条目填上，需要再检查一次
+        if (slots_[index].occupied && slots_[index].session == session) {
+            erase(index);
+            ++erased;
+        } else {
+            ++index;
+        }
+    }
+    return erased;
+}
+
+bool ExpectedFlowTable::erase_endpoint(const FlowAddress& address, uint16_t port, bool is_tcp,
+                                       uint64_t session) noexcept {
+    std::lock_guard lock(mutex_);
+    const size_t index = find(address, port, is_tcp, hash_endpoint(address, port, is_tcp));
+    if (index == slots_.size() || slots_[index].session != session) {
+        return false;
+    }
+    erase(index);
+    return true;
+}
+
+void ExpectedFlowTable::sweep(uint64_t now_us, size_t budget) noexcept {
+    budget = std::min(budget, slots_.size());
+    for (size_t step = 0; step < budget && size_ != 0; ++step) {
+        if (sweep_cursor_ >= slots_.size()) {
+            sweep_cursor_ = 0;
+        }
+        const size_t index = sweep_cursor_++;
+        if (slots_[index].occupied && slots_[index].expires_us <= now_us) {
+            erase(index);
+            ++stats_.expired;
+            --sweep_cursor_;     // 后移的条目落到当前槽
+        }
+    }
+}
+
+void ExpectedFlowTable::expire(uint64_t now_us) noexcept {
+    std::lock_guard lock(mutex_);
+    advance_locked(now_us);
+    for (size_t index = 0; index < slots_.size();) {
+        if (slots_[index].occupied && slots_[index].expires_us <= now_us) {
+            erase(index);
+            ++stats_.expired;
+        } else {
+            ++index;
+        }
+    }
+}
+
+void ExpectedFlowTable::clear() noexcept {
+    std::lock_guard lock(mutex_);
+    std::fill(slots_.begin(), slots_.end(), Slot{});
+    size_ = 0;
+    sweep_cursor_ = 0;
+}
+
+} // namespace protocol_parser::core
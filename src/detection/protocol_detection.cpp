@@ -1,15 +1,64 @@
 #include "detection/protocol_detection.hpp"
+#include "ai/compiled_model.hpp"
+#include "parsers/application/passive_dns_cache.hpp"
+#include "utils/byte_statistics.hpp"
 #include <algorithm>
 #include <cmath>
 #include <cstring>
 #include <chrono>
 #include <sstream>
 #include <iomanip>
+#include <condition_variable>
 #include <mutex>
 #include <shared_mutex>
+#include <thread>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
 
 namespace protocol_parser::detection {
 
+namespace {
+    // 读取周期计数器；非 x86 平台以纳秒近似
+    inline uint64_t read_cycle_counter() noexcept {
+        #if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+            return __rdtsc();
+        #else
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+        #endif
+    }
+
+    // 每线程的阶段开销估计（周期，指数滑动平均），用于执行前判断预算是否足够；
+    // 因估计超预算而跳过的阶段得不到新样本，每次跳过按 1/8 衰减估计，
+    // 使一次偶发的慢样本不会让该阶段在本线程上永久停用
+    struct StageCostEstimator {
+        std::array<uint64_t, kDetectionStageCount> cycles{};
+
+        uint64_t estimate(DetectionStage stage) const noexcept {
+            return cycles[static_cast<size_t>(stage)];
+        }
+
+        void record(DetectionStage stage, uint64_t sample) noexcept {
+            auto& estimate = cycles[static_cast<size_t>(stage)];
+            estimate = estimate == 0 ? sample : (estimate * 7 + sample) / 8;
+        }
+
+        void decay(DetectionStage stage) noexcept {
+            auto& estimate = cycles[static_cast<size_t>(stage)];
+            estimate -= estimate / 8;
+        }
+    };
+
+    StageCostEstimator& local_cost_estimator() noexcept {
+        thread_local StageCostEstimator estimator;
+        return estimator;
+    }
+}
+
 // ProtocolSignature::SignaturePattern 实现
 bool ProtocolSignature::SignaturePattern::matches(const uint8_t* data, size_t size) const noexcept {
     if (offset + pattern.size() > size) {
@@ -82,6 +131,28 @@ double ProtocolSignature::calculate_match_score(const protocol_parser::core::Buf
     return match_ratio * base_confidence;
 }
 
+double ProtocolSignature::calculate_anchored_score(const protocol_parser::core::BufferView& buffer) const noexcept {
+    const auto data = buffer.data();
+    const auto size = buffer.size();
+    
+    double total_score = 0.0;
+    double total_weight = 0.0;
+    
+    for (const auto& pattern : patterns) {
+        total_weight += pattern.weight;
+        
+        if (!pattern.pattern.empty() && pattern.matches(data, size)) {
+            total_score += pattern.weight;
+        }
+    }
+    
+    if (total_weight == 0.0) {
+        return 0.0;
+    }
+    
+    return total_score / total_weight * base_confidence;
+}
+
 // PortBasedDetector 实现
 PortBasedDetector::PortBasedDetector() {
     initialize_standard_ports();
@@ -173,38 +244,28 @@ HeuristicDetector::PacketFeatures HeuristicDetector::extract_features(const prot
         return features;
     }
     
-    // 计算字节频率和统计信息
-    for (size_t i = 0; i < size; ++i) {
-        uint8_t byte = data[i];
-        features.byte_frequency[byte]++;
-        
-        if (byte == 0) {
-            features.null_bytes++;
-        } else if (Utils::is_printable_ascii(byte)) {
-            features.printable_chars++;
-        }
-    }
-    
-    // 计算熵
-    features.entropy = calculate_entropy(data, size);
+    // 单遍 SIMD 统计：直方图、字符分类、最长零字节游程
+    utils::ByteStatistics stats;
+    utils::ByteStatisticsKernel::compute(data, size, stats);
     
-    // 检测连续零字节
-    size_t current_zeros = 0;
-    for (size_t i = 0; i < size; ++i) {
-        if (data[i] == 0) {
-            current_zeros++;
-        } else {
-            features.consecutive_zeros = std::max(features.consecutive_zeros, current_zeros);
-            current_zeros = 0;
-        }
-    }
-    features.consecutive_zeros = std::max(features.consecutive_zeros, current_zeros);
+    features.byte_frequency = stats.histogram;
+    features.printable_chars = stats.printable_count;
+    features.null_bytes = stats.null_count;
+    features.control_chars = stats.control_count;
+    features.consecutive_zeros = stats.longest_zero_run;
+    features.entropy = stats.entropy();
     
     // 检测常见头部模式
     features.has_common_headers = Utils::is_likely_header_field(data, std::min(size, size_t(64)));
     
-    // 提取字符串
-    features.detected_strings = extract_strings(buffer);
+    // 提取字符串（按需）
+    if (extract_strings_enabled_) {
+        try {
+            features.detected_strings = extract_strings(buffer);
+        } catch (const std::exception&) {
+            features.detected_strings.clear();
+        }
+    }
     
     return features;
 }
@@ -251,22 +312,9 @@ std::vector<DetectionResult> HeuristicDetector::detect_by_heuristics(const Packe
 }
 
 double HeuristicDetector::calculate_entropy(const uint8_t* data, size_t size) const noexcept {
-    if (size == 0) return 0.0;
-    
-    std::array<size_t, 256> frequency{};
-    for (size_t i = 0; i < size; ++i) {
-        frequency[data[i]]++;
-    }
-    
-    double entropy = 0.0;
-    for (size_t count : frequency) {
-        if (count > 0) {
-            double p = static_cast<double>(count) / size;
-            entropy -= p * std::log2(p);
-        }
-    }
-    
-    return entropy;
+    utils::ByteStatistics stats;
+    utils::ByteStatisticsKernel::compute(data, size, stats);
+    return stats.entropy();
 }
 
 bool HeuristicDetector::is_likely_text_protocol(const PacketFeatures& features) const noexcept {
@@ -310,103 +358,438 @@ ProtocolDetectionEngine::ProtocolDetectionEngine()
     : port_detector_(std::make_unique<PortBasedDetector>()),
       heuristic_detector_(std::make_unique<HeuristicDetector>()),
       deep_inspector_(std::make_unique<DeepPacketInspector>()),
-      ml_extractor_(std::make_unique<MLFeatureExtractor>()) {
+      ml_extractor_(std::make_unique<MLFeatureExtractor>()),
+      signatures_(std::make_shared<const SignatureTable>()),
+      statistics_shards_(std::make_unique<StatisticsShard[]>(kStatisticsShardCount)) {
     
     initialize_builtin_signatures();
 }
 
 DetectionResult ProtocolDetectionEngine::detect_protocol(const protocol_parser::core::BufferView& buffer) const noexcept {
+    return detect_protocol_staged(buffer, 0, 0);
+}
+
+DetectionResult ProtocolDetectionEngine::detect_protocol_with_ports(const protocol_parser::core::BufferView& buffer, 
+                                                                   uint16_t src_port, uint16_t dst_port) const noexcept {
+    return detect_protocol_staged(buffer, src_port, dst_port);
+}
+
+DetectionResult ProtocolDetectionEngine::detect_protocol_staged(const protocol_parser::core::BufferView& buffer,
+                                                                uint16_t src_port, uint16_t dst_port,
+                                                                DetectionBudget* flow_budget) const noexcept {
+    return detect_staged(buffer, src_port, dst_port, flow_budget, load_snapshot());
+}
+
+ProtocolDetectionEngine::DetectionSnapshot ProtocolDetectionEngine::load_snapshot() const noexcept {
+    return {signatures_.load(std::memory_order_acquire), ml_model_.load(std::memory_order_acquire)};
+}
+
+DetectionResult ProtocolDetectionEngine::detect_staged(const protocol_parser::core::BufferView& buffer,
+                                                       uint16_t src_port, uint16_t dst_port,
+                                                       DetectionBudget* flow_budget,
+                                                       const DetectionSnapshot& snapshot) const noexcept {
     auto start_time = std::chrono::high_resolution_clock::now();
+    const uint64_t start_cycles = read_cycle_counter();
+    
+    // 单包预算与流剩余预算取较小者
+    uint64_t cycle_limit = config_.packet_cycle_budget > 0 ? config_.packet_cycle_budget : UINT64_MAX;
+    if (flow_budget != nullptr) {
+        cycle_limit = std::min(cycle_limit, flow_budget->remaining_cycles);
+    }
+    const bool has_timeout = config_.detection_timeout.count() > 0;
+    const auto deadline = std::chrono::steady_clock::now() + config_.detection_timeout;
+    
+    const ai::CompiledModel* model = snapshot.model.get();
+    auto& estimator = local_cost_estimator();
     
+    PipelineTrace trace;
     std::vector<DetectionResult> all_results;
+    DetectionResult final_result;
+    bool timed_out = false;
     
     try {
-        // 签名匹配检测
-        if (config_.use_signature_based) {
-            std::shared_lock lock(signatures_mutex_);
-            for (const auto& [name, signature] : signatures_) {
-                double score = signature.calculate_match_score(buffer);
-                if (score > config_.min_confidence_threshold) {
-                    DetectionResult result;
-                    result.protocol_name = name;
-                    result.confidence_score = score;
-                    result.confidence = score_to_confidence_level(score);
-                    result.detection_method = "Signature-based";
-                    result.evidence.push_back("Signature pattern match");
-                    result.bytes_analyzed = buffer.size();
-                    all_results.push_back(result);
-                }
+        for (size_t index = 0; index < kDetectionStageCount; ++index) {
+            const auto stage = static_cast<DetectionStage>(index);
+            auto& stage_trace = trace.stages[index];
+            
+            if (!stage_enabled(stage, src_port, dst_port, model)) {
+                continue;
+            }
+            
+            // 超时后其余阶段全部跳过；预计开销超出预算的阶段跳过，后续更便宜的阶段仍可执行
+            if (!timed_out && has_timeout && std::chrono::steady_clock::now() >= deadline) {
+                timed_out = true;
+            }
+            const uint64_t used = read_cycle_counter() - start_cycles;
+            if (timed_out || cycle_limit == 0 || used >= cycle_limit) {
+                stage_trace.skipped++;
+                trace.budget_exhausted = true;
+                continue;
+            }
+            if (estimator.estimate(stage) > cycle_limit - used) {
+                estimator.decay(stage);
+                stage_trace.skipped++;
+                trace.budget_exhausted = true;
+                continue;
+            }
+            
+            const size_t previous_count = all_results.size();
+            const uint64_t stage_start = read_cycle_counter();
+            run_stage(stage, buffer, src_port, dst_port, snapshot, all_results);
+            const uint64_t stage_cycles = read_cycle_counter() - stage_start;
+            
+            estimator.record(stage, stage_cycles);
+            stage_trace.invocations++;
+            stage_trace.cycles += stage_cycles;
+            
+            if (all_results.size() == previous_count) {
+                continue;
+            }
+            
+            stage_trace.hits++;
+            final_result = combine_results(all_results);
+            if (final_result.confidence_score >= config_.early_exit_confidence) {
+                trace.early_exit = true;
+                break;
             }
-        }
-        
-        // 启发式检测
-        if (config_.use_heuristic_based) {
-            auto features = heuristic_detector_->extract_features(buffer);
-            auto heuristic_results = heuristic_detector_->detect_by_heuristics(features);
-            all_results.insert(all_results.end(), heuristic_results.begin(), heuristic_results.end());
-        }
-        
-        // 深度检测
-        if (config_.use_deep_inspection) {
-            auto deep_results = deep_inspector_->inspect_deep(buffer);
-            all_results.insert(all_results.end(), deep_results.begin(), deep_results.end());
         }
         
     } catch (const std::exception&) {
-        // 静默处理异常
+        // 静默处理异常，返回已完成阶段的结果
+        final_result = combine_results(all_results);
+    }
+    
+    if (flow_budget != nullptr) {
+        const uint64_t used = read_cycle_counter() - start_cycles;
+        flow_budget->remaining_cycles -= std::min(used, flow_budget->remaining_cycles);
     }
     
     auto end_time = std::chrono::high_resolution_clock::now();
     auto detection_time = std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time);
     
-    DetectionResult final_result = combine_results(all_results);
     final_result.bytes_analyzed = buffer.size();
     
-    update_statistics(final_result, detection_time);
+    update_statistics(final_result, detection_time, trace);
     
     return final_result;
 }
 
-DetectionResult ProtocolDetectionEngine::detect_protocol_with_ports(const protocol_parser::core::BufferView& buffer, 
-                                                                   uint16_t src_port, uint16_t dst_port) const noexcept {
-    auto start_time = std::chrono::high_resolution_clock::now();
+DetectionResult ProtocolDetectionEngine::detect_flow_protocol(const std::string& flow_id,
+                                                              const std::vector<protocol_parser::core::BufferView>& packets,
+                                                              uint16_t src_port, uint16_t dst_port) const {
+    DetectionBudget budget;
+    if (config_.flow_cycle_budget > 0) {
+        budget.remaining_cycles = config_.flow_cycle_budget;
+    }
     
-    std::vector<DetectionResult> all_results;
+    std::vector<DetectionResult> results;
+    bool first_packet = true;
+    const auto snapshot = load_snapshot();
+    
+    for (const auto& packet : packets) {
+        if (budget.exhausted()) {
+            break;
+        }
+        
+        if (config_.enable_flow_analysis) {
+            deep_inspector_->update_flow_state(flow_id, packet);
+        }
+        
+        // 端口证据只计入一次，避免重复加成
+        auto result = first_packet
+            ? detect_staged(packet, src_port, dst_port, &budget, snapshot)
+            : detect_staged(packet, 0, 0, &budget, snapshot);
+        first_packet = false;
+        
+        if (result.protocol_name.empty()) {
+            continue;
+        }
+        results.push_back(std::move(result));
+        
+        if (combine_results(results).confidence_score >= config_.early_exit_confidence) {
+            break;
+        }
+    }
+    
+    if (config_.enable_flow_analysis) {
+        auto flow_results = deep_inspector_->analyze_flow(flow_id);
+        results.insert(results.end(), flow_results.begin(), flow_results.end());
+    }
+    
+    return combine_results(results);
+}
+
+DetectionResult ProtocolDetectionEngine::detect_flow_protocol(const std::string& flow_id,
+                                                              const std::vector<protocol_parser::core::BufferView>& packets,
+                                                              uint16_t src_port, uint16_t dst_port,
+                                                              uint32_t server_ip, uint64_t now_us) const {
+    auto result = detect_flow_protocol(flow_id, packets, src_port, dst_port);
+    tag_server_name(result, server_ip, now_us);
+    return result;
+}
+
+DetectionResult ProtocolDetectionEngine::detect_flow_protocol(const std::string& flow_id,
+                                                              const std::vector<protocol_parser::core::BufferView>& packets,
+                                                              const FlowTuple& tuple, uint64_t now_us) const {
+    DetectionResult result;
+    if (detect_expected_flow(tuple, now_us, result)) {
+        return result;
+    }
+    return detect_flow_protocol(flow_id, packets, tuple.src_port, tuple.dst_port,
+                                parsers::PassiveDNSAddress::from_ipv6(tuple.dst.bytes), now_us);
+}
+
+bool ProtocolDetectionEngine::detect_expected_flow(const FlowTuple& tuple, uint64_t now_us,
+                                                   DetectionResult& result) const noexcept {
+    const auto table = expected_flows_.load(std::memory_order_acquire);
+    if (!table) {
+        return false;
+    }
+    
+    const auto start_time = std::chrono::high_resolution_clock::now();
+    protocol_parser::core::ExpectedFlowMatch match;
+    if (!table->match(tuple.src, tuple.dst, tuple.src_port, tuple.dst_port, tuple.is_tcp, now_us, match)) {
+        return false;
+    }
     
     try {
-        // 端口检测
-        if (config_.use_port_based) {
-            auto port_results = port_detector_->detect_by_port(src_port, dst_port);
-            all_results.insert(all_results.end(), port_results.begin(), port_results.end());
+        result = DetectionResult{};
+        result.protocol_name.assign(match.protocol);
+        result.confidence = ConfidenceLevel::VERY_HIGH;
+        result.confidence_score = 1.0;
+        result.detected_port = match.to_endpoint ? tuple.dst_port : tuple.src_port;
+        result.detection_method = "Expected-flow";
+        result.related_session = match.session;
+        result.evidence.push_back("Expected by control session " + std::to_string(match.session));
+    } catch (...) {
+        return false;
+    }
+    
+    const auto detection_time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::high_resolution_clock::now() - start_time);
+    update_statistics(result, detection_time, PipelineTrace{});
+    return true;
+}
+
+DetectionResult ProtocolDetectionEngine::detect_flow_protocol(const std::string& flow_id,
+                                                              const std::vector<protocol_parser::core::BufferView>& packets,
+                                                              uint16_t src_port, uint16_t dst_port,
+                                                              const parsers::PassiveDNSAddress& server, uint64_t now_us) const {
+    auto result = detect_flow_protocol(flow_id, packets, src_port, dst_port);
+    tag_server_name(result, server, now_us);
+    return result;
+}
+
+bool ProtocolDetectionEngine::tag_server_name(DetectionResult& result, uint32_t server_ip, uint64_t now_us) const noexcept {
+    return tag_server_name(result, parsers::PassiveDNSAddress::from_ipv4(server_ip), now_us);
+}
+
+bool ProtocolDetectionEngine::tag_server_name(DetectionResult& result, const parsers::PassiveDNSAddress& server,
+                                              uint64_t now_us) const noexcept {
+    const auto cache = passive_dns_.load(std::memory_order_acquire);
+    if (!cache) {
+        return false;
+    }
+    
+    parsers::PassiveDNSName name;
+    if (!cache->lookup(server, now_us, name)) {
+        return false;
+    }
+    
+    try {
+        result.server_name.assign(name.view());
+        result.evidence.push_back("Passive DNS: " + result.server_name);
+    } catch (...) {
+        return false;
+    }
+    return true;
+}
+
+// detect_multiple 的常驻工作线程池：一次只承载一个批次，调用线程同时参与处理；
+// 另一批次正在运行时，后来的调用方直接在本线程内完成自己的批次，不排队等待
+class ProtocolDetectionEngine::BatchWorkerPool {
+public:
+    explicit BatchWorkerPool(size_t thread_count) noexcept {
+        try {
+            threads_.reserve(thread_count);
+            for (size_t i = 0; i < thread_count; ++i) {
+                threads_.emplace_back([this](std::stop_token stop) { worker_loop(stop); });
+            }
+        } catch (const std::exception&) {
+            // 线程创建失败时保留已启动的线程
+        }
+    }
+    
+    BatchWorkerPool(const BatchWorkerPool&) = delete;
+    BatchWorkerPool& operator=(const BatchWorkerPool&) = delete;
+    
+    // 在至多 helpers 个池线程和调用线程上同时执行 task，全部返回后才返回；
+    // task 需自行划分工作（各线程可能在任意时刻加入或已无事可做）
+    template <typename Task>
+    void run(Task& task, size_t helpers) noexcept {
+        std::unique_lock batch(batch_mutex_, std::try_to_lock);
+        if (!batch.owns_lock() || threads_.empty() || helpers == 0) {
+            task();
+            return;
         }
         
-        // 其他检测方法...
-        auto content_result = detect_protocol(buffer);
-        if (!content_result.protocol_name.empty()) {
-            all_results.push_back(content_result);
+        {
+            std::lock_guard lock(mutex_);
+            task_context_ = &task;
+            task_invoke_ = [](void* context) noexcept { (*static_cast<Task*>(context))(); };
+            pending_ = std::min(helpers, threads_.size());
         }
+        wake_.notify_all();
+        
+        task();
         
+        // 调用线程完成时尚未被唤醒的池线程已无事可做，撤销其名额后等待进行中的线程返回
+        std::unique_lock lock(mutex_);
+        pending_ = 0;
+        done_.wait(lock, [this] { return active_ == 0; });
+        task_context_ = nullptr;
+        task_invoke_ = nullptr;
+    }
+    
+private:
+    void worker_loop(std::stop_token stop) noexcept {
+        std::unique_lock lock(mutex_);
+        for (;;) {
+            if (!wake_.wait(lock, stop, [this] { return pending_ != 0; })) {
+                return;
+            }
+            --pending_;
+            ++active_;
+            void* context = task_context_;
+            auto invoke = task_invoke_;
+            
+            lock.unlock();
+            invoke(context);
+            lock.lock();
+            
+            if (--active_ == 0) {
+                done_.notify_one();
+            }
+        }
+    }
+    
+    std::mutex batch_mutex_;                     // 保证同一时刻只有一个批次使用线程池
+    std::mutex mutex_;
+    std::condition_variable_any wake_;
+    std::condition_variable done_;
+    void* task_context_{nullptr};
+    void (*task_invoke_)(void*) noexcept {nullptr};
+    size_t pending_{0};                          // 待领取的执行名额
+    size_t active_{0};                           // 正在执行 task 的池线程数
+    std::vector<std::jthread> threads_;          // 最后声明，析构时先停止并等待线程退出
+};
+
+std::vector<DetectionResult> ProtocolDetectionEngine::detect_multiple(std::span<const protocol_parser::core::BufferView> buffers) const noexcept {
+    std::vector<DetectionResult> results;
+    
+    try {
+        results.resize(buffers.size());
     } catch (const std::exception&) {
-        // 静默处理异常
+        return {};
     }
     
-    auto end_time = std::chrono::high_resolution_clock::now();
-    auto detection_time = std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time);
+    const size_t chunk_size = std::max<size_t>(1, config_.batch_chunk_size);
+    const size_t chunk_count = (buffers.size() + chunk_size - 1) / chunk_size;
     
-    DetectionResult final_result = combine_results(all_results);
-    final_result.bytes_analyzed = buffer.size();
+    size_t worker_count = config_.batch_worker_threads;
+    if (worker_count == 0) {
+        worker_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+    worker_count = std::min(worker_count, chunk_count);
+    
+    // 工作线程动态领取分块，负载不均时自动平衡；签名表与模型整批只加载一次
+    const auto snapshot = load_snapshot();
+    std::atomic<size_t> next_index{0};
+    auto worker = [&]() noexcept {
+        for (;;) {
+            size_t begin = next_index.fetch_add(chunk_size, std::memory_order_relaxed);
+            if (begin >= buffers.size()) {
+                break;
+            }
+            size_t end = std::min(begin + chunk_size, buffers.size());
+            for (size_t i = begin; i < end; ++i) {
+                results[i] = detect_staged(buffers[i], 0, 0, nullptr, snapshot);
+            }
+        }
+    };
+    
+    if (worker_count <= 1) {
+        worker();
+        return results;
+    }
     
-    update_statistics(final_result, detection_time);
+    // 持有线程池引用，configure() 期间重建线程池不影响本批次
+    auto pool = acquire_batch_pool();
+    if (!pool) {
+        worker();
+        return results;
+    }
+    pool->run(worker, worker_count - 1);
     
-    return final_result;
+    return results;
+}
+
+std::shared_ptr<ProtocolDetectionEngine::BatchWorkerPool> ProtocolDetectionEngine::acquire_batch_pool() const noexcept {
+    size_t thread_count = config_.batch_worker_threads;
+    if (thread_count == 0) {
+        thread_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+    
+    std::lock_guard lock(batch_pool_mutex_);
+    if (!batch_pool_ || batch_pool_threads_ != thread_count) {
+        try {
+            // 调用线程本身参与处理，池中只需 thread_count - 1 个线程
+            batch_pool_ = std::make_shared<BatchWorkerPool>(thread_count - 1);
+            batch_pool_threads_ = thread_count;
+        } catch (const std::exception&) {
+            return nullptr;
+        }
+    }
+    return batch_pool_;
 }
 
 void ProtocolDetectionEngine::add_signature(const ProtocolSignature& signature) {
-    std::unique_lock lock(signatures_mutex_);
-    signatures_[signature.protocol_name] = signature;
+    std::lock_guard lock(signatures_write_mutex_);
+    auto updated = std::make_shared<SignatureTable>(*signatures_.load(std::memory_order_acquire));
+    (*updated)[signature.protocol_name] = signature;
+    signatures_.store(std::move(updated), std::memory_order_release);
+}
+
+void ProtocolDetectionEngine::remove_signature(const std::string& protocol_name) {
+    std::lock_guard lock(signatures_write_mutex_);
+    auto current = signatures_.load(std::memory_order_acquire);
+    if (current->find(protocol_name) == current->end()) {
+        return;
+    }
+    auto updated = std::make_shared<SignatureTable>(*current);
+    updated->erase(protocol_name);
+    signatures_.store(std::move(updated), std::memory_order_release);
+}
+
+void ProtocolDetectionEngine::set_ml_model(std::shared_ptr<const ai::CompiledModel> model) {
+    ml_model_.store(std::move(model), std::memory_order_release);
+}
+
+void ProtocolDetectionEngine::set_passive_dns(std::shared_ptr<const parsers::PassiveDNSCache> cache) {
+    passive_dns_.store(std::move(cache), std::memory_order_release);
+}
+
+void ProtocolDetectionEngine::set_expected_flows(std::shared_ptr<protocol_parser::core::ExpectedFlowTable> table) {
+    expected_flows_.store(std::move(table), std::memory_order_release);
 }
 
 void ProtocolDetectionEngine::configure(const DetectionConfig& config) {
+    if (config.batch_worker_threads != config_.batch_worker_threads) {
+        // 释放旧线程池；正在运行的批次持有引用，结束后线程随之退出
+        std::lock_guard lock(batch_pool_mutex_);
+        batch_pool_.reset();
+        batch_pool_threads_ = 0;
+    }
     config_ = config;
 }
 
@@ -415,20 +798,63 @@ ProtocolDetectionEngine::DetectionConfig ProtocolDetectionEngine::get_configurat
 }
 
 ProtocolDetectionEngine::DetectionStatistics ProtocolDetectionEngine::get_statistics() const noexcept {
-    std::lock_guard lock(stats_mutex_);
-    return statistics_;
+    DetectionStatistics merged;
+    
+    for (size_t i = 0; i < kStatisticsShardCount; ++i) {
+        auto& shard = statistics_shards_[i];
+        std::lock_guard lock(shard.mutex);
+        const auto& stats = shard.statistics;
+        
+        merged.total_detections += stats.total_detections;
+        merged.successful_detections += stats.successful_detections;
+        merged.port_based_detections += stats.port_based_detections;
+        merged.signature_based_detections += stats.signature_based_detections;
+        merged.heuristic_detections += stats.heuristic_detections;
+        merged.deep_inspection_detections += stats.deep_inspection_detections;
+        merged.ml_detections += stats.ml_detections;
+        merged.expected_flow_detections += stats.expected_flow_detections;
+        merged.early_exits += stats.early_exits;
+        merged.budget_exhausted += stats.budget_exhausted;
+        merged.total_detection_time += stats.total_detection_time;
+        
+        for (size_t stage = 0; stage < kDetectionStageCount; ++stage) {
+            const auto& from = stats.stage_statistics[stage];
+            auto& to = merged.stage_statistics[stage];
+            to.invocations += from.invocations;
+            to.hits += from.hits;
+            to.skipped += from.skipped;
+            to.cycles += from.cycles;
+        }
+        
+        try {
+            for (const auto& [protocol, count] : stats.protocol_detection_count) {
+                merged.protocol_detection_count[protocol] += count;
+            }
+        } catch (const std::exception&) {
+            // 内存不足时忽略协议明细
+        }
+    }
+    
+    if (merged.total_detections > 0) {
+        merged.avg_detection_time = merged.total_detection_time / merged.total_detections;
+    }
+    
+    return merged;
 }
 
 void ProtocolDetectionEngine::reset_statistics() noexcept {
-    std::lock_guard lock(stats_mutex_);
-    statistics_ = DetectionStatistics{};
+    for (size_t i = 0; i < kStatisticsShardCount; ++i) {
+        auto& shard = statistics_shards_[i];
+        std::lock_guard lock(shard.mutex);
+        shard.statistics = DetectionStatistics{};
+    }
 }
 
 std::vector<std::string> ProtocolDetectionEngine::get_supported_protocols() const noexcept {
     std::vector<std::string> protocols;
-    std::shared_lock lock(signatures_mutex_);
+    auto signatures = signatures_.load(std::memory_order_acquire);
     
-    for (const auto& [name, _] : signatures_) {
+    for (const auto& [name, _] : *signatures) {
         protocols.push_back(name);
     }
     
@@ -469,30 +895,163 @@ DetectionResult ProtocolDetectionEngine::combine_results(const std::vector<Detec
     return best_result;
 }
 
-void ProtocolDetectionEngine::update_statistics(const DetectionResult& result, std::chrono::nanoseconds detection_time) const noexcept {
-    std::lock_guard lock(stats_mutex_);
+ProtocolDetectionEngine::StatisticsShard& ProtocolDetectionEngine::local_statistics_shard() const noexcept {
+    // 线程首次更新统计时分配固定的分片序号，同一线程始终写同一分片
+    static std::atomic<size_t> next_shard{0};
+    thread_local const size_t shard_index = next_shard.fetch_add(1, std::memory_order_relaxed);
+    return statistics_shards_[shard_index % kStatisticsShardCount];
+}
+
+bool ProtocolDetectionEngine::stage_enabled(DetectionStage stage, uint16_t src_port, uint16_t dst_port,
+                                            const ai::CompiledModel* model) const noexcept {
+    switch (stage) {
+        case DetectionStage::PORT:
+            return config_.use_port_based && (src_port != 0 || dst_port != 0);
+        case DetectionStage::ANCHORED_SIGNATURE:
+        case DetectionStage::MULTI_PATTERN:
+            return config_.use_signature_based;
+        case DetectionStage::HEURISTIC:
+            return config_.use_heuristic_based;
+        case DetectionStage::DEEP_INSPECTION:
+            return config_.use_deep_inspection;
+        case DetectionStage::ML_MODEL:
+            return config_.use_ml_model && model != nullptr && !model->empty();
+        default:
+            return false;
+    }
+}
+
+void ProtocolDetectionEngine::run_stage(DetectionStage stage, const protocol_parser::core::BufferView& buffer,
+                                        uint16_t src_port, uint16_t dst_port, const DetectionSnapshot& snapshot,
+                                        std::vector<DetectionResult>& results) const {
+    auto add_signature_result = [&](const std::string& name, double score, const char* evidence) {
+        DetectionResult result;
+        result.protocol_name = name;
+        result.confidence_score = score;
+        result.confidence = score_to_confidence_level(score);
+        result.detection_method = "Signature-based";
+        result.evidence.push_back(evidence);
+        result.bytes_analyzed = buffer.size();
+        results.push_back(std::move(result));
+    };
+    
+    switch (stage) {
+        case DetectionStage::PORT: {
+            auto port_results = port_detector_->detect_by_port(src_port, dst_port);
+            results.insert(results.end(), port_results.begin(), port_results.end());
+            break;
+        }
+        
+        case DetectionStage::ANCHORED_SIGNATURE: {
+            for (const auto& [name, signature] : *snapshot.signatures) {
+                double score = signature.calculate_anchored_score(buffer);
+                if (score > config_.min_confidence_threshold) {
+                    add_signature_result(name, score, "Anchored signature match");
+                }
+            }
+            break;
+        }
+        
+        case DetectionStage::MULTI_PATTERN: {
+            // 固定偏移阶段已命中的协议不再重复搜索
+            for (const auto& [name, signature] : *snapshot.signatures) {
+                bool anchored = std::any_of(results.begin(), results.end(), [&](const DetectionResult& r) {
+                    return r.protocol_name == name && r.detection_method == "Signature-based";
+                });
+                if (anchored) {
+                    continue;
+                }
+                double score = signature.calculate_match_score(buffer);
+                if (score > config_.min_confidence_threshold) {
+                    add_signature_result(name, score, "Signature pattern match");
+                }
+            }
+            break;
+        }
+        
+        case DetectionStage::HEURISTIC: {
+            auto features = heuristic_detector_->extract_features(buffer);
+            auto heuristic_results = heuristic_detector_->detect_by_heuristics(features);
+            results.insert(results.end(), heuristic_results.begin(), heuristic_results.end());
+            break;
+        }
+        
+        case DetectionStage::DEEP_INSPECTION: {
+            auto deep_results = deep_inspector_->inspect_deep(buffer);
+            results.insert(results.end(), deep_results.begin(), deep_results.end());
+            break;
+        }
+        
+        case DetectionStage::ML_MODEL: {
+            MLFeatureVector features{};
+            ml_extractor_->extract_feature_vector(std::span(&buffer, 1), features);
+            const auto& model = *snapshot.model;
+            auto prediction = model.classify(features);
+            double score = prediction.confidence;
+            if (score > config_.min_confidence_threshold) {
+                DetectionResult result;
+                result.protocol_name = model.class_name(prediction.class_index);
+                result.confidence_score = score;
+                result.confidence = score_to_confidence_level(score);
+                result.detection_method = "ML-model";
+                result.evidence.push_back("Compiled model score " + std::to_string(prediction.score));
+                result.bytes_analyzed = buffer.size();
+                results.push_back(std::move(result));
+            }
+            break;
+        }
+        
+        default:
+            break;
+    }
+}
+
+void ProtocolDetectionEngine::update_statistics(const DetectionResult& result, std::chrono::nanoseconds detection_time,
+                                                const PipelineTrace& trace) const noexcept {
+    auto& shard = local_statistics_shard();
+    std::lock_guard lock(shard.mutex);  // 通常无竞争，仅与合并读取互斥
+    auto& stats = shard.statistics;
     
-    statistics_.total_detections++;
+    stats.total_detections++;
     
     if (!result.protocol_name.empty() && result.confidence_score > config_.min_confidence_threshold) {
-        statistics_.successful_detections++;
-        statistics_.protocol_detection_count[result.protocol_name]++;
+        stats.successful_detections++;
+        try {
+            stats.protocol_detection_count[result.protocol_name]++;
+        } catch (const std::exception&) {
+            // 内存不足时仅丢失协议明细
+        }
         
         if (result.detection_method == "Port-based") {
-            statistics_.port_based_detections++;
+            stats.port_based_detections++;
         } else if (result.detection_method == "Signature-based") {
-            statistics_.signature_based_detections++;
+            stats.signature_based_detections++;
         } else if (result.detection_method.find("Heuristic") != std::string::npos) {
-            statistics_.heuristic_detections++;
+            stats.heuristic_detections++;
         } else if (result.detection_method == "Deep-inspection") {
-            statistics_.deep_inspection_detections++;
+            stats.deep_inspection_detections++;
+        } else if (result.detection_method == "ML-model") {
+            stats.ml_detections++;
+        } else if (result.detection_method == "Expected-flow") {
+            stats.expected_flow_detections++;
         }
     }
     
-    statistics_.total_detection_time += detection_time;
-    if (statistics_.total_detections > 0) {
-        statistics_.avg_detection_time = statistics_.total_detection_time / statistics_.total_detections;
+    for (size_t stage = 0; stage < kDetectionStageCount; ++stage) {
+        auto& to = stats.stage_statistics[stage];
+        to.invocations += trace.stages[stage].invocations;
+        to.hits += trace.stages[stage].hits;
+        to.skipped += trace.stages[stage].skipped;
+        to.cycles += trace.stages[stage].cycles;
+    }
+    if (trace.early_exit) {
+        stats.early_exits++;
     }
+    if (trace.budget_exhausted) {
+        stats.budget_exhausted++;
+    }
+    
+    stats.total_detection_time += detection_time;
 }
 
 void ProtocolDetectionEngine::initialize_builtin_signatures() {
@@ -602,26 +1161,405 @@ bool DeepPacketInspector::match_regex_patterns(const std::vector<std::regex>& pa
     return false;
 }
 
+// FeatureMatrix 实现
+void FeatureMatrix::resize(size_t rows) {
+    rows_ = rows;
+    stride_ = (rows + kRowAlignment - 1) / kRowAlignment * kRowAlignment;
+    data_.assign(stride_ * kMLFeatureCount, 0.0f);
+}
+
+MLFeatureVector FeatureMatrix::row(size_t row) const noexcept {
+    MLFeatureVector result{};
+    for (size_t f = 0; f < kMLFeatureCount; ++f) {
+        result[f] = data_[f * stride_ + row];
+    }
+    return result;
+}
+
+// MLFeatureExtractor 实现
+
+// 一条流的汇总量，快速路径与 MLFeatures 路径共用
+struct MLFeatureExtractor::FlowSummary {
+    double entropy{0.0};
+    double compression_ratio{0.0};
+    double printable_ratio{0.0};
+    double null_ratio{0.0};
+    double control_ratio{0.0};
+    double high_byte_ratio{0.0};
+    std::array<double, 8> byte_bins{};
+    uint64_t total_bytes{0};
+    size_t longest_zero_run{0};
+    size_t packet_count{0};
+    size_t header_like{0};
+    size_t length_fields{0};
+    size_t checksum_like{0};
+    size_t structured{0};
+    size_t binary{0};
+    double size_sum{0.0};
+    double size_sum_sq{0.0};
+    size_t min_size{0};
+    size_t max_size{0};
+    std::array<size_t, 4> first_sizes{};
+    std::array<uint8_t, 4> leading_bytes{};
+    
+    void add_packet_size(size_t size) noexcept {
+        if (packet_count < first_sizes.size()) {
+            first_sizes[packet_count] = size;
+        }
+        min_size = packet_count == 0 ? size : std::min(min_size, size);
+        max_size = std::max(max_size, size);
+        size_sum += static_cast<double>(size);
+        size_sum_sq += static_cast<double>(size) * static_cast<double>(size);
+        packet_count++;
+    }
+    
+    // ratio(b) 返回字节值 b 在整条流中的占比
+    template<typename Ratio>
+    void derive_byte_ratios(Ratio ratio) noexcept {
+        for (size_t b = 0; b < 256; ++b) {
+            double r = ratio(b);
+            if (r == 0.0) continue;
+            if (b == 0) {
+                null_ratio += r;
+            } else if (b >= 0x20 && b <= 0x7E) {
+                printable_ratio += r;
+            } else if (b < 0x20 || b == 0x7F) {
+                control_ratio += r;
+            }
+            if (b >= 0x80) {
+                high_byte_ratio += r;
+            }
+            byte_bins[b >> 5] += r;
+        }
+    }
+};
+
+namespace {
+    constexpr double kSizeScale = 1500.0;
+    
+    bool is_structured_start(uint8_t byte) noexcept {
+        // JSON 对象/数组、XML、ASN.1 BER SEQUENCE
+        return byte == '{' || byte == '[' || byte == '<' || byte == 0x30;
+    }
+}
+
+void MLFeatureExtractor::summarize_flow(std::span<const protocol_parser::core::BufferView> packets,
+                                        FlowSummary& summary,
+                                        std::array<double, 256>* normalized_frequency) const noexcept {
+    summary = FlowSummary{};
+    
+    std::array<uint64_t, 256> histogram{};
+    double compressed_bytes = 0.0;
+    utils::ByteStatistics stats;
+    
+    for (const auto& packet : packets) {
+        const auto data = packet.data();
+        const auto size = packet.size();
+        
+        if (summary.packet_count == 0) {
+            for (size_t i = 0; i < summary.leading_bytes.size() && i < size; ++i) {
+                summary.leading_bytes[i] = data[i];
+            }
+        }
+        summary.add_packet_size(size);
+        
+        if (size == 0) {
+            continue;
+        }
+        
+        utils::ByteStatisticsKernel::compute(data, size, stats);
+        for (size_t b = 0; b < 256; ++b) {
+            histogram[b] += stats.histogram[b];
+        }
+        summary.total_bytes += size;
+        summary.longest_zero_run = std::max(summary.longest_zero_run, stats.longest_zero_run);
+        
+        compressed_bytes += calculate_compression_ratio(packet) * static_cast<double>(size);
+        summary.length_fields += detect_length_fields(packet);
+        
+        if (detect_checksum_patterns(packet) > 0) {
+            summary.checksum_like++;
+        }
+        if (Utils::is_likely_header_field(data, std::min(size, size_t(64)))) {
+            summary.header_like++;
+        }
+        if (is_structured_start(data[0])) {
+            summary.structured++;
+        }
+        if (stats.null_count * 10 > size) {
+            summary.binary++;
+        }
+    }
+    
+    if (summary.total_bytes == 0) {
+        return;
+    }
+    
+    const double total = static_cast<double>(summary.total_bytes);
+    summary.compression_ratio = compressed_bytes / total;
+    summary.derive_byte_ratios([&](size_t b) { return static_cast<double>(histogram[b]) / total; });
+    
+    // 熵：H = log2(N) - (1/N) * Σ c·log2(c)
+    double sum = 0.0;
+    for (uint64_t count : histogram) {
+        if (count > 0) {
+            sum += count <= UINT32_MAX
+                ? utils::ByteStatisticsKernel::n_log2_n(static_cast<uint32_t>(count))
+                : static_cast<double>(count) * std::log2(static_cast<double>(count));
+        }
+    }
+    summary.entropy = std::max(0.0, std::log2(total) - sum / total);
+    
+    if (normalized_frequency != nullptr) {
+        for (size_t b = 0; b < 256; ++b) {
+            (*normalized_frequency)[b] = static_cast<double>(histogram[b]) / total;
+        }
+    }
+}
+
+void MLFeatureExtractor::write_features(const FlowSummary& summary, float* out, size_t stride) noexcept {
+    auto set = [&](MLFeatureIndex index, double value) {
+        out[static_cast<size_t>(index) * stride] = static_cast<float>(value);
+    };
+    
+    const double packets = static_cast<double>(summary.packet_count);
+    const double per_packet = packets > 0.0 ? 1.0 / packets : 0.0;
+    const double mean = summary.size_sum * per_packet;
+    const double variance = std::max(0.0, summary.size_sum_sq * per_packet - mean * mean);
+    
+    set(MLFeatureIndex::ENTROPY, summary.entropy / 8.0);
+    set(MLFeatureIndex::COMPRESSION_RATIO, summary.compression_ratio);
+    set(MLFeatureIndex::PRINTABLE_RATIO, summary.printable_ratio);
+    set(MLFeatureIndex::NULL_RATIO, summary.null_ratio);
+    set(MLFeatureIndex::CONTROL_RATIO, summary.control_ratio);
+    set(MLFeatureIndex::HIGH_BYTE_RATIO, summary.high_byte_ratio);
+    set(MLFeatureIndex::ZERO_RUN_RATIO, summary.total_bytes > 0
+        ? static_cast<double>(summary.longest_zero_run) / static_cast<double>(summary.total_bytes) : 0.0);
+    set(MLFeatureIndex::HEADER_LIKE_RATIO, summary.header_like * per_packet);
+    set(MLFeatureIndex::LENGTH_FIELDS, std::min(1.0, summary.length_fields * per_packet / 4.0));
+    set(MLFeatureIndex::CHECKSUM_RATIO, summary.checksum_like * per_packet);
+    set(MLFeatureIndex::STRUCTURED_RATIO, summary.structured * per_packet);
+    set(MLFeatureIndex::BINARY_RATIO, summary.binary * per_packet);
+    set(MLFeatureIndex::PACKET_COUNT, std::log2(1.0 + packets) / 16.0);
+    set(MLFeatureIndex::MEAN_SIZE, mean / kSizeScale);
+    set(MLFeatureIndex::STDDEV_SIZE, std::sqrt(variance) / kSizeScale);
+    set(MLFeatureIndex::MIN_SIZE, summary.min_size / kSizeScale);
+    set(MLFeatureIndex::MAX_SIZE, summary.max_size / kSizeScale);
+    
+    for (size_t i = 0; i < summary.first_sizes.size(); ++i) {
+        set(static_cast<MLFeatureIndex>(static_cast<size_t>(MLFeatureIndex::FIRST_SIZE_0) + i),
+            summary.first_sizes[i] / kSizeScale);
+        set(static_cast<MLFeatureIndex>(static_cast<size_t>(MLFeatureIndex::LEADING_BYTE_0) + i),
+            summary.leading_bytes[i] / 255.0);
+    }
+    for (size_t i = 0; i < summary.byte_bins.size(); ++i) {
+        set(static_cast<MLFeatureIndex>(static_cast<size_t>(MLFeatureIndex::BYTE_BIN_0) + i),
+            summary.byte_bins[i]);
+    }
+}
+
 MLFeatureExtractor::MLFeatures MLFeatureExtractor::extract_features(const std::vector<protocol_parser::core::BufferView>& packet_sequence) const noexcept {
-    // 简化实现
-    return MLFeatures{};
+    MLFeatures features;
+    FlowSummary summary;
+    summarize_flow(packet_sequence, summary, &features.byte_frequency_normalized);
+    
+    features.entropy = summary.entropy;
+    features.compression_ratio = summary.compression_ratio;
+    features.header_like_patterns = summary.header_like;
+    features.length_fields_detected = summary.length_fields;
+    features.checksum_like_patterns = summary.checksum_like;
+    features.ascii_percentage = static_cast<size_t>(summary.printable_ratio * 100.0 + 0.5);
+    features.binary_patterns = summary.binary;
+    features.structured_data_indicators = summary.structured;
+    features.longest_zero_run = summary.longest_zero_run;
+    features.leading_bytes = summary.leading_bytes;
+    
+    try {
+        features.packet_size_sequence.reserve(packet_sequence.size());
+        for (const auto& packet : packet_sequence) {
+            features.packet_size_sequence.push_back(packet.size());
+        }
+    } catch (const std::exception&) {
+        features.packet_size_sequence.clear();
+    }
+    
+    return features;
 }
 
 std::vector<double> MLFeatureExtractor::to_feature_vector(const MLFeatures& features) const noexcept {
-    // 简化实现
-    return {};
+    FlowSummary summary;
+    summary.entropy = features.entropy;
+    summary.compression_ratio = features.compression_ratio;
+    summary.header_like = features.header_like_patterns;
+    summary.length_fields = features.length_fields_detected;
+    summary.checksum_like = features.checksum_like_patterns;
+    summary.structured = features.structured_data_indicators;
+    summary.binary = features.binary_patterns;
+    summary.longest_zero_run = features.longest_zero_run;
+    summary.leading_bytes = features.leading_bytes;
+    summary.derive_byte_ratios([&](size_t b) { return features.byte_frequency_normalized[b]; });
+    
+    for (size_t size : features.packet_size_sequence) {
+        summary.add_packet_size(size);
+        summary.total_bytes += size;
+    }
+    
+    MLFeatureVector dense{};
+    write_features(summary, dense.data(), 1);
+    
+    try {
+        return std::vector<double>(dense.begin(), dense.end());
+    } catch (const std::exception&) {
+        return {};
+    }
+}
+
+void MLFeatureExtractor::extract_feature_vector(std::span<const protocol_parser::core::BufferView> packets,
+                                                MLFeatureVector& out) const noexcept {
+    FlowSummary summary;
+    summarize_flow(packets, summary, nullptr);
+    write_features(summary, out.data(), 1);
+}
+
+bool MLFeatureExtractor::extract_batch(std::span<const std::vector<protocol_parser::core::BufferView>> flows,
+                                       FeatureMatrix& out) const noexcept {
+    try {
+        out.resize(flows.size());
+    } catch (const std::exception&) {
+        return false;
+    }
+    
+    FlowSummary summary;
+    for (size_t row = 0; row < flows.size(); ++row) {
+        summarize_flow(flows[row], summary, nullptr);
+        write_features(summary, out.column(0) + row, out.stride());
+    }
+    return true;
+}
+
+bool MLFeatureExtractor::extract_batch(std::span<const protocol_parser::core::BufferView> packets,
+                                       FeatureMatrix& out) const noexcept {
+    try {
+        out.resize(packets.size());
+    } catch (const std::exception&) {
+        return false;
+    }
+    
+    FlowSummary summary;
+    for (size_t row = 0; row < packets.size(); ++row) {
+        summarize_flow(packets.subspan(row, 1), summary, nullptr);
+        write_features(summary, out.column(0) + row, out.stride());
+    }
+    return true;
 }
 
 double MLFeatureExtractor::calculate_compression_ratio(const protocol_parser::core::BufferView& buffer) const noexcept {
-    return 1.0;
+    // LZ 风格匹配计数：4 字节哈希找历史匹配，估算 字面量 + 每个匹配 3 字节 的压缩大小
+    constexpr size_t kWindow = 2048;     // 仅分析前 2KB
+    constexpr size_t kHashBits = 10;
+    constexpr uint16_t kEmpty = 0xFFFF;
+    constexpr size_t kMatchCost = 3;
+    
+    const auto data = buffer.data();
+    const size_t size = std::min(buffer.size(), kWindow);
+    if (size < 8) {
+        return 1.0;
+    }
+    
+    std::array<uint16_t, size_t(1) << kHashBits> table;
+    table.fill(kEmpty);
+    
+    size_t literals = 0;
+    size_t matches = 0;
+    size_t i = 0;
+    
+    while (i + 4 <= size) {
+        uint32_t word;
+        std::memcpy(&word, data + i, 4);
+        const size_t hash = (word * 2654435761u) >> (32 - kHashBits);
+        const uint16_t candidate = table[hash];
+        table[hash] = static_cast<uint16_t>(i);
+        
+        if (candidate != kEmpty && std::memcmp(data + candidate, data + i, 4) == 0) {
+            size_t length = 4;
+            while (i + length < size && data[candidate + length] == data[i + length]) {
+                ++length;
+            }
+            matches++;
+            i += length;
+        } else {
+            literals++;
+            i++;
+        }
+    }
+    literals += size - i;
+    
+    const double estimated = static_cast<double>(literals + matches * kMatchCost);
+    return std::min(1.0, estimated / static_cast<double>(size));
 }
 
 size_t MLFeatureExtractor::detect_length_fields(const protocol_parser::core::BufferView& buffer) const noexcept {
-    return 0;
+    // 在前 16 字节内寻找取值等于 总长度 / 剩余长度 的 8/16/32 位大端字段
+    constexpr size_t kScanRange = 16;
+    const size_t size = buffer.size();
+    if (size < 4) {
+        return 0;
+    }
+    
+    auto is_length_of = [size](uint64_t value, size_t offset, size_t width) {
+        if (value < 4) return false;
+        return value == size || value == size - offset || value == size - offset - width;
+    };
+    
+    size_t detected = 0;
+    const size_t limit = std::min(kScanRange, size);
+    
+    for (size_t offset = 0; offset < limit; ++offset) {
+        if (size < 256 && is_length_of(buffer[offset], offset, 1)) {
+            detected++;
+        }
+        if (offset + 2 <= size && is_length_of(buffer.read_be16(offset), offset, 2)) {
+            detected++;
+        }
+        if (offset % 4 == 0 && offset + 4 <= size && is_length_of(buffer.read_be32(offset), offset, 4)) {
+            detected++;
+        }
+    }
+    
+    return detected;
 }
 
 size_t MLFeatureExtractor::detect_checksum_patterns(const protocol_parser::core::BufferView& buffer) const noexcept {
-    return 0;
+    // 单遍累加：Internet 反码和、XOR、模 256 和；内嵌校验字段会使对应累加结果归零
+    const auto data = buffer.data();
+    const size_t size = buffer.size();
+    if (size < 4) {
+        return 0;
+    }
+    
+    uint64_t ones_complement = 0;   // 每字节至多加 0xFF00，64 位累加器在任何缓冲区长度下都不会回绕
+    uint8_t xor_sum = 0;
+    uint8_t byte_sum = 0;
+    uint8_t any_set = 0;
+    
+    for (size_t i = 0; i < size; ++i) {
+        ones_complement += (i & 1) ? data[i] : (static_cast<uint64_t>(data[i]) << 8);
+        xor_sum ^= data[i];
+        byte_sum = static_cast<uint8_t>(byte_sum + data[i]);
+        any_set |= data[i];
+    }
+    if (any_set == 0) {
+        return 0;   // 全零数据不构成校验特征
+    }
+    while (ones_complement >> 16) {
+        ones_complement = (ones_complement & 0xFFFF) + (ones_complement >> 16);
+    }
+    
+    size_t detected = 0;
+    if (ones_complement == 0xFFFF) detected++;   // Internet 校验和
+    if (xor_sum == 0) detected++;                // 尾部 XOR 校验
+    if (byte_sum == 0) detected++;               // 尾部 LRC
+    return detected;
 }
 
 // Utils 命名空间实现
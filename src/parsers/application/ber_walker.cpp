@@ -0,0 +1,78 @@
+#include "parsers/application/ber_walker.hpp"
+
+namespace protocol_parser::parsers {
+
+bool BERWalker::next(BERElement& out) noexcept {
+    if (failed_ || input_.empty()) {
+        return false;
+    }
+    const uint8_t* data = input_.data();
+    const size_t available = input_.size();
+    if (available < 2 || (data[0] & 0x1F) == 0x1F) {
+        failed_ = true;
+        return false;
+    }
+
+    const uint32_t first = data[1];
+    const uint32_t long_form = first >> 7;
+    const uint32_t octets = (first & 0x7F) & (0U - long_form);
+    size_t length;
+    if (available >= 6) {
+        // 后 4 字节整段读出，只保留前 octets 字节；短格式时 octets 为 0，被掩码丢弃
+        const uint64_t word = (static_cast<uint32_t>(data[2]) << 24) | (static_cast<uint32_t>(data[3]) << 16) |
+                              (static_cast<uint32_t>(data[4]) << 8) | data[5];
+        const uint32_t kept = octets < 4 ? octets : 4;
+        const uint64_t long_length = word >> (32 - 8 * kept);
+        const uint64_t mask = 0 - static_cast<uint64_t>(long_form);
+        length = static_cast<size_t>((long_length & mask) | (first & ~mask));
+    } else {
+        length = long_form ? 0 : first;
+        for (uint32_t i = 0; i < octets && 2 + i < available; ++i) {
+            length = (length << 8) | data[2 + i];
+        }
+    }
+
+    // 长格式要求 1-4 个长度字节（0x80 为不定长）
+    const size_t header = 2 + octets;
+    const bool bad_form = long_form != 0 && (octets == 0 || octets > 4);
+    if (bad_form || header > available || length > available - header) {
+        failed_ = true;
+        return false;
+    }
+
+    out.tag = data[0];
+    out.value = input_.subspan(header, length);
+    out.encoded = input_.first(header + length);
+    input_ = input_.subspan(header + length);
+    return true;
+}
+
+bool BERWalker::decode_integer(std::span<const uint8_t> value, int64_t& out) noexcept {
+    if (value.empty() || value.size() > 8) {
+        return false;
+    }
+    // 从符号位扩展开始逐字节移入
+    uint64_t result = (value[0] & 0x80) ? ~uint64_t{0} : 0;
+    for (uint8_t byte : value) {
+        result = (result << 8) | byte;
+    }
+    out = static_cast<int64_t>(result);
+    return true;
+}
+
+bool BERWalker::decode_unsigned(std::span<const uint8_t> value, uint64_t& out) noexcept {
+    if (value.size() == 9 && value[0] == 0) {
+        value = value.subspan(1);
+    }
+    if (value.empty() || value.size() > 8) {
+        return false;
+    }
+    uint64_t result = 0;
+    for (uint8_t byte : value) {
+        result = (result << 8) | byte;
+    }
+    out = result;
+    return true;
+}
+
+} // namespace protocol_parser::parsers
@@ -0,0 +1,342 @@
+#include "parsers/application/dhcp_lease_table.hpp"
+#include <algorithm>
+#include <bit>
+
+namespace ProtocolParser::Parsers::Application {
+
+namespace {
+    constexpr uint8_t kFqdnEncoded = 0x04;   // RFC 4702 2.1：E 位，名字为 DNS 线格式
+
+    inline uint64_t mix64(uint64_t value) noexcept {
+        value ^= value >> 33;
+        value *= 0xff51afd7ed558ccdULL;
+        value ^= value >> 33;
+        value *= 0xc4ceb9fe1a85ec53ULL;
+        value ^= value >> 33;
+        return value;
+    }
+
+    struct HostnameBuffer {
+        std::array<char, DHCPLease::kMaxHostname> text{};
+        size_t length = 0;
+
+        void append(const uint8_t* data, size_t count) noexcept {
+            count = std::min(count, text.size() - length);
+            std::copy_n(data, count, text.begin() + static_cast<std::ptrdiff_t>(length));
+            length += count;
+        }
+    };
+
+    // 选项 12；缺省时取选项 81 的域名（线格式按标签拼成点分形式）
+    bool read_hostname(const DHCPMessage& message, HostnameBuffer& out) noexcept {
+        std::array<uint8_t, 255> value{};
+        size_t length = std::min(message.copy_option(DHCPOptionType::HOST_NAME, value), value.size());
+        if (length != 0) {
+            out.append(value.data(), length);
+        } else {
+            length = std::min(message.copy_option(DHCPOptionType::DHCP_FQDN, value), value.size());
+            if (length <= 3) {
+                return false;
+            }
+            if ((value[0] & kFqdnEncoded) == 0) {
+                out.append(value.data() + 3, length - 3);
+            } else {
+                for (size_t offset = 3; offset < length && value[offset] != 0;) {
+                    const size_t label = value[offset++];
+                    if (label > 63 || offset + label > length) {
+                        break;
+                    }
+                    if (out.length != 0) {
+                        const uint8_t dot = '.';
+                        out.append(&dot, 1);
+                    }
+                    out.append(value.data() + offset, label);
+                    offset += label;
+                }
+            }
+        }
+        // 部分客户端带结尾的 NUL
+        while (out.length != 0 && out.text[out.length - 1] == '\0') {
+            --out.length;
+        }
+        return out.length != 0;
+    }
+}
+
+DHCPLeaseTable::DHCPLeaseTable() : DHCPLeaseTable(Config{}) {}
+
+DHCPLeaseTable::DHCPLeaseTable(const Config& config) : config_(config) {
+    config_.max_leases = std::clamp<size_t>(config_.max_leases, 1, kEmpty - 1);
+    leases_.reserve(std::min<size_t>(config_.max_leases, 4096));
+    // 负载不超过 1/2
+    const size_t slots = std::bit_ceil(std::max<size_t>(config_.max_leases * 2, 16));
+    by_mac_.assign(slots, kEmpty);
+    by_ip_.assign(slots, kEmpty);
+    mask_ = slots - 1;
+}
+
+uint64_t DHCPLeaseTable::mac_key(const DHCPHeader& header) noexcept {
+    if (header.hlen != 6) {
+        return 0;
+    }
+    uint64_t mac = 0;
+    for (size_t i = 0; i < 6; ++i) {
+        mac = (mac << 8) | header.chaddr[i];
+    }
+    return mac;
+}
+
+size_t DHCPLeaseTable::find_mac(uint64_t mac) const noexcept {
+    for (size_t index = mix64(mac) & mask_;; index = (index + 1) & mask_) {
+        const uint32_t lease = by_mac_[index];
+        if (lease == kEmpty) {
+            return by_mac_.size();
+        }
+        if (leases_[lease].mac == mac) {
+            return index;
+        }
+    }
+}
+
+size_t DHCPLeaseTable::find_ip(uint32_t ip) const noexcept {
+    for (size_t index = mix64(ip) & mask_;; index = (index + 1) & mask_) {
+        const uint32_t lease = by_ip_[index];
+        if (lease == kEmpty) {
+            return by_ip_.size();
+        }
+        if (leases_[lease].ip == ip) {
+            return index;
+        }
+    }
+}
+
+void DHCPLeaseTable::insert(std::vector<uint32_t>& table, uint64_t hash, uint32_t lease) noexcept {
+    size_t index = hash & mask_;
+    while (table[index] != kEmpty) {
+        index = (index + 1) & mask_;
+    }
+    table[index] = lease;
+}
+
+template <typename Key>
+void DHCPLeaseTable::erase(std::vector<uint32_t>& table, size_t index, Key key) noexcept {
+    // 后移删除，不留墓碑；槽中只存租约下标，home 由租约的键重新计算
+    size_t hole = index;
+    for (size_t next = (hole + 1) & mask_; table[next] != kEmpty; next = (next + 1) & mask_) {
+        const size_t home = mix64(key(leases_[table[next]])) & mask_;
+        // home 循环落在 (hole, next] 内的条目保持不动
+        const bool stays = (hole <= next) ? (home > hole && home <= next) : (home > hole || home <= next);
+        if (!stays) {
+            table[hole] = table[next];
+            hole = next;
+        }
+    }
+    table[hole] = kEmpty;
+}
+
+uint32_t DHCPLeaseTable::acquire(uint64_t mac, uint64_t now_us) {
+    const size_t slot = find_mac(mac);
+    if (slot != by_mac_.size()) {
+        return by_mac_[slot];
+    }
+    if (size_ >= config_.max_leases) {
+        sweep(now_us, config_.sweep_step);
+        if (size_ >= config_.max_leases) {
+            ++stats_.dropped;
+            return kEmpty;
+        }
+    }
+
+    uint32_t index;
+    if (!free_.empty()) {
+        index = free_.back();
+        free_.pop_back();
+    } else {
+        index = static_cast<uint32_t>(leases_.size());
+        leases_.emplace_back();
+    }
+    leases_[index] = DHCPLease{};
+    leases_[index].mac = mac;
+    leases_[index].last_seen_us = now_us;
+    insert(by_mac_, mix64(mac), index);
+    ++size_;
+    return index;
+}
+
+void DHCPLeaseTable::bind(uint32_t index, uint32_t ip, uint64_t expires_us) {
+    DHCPLease& lease = leases_[index];
+    if (lease.ip == ip) {
+        lease.expires_us = expires_us;
+        ++stats_.leases_renewed;
+        return;
+    }
+    unbind(index);
+
+    const size_t slot = find_ip(ip);
+    if (slot != by_ip_.size()) {
+        const uint32_t holder = by_ip_[slot];
+        erase(by_ip_, slot, [](const DHCPLease& entry) { return uint64_t{entry.ip}; });
+        leases_[holder].ip = 0;
+        ++stats_.address_moves;
+    }
+    lease.ip = ip;
+    lease.expires_us = expires_us;
+    insert(by_ip_, mix64(ip), index);
+    ++stats_.leases_bound;
+}
+
+void DHCPLeaseTable::unbind(uint32_t index) noexcept {
+    DHCPLease& lease = leases_[index];
+    if (lease.ip == 0) {
+        return;
+    }
+    const size_t slot = find_ip(lease.ip);
+    if (slot != by_ip_.size()) {
+        erase(by_ip_, slot, [](const DHCPLease& entry) { return uint64_t{entry.ip}; });
+    }
+    lease.ip = 0;
+    lease.expires_us = 0;
+}
+
+void DHCPLeaseTable::remove(uint32_t index) noexcept {
+    unbind(index);
+    const size_t slot = find_mac(leases_[index].mac);
+    if (slot != by_mac_.size()) {
+        erase(by_mac_, slot, [](const DHCPLease& entry) { return entry.mac; });
+    }
+    leases_[index].mac = 0;
+    free_.push_back(index);
+    --size_;
+}
+
+bool DHCPLeaseTable::observe(const DHCPMessage& message, uint64_t now_us) {
+    sweep(now_us, config_.sweep_step);
+
+    const uint64_t mac = mac_key(message.header);
+    const auto type = message.get_message_type();
+    if (mac == 0 || !type) {
+        return false;
+    }
+
+    switch (*type) {
+        case DHCPOpcode::DISCOVER:
+        case DHCPOpcode::REQUEST:
+        case DHCPOpcode::INFORM:
+        case DHCPOpcode::ACK:
+            break;
+        case DHCPOpcode::RELEASE:
+        case DHCPOpcode::DECLINE:
+        case DHCPOpcode::NAK: {
+            const size_t slot = find_mac(mac);
+            if (slot == by_mac_.size() || leases_[by_mac_[slot]].ip == 0) {
+                return false;
+            }
+            const uint32_t index = by_mac_[slot];
+            // DECLINE 在选项 50 中给出被拒绝的地址，只在与当前绑定一致时解除
+            if (*type == DHCPOpcode::DECLINE) {
+                const auto declined = message.get_requested_ip();
+                if (declined && *declined != leases_[index].ip) {
+                    return false;
+                }
+            }
+            unbind(index);
+            leases_[index].last_seen_us = now_us;
+            ++stats_.leases_released;
+            return true;
+        }
+        default:
+            return false;   // OFFER 不代表分配
+    }
+
+    const uint32_t index = acquire(mac, now_us);
+    if (index == kEmpty) {
+        return false;
+    }
+    DHCPLease& lease = leases_[index];
+    lease.last_seen_us = now_us;
+
+    HostnameBuffer hostname;
+    if (read_hostname(message, hostname) &&
+        lease.get_hostname() != std::string_view(hostname.text.data(), hostname.length)) {
+        std::copy_n(hostname.text.begin(), hostname.length, lease.hostname.begin());
+        lease.hostname_length = static_cast<uint8_t>(hostname.length);
+        ++stats_.hostnames_learned;
+    }
+
+    if (*type == DHCPOpcode::ACK) {
+        uint32_t ip = message.header.yiaddr;
+        uint64_t expires_us = now_us + config_.inform_lease_us;
+        if (ip == 0) {
+            ip = message.header.ciaddr;       // INFORM 的 ACK 不分配地址
+        } else if (const auto lease_time = message.get_lease_time()) {
+            expires_us = *lease_time == UINT32_MAX ? UINT64_MAX : now_us + uint64_t{*lease_time} * 1'000'000;
+        }
+        if (ip != 0) {
+            bind(index, ip, expires_us);
+            if (const auto server = message.get_server_identifier()) {
+                leases_[index].server = *server;
+            }
+        }
+    }
+    return true;
+}
+
+const DHCPLease* DHCPLeaseTable::find_by_ip(uint32_t ip, uint64_t now_us) const noexcept {
+    if (ip == 0) {
+        return nullptr;
+    }
+    const size_t slot = find_ip(ip);
+    if (slot == by_ip_.size()) {
+        return nullptr;
+    }
+    const DHCPLease& lease = leases_[by_ip_[slot]];
+    return lease.expires_us > now_us ? &lease : nullptr;
+}
+
+const DHCPLease* DHCPLeaseTable::find_by_mac(uint64_t mac) const noexcept {
+    if (mac == 0) {
+        return nullptr;
+    }
+    const size_t slot = find_mac(mac);
+    return slot != by_mac_.size() ? &leases_[by_mac_[slot]] : nullptr;
+}
+
+bool DHCPLeaseTable::is_expired(const DHCPLease& lease, uint64_t now_us) const noexcept {
+    if (lease.ip != 0) {
+        return lease.expires_us <= now_us;
+    }
+    return lease.last_seen_us + config_.pending_timeout_us <= now_us;
+}
+
+void DHCPLeaseTable::sweep(uint64_t now_us, size_t budget) {
+    if (leases_.empty()) {
+        return;
+    }
+    budget = std::min(budget, leases_.size());
+    for (size_t step = 0; step < budget; ++step) {
+        if (sweep_cursor_ >= leases_.size()) {
+            sweep_cursor_ = 0;
+        }
+        const auto index = static_cast<uint32_t>(sweep_cursor_++);
+        if (leases_[index].mac != 0 && is_expired(leases_[index], now_us)) {
+            remove(index);
+            ++stats_.leases_expired;
+        }
+    }
+}
+
+void DHCPLeaseTable::expire(uint64_t now_us) {
+    sweep_cursor_ = 0;
+    sweep(now_us, leases_.size());
+}
+
+void DHCPLeaseTable::clear() {
+    leases_.clear();
+    free_.clear();
+    std::fill(by_mac_.begin(), by_mac_.end(), kEmpty);
+    std::fill(by_ip_.begin(), by_ip_.end(), kEmpty);
+    size_ = 0;
+    sweep_cursor_ = 0;
+}
+
+} // namespace ProtocolParser::Parsers::Application
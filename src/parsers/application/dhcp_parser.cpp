@@ -46,68 +46,208 @@ std::vector<uint32_t> DHCPOption::as_ip_list() const {
     return ips;
 }
 
-// DHCPMessage 方法实现
-std::optional<DHCPOpcode> DHCPMessage::get_message_type() const noexcept {
-    for (const auto& option : options) {
-        if (option.type == DHCPOptionType::DHCP_MESSAGE_TYPE && !option.data.empty()) {
-            return static_cast<DHCPOpcode>(option.data[0]);
+// DHCPOptionIndex 方法实现
+namespace {
+    constexpr size_t kSnameOffset = 44;
+    constexpr size_t kFileOffset = 108;
+    constexpr uint8_t kOverloadFile = 0x01;
+    constexpr uint8_t kOverloadSname = 0x02;
+
+    inline uint8_t code_of(DHCPOptionType type) noexcept {
+        return static_cast<uint8_t>(type);
+    }
+
+    inline uint32_t load_be32(const uint8_t* data) noexcept {
+        return (static_cast<uint32_t>(data[0]) << 24) | (static_cast<uint32_t>(data[1]) << 16) |
+               (static_cast<uint32_t>(data[2]) << 8) | static_cast<uint32_t>(data[3]);
+    }
+
+    std::optional<uint32_t> option_u32(const DHCPMessage& message, DHCPOptionType type) noexcept {
+        std::array<uint8_t, 4> value{};
+        if (message.copy_option(type, value) < value.size()) {
+            return std::nullopt;
         }
+        return load_be32(value.data());
     }
-    return std::nullopt;
-}
 
-std::optional<uint32_t> DHCPMessage::get_server_identifier() const noexcept {
-    for (const auto& option : options) {
-        if (option.type == DHCPOptionType::DHCP_SERVER_IDENTIFIER && option.data.size() >= 4) {
-            return option.as_uint32();
+    std::optional<std::string> option_string(const DHCPMessage& message, DHCPOptionType type) {
+        const size_t length = message.copy_option(type, {});
+        if (length == 0) {
+            return std::nullopt;
         }
+        std::string value(length, '\0');
+        message.copy_option(type, std::span<uint8_t>(reinterpret_cast<uint8_t*>(value.data()), value.size()));
+        return value;
     }
-    return std::nullopt;
 }
 
-std::optional<uint32_t> DHCPMessage::get_requested_ip() const noexcept {
-    for (const auto& option : options) {
-        if (option.type == DHCPOptionType::DHCP_REQUESTED_ADDRESS && option.data.size() >= 4) {
-            return option.as_uint32();
+void DHCPOptionIndex::clear() noexcept {
+    present_.fill(0);
+    segment_count_ = 0;
+    option_count_ = 0;
+    overload_ = 0;
+}
+
+bool DHCPOptionIndex::build(std::span<const uint8_t> packet) noexcept {
+    clear();
+    if (packet.size() < DHCP_HEADER_SIZE + 4) {
+        return packet.size() >= DHCP_HEADER_SIZE;
+    }
+    if (!scan(packet, DHCP_HEADER_SIZE + 4, packet.size())) {
+        return false;
+    }
+
+    // RFC 2131 4.1 / RFC 3396：选项 52 指定 file、sname 字段也承载选项，按 options、file、sname 的顺序拼接
+    const auto overload = static_cast<uint8_t>(DHCPOptionType::DHCP_OPTION_OVERLOAD);
+    if (has(overload) && entries_[overload].length >= 1) {
+        overload_ = packet[segments_[entries_[overload].head].offset] & (kOverloadFile | kOverloadSname);
+        if ((overload_ & kOverloadFile) != 0 && !scan(packet, kFileOffset, kFileOffset + 128)) {
+            return false;
+        }
+        if ((overload_ & kOverloadSname) != 0 && !scan(packet, kSnameOffset, kSnameOffset + 64)) {
+            return false;
         }
     }
-    return std::nullopt;
+    return true;
 }
 
-std::optional<uint32_t> DHCPMessage::get_lease_time() const noexcept {
-    for (const auto& option : options) {
-        if (option.type == DHCPOptionType::DHCP_LEASE_TIME && option.data.size() >= 4) {
-            return option.as_uint32();
+bool DHCPOptionIndex::scan(std::span<const uint8_t> packet, size_t begin, size_t end) noexcept {
+    size_t offset = begin;
+    while (offset < end) {
+        const uint8_t code = packet[offset];
+        if (code == static_cast<uint8_t>(DHCPOptionType::PAD)) {
+            ++offset;
+            continue;
         }
+        if (code == static_cast<uint8_t>(DHCPOptionType::END)) {
+            return true;
+        }
+        if (offset + 2 > end) {
+            return false;
+        }
+        const uint8_t length = packet[offset + 1];
+        if (offset + 2 + length > end || segment_count_ == kMaxSegments) {
+            return false;
+        }
+
+        const uint16_t segment = segment_count_++;
+        segments_[segment] = Segment{static_cast<uint16_t>(offset + 2), length, kEnd};
+        Entry& entry = entries_[code];
+        if (has(code)) {
+            segments_[entry.tail].next = segment;
+            entry.tail = segment;
+            entry.length = static_cast<uint16_t>(entry.length + length);
+            ++entry.count;
+        } else {
+            present_[code >> 6] |= uint64_t{1} << (code & 63);
+            entry = Entry{segment, segment, length, 1};
+            ++option_count_;
+        }
+        offset += 2 + length;
     }
-    return std::nullopt;
+    // 缺少 END 时按字段结束处理
+    return true;
 }
 
-std::optional<std::vector<uint32_t>> DHCPMessage::get_dns_servers() const noexcept {
-    for (const auto& option : options) {
-        if (option.type == DHCPOptionType::DNS_SERVER && option.data.size() >= 4) {
-            return option.as_ip_list();
-        }
+std::span<const uint8_t> DHCPOptionIndex::view(std::span<const uint8_t> packet, uint8_t code) const noexcept {
+    if (!has(code) || entries_[code].count != 1) {
+        return {};
     }
-    return std::nullopt;
+    const Segment& segment = segments_[entries_[code].head];
+    return packet.subspan(segment.offset, segment.length);
 }
 
-std::optional<std::string> DHCPMessage::get_domain_name() const noexcept {
+size_t DHCPOptionIndex::copy(std::span<const uint8_t> packet, uint8_t code, std::span<uint8_t> out) const noexcept {
+    if (!has(code)) {
+        return 0;
+    }
+    size_t written = 0;
+    for (uint16_t index = entries_[code].head; index != kEnd && written < out.size(); index = segments_[index].next) {
+        const Segment& segment = segments_[index];
+        const size_t count = std::min<size_t>(segment.length, out.size() - written);
+        std::memcpy(out.data() + written, packet.data() + segment.offset, count);
+        written += count;
+    }
+    return entries_[code].length;
+}
+
+// DHCPMessage 方法实现
+bool DHCPMessage::has_option(DHCPOptionType type) const noexcept {
+    return option_index.has(code_of(type));
+}
+
+std::span<const uint8_t> DHCPMessage::option_view(DHCPOptionType type) const noexcept {
+    if (is_lazy()) {
+        return option_index.view(packet, code_of(type));
+    }
     for (const auto& option : options) {
-        if (option.type == DHCPOptionType::DOMAIN_NAME && !option.data.empty()) {
-            return option.as_string();
+        if (option.type == type) {
+            return option.data;
         }
     }
-    return std::nullopt;
+    return {};
 }
 
-std::optional<std::string> DHCPMessage::get_hostname() const noexcept {
+size_t DHCPMessage::copy_option(DHCPOptionType type, std::span<uint8_t> out) const noexcept {
+    if (is_lazy()) {
+        return option_index.copy(packet, code_of(type), out);
+    }
+    // 立即解码模式同样按出现顺序拼接同一选项码的多个实例
+    size_t total = 0;
     for (const auto& option : options) {
-        if (option.type == DHCPOptionType::HOST_NAME && !option.data.empty()) {
-            return option.as_string();
+        if (option.type != type) {
+            continue;
         }
+        if (total < out.size() && !option.data.empty()) {
+            const size_t count = std::min(option.data.size(), out.size() - total);
+            std::memcpy(out.data() + total, option.data.data(), count);
+        }
+        total += option.data.size();
+    }
+    return total;
+}
+
+std::optional<DHCPOpcode> DHCPMessage::get_message_type() const noexcept {
+    uint8_t value = 0;
+    if (copy_option(DHCPOptionType::DHCP_MESSAGE_TYPE, std::span<uint8_t>(&value, 1)) == 0) {
+        return std::nullopt;
     }
-    return std::nullopt;
+    return static_cast<DHCPOpcode>(value);
+}
+
+std::optional<uint32_t> DHCPMessage::get_server_identifier() const noexcept {
+    return option_u32(*this, DHCPOptionType::DHCP_SERVER_IDENTIFIER);
+}
+
+std::optional<uint32_t> DHCPMessage::get_requested_ip() const noexcept {
+    return option_u32(*this, DHCPOptionType::DHCP_REQUESTED_ADDRESS);
+}
+
+std::optional<uint32_t> DHCPMessage::get_lease_time() const noexcept {
+    return option_u32(*this, DHCPOptionType::DHCP_LEASE_TIME);
+}
+
+std::optional<std::vector<uint32_t>> DHCPMessage::get_dns_servers() const noexcept {
+    const size_t length = copy_option(DHCPOptionType::DNS_SERVER, {});
+    if (length < 4) {
+        return std::nullopt;
+    }
+    std::vector<uint8_t> data(length);
+    copy_option(DHCPOptionType::DNS_SERVER, data);
+    std::vector<uint32_t> ips;
+    ips.reserve(length / 4);
+    for (size_t i = 0; i + 3 < data.size(); i += 4) {
+        ips.push_back(load_be32(&data[i]));
+    }
+    return ips;
+}
+
+std::optional<std::string> DHCPMessage::get_domain_name() const noexcept {
+    return option_string(*this, DHCPOptionType::DOMAIN_NAME);
+}
+
+std::optional<std::string> DHCPMessage::get_hostname() const noexcept {
+    return option_string(*this, DHCPOptionType::HOST_NAME);
 }
 
 bool DHCPMessage::is_broadcast() const noexcept {
@@ -145,8 +285,16 @@ ParseResult DHCPParser::parse(const BufferView& buffer) noexcept {
                 return ParseResult::InvalidFormat;
             }
             
-            // 解析选项
-            if (!parse_options(data, size, DHCP_HEADER_SIZE + 4)) {
+            // 一次遍历建立选项偏移索引（含 overload 与 RFC 3396 分段）；懒解码模式下不再复制选项
+            const std::span<const uint8_t> packet(data, size);
+            if (!dhcp_message_.option_index.build(packet)) {
+                is_malformed_ = true;
+                return ParseResult::InvalidFormat;
+            }
+            if (lazy_options_) {
+                dhcp_message_.packet = packet;
+            } else if (!parse_options(data, size, DHCP_HEADER_SIZE + 4) ||
+                       !parse_overloaded_options(data)) {
                 is_malformed_ = true;
                 return ParseResult::InvalidFormat;
             }
@@ -196,7 +344,11 @@ bool DHCPParser::can_parse(const BufferView& buffer) const noexcept {
 }
 
 void DHCPParser::reset() noexcept {
-    dhcp_message_ = DHCPMessage{};
+    // 选项索引只清位图，避免每个报文清零整张索引
+    dhcp_message_.header = DHCPHeader{};
+    dhcp_message_.options.clear();
+    dhcp_message_.option_index.clear();
+    dhcp_message_.packet = {};
     parsed_successfully_ = false;
     is_malformed_ = false;
 }
@@ -214,13 +366,13 @@ bool DHCPParser::validate_message() const noexcept {
         return false;
     }
     
-    for (const auto& option : dhcp_message_.options) {
-        if (!validate_option(option)) {
-            return false;
-        }
-    }
-    
-    return true;
+    // RFC 3396：按拼接后的长度校验，两种解码模式都以索引为准
+    bool valid = true;
+    dhcp_message_.option_index.for_each([&](uint8_t code) {
+        valid = valid && is_valid_option_length(static_cast<DHCPOptionType>(code),
+                                                dhcp_message_.option_index.length(code));
+    });
+    return valid;
 }
 
 bool DHCPParser::is_malformed() const noexcept {
@@ -262,6 +414,30 @@ DHCPParser::DHCPAnalysis DHCPParser::analyze_message() const noexcept {
     analysis.has_relay_agent = (dhcp_message_.header.giaddr != 0);
     
     // 分析选项
+    if (dhcp_message_.is_lazy()) {
+        const auto& index = dhcp_message_.option_index;
+        analysis.total_options = index.option_count();
+        if (auto vendor = option_string(dhcp_message_, DHCPOptionType::DHCP_VENDOR_CLASS_ID)) {
+            analysis.vendor_class = std::move(*vendor);
+        }
+        if (auto client = option_string(dhcp_message_, DHCPOptionType::DHCP_CLIENT_IDENTIFIER)) {
+            analysis.client_identifier = std::move(*client);
+        }
+        std::array<uint8_t, 255> requested{};
+        const size_t count = std::min(
+            dhcp_message_.copy_option(DHCPOptionType::DHCP_PARAMETER_REQUEST_LIST, requested), requested.size());
+        for (size_t i = 0; i < count; ++i) {
+            analysis.requested_options.push_back(static_cast<DHCPOptionType>(requested[i]));
+        }
+        index.for_each([&](uint8_t code) {
+            const auto type = static_cast<DHCPOptionType>(code);
+            if (code > 76 && type != DHCPOptionType::DHCP_FQDN && type != DHCPOptionType::DHCP_AGENT_OPTIONS) {
+                analysis.unknown_options++;
+            }
+        });
+        return analysis;
+    }
+    
     analysis.total_options = dhcp_message_.options.size();
     
     for (const auto& option : dhcp_message_.options) {
@@ -409,8 +585,7 @@ bool DHCPParser::parse_options(const uint8_t* data, size_t size, size_t offset)
         }
         
         // 检查是否遇到END选项
-        if (current_offset > offset && 
-            data[current_offset - dhcp_message_.options.back().length - 2] == static_cast<uint8_t>(DHCPOptionType::END)) {
+        if (dhcp_message_.options.back().type == DHCPOptionType::END) {
             break;
         }
     }
@@ -418,6 +593,18 @@ bool DHCPParser::parse_options(const uint8_t* data, size_t size, size_t offset)
     return true;
 }
 
+bool DHCPParser::parse_overloaded_options(const uint8_t* data) noexcept {
+    // 与索引相同的顺序（options、file、sname）追加到 options，两种模式下的访问结果一致
+    const uint8_t overload = dhcp_message_.option_index.overload();
+    if ((overload & kOverloadFile) != 0 && !parse_options(data, kFileOffset + 128, kFileOffset)) {
+        return false;
+    }
+    if ((overload & kOverloadSname) != 0 && !parse_options(data, kSnameOffset + 64, kSnameOffset)) {
+        return false;
+    }
+    return true;
+}
+
 bool DHCPParser::parse_single_option(const uint8_t* data, size_t size, size_t& offset) noexcept {
     if (offset >= size) {
         return false;
@@ -475,26 +662,26 @@ bool DHCPParser::validate_header(const DHCPHeader& header) const noexcept {
     return true;
 }
 
-bool DHCPParser::validate_option(const DHCPOption& option) const noexcept {
-    switch (option.type) {
+bool DHCPParser::is_valid_option_length(DHCPOptionType type, size_t length) noexcept {
+    switch (type) {
         case DHCPOptionType::SUBNET_MASK:
         case DHCPOptionType::ROUTER:
         case DHCPOptionType::DNS_SERVER:
         case DHCPOptionType::DHCP_SERVER_IDENTIFIER:
         case DHCPOptionType::DHCP_REQUESTED_ADDRESS:
-            return option.data.size() % 4 == 0 && !option.data.empty();
+            return length % 4 == 0 && length != 0;
             
         case DHCPOptionType::DHCP_MESSAGE_TYPE:
-            return option.data.size() == 1;
+            return length == 1;
             
         case DHCPOptionType::DHCP_LEASE_TIME:
         case DHCPOptionType::DHCP_RENEWAL_TIME:
         case DHCPOptionType::DHCP_REBINDING_TIME:
-            return option.data.size() == 4;
+            return length == 4;
             
         case DHCPOptionType::PAD:
         case DHCPOptionType::END:
-            return option.data.empty();
+            return length == 0;
             
         default:
             return true; // 未知选项默认有效
@@ -524,8 +711,14 @@ void DHCPParser::update_statistics(const DHCPMessage& message) noexcept {
     }
     
     // 统计选项使用情况
-    for (const auto& option : message.options) {
-        statistics_.option_usage[option.type]++;
+    if (message.is_lazy()) {
+        message.option_index.for_each([&](uint8_t code) {
+            statistics_.option_usage[static_cast<DHCPOptionType>(code)]++;
+        });
+    } else {
+        for (const auto& option : message.options) {
+            statistics_.option_usage[option.type]++;
+        }
     }
     
     if (is_malformed_) {
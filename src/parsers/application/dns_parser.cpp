@@ -8,202 +8,452 @@ using namespace protocol_parser::utils;
 
 namespace protocol_parser::parsers {
 
-ParseResult DNSParser::parse(ParseContext& context) noexcept {
-    const BufferView& buffer = context.buffer;
-    if (buffer.size() < 12) {
-        return ParseResult::InvalidFormat;
-    }
-
-    size_t offset = 0;
-    
-    // Parse DNS header
-    auto status = parse_header(buffer, offset);
-    if (status != ParseResult::Success) {
-        return status;
-    }
-
-    // Parse questions
-    status = parse_questions(buffer, offset);
-    if (status != ParseResult::Success) {
-        return status;
-    }
+namespace {
+    constexpr uint64_t kFnvOffsetBasis = 0xcbf29ce484222325ULL;
+    constexpr uint64_t kFnvPrime = 0x100000001b3ULL;
 
-    // Parse answer records
-    status = parse_resource_records(buffer, offset, dns_message_.answers, dns_message_.header.ancount);
-    if (status != ParseResult::Success) {
-        return status;
+    inline char ascii_lower(char c) noexcept {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c + ('a' - 'A')) : c;
     }
 
-    // Parse authority records
-    status = parse_resource_records(buffer, offset, dns_message_.authority, dns_message_.header.nscount);
-    if (status != ParseResult::Success) {
-        return status;
+    inline bool label_equals(std::string_view lhs, std::string_view rhs) noexcept {
+        if (lhs.size() != rhs.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < lhs.size(); ++i) {
+            if (ascii_lower(lhs[i]) != ascii_lower(rhs[i])) {
+                return false;
+            }
+        }
+        return true;
     }
 
-    // Parse additional records
-    status = parse_resource_records(buffer, offset, dns_message_.additional, dns_message_.header.arcount);
-    if (status != ParseResult::Success) {
-        return status;
+    inline uint64_t hash_label(uint64_t hash, std::string_view label) noexcept {
+        hash = (hash ^ static_cast<uint8_t>(label.size())) * kFnvPrime;
+        for (const char c : label) {
+            hash = (hash ^ static_cast<uint8_t>(ascii_lower(c))) * kFnvPrime;
+        }
+        return hash;
     }
 
-    // Store parsed data in context
-    context.metadata["dns_transaction_id"] = dns_message_.header.id;
-    context.metadata["dns_is_query"] = is_query();
-    context.metadata["dns_is_response"] = is_response();
-    context.metadata["dns_question_count"] = dns_message_.header.qdcount;
-    context.metadata["dns_answer_count"] = dns_message_.header.ancount;
-    context.metadata["dns_response_code"] = static_cast<uint8_t>(get_response_code());
-    
-    if (!dns_message_.questions.empty()) {
-        context.metadata["dns_query_name"] = dns_message_.questions[0].qname;
-        context.metadata["dns_query_type"] = dns_message_.questions[0].qtype;
+    // Splits "www.example.com." into labels; a single trailing dot is ignored
+    inline std::string_view strip_root_dot(std::string_view dotted) noexcept {
+        if (!dotted.empty() && dotted.back() == '.') {
+            dotted.remove_suffix(1);
+        }
+        return dotted;
     }
+}
 
-    context.offset = offset;
-    return ParseResult::Success;
+// ---------------------------------------------------------------------------
+// DNSMessageView
+// ---------------------------------------------------------------------------
+
+void DNSMessageView::clear() noexcept {
+    buffer_ = BufferView{};
+    message_length_ = 0;
+    header_ = DNSHeader{};
+    questions_.clear();
+    answers_.clear();
+    authority_.clear();
+    additional_.clear();
 }
 
-ParseResult DNSParser::parse_header(const BufferView& buffer, size_t& offset) {
-    if (buffer.size() < offset + 12) {
-        return ParseResult::NeedMoreData;
+bool DNSMessageView::parse(const BufferView& buffer) noexcept {
+    clear();
+    if (buffer.size() < sizeof(DNSHeader)) {
+        return false;
     }
+    buffer_ = buffer;
 
-    const auto* header_ptr = reinterpret_cast<const DNSHeader*>(buffer.data() + offset);
-    
-    dns_message_.header.id = ntohs(header_ptr->id);
-    dns_message_.header.flags = ntohs(header_ptr->flags);
-    dns_message_.header.qdcount = ntohs(header_ptr->qdcount);
-    dns_message_.header.ancount = ntohs(header_ptr->ancount);
-    dns_message_.header.nscount = ntohs(header_ptr->nscount);
-    dns_message_.header.arcount = ntohs(header_ptr->arcount);
-
-    offset += sizeof(DNSHeader);
-    return ParseResult::Success;
-}
+    // New generation invalidates the suffix cache without touching it
+    if (++generation_ == 0) {
+        suffix_cache_.fill(SuffixEntry{});
+        generation_ = 1;
+    }
 
-ParseResult DNSParser::parse_questions(const BufferView& buffer, size_t& offset) {
-    dns_message_.questions.reserve(dns_message_.header.qdcount);
-    
-    for (uint16_t i = 0; i < dns_message_.header.qdcount; ++i) {
-        DNSQuestion question;
-        
-        // Parse domain name
-        question.qname = parse_domain_name(buffer, offset);
-        if (question.qname.empty()) {
-            return ParseResult::InvalidFormat;
+    header_.id = buffer.read_be16(0);
+    header_.flags = buffer.read_be16(2);
+    header_.qdcount = buffer.read_be16(4);
+    header_.ancount = buffer.read_be16(6);
+    header_.nscount = buffer.read_be16(8);
+    header_.arcount = buffer.read_be16(10);
+
+    try {
+        size_t offset = sizeof(DNSHeader);
+        for (uint16_t i = 0; i < header_.qdcount; ++i) {
+            DNSQuestionView question;
+            size_t end = 0;
+            if (!decode_name_at(offset, question.qname, end) || end + 4 > buffer.size()) {
+                return false;
+            }
+            question.qtype = buffer.read_be16(end);
+            question.qclass = buffer.read_be16(end + 2);
+            questions_.push_back(question);
+            offset = end + 4;
         }
 
-        // Parse question type and class
-        if (buffer.size() < offset + 4) {
-            return ParseResult::NeedMoreData;
+        if (!parse_records(offset, header_.ancount, answers_) ||
+            !parse_records(offset, header_.nscount, authority_) ||
+            !parse_records(offset, header_.arcount, additional_)) {
+            return false;
         }
 
-        question.qtype = ntohs(*reinterpret_cast<const uint16_t*>(buffer.data() + offset));
-        offset += 2;
-        question.qclass = ntohs(*reinterpret_cast<const uint16_t*>(buffer.data() + offset));
-        offset += 2;
+        message_length_ = offset;
+        return true;
 
-        dns_message_.questions.push_back(question);
+    } catch (const std::exception&) {
+        return false;
     }
-    
-    return ParseResult::Success;
 }
 
-ParseResult DNSParser::parse_resource_records(const BufferView& buffer, size_t& offset, 
-                                            std::vector<DNSResourceRecord>& records, uint16_t count) {
-    records.reserve(count);
-    
+bool DNSMessageView::parse_records(size_t& offset, uint16_t count, std::vector<DNSRecordView>& records) noexcept {
     for (uint16_t i = 0; i < count; ++i) {
-        DNSResourceRecord record;
-        
-        // Parse name
-        record.name = parse_domain_name(buffer, offset);
-        if (record.name.empty()) {
-            return ParseResult::InvalidFormat;
-        }
-
-        // Parse type, class, TTL, and data length
-        if (buffer.size() < offset + 10) {
-            return ParseResult::NeedMoreData;
+        DNSRecordView record;
+        size_t end = 0;
+        if (!decode_name_at(offset, record.name, end) || end + 10 > buffer_.size()) {
+            return false;
         }
 
-        record.type = ntohs(*reinterpret_cast<const uint16_t*>(buffer.data() + offset));
-        offset += 2;
-        record.rr_class = ntohs(*reinterpret_cast<const uint16_t*>(buffer.data() + offset));
-        offset += 2;
-        record.ttl = ntohl(*reinterpret_cast<const uint32_t*>(buffer.data() + offset));
-        offset += 4;
-        record.rdlength = ntohs(*reinterpret_cast<const uint16_t*>(buffer.data() + offset));
-        offset += 2;
-
-        // Parse resource data
-        if (buffer.size() < offset + record.rdlength) {
-            return ParseResult::NeedMoreData;
+        record.type = buffer_.read_be16(end);
+        record.rr_class = buffer_.read_be16(end + 2);
+        record.ttl = buffer_.read_be32(end + 4);
+        const uint16_t rdlength = buffer_.read_be16(end + 8);
+        const size_t rdata_offset = end + 10;
+        if (rdata_offset + rdlength > buffer_.size()) {
+            return false;
         }
 
-        record.rdata.resize(record.rdlength);
-        std::memcpy(record.rdata.data(), buffer.data() + offset, record.rdlength);
-        offset += record.rdlength;
-
+        record.rdata_offset = static_cast<uint16_t>(rdata_offset);
+        record.rdata = buffer_.substr(rdata_offset, rdlength);
         records.push_back(std::move(record));
+        offset = rdata_offset + rdlength;
     }
-
-    return ParseResult::Success;
+    return true;
 }
 
-std::string DNSParser::parse_domain_name(const BufferView& buffer, size_t& offset) const {
-    std::string domain_name;
+bool DNSMessageView::decode_name_at(size_t offset, DNSName& name, size_t& end) noexcept {
+    const uint8_t* data = buffer_.data();
+    const size_t size = buffer_.size();
+
+    // Labels read directly (not through the cache); recorded so their suffixes can be cached
+    std::array<uint16_t, kMaxLabels> label_offsets;
+    std::array<uint8_t, kMaxLabels> label_lengths;
+    size_t count = 0;
+    size_t label_bytes = 0;
+    uint8_t tail_labels = 0;
+    uint8_t tail_bytes = 0;
+
+    size_t pos = offset;
     bool jumped = false;
-    size_t original_offset = offset;
-    size_t max_jumps = 10; // Prevent infinite loops
-    size_t jump_count = 0;
-
-    while (offset < buffer.size()) {
-        uint8_t length = buffer.data()[offset];
-        
-        // Check for compression (pointer)
+    end = 0;
+
+    while (true) {
+        if (pos >= size) {
+            return false;
+        }
+        const uint8_t length = data[pos];
+
+        if (length == 0) {
+            if (!jumped) {
+                end = pos + 1;
+            }
+            break;
+        }
+
         if ((length & 0xC0) == 0xC0) {
-            if (offset + 1 >= buffer.size()) {
-                return "";
+            if (pos + 1 >= size) {
+                return false;
             }
-            
-            if (++jump_count > max_jumps) {
-                return ""; // Too many jumps, likely a loop
+            const size_t target = (static_cast<size_t>(length & 0x3F) << 8) | data[pos + 1];
+            // Only backward pointers are accepted, which rules out loops
+            if (target >= pos) {
+                return false;
             }
-            
-            uint16_t pointer = ((length & 0x3F) << 8) | buffer.data()[offset + 1];
             if (!jumped) {
-                original_offset = offset + 2;
+                end = pos + 2;
                 jumped = true;
             }
-            offset = pointer;
+            if (const auto* suffix = find_suffix(target)) {
+                tail_labels = suffix->labels;
+                tail_bytes = suffix->label_bytes;
+                ++cache_hits_;
+                break;
+            }
+            pos = target;
             continue;
         }
-        
-        // End of domain name
+
+        // 0x40/0x80 label types are obsolete or undefined
+        if ((length & 0xC0) != 0 || pos + 1 + length > size || count == kMaxLabels) {
+            return false;
+        }
+        label_offsets[count] = static_cast<uint16_t>(pos);
+        label_lengths[count] = length;
+        ++count;
+        label_bytes += length;
+        pos += 1 + length;
+    }
+
+    const size_t total_labels = count + tail_labels;
+    const size_t total_bytes = label_bytes + tail_bytes;
+    const size_t text_length = total_labels == 0 ? 0 : total_bytes + total_labels - 1;
+    if (total_labels > kMaxLabels || text_length > kMaxNameLength) {
+        return false;
+    }
+
+    // Every label position walked here now starts a known suffix
+    uint8_t suffix_labels = tail_labels;
+    uint8_t suffix_bytes = tail_bytes;
+    for (size_t i = count; i-- > 0;) {
+        ++suffix_labels;
+        suffix_bytes = static_cast<uint8_t>(suffix_bytes + label_lengths[i]);
+        remember_suffix(label_offsets[i], suffix_labels, suffix_bytes);
+    }
+
+    name.offset = static_cast<uint16_t>(offset);
+    name.labels = static_cast<uint8_t>(total_labels);
+    name.length = static_cast<uint8_t>(text_length);
+    return true;
+}
+
+const DNSMessageView::SuffixEntry* DNSMessageView::find_suffix(size_t offset) const noexcept {
+    const auto& entry = suffix_cache_[offset & (kCacheSize - 1)];
+    return (entry.generation == generation_ && entry.offset == offset) ? &entry : nullptr;
+}
+
+void DNSMessageView::remember_suffix(size_t offset, uint8_t labels, uint8_t label_bytes) noexcept {
+    auto& entry = suffix_cache_[offset & (kCacheSize - 1)];
+    entry.generation = generation_;
+    entry.offset = static_cast<uint16_t>(offset);
+    entry.labels = labels;
+    entry.label_bytes = label_bytes;
+}
+
+bool DNSMessageView::rdata_name(const DNSRecordView& record, DNSName& name) noexcept {
+    size_t skip = 0;
+    switch (record.type) {
+        case static_cast<uint16_t>(DNSRecordType::NS):
+        case static_cast<uint16_t>(DNSRecordType::CNAME):
+        case static_cast<uint16_t>(DNSRecordType::PTR):
+        case 39:    // DNAME
+            skip = 0;
+            break;
+        case static_cast<uint16_t>(DNSRecordType::MX):
+            skip = 2;
+            break;
+        case static_cast<uint16_t>(DNSRecordType::SRV):
+            skip = 6;
+            break;
+        default:
+            return false;
+    }
+
+    if (record.rdata.size() <= skip) {
+        return false;
+    }
+    size_t end = 0;
+    return decode_name_at(record.rdata_offset + skip, name, end) &&
+           end <= static_cast<size_t>(record.rdata_offset) + record.rdata.size();
+}
+
+bool DNSMessageView::next_label(size_t& pos, std::string_view& label) const noexcept {
+    const uint8_t* data = buffer_.data();
+    const size_t size = buffer_.size();
+
+    while (pos < size) {
+        const uint8_t length = data[pos];
         if (length == 0) {
-            offset++;
+            return false;
+        }
+        if ((length & 0xC0) == 0xC0) {
+            if (pos + 1 >= size) {
+                return false;
+            }
+            const size_t target = (static_cast<size_t>(length & 0x3F) << 8) | data[pos + 1];
+            if (target >= pos) {
+                return false;
+            }
+            pos = target;
+            continue;
+        }
+        if ((length & 0xC0) != 0 || pos + 1 + length > size) {
+            return false;
+        }
+        label = std::string_view(reinterpret_cast<const char*>(data + pos + 1), length);
+        pos += 1 + length;
+        return true;
+    }
+    return false;
+}
+
+bool DNSMessageView::name_equals(const DNSName& name, std::string_view dotted) const noexcept {
+    dotted = strip_root_dot(dotted);
+    if (dotted.size() != name.length) {
+        return false;
+    }
+
+    size_t pos = name.offset;
+    std::string_view label;
+    while (next_label(pos, label)) {
+        const size_t dot = dotted.find('.');
+        const std::string_view expected = dotted.substr(0, dot);
+        if (!label_equals(label, expected)) {
+            return false;
+        }
+        dotted = (dot == std::string_view::npos) ? std::string_view{} : dotted.substr(dot + 1);
+    }
+    return dotted.empty();
+}
+
+bool DNSMessageView::name_equals(const DNSName& lhs, const DNSName& rhs) const noexcept {
+    if (lhs.labels != rhs.labels || lhs.length != rhs.length) {
+        return false;
+    }
+
+    size_t lhs_pos = lhs.offset;
+    size_t rhs_pos = rhs.offset;
+    std::string_view lhs_label;
+    std::string_view rhs_label;
+    while (next_label(lhs_pos, lhs_label)) {
+        if (!next_label(rhs_pos, rhs_label) || !label_equals(lhs_label, rhs_label)) {
+            return false;
+        }
+    }
+    return !next_label(rhs_pos, rhs_label);
+}
+
+uint64_t DNSMessageView::name_hash(const DNSName& name) const noexcept {
+    uint64_t hash = kFnvOffsetBasis;
+    for_each_label(name, [&hash](std::string_view label) { hash = hash_label(hash, label); });
+    return hash;
+}
+
+uint64_t DNSMessageView::name_hash(std::string_view dotted) noexcept {
+    dotted = strip_root_dot(dotted);
+    uint64_t hash = kFnvOffsetBasis;
+    while (!dotted.empty()) {
+        const size_t dot = dotted.find('.');
+        hash = hash_label(hash, dotted.substr(0, dot));
+        if (dot == std::string_view::npos) {
             break;
         }
-        
-        // Regular label
-        if (offset + 1 + length >= buffer.size()) {
-            return "";
+        dotted.remove_prefix(dot + 1);
+    }
+    return hash;
+}
+
+size_t DNSMessageView::copy_name(const DNSName& name, char* out, size_t capacity) const noexcept {
+    if (capacity < name.length) {
+        return 0;
+    }
+
+    size_t written = 0;
+    for_each_label(name, [&](std::string_view label) {
+        if (written != 0) {
+            out[written++] = '.';
+        }
+        std::memcpy(out + written, label.data(), label.size());
+        written += label.size();
+    });
+    return written;
+}
+
+std::string DNSMessageView::name_to_string(const DNSName& name) const {
+    if (name.labels == 0) {
+        return ".";
+    }
+    std::string result(name.length, '\0');
+    result.resize(copy_name(name, result.data(), result.size()));
+    return result;
+}
+
+// ---------------------------------------------------------------------------
+// DNSParser
+// ---------------------------------------------------------------------------
+
+ParseResult DNSParser::parse(ParseContext& context) noexcept {
+    const BufferView& buffer = context.buffer;
+    if (buffer.size() < 12) {
+        return ParseResult::InvalidFormat;
+    }
+
+    dns_message_ready_ = false;
+    if (!message_view_.parse(buffer)) {
+        error_message_ = "Malformed DNS message";
+        return ParseResult::InvalidFormat;
+    }
+
+    try {
+        if (!zero_copy_) {
+            materialize_message();
         }
-        
-        if (!domain_name.empty()) {
-            domain_name += ".";
+
+        const auto& header = message_view_.header();
+
+        // Store parsed data in context
+        context.metadata["dns_transaction_id"] = header.id;
+        context.metadata["dns_is_query"] = is_query();
+        context.metadata["dns_is_response"] = is_response();
+        context.metadata["dns_question_count"] = header.qdcount;
+        context.metadata["dns_answer_count"] = header.ancount;
+        context.metadata["dns_response_code"] = static_cast<uint8_t>(get_response_code());
+
+        const auto& questions = message_view_.questions();
+        if (!questions.empty()) {
+            // The hash avoids materializing the name in zero-copy mode
+            if (zero_copy_) {
+                context.metadata["dns_query_name_hash"] = message_view_.name_hash(questions[0].qname);
+            } else {
+                context.metadata["dns_query_name"] = dns_message_.questions[0].qname;
+            }
+            context.metadata["dns_query_type"] = questions[0].qtype;
         }
-        
-        domain_name.append(reinterpret_cast<const char*>(buffer.data() + offset + 1), length);
-        offset += 1 + length;
+
+    } catch (const std::exception&) {
+        return ParseResult::InternalError;
+    }
+
+    context.offset = message_view_.message_length();
+    return ParseResult::Success;
+}
+
+const DNSMessage& DNSParser::get_dns_message() const {
+    if (!dns_message_ready_) {
+        materialize_message();
     }
+    return dns_message_;
+}
 
-    if (jumped) {
-        offset = original_offset;
+void DNSParser::materialize_message() const {
+    dns_message_.header = message_view_.header();
+
+    dns_message_.questions.clear();
+    dns_message_.questions.reserve(message_view_.questions().size());
+    for (const auto& view : message_view_.questions()) {
+        dns_message_.questions.push_back(DNSQuestion{message_view_.name_to_string(view.qname), view.qtype, view.qclass});
     }
 
-    return domain_name;
+    materialize_records(message_view_.answers(), dns_message_.answers);
+    materialize_records(message_view_.authority(), dns_message_.authority);
+    materialize_records(message_view_.additional(), dns_message_.additional);
+    dns_message_ready_ = true;
+}
+
+void DNSParser::materialize_records(const std::vector<DNSRecordView>& views,
+                                    std::vector<DNSResourceRecord>& records) const {
+    records.clear();
+    records.reserve(views.size());
+    for (const auto& view : views) {
+        DNSResourceRecord record;
+        record.name = message_view_.name_to_string(view.name);
+        record.type = view.type;
+        record.rr_class = view.rr_class;
+        record.ttl = view.ttl;
+        record.rdlength = static_cast<uint16_t>(view.rdata.size());
+        record.rdata.assign(view.rdata.data(), view.rdata.data() + view.rdata.size());
+        records.push_back(std::move(record));
+    }
 }
 
 bool DNSParser::validate_dns_packet(const BufferView& buffer) const {
@@ -217,31 +467,31 @@ bool DNSParser::validate_dns_packet(const BufferView& buffer) const {
 }
 
 bool DNSParser::is_query() const {
-    return (dns_message_.header.flags & 0x8000) == 0;
+    return (message_view_.header().flags & 0x8000) == 0;
 }
 
 bool DNSParser::is_response() const {
-    return (dns_message_.header.flags & 0x8000) != 0;
+    return (message_view_.header().flags & 0x8000) != 0;
 }
 
 DNSResponseCode DNSParser::get_response_code() const {
-    return static_cast<DNSResponseCode>(dns_message_.header.flags & 0x000F);
+    return static_cast<DNSResponseCode>(message_view_.header().flags & 0x000F);
 }
 
 bool DNSParser::is_recursive_desired() const {
-    return (dns_message_.header.flags & 0x0100) != 0;
+    return (message_view_.header().flags & 0x0100) != 0;
 }
 
 bool DNSParser::is_recursive_available() const {
-    return (dns_message_.header.flags & 0x0080) != 0;
+    return (message_view_.header().flags & 0x0080) != 0;
 }
 
 bool DNSParser::is_authoritative() const {
-    return (dns_message_.header.flags & 0x0400) != 0;
+    return (message_view_.header().flags & 0x0400) != 0;
 }
 
 bool DNSParser::is_truncated() const {
-    return (dns_message_.header.flags & 0x0200) != 0;
+    return (message_view_.header().flags & 0x0200) != 0;
 }
 
 std::string DNSParser::record_type_to_string(uint16_t type) const {
@@ -291,7 +541,9 @@ double DNSParser::get_progress() const noexcept {
 }
 
 void DNSParser::reset() noexcept {
+    message_view_.clear();
     dns_message_ = DNSMessage{};
+    dns_message_ready_ = false;
     error_message_.clear();
 }
 
@@ -0,0 +1,341 @@
+#include "parsers/application/dns_transaction_tracker.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+
+namespace protocol_parser::parsers {
+
+namespace {
+    constexpr size_t kMinCapacity = 64;
+
+    inline uint64_t mix64(uint64_t value) noexcept {
+        value ^= value >> 33;
+        value *= 0xff51afd7ed558ccdULL;
+        value ^= value >> 33;
+        value *= 0xc4ceb9fe1a85ec53ULL;
+        value ^= value >> 33;
+        return value;
+    }
+
+    inline uint64_t address_hash(const core::FlowAddress& address) noexcept {
+        uint64_t high = 0;
+        uint64_t low = 0;
+        std::memcpy(&high, address.bytes.data(), sizeof(high));
+        std::memcpy(&low, address.bytes.data() + sizeof(high), sizeof(low));
+        return mix64(high ^ mix64(low));
+    }
+
+    inline bool is_response(const DNSHeader& header) noexcept {
+        return (header.flags & 0x8000) != 0;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// DNSLatencyHistogram
+// ---------------------------------------------------------------------------
+
+size_t DNSLatencyHistogram::bucket_index(uint64_t value) noexcept {
+    if (value < kSubBuckets) {
+        return static_cast<size_t>(value);
+    }
+    const unsigned magnitude = static_cast<unsigned>(std::bit_width(value)) - 1;
+    if (magnitude >= kMaxMagnitude) {
+        return kBucketCount - 1;
+    }
+    const size_t sub_bucket = static_cast<size_t>(value >> (magnitude - kSubBucketBits)) & (kSubBuckets - 1);
+    return (magnitude - kSubBucketBits + 1) * kSubBuckets + sub_bucket;
+}
+
+uint64_t DNSLatencyHistogram::bucket_lower_bound(size_t index) noexcept {
+    if (index < kSubBuckets) {
+        return index;
+    }
+    const unsigned magnitude = static_cast<unsigned>(index / kSubBuckets) + kSubBucketBits - 1;
+    const uint64_t sub_bucket = index % kSubBuckets;
+    return (kSubBuckets + sub_bucket) << (magnitude - kSubBucketBits);
+}
+
+uint64_t DNSLatencyHistogram::bucket_upper_bound(size_t index) noexcept {
+    return index + 1 < kBucketCount ? bucket_lower_bound(index + 1) - 1 : UINT64_MAX;
+}
+
+void DNSLatencyHistogram::record(uint64_t value) noexcept {
+    ++buckets_[bucket_index(value)];
+    ++count_;
+    sum_ += value;
+    min_ = std::min(min_, value);
+    max_ = std::max(max_, value);
+}
+
+void DNSLatencyHistogram::merge(const DNSLatencyHistogram& other) noexcept {
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        buckets_[i] += other.buckets_[i];
+    }
+    count_ += other.count_;
+    sum_ += other.sum_;
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+}
+
+uint64_t DNSLatencyHistogram::percentile(double percent) const noexcept {
+    if (count_ == 0) {
+        return 0;
+    }
+    const double clamped = std::clamp(percent, 0.0, 100.0);
+    const uint64_t target = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(clamped / 100.0 * count_)));
+
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        cumulative += buckets_[i];
+        if (cumulative >= target) {
+            return std::min(bucket_upper_bound(i), max_);
+        }
+    }
+    return max_;
+}
+
+// ---------------------------------------------------------------------------
+// DNSTransactionTracker
+// ---------------------------------------------------------------------------
+
+DNSTransactionTracker::DNSTransactionTracker() : DNSTransactionTracker(Config{}) {}
+
+DNSTransactionTracker::DNSTransactionTracker(const Config& config) : config_(config) {
+    const size_t capacity = std::bit_ceil(std::max(config_.capacity, kMinCapacity));
+    slots_.resize(capacity);
+    mask_ = capacity - 1;
+}
+
+void DNSTransactionTracker::reset() {
+    std::fill(slots_.begin(), slots_.end(), Slot{});
+    pending_ = 0;
+    sweep_cursor_ = 0;
+    stats_ = Statistics{};
+    latency_.reset();
+    for (auto& histogram : rcode_latency_) {
+        histogram.reset();
+    }
+    servers_.clear();
+}
+
+size_t DNSTransactionTracker::ServerKeyHash::operator()(const ServerKey& key) const noexcept {
+    return static_cast<size_t>(mix64(address_hash(key.address) ^ key.port));
+}
+
+uint64_t DNSTransactionTracker::hash_key(const core::FlowAddress& client_ip, const core::FlowAddress& server_ip,
+                                         uint16_t client_port, uint16_t id, uint64_t name_hash) noexcept {
+    uint64_t hash = mix64(address_hash(client_ip) ^ (address_hash(server_ip) << 1));
+    hash = mix64(hash ^ ((static_cast<uint64_t>(client_port) << 16) | id));
+    return mix64(hash ^ name_hash);
+}
+
+size_t DNSTransactionTracker::find_slot(const Slot& probe) const noexcept {
+    for (size_t index = probe.hash & mask_;; index = (index + 1) & mask_) {
+        const Slot& slot = slots_[index];
+        if (!slot.occupied) {
+            return slots_.size();
+        }
+        if (slot.hash == probe.hash && slot.client_ip == probe.client_ip && slot.server_ip == probe.server_ip &&
+            slot.client_port == probe.client_port && slot.id == probe.id && slot.name_hash == probe.name_hash) {
+            return index;
+        }
+    }
+}
+
+void DNSTransactionTracker::erase_slot(size_t index) noexcept {
+    // Backward-shift deletion keeps probe chains intact without tombstones
+    size_t hole = index;
+    for (size_t next = (hole + 1) & mask_; slots_[next].occupied; next = (next + 1) & mask_) {
+        const size_t home = slots_[next].hash & mask_;
+        // Move the entry unless its home lies cyclically in (hole, next]
+        const bool stays = (hole <= next) ? (home > hole && home <= next) : (home > hole || home <= next);
+        if (!stays) {
+            slots_[hole] = slots_[next];
+            hole = next;
+        }
+    }
+    slots_[hole] = Slot{};
+    --pending_;
+}
+
+DNSTransactionTracker::ServerStatistics* DNSTransactionTracker::server_stats(const core::FlowAddress& ip, uint16_t port,
+                                                                           bool create) {
+    const ServerKey key{ip, port};
+    auto it = servers_.find(key);
+    if (it != servers_.end()) {
+        return &it->second;
+    }
+    if (!create || servers_.size() >= config_.max_servers) {
+        return nullptr;
+    }
+    return &servers_[key];
+}
+
+const DNSTransactionTracker::ServerStatistics* DNSTransactionTracker::find_server(const core::FlowAddress& ip,
+                                                                                 uint16_t port) const noexcept {
+    auto it = servers_.find(ServerKey{ip, port});
+    return it != servers_.end() ? &it->second : nullptr;
+}
+
+void DNSTransactionTracker::process_message(const DNSMessageView& message, const core::FlowAddress& src_ip,
+                                            const core::FlowAddress& dst_ip, uint16_t src_port, uint16_t dst_port, uint64_t timestamp_us, bool tcp) {
+    const auto& header = message.header();
+    const bool response = is_response(header);
+
+    Slot probe;
+    probe.client_ip = response ? dst_ip : src_ip;
+    probe.server_ip = response ? src_ip : dst_ip;
+    probe.client_port = response ? dst_port : src_port;
+    probe.server_port = response ? src_port : dst_port;
+    probe.id = header.id;
+    if (!message.questions().empty()) {
+        probe.name_hash = message.name_hash(message.questions()[0].qname);
+        probe.qtype = message.questions()[0].qtype;
+    }
+    probe.hash = hash_key(probe.client_ip, probe.server_ip, probe.client_port, probe.id, probe.name_hash);
+    probe.query_time_us = timestamp_us;
+    probe.tcp = tcp;
+
+    if (!response) {
+        ++stats_.queries;
+        if (auto* server = server_stats(probe.server_ip, probe.server_port, true)) {
+            ++server->queries;
+        }
+
+        if (find_slot(probe) != slots_.size()) {
+            ++stats_.retransmissions;   // Keep the first send time: that is what the client waits from
+        } else if (pending_ >= slots_.size() - slots_.size() / 4) {
+            ++stats_.dropped_queries;
+        } else {
+            size_t index = probe.hash & mask_;
+            while (slots_[index].occupied) {
+                index = (index + 1) & mask_;
+            }
+            probe.occupied = true;
+            slots_[index] = probe;
+            ++pending_;
+        }
+    } else {
+        ++stats_.responses;
+        auto* server = server_stats(probe.server_ip, probe.server_port, false);
+        if (server != nullptr) {
+            ++server->responses;
+        }
+
+        const size_t index = find_slot(probe);
+        if (index == slots_.size()) {
+            ++stats_.unmatched_responses;
+        } else {
+            const Slot& query = slots_[index];
+            const uint64_t latency = timestamp_us > query.query_time_us ? timestamp_us - query.query_time_us : 0;
+            const uint8_t rcode = static_cast<uint8_t>(header.flags & 0x000F);
+
+            ++stats_.matched;
+            latency_.record(latency);
+            rcode_latency_[rcode].record(latency);
+            if (server != nullptr) {
+                server->latency.record(latency);
+            }
+
+            if (callback_) {
+                DNSTransaction transaction;
+                transaction.client_ip = query.client_ip;
+                transaction.server_ip = query.server_ip;
+                transaction.client_port = query.client_port;
+                transaction.server_port = query.server_port;
+                transaction.id = query.id;
+                transaction.qtype = query.qtype;
+                transaction.name_hash = query.name_hash;
+                transaction.query_time_us = query.query_time_us;
+                transaction.latency_us = latency;
+                transaction.rcode = rcode;
+                transaction.answered = true;
+                transaction.tcp = query.tcp || tcp;
+                callback_(transaction, &message);
+            }
+            erase_slot(index);
+        }
+    }
+
+    sweep(timestamp_us, config_.sweep_step);
+}
+
+bool DNSTransactionTracker::process_datagram(const BufferView& payload, const core::FlowAddress& src_ip,
+                                             const core::FlowAddress& dst_ip, uint16_t src_port, uint16_t dst_port, uint64_t timestamp_us) {
+    if (!scratch_view_.parse(payload)) {
+        ++stats_.malformed;
+        return false;
+    }
+    process_message(scratch_view_, src_ip, dst_ip, src_port, dst_port, timestamp_us, false);
+    return true;
+}
+
+size_t DNSTransactionTracker::process_tcp_stream(core::TcpReassembler& reassembler, const core::FlowAddress& src_ip,
+                                                 const core::FlowAddress& dst_ip, uint16_t src_port, uint16_t dst_port,
+                                                 uint64_t timestamp_us) {
+    size_t processed = 0;
+
+    while (true) {
+        const BufferView data = reassembler.get_data();
+        if (data.size() < 2) {
+            break;
+        }
+        const size_t length = data.read_be16(0);
+        if (data.size() < 2 + length) {
+            break;   // Rest of the message has not arrived yet
+        }
+
+        if (scratch_view_.parse(data.substr(2, length))) {
+            ++stats_.tcp_messages;
+            process_message(scratch_view_, src_ip, dst_ip, src_port, dst_port, timestamp_us, true);
+            ++processed;
+        } else {
+            ++stats_.malformed;
+        }
+        reassembler.consume(2 + length);
+    }
+
+    return processed;
+}
+
+void DNSTransactionTracker::time_out(size_t index) {
+    const Slot& query = slots_[index];
+    ++stats_.unanswered;
+    if (auto* server = server_stats(query.server_ip, query.server_port, false)) {
+        ++server->unanswered;
+    }
+
+    if (callback_) {
+        DNSTransaction transaction;
+        transaction.client_ip = query.client_ip;
+        transaction.server_ip = query.server_ip;
+        transaction.client_port = query.client_port;
+        transaction.server_port = query.server_port;
+        transaction.id = query.id;
+        transaction.qtype = query.qtype;
+        transaction.name_hash = query.name_hash;
+        transaction.query_time_us = query.query_time_us;
+        transaction.tcp = query.tcp;
+        callback_(transaction, nullptr);
+    }
+    erase_slot(index);
+}
+
+void DNSTransactionTracker::sweep(uint64_t now_us, size_t budget) {
+    for (size_t checked = 0; checked < budget && pending_ > 0; ++checked) {
+        const Slot& slot = slots_[sweep_cursor_];
+        if (slot.occupied && now_us >= slot.query_time_us && now_us - slot.query_time_us >= config_.timeout_us) {
+            // Deletion may shift a later entry into this slot, so look at it again
+            time_out(sweep_cursor_);
+            continue;
+        }
+        sweep_cursor_ = (sweep_cursor_ + 1) & mask_;
+    }
+}
+
+void DNSTransactionTracker::expire(uint64_t now_us) {
+    sweep(now_us, slots_.size() + pending_);
+}
+
+} // namespace protocol_parser::parsers
@@ -5,7 +5,57 @@
 
 namespace protocol_parser::parsers {
 
+namespace {
+    constexpr std::string_view kDataProtocol = "FTP-DATA";
+
+    // Decimal number of at most max_digits digits not exceeding limit; advances pos
+    bool read_number(std::string_view text, size_t& pos, size_t max_digits, uint32_t limit, uint32_t& value) noexcept {
+        const size_t start = pos;
+        value = 0;
+        while (pos < text.size() && pos - start < max_digits && std::isdigit(static_cast<unsigned char>(text[pos]))) {
+            value = value * 10 + static_cast<uint32_t>(text[pos] - '0');
+            ++pos;
+        }
+        if (pos == start || value > limit) {
+            return false;
+        }
+        return pos == text.size() || !std::isdigit(static_cast<unsigned char>(text[pos]));
+    }
+
+    // count numbers of 0-255 separated by the given character
+    bool read_octets(std::string_view text, size_t& pos, char separator, size_t count, uint32_t* octets) noexcept {
+        for (size_t i = 0; i < count; ++i) {
+            if (i != 0) {
+                if (pos >= text.size() || text[pos] != separator) {
+                    return false;
+                }
+                ++pos;
+            }
+            if (!read_number(text, pos, 3, 255, octets[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+const ProtocolInfo& FTPParser::get_protocol_info() const noexcept {
+    static const ProtocolInfo info{
+        "FTP",          // name
+        21,             // type (port)
+        0,              // header_size: line based
+        3,              // min_packet_size: response code
+        65535
+    };
+    return info;
+}
+
+bool FTPParser::can_parse(const BufferView& buffer) const noexcept {
+    return buffer.size() >= 3 && validate_ftp_message(buffer);
+}
+
 ParseResult FTPParser::parse(ParseContext& context) noexcept {
+    data_endpoint_.reset();
     if (context.buffer.size() < 3) {
         return ParseResult::NeedMoreData;
     }
@@ -40,18 +90,150 @@ ParseResult FTPParser::parse(ParseContext& context) noexcept {
     }
     
     // Determine if this is a command or response
+    ParseResult result;
     if (std::isdigit(first_line[0]) && first_line.length() >= 3) {
         // Response (starts with 3-digit code)
         if (first_line.length() > 3 && first_line[3] == '-') {
             // Multiline response
-            return parse_multiline_response(context.buffer, 0);
+            result = parse_multiline_response(context.buffer, 0);
         } else {
-            return parse_response(first_line);
+            result = parse_response(first_line);
         }
     } else {
         // Command
-        return parse_command(first_line);
+        result = parse_command(first_line);
+    }
+    
+    if (result == ParseResult::Success) {
+        track_data_endpoint();
+    }
+    return result;
+}
+
+bool FTPParser::parse_host_port(std::string_view text, FTPDataEndpoint& out) noexcept {
+    // 227 replies wrap the numbers in free text, e.g. "Entering Passive Mode (h1,h2,h3,h4,p1,p2)"
+    for (size_t start = 0; start < text.size(); ++start) {
+        if (!std::isdigit(static_cast<unsigned char>(text[start])) ||
+            (start != 0 && std::isdigit(static_cast<unsigned char>(text[start - 1])))) {
+            continue;
+        }
+        size_t pos = start;
+        uint32_t fields[6];
+        if (!read_octets(text, pos, ',', 6, fields)) {
+            continue;
+        }
+        const uint32_t ip = (fields[0] << 24) | (fields[1] << 16) | (fields[2] << 8) | fields[3];
+        const auto port = static_cast<uint16_t>((fields[4] << 8) | fields[5]);
+        if (ip == 0 || port == 0) {
+            return false;
+        }
+        out.address = core::FlowAddress::from_ipv4(ip);
+        out.port = port;
+        return true;
+    }
+    return false;
+}
+
+bool FTPParser::parse_extended_port(std::string_view text, FTPDataEndpoint& out) noexcept {
+    // 229 replies carry the argument in parentheses: "Entering Extended Passive Mode (|||port|)"
+    size_t pos = text.find('(');
+    pos = pos == std::string_view::npos ? text.find_first_not_of(' ') : pos + 1;
+    if (pos == std::string_view::npos || pos >= text.size()) {
+        return false;
+    }
+    const char delimiter = text[pos++];
+    if (delimiter < 33 || delimiter > 126 || std::isdigit(static_cast<unsigned char>(delimiter))) {
+        return false;
+    }
+    
+    // Network protocol: empty, 1 (IPv4) or 2 (IPv6)
+    bool ipv6 = false;
+    if (pos < text.size() && (text[pos] == '1' || text[pos] == '2')) {
+        ipv6 = text[pos++] == '2';
+    }
+    if (pos >= text.size() || text[pos++] != delimiter) {
+        return false;
+    }
+    
+    core::FlowAddress address;
+    const size_t address_end = text.find(delimiter, pos);
+    if (address_end == std::string_view::npos) {
+        return false;
+    }
+    if (address_end != pos) {
+        if (ipv6) {
+            const auto literal = text.substr(pos, address_end - pos);
+            if (literal.find(':') == std::string_view::npos || !core::FlowAddress::from_text(literal, address)) {
+                return false;
+            }
+            pos = address_end;
+        } else {
+            uint32_t octets[4];
+            if (!read_octets(text, pos, '.', 4, octets)) {
+                return false;
+            }
+            address = core::FlowAddress::from_ipv4((octets[0] << 24) | (octets[1] << 16) | (octets[2] << 8) | octets[3]);
+        }
+    }
+    if (pos >= text.size() || text[pos++] != delimiter) {
+        return false;
+    }
+    
+    uint32_t port = 0;
+    if (!read_number(text, pos, 5, 65535, port) || port == 0) {
+        return false;
+    }
+    if (pos >= text.size() || text[pos] != delimiter) {
+        return false;
+    }
+    out.address = address;
+    out.port = static_cast<uint16_t>(port);
+    return true;
+}
+
+void FTPParser::track_data_endpoint() noexcept {
+    FTPDataEndpoint endpoint;
+    bool found = false;
+    if (ftp_message_.type == FTPMessageType::COMMAND) {
+        const auto& command = ftp_message_.command;
+        if (command.command == FTPCommand::PORT) {
+            found = parse_host_port(command.parameters, endpoint);
+        } else if (command.command == FTPCommand::EPRT) {
+            found = parse_extended_port(command.parameters, endpoint);
+        }
+    } else if (ftp_message_.type == FTPMessageType::RESPONSE) {
+        const auto& response = ftp_message_.response;
+        if (response.code == FTPResponseCode::PASSIVE_MODE) {
+            found = parse_host_port(response.message, endpoint);
+        } else if (response.code == FTPResponseCode::EXTENDED_PASSIVE_MODE) {
+            found = parse_extended_port(response.message, endpoint);
+        }
+        endpoint.passive = true;
+    }
+    if (!found) {
+        return;
+    }
+    data_endpoint_ = endpoint;
+    
+    if (!expected_flows_) {
+        return;
+    }
+    // Passive: the client connects to the server's endpoint (229 implies the control
+    // connection's server address, which also covers EPSV over IPv6). Active: the
+    // server connects back to the client
+    core::ExpectedFlow flow;
+    flow.protocol = kDataProtocol;
+    flow.session = control_flow_.session;
+    flow.port = endpoint.port;
+    flow.is_tcp = true;
+    if (endpoint.passive) {
+        flow.address = !endpoint.address.is_unspecified() ? endpoint.address : control_flow_.server;
+        flow.peer = control_flow_.client;
+    } else {
+        flow.address = !endpoint.address.is_unspecified() ? endpoint.address : control_flow_.client;
+        flow.peer = control_flow_.server;
     }
+    expected_flows_->expect(flow, now_us_);
 }
 
 ParseResult FTPParser::parse_command(const std::string& line) {
@@ -301,6 +483,8 @@ std::string FTPParser::command_to_string(FTPCommand cmd) const {
         case FTPCommand::AUTH: return "AUTH";
         case FTPCommand::PBSZ: return "PBSZ";
         case FTPCommand::PROT: return "PROT";
+        case FTPCommand::EPRT: return "EPRT";
+        case FTPCommand::EPSV: return "EPSV";
         default: return "UNKNOWN";
     }
 }
@@ -346,6 +530,8 @@ FTPCommand FTPParser::string_to_command(const std::string& cmd_str) const {
     if (upper_cmd == "AUTH") return FTPCommand::AUTH;
     if (upper_cmd == "PBSZ") return FTPCommand::PBSZ;
     if (upper_cmd == "PROT") return FTPCommand::PROT;
+    if (upper_cmd == "EPRT") return FTPCommand::EPRT;
+    if (upper_cmd == "EPSV") return FTPCommand::EPSV;
     
     return FTPCommand::UNKNOWN;
 }
@@ -368,6 +554,7 @@ std::string FTPParser::response_code_to_string(FTPResponseCode code) const {
         case FTPResponseCode::DATA_CONNECTION_OPEN_NO_TRANSFER: return "225 Data connection open, no transfer";
         case FTPResponseCode::DATA_CONNECTION_CLOSED: return "226 Data connection closed";
         case FTPResponseCode::PASSIVE_MODE: return "227 Entering passive mode";
+        case FTPResponseCode::EXTENDED_PASSIVE_MODE: return "229 Entering extended passive mode";
         case FTPResponseCode::USER_LOGGED_IN: return "230 User logged in";
         case FTPResponseCode::FILE_ACTION_OK: return "250 File action okay";
         case FTPResponseCode::PATHNAME_CREATED: return "257 Pathname created";
@@ -413,6 +600,7 @@ FTPResponseCode FTPParser::number_to_response_code(uint16_t code_num) const {
         case 225: return FTPResponseCode::DATA_CONNECTION_OPEN_NO_TRANSFER;
         case 226: return FTPResponseCode::DATA_CONNECTION_CLOSED;
         case 227: return FTPResponseCode::PASSIVE_MODE;
+        case 229: return FTPResponseCode::EXTENDED_PASSIVE_MODE;
         case 230: return FTPResponseCode::USER_LOGGED_IN;
         case 250: return FTPResponseCode::FILE_ACTION_OK;
         case 257: return FTPResponseCode::PATHNAME_CREATED;
@@ -486,6 +674,7 @@ void FTPParser::reset() noexcept {
         ftp_message_.response.~FTPResponseMessage();
     }
     ftp_message_.type = FTPMessageType::UNKNOWN;
+    data_endpoint_.reset();
     error_message_.clear();
 }
 
@@ -1,5 +1,7 @@
 #include "parsers/application/grpc_parser.hpp"
 #include <algorithm>
+#include <charconv>
+#include <chrono>
 #include <sstream>
 #include <string>
 #include <cstring>
@@ -15,38 +17,55 @@
 
 namespace ProtocolParser::Parsers::Application {
 
+using namespace protocol_parser::parsers;
+using protocol_parser::core::BufferView;
+
+namespace {
+    inline uint64_t monotonic_micros() noexcept {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    inline size_t direction_index(HTTP2Direction direction) noexcept {
+        return static_cast<size_t>(direction);
+    }
+}
+
 GRPCParser::GRPCParser() : BaseParser() {
-    // gRPC解析器初始化
+    HTTP2Demuxer::Handlers handlers;
+    handlers.on_headers = [this](HTTP2Direction direction, uint32_t stream_id,
+                                 std::span<const HPACKHeader> fields, bool end_stream) {
+        on_headers(direction, stream_id, fields, end_stream);
+    };
+    handlers.on_data = [this](HTTP2Direction direction, uint32_t stream_id,
+                              std::span<const uint8_t> data, bool) {
+        on_data(direction, stream_id, data);
+    };
+    handlers.on_stream_reset = [this](uint32_t stream_id, uint32_t) { finish_call(stream_id, true); };
+    handlers.on_stream_closed = [this](uint32_t stream_id) { finish_call(stream_id, false); };
+    demuxer_.set_handlers(std::move(handlers));
 }
 
 ParseResult GRPCParser::parse(ParseContext& context) noexcept {
-    const auto& buffer = context.buffer;
-    
-    if (buffer.size() < 9) { // HTTP/2最小帧大小
+    if (context.offset >= context.buffer.size()) {
         return ParseResult::NeedMoreData;
     }
 
     try {
-        GRPCMessage message;
-        
-        // 检测HTTP/2连接前导
-        if (is_http2_preface(buffer)) {
-            return ParseResult::Success; // 连接前导解析成功
-        }
-        
-        // 检测是否为gRPC流量
-        if (!is_grpc_traffic(buffer)) {
-            return ParseResult::InvalidFormat;
+        const auto data = context.buffer.substr(context.offset);
+
+        // 连接前导只由客户端发送
+        if (is_http2_preface(data)) {
+            direction_ = HTTP2Direction::CLIENT_TO_SERVER;
         }
-        
-        // 解析HTTP/2帧
-        auto result = parse_http2_frame(buffer, message);
+
+        // 不完整的帧由解复用器缓存，片段总是被整体消费
+        auto result = demuxer_.feed(direction_, data);
         if (result == ParseResult::Success) {
-            collect_metrics(message);
+            context.offset = context.buffer.size();
         }
-        
         return result;
-        
+
     } catch (const std::exception&) {
         return ParseResult::InternalError;
     }
@@ -70,6 +89,18 @@ bool GRPCParser::can_parse(const BufferView& buffer) const noexcept {
 void GRPCParser::reset() noexcept {
     // 重置解析器状态
     metrics_ = GRPCMetrics{};
+    demuxer_.reset();
+    calls_.clear();
+    direction_ = HTTP2Direction::CLIENT_TO_SERVER;
+}
+
+std::string GRPCParser::get_error_message() const noexcept {
+    return demuxer_.get_error_message();
+}
+
+const GRPCCall* GRPCParser::find_call(uint32_t stream_id) const noexcept {
+    const auto* state = calls_.find(stream_id);
+    return state ? &state->call : nullptr;
 }
 
 bool GRPCParser::is_grpc_traffic(const protocol_parser::core::BufferView& buffer) const {
@@ -80,7 +111,6 @@ bool GRPCParser::is_grpc_traffic(const protocol_parser::core::BufferView& buffer
     // 检查HTTP/2帧头格式
     uint32_t length = (buffer[0] << 16) | (buffer[1] << 8) | buffer[2];
     uint8_t type = buffer[3];
-    uint8_t flags = buffer[4];
     uint32_t stream_id = ntohl(*reinterpret_cast<const uint32_t*>(buffer.data() + 5)) & 0x7FFFFFFF;
     
     // 基本有效性检查
@@ -337,26 +367,13 @@ GRPCCompression GRPCParser::detect_compression(const std::vector<uint8_t>& data)
     return GRPCCompression::NONE;
 }
 
-bool GRPCParser::is_protobuf_message(const std::vector<uint8_t>& data) const {
+bool GRPCParser::is_protobuf_message(std::span<const uint8_t> data) const {
     if (data.empty()) {
         return false;
     }
     
-    // Protocol Buffers使用varint编码
-    // 检查第一个字节是否为有效的字段标识符
-    uint8_t first_byte = data[0];
-    
-    // 字段号不能为0，且wire type必须有效
-    uint32_t field_number = first_byte >> 3;
-    uint32_t wire_type = first_byte & 0x07;
-    
-    if (field_number == 0 || wire_type > 5) {
-        return false;
-    }
-    
-    // 简单启发式：检查是否包含典型的protobuf模式
-    // 这是一个简化的检测，实际应该更复杂
-    return true;
+    // 无模式时只能验证线格式：每个标签、长度与定长值都必须恰好落在消息内
+    return ProtobufScanner::is_valid_message(data);
 }
 
 bool GRPCParser::extract_service_method(const std::string& path, 
@@ -495,73 +512,47 @@ ParseResult GRPCParser::parse_frame_header(const protocol_parser::core::BufferVi
 
 ParseResult GRPCParser::simple_hpack_decode(const std::vector<uint8_t>& data, 
                                            GRPCHeaders& headers) const {
-    // 这是一个极简的HPACK解码实现
-    // 实际的HPACK实现要复杂得多，包括动态表、霍夫曼编码等
+    // 独立的头部块没有连接上下文，只能解析静态表与字面量表示
+    HPACKDecoder decoder;
+    std::vector<HPACKHeader> fields;
+    if (!decoder.decode(data, fields)) {
+        return ParseResult::InvalidFormat;
+    }
     
-    size_t offset = 0;
-    while (offset < data.size()) {
-        uint8_t byte = data[offset++];
+    apply_headers(fields, headers);
+    return ParseResult::Success;
+}
+
+void GRPCParser::apply_headers(std::span<const HPACKHeader> fields, GRPCHeaders& headers) const {
+    // HTTP/2 要求头部名称为小写，无需再做大小写转换
+    for (const auto& field : fields) {
+        const auto name = field.name;
+        const auto value = field.value;
         
-        // 简化处理：假设是字面量头部字段
-        if ((byte & 0x40) == 0x40) { // 字面量头部字段，增量索引
-            // 跳过索引部分（简化）
-            if (byte & 0x3F) {
-                // 有索引值，跳过
-            }
-            
-            // 读取名称长度和名称（简化）
-            if (offset >= data.size()) break;
-            uint8_t name_len = data[offset++] & 0x7F;
-            if (offset + name_len > data.size()) break;
-            
-            std::string name(reinterpret_cast<const char*>(data.data() + offset), name_len);
-            offset += name_len;
-            
-            // 读取值长度和值（简化）
-            if (offset >= data.size()) break;
-            uint8_t value_len = data[offset++] & 0x7F;
-            if (offset + value_len > data.size()) break;
-            
-            std::string value(reinterpret_cast<const char*>(data.data() + offset), value_len);
-            offset += value_len;
-            
-            // 处理伪头部
-            if (name[0] == ':') {
-                parse_pseudo_header(name, value, headers);
-            } else {
-                // 处理普通头部
-                std::string lower_name = name;
-                std::transform(lower_name.begin(), lower_name.end(), lower_name.begin(), ::tolower);
-                
-                if (lower_name == "content-type") {
-                    headers.content_type = value;
-                } else if (lower_name == "user-agent") {
-                    headers.user_agent = value;
-                } else if (lower_name == "grpc-encoding") {
-                    headers.grpc_encoding = value;
-                } else if (lower_name == "grpc-accept-encoding") {
-                    headers.grpc_accept_encoding = value;
-                } else if (lower_name == "grpc-timeout") {
-                    headers.grpc_timeout = value;
-                } else if (lower_name == "grpc-status") {
-                    headers.grpc_status = value;
-                } else if (lower_name == "grpc-message") {
-                    headers.grpc_message = value;
-                } else {
-                    headers.custom_headers[name] = value;
-                }
-            }
+        if (!name.empty() && name[0] == ':') {
+            parse_pseudo_header(name, value, headers);
+        } else if (name == "content-type") {
+            headers.content_type = value;
+        } else if (name == "user-agent") {
+            headers.user_agent = value;
+        } else if (name == "grpc-encoding") {
+            headers.grpc_encoding = value;
+        } else if (name == "grpc-accept-encoding") {
+            headers.grpc_accept_encoding = value;
+        } else if (name == "grpc-timeout") {
+            headers.grpc_timeout = value;
+        } else if (name == "grpc-status") {
+            headers.grpc_status = value;
+        } else if (name == "grpc-message") {
+            headers.grpc_message = value;
         } else {
-            // 其他类型的头部字段，简化处理
-            break;
+            headers.custom_headers[std::string(name)] = value;
         }
     }
-    
-    return ParseResult::Success;
 }
 
-void GRPCParser::parse_pseudo_header(const std::string& name, 
-                                    const std::string& value, 
+void GRPCParser::parse_pseudo_header(std::string_view name,
+                                    std::string_view value,
                                     GRPCHeaders& headers) const {
     if (name == ":method") {
         headers.method = value;
@@ -572,7 +563,7 @@ void GRPCParser::parse_pseudo_header(const std::string& name,
     }
 }
 
-GRPCStreamType GRPCParser::detect_stream_type(const GRPCHeaders& headers) const {
+GRPCStreamType GRPCParser::detect_stream_type([[maybe_unused]] const GRPCHeaders& headers) const {
     // 基于头部信息简单推断流类型
     // 实际的流类型检测需要分析多个消息
     
@@ -598,4 +589,165 @@ void GRPCParser::collect_metrics(const GRPCMessage& message) const {
     }
 }
 
+GRPCParser::CallState& GRPCParser::track_call(uint32_t stream_id) {
+    // 与解复用器的流表保持同样的上限，丢弃只观测到一端的旧调用
+    if (calls_.find(stream_id) == nullptr && calls_.size() >= HTTP2Demuxer::kMaxTrackedStreams) {
+        calls_.erase(calls_.begin()->first);
+    }
+    
+    auto& state = calls_.get_or_insert(stream_id);
+    if (state.call.start_time == 0) {
+        state.call.stream_id = stream_id;
+        state.call.start_time = monotonic_micros();
+        metrics_.concurrent_streams = static_cast<uint32_t>(calls_.size());
+    }
+    return state;
+}
+
+void GRPCParser::on_headers(HTTP2Direction direction, uint32_t stream_id,
+                            std::span<const HPACKHeader> fields, bool) {
+    auto& call = track_call(stream_id).call;
+    
+    if (direction == HTTP2Direction::CLIENT_TO_SERVER) {
+        apply_headers(fields, call.request_headers);
+        call.is_client_to_server = true;
+        if (call.service.empty() && !call.request_headers.path.empty()) {
+            extract_service_method(call.request_headers.path, call.service, call.method);
+        }
+        return;
+    }
+    
+    // 响应头与尾部（trailers）都落在 response_headers，grpc-status 一般在尾部
+    apply_headers(fields, call.response_headers);
+    const auto& status = call.response_headers.grpc_status;
+    if (!status.empty()) {
+        uint32_t code = 0;
+        const auto [ptr, ec] = std::from_chars(status.data(), status.data() + status.size(), code);
+        call.status_code = (ec == std::errc{} && code <= static_cast<uint32_t>(GRPCStatusCode::UNAUTHENTICATED))
+                               ? static_cast<GRPCStatusCode>(code) : GRPCStatusCode::UNKNOWN;
+        call.status_message = call.response_headers.grpc_message;
+    }
+}
+
+void GRPCParser::on_data(HTTP2Direction direction, uint32_t stream_id, std::span<const uint8_t> data) {
+    auto& state = track_call(stream_id);
+    auto& call = state.call;
+    auto& framer = state.framers[direction_index(direction)];
+    const bool request = direction == HTTP2Direction::CLIENT_TO_SERVER;
+    auto& payload = request ? call.request_payload : call.response_payload;
+    (request ? call.request_size : call.response_size) += data.size();
+    
+    // 5 字节前缀（压缩标志 + 大端长度）可能跨 DATA 帧切分
+    while (!data.empty()) {
+        if (framer.prefix_bytes < framer.prefix.size()) {
+            const size_t take = std::min(framer.prefix.size() - framer.prefix_bytes, data.size());
+            std::memcpy(framer.prefix.data() + framer.prefix_bytes, data.data(), take);
+            framer.prefix_bytes += static_cast<uint8_t>(take);
+            data = data.subspan(take);
+            if (framer.prefix_bytes < framer.prefix.size()) {
+                break;
+            }
+            
+            framer.remaining = (static_cast<uint32_t>(framer.prefix[1]) << 24) |
+                               (static_cast<uint32_t>(framer.prefix[2]) << 16) |
+                               (static_cast<uint32_t>(framer.prefix[3]) << 8) | framer.prefix[4];
+            framer.messages++;
+            call.message_count++;
+            
+            // 只投影每个方向的第一个消息，在其载荷的首段到达时进行（前缀可能恰好结束于 DATA 帧末尾）；
+            // 跨 DATA 帧的消息只扫描首段
+            const bool compressed = (framer.prefix[0] & 0x01) != 0;
+            framer.projection_pending = framer.messages == 1 && !compressed && framer.remaining != 0 &&
+                                        projection_.slot_count() > 0;
+            if (framer.remaining == 0) {
+                framer.prefix_bytes = 0;
+            }
+            continue;
+        }
+        
+        const size_t take = std::min<size_t>(framer.remaining, data.size());
+        if (framer.projection_pending) {
+            framer.projection_pending = false;
+            project_fields(data.first(take), request ? call.request_fields : call.response_fields);
+        }
+        if (payload.size() < MAX_CAPTURED_PAYLOAD) {
+            const size_t keep = std::min(take, MAX_CAPTURED_PAYLOAD - payload.size());
+            payload.insert(payload.end(), data.begin(), data.begin() + keep);
+        }
+        framer.remaining -= static_cast<uint32_t>(take);
+        data = data.subspan(take);
+        if (framer.remaining == 0) {
+            framer.prefix_bytes = 0;
+        }
+    }
+}
+
+void GRPCParser::project_fields(std::span<const uint8_t> message, std::vector<GRPCFieldValue>& out) {
+    if (projection_.extract(message, projected_) == 0) {
+        return;
+    }
+    
+    for (size_t slot = 0; slot < projected_.size(); ++slot) {
+        const auto& field = projected_[slot];
+        if (!field.valid()) {
+            continue;
+        }
+        auto& value = out.emplace_back();
+        value.slot = slot;
+        value.wire_type = field.wire_type;
+        value.value = field.value;
+        value.bytes.assign(field.as_string());
+    }
+}
+
+void GRPCParser::finish_call(uint32_t stream_id, bool reset) {
+    auto* state = calls_.find(stream_id);
+    if (state == nullptr) {
+        return;
+    }
+    
+    auto& call = state->call;
+    call.end_time = monotonic_micros();
+    call.reset = reset;
+    if (reset && call.response_headers.grpc_status.empty()) {
+        call.status_code = GRPCStatusCode::CANCELLED;
+    }
+    
+    // 按两端消息数推断流类型
+    const uint32_t requests = state->framers[direction_index(HTTP2Direction::CLIENT_TO_SERVER)].messages;
+    const uint32_t responses = state->framers[direction_index(HTTP2Direction::SERVER_TO_CLIENT)].messages;
+    if (requests > 1 && responses > 1) {
+        call.stream_type = GRPCStreamType::BIDIRECTIONAL;
+    } else if (requests > 1) {
+        call.stream_type = GRPCStreamType::CLIENT_STREAMING;
+    } else if (responses > 1) {
+        call.stream_type = GRPCStreamType::SERVER_STREAMING;
+    } else {
+        call.stream_type = GRPCStreamType::UNARY;
+    }
+    
+    metrics_.total_calls++;
+    if (!reset && call.status_code == GRPCStatusCode::OK) {
+        metrics_.successful_calls++;
+    } else {
+        metrics_.failed_calls++;
+    }
+    if (!call.method.empty()) {
+        metrics_.method_counts[call.method]++;
+    }
+    metrics_.status_counts[static_cast<uint32_t>(call.status_code)]++;
+    metrics_.total_request_bytes += call.request_size;
+    metrics_.total_response_bytes += call.response_size;
+    
+    const double latency = static_cast<double>(call.end_time - call.start_time);
+    metrics_.average_latency += (latency - metrics_.average_latency) / static_cast<double>(metrics_.total_calls);
+    
+    if (call_callback_) {
+        call_callback_(call);
+    }
+    
+    calls_.erase(stream_id);
+    metrics_.concurrent_streams = static_cast<uint32_t>(calls_.size());
+}
+
 } // namespace ProtocolParser::Parsers::Application
\ No newline at end of file
@@ -0,0 +1,549 @@
+#include "parsers/application/hpack_decoder.hpp"
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace protocol_parser::parsers {
+
+namespace {
+    struct StaticEntry {
+        std::string_view name;
+        std::string_view value;
+    };
+
+    // RFC 7541 附录 A
+    constexpr std::array<StaticEntry, 61> kStaticTable{{
+        {":authority", ""},
+        {":method", "GET"},
+        {":method", "POST"},
+        {":path", "/"},
+        {":path", "/index.html"},
+        {":scheme", "http"},
+        {":scheme", "https"},
+        {":status", "200"},
+        {":status", "204"},
+        {":status", "206"},
+        {":status", "304"},
+        {":status", "400"},
+        {":status", "404"},
+        {":status", "500"},
+        {"accept-charset", ""},
+        {"accept-encoding", "gzip, deflate"},
+        {"accept-language", ""},
+        {"accept-ranges", ""},
+        {"accept", ""},
+        {"access-control-allow-origin", ""},
+        {"age", ""},
+        {"allow", ""},
+        {"authorization", ""},
+        {"cache-control", ""},
+        {"content-disposition", ""},
+        {"content-encoding", ""},
+        {"content-language", ""},
+        {"content-length", ""},
+        {"content-location", ""},
+        {"content-range", ""},
+        {"content-type", ""},
+        {"cookie", ""},
+        {"date", ""},
+        {"etag", ""},
+        {"expect", ""},
+        {"expires", ""},
+        {"from", ""},
+        {"host", ""},
+        {"if-match", ""},
+        {"if-modified-since", ""},
+        {"if-none-match", ""},
+        {"if-range", ""},
+        {"if-unmodified-since", ""},
+        {"last-modified", ""},
+        {"link", ""},
+        {"location", ""},
+        {"max-forwards", ""},
+        {"proxy-authenticate", ""},
+        {"proxy-authorization", ""},
+        {"range", ""},
+        {"referer", ""},
+        {"refresh", ""},
+        {"retry-after", ""},
+        {"server", ""},
+        {"set-cookie", ""},
+        {"strict-transport-security", ""},
+        {"transfer-encoding", ""},
+        {"user-agent", ""},
+        {"vary", ""},
+        {"via", ""},
+        {"www-authenticate", ""}
+    }};
+
+    struct HuffmanCode {
+        uint32_t code;
+        uint8_t bits;
+    };
+
+    // RFC 7541 附录 B：符号 0-255 与 EOS(256) 的编码及位长
+    constexpr std::array<HuffmanCode, 257> kHuffmanCodes{{
+        {0x1ff8, 13}, {0x7fffd8, 23}, {0xfffffe2, 28}, {0xfffffe3, 28},
+        {0xfffffe4, 28}, {0xfffffe5, 28}, {0xfffffe6, 28}, {0xfffffe7, 28},
+        {0xfffffe8, 28}, {0xffffea, 24}, {0x3ffffffc, 30}, {0xfffffe9, 28},
+        {0xfffffea, 28}, {0x3ffffffd, 30}, {0xfffffeb, 28}, {0xfffffec, 28},
+        {0xfffffed, 28}, {0xfffffee, 28}, {0xfffffef, 28}, {0xffffff0, 28},
+        {0xffffff1, 28}, {0xffffff2, 28}, {0x3ffffffe, 30}, {0xffffff3, 28},
+        {0xffffff4, 28}, {0xffffff5, 28}, {0xffffff6, 28}, {0xffffff7, 28},
+        {0xffffff8, 28}, {0xffffff9, 28}, {0xffffffa, 28}, {0xffffffb, 28},
+        {0x14, 6}, {0x3f8, 10}, {0x3f9, 10}, {0xffa, 12},
+        {0x1ff9, 13}, {0x15, 6}, {0xf8, 8}, {0x7fa, 11},
+        {0x3fa, 10}, {0x3fb, 10}, {0xf9, 8}, {0x7fb, 11},
+        {0xfa, 8}, {0x16, 6}, {0x17, 6}, {0x18, 6},
+        {0x0, 5}, {0x1, 5}, {0x2, 5}, {0x19, 6},
+        {0x1a, 6}, {0x1b, 6}, {0x1c, 6}, {0x1d, 6},
+        {0x1e, 6}, {0x1f, 6}, {0x5c, 7}, {0xfb, 8},
+        {0x7ffc, 15}, {0x20, 6}, {0xffb, 12}, {0x3fc, 10},
+        {0x1ffa, 13}, {0x21, 6}, {0x5d, 7}, {0x5e, 7},
+        {0x5f, 7}, {0x60, 7}, {0x61, 7}, {0x62, 7},
+        {0x63, 7}, {0x64, 7}, {0x65, 7}, {0x66, 7},
+        {0x67, 7}, {0x68, 7}, {0x69, 7}, {0x6a, 7},
+        {0x6b, 7}, {0x6c, 7}, {0x6d, 7}, {0x6e, 7},
+        {0x6f, 7}, {0x70, 7}, {0x71, 7}, {0x72, 7},
+        {0xfc, 8}, {0x73, 7}, {0xfd, 8}, {0x1ffb, 13},
+        {0x7fff0, 19}, {0x1ffc, 13}, {0x3ffc, 14}, {0x22, 6},
+        {0x7ffd, 15}, {0x3, 5}, {0x23, 6}, {0x4, 5},
+        {0x24, 6}, {0x5, 5}, {0x25, 6}, {0x26, 6},
+        {0x27, 6}, {0x6, 5}, {0x74, 7}, {0x75, 7},
+        {0x28, 6}, {0x29, 6}, {0x2a, 6}, {0x7, 5},
+        {0x2b, 6}, {0x76, 7}, {0x2c, 6}, {0x8, 5},
+        {0x9, 5}, {0x2d, 6}, {0x77, 7}, {0x78, 7},
+        {0x79, 7}, {0x7a, 7}, {0x7b, 7}, {0x7ffe, 15},
+        {0x7fc, 11}, {0x3ffd, 14}, {0x1ffd, 13}, {0xffffffc, 28},
+        {0xfffe6, 20}, {0x3fffd2, 22}, {0xfffe7, 20}, {0xfffe8, 20},
+        {0x3fffd3, 22}, {0x3fffd4, 22}, {0x3fffd5, 22}, {0x7fffd9, 23},
+        {0x3fffd6, 22}, {0x7fffda, 23}, {0x7fffdb, 23}, {0x7fffdc, 23},
+        {0x7fffdd, 23}, {0x7fffde, 23}, {0xffffeb, 24}, {0x7fffdf, 23},
+        {0xffffec, 24}, {0xffffed, 24}, {0x3fffd7, 22}, {0x7fffe0, 23},
+        {0xffffee, 24}, {0x7fffe1, 23}, {0x7fffe2, 23}, {0x7fffe3, 23},
+        {0x7fffe4, 23}, {0x1fffdc, 21}, {0x3fffd8, 22}, {0x7fffe5, 23},
+        {0x3fffd9, 22}, {0x7fffe6, 23}, {0x7fffe7, 23}, {0xffffef, 24},
+        {0x3fffda, 22}, {0x1fffdd, 21}, {0xfffe9, 20}, {0x3fffdb, 22},
+        {0x3fffdc, 22}, {0x7fffe8, 23}, {0x7fffe9, 23}, {0x1fffde, 21},
+        {0x7fffea, 23}, {0x3fffdd, 22}, {0x3fffde, 22}, {0xfffff0, 24},
+        {0x1fffdf, 21}, {0x3fffdf, 22}, {0x7fffeb, 23}, {0x7fffec, 23},
+        {0x1fffe0, 21}, {0x1fffe1, 21}, {0x3fffe0, 22}, {0x1fffe2, 21},
+        {0x7fffed, 23}, {0x3fffe1, 22}, {0x7fffee, 23}, {0x7fffef, 23},
+        {0xfffea, 20}, {0x3fffe2, 22}, {0x3fffe3, 22}, {0x3fffe4, 22},
+        {0x7ffff0, 23}, {0x3fffe5, 22}, {0x3fffe6, 22}, {0x7ffff1, 23},
+        {0x3ffffe0, 26}, {0x3ffffe1, 26}, {0xfffeb, 20}, {0x7fff1, 19},
+        {0x3fffe7, 22}, {0x7ffff2, 23}, {0x3fffe8, 22}, {0x1ffffec, 25},
+        {0x3ffffe2, 26}, {0x3ffffe3, 26}, {0x3ffffe4, 26}, {0x7ffffde, 27},
+        {0x7ffffdf, 27}, {0x3ffffe5, 26}, {0xfffff1, 24}, {0x1ffffed, 25},
+        {0x7fff2, 19}, {0x1fffe3, 21}, {0x3ffffe6, 26}, {0x7ffffe0, 27},
+        {0x7ffffe1, 27}, {0x3ffffe7, 26}, {0x7ffffe2, 27}, {0xfffff2, 24},
+        {0x1fffe4, 21}, {0x1fffe5, 21}, {0x3ffffe8, 26}, {0x3ffffe9, 26},
+        {0xffffffd, 28}, {0x7ffffe3, 27}, {0x7ffffe4, 27}, {0x7ffffe5, 27},
+        {0xfffec, 20}, {0xfffff3, 24}, {0xfffed, 20}, {0x1fffe6, 21},
+        {0x3fffe9, 22}, {0x1fffe7, 21}, {0x1fffe8, 21}, {0x7ffff3, 23},
+        {0x3fffea, 22}, {0x3fffeb, 22}, {0x1ffffee, 25}, {0x1ffffef, 25},
+        {0xfffff4, 24}, {0xfffff5, 24}, {0x3ffffea, 26}, {0x7ffff4, 23},
+        {0x3ffffeb, 26}, {0x7ffffe6, 27}, {0x3ffffec, 26}, {0x3ffffed, 26},
+        {0x7ffffe7, 27}, {0x7ffffe8, 27}, {0x7ffffe9, 27}, {0x7ffffea, 27},
+        {0x7ffffeb, 27}, {0xffffffe, 28}, {0x7ffffec, 27}, {0x7ffffed, 27},
+        {0x7ffffee, 27}, {0x7ffffef, 27}, {0x7fffff0, 27}, {0x3ffffee, 26},
+        {0x3fffffff, 30}
+    }};
+
+    constexpr uint16_t kHuffmanEOS = 256;
+    constexpr size_t kHuffmanStates = 256;    // 257 个叶子的满二叉树恰有 256 个内部节点
+
+    enum HuffmanFlags : uint8_t {
+        kHuffmanEmit = 0x01,      // 本次半字节输出一个符号
+        kHuffmanFail = 0x02,      // 遇到 EOS，编码非法
+        kHuffmanAccept = 0x04     // 在此状态结束是合法的填充（不超过 7 位的全 1 前缀）
+    };
+
+    struct HuffmanTransition {
+        uint8_t next_state;
+        uint8_t flags;
+        uint8_t symbol;
+    };
+
+    using HuffmanDecodeTable = std::array<std::array<HuffmanTransition, 16>, kHuffmanStates>;
+
+    // 由编码表构建 Huffman 树，再展开为"状态 × 半字节"转移表；最短码长 5 位，每个半字节至多输出一个符号
+    const HuffmanDecodeTable& huffman_decode_table() {
+        static const auto table = [] {
+            // children[node][bit]：正数为内部节点，负数为 -(symbol + 1)，0 表示未分配（根节点不会作为子节点）
+            std::array<std::array<int16_t, 2>, kHuffmanStates> children{};
+            std::array<uint8_t, kHuffmanStates> depth{};
+            std::array<bool, kHuffmanStates> all_ones{};
+            all_ones[0] = true;
+            size_t node_count = 1;
+
+            for (uint16_t symbol = 0; symbol < kHuffmanCodes.size(); ++symbol) {
+                const auto& code = kHuffmanCodes[symbol];
+                size_t node = 0;
+                for (int bit_index = code.bits - 1; bit_index >= 0; --bit_index) {
+                    const int bit = (code.code >> bit_index) & 1;
+                    if (bit_index == 0) {
+                        children[node][bit] = static_cast<int16_t>(-(symbol + 1));
+                        break;
+                    }
+                    if (children[node][bit] == 0) {
+                        const size_t child = node_count++;
+                        children[node][bit] = static_cast<int16_t>(child);
+                        depth[child] = static_cast<uint8_t>(depth[node] + 1);
+                        all_ones[child] = all_ones[node] && bit == 1;
+                    }
+                    node = static_cast<size_t>(children[node][bit]);
+                }
+            }
+
+            HuffmanDecodeTable result{};
+            for (size_t state = 0; state < node_count; ++state) {
+                for (uint8_t nibble = 0; nibble < 16; ++nibble) {
+                    HuffmanTransition transition{};
+                    size_t node = state;
+                    for (int bit_index = 3; bit_index >= 0; --bit_index) {
+                        const int16_t child = children[node][(nibble >> bit_index) & 1];
+                        if (child < 0) {
+                            const uint16_t symbol = static_cast<uint16_t>(-child - 1);
+                            if (symbol == kHuffmanEOS) {
+                                transition.flags |= kHuffmanFail;
+                                break;
+                            }
+                            transition.flags |= kHuffmanEmit;
+                            transition.symbol = static_cast<uint8_t>(symbol);
+                            node = 0;
+                        } else {
+                            node = static_cast<size_t>(child);
+                        }
+                    }
+                    transition.next_state = static_cast<uint8_t>(node);
+                    if (all_ones[node] && depth[node] <= 7) {
+                        transition.flags |= kHuffmanAccept;
+                    }
+                    result[state][nibble] = transition;
+                }
+            }
+            return result;
+        }();
+        return table;
+    }
+
+    constexpr size_t kInitialRingCapacity = 64;
+}
+
+HPACKDecoder::HPACKDecoder(size_t max_table_size)
+    : max_table_size_(std::min(max_table_size, kMaxTableSizeLimit)),
+      settings_max_table_size_(std::min(max_table_size, kMaxTableSizeLimit)) {
+    entries_.resize(kInitialRingCapacity);
+    arena_.resize(2 * max_table_size_);
+}
+
+void HPACKDecoder::set_max_table_size(size_t size) {
+    settings_max_table_size_ = std::min(size, kMaxTableSizeLimit);
+    if (arena_.size() < 2 * settings_max_table_size_) {
+        // 仅在存活数据前移后扩容，保证条目偏移有效
+        std::memmove(arena_.data(), arena_.data() + arena_begin_, arena_end_ - arena_begin_);
+        for (size_t age = 0; age < entry_count_; ++age) {
+            auto& entry = entries_[(head_ - 1 - age) & (entries_.size() - 1)];
+            entry.offset -= static_cast<uint32_t>(arena_begin_);
+        }
+        arena_end_ -= arena_begin_;
+        arena_begin_ = 0;
+        arena_.resize(2 * settings_max_table_size_);
+    }
+}
+
+void HPACKDecoder::reset() noexcept {
+    head_ = 0;
+    entry_count_ = 0;
+    arena_begin_ = 0;
+    arena_end_ = 0;
+    table_size_ = 0;
+    max_table_size_ = settings_max_table_size_;
+    scratch_.clear();
+    pending_.clear();
+    error_message_.clear();
+}
+
+bool HPACKDecoder::decode(std::span<const uint8_t> block, std::vector<HPACKHeader>& out) {
+    out.clear();
+    scratch_.clear();
+    pending_.clear();
+
+    size_t pos = 0;
+    while (pos < block.size()) {
+        const uint8_t first = block[pos];
+        PendingField field;
+
+        if (first & 0x80) {
+            // 6.1 索引表示
+            uint64_t index = 0;
+            std::string_view name, value;
+            if (!decode_integer(block, pos, 7, index) || !lookup(index, name, value)) {
+                return false;
+            }
+            field.name_offset = static_cast<uint32_t>(scratch_.size());
+            field.name_length = static_cast<uint32_t>(name.size());
+            scratch_.append(name);
+            field.value_offset = static_cast<uint32_t>(scratch_.size());
+            field.value_length = static_cast<uint32_t>(value.size());
+            scratch_.append(value);
+            pending_.push_back(field);
+            continue;
+        }
+
+        if ((first & 0xE0) == 0x20) {
+            // 6.3 动态表大小更新，只能出现在头部块开头
+            uint64_t size = 0;
+            if (!pending_.empty()) {
+                error_message_ = "HPACK table size update after header field";
+                return false;
+            }
+            if (!decode_integer(block, pos, 5, size)) {
+                return false;
+            }
+            if (size > settings_max_table_size_) {
+                error_message_ = "HPACK table size update exceeds negotiated limit";
+                return false;
+            }
+            max_table_size_ = static_cast<size_t>(size);
+            evict_to(max_table_size_);
+            continue;
+        }
+
+        // 6.2 字面量表示：带增量索引（01）、不索引（0000）、永不索引（0001）
+        const bool incremental = (first & 0xC0) == 0x40;
+        field.never_indexed = (first & 0xF0) == 0x10;
+        const uint8_t prefix_bits = incremental ? 6 : 4;
+
+        uint64_t name_index = 0;
+        if (!decode_integer(block, pos, prefix_bits, name_index)) {
+            return false;
+        }
+
+        field.name_offset = static_cast<uint32_t>(scratch_.size());
+        if (name_index == 0) {
+            if (!decode_string(block, pos)) {
+                return false;
+            }
+        } else {
+            std::string_view name, value;
+            if (!lookup(name_index, name, value)) {
+                return false;
+            }
+            scratch_.append(name);
+        }
+        field.name_length = static_cast<uint32_t>(scratch_.size() - field.name_offset);
+
+        field.value_offset = static_cast<uint32_t>(scratch_.size());
+        if (!decode_string(block, pos)) {
+            return false;
+        }
+        field.value_length = static_cast<uint32_t>(scratch_.size() - field.value_offset);
+        pending_.push_back(field);
+
+        if (incremental) {
+            insert(std::string_view(scratch_).substr(field.name_offset, field.name_length),
+                   std::string_view(scratch_).substr(field.value_offset, field.value_length));
+        }
+    }
+
+    out.reserve(pending_.size());
+    const std::string_view storage(scratch_);
+    for (const auto& field : pending_) {
+        out.push_back({storage.substr(field.name_offset, field.name_length),
+                       storage.substr(field.value_offset, field.value_length),
+                       field.never_indexed});
+    }
+    return true;
+}
+
+bool HPACKDecoder::huffman_decode(std::span<const uint8_t> data, std::string& out) {
+    const auto& table = huffman_decode_table();
+    uint8_t state = 0;
+    bool accept = true;
+
+    for (uint8_t byte : data) {
+        for (uint8_t nibble : {static_cast<uint8_t>(byte >> 4), static_cast<uint8_t>(byte & 0x0F)}) {
+            const auto& transition = table[state][nibble];
+            if (transition.flags & kHuffmanFail) {
+                return false;
+            }
+            if (transition.flags & kHuffmanEmit) {
+                out.push_back(static_cast<char>(transition.symbol));
+            }
+            state = transition.next_state;
+            accept = (transition.flags & kHuffmanAccept) != 0;
+        }
+    }
+
+    return accept;
+}
+
+bool HPACKDecoder::decode_integer(std::span<const uint8_t> block, size_t& pos,
+                                  uint8_t prefix_bits, uint64_t& value) {
+    if (pos >= block.size()) {
+        error_message_ = "HPACK integer truncated";
+        return false;
+    }
+
+    const uint8_t prefix_max = static_cast<uint8_t>((1u << prefix_bits) - 1);
+    value = block[pos++] & prefix_max;
+    if (value < prefix_max) {
+        return true;
+    }
+
+    // 5.1 多字节整数，限制在 32 位以内防止溢出
+    for (unsigned shift = 0; shift <= 28; shift += 7) {
+        if (pos >= block.size()) {
+            error_message_ = "HPACK integer truncated";
+            return false;
+        }
+        const uint8_t byte = block[pos++];
+        value += static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            if (value > UINT32_MAX) {
+                break;
+            }
+            return true;
+        }
+    }
+
+    error_message_ = "HPACK integer overflow";
+    return false;
+}
+
+bool HPACKDecoder::decode_string(std::span<const uint8_t> block, size_t& pos) {
+    if (pos >= block.size()) {
+        error_message_ = "HPACK string truncated";
+        return false;
+    }
+
+    const bool huffman = (block[pos] & 0x80) != 0;
+    uint64_t length = 0;
+    if (!decode_integer(block, pos, 7, length)) {
+        return false;
+    }
+    if (length > block.size() - pos) {
+        error_message_ = "HPACK string truncated";
+        return false;
+    }
+
+    const auto data = block.subspan(pos, static_cast<size_t>(length));
+    pos += static_cast<size_t>(length);
+
+    if (!huffman) {
+        scratch_.append(reinterpret_cast<const char*>(data.data()), data.size());
+        return true;
+    }
+
+    if (!huffman_decode(data, scratch_)) {
+        error_message_ = "Invalid HPACK Huffman string";
+        return false;
+    }
+    return true;
+}
+
+bool HPACKDecoder::lookup(uint64_t index, std::string_view& name, std::string_view& value) {
+    if (index == 0) {
+        error_message_ = "HPACK index 0";
+        return false;
+    }
+    if (index <= kStaticTableSize) {
+        name = kStaticTable[index - 1].name;
+        value = kStaticTable[index - 1].value;
+        return true;
+    }
+
+    const uint64_t age = index - kStaticTableSize - 1;
+    if (age >= entry_count_) {
+        error_message_ = "HPACK index out of range";
+        return false;
+    }
+    const auto& entry = entry_at(static_cast<size_t>(age));
+    name = entry_name(entry);
+    value = entry_value(entry);
+    return true;
+}
+
+std::string_view HPACKDecoder::entry_name(const DynamicEntry& entry) const noexcept {
+    return std::string_view(arena_.data() + entry.offset, entry.name_length);
+}
+
+std::string_view HPACKDecoder::entry_value(const DynamicEntry& entry) const noexcept {
+    return std::string_view(arena_.data() + entry.offset + entry.name_length, entry.value_length);
+}
+
+const HPACKDecoder::DynamicEntry& HPACKDecoder::entry_at(size_t age) const noexcept {
+    return entries_[(head_ - 1 - age) & (entries_.size() - 1)];
+}
+
+void HPACKDecoder::insert(std::string_view name, std::string_view value) {
+    const size_t entry_size = name.size() + value.size() + kEntryOverhead;
+
+    // 4.4 超过上限的条目清空动态表且不插入
+    if (entry_size > max_table_size_) {
+        evict_to(0);
+        return;
+    }
+    evict_to(max_table_size_ - entry_size);
+
+    // 字节区尾部空间不足时前移存活数据；容量为上限两倍，前移后必然放得下
+    const size_t bytes = name.size() + value.size();
+    if (arena_end_ + bytes > arena_.size()) {
+        const size_t live = arena_end_ - arena_begin_;
+        std::memmove(arena_.data(), arena_.data() + arena_begin_, live);
+        for (size_t age = 0; age < entry_count_; ++age) {
+            auto& entry = entries_[(head_ - 1 - age) & (entries_.size() - 1)];
+            entry.offset -= static_cast<uint32_t>(arena_begin_);
+        }
+        arena_begin_ = 0;
+        arena_end_ = live;
+        if (arena_end_ + bytes > arena_.size()) {
+            arena_.resize(arena_end_ + bytes);
+        }
+    }
+
+    // 环形队列已满时按顺序搬迁到两倍容量
+    if (entry_count_ == entries_.size()) {
+        std::vector<DynamicEntry> grown(entries_.size() * 2);
+        for (size_t i = 0; i < entry_count_; ++i) {
+            grown[i] = entry_at(entry_count_ - 1 - i);
+        }
+        entries_ = std::move(grown);
+        head_ = entry_count_;
+    }
+
+    DynamicEntry entry;
+    entry.offset = static_cast<uint32_t>(arena_end_);
+    entry.name_length = static_cast<uint32_t>(name.size());
+    entry.value_length = static_cast<uint32_t>(value.size());
+    std::memcpy(arena_.data() + arena_end_, name.data(), name.size());
+    std::memcpy(arena_.data() + arena_end_ + name.size(), value.data(), value.size());
+
+    if (entry_count_ == 0) {
+        arena_begin_ = arena_end_;
+    }
+    arena_end_ += bytes;
+
+    entries_[head_] = entry;
+    head_ = (head_ + 1) & (entries_.size() - 1);
+    entry_count_++;
+    table_size_ += entry_size;
+}
+
+void HPACKDecoder::evict_to(size_t limit) noexcept {
+    while (table_size_ > limit && entry_count_ > 0) {
+        const auto& oldest = entry_at(entry_count_ - 1);
+        table_size_ -= oldest.name_length + oldest.value_length + kEntryOverhead;
+        entry_count_--;
+        if (entry_count_ == 0) {
+            arena_begin_ = 0;
+            arena_end_ = 0;
+        } else {
+            arena_begin_ = entry_at(entry_count_ - 1).offset;
+        }
+    }
+}
+
+} // namespace protocol_parser::parsers
@@ -0,0 +1,349 @@
+#include "parsers/application/http2_demuxer.hpp"
+#include <cstring>
+
+namespace protocol_parser::parsers {
+
+namespace {
+    constexpr char kConnectionPreface[] = "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n";
+
+    // SETTINGS 参数标识（RFC 9113 6.5.2）
+    constexpr uint16_t kSettingsHeaderTableSize = 0x1;
+    constexpr uint16_t kSettingsMaxFrameSize = 0x5;
+
+    inline uint32_t read_be32(const uint8_t* data) noexcept {
+        return (static_cast<uint32_t>(data[0]) << 24) | (static_cast<uint32_t>(data[1]) << 16) |
+               (static_cast<uint32_t>(data[2]) << 8) | data[3];
+    }
+
+    inline HTTP2FrameHeader read_frame_header(const uint8_t* data) noexcept {
+        HTTP2FrameHeader header;
+        header.length = (static_cast<uint32_t>(data[0]) << 16) | (static_cast<uint32_t>(data[1]) << 8) | data[2];
+        header.type = static_cast<HTTP2FrameType>(data[3]);
+        header.flags = data[4];
+        header.stream_id = read_be32(data + 5) & 0x7FFFFFFF;
+        return header;
+    }
+
+    inline HTTP2Direction opposite(HTTP2Direction direction) noexcept {
+        return direction == HTTP2Direction::CLIENT_TO_SERVER ? HTTP2Direction::SERVER_TO_CLIENT
+                                                             : HTTP2Direction::CLIENT_TO_SERVER;
+    }
+}
+
+HTTP2Demuxer::HTTP2Demuxer() {
+    reset();
+}
+
+void HTTP2Demuxer::reset() {
+    for (auto& state : directions_) {
+        state = DirectionState{};
+    }
+    // 服务端方向没有连接前导
+    directions_[static_cast<size_t>(HTTP2Direction::SERVER_TO_CLIENT)].preface_done = true;
+    streams_.clear();
+    headers_.clear();
+    frames_parsed_ = 0;
+    failed_ = false;
+    error_message_.clear();
+}
+
+bool HTTP2Demuxer::is_preface(const BufferView& data) noexcept {
+    return data.size() >= kPrefaceSize && std::memcmp(data.data(), kConnectionPreface, kPrefaceSize) == 0;
+}
+
+ParseResult HTTP2Demuxer::feed(HTTP2Direction direction, const BufferView& data) {
+    if (failed_) {
+        return ParseResult::InvalidFormat;
+    }
+
+    auto& state = directions_[static_cast<size_t>(direction)];
+    std::span<const uint8_t> input(data.data(), data.size());
+
+    try {
+        if (!state.preface_done) {
+            input = input.subspan(consume_preface(state, input));
+            if (failed_) {
+                return ParseResult::InvalidFormat;
+            }
+        }
+
+        // 先补全上一片段遗留的不完整帧
+        if (!state.partial_frame.empty()) {
+            auto& partial = state.partial_frame;
+            if (partial.size() < kFrameHeaderSize) {
+                const size_t take = std::min(kFrameHeaderSize - partial.size(), input.size());
+                partial.insert(partial.end(), input.begin(), input.begin() + take);
+                input = input.subspan(take);
+                if (partial.size() < kFrameHeaderSize) {
+                    return ParseResult::Success;
+                }
+            }
+
+            const auto header = read_frame_header(partial.data());
+            if (header.length > state.max_frame_size) {
+                (void)fail("HTTP/2 frame exceeds maximum frame size");
+                return ParseResult::InvalidFormat;
+            }
+
+            const size_t total = kFrameHeaderSize + header.length;
+            const size_t take = std::min(total - partial.size(), input.size());
+            partial.insert(partial.end(), input.begin(), input.begin() + take);
+            input = input.subspan(take);
+            if (partial.size() < total) {
+                return ParseResult::Success;
+            }
+
+            if (!process_frame(direction, header, std::span<const uint8_t>(partial).subspan(kFrameHeaderSize))) {
+                return ParseResult::InvalidFormat;
+            }
+            partial.clear();
+        }
+
+        // 完整帧直接在输入缓冲区上解析
+        while (input.size() >= kFrameHeaderSize) {
+            const auto header = read_frame_header(input.data());
+            if (header.length > state.max_frame_size) {
+                (void)fail("HTTP/2 frame exceeds maximum frame size");
+                return ParseResult::InvalidFormat;
+            }
+            if (input.size() < kFrameHeaderSize + header.length) {
+                break;
+            }
+            if (!process_frame(direction, header, input.subspan(kFrameHeaderSize, header.length))) {
+                return ParseResult::InvalidFormat;
+            }
+            input = input.subspan(kFrameHeaderSize + header.length);
+        }
+
+        state.partial_frame.assign(input.begin(), input.end());
+        return ParseResult::Success;
+
+    } catch (const std::exception&) {
+        failed_ = true;
+        error_message_ = "HTTP/2 demuxer out of memory";
+        return ParseResult::InternalError;
+    }
+}
+
+size_t HTTP2Demuxer::consume_preface(DirectionState& state, std::span<const uint8_t> data) {
+    size_t used = 0;
+    while (used < data.size() && state.preface_matched < kPrefaceSize) {
+        if (data[used] != static_cast<uint8_t>(kConnectionPreface[state.preface_matched])) {
+            if (state.preface_matched == 0) {
+                // 连接中途开始观测：没有前导，也没见到 SETTINGS，放宽帧长限制
+                state.preface_done = true;
+                for (auto& direction : directions_) {
+                    direction.max_frame_size = kMaxFrameSizeLimit;
+                }
+                return 0;
+            }
+            (void)fail("Invalid HTTP/2 connection preface");
+            return used;
+        }
+        ++used;
+        ++state.preface_matched;
+    }
+
+    if (state.preface_matched == kPrefaceSize) {
+        state.preface_done = true;
+    }
+    return used;
+}
+
+bool HTTP2Demuxer::process_frame(HTTP2Direction direction, const HTTP2FrameHeader& header,
+                                 std::span<const uint8_t> payload) {
+    auto& state = directions_[static_cast<size_t>(direction)];
+    frames_parsed_++;
+
+    if (handlers_.on_frame) {
+        handlers_.on_frame(direction, header);
+    }
+
+    // 头部块未结束时只允许同一流的 CONTINUATION
+    if (state.expecting_continuation &&
+        (header.type != HTTP2FrameType::CONTINUATION || header.stream_id != state.continuation_stream_id)) {
+        return fail("HTTP/2 header block interrupted");
+    }
+
+    const bool end_stream = (header.flags & HTTP2Flags::END_STREAM) != 0;
+    const bool end_headers = (header.flags & HTTP2Flags::END_HEADERS) != 0;
+
+    switch (header.type) {
+        case HTTP2FrameType::DATA: {
+            if (header.stream_id == 0 || !strip_padding(header, payload, 0)) {
+                return fail("Malformed HTTP/2 DATA frame");
+            }
+            auto& stream = track_stream(header.stream_id);
+            (direction == HTTP2Direction::CLIENT_TO_SERVER ? stream.client_bytes : stream.server_bytes) += payload.size();
+            if (handlers_.on_data) {
+                handlers_.on_data(direction, header.stream_id, payload, end_stream);
+            }
+            if (end_stream) {
+                mark_end_stream(direction, header.stream_id);
+            }
+            return true;
+        }
+
+        case HTTP2FrameType::HEADERS: {
+            const size_t priority_bytes = (header.flags & HTTP2Flags::PRIORITY) ? 5 : 0;
+            if (header.stream_id == 0 || !strip_padding(header, payload, priority_bytes)) {
+                return fail("Malformed HTTP/2 HEADERS frame");
+            }
+            state.continuation_stream_id = header.stream_id;
+            return process_header_fragment(direction, header.stream_id, payload.subspan(priority_bytes),
+                                           end_headers, end_stream);
+        }
+
+        case HTTP2FrameType::PUSH_PROMISE: {
+            // 承诺流的请求头同样要解码，以保持 HPACK 动态表同步
+            if (header.stream_id == 0 || !strip_padding(header, payload, 4)) {
+                return fail("Malformed HTTP/2 PUSH_PROMISE frame");
+            }
+            const uint32_t promised_stream_id = read_be32(payload.data()) & 0x7FFFFFFF;
+            state.continuation_stream_id = header.stream_id;
+            return process_header_fragment(direction, promised_stream_id, payload.subspan(4), end_headers, false);
+        }
+
+        case HTTP2FrameType::CONTINUATION:
+            if (!state.expecting_continuation) {
+                return fail("Unexpected HTTP/2 CONTINUATION frame");
+            }
+            return process_header_fragment(direction, state.header_stream_id, payload, end_headers,
+                                           state.header_end_stream);
+
+        case HTTP2FrameType::RST_STREAM: {
+            if (header.stream_id == 0 || payload.size() != 4) {
+                return fail("Malformed HTTP/2 RST_STREAM frame");
+            }
+            if (handlers_.on_stream_reset) {
+                handlers_.on_stream_reset(header.stream_id, read_be32(payload.data()));
+            }
+            streams_.erase(header.stream_id);
+            return true;
+        }
+
+        case HTTP2FrameType::SETTINGS:
+            if (header.stream_id != 0 || payload.size() % 6 != 0) {
+                return fail("Malformed HTTP/2 SETTINGS frame");
+            }
+            if ((header.flags & HTTP2Flags::ACK) == 0) {
+                process_settings(direction, payload);
+            }
+            return true;
+
+        default:
+            // PRIORITY、PING、GOAWAY、WINDOW_UPDATE 与未知类型不影响解复用
+            return true;
+    }
+}
+
+bool HTTP2Demuxer::process_header_fragment(HTTP2Direction direction, uint32_t stream_id,
+                                           std::span<const uint8_t> fragment, bool end_headers,
+                                           bool end_stream) {
+    auto& state = directions_[static_cast<size_t>(direction)];
+
+    // 单帧头部块直接在帧载荷上解码
+    if (!state.expecting_continuation && end_headers) {
+        return decode_header_block(direction, stream_id, fragment, end_stream);
+    }
+
+    if (!state.expecting_continuation) {
+        state.header_block.clear();
+        state.header_stream_id = stream_id;
+        state.header_end_stream = end_stream;
+        state.expecting_continuation = true;
+    }
+
+    if (state.header_block.size() + fragment.size() > kMaxHeaderBlockSize) {
+        return fail("HTTP/2 header block too large");
+    }
+    state.header_block.insert(state.header_block.end(), fragment.begin(), fragment.end());
+
+    if (!end_headers) {
+        return true;
+    }
+
+    state.expecting_continuation = false;
+    return decode_header_block(direction, state.header_stream_id, state.header_block, state.header_end_stream);
+}
+
+bool HTTP2Demuxer::decode_header_block(HTTP2Direction direction, uint32_t stream_id,
+                                       std::span<const uint8_t> block, bool end_stream) {
+    auto& decoder = directions_[static_cast<size_t>(direction)].decoder;
+    if (!decoder.decode(block, headers_)) {
+        return fail("HPACK decoding failed: " + decoder.get_error_message());
+    }
+
+    track_stream(stream_id).header_blocks++;
+
+    if (handlers_.on_headers) {
+        handlers_.on_headers(direction, stream_id, headers_, end_stream);
+    }
+    if (end_stream) {
+        mark_end_stream(direction, stream_id);
+    }
+    return true;
+}
+
+void HTTP2Demuxer::process_settings(HTTP2Direction direction, std::span<const uint8_t> payload) {
+    // 发送方声明的是自己的接收限制，约束的是反方向的帧
+    auto& peer = directions_[static_cast<size_t>(opposite(direction))];
+
+    for (size_t offset = 0; offset + 6 <= payload.size(); offset += 6) {
+        const uint16_t id = static_cast<uint16_t>((payload[offset] << 8) | payload[offset + 1]);
+        const uint32_t value = read_be32(payload.data() + offset + 2);
+
+        if (id == kSettingsHeaderTableSize) {
+            peer.decoder.set_max_table_size(value);
+        } else if (id == kSettingsMaxFrameSize && value >= kDefaultMaxFrameSize && value <= kMaxFrameSizeLimit) {
+            peer.max_frame_size = std::max(peer.max_frame_size, value);
+        }
+    }
+}
+
+HTTP2StreamInfo& HTTP2Demuxer::track_stream(uint32_t stream_id) {
+    if (streams_.find(stream_id) == nullptr && streams_.size() >= kMaxTrackedStreams) {
+        streams_.erase(streams_.begin()->first);
+    }
+    return streams_.get_or_insert(stream_id);
+}
+
+void HTTP2Demuxer::mark_end_stream(HTTP2Direction direction, uint32_t stream_id) {
+    auto* stream = streams_.find(stream_id);
+    if (stream == nullptr) {
+        return;
+    }
+
+    (direction == HTTP2Direction::CLIENT_TO_SERVER ? stream->client_closed : stream->server_closed) = true;
+    if (stream->client_closed && stream->server_closed) {
+        if (handlers_.on_stream_closed) {
+            handlers_.on_stream_closed(stream_id);
+        }
+        streams_.erase(stream_id);
+    }
+}
+
+bool HTTP2Demuxer::fail(std::string message) {
+    failed_ = true;
+    error_message_ = std::move(message);
+    return false;
+}
+
+bool HTTP2Demuxer::strip_padding(const HTTP2FrameHeader& header, std::span<const uint8_t>& payload,
+                                 size_t prefix_bytes) {
+    size_t pad_length = 0;
+    if (header.flags & HTTP2Flags::PADDED) {
+        if (payload.empty()) {
+            return false;
+        }
+        pad_length = payload[0];
+        payload = payload.subspan(1);
+    }
+    if (payload.size() < prefix_bytes + pad_length) {
+        return false;
+    }
+    payload = payload.first(payload.size() - pad_length);
+    return true;
+}
+
+} // namespace protocol_parser::parsers
@@ -1,57 +1,272 @@
 #include "../../../include/parsers/application/http_parser.hpp"
 #include <algorithm>
+#include <bit>
+#include <charconv>
 #include <sstream>
 #include <cctype>
 #include <cstring>
 
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
 namespace protocol_parser::parsers {
 
+namespace {
+    // Caller guarantees value != 0
+    inline unsigned int count_trailing_zeros(uint32_t value) {
+        #ifdef _MSC_VER
+            unsigned long index = 0;
+            _BitScanForward(&index, value);
+            return static_cast<unsigned int>(index);
+        #else
+            return static_cast<unsigned int>(__builtin_ctz(value));
+        #endif
+    }
+
+    // Position of the first a or b, or size if neither occurs
+    inline size_t find_either(const char* data, size_t size, char a, char b) noexcept {
+        size_t i = 0;
+#ifdef __AVX2__
+        const __m256i va = _mm256_set1_epi8(a);
+        const __m256i vb = _mm256_set1_epi8(b);
+        for (; i + 32 <= size; i += 32) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(
+                _mm256_or_si256(_mm256_cmpeq_epi8(v, va), _mm256_cmpeq_epi8(v, vb))));
+            if (mask != 0) {
+                return i + count_trailing_zeros(mask);
+            }
+        }
+#endif
+        for (; i < size; ++i) {
+            if (data[i] == a || data[i] == b) {
+                return i;
+            }
+        }
+        return size;
+    }
+
+    // Pack up to 8 chars in memory order so they compare directly against a memcpy load
+    constexpr uint64_t pack_token(std::string_view text) noexcept {
+        uint64_t value = 0;
+        for (size_t i = 0; i < text.size() && i < 8; ++i) {
+            const size_t shift = std::endian::native == std::endian::little ? i * 8 : (7 - i) * 8;
+            value |= static_cast<uint64_t>(static_cast<uint8_t>(text[i])) << shift;
+        }
+        return value;
+    }
+
+    constexpr uint64_t prefix_mask(size_t length) noexcept {
+        return pack_token(std::string_view("\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF", length));
+    }
+
+    inline uint64_t load_prefix(const char* data, size_t size) noexcept {
+        uint64_t value = 0;
+        std::memcpy(&value, data, std::min<size_t>(size, 8));
+        return value;
+    }
+
+    struct MethodToken {
+        uint64_t value;
+        uint64_t mask;
+        size_t length;    // excluding the trailing space
+        HTTPMethod method;
+    };
+
+    // Tokens include the trailing space so one compare also checks the delimiter; ordered by frequency
+    constexpr MethodToken make_method_token(std::string_view token, HTTPMethod method) noexcept {
+        return {pack_token(token), prefix_mask(token.size()), token.size() - 1, method};
+    }
+
+    constexpr std::array<MethodToken, 9> kMethodTokens{{
+        make_method_token("GET ", HTTPMethod::GET),
+        make_method_token("POST ", HTTPMethod::POST),
+        make_method_token("PUT ", HTTPMethod::PUT),
+        make_method_token("HEAD ", HTTPMethod::HEAD),
+        make_method_token("DELETE ", HTTPMethod::DELETE_METHOD),
+        make_method_token("OPTIONS ", HTTPMethod::OPTIONS),
+        make_method_token("PATCH ", HTTPMethod::PATCH),
+        make_method_token("CONNECT ", HTTPMethod::CONNECT),
+        make_method_token("TRACE ", HTTPMethod::TRACE),
+    }};
+
+    // Matches the method token (and its trailing space) at the start of data; length excludes the space
+    inline HTTPMethod match_method(const char* data, size_t size, size_t& length) noexcept {
+        const uint64_t prefix = load_prefix(data, size);
+        for (const auto& token : kMethodTokens) {
+            if ((prefix & token.mask) == token.value && size > token.length) {
+                length = token.length;
+                return token.method;
+            }
+        }
+        return HTTPMethod::UNKNOWN;
+    }
+
+    constexpr uint64_t kVersion10 = pack_token("HTTP/1.0");
+    constexpr uint64_t kVersion11 = pack_token("HTTP/1.1");
+    constexpr uint64_t kVersion20 = pack_token("HTTP/2.0");
+
+    inline HTTPVersion match_version(std::string_view text) noexcept {
+        if (text.size() < 8) {
+            return HTTPVersion::UNKNOWN;
+        }
+        const uint64_t value = load_prefix(text.data(), 8);
+        if (value == kVersion11) return HTTPVersion::HTTP_1_1;
+        if (value == kVersion10) return HTTPVersion::HTTP_1_0;
+        if (value == kVersion20) return HTTPVersion::HTTP_2_0;
+        return HTTPVersion::UNKNOWN;
+    }
+
+    inline char ascii_lower(char c) noexcept {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c + ('a' - 'A')) : c;
+    }
+
+    inline bool equals_ignore_case(std::string_view a, std::string_view b) noexcept {
+        if (a.size() != b.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < a.size(); ++i) {
+            if (ascii_lower(a[i]) != ascii_lower(b[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // needle must be lowercase
+    inline bool contains_ignore_case(std::string_view haystack, std::string_view needle) noexcept {
+        if (needle.size() > haystack.size()) {
+            return false;
+        }
+        for (size_t i = 0; i + needle.size() <= haystack.size(); ++i) {
+            if (equals_ignore_case(haystack.substr(i, needle.size()), needle)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    inline std::string_view trim_view(std::string_view text) noexcept {
+        while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) {
+            text.remove_prefix(1);
+        }
+        while (!text.empty() && (text.back() == ' ' || text.back() == '\t' || text.back() == '\r')) {
+            text.remove_suffix(1);
+        }
+        return text;
+    }
+
+    inline std::string_view strip_cr(std::string_view line) noexcept {
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        return line;
+    }
+}
+
+std::string_view HTTPMessageView::find_header(std::string_view name) const noexcept {
+    for (size_t i = 0; i < header_count; ++i) {
+        if (equals_ignore_case(headers[i].name, name)) {
+            return headers[i].value;
+        }
+    }
+    return {};
+}
+
 ParseResult HTTPParser::parse(ParseContext& context) noexcept {
-    if (!validate_http_message(context.buffer)) {
-        return ParseResult::InvalidFormat;
+    // A message whose body is still in progress resumes with the new data
+    if (body_in_progress()) {
+        size_t pos = context.offset;
+        ParseResult status = parse_body(context.buffer, pos);
+        context.offset = pos;
+        return status;
     }
 
-    reset();
-    
-    // Find the end of headers (\r\n\r\n)
-    size_t headers_end = find_headers_end(context.buffer);
-    if (headers_end == std::string::npos) {
+    if (context.offset >= context.buffer.size()) {
         return ParseResult::NeedMoreData;
     }
 
-    // Extract headers section
-    std::string headers_section(reinterpret_cast<const char*>(context.buffer.data()), headers_end);
-    auto lines = split_lines(headers_section);
-    
-    if (lines.empty()) {
+    // Pipelined messages start at the current offset
+    const BufferView message = context.buffer.substr(context.offset);
+    if (!validate_http_message(message)) {
         return ParseResult::InvalidFormat;
     }
 
-    // Parse first line (request line or status line)
-    ParseResult status;
-    if (lines[0].find("HTTP/") == 0) {
-        // Response (starts with HTTP/)
-        http_message_.type = HTTPMessageType::RESPONSE;
-        status = parse_status_line(lines[0]);
-    } else {
-        // Request (method URI HTTP/version)
-        http_message_.type = HTTPMessageType::REQUEST;
-        status = parse_request_line(lines[0]);
-    }
+    reset();
     
+    size_t header_length = 0;
+    ParseResult status = zero_copy_ ? parse_zero_copy(message, header_length)
+                                    : parse_header_block(message, header_length);
     if (status != ParseResult::Success) {
         return status;
     }
 
-    // Parse headers
-    std::vector<std::string> header_lines(lines.begin() + 1, lines.end());
-    status = parse_headers(header_lines);
-    if (status != ParseResult::Success) {
-        return status;
+    begin_body();
+
+    // Zero-copy mode leaves context.metadata alone; callers read get_message_view() instead
+    if (!zero_copy_) {
+        try {
+            store_metadata(context);
+        } catch (const std::exception&) {
+            return ParseResult::InternalError;
+        }
+    }
+
+    // Parse body if present; offset ends after this message or after the consumed body bytes
+    size_t pos = context.offset + header_length;
+    status = parse_body(context.buffer, pos);
+    context.offset = pos;
+    return status;
+}
+
+ParseResult HTTPParser::parse_header_block(const BufferView& buffer, size_t& header_length) noexcept {
+    try {
+        // Find the end of headers (\r\n\r\n)
+        size_t headers_end = find_headers_end(buffer);
+        if (headers_end == std::string::npos) {
+            return ParseResult::NeedMoreData;
+        }
+
+        // Extract headers section
+        std::string headers_section(reinterpret_cast<const char*>(buffer.data()), headers_end);
+        auto lines = split_lines(headers_section);
+        
+        if (lines.empty()) {
+            return ParseResult::InvalidFormat;
+        }
+
+        // Parse first line (request line or status line)
+        ParseResult status;
+        if (lines[0].find("HTTP/") == 0) {
+            // Response (starts with HTTP/)
+            http_message_.type = HTTPMessageType::RESPONSE;
+            status = parse_status_line(lines[0]);
+        } else {
+            // Request (method URI HTTP/version)
+            http_message_.type = HTTPMessageType::REQUEST;
+            status = parse_request_line(lines[0]);
+        }
+        
+        if (status != ParseResult::Success) {
+            return status;
+        }
+
+        // Parse headers
+        std::vector<std::string> header_lines(lines.begin() + 1, lines.end());
+        status = parse_headers(header_lines);
+        if (status != ParseResult::Success) {
+            return status;
+        }
+
+        header_length = headers_end + 4; // +4 for \r\n\r\n
+        return ParseResult::Success;
+    } catch (const std::exception&) {
+        return ParseResult::InternalError;
     }
+}
 
-    // Parse body if present
-    status = parse_body(context.buffer, headers_end + 4); // +4 for \r\n\r\n
+void HTTPParser::store_metadata(ParseContext& context) const {
     // Store parsed data in context
     context.metadata["http_message_type"] = static_cast<int>(http_message_.type);
     context.metadata["http_version"] = version_to_string(get_version());
@@ -83,9 +298,132 @@ ParseResult HTTPParser::parse(ParseContext& context) noexcept {
     if (!host.empty()) {
         context.metadata["http_host"] = host;
     }
+}
 
-    context.offset = context.buffer.size(); // HTTP parser consumes entire buffer
-    return status;
+ParseResult HTTPParser::parse_zero_copy(const BufferView& buffer, size_t& header_length) noexcept {
+    const char* data = reinterpret_cast<const char*>(buffer.data());
+    const size_t size = buffer.size();
+    
+    // Start line
+    size_t line_end = find_either(data, size, '\n', '\n');
+    if (line_end == size) {
+        return ParseResult::NeedMoreData;
+    }
+    
+    ParseResult status = parse_view_start_line(strip_cr(std::string_view(data, line_end)));
+    if (status != ParseResult::Success) {
+        return status;
+    }
+    
+    // Headers: one scan finds the colon or line end; an empty line terminates
+    size_t pos = line_end + 1;
+    for (;;) {
+        if (pos >= size) {
+            return ParseResult::NeedMoreData;
+        }
+        
+        const char* line = data + pos;
+        const size_t remaining = size - pos;
+        const size_t stop = find_either(line, remaining, ':', '\n');
+        if (stop == remaining) {
+            return ParseResult::NeedMoreData;
+        }
+        
+        if (line[stop] == '\n') {
+            pos += stop + 1;
+            if (strip_cr(std::string_view(line, stop)).empty()) {
+                break;
+            }
+            continue; // Skip malformed headers
+        }
+        
+        const size_t value_begin = stop + 1;
+        const size_t value_end = value_begin + find_either(line + value_begin, remaining - value_begin, '\n', '\n');
+        if (value_end == remaining) {
+            return ParseResult::NeedMoreData;
+        }
+        
+        if (message_view_.header_count == HTTPMessageView::kMaxHeaders) {
+            error_message_ = "Too many HTTP headers";
+            return ParseResult::InvalidFormat;
+        }
+        
+        auto& header = message_view_.headers[message_view_.header_count++];
+        header.name = trim_view(std::string_view(line, stop));
+        header.value = trim_view(std::string_view(line + value_begin, value_end - value_begin));
+        pos += value_end + 1;
+    }
+    message_view_.header_length = pos;
+    
+    // Body length
+    if (contains_ignore_case(message_view_.find_header("transfer-encoding"), "chunked")) {
+        is_chunked_ = true;
+    } else {
+        auto content_length = message_view_.find_header("content-length");
+        if (!content_length.empty()) {
+            has_content_length_ = true;
+            auto [ptr, ec] = std::from_chars(content_length.data(), content_length.data() + content_length.size(),
+                                             expected_body_length_);
+            if (ec != std::errc{}) {
+                expected_body_length_ = 0;
+            }
+        }
+    }
+    
+    header_length = pos;
+    return ParseResult::Success;
+}
+
+ParseResult HTTPParser::parse_view_start_line(std::string_view line) noexcept {
+    message_view_.start_line = line;
+    
+    // Status line: HTTP/x.y SP status-code [SP reason-phrase]
+    if (line.size() >= 5 && std::memcmp(line.data(), "HTTP/", 5) == 0) {
+        message_view_.type = HTTPMessageType::RESPONSE;
+        message_view_.version = match_version(line);
+        if (message_view_.version == HTTPVersion::UNKNOWN || line.size() < 12 || line[8] != ' ') {
+            return ParseResult::InvalidFormat;
+        }
+        
+        uint16_t code = 0;
+        for (size_t i = 9; i < 12; ++i) {
+            if (line[i] < '0' || line[i] > '9') {
+                return ParseResult::InvalidFormat;
+            }
+            code = static_cast<uint16_t>(code * 10 + (line[i] - '0'));
+        }
+        message_view_.status_code = code;
+        message_view_.reason_phrase = trim_view(line.substr(12));
+        
+        http_message_.type = HTTPMessageType::RESPONSE;
+        http_message_.response.version = message_view_.version;
+        http_message_.response.status_code = code;
+        return ParseResult::Success;
+    }
+    
+    // Request line: method SP request-target SP HTTP/x.y
+    message_view_.type = HTTPMessageType::REQUEST;
+    size_t method_length = 0;
+    message_view_.method = match_method(line.data(), line.size(), method_length);
+    if (message_view_.method == HTTPMethod::UNKNOWN) {
+        return ParseResult::InvalidFormat;
+    }
+    
+    const size_t uri_begin = method_length + 1;
+    const size_t uri_end = uri_begin + find_either(line.data() + uri_begin, line.size() - uri_begin, ' ', ' ');
+    if (uri_end == line.size() || uri_end == uri_begin) {
+        return ParseResult::InvalidFormat;
+    }
+    message_view_.uri = line.substr(uri_begin, uri_end - uri_begin);
+    message_view_.version = match_version(line.substr(uri_end + 1));
+    if (message_view_.version == HTTPVersion::UNKNOWN) {
+        return ParseResult::InvalidFormat;
+    }
+    
+    http_message_.type = HTTPMessageType::REQUEST;
+    http_message_.request.method = message_view_.method;
+    http_message_.request.version = message_view_.version;
+    return ParseResult::Success;
 }
 
 ParseResult HTTPParser::parse_request_line(const std::string& line) {
@@ -163,6 +501,7 @@ ParseResult HTTPParser::parse_headers(const std::vector<std::string>& header_lin
         to_lower(transfer_encoding_header).find("chunked") != std::string::npos) {
         is_chunked_ = true;
     } else if (!content_length_header.empty()) {
+        has_content_length_ = true;
         try {
             expected_body_length_ = std::stoull(content_length_header);
         } catch (const std::exception&) {
@@ -173,93 +512,251 @@ ParseResult HTTPParser::parse_headers(const std::vector<std::string>& header_lin
     return ParseResult::Success;
 }
 
-ParseResult HTTPParser::parse_body(const BufferView& buffer, size_t start_pos) {
-    if (start_pos >= buffer.size()) {
-        is_complete_ = true;
-        return ParseResult::Success;
-    }
-    
-    if (is_chunked_) {
-        return parse_chunked_body(buffer, start_pos);
-    }
-    
-    // Fixed-length body
-    size_t available_body_length = buffer.size() - start_pos;
-    
-    if (expected_body_length_ == 0) {
-        // No body expected
-        is_complete_ = true;
-        return ParseResult::Success;
-    }
-    
-    if (available_body_length < expected_body_length_) {
-        return ParseResult::NeedMoreData;
-    }
-    
-    // Extract body
-    std::string body(reinterpret_cast<const char*>(buffer.data() + start_pos), expected_body_length_);
-    
-    if (http_message_.type == HTTPMessageType::REQUEST) {
-        http_message_.request.body = std::move(body);
+void HTTPParser::begin_body() noexcept {
+    // Message body length rules of RFC 9112 section 6.3
+    const uint16_t status = get_status_code();
+    const bool bodyless_response = is_response() &&
+        ((status >= 100 && status < 200) || status == 204 || status == 304);
+
+    body_remaining_ = 0;
+    if (bodyless_response) {
+        body_state_ = BodyState::DONE;
+    } else if (is_chunked_) {
+        body_state_ = BodyState::CHUNK_SIZE;
+        chunk_size_digits_ = 0;
+    } else if (has_content_length_) {
+        body_remaining_ = expected_body_length_;
+        body_state_ = expected_body_length_ > 0 ? BodyState::FIXED : BodyState::DONE;
+    } else if (is_response()) {
+        body_state_ = BodyState::UNTIL_CLOSE;
     } else {
-        http_message_.response.body = std::move(body);
+        body_state_ = BodyState::DONE;
     }
-    
-    is_complete_ = true;
-    return ParseResult::Success;
+
+    is_complete_ = body_state_ == BodyState::DONE;
 }
 
-ParseResult HTTPParser::parse_chunked_body(const BufferView& buffer, size_t start_pos) {
-    // Simplified chunked encoding parser
-    // In a full implementation, this would handle chunk sizes and trailers
-    std::string body;
-    size_t pos = start_pos;
-    
-    while (pos < buffer.size()) {
-        // Find chunk size line
-        size_t line_end = pos;
-        while (line_end < buffer.size() - 1 && 
-               !(buffer.data()[line_end] == '\r' && buffer.data()[line_end + 1] == '\n')) {
-            line_end++;
+void HTTPParser::emit_body(std::string_view chunk) {
+    body_bytes_ += chunk.size();
+
+    if (body_callback_) {
+        body_callback_(chunk);
+    } else if (zero_copy_) {
+        // Without a callback only a Content-Length body contained in one buffer is kept as a view
+        if (body_state_ == BodyState::FIXED && chunk.size() == expected_body_length_) {
+            message_view_.body = chunk;
         }
-        
-        if (line_end >= buffer.size() - 1) {
-            return ParseResult::NeedMoreData;
+    } else {
+        auto& body = (http_message_.type == HTTPMessageType::REQUEST) ?
+                     http_message_.request.body : http_message_.response.body;
+        const size_t room = max_buffered_body_ - std::min(body.size(), max_buffered_body_);
+        if (chunk.size() > room) {
+            body_truncated_ = true;
+            chunk = chunk.substr(0, room);
         }
-        
-        std::string chunk_size_str(reinterpret_cast<const char*>(buffer.data() + pos), line_end - pos);
-        
-        // Parse chunk size (hexadecimal)
-        size_t chunk_size;
-        try {
-            chunk_size = std::stoull(chunk_size_str, nullptr, 16);
-        } catch (const std::exception&) {
-            return ParseResult::InvalidFormat;
+        body.append(chunk);
+    }
+}
+
+ParseResult HTTPParser::parse_body(const BufferView& buffer, size_t& pos) noexcept {
+    try {
+        const char* data = reinterpret_cast<const char*>(buffer.data());
+        const size_t size = buffer.size();
+
+        while (body_state_ == BodyState::FIXED || body_state_ == BodyState::UNTIL_CLOSE) {
+            if (pos >= size) {
+                return ParseResult::NeedMoreData;
+            }
+
+            if (body_state_ == BodyState::UNTIL_CLOSE) {
+                // Everything up to connection close belongs to the body
+                emit_body(std::string_view(data + pos, size - pos));
+                pos = size;
+                return ParseResult::NeedMoreData;
+            }
+
+            const size_t length = static_cast<size_t>(std::min<uint64_t>(body_remaining_, size - pos));
+            emit_body(std::string_view(data + pos, length));
+            pos += length;
+            body_remaining_ -= length;
+            if (body_remaining_ == 0) {
+                body_state_ = BodyState::DONE;
+            }
         }
-        
-        if (chunk_size == 0) {
-            // End of chunks
-            break;
+
+        if (is_chunked_ && body_state_ != BodyState::DONE) {
+            ParseResult status = parse_chunked_body(buffer, pos);
+            if (status != ParseResult::Success) {
+                return status;
+            }
         }
-        
-        pos = line_end + 2; // Skip \r\n
-        
-        // Read chunk data
-        if (pos + chunk_size + 2 > buffer.size()) {
+
+        is_complete_ = body_state_ == BodyState::DONE;
+        return ParseResult::Success;
+    } catch (const std::exception&) {
+        body_state_ = BodyState::DONE;
+        return ParseResult::InternalError;
+    }
+}
+
+ParseResult HTTPParser::parse_chunked_body(const BufferView& buffer, size_t& pos) {
+    const char* data = reinterpret_cast<const char*>(buffer.data());
+    const size_t size = buffer.size();
+
+    while (body_state_ != BodyState::DONE) {
+        if (pos >= size) {
             return ParseResult::NeedMoreData;
         }
-        
-        body.append(reinterpret_cast<const char*>(buffer.data() + pos), chunk_size);
-        pos += chunk_size + 2; // Skip chunk data and trailing \r\n
+
+        switch (body_state_) {
+            case BodyState::CHUNK_SIZE: {
+                // Hexadecimal chunk size, accumulated across buffers
+                const char c = data[pos];
+                int digit = -1;
+                if (c >= '0' && c <= '9') digit = c - '0';
+                else if (c >= 'a' && c <= 'f') digit = c - 'a' + 10;
+                else if (c >= 'A' && c <= 'F') digit = c - 'A' + 10;
+
+                if (digit < 0) {
+                    if (chunk_size_digits_ == 0) {
+                        error_message_ = "Invalid HTTP chunk size";
+                        return ParseResult::InvalidFormat;
+                    }
+                    body_state_ = BodyState::CHUNK_EXTENSION;
+                    break;
+                }
+                if (++chunk_size_digits_ > 16) {
+                    error_message_ = "HTTP chunk size too large";
+                    return ParseResult::InvalidFormat;
+                }
+                body_remaining_ = (body_remaining_ << 4) | static_cast<uint64_t>(digit);
+                ++pos;
+                break;
+            }
+
+            case BodyState::CHUNK_EXTENSION: {
+                // Skip chunk extensions up to the end of the size line
+                const size_t line_end = pos + find_either(data + pos, size - pos, '\n', '\n');
+                if (line_end == size) {
+                    pos = size;
+                    return ParseResult::NeedMoreData;
+                }
+                pos = line_end + 1;
+                body_state_ = body_remaining_ == 0 ? BodyState::TRAILER_START : BodyState::CHUNK_DATA;
+                break;
+            }
+
+            case BodyState::CHUNK_DATA: {
+                const size_t length = static_cast<size_t>(std::min<uint64_t>(body_remaining_, size - pos));
+                emit_body(std::string_view(data + pos, length));
+                pos += length;
+                body_remaining_ -= length;
+                if (body_remaining_ == 0) {
+                    body_state_ = BodyState::CHUNK_DATA_END;
+                }
+                break;
+            }
+
+            case BodyState::CHUNK_DATA_END: {
+                // CRLF after chunk data (a bare LF is tolerated)
+                const char c = data[pos++];
+                if (c == '\n') {
+                    body_state_ = BodyState::CHUNK_SIZE;
+                    chunk_size_digits_ = 0;
+                } else if (c != '\r') {
+                    error_message_ = "Missing CRLF after HTTP chunk data";
+                    return ParseResult::InvalidFormat;
+                }
+                break;
+            }
+
+            case BodyState::TRAILER_START: {
+                const char c = data[pos];
+                if (c == '\r') {
+                    ++pos;
+                    body_state_ = BodyState::TRAILER_END;
+                } else if (c == '\n') {
+                    ++pos;
+                    body_state_ = BodyState::DONE;
+                } else {
+                    trailer_line_.clear();
+                    body_state_ = BodyState::TRAILER_FIELD;
+                }
+                break;
+            }
+
+            case BodyState::TRAILER_FIELD: {
+                // A trailer line split across buffers is kept in trailer_line_ until its LF arrives
+                const size_t line_end = pos + find_either(data + pos, size - pos, '\n', '\n');
+                const std::string_view segment(data + pos, line_end - pos);
+                if (line_end == size) {
+                    if (!zero_copy_) {
+                        if (trailer_line_.size() + segment.size() > kMaxTrailerLine) {
+                            error_message_ = "HTTP chunked trailer line too long";
+                            return ParseResult::InvalidFormat;
+                        }
+                        trailer_line_.append(segment);
+                    }
+                    pos = size;
+                    return ParseResult::NeedMoreData;
+                }
+                if (trailer_line_.empty()) {
+                    record_trailer(strip_cr(segment));
+                } else {
+                    trailer_line_.append(segment);
+                    record_trailer(strip_cr(trailer_line_));
+                    trailer_line_.clear();
+                }
+                pos = line_end + 1;
+                body_state_ = BodyState::TRAILER_START;
+                break;
+            }
+
+            case BodyState::TRAILER_END: {
+                if (data[pos++] != '\n') {
+                    error_message_ = "Malformed HTTP chunked trailer";
+                    return ParseResult::InvalidFormat;
+                }
+                body_state_ = BodyState::DONE;
+                break;
+            }
+
+            default:
+                return ParseResult::InternalError;
+        }
     }
-    
-    if (http_message_.type == HTTPMessageType::REQUEST) {
-        http_message_.request.body = std::move(body);
-    } else {
-        http_message_.response.body = std::move(body);
+
+    return ParseResult::Success;
+}
+
+void HTTPParser::record_trailer(std::string_view line) {
+    // Trailer views would outlive their buffer, so only the copying mode keeps them
+    if (zero_copy_) {
+        return;
     }
-    
-    is_complete_ = true;
+
+    const size_t colon = line.find(':');
+    if (colon == std::string_view::npos) {
+        return;
+    }
+
+    auto& headers = (http_message_.type == HTTPMessageType::REQUEST) ?
+                   http_message_.request.headers : http_message_.response.headers;
+    headers[to_lower(std::string(trim_view(line.substr(0, colon))))] = std::string(trim_view(line.substr(colon + 1)));
+}
+
+ParseResult HTTPParser::finish_stream() noexcept {
+    if (body_state_ == BodyState::UNTIL_CLOSE) {
+        body_state_ = BodyState::DONE;
+        is_complete_ = true;
+        return ParseResult::Success;
+    }
+
+    if (body_in_progress()) {
+        error_message_ = "Connection closed before end of HTTP body";
+        return ParseResult::InvalidFormat;
+    }
+
     return ParseResult::Success;
 }
 
@@ -312,14 +809,15 @@ bool HTTPParser::validate_http_message(const BufferView& buffer) const {
         return false;
     }
     
-    // Check for HTTP signature
+    // Check for HTTP signature: a status line or any method the request-line parser accepts
     const char* data = reinterpret_cast<const char*>(buffer.data());
-    std::string start(data, std::min(buffer.size(), size_t(8)));
+    std::string_view start(data, std::min(buffer.size(), size_t(8)));
+    if (start.find("HTTP/") != std::string::npos) {
+        return true;
+    }
     
-    return start.find("HTTP/") != std::string::npos || 
-           start.find("GET ") == 0 || start.find("POST ") == 0 || 
-           start.find("PUT ") == 0 || start.find("DELETE ") == 0 ||
-           start.find("HEAD ") == 0 || start.find("OPTIONS ") == 0;
+    size_t method_length = 0;
+    return match_method(data, buffer.size(), method_length) != HTTPMethod::UNKNOWN;
 }
 
 // Getter implementations
@@ -329,6 +827,9 @@ HTTPMethod HTTPParser::get_method() const {
 }
 
 std::string HTTPParser::get_uri() const {
+    if (zero_copy_) {
+        return std::string(message_view_.type == HTTPMessageType::REQUEST ? message_view_.uri : std::string_view{});
+    }
     return (http_message_.type == HTTPMessageType::REQUEST) ? 
            http_message_.request.uri : "";
 }
@@ -339,6 +840,9 @@ uint16_t HTTPParser::get_status_code() const {
 }
 
 std::string HTTPParser::get_reason_phrase() const {
+    if (zero_copy_) {
+        return std::string(message_view_.reason_phrase);
+    }
     return (http_message_.type == HTTPMessageType::RESPONSE) ? 
            http_message_.response.reason_phrase : "";
 }
@@ -351,6 +855,10 @@ HTTPVersion HTTPParser::get_version() const {
 }
 
 std::string HTTPParser::get_header(const std::string& name) const {
+    if (zero_copy_) {
+        return std::string(message_view_.find_header(name));
+    }
+    
     const auto& headers = (http_message_.type == HTTPMessageType::REQUEST) ? 
                          http_message_.request.headers : http_message_.response.headers;
     
@@ -361,6 +869,18 @@ std::string HTTPParser::get_header(const std::string& name) const {
 const std::unordered_map<std::string, std::string>& HTTPParser::get_headers() const {
     static const std::unordered_map<std::string, std::string> empty_headers;
     
+    if (zero_copy_) {
+        if (!view_headers_ready_) {
+            view_headers_.clear();
+            for (size_t i = 0; i < message_view_.header_count; ++i) {
+                const auto& header = message_view_.headers[i];
+                view_headers_[to_lower(std::string(header.name))] = std::string(header.value);
+            }
+            view_headers_ready_ = true;
+        }
+        return view_headers_;
+    }
+    
     if (http_message_.type == HTTPMessageType::REQUEST) {
         return http_message_.request.headers;
     } else if (http_message_.type == HTTPMessageType::RESPONSE) {
@@ -371,6 +891,9 @@ const std::unordered_map<std::string, std::string>& HTTPParser::get_headers() co
 }
 
 std::string HTTPParser::get_body() const {
+    if (zero_copy_) {
+        return std::string(message_view_.body);
+    }
     return (http_message_.type == HTTPMessageType::REQUEST) ? 
            http_message_.request.body : 
            (http_message_.type == HTTPMessageType::RESPONSE) ? 
@@ -475,14 +998,40 @@ void HTTPParser::reset() noexcept {
     http_message_.response.headers.clear();
     http_message_.response.body.clear();
     
+    // Reset zero-copy view (header slots beyond header_count are never read)
+    message_view_.type = HTTPMessageType::UNKNOWN;
+    message_view_.method = HTTPMethod::UNKNOWN;
+    message_view_.version = HTTPVersion::UNKNOWN;
+    message_view_.status_code = 0;
+    message_view_.start_line = {};
+    message_view_.uri = {};
+    message_view_.reason_phrase = {};
+    message_view_.header_count = 0;
+    message_view_.header_length = 0;
+    message_view_.body = {};
+    view_headers_ready_ = false;
+    
     is_complete_ = false;
     expected_body_length_ = 0;
     is_chunked_ = false;
+    has_content_length_ = false;
+    body_state_ = BodyState::NONE;
+    body_remaining_ = 0;
+    body_bytes_ = 0;
+    chunk_size_digits_ = 0;
+    trailer_line_.clear();
+    body_truncated_ = false;
     error_message_.clear();
 }
 
 double HTTPParser::get_progress() const noexcept {
-    return is_complete_ ? 1.0 : 0.5; // 简单的进度指示
+    if (is_complete_) {
+        return 1.0;
+    }
+    if (body_state_ == BodyState::FIXED && expected_body_length_ > 0) {
+        return 0.5 + 0.5 * static_cast<double>(expected_body_length_ - body_remaining_) / expected_body_length_;
+    }
+    return 0.5; // 简单的进度指示
 }
 
 bool HTTPParser::is_request() const {
@@ -493,6 +1042,10 @@ bool HTTPParser::is_response() const {
     return http_message_.type == HTTPMessageType::RESPONSE;
 }
 
+bool HTTPParser::is_complete() const {
+    return is_complete_;
+}
+
 std::string HTTPParser::get_error_message() const noexcept {
     return error_message_;
 }
@@ -7,10 +7,15 @@ namespace protocol_parser::parsers {
 
 HTTPSParser::HTTPSParser() 
     : handshake_messages_parsed_(0),
-      application_data_records_(0),
       alert_messages_(0) {
     reset_session();
     initialize_cipher_suites();
+    
+    TLSRecordLayer::Handlers handlers;
+    handlers.on_handshake = [this](TLSDirection, std::span<const uint8_t> message) { on_handshake(message); };
+    handlers.on_alert = [this](TLSDirection, uint8_t level, uint8_t description) { on_alert(level, description); };
+    handlers.on_handshake_done = [this](uint16_t version) { on_handshake_done(version); };
+    record_layer_.set_handlers(std::move(handlers));
 }
 
 const ProtocolInfo& HTTPSParser::get_protocol_info() const noexcept {
@@ -33,63 +38,98 @@ bool HTTPSParser::can_parse(const BufferView& buffer) const noexcept {
 }
 
 ParseResult HTTPSParser::parse(ParseContext& context) noexcept {
-    const uint8_t* data = context.buffer.data();
-    size_t length = context.buffer.size();
-    if (!data || length == 0) {
+    if (context.offset >= context.buffer.size()) {
         return ParseResult::InvalidFormat;
     }
     
-    // Add data to buffer
-    buffer_.insert(buffer_.end(), data, data + length);
-    
-    size_t offset = 0;
-    
-    // Process complete TLS records
-    while (offset + 5 <= buffer_.size()) {  // Minimum TLS record header size
-        HTTPSMessage message;
-        
-        // Parse record header
-        if (!parse_record_header(buffer_.data() + offset, message.record_header)) {
-            // Invalid record header, skip this byte and try again
-            offset++;
-            continue;
-        }
+    try {
+        const auto data = context.buffer.substr(context.offset);
         
-        // Check if we have the complete record
-        size_t total_record_size = 5 + message.record_header.length;
-        if (offset + total_record_size > buffer_.size()) {
-            // Incomplete record, wait for more data
-            return ParseResult::NeedMoreData;
+        // A hello at a message boundary tells which side is talking
+        if (data.size() > 5 && data[0] == static_cast<uint8_t>(TLSContentType::HANDSHAKE) && data[1] == 3) {
+            if (data[5] == static_cast<uint8_t>(TLSHandshakeType::CLIENT_HELLO) &&
+                record_layer_.at_message_boundary(TLSDirection::CLIENT_TO_SERVER)) {
+                direction_ = TLSDirection::CLIENT_TO_SERVER;
+            } else if (data[5] == static_cast<uint8_t>(TLSHandshakeType::SERVER_HELLO) &&
+                       record_layer_.at_message_boundary(TLSDirection::SERVER_TO_CLIENT)) {
+                direction_ = TLSDirection::SERVER_TO_CLIENT;
+            }
         }
         
-        // Parse the complete TLS record
-        if (parse_tls_record(buffer_.data() + offset, total_record_size, message)) {
-            message.session_info = current_session_;
-            update_session_state(message);
-            
-            // Store parsed message in context metadata
-            context.metadata["https_message"] = std::make_shared<HTTPSMessage>(message);
+        // Partial records and handshake messages are kept by the record layer,
+        // so the input is always consumed in full
+        active_context_ = &context;
+        const ParseResult result = record_layer_.feed(direction_, data);
+        active_context_ = nullptr;
+        if (result == ParseResult::Success) {
+            context.offset = context.buffer.size();
         }
+        return result;
         
-        offset += total_record_size;
+    } catch (const std::exception&) {
+        active_context_ = nullptr;
+        return ParseResult::InternalError;
     }
-    
-    // Remove processed data from buffer
-    if (offset > 0) {
-        buffer_.erase(buffer_.begin(), buffer_.begin() + offset);
-    }
-    
-    return ParseResult::Success;
 }
 
 void HTTPSParser::reset() noexcept {
-    buffer_.clear();
+    record_layer_.reset();
+    direction_ = TLSDirection::CLIENT_TO_SERVER;
     reset_session();
     handshake_messages_parsed_ = 0;
-    application_data_records_ = 0;
     alert_messages_ = 0;
 }
 
+void HTTPSParser::on_handshake(std::span<const uint8_t> message) {
+    HTTPSMessage parsed;
+    parsed.record_header.content_type = TLSContentType::HANDSHAKE;
+    parsed.record_header.version = current_session_.negotiated_version;
+    parsed.record_header.length = static_cast<uint16_t>(std::min<size_t>(message.size(), UINT16_MAX));
+    if (parse_handshake_message(message.data(), message.size(), parsed)) {
+        publish(parsed);
+    }
+}
+
+void HTTPSParser::on_alert(uint8_t level, uint8_t description) {
+    HTTPSMessage parsed;
+    parsed.record_header.content_type = TLSContentType::ALERT;
+    parsed.record_header.version = current_session_.negotiated_version;
+    parsed.record_header.length = 2;
+    const uint8_t alert[2] = {level, description};
+    if (parse_alert(alert, sizeof(alert), parsed.alert)) {
+        publish(parsed);
+    }
+}
+
+void HTTPSParser::on_handshake_done(uint16_t version) {
+    current_session_.state = TLSConnectionState::HANDSHAKE_COMPLETED;
+    // For TLS 1.3 this is the supported_versions selection, not the legacy field
+    if (version != 0) {
+        current_session_.negotiated_version = parse_version(version);
+    }
+    if (active_context_ != nullptr) {
+        active_context_->metadata["tls_handshake_done"] = true;
+    }
+}
+
+void HTTPSParser::publish(HTTPSMessage& message) {
+    update_session_state(message);
+    if (active_context_ == nullptr) {
+        return;
+    }
+    
+    if (fingerprint_only_) {
+        if (message.record_header.content_type == TLSContentType::HANDSHAKE &&
+            (message.handshake_header.msg_type == TLSHandshakeType::CLIENT_HELLO ||
+             message.handshake_header.msg_type == TLSHandshakeType::SERVER_HELLO)) {
+            active_context_->metadata["tls_fingerprints"] = current_session_.fingerprints;
+        }
+    } else {
+        message.session_info = current_session_;
+        active_context_->metadata["https_message"] = std::make_shared<HTTPSMessage>(message);
+    }
+}
+
 bool HTTPSParser::parse_tls_record(const uint8_t* data, size_t length, HTTPSMessage& message) {
     if (length < 5) {
         return false;
@@ -108,7 +148,6 @@ bool HTTPSParser::parse_tls_record(const uint8_t* data, size_t length, HTTPSMess
             
         case TLSContentType::APPLICATION_DATA:
             message.application_data.assign(payload, payload + payload_length);
-            application_data_records_++;
             return true;
             
         case TLSContentType::CHANGE_CIPHER_SPEC:
@@ -145,6 +184,26 @@ bool HTTPSParser::parse_handshake_message(const uint8_t* data, size_t length, HT
         return false;
     }
     
+    // Hellos are fingerprinted in one pass over the wire bytes
+    const bool is_hello = message.handshake_header.msg_type == TLSHandshakeType::CLIENT_HELLO ||
+                          message.handshake_header.msg_type == TLSHandshakeType::SERVER_HELLO;
+    if (is_hello) {
+        TLSHelloView hello;
+        if (!TLSHelloScanner::fingerprint(std::span<const uint8_t>(data, length), current_session_.fingerprints, &hello)) {
+            return false;
+        }
+        if (fingerprint_only_) {
+            if (hello.is_client) {
+                current_session_.server_name.assign(hello.server_name);
+            } else {
+                message.server_hello.version = parse_version(hello.legacy_version);
+                message.server_hello.cipher_suite = hello.cipher_suite;
+            }
+            handshake_messages_parsed_++;
+            return true;
+        }
+    }
+    
     // Store raw handshake data
     message.raw_handshake_data.assign(data, data + length);
     
@@ -542,10 +601,35 @@ Certificate HTTPSParser::parse_x509_certificate(const uint8_t* data, size_t leng
     Certificate cert;
     cert.raw_data.assign(data, data + length);
     
-    // Basic X.509 parsing would go here
-    // For now, just store the raw data
-    cert.subject = "[Certificate parsing not implemented]";
-    cert.issuer = "[Certificate parsing not implemented]";
+    const std::span<const uint8_t> der(cert.raw_data);
+    cert.parsed = certificate_cache_
+        ? certificate_cache_->get_or_parse(der)
+        : X509CertificateCache::parse_entry(der, utils::SHA256::hash(der));
+    cert.sha256 = cert.parsed->fingerprint;
+    
+    const X509CertificateView& view = cert.parsed->view;
+    if (!view.valid()) {
+        return cert;
+    }
+    
+    std::array<char, 512> name;
+    cert.subject.assign(name.data(), X509CertificateView::format_name(view.subject(), name));
+    cert.issuer.assign(name.data(), X509CertificateView::format_name(view.issuer(), name));
+    
+    static constexpr char kHex[] = "0123456789abcdef";
+    cert.serial_number.reserve(view.serial().size() * 2);
+    for (const uint8_t byte : view.serial()) {
+        cert.serial_number.push_back(kHex[byte >> 4]);
+        cert.serial_number.push_back(kHex[byte & 0x0F]);
+    }
+    
+    cert.not_before = view.not_before_text();
+    cert.not_after = view.not_after_text();
+    (void)view.for_each_subject_alt_name([&](uint8_t type, std::span<const uint8_t> value) {
+        if (type == 2) {   // dNSName
+            cert.san_dns_names.emplace_back(reinterpret_cast<const char*>(value.data()), value.size());
+        }
+    });
     
     return cert;
 }
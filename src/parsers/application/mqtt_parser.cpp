@@ -1,6 +1,7 @@
 #include "parsers/application/mqtt_parser.hpp"
 #include <cstring>
 #include <algorithm>
+#include <stdexcept>
 
 namespace protocol_parser::parsers {
 
@@ -136,46 +137,149 @@ bool MQTTParser::can_parse(const BufferView& buffer) const noexcept {
 }
 
 ParseResult MQTTParser::parse(ParseContext& context) noexcept {
-    reset();
+    if (context.offset >= context.buffer.size()) {
+        return ParseResult::NeedMoreData;
+    }
+    if (stream_failed_) {
+        return ParseResult::InvalidFormat;
+    }
 
-    const auto buffer = context.buffer;
-    const auto data = buffer.data();
-    const auto size = buffer.size();
+    try {
+        std::span<const uint8_t> input(context.buffer.data() + context.offset,
+                                       context.buffer.size() - context.offset);
+        size_t parsed = 0;
+        size_t malformed = 0;
+        const auto fail = [this] {
+            stream_failed_ = true;
+            is_malformed_ = true;
+            statistics_.malformed_count++;
+            partial_packet_.clear();
+            return ParseResult::InvalidFormat;
+        };
+
+        // 上一次 parse() 的视图到此失效
+        completed_packet_.clear();
+
+        // 先补全上一片段遗留的不完整包
+        if (!partial_packet_.empty()) {
+            auto& partial = partial_packet_;
+            size_t total = 0;
+            for (;;) {
+                const auto result = measure_packet(partial, total);
+                if (result == ParseResult::Success) {
+                    break;
+                }
+                if (result != ParseResult::NeedMoreData) {
+                    return fail();
+                }
+                // 剩余长度尚不完整，逐字节补齐（最多 4 字节）
+                if (input.empty()) {
+                    context.offset = context.buffer.size();
+                    return ParseResult::NeedMoreData;
+                }
+                partial.push_back(input.front());
+                input = input.subspan(1);
+            }
+
+            const size_t take = std::min(total - partial.size(), input.size());
+            partial.insert(partial.end(), input.begin(), input.begin() + take);
+            input = input.subspan(take);
+            if (partial.size() < total) {
+                context.offset = context.buffer.size();
+                return ParseResult::NeedMoreData;
+            }
+
+            completed_packet_.swap(partial);
+            partial.clear();
+            (process_packet(completed_packet_) ? parsed : malformed)++;
+        }
 
-    if (size < 2) {
-        return ParseResult::NeedMoreData;
+        // 完整的包直接在输入缓冲区上解析
+        while (!input.empty()) {
+            size_t total = 0;
+            const auto result = measure_packet(input, total);
+            if (result == ParseResult::NeedMoreData || (result == ParseResult::Success && total > input.size())) {
+                partial_packet_.assign(input.begin(), input.end());
+                break;
+            }
+            if (result != ParseResult::Success) {
+                return fail();
+            }
+            (process_packet(input.first(total)) ? parsed : malformed)++;
+            input = input.subspan(total);
+        }
+
+        context.offset = context.buffer.size();
+        if (parsed > 0) {
+            return ParseResult::Success;
+        }
+        return malformed > 0 ? ParseResult::InvalidFormat : ParseResult::NeedMoreData;
+
+    } catch (const std::exception&) {
+        return ParseResult::InternalError;
     }
+}
 
-    // 解析固定头部
-    size_t offset = 0;
-    auto result = parse_fixed_header(data, size, offset);
-    if (result != ParseResult::Success) {
-        return result;
+void MQTTParser::reset() noexcept {
+    mqtt_packet_ = MQTTPacket{};
+    parsed_successfully_ = false;
+    is_malformed_ = false;
+    protocol_version_ = MQTTVersion::MQTT_3_1_1;
+    partial_packet_.clear();
+    completed_packet_.clear();
+    stream_failed_ = false;
+    topic_aliases_.clear();
+}
+
+ParseResult MQTTParser::measure_packet(std::span<const uint8_t> data, size_t& total) const noexcept {
+    if (data.size() < MQTTFixedHeader::MIN_SIZE) {
+        return ParseResult::NeedMoreData;
+    }
+    if ((data[0] >> 4) == static_cast<uint8_t>(MQTTMessageType::RESERVED_0)) {
+        return ParseResult::InvalidFormat;
     }
 
-    // 解析可变头部
-    result = parse_variable_header(data, size, offset);
+    size_t offset = 1;
+    uint32_t remaining_length = 0;
+    const auto result = decode_remaining_length(data.data(), data.size(), offset, remaining_length);
     if (result != ParseResult::Success) {
         return result;
     }
+    total = offset + remaining_length;
+    return total <= max_packet_size_ ? ParseResult::Success : ParseResult::InvalidFormat;
+}
+
+bool MQTTParser::process_packet(std::span<const uint8_t> packet) {
+    mqtt_packet_ = MQTTPacket{};
+    parsed_successfully_ = false;
 
-    // 解析载荷
-    result = parse_payload(data, size, offset);
+    const uint8_t* data = packet.data();
+    const size_t size = packet.size();
+    size_t offset = 0;
+
+    // 所有读取都限制在包边界内
+    auto result = parse_fixed_header(data, size, offset);
+    if (result == ParseResult::Success) {
+        result = parse_variable_header(data, size, offset);
+    }
     if (result != ParseResult::Success) {
-        return result;
+        is_malformed_ = true;
+        statistics_.malformed_count++;
+        return false;
     }
 
     parsed_successfully_ = true;
+    is_malformed_ = false;
+    if (auto* publish = std::get_if<MQTTPublishMessage>(&mqtt_packet_.message)) {
+        resolve_topic_alias(*publish);
+    }
     update_statistics(mqtt_packet_);
     perform_security_analysis();
 
-    return ParseResult::Success;
-}
-
-void MQTTParser::reset() noexcept {
-    mqtt_packet_ = MQTTPacket{};
-    parsed_successfully_ = false;
-    is_malformed_ = false;
+    if (packet_callback_) {
+        packet_callback_(mqtt_packet_);
+    }
+    return true;
 }
 
 std::string MQTTParser::get_protocol_name() const noexcept {
@@ -282,21 +386,21 @@ std::string MQTTParser::return_code_to_string(MQTTConnectReturnCode code) noexce
     }
 }
 
-bool MQTTParser::is_valid_topic(const std::string& topic) noexcept {
+bool MQTTParser::is_valid_topic(std::string_view topic) noexcept {
     if (topic.empty() || topic.size() > MAX_TOPIC_LENGTH) {
         return false;
     }
 
     // 检查通配符
-    if (topic.find('+') != std::string::npos || topic.find('#') != std::string::npos) {
+    if (is_wildcard_topic(topic)) {
         return false;
     }
 
     return true;
 }
 
-bool MQTTParser::is_wildcard_topic(const std::string& topic) noexcept {
-    return topic.find('+') != std::string::npos || topic.find('#') != std::string::npos;
+bool MQTTParser::is_wildcard_topic(std::string_view topic) noexcept {
+    return topic.find_first_of("+#") != std::string_view::npos;
 }
 
 // ============================================================================
@@ -312,8 +416,16 @@ ParseResult MQTTParser::parse_fixed_header(const uint8_t* data, size_t size, siz
     mqtt_packet_.fixed_header.qos_level = static_cast<MQTTQoS>((first_byte >> 1) & 0x03);
     mqtt_packet_.fixed_header.retain_flag = (first_byte & 0x01) != 0;
 
+    if (mqtt_packet_.fixed_header.message_type == MQTTMessageType::PUBLISH &&
+        mqtt_packet_.fixed_header.qos_level == MQTTQoS::RESERVED) {
+        return ParseResult::InvalidFormat;
+    }
+
     // 解析剩余长度
-    mqtt_packet_.fixed_header.remaining_length = decode_remaining_length(data, size, offset);
+    auto result = decode_remaining_length(data, size, offset, mqtt_packet_.fixed_header.remaining_length);
+    if (result != ParseResult::Success) {
+        return result;
+    }
     if (offset + mqtt_packet_.fixed_header.remaining_length > size) {
         return ParseResult::NeedMoreData;
     }
@@ -345,17 +457,15 @@ ParseResult MQTTParser::parse_payload(const uint8_t* data, size_t size, size_t&
 
 ParseResult MQTTParser::parse_connect_message(const uint8_t* data, size_t size, size_t& offset) noexcept {
     MQTTConnectMessage connect_msg;
+    std::string_view value;
 
     // 协议名称
-    connect_msg.protocol_name = read_utf8_string(data, size, offset);
-    if (offset > size) return ParseResult::InvalidFormat;
+    if (!read_utf8_string(data, size, offset, value)) return ParseResult::InvalidFormat;
+    connect_msg.protocol_name.assign(value);
 
-    // 协议版本
-    if (offset >= size) return ParseResult::NeedMoreData;
+    // 协议版本、连接标志、保活
+    if (offset + 4 > size) return ParseResult::InvalidFormat;
     connect_msg.protocol_version = static_cast<MQTTVersion>(data[offset++]);
-
-    // 连接标志
-    if (offset >= size) return ParseResult::NeedMoreData;
     uint8_t flags = data[offset++];
     connect_msg.clean_session = (flags & 0x02) != 0;
     connect_msg.will_flag = (flags & 0x04) != 0;
@@ -363,66 +473,94 @@ ParseResult MQTTParser::parse_connect_message(const uint8_t* data, size_t size,
     connect_msg.will_retain = (flags & 0x20) != 0;
     connect_msg.password_flag = (flags & 0x40) != 0;
     connect_msg.username_flag = (flags & 0x80) != 0;
-
-    // 保活
-    if (offset + 2 > size) return ParseResult::NeedMoreData;
     connect_msg.keep_alive = (static_cast<uint16_t>(data[offset]) << 8) | data[offset + 1];
     offset += 2;
 
+    const bool v5 = connect_msg.protocol_version == MQTTVersion::MQTT_5_0;
+    if (v5 && parse_properties(data, size, offset, connect_msg.properties) != ParseResult::Success) {
+        return ParseResult::InvalidFormat;
+    }
+
     // Client ID
-    connect_msg.client_id = read_utf8_string(data, size, offset);
+    if (!read_utf8_string(data, size, offset, value)) return ParseResult::InvalidFormat;
+    connect_msg.client_id.assign(value);
 
-    // Will Topic 和 Will Message
+    // Will Topic 和 Will Message（5.0 在其前有遗嘱属性）
     if (connect_msg.will_flag) {
-        connect_msg.will_topic = read_utf8_string(data, size, offset);
-        connect_msg.will_message = read_utf8_string(data, size, offset);
+        std::vector<MQTTProperty> will_properties;
+        if (v5 && parse_properties(data, size, offset, will_properties) != ParseResult::Success) {
+            return ParseResult::InvalidFormat;
+        }
+        if (!read_utf8_string(data, size, offset, value)) return ParseResult::InvalidFormat;
+        connect_msg.will_topic.assign(value);
+        if (!read_utf8_string(data, size, offset, value)) return ParseResult::InvalidFormat;
+        connect_msg.will_message.assign(value);
     }
 
     // Username 和 Password
     if (connect_msg.username_flag) {
-        connect_msg.username = read_utf8_string(data, size, offset);
+        if (!read_utf8_string(data, size, offset, value)) return ParseResult::InvalidFormat;
+        connect_msg.username.assign(value);
     }
     if (connect_msg.password_flag) {
-        connect_msg.password = read_utf8_string(data, size, offset);
+        if (!read_utf8_string(data, size, offset, value)) return ParseResult::InvalidFormat;
+        connect_msg.password.assign(value);
+    }
+
+    // 之后同一条流上的包按该版本解析
+    switch (connect_msg.protocol_version) {
+        case MQTTVersion::MQTT_3_1:
+        case MQTTVersion::MQTT_3_1_1:
+        case MQTTVersion::MQTT_5_0:
+            protocol_version_ = connect_msg.protocol_version;
+            break;
+        default:
+            break;
     }
 
-    mqtt_packet_.message = connect_msg;
+    mqtt_packet_.message = std::move(connect_msg);
     return ParseResult::Success;
 }
 
 ParseResult MQTTParser::parse_connack_message(const uint8_t* data, size_t size, size_t& offset) noexcept {
-    if (offset + 2 > size) return ParseResult::NeedMoreData;
+    if (offset + 2 > size) return ParseResult::InvalidFormat;
 
     MQTTConnackMessage connack;
     connack.session_present = (data[offset++] & 0x01) != 0;
     connack.return_code = static_cast<MQTTConnectReturnCode>(data[offset++]);
 
-    mqtt_packet_.message = connack;
+    mqtt_packet_.message = std::move(connack);
     return ParseResult::Success;
 }
 
 ParseResult MQTTParser::parse_publish_message(const uint8_t* data, size_t size, size_t& offset) noexcept {
     MQTTPublishMessage pub_msg;
+    const bool v5 = protocol_version_ == MQTTVersion::MQTT_5_0;
 
-    // Topic
-    pub_msg.topic = read_utf8_string(data, size, offset);
-    if (pub_msg.topic.empty()) return ParseResult::InvalidFormat;
+    // Topic（5.0 可用主题别名代替，此时为空）
+    if (!read_utf8_string(data, size, offset, pub_msg.topic)) return ParseResult::InvalidFormat;
+    if (pub_msg.topic.empty() && !v5) return ParseResult::InvalidFormat;
 
     // Packet ID (if QoS > 0)
     if (mqtt_packet_.fixed_header.qos_level != MQTTQoS::AT_MOST_ONCE) {
-        if (offset + 2 > size) return ParseResult::NeedMoreData;
+        if (offset + 2 > size) return ParseResult::InvalidFormat;
         pub_msg.packet_id = (static_cast<uint16_t>(data[offset]) << 8) | data[offset + 1];
         offset += 2;
     }
 
-    // Payload
-    size_t payload_size = mqtt_packet_.fixed_header.remaining_length - (offset - 2); // Adjust for header
-    if (offset + payload_size <= size) {
-        pub_msg.payload.assign(data + offset, data + offset + payload_size);
-        offset += payload_size;
+    if (v5) {
+        const size_t properties_begin = offset;
+        if (parse_properties(data, size, offset, pub_msg.properties) != ParseResult::Success ||
+            !find_topic_alias(data, properties_begin, offset, pub_msg.topic_alias)) {
+            return ParseResult::InvalidFormat;
+        }
     }
 
-    mqtt_packet_.message = pub_msg;
+    // Payload：包内剩余的全部字节
+    pub_msg.payload = std::span<const uint8_t>(data + offset, size - offset);
+    offset = size;
+
+    mqtt_packet_.message = std::move(pub_msg);
     return ParseResult::Success;
 }
 
@@ -430,89 +568,192 @@ ParseResult MQTTParser::parse_subscribe_message(const uint8_t* data, size_t size
     MQTTSubscribeMessage sub_msg;
 
     // Packet ID
-    if (offset + 2 > size) return ParseResult::NeedMoreData;
+    if (offset + 2 > size) return ParseResult::InvalidFormat;
     sub_msg.packet_id = (static_cast<uint16_t>(data[offset]) << 8) | data[offset + 1];
     offset += 2;
 
-    // Topics (简化：只读取第一个)
-    while (offset + 2 <= size) {
-        std::string topic = read_utf8_string(data, size, offset);
-        if (topic.empty()) break;
-
-        MQTTSubscribeMessage::TopicFilter filter;
-        filter.topic = topic;
+    if (protocol_version_ == MQTTVersion::MQTT_5_0 &&
+        parse_properties(data, size, offset, sub_msg.properties) != ParseResult::Success) {
+        return ParseResult::InvalidFormat;
+    }
 
-        if (offset < size) {
-            uint8_t options = data[offset++];
-            filter.max_qos = static_cast<MQTTQoS>(options & 0x03);
+    // 过滤器列表一直延续到包尾，每项为过滤器 + 订阅选项
+    while (offset < size) {
+        std::string_view topic;
+        if (!read_utf8_string(data, size, offset, topic) || offset >= size) {
+            return ParseResult::InvalidFormat;
         }
 
-        sub_msg.topic_filters.push_back(filter);
+        MQTTSubscribeMessage::TopicFilter filter;
+        filter.topic.assign(topic);
+        const uint8_t options = data[offset++];
+        filter.max_qos = static_cast<MQTTQoS>(options & 0x03);
+        filter.no_local = (options & 0x04) != 0;
+        filter.retain_as_published = (options & 0x08) != 0;
+        filter.retain_handling = (options >> 4) & 0x03;
+
+        sub_msg.topic_filters.push_back(std::move(filter));
     }
 
-    mqtt_packet_.message = sub_msg;
+    mqtt_packet_.message = std::move(sub_msg);
     return ParseResult::Success;
 }
 
-uint32_t MQTTParser::decode_remaining_length(const uint8_t* data, size_t size, size_t& offset) noexcept {
-    uint32_t value = 0;
-    uint8_t multiplier = 1;
-    size_t index = offset;
-
-    while (index < size) {
-        uint8_t encoded_byte = data[index++];
-        value += (encoded_byte & 0x7F) * multiplier;
-
-        if ((encoded_byte & 0x80) == 0) {
-            offset = index;
-            return value;
+ParseResult MQTTParser::decode_remaining_length(const uint8_t* data, size_t size, size_t& offset,
+                                                uint32_t& value) noexcept {
+    value = 0;
+    for (size_t i = 0; i < 4; ++i) {
+        if (offset + i >= size) {
+            return ParseResult::NeedMoreData;
         }
-
-        multiplier *= 0x80;
-        if (multiplier > 0x08000000) {
-            offset = index;
-            return value; // Invalid, but return what we have
+        const uint8_t encoded_byte = data[offset + i];
+        value |= static_cast<uint32_t>(encoded_byte & 0x7F) << (7 * i);
+        if ((encoded_byte & 0x80) == 0) {
+            offset += i + 1;
+            return ParseResult::Success;
         }
     }
-
-    offset = index;
-    return value;
+    // 第 4 字节仍有延续位
+    return ParseResult::InvalidFormat;
 }
 
-std::string MQTTParser::read_utf8_string(const uint8_t* data, size_t size, size_t& offset) noexcept {
+bool MQTTParser::read_utf8_string(const uint8_t* data, size_t size, size_t& offset,
+                                  std::string_view& value) noexcept {
     if (offset + 2 > size) {
-        offset = size;
-        return "";
+        return false;
     }
 
-    uint16_t len = (static_cast<uint16_t>(data[offset]) << 8) | data[offset + 1];
-    offset += 2;
-
-    if (offset + len > size) {
-        offset = size;
-        return "";
+    const size_t len = (static_cast<size_t>(data[offset]) << 8) | data[offset + 1];
+    if (len > size - offset - 2) {
+        return false;
     }
 
-    std::string result(reinterpret_cast<const char*>(data + offset), len);
-    offset += len;
-    return result;
+    value = std::string_view(reinterpret_cast<const char*>(data + offset + 2), len);
+    offset += 2 + len;
+    return true;
 }
 
 ParseResult MQTTParser::parse_properties(const uint8_t* data, size_t size, size_t& offset,
                                         std::vector<MQTTProperty>& properties) noexcept {
-    // 简化实现：跳过属性解析
-    (void)data;
-    (void)size;
-    (void)offset;
+    // 属性内容暂不解码，只按属性长度跳过
     (void)properties;
+    uint32_t length = 0;
+    if (decode_remaining_length(data, size, offset, length) != ParseResult::Success || length > size - offset) {
+        return ParseResult::InvalidFormat;
+    }
+    offset += length;
     return ParseResult::Success;
 }
 
+bool MQTTParser::find_topic_alias(const uint8_t* data, size_t begin, size_t end, uint16_t& alias) noexcept {
+    size_t offset = begin;
+    uint32_t length = 0;
+    if (decode_remaining_length(data, end, offset, length) != ParseResult::Success) {
+        return false;
+    }
+
+    alias = 0;
+    while (offset < end) {
+        const auto type = static_cast<MQTTPropertyType>(data[offset++]);
+        size_t value_size = 0;
+        switch (type) {
+            case MQTTPropertyType::PAYLOAD_FORMAT_INDICATOR:
+            case MQTTPropertyType::REQUEST_PROBLEM_INFORMATION:
+            case MQTTPropertyType::REQUEST_RESPONSE_INFORMATION:
+            case MQTTPropertyType::MAXIMUM_QOS:
+            case MQTTPropertyType::RETAIN_AVAILABLE:
+            case MQTTPropertyType::WILDCARD_SUBSCRIPTION_AVAILABLE:
+            case MQTTPropertyType::SUBSCRIPTION_IDENTIFIER_AVAILABLE:
+            case MQTTPropertyType::SHARED_SUBSCRIPTION_AVAILABLE:
+                value_size = 1;
+                break;
+            case MQTTPropertyType::SERVER_KEEP_ALIVE:
+            case MQTTPropertyType::RECEIVE_MAXIMUM:
+            case MQTTPropertyType::TOPIC_ALIAS_MAXIMUM:
+            case MQTTPropertyType::TOPIC_ALIAS:
+                value_size = 2;
+                break;
+            case MQTTPropertyType::MESSAGE_EXPIRY_INTERVAL:
+            case MQTTPropertyType::SESSION_EXPIRY_INTERVAL:
+            case MQTTPropertyType::WILL_DELAY_INTERVAL:
+            case MQTTPropertyType::MAXIMUM_PACKET_SIZE:
+                value_size = 4;
+                break;
+            case MQTTPropertyType::SUBSCRIPTION_IDENTIFIER: {
+                uint32_t identifier = 0;
+                if (decode_remaining_length(data, end, offset, identifier) != ParseResult::Success) {
+                    return false;
+                }
+                continue;
+            }
+            case MQTTPropertyType::USER_PROPERTY: {
+                std::string_view name;
+                std::string_view value;
+                if (!read_utf8_string(data, end, offset, name) || !read_utf8_string(data, end, offset, value)) {
+                    return false;
+                }
+                continue;
+            }
+            case MQTTPropertyType::CONTENT_TYPE:
+            case MQTTPropertyType::RESPONSE_TOPIC:
+            case MQTTPropertyType::CORRELATION_DATA:
+            case MQTTPropertyType::ASSIGNED_CLIENT_IDENTIFIER:
+            case MQTTPropertyType::AUTHENTICATION_METHOD:
+            case MQTTPropertyType::AUTHENTICATION_DATA:
+            case MQTTPropertyType::RESPONSE_INFORMATION:
+            case MQTTPropertyType::SERVER_REFERENCE:
+            case MQTTPropertyType::REASON_STRING: {
+                std::string_view value;
+                if (!read_utf8_string(data, end, offset, value)) {
+                    return false;
+                }
+                continue;
+            }
+            default:
+                // 未知属性无法确定长度，停止查找
+                return true;
+        }
+
+        if (value_size > end - offset) {
+            return false;
+        }
+        if (type == MQTTPropertyType::TOPIC_ALIAS) {
+            alias = static_cast<uint16_t>((data[offset] << 8) | data[offset + 1]);
+            // 别名 0 不合法
+            if (alias == 0) {
+                return false;
+            }
+        }
+        offset += value_size;
+    }
+    return true;
+}
+
+void MQTTParser::resolve_topic_alias(MQTTPublishMessage& publish) {
+    if (publish.topic_alias == 0) {
+        return;
+    }
+    if (publish.topic.empty()) {
+        const auto it = topic_aliases_.find(publish.topic_alias);
+        if (it != topic_aliases_.end()) {
+            publish.topic = it->second;
+        }
+        return;
+    }
+    // 同一别名可被重新指向其他主题
+    const auto it = topic_aliases_.find(publish.topic_alias);
+    if (it != topic_aliases_.end()) {
+        it->second.assign(publish.topic);
+    } else if (topic_aliases_.size() < MAX_TOPIC_ALIASES) {
+        topic_aliases_.emplace(publish.topic_alias, std::string(publish.topic));
+    }
+}
+
 bool MQTTParser::validate_fixed_header() const noexcept {
     return mqtt_packet_.fixed_header.is_valid();
 }
 
-bool MQTTParser::validate_topic_name(const std::string& topic) const noexcept {
+bool MQTTParser::validate_topic_name(std::string_view topic) const noexcept {
     return is_valid_topic(topic);
 }
 
@@ -524,21 +765,54 @@ void MQTTParser::perform_security_analysis() noexcept {
     // 简化实现
 }
 
-void MQTTParser::update_statistics(const MQTTPacket& packet) noexcept {
+MQTTUsageCollector& MQTTParser::usage_collector_for_update() {
+    if (!usage_collector_) {
+        usage_collector_ = std::make_shared<MQTTUsageCollector>();
+    }
+    return *usage_collector_;
+}
+
+void MQTTParser::update_statistics(const MQTTPacket& packet) {
     statistics_.total_packets++;
 
     switch (packet.fixed_header.message_type) {
-        case MQTTMessageType::CONNECT:
+        case MQTTMessageType::CONNECT: {
             statistics_.connect_count++;
+            const auto& connect = std::get<MQTTConnectMessage>(packet.message);
+            switch (connect.protocol_version) {
+                case MQTTVersion::MQTT_3_1: statistics_.v3_1_count++; break;
+                case MQTTVersion::MQTT_3_1_1: statistics_.v3_1_1_count++; break;
+                case MQTTVersion::MQTT_5_0: statistics_.v5_0_count++; break;
+                default: break;
+            }
+            usage_collector_for_update().record_connect(connect.client_id);
             break;
+        }
         case MQTTMessageType::CONNACK:
             statistics_.connack_count++;
             break;
-        case MQTTMessageType::PUBLISH:
+        case MQTTMessageType::PUBLISH: {
             statistics_.publish_count++;
+            const auto& publish = std::get<MQTTPublishMessage>(packet.message);
+            statistics_.publish_bytes += publish.payload.size();
+            // 别名未知的 PUBLISH 没有主题可匹配，不计入未匹配
+            if (!publish.topic.empty() &&
+                usage_collector_for_update().record_publish(publish.topic, publish.payload.size()) == 0) {
+                statistics_.unmatched_publish++;
+            }
             break;
-        case MQTTMessageType::SUBSCRIBE:
+        }
+        case MQTTMessageType::SUBSCRIBE: {
             statistics_.subscribe_count++;
+            // 订阅方的过滤器直接登记，之后发布方的 PUBLISH 即可按订阅计数
+            auto& collector = usage_collector_for_update();
+            for (const auto& filter : std::get<MQTTSubscribeMessage>(packet.message).topic_filters) {
+                (void)collector.add_subscription(filter.topic);
+            }
+            break;
+        }
+        case MQTTMessageType::UNSUBSCRIBE:
+            statistics_.unsubscribe_count++;
             break;
         case MQTTMessageType::PINGREQ:
             statistics_.pingreq_count++;
@@ -0,0 +1,161 @@
+#include "parsers/application/mqtt_topic_trie.hpp"
+#include <algorithm>
+
+namespace protocol_parser::parsers {
+
+namespace {
+    constexpr std::string_view kSharePrefix = "$share/";
+    constexpr size_t kMaxFilterLength = 65535;
+
+    // 共享订阅 "$share/<组>/<过滤器>"：组名非空且不含通配符
+    std::string_view strip_share(std::string_view filter) noexcept {
+        if (!filter.starts_with(kSharePrefix)) {
+            return filter;
+        }
+        const auto rest = filter.substr(kSharePrefix.size());
+        const size_t slash = rest.find('/');
+        if (slash == 0 || slash == std::string_view::npos ||
+            rest.substr(0, slash).find_first_of("+#") != std::string_view::npos) {
+            return {};
+        }
+        return rest.substr(slash + 1);
+    }
+}
+
+bool MQTTTopicTrie::is_valid_filter(std::string_view filter) noexcept {
+    filter = strip_share(filter);
+    if (filter.empty() || filter.size() > kMaxFilterLength) {
+        return false;
+    }
+    for (size_t i = 0; i < filter.size(); ++i) {
+        const char c = filter[i];
+        if (c == '+' || c == '#') {
+            // 通配符必须独占一层，'#' 还必须是最后一层
+            const bool starts_level = i == 0 || filter[i - 1] == '/';
+            const bool ends_level = i + 1 == filter.size() || filter[i + 1] == '/';
+            if (!starts_level || !ends_level || (c == '#' && i + 1 != filter.size())) {
+                return false;
+            }
+        } else if (c == '\0') {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool MQTTTopicTrie::add(std::string_view filter, uint32_t& id) {
+    if (!is_valid_filter(filter)) {
+        return false;
+    }
+    const auto path = strip_share(filter);
+
+    if (build_.empty()) {
+        build_.emplace_back();
+    }
+
+    uint32_t node = 0;
+    bool multi = false;
+    for (size_t position = 0; position <= path.size();) {
+        const size_t slash = path.find('/', position);
+        const size_t end = slash == std::string_view::npos ? path.size() : slash;
+        const auto level = path.substr(position, end - position);
+        position = end + 1;
+
+        if (level == "#") {
+            multi = true;
+            break;
+        }
+        if (level == "+") {
+            if (build_[node].plus == kNone) {
+                build_[node].plus = static_cast<uint32_t>(build_.size());
+                build_.emplace_back();
+            }
+            node = build_[node].plus;
+            continue;
+        }
+        auto it = build_[node].children.find(level);
+        if (it == build_[node].children.end()) {
+            const auto child = static_cast<uint32_t>(build_.size());
+            build_[node].children.emplace(std::string(level), child);
+            build_.emplace_back();
+            node = child;
+        } else {
+            node = it->second;
+        }
+    }
+
+    uint32_t& slot = multi ? build_[node].multi : build_[node].exact;
+    if (slot == kNone) {
+        slot = static_cast<uint32_t>(subscriptions_.size());
+        subscriptions_.push_back(Subscription{std::string(filter)});
+        dirty_ = true;
+    }
+    id = slot;
+    return true;
+}
+
+void MQTTTopicTrie::compile() {
+    nodes_.assign(build_.size(), Node{});
+    edges_.clear();
+    text_.clear();
+
+    // 构建节点与展平节点一一对应；std::map 已按层名排序
+    for (size_t i = 0; i < build_.size(); ++i) {
+        const BuildNode& source = build_[i];
+        Node& node = nodes_[i];
+        node.first_edge = static_cast<uint32_t>(edges_.size());
+        node.edge_count = static_cast<uint32_t>(source.children.size());
+        node.plus = source.plus;
+        node.exact = source.exact;
+        node.multi = source.multi;
+        for (const auto& [level, child] : source.children) {
+            edges_.push_back(Edge{static_cast<uint32_t>(text_.size()), static_cast<uint32_t>(level.size()), child});
+            text_ += level;
+        }
+    }
+    dirty_ = false;
+}
+
+uint32_t MQTTTopicTrie::find_child(const Node& node, std::string_view level) const noexcept {
+    const Edge* begin = edges_.data() + node.first_edge;
+    const Edge* end = begin + node.edge_count;
+    const auto text = [this](const Edge& edge) {
+        return std::string_view(text_).substr(edge.text_offset, edge.text_length);
+    };
+    const Edge* it = std::lower_bound(begin, end, level, [&](const Edge& edge, std::string_view value) {
+        return text(edge) < value;
+    });
+    return (it != end && text(*it) == level) ? it->node : kNone;
+}
+
+size_t MQTTTopicTrie::record(std::string_view topic, size_t payload_bytes) {
+    if (dirty_) {
+        compile();
+    }
+    size_t matched = 0;
+    match(topic, [&](uint32_t id) {
+        auto& subscription = subscriptions_[id];
+        ++subscription.messages;
+        subscription.bytes += payload_bytes;
+        ++matched;
+    });
+    return matched;
+}
+
+void MQTTTopicTrie::reset_counters() noexcept {
+    for (auto& subscription : subscriptions_) {
+        subscription.messages = 0;
+        subscription.bytes = 0;
+    }
+}
+
+void MQTTTopicTrie::clear() {
+    build_.clear();
+    subscriptions_.clear();
+    nodes_.clear();
+    edges_.clear();
+    text_.clear();
+    dirty_ = false;
+}
+
+} // namespace protocol_parser::parsers
@@ -0,0 +1,66 @@
+#include "parsers/application/mqtt_usage_collector.hpp"
+
+namespace protocol_parser::parsers {
+
+MQTTUsageCollector::MQTTUsageCollector() : MQTTUsageCollector(Config{}) {}
+
+MQTTUsageCollector::MQTTUsageCollector(const Config& config)
+    : config_(config),
+      topic_usage_(config.top_k_capacity),
+      client_usage_(config.top_k_capacity) {}
+
+void MQTTUsageCollector::record_connect(std::string_view client_id) {
+    std::lock_guard lock(mutex_);
+    client_usage_.add(client_id);
+}
+
+size_t MQTTUsageCollector::record_publish(std::string_view topic, size_t payload_bytes) {
+    std::lock_guard lock(mutex_);
+    if (!topic.empty()) {
+        topic_usage_.add(topic);
+    }
+    if (subscriptions_.empty()) {
+        return kNoSubscriptions;
+    }
+    return subscriptions_.record(topic, payload_bytes);
+}
+
+bool MQTTUsageCollector::add_subscription(std::string_view filter) {
+    std::lock_guard lock(mutex_);
+    if (subscriptions_.subscriptions().size() >= config_.max_subscriptions) {
+        return false;
+    }
+    uint32_t id = 0;
+    return subscriptions_.add(filter, id);
+}
+
+std::vector<utils::HeavyHitterSketch::Entry> MQTTUsageCollector::top_topics(size_t k) const {
+    std::lock_guard lock(mutex_);
+    return topic_usage_.top(k);
+}
+
+std::vector<utils::HeavyHitterSketch::Entry> MQTTUsageCollector::top_clients(size_t k) const {
+    std::lock_guard lock(mutex_);
+    return client_usage_.top(k);
+}
+
+std::vector<MQTTTopicTrie::Subscription> MQTTUsageCollector::subscriptions() const {
+    std::lock_guard lock(mutex_);
+    return subscriptions_.subscriptions();
+}
+
+void MQTTUsageCollector::reset_counters() {
+    std::lock_guard lock(mutex_);
+    topic_usage_.clear();
+    client_usage_.clear();
+    subscriptions_.reset_counters();
+}
+
+void MQTTUsageCollector::clear() {
+    std::lock_guard lock(mutex_);
+    topic_usage_.clear();
+    client_usage_.clear();
+    subscriptions_.clear();
+}
+
+} // namespace protocol_parser::parsers
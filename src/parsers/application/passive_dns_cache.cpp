@@ -0,0 +1,295 @@
+#include "parsers/application/passive_dns_cache.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+namespace protocol_parser::parsers {
+
+namespace {
+    constexpr size_t kMinCapacity = 64;
+    constexpr size_t kMinArenaBytes = 4096;
+    constexpr uint64_t kMicrosPerSecond = 1'000'000;
+
+    constexpr uint16_t kTypeA = static_cast<uint16_t>(DNSRecordType::A);
+    constexpr uint16_t kTypeAAAA = static_cast<uint16_t>(DNSRecordType::AAAA);
+
+    inline uint64_t mix64(uint64_t value) noexcept {
+        value ^= value >> 33;
+        value *= 0xff51afd7ed558ccdULL;
+        value ^= value >> 33;
+        value *= 0xc4ceb9fe1a85ec53ULL;
+        value ^= value >> 33;
+        return value;
+    }
+
+    inline std::array<uint32_t, 4> address_words(const PassiveDNSAddress& address) noexcept {
+        std::array<uint32_t, 4> words;
+        std::memcpy(words.data(), address.bytes.data(), sizeof(words));
+        return words;
+    }
+}
+
+PassiveDNSAddress PassiveDNSAddress::from_ipv4(uint32_t ipv4) noexcept {
+    PassiveDNSAddress address;
+    address.bytes[10] = 0xFF;
+    address.bytes[11] = 0xFF;
+    address.bytes[12] = static_cast<uint8_t>(ipv4 >> 24);
+    address.bytes[13] = static_cast<uint8_t>(ipv4 >> 16);
+    address.bytes[14] = static_cast<uint8_t>(ipv4 >> 8);
+    address.bytes[15] = static_cast<uint8_t>(ipv4);
+    return address;
+}
+
+PassiveDNSAddress PassiveDNSAddress::from_ipv6(std::span<const uint8_t, 16> ipv6) noexcept {
+    PassiveDNSAddress address;
+    std::memcpy(address.bytes.data(), ipv6.data(), 16);
+    return address;
+}
+
+PassiveDNSCache::PassiveDNSCache() : PassiveDNSCache(Config{}) {}
+
+PassiveDNSCache::PassiveDNSCache(const Config& config) : config_(config) {
+    const size_t capacity = std::bit_ceil(std::max(config_.capacity, kMinCapacity));
+    slots_ = std::make_unique<Slot[]>(capacity);
+    mask_ = capacity - 1;
+
+    const size_t arena_bytes = std::bit_ceil(std::max(config_.name_arena_bytes, kMinArenaBytes));
+    arena_ = std::make_unique<std::atomic<char>[]>(arena_bytes);
+    arena_mask_ = arena_bytes - 1;
+}
+
+size_t PassiveDNSCache::home_slot(const PassiveDNSAddress& address) const noexcept {
+    const auto words = address_words(address);
+    const uint64_t high = (static_cast<uint64_t>(words[0]) << 32) | words[1];
+    const uint64_t low = (static_cast<uint64_t>(words[2]) << 32) | words[3];
+    return static_cast<size_t>(mix64(high ^ mix64(low))) & mask_;
+}
+
+bool PassiveDNSCache::arena_contains(uint64_t position, uint32_t length) const noexcept {
+    // Bytes [position, position + length) survive until the head moves a full ring past them
+    const uint64_t head = arena_head_.load(std::memory_order_relaxed);
+    return position + length <= head && head - position <= arena_mask_ + 1;
+}
+
+PassiveDNSCache::InternedName PassiveDNSCache::intern(std::string_view name) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (const char c : name) {
+        hash = (hash ^ static_cast<uint8_t>(c)) * 0x100000001b3ULL;
+    }
+
+    // Reuse the latest copy while it is in the newer half of the ring, so it outlives
+    // the entries about to point at it
+    const uint64_t head = arena_head_.load(std::memory_order_relaxed);
+    auto it = interned_.find(hash);
+    if (it != interned_.end() && it->second.length == name.size() &&
+        head - it->second.position <= (arena_mask_ + 1) / 2) {
+        bool same = true;
+        for (size_t i = 0; i < name.size() && same; ++i) {
+            same = arena_[(it->second.position + i) & arena_mask_].load(std::memory_order_relaxed) == name[i];
+        }
+        if (same) {
+            return it->second;
+        }
+    }
+
+    // Publish the new head before overwriting: a reader that copies any new byte
+    // is then guaranteed to see the head that invalidates its old position
+    const InternedName interned{head, static_cast<uint32_t>(name.size())};
+    arena_head_.store(head + name.size(), std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < name.size(); ++i) {
+        arena_[(head + i) & arena_mask_].store(name[i], std::memory_order_relaxed);
+    }
+
+    // The map only speeds up deduplication; dropping it is always safe
+    if (interned_.size() >= capacity()) {
+        interned_.clear();
+    }
+    interned_[hash] = interned;
+    ++stats_.names_interned;
+    return interned;
+}
+
+void PassiveDNSCache::insert_locked(const PassiveDNSAddress& address, const InternedName& name,
+                                    uint64_t expires_at_us, uint64_t now_us) {
+    const auto words = address_words(address);
+    const size_t home = home_slot(address);
+
+    // Same address, else a free or expired slot, else the entry that expires first
+    size_t target = home;
+    bool found_match = false;
+    bool found_free = false;
+    uint64_t earliest_expiry = UINT64_MAX;
+
+    for (size_t i = 0; i < kProbeWindow; ++i) {
+        const size_t index = (home + i) & mask_;
+        const Slot& slot = slots_[index];
+        const uint64_t expires = slot.expires_at_us.load(std::memory_order_relaxed);
+
+        if (expires != 0 && slot.address[0].load(std::memory_order_relaxed) == words[0] &&
+            slot.address[1].load(std::memory_order_relaxed) == words[1] &&
+            slot.address[2].load(std::memory_order_relaxed) == words[2] &&
+            slot.address[3].load(std::memory_order_relaxed) == words[3]) {
+            target = index;
+            found_match = true;
+            break;
+        }
+        if (!found_free && (expires == 0 || expires <= now_us)) {
+            target = index;
+            found_free = true;
+        } else if (!found_free && expires < earliest_expiry) {
+            target = index;
+            earliest_expiry = expires;
+        }
+    }
+
+    if (found_match) {
+        ++stats_.records_refreshed;
+    } else {
+        ++stats_.records_inserted;
+        if (!found_free) {
+            ++stats_.evictions;
+        }
+    }
+
+    Slot& slot = slots_[target];
+    const uint32_t sequence = slot.sequence.load(std::memory_order_relaxed);
+    slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < 4; ++i) {
+        slot.address[i].store(words[i], std::memory_order_relaxed);
+    }
+    slot.name_position.store(name.position, std::memory_order_relaxed);
+    slot.name_length.store(name.length, std::memory_order_relaxed);
+    slot.expires_at_us.store(expires_at_us, std::memory_order_relaxed);
+    slot.sequence.store(sequence + 2, std::memory_order_release);
+}
+
+void PassiveDNSCache::insert(const PassiveDNSAddress& address, std::string_view name,
+                             uint32_t ttl_seconds, uint64_t now_us) {
+    if (name.empty() || name.size() > DNSMessageView::kMaxNameLength) {
+        return;
+    }
+    const uint32_t ttl = std::clamp(ttl_seconds, config_.min_ttl_seconds, config_.max_ttl_seconds);
+
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    insert_locked(address, intern(name), now_us + ttl * kMicrosPerSecond, now_us);
+}
+
+void PassiveDNSCache::observe(const DNSMessageView& response, uint64_t now_us) {
+    const auto& header = response.header();
+    const bool is_response = (header.flags & 0x8000) != 0;
+    const uint8_t rcode = header.flags & 0x000F;
+    if (!is_response || rcode != 0 || response.questions().empty() || response.answers().empty()) {
+        return;
+    }
+
+    // Names are stored lowercased so lookups give one spelling per name
+    std::array<char, DNSMessageView::kMaxNameLength> buffer;
+    const size_t length = response.copy_name(response.questions()[0].qname, buffer.data(), buffer.size());
+    if (length == 0) {
+        return;
+    }
+    for (size_t i = 0; i < length; ++i) {
+        if (buffer[i] >= 'A' && buffer[i] <= 'Z') {
+            buffer[i] = static_cast<char>(buffer[i] + ('a' - 'A'));
+        }
+    }
+    const std::string_view name(buffer.data(), length);
+
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    ++stats_.responses_observed;
+
+    InternedName interned{};
+    bool have_name = false;
+    for (const auto& record : response.answers()) {
+        PassiveDNSAddress address;
+        if (record.type == kTypeA && record.rdata.size() == 4) {
+            address = PassiveDNSAddress::from_ipv4(record.rdata.read_be32(0));
+        } else if (record.type == kTypeAAAA && record.rdata.size() == 16) {
+            address = PassiveDNSAddress::from_ipv6(std::span<const uint8_t, 16>(record.rdata.data(), 16));
+        } else {
+            continue;
+        }
+
+        if (!have_name) {
+            interned = intern(name);
+            have_name = true;
+        }
+        const uint32_t ttl = std::clamp(record.ttl, config_.min_ttl_seconds, config_.max_ttl_seconds);
+        insert_locked(address, interned, now_us + ttl * kMicrosPerSecond, now_us);
+    }
+}
+
+bool PassiveDNSCache::lookup(const PassiveDNSAddress& address, uint64_t now_us, PassiveDNSName& out) const noexcept {
+    const auto words = address_words(address);
+    const size_t home = home_slot(address);
+
+    for (size_t i = 0; i < kProbeWindow; ++i) {
+        const Slot& slot = slots_[(home + i) & mask_];
+
+        for (int attempt = 0; attempt < kReadAttempts; ++attempt) {
+            const uint32_t before = slot.sequence.load(std::memory_order_acquire);
+            if (before & 1) {
+                continue;   // Writer in progress
+            }
+
+            const bool matches = slot.address[0].load(std::memory_order_relaxed) == words[0] &&
+                                 slot.address[1].load(std::memory_order_relaxed) == words[1] &&
+                                 slot.address[2].load(std::memory_order_relaxed) == words[2] &&
+                                 slot.address[3].load(std::memory_order_relaxed) == words[3];
+            const uint64_t position = slot.name_position.load(std::memory_order_relaxed);
+            const uint32_t length = slot.name_length.load(std::memory_order_relaxed);
+            const uint64_t expires = slot.expires_at_us.load(std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) != before) {
+                continue;
+            }
+
+            if (!matches || expires == 0) {
+                break;   // Consistent read of some other address: try the next slot
+            }
+            if (expires <= now_us || length > out.data.size()) {
+                return false;
+            }
+
+            for (uint32_t k = 0; k < length; ++k) {
+                out.data[k] = arena_[(position + k) & arena_mask_].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (!arena_contains(position, length)) {
+                return false;   // Name overwritten by newer ones
+            }
+
+            out.length = static_cast<uint8_t>(length);
+            out.expires_at_us = expires;
+            return true;
+        }
+    }
+    return false;
+}
+
+PassiveDNSCache::Statistics PassiveDNSCache::statistics() const {
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    return stats_;
+}
+
+void PassiveDNSCache::clear() {
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    for (size_t i = 0; i <= mask_; ++i) {
+        Slot& slot = slots_[i];
+        if (slot.expires_at_us.load(std::memory_order_relaxed) == 0) {
+            continue;
+        }
+        const uint32_t sequence = slot.sequence.load(std::memory_order_relaxed);
+        slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.expires_at_us.store(0, std::memory_order_relaxed);
+        slot.sequence.store(sequence + 2, std::memory_order_release);
+    }
+    interned_.clear();
+    stats_ = Statistics{};
+}
+
+} // namespace protocol_parser::parsers
@@ -0,0 +1,270 @@
+#include "parsers/application/protobuf_scanner.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace protocol_parser::parsers {
+
+namespace {
+    constexpr uint32_t kMaxFieldNumber = (1u << 29) - 1;
+
+    // Caller guarantees value != 0
+    inline unsigned int count_trailing_zeros64(uint64_t value) {
+        #ifdef _MSC_VER
+            unsigned long index = 0;
+            _BitScanForward64(&index, value);
+            return static_cast<unsigned int>(index);
+        #else
+            return static_cast<unsigned int>(__builtin_ctzll(value));
+        #endif
+    }
+}
+
+bool ProtobufScanner::decode_varint(const uint8_t* data, size_t size,
+                                    uint64_t& value, size_t& length) noexcept {
+    // 标签与小整数绝大多数是单字节
+    if (size > 0 && data[0] < 0x80) {
+        value = data[0];
+        length = 1;
+        return true;
+    }
+
+    if (size >= 8) {
+        uint64_t word;
+        std::memcpy(&word, data, sizeof(word));
+        const uint64_t stops = ~word & 0x8080808080808080ULL;
+        if (stops != 0) {
+            // 保留到第一个停止位所在字节为止；停止位在第 8 字节时移位溢出为全 1
+            const uint64_t stop_bit = stops & (~stops + 1);
+            uint64_t x = word & ((stop_bit << 1) - 1) & 0x7F7F7F7F7F7F7F7FULL;
+            // 逐级合并相邻的 7 位分组：2x7 -> 14，2x14 -> 28，2x28 -> 56
+            x = ((x & 0x7F007F007F007F00ULL) >> 1) | (x & 0x007F007F007F007FULL);
+            x = ((x & 0x3FFF00003FFF0000ULL) >> 2) | (x & 0x00003FFF00003FFFULL);
+            x = ((x & 0x0FFFFFFF00000000ULL) >> 4) | (x & 0x000000000FFFFFFFULL);
+            value = x;
+            length = count_trailing_zeros64(stops) / 8 + 1;
+            return true;
+        }
+    }
+
+    // 缓冲区末尾或 9~10 字节的 varint
+    uint64_t result = 0;
+    const size_t limit = std::min(size, kMaxVarintLength);
+    for (size_t i = 0; i < limit; ++i) {
+        const uint8_t byte = data[i];
+        if (i == kMaxVarintLength - 1 && byte > 1) {
+            return false;   // 超出 64 位
+        }
+        result |= static_cast<uint64_t>(byte & 0x7F) << (7 * i);
+        if ((byte & 0x80) == 0) {
+            value = result;
+            length = i + 1;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ProtobufScanner::read_tag(uint32_t& number, ProtobufWireType& wire_type) noexcept {
+    uint64_t tag = 0;
+    size_t length = 0;
+    if (!decode_varint(data_ + position_, size_ - position_, tag, length)) {
+        return fail();
+    }
+    position_ += length;
+
+    const uint64_t raw_number = tag >> 3;
+    const uint8_t raw_type = static_cast<uint8_t>(tag & 0x7);
+    if (raw_number == 0 || raw_number > kMaxFieldNumber || raw_type > 5) {
+        return fail();
+    }
+
+    number = static_cast<uint32_t>(raw_number);
+    wire_type = static_cast<ProtobufWireType>(raw_type);
+    return true;
+}
+
+bool ProtobufScanner::next(ProtobufField& field) noexcept {
+    if (failed_ || position_ >= size_) {
+        return false;
+    }
+
+    field = ProtobufField{};
+    field.offset = position_;
+    if (!read_tag(field.number, field.wire_type)) {
+        return false;
+    }
+    return read_value(field.wire_type, field, 0);
+}
+
+bool ProtobufScanner::read_value(ProtobufWireType wire_type, ProtobufField& field, size_t depth) noexcept {
+    const size_t remaining = size_ - position_;
+
+    switch (wire_type) {
+        case ProtobufWireType::VARINT: {
+            size_t length = 0;
+            if (!decode_varint(data_ + position_, remaining, field.value, length)) {
+                return fail();
+            }
+            position_ += length;
+            return true;
+        }
+
+        case ProtobufWireType::FIXED64: {
+            if (remaining < 8) {
+                return fail();
+            }
+            std::memcpy(&field.value, data_ + position_, 8);   // 小端
+            position_ += 8;
+            return true;
+        }
+
+        case ProtobufWireType::FIXED32: {
+            if (remaining < 4) {
+                return fail();
+            }
+            uint32_t value;
+            std::memcpy(&value, data_ + position_, 4);
+            field.value = value;
+            position_ += 4;
+            return true;
+        }
+
+        case ProtobufWireType::LENGTH_DELIMITED: {
+            uint64_t length = 0;
+            size_t prefix = 0;
+            if (!decode_varint(data_ + position_, remaining, length, prefix) || length > remaining - prefix) {
+                return fail();
+            }
+            field.bytes = {data_ + position_ + prefix, static_cast<size_t>(length)};
+            position_ += prefix + static_cast<size_t>(length);
+            return true;
+        }
+
+        case ProtobufWireType::START_GROUP: {
+            const size_t start = position_;
+            size_t content_end = 0;
+            if (!skip_group(field.number, depth + 1, content_end)) {
+                return false;
+            }
+            field.bytes = {data_ + start, content_end - start};
+            return true;
+        }
+
+        case ProtobufWireType::END_GROUP:
+        default:
+            // 不成对的 END_GROUP
+            return fail();
+    }
+}
+
+bool ProtobufScanner::skip_group(uint32_t number, size_t depth, size_t& content_end) noexcept {
+    if (depth > kMaxDepth) {
+        return fail();
+    }
+
+    ProtobufField inner;
+    while (position_ < size_) {
+        const size_t tag_offset = position_;
+        if (!read_tag(inner.number, inner.wire_type)) {
+            return false;
+        }
+        if (inner.wire_type == ProtobufWireType::END_GROUP) {
+            if (inner.number != number) {
+                return fail();
+            }
+            content_end = tag_offset;
+            return true;
+        }
+        if (!read_value(inner.wire_type, inner, depth)) {
+            return false;
+        }
+    }
+    return fail();   // group 未结束
+}
+
+bool ProtobufScanner::is_valid_message(std::span<const uint8_t> data) noexcept {
+    ProtobufScanner scanner(data);
+    ProtobufField field;
+    while (scanner.next(field)) {
+    }
+    return !scanner.failed();
+}
+
+// ProtobufProjection 实现
+
+ProtobufProjection::ProtobufProjection() {
+    nodes_.emplace_back();   // 根节点
+}
+
+size_t ProtobufProjection::add_path(std::initializer_list<uint32_t> path) {
+    return add_path(std::span<const uint32_t>(path.begin(), path.size()));
+}
+
+size_t ProtobufProjection::add_path(std::span<const uint32_t> path) {
+    if (path.empty() || path.size() > ProtobufScanner::kMaxDepth) {
+        return SIZE_MAX;
+    }
+
+    // 节点以下标引用，插入会使引用失效
+    size_t current = 0;
+    for (const uint32_t number : path) {
+        if (number == 0 || number > kMaxFieldNumber) {
+            return SIZE_MAX;
+        }
+
+        size_t next = 0;
+        for (const uint32_t child : nodes_[current].children) {
+            if (nodes_[child].number == number) {
+                next = child;
+                break;
+            }
+        }
+        if (next == 0) {
+            next = nodes_.size();
+            nodes_.emplace_back();
+            nodes_[next].number = number;
+            nodes_[current].children.push_back(static_cast<uint32_t>(next));
+        }
+        current = next;
+    }
+
+    if (nodes_[current].slot == kNoSlot) {
+        nodes_[current].slot = slot_count_++;
+    }
+    return nodes_[current].slot;
+}
+
+size_t ProtobufProjection::extract(std::span<const uint8_t> message, std::vector<ProtobufField>& values) const {
+    values.assign(slot_count_, ProtobufField{});
+    size_t found = 0;
+    if (slot_count_ > 0) {
+        extract_node(message, nodes_[0], 0, values, found);
+    }
+    return found;
+}
+
+void ProtobufProjection::extract_node(std::span<const uint8_t> message, const Node& node, size_t depth,
+                                      std::vector<ProtobufField>& values, size_t& found) const {
+    ProtobufScanner scanner(message);
+    ProtobufField field;
+
+    while (found < slot_count_ && scanner.next(field)) {
+        for (const uint32_t index : node.children) {
+            const Node& child = nodes_[index];
+            if (child.number != field.number) {
+                continue;
+            }
+            if (child.slot != kNoSlot && !values[child.slot].valid()) {
+                values[child.slot] = field;
+                ++found;
+            }
+            if (!child.children.empty() && field.wire_type == ProtobufWireType::LENGTH_DELIMITED &&
+                depth + 1 < ProtobufScanner::kMaxDepth) {
+                extract_node(field.bytes, child, depth + 1, values, found);
+            }
+            break;
+        }
+    }
+}
+
+} // namespace protocol_parser::parsers
@@ -0,0 +1,484 @@
+#include "parsers/application/sip_dialog_table.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+namespace protocol_parser::parsers {
+
+namespace {
+    constexpr size_t kMinCapacity = 64;
+    constexpr std::string_view kRtpProtocol = "RTP";
+    constexpr std::string_view kRtcpProtocol = "RTCP";
+
+    inline uint64_t mix64(uint64_t value) noexcept {
+        value ^= value >> 33;
+        value *= 0xff51afd7ed558ccdULL;
+        value ^= value >> 33;
+        value *= 0xc4ceb9fe1a85ec53ULL;
+        value ^= value >> 33;
+        return value;
+    }
+
+    bool is_unspecified(const SipMediaEndpoint& endpoint) noexcept {
+        // 0.0.0.0（RFC 2543 的保持）与 ::
+        static constexpr std::array<uint8_t, 16> kMappedAny = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xFF, 0xFF, 0, 0, 0, 0};
+        return endpoint.address == kMappedAny || endpoint.address == std::array<uint8_t, 16>{};
+    }
+}
+
+// ============================================================================
+// SipMediaEndpoint / SipMediaStream
+// ============================================================================
+
+SipMediaEndpoint SipMediaEndpoint::from_ipv4(uint32_t address, uint16_t port) noexcept {
+    SipMediaEndpoint endpoint;
+    endpoint.address[10] = 0xFF;
+    endpoint.address[11] = 0xFF;
+    endpoint.address[12] = static_cast<uint8_t>(address >> 24);
+    endpoint.address[13] = static_cast<uint8_t>(address >> 16);
+    endpoint.address[14] = static_cast<uint8_t>(address >> 8);
+    endpoint.address[15] = static_cast<uint8_t>(address);
+    endpoint.port = port;
+    return endpoint;
+}
+
+SipMediaEndpoint SipMediaEndpoint::from_ipv6(std::span<const uint8_t, 16> address, uint16_t port) noexcept {
+    SipMediaEndpoint endpoint;
+    std::copy(address.begin(), address.end(), endpoint.address.begin());
+    endpoint.port = port;
+    return endpoint;
+}
+
+bool SipMediaEndpoint::from_text(std::string_view address, uint16_t port, SipMediaEndpoint& out) noexcept {
+    core::FlowAddress parsed;
+    const bool valid = core::FlowAddress::from_text(address, parsed);
+    out = from_ipv6(parsed.bytes, port);
+    return valid;
+}
+
+uint32_t SipMediaStream::clock_rate(uint8_t payload_type) const noexcept {
+    for (size_t i = 0; i < format_count; ++i) {
+        if (formats[i].payload_type == payload_type) {
+            return formats[i].clock_rate;
+        }
+    }
+    return 0;
+}
+
+// ============================================================================
+// SipDialogTable
+// ============================================================================
+
+SipDialogTable::SipDialogTable() : SipDialogTable(Config{}) {}
+
+SipDialogTable::SipDialogTable(const Config& config) : config_(config) {
+    config_.max_dialogs = std::clamp<size_t>(config_.max_dialogs, 1, UINT32_MAX - 1);
+    endpoints_.resize(std::bit_ceil(std::max(config_.endpoint_capacity, kMinCapacity)));
+    mask_ = endpoints_.size() - 1;
+}
+
+void SipDialogTable::clear() {
+    for (const EndpointSlot& slot : endpoints_) {
+        if (slot.occupied && endpoint_is_live(slot)) {
+            withdraw_expected(slot);
+        }
+    }
+    std::fill(endpoints_.begin(), endpoints_.end(), EndpointSlot{});
+    live_endpoints_ = 0;
+    dialogs_.clear();
+    free_dialogs_.clear();
+    call_ids_.clear();
+    sweep_cursor_ = 0;
+    stats_ = Statistics{};
+}
+
+uint64_t SipDialogTable::hash_endpoint(const SipMediaEndpoint& endpoint) noexcept {
+    uint64_t high;
+    uint64_t low;
+    std::memcpy(&high, endpoint.address.data(), 8);
+    std::memcpy(&low, endpoint.address.data() + 8, 8);
+    return mix64(high ^ mix64(low ^ endpoint.port));
+}
+
+size_t SipDialogTable::find_endpoint(const SipMediaEndpoint& endpoint, uint64_t hash) const noexcept {
+    for (size_t index = hash & mask_;; index = (index + 1) & mask_) {
+        const EndpointSlot& slot = endpoints_[index];
+        if (!slot.occupied) {
+            return endpoints_.size();
+        }
+        if (slot.hash == hash && slot.endpoint == endpoint) {
+            return index;
+        }
+    }
+}
+
+bool SipDialogTable::endpoint_is_live(const EndpointSlot& slot) const noexcept {
+    return slot.dialog < dialogs_.size() && dialogs_[slot.dialog].live &&
+           dialogs_[slot.dialog].generation == slot.generation;
+}
+
+bool SipDialogTable::resolve(const SipMediaEndpoint& endpoint, const EndpointSlot*& slot) const noexcept {
+    const size_t index = find_endpoint(endpoint, hash_endpoint(endpoint));
+    if (index == endpoints_.size() || !endpoint_is_live(endpoints_[index])) {
+        return false;
+    }
+    slot = &endpoints_[index];
+    return true;
+}
+
+void SipDialogTable::erase_endpoint(size_t index) noexcept {
+    // 后移删除，不留墓碑
+    size_t hole = index;
+    for (size_t next = (hole + 1) & mask_; endpoints_[next].occupied; next = (next + 1) & mask_) {
+        const size_t home = endpoints_[next].hash & mask_;
+        // home 循环落在 (hole, next] 内的条目保持不动
+        const bool stays = (hole <= next) ? (home > hole && home <= next) : (home > hole || home <= next);
+        if (!stays) {
+            endpoints_[hole] = endpoints_[next];
+            hole = next;
+        }
+    }
+    endpoints_[hole] = EndpointSlot{};
+    --live_endpoints_;
+}
+
+void SipDialogTable::register_endpoint(uint32_t index, uint8_t stream, bool rtcp, bool mux,
+                                       const SipMediaEndpoint& endpoint, uint64_t now_us) {
+    const uint64_t hash = hash_endpoint(endpoint);
+    size_t slot = find_endpoint(endpoint, hash);
+    if (slot == endpoints_.size()) {
+        if ((live_endpoints_ + 1) * 4 > endpoints_.size() * 3) {
+            ++stats_.dropped;
+            return;
+        }
+        slot = hash & mask_;
+        while (endpoints_[slot].occupied) {
+            slot = (slot + 1) & mask_;
+        }
+        ++live_endpoints_;
+    }
+
+    // 新声明覆盖旧归属（端口被新呼叫复用）
+    EndpointSlot& entry = endpoints_[slot];
+    entry.hash = hash;
+    entry.endpoint = endpoint;
+    entry.dialog = index;
+    entry.generation = dialogs_[index].generation;
+    entry.stream = stream;
+    entry.rtcp = rtcp;
+    entry.mux = mux;
+    entry.occupied = true;
+    ++stats_.endpoints_registered;
+
+    if (expected_flows_) {
+        // 未绑定的预期与对话同样按 idle_timeout_us 过期：应答前可能振铃很久
+        core::ExpectedFlow flow;
+        flow.protocol = rtcp ? kRtcpProtocol : kRtpProtocol;
+        flow.session = dialogs_[index].dialog.id;
+        flow.address = core::FlowAddress::from_ipv6(endpoint.address);
+        flow.port = endpoint.port;
+        flow.is_tcp = false;
+        flow.timeout_us = config_.idle_timeout_us;
+        expected_flows_->expect(flow, now_us);
+    }
+}
+
+void SipDialogTable::withdraw_expected(const EndpointSlot& slot) noexcept {
+    if (expected_flows_) {
+        expected_flows_->erase_endpoint(core::FlowAddress::from_ipv6(slot.endpoint.address), slot.endpoint.port,
+                                        false, dialogs_[slot.dialog].dialog.id);
+    }
+}
+
+void SipDialogTable::unregister_endpoint(uint32_t index, const SipMediaEndpoint& endpoint) noexcept {
+    const size_t slot = find_endpoint(endpoint, hash_endpoint(endpoint));
+    if (slot != endpoints_.size() && endpoints_[slot].dialog == index &&
+        endpoints_[slot].generation == dialogs_[index].generation) {
+        withdraw_expected(endpoints_[slot]);
+        erase_endpoint(slot);
+    }
+}
+
+uint32_t SipDialogTable::index_of(uint64_t dialog) const noexcept {
+    const uint64_t slot = dialog & 0xFFFFFFFFULL;
+    if (slot == 0 || slot > dialogs_.size()) {
+        return kNoDialog;
+    }
+    const auto index = static_cast<uint32_t>(slot - 1);
+    const Slot& entry = dialogs_[index];
+    return (entry.live && entry.generation == static_cast<uint32_t>(dialog >> 32)) ? index : kNoDialog;
+}
+
+const SipDialog* SipDialogTable::find(uint64_t dialog) const noexcept {
+    const uint32_t index = index_of(dialog);
+    return index != kNoDialog ? &dialogs_[index].dialog : nullptr;
+}
+
+const SipDialog* SipDialogTable::find_by_call_id(std::string_view call_id) const noexcept {
+    const auto it = call_ids_.find(call_id);
+    return it != call_ids_.end() ? &dialogs_[it->second].dialog : nullptr;
+}
+
+uint32_t SipDialogTable::create_dialog(std::string_view call_id, std::string_view caller_tag, uint64_t now_us) {
+    if (call_ids_.size() >= config_.max_dialogs) {
+        ++stats_.dropped;
+        return kNoDialog;
+    }
+
+    uint32_t index;
+    if (!free_dialogs_.empty()) {
+        index = free_dialogs_.back();
+        free_dialogs_.pop_back();
+    } else {
+        index = static_cast<uint32_t>(dialogs_.size());
+        dialogs_.emplace_back();
+    }
+
+    Slot& slot = dialogs_[index];
+    slot.live = true;
+    slot.dialog = SipDialog{};
+    SipDialog& dialog = slot.dialog;
+    dialog.id = (static_cast<uint64_t>(slot.generation) << 32) | (static_cast<uint64_t>(index) + 1);
+    dialog.call_id.assign(call_id);
+    dialog.caller_tag.assign(caller_tag);
+    dialog.created_us = now_us;
+    dialog.last_seen_us = now_us;
+
+    call_ids_.emplace(dialog.call_id, index);
+    ++stats_.dialogs_created;
+    return index;
+}
+
+void SipDialogTable::release_dialog(uint32_t index) {
+    Slot& slot = dialogs_[index];
+    SipDialog& dialog = slot.dialog;
+    for (size_t i = 0; i < dialog.stream_count; ++i) {
+        unregister_endpoint(index, dialog.streams[i].rtp);
+        unregister_endpoint(index, dialog.streams[i].rtcp);
+    }
+    call_ids_.erase(dialog.call_id);
+
+    slot.live = false;
+    ++slot.generation;
+    slot.dialog = SipDialog{};
+    free_dialogs_.push_back(index);
+}
+
+bool SipDialogTable::is_expired(const SipDialog& dialog, uint64_t now_us) const noexcept {
+    if (dialog.state == SipDialogState::Terminated && now_us >= dialog.ended_us &&
+        now_us - dialog.ended_us > config_.linger_us) {
+        return true;
+    }
+    return now_us >= dialog.last_seen_us && now_us - dialog.last_seen_us > config_.idle_timeout_us;
+}
+
+void SipDialogTable::sweep(uint64_t now_us, size_t budget) {
+    if (dialogs_.empty()) {
+        return;
+    }
+    budget = std::min(budget, dialogs_.size());
+    for (size_t i = 0; i < budget; ++i) {
+        sweep_cursor_ = (sweep_cursor_ + 1) % dialogs_.size();
+        Slot& slot = dialogs_[sweep_cursor_];
+        if (slot.live && is_expired(slot.dialog, now_us)) {
+            release_dialog(static_cast<uint32_t>(sweep_cursor_));
+            ++stats_.dialogs_expired;
+        }
+    }
+}
+
+void SipDialogTable::expire(uint64_t now_us) {
+    sweep(now_us, dialogs_.size());
+}
+
+void SipDialogTable::apply_sdp(uint32_t index, SipParty owner, const SdpSession& sdp, uint64_t now_us) {
+    SipDialog& dialog = dialogs_[index].dialog;
+
+    // 整体重建：另一方的媒体流保持不变，本方的媒体流按新 SDP 替换，端点不变的沿用计数
+    const auto previous = dialog.streams;
+    const size_t previous_count = dialog.stream_count;
+    for (size_t i = 0; i < previous_count; ++i) {
+        unregister_endpoint(index, previous[i].rtp);
+        unregister_endpoint(index, previous[i].rtcp);
+    }
+
+    dialog.stream_count = 0;
+    for (size_t i = 0; i < previous_count; ++i) {
+        if (previous[i].owner != owner) {
+            dialog.streams[dialog.stream_count++] = previous[i];
+        }
+    }
+
+    for (size_t m = 0; m < sdp.media_count && dialog.stream_count < SipDialog::kMaxStreams; ++m) {
+        const SdpMedia& media = sdp.media[m];
+        if (media.port == 0 || !media.is_rtp()) {
+            continue;
+        }
+
+        SipMediaStream stream;
+        stream.owner = owner;
+        stream.type = media.type;
+        if (!SipMediaEndpoint::from_text(media.address, media.port, stream.rtp) || is_unspecified(stream.rtp)) {
+            continue;
+        }
+        if (media.rtcp_mux) {
+            stream.rtcp = stream.rtp;
+        } else if (media.rtcp_port == 0) {
+            stream.rtcp = SipMediaEndpoint{};
+        } else if (!SipMediaEndpoint::from_text(media.rtcp_address.empty() ? media.address : media.rtcp_address,
+                                                media.rtcp_port, stream.rtcp)) {
+            stream.rtcp = stream.rtp;
+        }
+        for (size_t f = 0; f < media.format_count && stream.format_count < SipMediaStream::kMaxFormats; ++f) {
+            stream.formats[stream.format_count++] = {media.formats[f].payload_type, media.formats[f].clock_rate};
+        }
+
+        for (size_t i = 0; i < previous_count; ++i) {
+            const SipMediaStream& old = previous[i];
+            if (old.owner == owner && old.rtp == stream.rtp) {
+                stream.rtp_packets = old.rtp_packets;
+                stream.rtp_bytes = old.rtp_bytes;
+                stream.rtcp_packets = old.rtcp_packets;
+                stream.rtcp_bytes = old.rtcp_bytes;
+                break;
+            }
+        }
+        dialog.streams[dialog.stream_count++] = stream;
+    }
+
+    for (size_t i = 0; i < dialog.stream_count; ++i) {
+        const SipMediaStream& stream = dialog.streams[i];
+        const bool mux = stream.rtcp == stream.rtp;
+        register_endpoint(index, static_cast<uint8_t>(i), false, mux, stream.rtp, now_us);
+        if (!mux && stream.rtcp.port != 0) {
+            register_endpoint(index, static_cast<uint8_t>(i), true, false, stream.rtcp, now_us);
+        }
+    }
+    ++stats_.offers;
+}
+
+uint64_t SipDialogTable::observe(const SipParseResult& message, uint64_t now_us) {
+    if (message.call_id.empty()) {
+        return 0;
+    }
+    sweep(now_us, config_.sweep_step);
+
+    const bool invite = message.is_request && message.method == SipMethod::INVITE;
+    uint32_t index = kNoDialog;
+    if (const auto it = call_ids_.find(message.call_id); it != call_ids_.end()) {
+        index = it->second;
+        if (is_expired(dialogs_[index].dialog, now_us)) {
+            release_dialog(index);
+            ++stats_.dialogs_expired;
+            index = kNoDialog;
+        }
+    }
+    if (index == kNoDialog) {
+        // 只有 INVITE 建立带媒体的对话
+        if (!invite) {
+            return 0;
+        }
+        index = create_dialog(message.call_id, message.from_tag(), now_us);
+        if (index == kNoDialog) {
+            return 0;
+        }
+    }
+
+    SipDialog& dialog = dialogs_[index].dialog;
+    dialog.last_seen_us = now_us;
+
+    // 请求由 From 一方发出；响应由 To 一方发出
+    const bool from_caller = message.from_tag() == dialog.caller_tag;
+    const SipParty sender = (from_caller == message.is_request) ? SipParty::Caller : SipParty::Callee;
+
+    const SipMethod method = message.is_request ? message.method : message.cseq_method;
+    if (!message.is_request && !message.cseq_valid) {
+        return dialog.id;
+    }
+    const auto status = static_cast<uint16_t>(message.response_code);
+
+    if (message.is_request) {
+        if (method == SipMethod::BYE && dialog.state != SipDialogState::Terminated) {
+            dialog.state = SipDialogState::Terminated;
+            dialog.ended_us = now_us;
+        } else if (method == SipMethod::CANCEL && dialog.state == SipDialogState::Early) {
+            dialog.state = SipDialogState::Terminated;
+            dialog.ended_us = now_us;
+            ++stats_.dialogs_failed;
+        }
+    } else if (method == SipMethod::INVITE && status >= 200) {
+        if (dialog.final_status == 0) {
+            dialog.final_status = status;
+        }
+        if (status < 300 && dialog.state == SipDialogState::Early) {
+            dialog.state = SipDialogState::Confirmed;
+            dialog.answered_us = now_us;
+            ++stats_.dialogs_answered;
+        } else if (status >= 300 && dialog.state == SipDialogState::Early) {
+            dialog.state = SipDialogState::Terminated;
+            dialog.ended_us = now_us;
+            ++stats_.dialogs_failed;
+        }
+    }
+
+    // 携带 SDP 的 offer/answer：INVITE/ACK/PRACK/UPDATE 请求，及其 1xx/2xx 响应
+    const bool sdp_method = method == SipMethod::INVITE || method == SipMethod::ACK ||
+                            method == SipMethod::PRACK || method == SipMethod::UPDATE;
+    if (message.has_sdp && sdp_method && dialog.state != SipDialogState::Terminated &&
+        (message.is_request || status < 300)) {
+        apply_sdp(index, sender, message.sdp, now_us);
+    }
+    return dialog.id;
+}
+
+bool SipDialogTable::lookup(const SipMediaEndpoint& endpoint, SipMediaMatch& out) const noexcept {
+    const EndpointSlot* slot = nullptr;
+    if (!resolve(endpoint, slot)) {
+        return false;
+    }
+    const SipDialog& dialog = dialogs_[slot->dialog].dialog;
+    out.dialog = dialog.id;
+    out.stream = slot->stream;
+    out.rtcp = slot->rtcp;
+    out.to_endpoint = true;
+    out.media = &dialog.streams[slot->stream];
+    out.type = out.media->type;
+    return true;
+}
+
+bool SipDialogTable::classify(const SipMediaEndpoint& source, const SipMediaEndpoint& destination,
+                              std::span<const uint8_t> payload, uint64_t now_us, SipMediaMatch& out) {
+    const EndpointSlot* slot = nullptr;
+    bool to_endpoint = true;
+    if (!resolve(destination, slot)) {
+        // 对称 RTP：从声明的端点发出
+        if (!resolve(source, slot)) {
+            ++stats_.media_misses;
+            return false;
+        }
+        to_endpoint = false;
+    }
+
+    SipDialog& dialog = dialogs_[slot->dialog].dialog;
+    SipMediaStream& stream = dialog.streams[slot->stream];
+    const bool rtcp = slot->rtcp || (slot->mux && is_rtcp_payload(payload));
+    if (rtcp) {
+        ++stream.rtcp_packets;
+        stream.rtcp_bytes += payload.size();
+    } else {
+        ++stream.rtp_packets;
+        stream.rtp_bytes += payload.size();
+    }
+    dialog.last_seen_us = std::max(dialog.last_seen_us, now_us);
+    ++stats_.media_hits;
+
+    out.dialog = dialog.id;
+    out.stream = slot->stream;
+    out.rtcp = rtcp;
+    out.to_endpoint = to_endpoint;
+    out.type = stream.type;
+    out.media = &stream;
+    return true;
+}
+
+} // namespace protocol_parser::parsers
@@ -1,10 +1,230 @@
 #include "parsers/application/sip_parser.hpp"
 #include <algorithm>
-#include <cctype>
-#include <sstream>
+#include <charconv>
 
 namespace protocol_parser::parsers {
 
+namespace {
+    constexpr std::string_view kWhitespace = " \t";
+
+    inline char ascii_lower(char c) noexcept {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c + ('a' - 'A')) : c;
+    }
+
+    bool iequals(std::string_view a, std::string_view b) noexcept {
+        if (a.size() != b.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < a.size(); ++i) {
+            if (ascii_lower(a[i]) != ascii_lower(b[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::string_view trim(std::string_view value) noexcept {
+        const size_t begin = value.find_first_not_of(kWhitespace);
+        if (begin == std::string_view::npos) {
+            return {};
+        }
+        const size_t end = value.find_last_not_of(kWhitespace);
+        return value.substr(begin, end - begin + 1);
+    }
+
+    // 取下一行（不含 CR/LF），没有换行符时返回 false
+    bool next_line(std::string_view text, size_t& position, std::string_view& line) noexcept {
+        const size_t newline = text.find('\n', position);
+        if (newline == std::string_view::npos) {
+            return false;
+        }
+        size_t end = newline;
+        if (end > position && text[end - 1] == '\r') {
+            --end;
+        }
+        line = text.substr(position, end - position);
+        position = newline + 1;
+        return true;
+    }
+
+    // 以空白分隔的下一个字段
+    std::string_view next_token(std::string_view& rest) noexcept {
+        const size_t begin = rest.find_first_not_of(kWhitespace);
+        if (begin == std::string_view::npos) {
+            rest = {};
+            return {};
+        }
+        rest.remove_prefix(begin);
+        const size_t end = std::min(rest.find_first_of(kWhitespace), rest.size());
+        const auto token = rest.substr(0, end);
+        rest.remove_prefix(end);
+        return token;
+    }
+
+    template <typename T>
+    bool parse_number(std::string_view text, T& value) noexcept {
+        const auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+        return ec == std::errc{} && ptr == text.data() + text.size();
+    }
+
+    struct HeaderName {
+        std::string_view name;
+        char compact;
+        SipHeaderId id;
+    };
+
+    constexpr HeaderName kHeaderNames[] = {
+        {"Via", 'v', SipHeaderId::Via},
+        {"From", 'f', SipHeaderId::From},
+        {"To", 't', SipHeaderId::To},
+        {"Call-ID", 'i', SipHeaderId::CallId},
+        {"CSeq", 0, SipHeaderId::CSeq},
+        {"Contact", 'm', SipHeaderId::Contact},
+        {"Content-Type", 'c', SipHeaderId::ContentType},
+        {"Content-Length", 'l', SipHeaderId::ContentLength},
+        {"Content-Encoding", 'e', SipHeaderId::ContentEncoding},
+        {"Supported", 'k', SipHeaderId::Supported},
+        {"Subject", 's', SipHeaderId::Subject},
+        {"Event", 'o', SipHeaderId::Event},
+        {"Refer-To", 'r', SipHeaderId::ReferTo},
+        {"Referred-By", 'b', SipHeaderId::ReferredBy},
+        {"Allow-Events", 'u', SipHeaderId::AllowEvents},
+        {"Session-Expires", 'x', SipHeaderId::SessionExpires},
+        {"Accept-Contact", 'a', SipHeaderId::AcceptContact},
+        {"Reject-Contact", 'j', SipHeaderId::RejectContact},
+        {"Request-Disposition", 'd', SipHeaderId::RequestDisposition},
+        {"Identity", 'y', SipHeaderId::Identity},
+        {"Max-Forwards", 0, SipHeaderId::MaxForwards},
+        {"User-Agent", 0, SipHeaderId::UserAgent},
+        {"Server", 0, SipHeaderId::Server},
+        {"Allow", 0, SipHeaderId::Allow},
+        {"Expires", 0, SipHeaderId::Expires},
+    };
+
+    struct MethodName {
+        std::string_view name;
+        SipMethod method;
+    };
+
+    constexpr MethodName kMethodNames[] = {
+        {"INVITE", SipMethod::INVITE},
+        {"ACK", SipMethod::ACK},
+        {"BYE", SipMethod::BYE},
+        {"CANCEL", SipMethod::CANCEL},
+        {"REGISTER", SipMethod::REGISTER},
+        {"OPTIONS", SipMethod::OPTIONS},
+        {"PRACK", SipMethod::PRACK},
+        {"SUBSCRIBE", SipMethod::SUBSCRIBE},
+        {"NOTIFY", SipMethod::NOTIFY},
+        {"PUBLISH", SipMethod::PUBLISH},
+        {"INFO", SipMethod::INFO},
+        {"REFER", SipMethod::REFER},
+        {"MESSAGE", SipMethod::MESSAGE},
+        {"UPDATE", SipMethod::UPDATE},
+    };
+
+    bool lookup_method(std::string_view name, SipMethod& method) noexcept {
+        // 方法名区分大小写（RFC 3261 7.1）
+        for (const auto& entry : kMethodNames) {
+            if (entry.name == name) {
+                method = entry.method;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // RFC 3551 表 4/5 的静态载荷类型
+    struct StaticPayload {
+        uint8_t payload_type;
+        std::string_view encoding;
+        uint32_t clock_rate;
+        uint8_t channels;
+    };
+
+    constexpr StaticPayload kStaticPayloads[] = {
+        {0, "PCMU", 8000, 1}, {3, "GSM", 8000, 1}, {4, "G723", 8000, 1}, {5, "DVI4", 8000, 1},
+        {6, "DVI4", 16000, 1}, {7, "LPC", 8000, 1}, {8, "PCMA", 8000, 1}, {9, "G722", 8000, 1},
+        {10, "L16", 44100, 2}, {11, "L16", 44100, 1}, {12, "QCELP", 8000, 1}, {13, "CN", 8000, 1},
+        {14, "MPA", 90000, 1}, {15, "G728", 8000, 1}, {16, "DVI4", 11025, 1}, {17, "DVI4", 22050, 1},
+        {18, "G729", 8000, 1}, {25, "CelB", 90000, 1}, {26, "JPEG", 90000, 1}, {28, "nv", 90000, 1},
+        {31, "H261", 90000, 1}, {32, "MPV", 90000, 1}, {33, "MP2T", 90000, 1}, {34, "H263", 90000, 1},
+    };
+
+    SdpMediaType media_type(std::string_view media) noexcept {
+        if (media == "audio") return SdpMediaType::Audio;
+        if (media == "video") return SdpMediaType::Video;
+        if (media == "text") return SdpMediaType::Text;
+        if (media == "application") return SdpMediaType::Application;
+        if (media == "message") return SdpMediaType::Message;
+        return SdpMediaType::Other;
+    }
+
+    // c=<nettype> <addrtype> <address>[/ttl[/count]]
+    std::string_view connection_address(std::string_view value) noexcept {
+        next_token(value);
+        next_token(value);
+        const auto address = next_token(value);
+        return address.substr(0, address.find('/'));
+    }
+
+    bool direction_attribute(std::string_view attribute, SdpDirection& direction) noexcept {
+        if (attribute == "sendrecv") direction = SdpDirection::SendRecv;
+        else if (attribute == "sendonly") direction = SdpDirection::SendOnly;
+        else if (attribute == "recvonly") direction = SdpDirection::RecvOnly;
+        else if (attribute == "inactive") direction = SdpDirection::Inactive;
+        else return false;
+        return true;
+    }
+}
+
+// ============================================================================
+// SipParseResult / SDP 辅助函数
+// ============================================================================
+
+std::string_view SipParseResult::find_header(SipHeaderId id) const noexcept {
+    for (size_t i = 0; i < header_count; ++i) {
+        if (headers[i].id == id) {
+            return headers[i].value;
+        }
+    }
+    return {};
+}
+
+std::string_view SipParseResult::find_header(std::string_view name) const noexcept {
+    const auto id = SipParser::header_id(name);
+    if (id != SipHeaderId::Other) {
+        return find_header(id);
+    }
+    for (size_t i = 0; i < header_count; ++i) {
+        if (iequals(headers[i].name, name)) {
+            return headers[i].value;
+        }
+    }
+    return {};
+}
+
+std::string_view SipParseResult::from_tag() const noexcept {
+    return SipParser::header_parameter(from, "tag");
+}
+
+std::string_view SipParseResult::to_tag() const noexcept {
+    return SipParser::header_parameter(to, "tag");
+}
+
+bool SdpMedia::is_rtp() const noexcept {
+    return protocol.find("RTP/") != std::string_view::npos;
+}
+
+const SdpRtpMap* SdpMedia::find_format(uint8_t payload_type) const noexcept {
+    for (size_t i = 0; i < format_count; ++i) {
+        if (formats[i].payload_type == payload_type) {
+            return &formats[i];
+        }
+    }
+    return nullptr;
+}
+
 // ============================================================================
 // SipParser 实现
 // ============================================================================
@@ -62,122 +282,128 @@ bool SipParser::can_parse(const BufferView& buffer) const noexcept {
 
 ParseResult SipParser::parse(ParseContext& context) noexcept {
     const BufferView& buffer = context.buffer;
-
-    if (buffer.size() < protocol_info_.min_packet_size) {
-        return ParseResult::BufferTooSmall;
+    if (context.offset >= buffer.size()) {
+        return ParseResult::NeedMoreData;
     }
 
     reset();
 
-    // 转换为字符串处理
-    std::string_view sv(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+    try {
+        const std::string_view text(reinterpret_cast<const char*>(buffer.data()) + context.offset,
+                                    buffer.size() - context.offset);
 
-    // 分割行
-    std::vector<std::string> lines;
-    std::string line;
-    for (char c : sv) {
-        if (c == '\n') {
-            lines.push_back(line);
-            line.clear();
-        } else if (c != '\r') {
-            line += c;
+        // 跳过消息之间的 CRLF（RFC 5626 保活）
+        size_t position = text.find_first_not_of("\r\n");
+        if (position == std::string_view::npos) {
+            context.offset = buffer.size();
+            return ParseResult::NeedMoreData;
         }
-    }
-    if (!line.empty()) {
-        lines.push_back(line);
-    }
-
-    if (lines.empty()) {
-        return ParseResult::InvalidFormat;
-    }
+        const size_t message_start = position;
 
-    // 解析起始行
-    const std::string& start_line = lines[0];
-
-    if (start_line.find("SIP/2.0") == 0) {
-        // 响应行
-        result_.is_request = false;
-        if (!parse_response_line(start_line)) {
-            return ParseResult::InvalidFormat;
+        // 起始行
+        std::string_view line;
+        if (!next_line(text, position, line)) {
+            return ParseResult::NeedMoreData;
         }
-    } else {
-        // 请求行
-        result_.is_request = true;
-        if (!parse_request_line(start_line)) {
-            return ParseResult::InvalidFormat;
+        if (line.starts_with("SIP/")) {
+            result_.is_request = false;
+            if (!parse_response_line(line)) {
+                return ParseResult::InvalidFormat;
+            }
+        } else {
+            result_.is_request = true;
+            if (!parse_request_line(line)) {
+                return ParseResult::InvalidFormat;
+            }
         }
-    }
 
-    // 查找空行（头部结束）
-    size_t header_end = 1;
-    for (size_t i = 1; i < lines.size(); ++i) {
-        if (lines[i].empty()) {
-            header_end = i;
-            break;
+        // 头部，直到空行
+        bool content_length_seen = false;
+        for (;;) {
+            if (!next_line(text, position, line)) {
+                return ParseResult::NeedMoreData;
+            }
+            if (line.empty()) {
+                break;
+            }
+            if (line.front() == ' ' || line.front() == '\t') {
+                extend_header(line.data() + line.size());
+                continue;
+            }
+
+            const size_t colon = line.find(':');
+            if (colon == std::string_view::npos) {
+                last_header_ = nullptr;
+                last_field_ = nullptr;
+                continue;  // 跳过无效头部
+            }
+            const auto name = trim(line.substr(0, colon));
+            const auto value = trim(line.substr(colon + 1));
+            add_header(name, value);
+
+            if (header_id(name) == SipHeaderId::ContentLength) {
+                if (!parse_number(value, result_.content_length)) {
+                    return ParseResult::InvalidFormat;
+                }
+                content_length_seen = true;
+            }
         }
-    }
 
-    // 解析头部
-    if (header_end > 1) {
-        std::vector<std::string> header_lines(lines.begin() + 1, lines.begin() + header_end);
-        if (!parse_headers(header_lines)) {
-            return ParseResult::InvalidFormat;
+        // 消息体：没有 Content-Length 时（仅 UDP 允许）取到缓冲区末尾
+        const size_t available = text.size() - position;
+        if (!content_length_seen) {
+            result_.content_length = available;
+        } else if (result_.content_length > available) {
+            return ParseResult::NeedMoreData;
         }
-    }
 
-    // 解析消息体
-    if (result_.content_length > 0 && header_end + 1 < lines.size()) {
-        // 计算消息体在原始缓冲区中的偏移
-        size_t body_start = 0;
-        for (size_t i = 0; i <= header_end; ++i) {
-            body_start += lines[i].size() + 1;  // +1 for \n
-            if (i > 0) {
-                body_start += 1;  // +1 for \r if present
+        if (result_.content_length > 0) {
+            SipBody body;
+            body.content_type = result_.content_type;
+            body.data = std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(text.data() + position),
+                                                 result_.content_length);
+            result_.body = body;
+
+            // 如果是 SDP，解析
+            const auto media_type = trim(body.content_type.substr(0, body.content_type.find(';')));
+            if (iequals(media_type, "application/sdp")) {
+                result_.has_sdp = parse_sdp(text.substr(position, result_.content_length), result_.sdp);
             }
         }
 
-        if (!parse_body(buffer, body_start)) {
-            return ParseResult::InvalidFormat;
+        result_.message_length = position + result_.content_length - message_start;
+        context.offset += position + result_.content_length;
+        state_ = ParserState::Complete;
+
+        // 元数据只保存数值字段；result_ 中的视图指向输入缓冲区，完整结果通过 get_result() 获取
+        context.metadata["sip_is_request"] = result_.is_request;
+        if (result_.is_request) {
+            context.metadata["sip_method"] = static_cast<int>(result_.method);
+        } else {
+            context.metadata["sip_status_code"] = static_cast<int>(result_.response_code);
         }
-    }
+        context.metadata["sip_cseq_number"] = result_.cseq_number;
+        context.metadata["sip_content_length"] = result_.content_length;
+        context.metadata["sip_has_sdp"] = result_.has_sdp;
 
-    // 保存结果
-    context.metadata["sip_result"] = result_;
+        return ParseResult::Success;
 
-    return ParseResult::Success;
+    } catch (const std::exception&) {
+        return ParseResult::InternalError;
+    }
 }
 
-bool SipParser::parse_request_line(const std::string& line) {
+bool SipParser::parse_request_line(std::string_view line) noexcept {
     // 格式: METHOD Request-URI SIP-Version
-    std::istringstream iss(line);
-    std::string method_str, request_uri, sip_version;
-
-    if (!(iss >> method_str >> request_uri >> sip_version)) {
+    const auto method = next_token(line);
+    const auto request_uri = next_token(line);
+    const auto sip_version = next_token(line);
+    if (sip_version.empty() || !trim(line).empty() || !sip_version.starts_with("SIP/")) {
         return false;
     }
 
     // 解析方法
-    static const std::map<std::string, SipMethod> method_map = {
-        {"INVITE", SipMethod::INVITE},
-        {"ACK", SipMethod::ACK},
-        {"BYE", SipMethod::BYE},
-        {"CANCEL", SipMethod::CANCEL},
-        {"REGISTER", SipMethod::REGISTER},
-        {"OPTIONS", SipMethod::OPTIONS},
-        {"PRACK", SipMethod::PRACK},
-        {"SUBSCRIBE", SipMethod::SUBSCRIBE},
-        {"NOTIFY", SipMethod::NOTIFY},
-        {"PUBLISH", SipMethod::PUBLISH},
-        {"INFO", SipMethod::INFO},
-        {"REFER", SipMethod::REFER},
-        {"MESSAGE", SipMethod::MESSAGE},
-        {"UPDATE", SipMethod::UPDATE}
-    };
-
-    auto it = method_map.find(method_str);
-    if (it != method_map.end()) {
-        result_.method = it->second;
-    } else {
+    if (!lookup_method(method, result_.method)) {
         return false;  // 未知方法
     }
 
@@ -187,145 +413,278 @@ bool SipParser::parse_request_line(const std::string& line) {
     return true;
 }
 
-bool SipParser::parse_response_line(const std::string& line) {
+bool SipParser::parse_response_line(std::string_view line) noexcept {
     // 格式: SIP-Version Status-Code Reason-Phrase
-    std::istringstream iss(line);
-    std::string sip_version;
-    int status_code;
+    const auto sip_version = next_token(line);
+    const auto status = next_token(line);
 
-    if (!(iss >> sip_version >> status_code)) {
+    uint16_t status_code = 0;
+    if (status.size() != 3 || !parse_number(status, status_code) || status_code < 100) {
         return false;
     }
 
-    // 读取原因短语（剩余部分）
-    std::string reason_phrase;
-    std::getline(iss >> std::ws, reason_phrase);
-
     result_.sip_version = sip_version;
     result_.response_code = static_cast<SipResponseCode>(status_code);
-    result_.reason_phrase = reason_phrase;
+    // 原因短语（剩余部分）
+    result_.reason_phrase = trim(line);
 
     return true;
 }
 
-bool SipParser::parse_headers(const std::vector<std::string>& lines) {
-    for (const std::string& line : lines) {
-        if (line.empty()) {
-            continue;
+SipHeaderId SipParser::header_id(std::string_view name) noexcept {
+    if (name.size() == 1) {
+        const char compact = ascii_lower(name[0]);
+        for (const auto& entry : kHeaderNames) {
+            if (entry.compact == compact) {
+                return entry.id;
+            }
         }
-
-        // 查找冒号
-        size_t colon_pos = line.find(':');
-        if (colon_pos == std::string::npos) {
-            continue;  // 跳过无效头部
+        return SipHeaderId::Other;
+    }
+    for (const auto& entry : kHeaderNames) {
+        if (iequals(entry.name, name)) {
+            return entry.id;
         }
+    }
+    return SipHeaderId::Other;
+}
 
-        // 提取头部名和值
-        std::string name = line.substr(0, colon_pos);
-        std::string value = line.substr(colon_pos + 1);
-
-        // 去除空白
-        while (!name.empty() && std::isspace(name.back())) {
-            name.pop_back();
-        }
-        while (!value.empty() && std::isspace(value.front())) {
-            value.erase(0, 1);
-        }
+std::string_view SipParser::header_parameter(std::string_view value, std::string_view name) noexcept {
+    // name-addr 的 URI 参数在 <> 内，头部参数在 '>' 之后
+    const size_t angle = value.find('>');
+    if (angle != std::string_view::npos) {
+        value.remove_prefix(angle + 1);
+    }
 
-        // 存储头部
-        SipHeader header{name, value};
-        result_.headers.push_back(header);
-
-        // 提取关键头部（快速访问）
-        std::string lower_name = name;
-        std::transform(lower_name.begin(), lower_name.end(),
-                      lower_name.begin(), ::tolower);
-
-        if (lower_name == "from") {
-            result_.from = value;
-        } else if (lower_name == "to") {
-            result_.to = value;
-        } else if (lower_name == "call-id" || lower_name == "i") {
-            result_.call_id = value;
-        } else if (lower_name == "cseq") {
-            result_.cseq = value;
-        } else if (lower_name == "via") {
-            result_.via = value;
-        } else if (lower_name == "contact") {
-            result_.contact = value;
-        } else if (lower_name == "content-type") {
-            result_.content_type = value;
-        } else if (lower_name == "content-length") {
-            try {
-                result_.content_length = std::stoul(value);
-            } catch (...) {
-                result_.content_length = 0;
-            }
+    for (size_t semicolon = value.find(';'); semicolon != std::string_view::npos;
+         semicolon = value.find(';', semicolon + 1)) {
+        auto parameter = value.substr(semicolon + 1);
+        parameter = parameter.substr(0, parameter.find(';'));
+        const size_t equals = parameter.find('=');
+        if (iequals(trim(parameter.substr(0, equals)), name)) {
+            return equals == std::string_view::npos ? std::string_view{} : trim(parameter.substr(equals + 1));
         }
     }
-
-    return true;
+    return {};
 }
 
-bool SipParser::parse_body(const BufferView& buffer, size_t offset) {
-    if (offset >= buffer.size()) {
-        return false;
-    }
-
-    size_t body_size = std::min(result_.content_length, buffer.size() - offset);
+void SipParser::add_header(std::string_view name, std::string_view value) noexcept {
+    const auto id = header_id(name);
 
-    SipBody body;
-    body.content_type = result_.content_type;
-    body.data.assign(buffer.data() + offset, buffer.data() + offset + body_size);
+    last_header_ = nullptr;
+    if (result_.header_count < SipParseResult::kMaxHeaders) {
+        last_header_ = &result_.headers[result_.header_count++];
+        *last_header_ = SipHeader{name, value, id};
+    }
 
-    result_.body = body;
+    // 提取关键头部（快速访问）
+    std::string_view* field = nullptr;
+    switch (id) {
+        case SipHeaderId::From: field = &result_.from; break;
+        case SipHeaderId::To: field = &result_.to; break;
+        case SipHeaderId::CallId: field = &result_.call_id; break;
+        case SipHeaderId::CSeq: field = &result_.cseq; break;
+        case SipHeaderId::Via: field = &result_.via; break;
+        case SipHeaderId::Contact: field = &result_.contact; break;
+        case SipHeaderId::ContentType: field = &result_.content_type; break;
+        default: break;
+    }
+    last_field_ = nullptr;
+    if (field != nullptr && field->empty()) {
+        *field = value;
+        last_field_ = field;
+    }
 
-    // 如果是 SDP，解析
-    if (body.content_type.find("application/sdp") != std::string::npos) {
-        std::string sdp_str(body.data.begin(), body.data.end());
-        parse_sdp(sdp_str);
+    if (id == SipHeaderId::CSeq && !result_.cseq_valid) {
+        auto rest = value;
+        const auto number = next_token(rest);
+        const auto method = next_token(rest);
+        result_.cseq_valid = parse_number(number, result_.cseq_number) && lookup_method(method, result_.cseq_method);
     }
+}
 
-    return true;
+void SipParser::extend_header(const char* line_end) noexcept {
+    const auto extend = [line_end](std::string_view& value) {
+        if (!value.empty()) {
+            value = trim(std::string_view(value.data(), static_cast<size_t>(line_end - value.data())));
+        }
+    };
+    if (last_header_ != nullptr) {
+        extend(last_header_->value);
+    }
+    if (last_field_ != nullptr) {
+        extend(*last_field_);
+    }
 }
 
-std::optional<std::string> SipParser::find_header(const std::string& name) const {
-    std::string lower_name = name;
-    std::transform(lower_name.begin(), lower_name.end(),
-                  lower_name.begin(), ::tolower);
+bool SipParser::parse_sdp(std::string_view sdp, SdpSession& session) noexcept {
+    session = SdpSession{};
+
+    size_t position = 0;
+    std::string_view line;
+    SdpMedia* media = nullptr;
+    bool version_seen = false;
+    bool skip_media = false;   // 超出 kMaxMedia 的媒体段
+
+    while (position < sdp.size()) {
+        if (!next_line(sdp, position, line)) {
+            // 最后一行可以没有换行符
+            line = sdp.substr(position);
+            if (!line.empty() && line.back() == '\r') {
+                line.remove_suffix(1);
+            }
+            position = sdp.size();
+        }
+        if (line.size() < 2 || line[1] != '=') {
+            continue;
+        }
+        const char type = line[0];
+        const auto value = line.substr(2);
 
-    for (const auto& header : result_.headers) {
-        std::string header_lower = header.name;
-        std::transform(header_lower.begin(), header_lower.end(),
-                      header_lower.begin(), ::tolower);
+        if (!version_seen) {
+            if (type != 'v') {
+                return false;
+            }
+            version_seen = true;
+            continue;
+        }
 
-        if (header_lower == lower_name) {
-            return header.value;
+        switch (type) {
+            case 'o': {
+                // o=<username> <sess-id> <sess-version> <nettype> <addrtype> <address>
+                auto rest = value;
+                for (int i = 0; i < 5; ++i) {
+                    next_token(rest);
+                }
+                session.origin_address = next_token(rest);
+                break;
+            }
+            case 's':
+                session.session_name = value;
+                break;
+            case 'c':
+                if (skip_media) {
+                    break;
+                }
+                (media != nullptr ? media->address : session.connection_address) = connection_address(value);
+                break;
+            case 'm': {
+                // m=<media> <port>[/<number of ports>] <proto> <fmt> ...
+                if (session.media_count == SdpSession::kMaxMedia) {
+                    skip_media = true;
+                    media = nullptr;
+                    break;
+                }
+                skip_media = false;
+                media = &session.media[session.media_count++];
+                auto rest = value;
+                media->media = next_token(rest);
+                media->type = media_type(media->media);
+                const auto ports = next_token(rest);
+                const size_t slash = ports.find('/');
+                if (!parse_number(ports.substr(0, slash), media->port) ||
+                    (slash != std::string_view::npos && !parse_number(ports.substr(slash + 1), media->port_count))) {
+                    return false;
+                }
+                media->protocol = next_token(rest);
+                media->direction = session.direction;
+                // 65535 + 1 没有对应端口，RTCP 端口留空
+                media->rtcp_port = media->port != 0 && media->port != UINT16_MAX
+                                       ? static_cast<uint16_t>(media->port + 1) : 0;
+                if (!media->is_rtp()) {
+                    break;
+                }
+                for (auto format = next_token(rest); !format.empty(); format = next_token(rest)) {
+                    uint8_t payload_type = 0;
+                    if (!parse_number(format, payload_type) || payload_type > 127) {
+                        return false;
+                    }
+                    if (media->format_count == SdpMedia::kMaxFormats) {
+                        continue;
+                    }
+                    auto& entry = media->formats[media->format_count++];
+                    entry.payload_type = payload_type;
+                    for (const auto& known : kStaticPayloads) {
+                        if (known.payload_type == payload_type) {
+                            entry.encoding = known.encoding;
+                            entry.clock_rate = known.clock_rate;
+                            entry.channels = known.channels;
+                            break;
+                        }
+                    }
+                }
+                break;
+            }
+            case 'a': {
+                if (skip_media) {
+                    break;
+                }
+                const size_t colon = value.find(':');
+                const auto attribute = value.substr(0, colon);
+                const auto argument = colon == std::string_view::npos ? std::string_view{} : value.substr(colon + 1);
+
+                if (direction_attribute(attribute, media != nullptr ? media->direction : session.direction)) {
+                    break;
+                }
+                if (media == nullptr) {
+                    break;
+                }
+                if (attribute == "rtcp-mux") {
+                    media->rtcp_mux = true;
+                } else if (attribute == "rtcp") {
+                    // a=rtcp:<port> [<nettype> <addrtype> <address>]
+                    auto rest = argument;
+                    uint16_t port = 0;
+                    if (parse_number(next_token(rest), port)) {
+                        media->rtcp_port = port;
+                        media->rtcp_address = connection_address(rest);
+                    }
+                } else if (attribute == "rtpmap") {
+                    // a=rtpmap:<payload type> <encoding name>/<clock rate>[/<channels>]
+                    auto rest = argument;
+                    uint8_t payload_type = 0;
+                    if (!parse_number(next_token(rest), payload_type)) {
+                        break;
+                    }
+                    for (size_t i = 0; i < media->format_count; ++i) {
+                        auto& entry = media->formats[i];
+                        if (entry.payload_type != payload_type) {
+                            continue;
+                        }
+                        const auto encoding = next_token(rest);
+                        const size_t first = encoding.find('/');
+                        const size_t second = encoding.find('/', first == std::string_view::npos ? first : first + 1);
+                        entry.encoding = encoding.substr(0, first);
+                        if (first != std::string_view::npos) {
+                            (void)parse_number(encoding.substr(first + 1, second - first - 1), entry.clock_rate);
+                        }
+                        if (second != std::string_view::npos) {
+                            (void)parse_number(encoding.substr(second + 1), entry.channels);
+                        }
+                        break;
+                    }
+                }
+                break;
+            }
+            default:
+                break;
         }
     }
 
-    return std::nullopt;
-}
-
-void SipParser::parse_sdp(const std::string& sdp) {
-    // 简化：暂不解析 SDP
-    // SDP 格式:
-    // v=0 (protocol version)
-    // o=<username> <session id> <version> <network type> <address type> <address>
-    // s=<session name>
-    // c=<network type> <address type> <connection address>
-    // t=<start time> <stop time>
-    // m=<media> <port> <transport> <fmt list>
-    // a=<attribute>
-    // ...
+    // 媒体级没有 c= 时继承会话级
+    for (size_t i = 0; i < session.media_count; ++i) {
+        if (session.media[i].address.empty()) {
+            session.media[i].address = session.connection_address;
+        }
+    }
+    return version_seen;
 }
 
 void SipParser::reset() noexcept {
     result_ = SipParseResult{};
-    result_.is_request = true;
-    result_.content_length = 0;
     state_ = ParserState::Initial;
-    header_lines_.clear();
+    last_header_ = nullptr;
+    last_field_ = nullptr;
 }
 
 } // namespace protocol_parser::parsers
@@ -0,0 +1,250 @@
+#include "parsers/application/snmp_oid_trie.hpp"
+#include <algorithm>
+#include <charconv>
+
+namespace protocol_parser::parsers {
+
+namespace {
+    // 32 位子标识符最多 5 个字节
+    constexpr size_t kMaxSubidentifierLength = 5;
+
+    void append_base128(uint64_t value, std::vector<uint8_t>& out) {
+        uint8_t buffer[10];
+        size_t count = 0;
+        do {
+            buffer[count++] = static_cast<uint8_t>(value & 0x7F);
+            value >>= 7;
+        } while (value != 0);
+        while (count > 1) {
+            out.push_back(buffer[--count] | 0x80);
+        }
+        out.push_back(buffer[0]);
+    }
+}
+
+// ============================================================================
+// EncodedOID
+// ============================================================================
+
+bool EncodedOID::is_valid(std::span<const uint8_t> encoded) noexcept {
+    if (encoded.empty() || (encoded.back() & 0x80) != 0) {
+        return false;
+    }
+    size_t length = 0;
+    for (uint8_t byte : encoded) {
+        // 子标识符的首字节不能是 0x80（非最小编码）
+        if (length == 0 && byte == 0x80) {
+            return false;
+        }
+        ++length;
+        if (length > kMaxSubidentifierLength) {
+            return false;
+        }
+        if ((byte & 0x80) == 0) {
+            length = 0;
+        }
+    }
+    return true;
+}
+
+size_t EncodedOID::arc_count() const noexcept {
+    size_t count = 0;
+    for (uint8_t byte : bytes) {
+        count += (byte & 0x80) == 0;
+    }
+    return count == 0 ? 0 : count + 1;
+}
+
+std::string EncodedOID::to_string() const {
+    std::string result;
+    uint64_t value = 0;
+    bool first = true;
+    char digits[24];
+    for (uint8_t byte : bytes) {
+        value = (value << 7) | (byte & 0x7F);
+        if (byte & 0x80) {
+            continue;
+        }
+        if (first) {
+            // 首个子标识符 = X * 40 + Y，X 取 0、1、2
+            const uint64_t arc0 = value < 80 ? value / 40 : 2;
+            const uint64_t arc1 = value - arc0 * 40;
+            auto end = std::to_chars(digits, digits + sizeof(digits), arc0).ptr;
+            result.append(digits, end);
+            result.push_back('.');
+            end = std::to_chars(digits, digits + sizeof(digits), arc1).ptr;
+            result.append(digits, end);
+            first = false;
+        } else {
+            result.push_back('.');
+            const auto end = std::to_chars(digits, digits + sizeof(digits), value).ptr;
+            result.append(digits, end);
+        }
+        value = 0;
+    }
+    return result;
+}
+
+bool EncodedOID::encode(std::string_view dotted, std::vector<uint8_t>& out) {
+    out.clear();
+    uint64_t first = 0;
+    size_t arcs = 0;
+    while (!dotted.empty()) {
+        const size_t dot = dotted.find('.');
+        const auto arc_text = dotted.substr(0, dot);
+        uint32_t arc = 0;
+        const auto [ptr, ec] = std::from_chars(arc_text.data(), arc_text.data() + arc_text.size(), arc);
+        if (arc_text.empty() || ec != std::errc{} || ptr != arc_text.data() + arc_text.size()) {
+            out.clear();
+            return false;
+        }
+        if (arcs == 0) {
+            if (arc > 2) {
+                return false;
+            }
+            first = arc;
+        } else if (arcs == 1) {
+            if (first < 2 && arc >= 40) {
+                return false;
+            }
+            append_base128(first * 40 + arc, out);
+        } else {
+            append_base128(arc, out);
+        }
+        ++arcs;
+        dotted = dot == std::string_view::npos ? std::string_view{} : dotted.substr(dot + 1);
+        if (dot != std::string_view::npos && dotted.empty()) {
+            out.clear();
+            return false;
+        }
+    }
+    if (arcs < 2) {
+        out.clear();
+        return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// SNMPOIDTrie
+// ============================================================================
+
+uint32_t SNMPOIDTrie::find_child(const Node& node, uint8_t byte) const noexcept {
+    for (uint32_t child : node.children) {
+        const uint8_t first = labels_[nodes_[child].label_offset];
+        if (first == byte) {
+            return child;
+        }
+        if (first > byte) {
+            break;
+        }
+    }
+    return kNone;
+}
+
+bool SNMPOIDTrie::add(std::string_view dotted, uint32_t& id) {
+    std::vector<uint8_t> encoded;
+    return EncodedOID::encode(dotted, encoded) && add(encoded, id);
+}
+
+bool SNMPOIDTrie::add(std::span<const uint8_t> encoded, uint32_t& id) {
+    if (!EncodedOID::is_valid(encoded)) {
+        return false;
+    }
+    if (nodes_.empty()) {
+        nodes_.emplace_back();
+    }
+
+    uint32_t node = 0;
+    size_t position = 0;
+    while (position < encoded.size()) {
+        const uint32_t child = find_child(nodes_[node], encoded[position]);
+        if (child == kNone) {
+            // 剩余字节作为新叶子的标签
+            Node leaf;
+            leaf.label_offset = static_cast<uint32_t>(labels_.size());
+            leaf.label_length = static_cast<uint32_t>(encoded.size() - position);
+            labels_.insert(labels_.end(), encoded.begin() + static_cast<std::ptrdiff_t>(position), encoded.end());
+            const auto index = static_cast<uint32_t>(nodes_.size());
+            nodes_.push_back(std::move(leaf));
+
+            auto& children = nodes_[node].children;
+            const auto at = std::find_if(children.begin(), children.end(), [&](uint32_t other) {
+                return labels_[nodes_[other].label_offset] > encoded[position];
+            });
+            children.insert(at, index);
+            node = index;
+            break;
+        }
+
+        const Node& existing = nodes_[child];
+        const size_t limit = std::min<size_t>(existing.label_length, encoded.size() - position);
+        size_t common = 0;
+        while (common < limit && labels_[existing.label_offset + common] == encoded[position + common]) {
+            ++common;
+        }
+        if (common == existing.label_length) {
+            node = child;
+            position += common;
+            continue;
+        }
+
+        // 在 common 处拆分边：新的中间节点接替 child 在父节点中的位置（首字节不变）
+        Node middle;
+        middle.label_offset = existing.label_offset;
+        middle.label_length = static_cast<uint32_t>(common);
+        middle.children.push_back(child);
+        const auto index = static_cast<uint32_t>(nodes_.size());
+        nodes_[child].label_offset += static_cast<uint32_t>(common);
+        nodes_[child].label_length -= static_cast<uint32_t>(common);
+        nodes_.push_back(std::move(middle));
+
+        auto& siblings = nodes_[node].children;
+        *std::find(siblings.begin(), siblings.end(), child) = index;
+        node = index;
+        position += common;
+    }
+
+    uint32_t& subtree = nodes_[node].subtree;
+    if (subtree == kNone) {
+        subtree = static_cast<uint32_t>(subtrees_.size());
+        subtrees_.push_back(Subtree{std::vector<uint8_t>(encoded.begin(), encoded.end())});
+    }
+    id = subtree;
+    return true;
+}
+
+uint32_t SNMPOIDTrie::find(std::span<const uint8_t> encoded) const noexcept {
+    uint32_t found = kNone;
+    match(encoded, [&](uint32_t id) { found = id; });
+    return (found != kNone && subtrees_[found].oid.size() == encoded.size()) ? found : kNone;
+}
+
+uint32_t SNMPOIDTrie::longest_match(std::span<const uint8_t> encoded) const noexcept {
+    uint32_t found = kNone;
+    match(encoded, [&](uint32_t id) { found = id; });
+    return found;
+}
+
+uint32_t SNMPOIDTrie::record(std::span<const uint8_t> encoded) noexcept {
+    uint32_t found = kNone;
+    match(encoded, [&](uint32_t id) {
+        ++subtrees_[id].hits;
+        found = id;
+    });
+    return found;
+}
+
+void SNMPOIDTrie::reset_counters() noexcept {
+    for (auto& subtree : subtrees_) {
+        subtree.hits = 0;
+    }
+}
+
+void SNMPOIDTrie::clear() {
+    nodes_.clear();
+    labels_.clear();
+    subtrees_.clear();
+}
+
+} // namespace protocol_parser::parsers
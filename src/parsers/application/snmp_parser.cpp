@@ -34,6 +34,53 @@ OID::OID(const std::string& dotted_notation) {
     }
 }
 
+OID::OID(std::span<const uint8_t> encoded) {
+    if (!EncodedOID::is_valid(encoded)) {
+        return;
+    }
+    uint32_t value = 0;
+    bool first = true;
+    for (uint8_t byte : encoded) {
+        value = (value << 7) | (byte & 0x7F);
+        if (byte & 0x80) {
+            continue;
+        }
+        if (first) {
+            const uint32_t arc0 = value < 80 ? value / 40 : 2;
+            components_.push_back(arc0);
+            components_.push_back(value - arc0 * 40);
+            first = false;
+        } else {
+            components_.push_back(value);
+        }
+        value = 0;
+    }
+}
+
+std::vector<uint8_t> OID::encode() const {
+    std::vector<uint8_t> encoded;
+    if (!is_valid()) {
+        return encoded;
+    }
+    const auto append = [&encoded](uint64_t value) {
+        uint8_t buffer[10];
+        size_t count = 0;
+        do {
+            buffer[count++] = static_cast<uint8_t>(value & 0x7F);
+            value >>= 7;
+        } while (value != 0);
+        while (count > 1) {
+            encoded.push_back(buffer[--count] | 0x80);
+        }
+        encoded.push_back(buffer[0]);
+    };
+    append(static_cast<uint64_t>(components_[0]) * 40 + components_[1]);
+    for (size_t i = 2; i < components_.size(); ++i) {
+        append(components_[i]);
+    }
+    return encoded;
+}
+
 const std::vector<uint32_t>& OID::components() const noexcept {
     return components_;
 }
@@ -115,8 +162,68 @@ bool VarBind::is_null() const noexcept {
 }
 
 bool VarBind::is_exception() const noexcept {
-    // 在实际实现中检查异常值
-    return false;
+    // noSuchObject / noSuchInstance / endOfMibView（RFC 3416）
+    const auto tag = static_cast<uint8_t>(type);
+    return tag >= 0x80 && tag <= 0x82;
+}
+
+VarBind SNMPVarBindView::decode() const {
+    VarBind binding;
+    binding.oid = OID(oid);
+    binding.type = static_cast<BERType>(tag);
+
+    int64_t integer = 0;
+    uint64_t unsigned_value = 0;
+    switch (binding.type) {
+        case BERType::INTEGER:
+            if (BERWalker::decode_integer(value, integer)) {
+                binding.value = integer;
+            }
+            break;
+        case BERType::OCTET_STRING:
+            binding.value = std::string(value.begin(), value.end());
+            break;
+        case BERType::OBJECT_IDENTIFIER:
+            binding.value = OID(value);
+            break;
+        case BERType::IPADDRESS:
+            if (value.size() == 4) {
+                binding.value.emplace<4>((static_cast<uint32_t>(value[0]) << 24) | (static_cast<uint32_t>(value[1]) << 16) |
+                                         (static_cast<uint32_t>(value[2]) << 8) | value[3]);
+            }
+            break;
+        case BERType::COUNTER32:
+        case BERType::GAUGE32:
+        case BERType::TIMETICKS:
+            // 变体中三者同为 uint32_t，按下标放置
+            if (BERWalker::decode_unsigned(value, unsigned_value) && unsigned_value <= UINT32_MAX) {
+                const auto number = static_cast<uint32_t>(unsigned_value);
+                if (binding.type == BERType::COUNTER32) {
+                    binding.value.emplace<5>(number);
+                } else if (binding.type == BERType::GAUGE32) {
+                    binding.value.emplace<6>(number);
+                } else {
+                    binding.value.emplace<7>(number);
+                }
+            }
+            break;
+        case BERType::COUNTER64:
+            if (BERWalker::decode_unsigned(value, unsigned_value)) {
+                binding.value = unsigned_value;
+            }
+            break;
+        case BERType::NULL_TYPE:
+            binding.value = std::monostate{};
+            break;
+        default:
+            if (!binding.is_exception()) {
+                binding.value = std::vector<uint8_t>(value.begin(), value.end());
+            } else {
+                binding.value = std::monostate{};
+            }
+            break;
+    }
+    return binding;
 }
 
 // SNMPMessage 方法实现
@@ -141,6 +248,10 @@ const SNMPPDU& SNMPMessage::get_pdu() const noexcept {
 
 // SNMPParser 方法实现
 
+SNMPParser::SNMPParser() {
+    initialize_standard_mibs();
+}
+
 const ProtocolInfo& SNMPParser::get_protocol_info() const noexcept {
     static ProtocolInfo info = {
         "SNMP",           // name
@@ -184,8 +295,6 @@ ParseResult SNMPParser::parse(ParseContext& context) noexcept {
             return ParseResult::BufferTooSmall;
         }
 
-        size_t offset = 0;
-
         // 验证BER编码
         if (!validate_ber_encoding(data, size)) {
             is_malformed_ = true;
@@ -193,14 +302,19 @@ ParseResult SNMPParser::parse(ParseContext& context) noexcept {
         }
 
         // 解析顶层序列
-        if (!parse_ber_sequence(data, size, offset)) {
+        BERWalker top(buffer);
+        BERElement message;
+        if (!top.expect(BERWalker::kSequence, message)) {
             is_malformed_ = true;
             return ParseResult::InvalidFormat;
         }
 
         // 解析版本
+        BERWalker fields(message.value);
+        BERElement version;
         int64_t version_val;
-        if (!parse_ber_integer(data, size, offset, version_val)) {
+        if (!fields.expect(BERWalker::kInteger, version) ||
+            !BERWalker::decode_integer(version.value, version_val)) {
             is_malformed_ = true;
             return ParseResult::InvalidFormat;
         }
@@ -212,10 +326,10 @@ ParseResult SNMPParser::parse(ParseContext& context) noexcept {
         switch (snmp_message_.version) {
             case SNMPVersion::VERSION_1:
             case SNMPVersion::VERSION_2C:
-                parse_success = parse_v1_v2c_message(data, size, offset);
+                parse_success = parse_v1_v2c_message(fields);
                 break;
             case SNMPVersion::VERSION_3:
-                parse_success = parse_v3_message(data, size, offset);
+                parse_success = parse_v3_message(fields);
                 break;
             default:
                 is_malformed_ = true;
@@ -259,7 +373,11 @@ std::vector<uint16_t> SNMPParser::get_supported_ports() const noexcept {
 }
 
 void SNMPParser::reset() noexcept {
+    // 保留变量绑定数组的容量，遍历响应逐包复用
+    auto bindings = std::move(snmp_message_.pdu.variable_bindings);
+    bindings.clear();
     snmp_message_ = SNMPMessage{};
+    snmp_message_.pdu.variable_bindings = std::move(bindings);
     parsed_successfully_ = false;
     is_malformed_ = false;
 }
@@ -331,7 +449,7 @@ SNMPParser::SNMPAnalysis SNMPParser::analyze_message() const noexcept {
     
     // 计算OID复杂度
     for (const auto& vb : pdu.variable_bindings) {
-        analysis.oid_complexity += vb.oid.components().size();
+        analysis.oid_complexity += vb.encoded_oid().arc_count();
     }
     
     // 分析MIB模块
@@ -409,85 +527,102 @@ std::string SNMPParser::version_to_string(SNMPVersion version) noexcept {
     }
 }
 
-// 私有方法实现（简化版）
-bool SNMPParser::parse_ber_sequence(const uint8_t* data, size_t size, size_t& offset) noexcept {
-    if (offset >= size || data[offset] != static_cast<uint8_t>(BERType::SEQUENCE)) {
+// 私有方法实现
+bool SNMPParser::parse_v1_v2c_message(BERWalker& fields) noexcept {
+    // 解析community字符串
+    BERElement community;
+    if (!fields.expect(BERWalker::kOctetString, community)) {
         return false;
     }
+    snmp_message_.community.assign(community.value.begin(), community.value.end());
     
-    offset++;
-    size_t length;
-    return parse_ber_length(data, size, offset, length);
+    // 解析PDU
+    BERElement pdu;
+    return fields.next(pdu) && parse_pdu(pdu, snmp_message_.pdu);
 }
 
-bool SNMPParser::parse_ber_length(const uint8_t* data, size_t size, size_t& offset, size_t& length) noexcept {
-    if (offset >= size) {
+bool SNMPParser::parse_pdu(const BERElement& element, SNMPPDU& pdu) noexcept {
+    // PDU 为上下文类构造类型 [0]-[8]
+    const uint8_t type = element.tag & 0x1F;
+    if ((element.tag & 0xE0) != 0xA0 || type > static_cast<uint8_t>(SNMPPDUType::REPORT)) {
         return false;
     }
-    
-    uint8_t first_byte = data[offset++];
-    
-    if ((first_byte & 0x80) == 0) {
-        // 短格式
-        length = first_byte;
-        return true;
-    }
-    
-    // 长格式
-    uint8_t num_octets = first_byte & 0x7F;
-    if (num_octets == 0 || num_octets > 4 || offset + num_octets > size) {
-        return false;
-    }
-    
-    length = 0;
-    for (uint8_t i = 0; i < num_octets; ++i) {
-        length = (length << 8) | data[offset++];
-    }
-    
-    return offset + length <= size;
-}
+    pdu.type = static_cast<SNMPPDUType>(type);
 
-bool SNMPParser::parse_ber_integer(const uint8_t* data, size_t size, size_t& offset, int64_t& value) noexcept {
-    if (offset >= size || data[offset] != static_cast<uint8_t>(BERType::INTEGER)) {
-        return false;
-    }
-    
-    offset++;
-    size_t length;
-    if (!parse_ber_length(data, size, offset, length)) {
-        return false;
-    }
-    
-    if (length == 0 || length > 8 || offset + length > size) {
-        return false;
-    }
-    
-    value = 0;
-    bool negative = (data[offset] & 0x80) != 0;
-    
-    for (size_t i = 0; i < length; ++i) {
-        value = (value << 8) | data[offset++];
-    }
-    
-    if (negative && length < 8) {
-        // 符号扩展
-        value |= (~0ULL << (length * 8));
+    BERWalker fields(element.value);
+    BERElement field;
+    int64_t value = 0;
+    const auto read_integer = [&](uint8_t tag, int64_t& out) {
+        return fields.expect(tag, field) && BERWalker::decode_integer(field.value, out);
+    };
+
+    if (pdu.type == SNMPPDUType::TRAP) {
+        // RFC 1157 Trap-PDU：enterprise、agent-addr、generic-trap、specific-trap、time-stamp
+        if (!fields.expect(BERWalker::kOID, field) || !EncodedOID::is_valid(field.value)) {
+            return false;
+        }
+        pdu.enterprise = field.value;
+        if (!fields.expect(static_cast<uint8_t>(BERType::IPADDRESS), field) || field.value.size() != 4) {
+            return false;
+        }
+        pdu.agent_addr = (static_cast<uint32_t>(field.value[0]) << 24) | (static_cast<uint32_t>(field.value[1]) << 16) |
+                         (static_cast<uint32_t>(field.value[2]) << 8) | field.value[3];
+        if (!read_integer(BERWalker::kInteger, value)) {
+            return false;
+        }
+        pdu.generic_trap = static_cast<uint32_t>(value);
+        if (!read_integer(BERWalker::kInteger, value)) {
+            return false;
+        }
+        pdu.specific_trap = static_cast<uint32_t>(value);
+        uint64_t ticks = 0;
+        if (!fields.expect(static_cast<uint8_t>(BERType::TIMETICKS), field) ||
+            !BERWalker::decode_unsigned(field.value, ticks)) {
+            return false;
+        }
+        pdu.timestamp = static_cast<uint32_t>(ticks);
+    } else {
+        if (!read_integer(BERWalker::kInteger, value)) {
+            return false;
+        }
+        pdu.request_id = static_cast<uint32_t>(value);
+        int64_t second = 0;
+        int64_t third = 0;
+        if (!read_integer(BERWalker::kInteger, second) || !read_integer(BERWalker::kInteger, third)) {
+            return false;
+        }
+        if (pdu.type == SNMPPDUType::GET_BULK_REQUEST) {
+            pdu.non_repeaters = static_cast<uint32_t>(second);
+            pdu.max_repetitions = static_cast<uint32_t>(third);
+        } else {
+            pdu.error_status = static_cast<SNMPErrorStatus>(second);
+            pdu.error_index = static_cast<uint32_t>(third);
+        }
     }
-    
-    return true;
+
+    return fields.expect(BERWalker::kSequence, field) &&
+           parse_variable_bindings(field.value, pdu.variable_bindings);
 }
 
-bool SNMPParser::parse_v1_v2c_message(const uint8_t* data, size_t size, size_t& offset) noexcept {
-    // 解析community字符串
-    if (!parse_ber_octet_string(data, size, offset, snmp_message_.community)) {
-        return false;
+bool SNMPParser::parse_variable_bindings(std::span<const uint8_t> data,
+                                         std::vector<SNMPVarBindView>& bindings) noexcept {
+    BERWalker list(data);
+    for (const BERElement& entry : list) {
+        if (entry.tag != BERWalker::kSequence) {
+            return false;
+        }
+        BERWalker pair(entry.value);
+        BERElement name;
+        BERElement value;
+        if (!pair.expect(BERWalker::kOID, name) || !EncodedOID::is_valid(name.value) || !pair.next(value)) {
+            return false;
+        }
+        bindings.push_back(SNMPVarBindView{name.value, value.tag, value.value});
     }
-    
-    // 解析PDU
-    return parse_pdu(data, size, offset, snmp_message_.pdu);
+    return !list.failed();
 }
 
-bool SNMPParser::parse_v3_message(const uint8_t* data, size_t size, size_t& offset) noexcept {
+bool SNMPParser::parse_v3_message(BERWalker& fields) noexcept {
     // 简化实现 - 实际需要解析完整的v3消息结构
     // 这里只是框架代码
     return true;
@@ -524,43 +659,74 @@ void SNMPParser::update_statistics(const SNMPMessage& message) noexcept {
     
     statistics_.error_distribution[pdu.error_status]++;
     
+    // 按编码 OID 归入已登记的子树，不做字符串格式化
+    for (const auto& vb : pdu.variable_bindings) {
+        statistics_.variable_bindings++;
+        if (oid_trie_.record(vb.oid) == SNMPOIDTrie::kNone) {
+            statistics_.unclassified_oids++;
+        }
+    }
+    
     if (is_malformed_) {
         statistics_.malformed_messages++;
     }
 }
 
-std::string SNMPParser::classify_oid_by_prefix(const OID& oid) const noexcept {
-    const auto& components = oid.components();
-    if (components.size() < 3) {
-        return "";
-    }
-    
-    // 标准MIB-II (1.3.6.1.2.1)
-    if (components.size() >= 6 && 
-        components[0] == 1 && components[1] == 3 && components[2] == 6 &&
-        components[3] == 1 && components[4] == 2 && components[5] == 1) {
-        return "MIB-II";
+const SNMPParser::MIBInfo* SNMPParser::find_mib_object(std::span<const uint8_t> encoded) const noexcept {
+    // 最深的带 MIB 信息的子树
+    const MIBInfo* found = nullptr;
+    oid_trie_.match(encoded, [&](uint32_t id) {
+        if (id < subtree_mib_.size() && subtree_mib_[id] != SNMPOIDTrie::kNone) {
+            found = &mib_objects_[subtree_mib_[id]];
+        }
+    });
+    return found;
+}
+
+std::string SNMPParser::classify_oid_by_prefix(std::span<const uint8_t> encoded) const noexcept {
+    const MIBInfo* info = find_mib_object(encoded);
+    return info != nullptr ? info->module_name : "Unknown";
+}
+
+std::optional<SNMPParser::MIBInfo> SNMPParser::lookup_oid(std::span<const uint8_t> encoded) const noexcept {
+    const MIBInfo* info = find_mib_object(encoded);
+    if (info == nullptr) {
+        return std::nullopt;
     }
-    
-    // 企业MIB (1.3.6.1.4.1)
-    if (components.size() >= 6 &&
-        components[0] == 1 && components[1] == 3 && components[2] == 6 &&
-        components[3] == 1 && components[4] == 4 && components[5] == 1) {
-        return "Enterprise";
+    return *info;
+}
+
+std::optional<SNMPParser::MIBInfo> SNMPParser::lookup_oid(const OID& oid) const noexcept {
+    try {
+        return lookup_oid(oid.encode());
+    } catch (const std::exception&) {
+        return std::nullopt;
     }
-    
-    return "Unknown";
 }
 
-// 简化的其他方法实现...
-bool SNMPParser::parse_ber_octet_string(const uint8_t* data, size_t size, size_t& offset, std::string& value) noexcept {
-    // 简化实现
+bool SNMPParser::add_mib_object(std::string_view dotted, const MIBInfo& info) {
+    uint32_t id;
+    if (!oid_trie_.add(dotted, id)) {
+        return false;
+    }
+    if (subtree_mib_.size() <= id) {
+        subtree_mib_.resize(id + 1, SNMPOIDTrie::kNone);
+    }
+    if (subtree_mib_[id] == SNMPOIDTrie::kNone) {
+        subtree_mib_[id] = static_cast<uint32_t>(mib_objects_.size());
+        mib_objects_.push_back(info);
+    } else {
+        mib_objects_[subtree_mib_[id]] = info;
+    }
     return true;
 }
 
-bool SNMPParser::parse_pdu(const uint8_t* data, size_t size, size_t& offset, SNMPPDU& pdu) noexcept {
-    // 简化实现
-    return true;
+std::optional<uint32_t> SNMPParser::add_oid_subtree(std::string_view dotted) {
+    uint32_t id;
+    if (!oid_trie_.add(dotted, id)) {
+        return std::nullopt;
+    }
+    return id;
 }
 
 bool SNMPParser::validate_pdu(const SNMPPDU& pdu) const noexcept {
@@ -572,7 +738,51 @@ void SNMPParser::perform_security_analysis() noexcept {
 }
 
 void SNMPParser::initialize_standard_mibs() noexcept {
-    // 初始化标准MIB
+    struct StandardObject {
+        const char* oid;
+        const char* module;
+        const char* name;
+        BERType syntax;
+        bool is_table;
+    };
+    static constexpr StandardObject kObjects[] = {
+        {"1.3.6.1.2.1", "MIB-II", "mib-2", BERType::NULL_TYPE, false},
+        {"1.3.6.1.2.1.1", "SNMPv2-MIB", "system", BERType::NULL_TYPE, false},
+        {"1.3.6.1.2.1.1.1", "SNMPv2-MIB", "sysDescr", BERType::OCTET_STRING, false},
+        {"1.3.6.1.2.1.1.2", "SNMPv2-MIB", "sysObjectID", BERType::OBJECT_IDENTIFIER, false},
+        {"1.3.6.1.2.1.1.3", "SNMPv2-MIB", "sysUpTime", BERType::TIMETICKS, false},
+        {"1.3.6.1.2.1.1.4", "SNMPv2-MIB", "sysContact", BERType::OCTET_STRING, false},
+        {"1.3.6.1.2.1.1.5", "SNMPv2-MIB", "sysName", BERType::OCTET_STRING, false},
+        {"1.3.6.1.2.1.1.6", "SNMPv2-MIB", "sysLocation", BERType::OCTET_STRING, false},
+        {"1.3.6.1.2.1.2", "IF-MIB", "interfaces", BERType::NULL_TYPE, false},
+        {"1.3.6.1.2.1.2.2", "IF-MIB", "ifTable", BERType::SEQUENCE, true},
+        {"1.3.6.1.2.1.2.2.1.10", "IF-MIB", "ifInOctets", BERType::COUNTER32, false},
+        {"1.3.6.1.2.1.2.2.1.16", "IF-MIB", "ifOutOctets", BERType::COUNTER32, false},
+        {"1.3.6.1.2.1.4", "IP-MIB", "ip", BERType::NULL_TYPE, false},
+        {"1.3.6.1.2.1.6", "TCP-MIB", "tcp", BERType::NULL_TYPE, false},
+        {"1.3.6.1.2.1.7", "UDP-MIB", "udp", BERType::NULL_TYPE, false},
+        {"1.3.6.1.2.1.11", "SNMPv2-MIB", "snmp", BERType::NULL_TYPE, false},
+        {"1.3.6.1.2.1.25", "HOST-RESOURCES-MIB", "host", BERType::NULL_TYPE, false},
+        {"1.3.6.1.2.1.31.1.1", "IF-MIB", "ifXTable", BERType::SEQUENCE, true},
+        {"1.3.6.1.2.1.31.1.1.1.6", "IF-MIB", "ifHCInOctets", BERType::COUNTER64, false},
+        {"1.3.6.1.2.1.31.1.1.1.10", "IF-MIB", "ifHCOutOctets", BERType::COUNTER64, false},
+        {"1.3.6.1.4.1", "Enterprise", "enterprises", BERType::NULL_TYPE, false},
+        {"1.3.6.1.6.3", "SNMPv2-SMI", "snmpModules", BERType::NULL_TYPE, false},
+    };
+
+    try {
+        for (const auto& object : kObjects) {
+            MIBInfo info;
+            info.module_name = object.module;
+            info.object_name = object.name;
+            info.syntax = object.syntax;
+            info.is_table = object.is_table;
+            info.is_readable = object.syntax != BERType::NULL_TYPE;
+            add_mib_object(object.oid, info);
+        }
+    } catch (const std::exception&) {
+        // 内存不足时保留已登记的部分
+    }
 }
 
 } // namespace protocol_parser::parsers
\ No newline at end of file
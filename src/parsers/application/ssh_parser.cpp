@@ -1,158 +1,194 @@
 #include "../../../include/parsers/application/ssh_parser.hpp"
+#include "utils/digest.hpp"
 #include <algorithm>
-#include <sstream>
+#include <bit>
 #include <cstring>
 
 namespace protocol_parser::parsers {
 
-// 类型引用已在头文件中简化
-// SSH相关类型已在头文件中定义
+namespace {
+    constexpr std::string_view kVersionPrefix = "SSH-";
+    constexpr size_t kMaxPacketLength = 35000;   // RFC 4253 6.1
 
-ParseResult SSHParser::parse(ParseContext& context) noexcept {
-    const BufferView& buffer = context.buffer;
-    if (buffer.size() < 4) {
-        return ParseResult::NeedMoreData;
+    inline size_t index_of(SSHDirection direction) noexcept {
+        return static_cast<size_t>(direction);
     }
-    
-    if (!validate_ssh_packet(buffer)) {
+}
+
+void SSHTrafficCounters::record(size_t size, uint64_t now_us) noexcept {
+    const auto length = static_cast<uint32_t>(std::min<size_t>(size, UINT32_MAX));
+    if (packets == 0) {
+        min_size = length;
+        first_us = now_us;
+    } else {
+        min_size = std::min(min_size, length);
+        if (now_us > last_us) {
+            max_gap_us = std::max(max_gap_us, now_us - last_us);
+        }
+    }
+    max_size = std::max(max_size, length);
+    last_us = std::max(last_us, now_us);
+    ++packets;
+    bytes += size;
+    const size_t bucket = size == 0 ? 0 : static_cast<size_t>(std::bit_width((size - 1) >> 6));
+    ++size_histogram[std::min(bucket, kSizeBuckets - 1)];
+}
+
+const ProtocolInfo& SSHParser::get_protocol_info() const noexcept {
+    static const ProtocolInfo info{
+        "SSH",          // name
+        22,             // type (port)
+        5,              // header_size: packet_length + padding_length
+        4,              // min_packet_size: "SSH-"
+        kMaxPacketLength + 4
+    };
+    return info;
+}
+
+bool SSHParser::can_parse(const BufferView& buffer) const noexcept {
+    return validate_ssh_packet(buffer);
+}
+
+ParseResult SSHParser::parse(ParseContext& context) noexcept {
+    if (ssh_connection_.state == SSHConnectionState::DISCONNECTED) {
         return ParseResult::InvalidFormat;
     }
     
-    // Determine parsing based on connection state
-    switch (ssh_connection_.state) {
-        case SSHConnectionState::VERSION_EXCHANGE:
-        case SSHConnectionState::UNKNOWN:
-            return parse_version_exchange(buffer);
+    // The banner and the first packets often share a segment: consume every complete
+    // element from context.offset and leave a trailing partial one in place
+    const BufferView& buffer = context.buffer;
+    bool parsed = false;
+    try {
+        while (context.offset < buffer.size()) {
+            const BufferView rest = buffer.substr(context.offset);
             
-        case SSHConnectionState::KEY_EXCHANGE:
-        case SSHConnectionState::AUTHENTICATION:
-        case SSHConnectionState::CONNECTION:
-            return parse_binary_packet(buffer);
+            // Past NEWKEYS the direction is encrypted: only count it, keep nothing
+            const size_t side = index_of(direction_);
+            if (ssh_connection_.encrypted[side]) {
+                ssh_connection_.traffic[side].record(rest.size(), now_us_);
+                context.offset = buffer.size();
+                return ParseResult::Success;
+            }
             
-        case SSHConnectionState::DISCONNECTED:
-            return ParseResult::InvalidFormat;
+            if (rest.size() < kVersionPrefix.size()) {
+                break;
+            }
             
-        default:
-            return ParseResult::InvalidFormat;
+            size_t consumed = 0;
+            const ParseResult status = expects_version_line(rest)
+                ? parse_version_exchange(rest, consumed)
+                : parse_binary_packet(rest, consumed);
+            if (status == ParseResult::NeedMoreData) {
+                break;
+            }
+            if (status != ParseResult::Success) {
+                return status;
+            }
+            context.offset += consumed;
+            parsed = true;
+        }
+    } catch (const std::exception&) {
+        return ParseResult::InternalError;
+    }
+    
+    return parsed ? ParseResult::Success : ParseResult::NeedMoreData;
+}
+
+bool SSHParser::expects_version_line(const BufferView& buffer) const noexcept {
+    // Each direction sends its identification string before any binary packet
+    if (direction_known_) {
+        return (direction_ == SSHDirection::CLIENT_TO_SERVER
+            ? ssh_connection_.client_version : ssh_connection_.server_version).empty();
     }
+    // Without a direction, the client's KEXINIT may follow its banner before the server's arrives
+    if (ssh_connection_.version_exchange_complete) {
+        return false;
+    }
+    const std::string_view data(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+    return ssh_connection_.client_version.empty() || data.starts_with(kVersionPrefix);
 }
 
-ParseResult SSHParser::parse_version_exchange(const BufferView& buffer) {
+ParseResult SSHParser::parse_version_exchange(const BufferView& buffer, size_t& consumed) {
+    const std::string_view data(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+    if (!data.starts_with(kVersionPrefix)) {
+        return ParseResult::InvalidFormat;
+    }
     if (!is_version_line_complete(buffer)) {
         return ParseResult::NeedMoreData;
     }
     
-    // Convert buffer to string
-    std::string data(reinterpret_cast<const char*>(buffer.data()), buffer.size());
-    
-    // Find the end of the version line
-    size_t line_end = data.find("\r\n");
-    if (line_end == std::string::npos) {
-        line_end = data.find('\n');
-        if (line_end == std::string::npos) {
-            return ParseResult::NeedMoreData;
-        }
+    const size_t line_end = data.find('\n');
+    consumed = line_end + 1;
+    std::string_view version_line = data.substr(0, line_end);
+    if (version_line.ends_with('\r')) {
+        version_line.remove_suffix(1);
     }
     
-    std::string version_line = data.substr(0, line_end);
-    
     if (!validate_version_string(version_line)) {
         return ParseResult::InvalidFormat;
     }
     
-    // Parse version string: "SSH-protoversion-softwareversion SP comments"
-    SSHVersionExchange version_info;
-    
-    // Split by spaces to separate version and comments
-    size_t space_pos = version_line.find(' ');
-    std::string version_part = (space_pos != std::string::npos) ? 
-                              version_line.substr(0, space_pos) : version_line;
-    
-    if (space_pos != std::string::npos && space_pos + 1 < version_line.length()) {
-        version_info.comments = version_line.substr(space_pos + 1);
-    }
-    
-    // Parse version part: "SSH-protoversion-softwareversion"
-    std::vector<std::string> parts;
-    std::istringstream iss(version_part);
-    std::string part;
-    
-    while (std::getline(iss, part, '-')) {
-        parts.push_back(part);
-    }
-    
-    if (parts.size() < 3 || parts[0] != "SSH") {
+    // "SSH-protoversion-softwareversion SP comments"
+    const size_t space_pos = version_line.find(' ');
+    const std::string_view version_part = version_line.substr(0, space_pos);
+    const size_t dash_pos = version_part.find('-', kVersionPrefix.size());
+    if (dash_pos == std::string_view::npos || dash_pos + 1 == version_part.size()) {
         return ParseResult::InvalidFormat;
     }
     
-    version_info.version_string = version_part;
-    version_info.version = string_to_version(parts[1]);
-    
-    // Combine software version parts (everything after protocol version)
-    for (size_t i = 2; i < parts.size(); ++i) {
-        if (i > 2) version_info.software_version += "-";
-        version_info.software_version += parts[i];
+    // Client speaks first unless the direction is known
+    const SSHDirection sender = direction_known_ ? direction_
+        : (ssh_connection_.client_version.empty() ? SSHDirection::CLIENT_TO_SERVER : SSHDirection::SERVER_TO_CLIENT);
+    SSHVersionExchange& version_info = sender == SSHDirection::CLIENT_TO_SERVER
+        ? ssh_connection_.client_version : ssh_connection_.server_version;
+    if (ssh_connection_.version_exchange_complete || !version_info.empty()) {
+        return ParseResult::Success;
     }
     
-    // Determine if this is client or server version
-    if (!ssh_connection_.version_exchange_complete) {
-        if (ssh_connection_.client_version.version_string.empty()) {
-            ssh_connection_.client_version = version_info;
-        } else {
-            ssh_connection_.server_version = version_info;
-            ssh_connection_.version_exchange_complete = true;
-            update_connection_state();
-        }
+    std::copy(version_line.begin(), version_line.end(), version_info.line.begin());
+    version_info.length = static_cast<uint8_t>(version_line.size());
+    version_info.version_length = static_cast<uint8_t>(version_part.size());
+    version_info.software_offset = static_cast<uint8_t>(dash_pos + 1);
+    version_info.version = string_to_version(
+        version_part.substr(kVersionPrefix.size(), dash_pos - kVersionPrefix.size()));
+    
+    if (!ssh_connection_.client_version.empty() && !ssh_connection_.server_version.empty()) {
+        ssh_connection_.version_exchange_complete = true;
+        update_connection_state();
     }
     
     return ParseResult::Success;
 }
 
-ParseResult SSHParser::parse_binary_packet(const BufferView& buffer) {
+ParseResult SSHParser::parse_binary_packet(const BufferView& buffer, size_t& consumed) {
     if (buffer.size() < 5) { // Minimum: packet_length(4) + padding_length(1)
         return ParseResult::NeedMoreData;
     }
     
     SSHBinaryPacket packet;
-    
-    // Read packet length (first 4 bytes, big-endian)
-    packet.packet_length = (static_cast<uint32_t>(buffer.data()[0]) << 24) |
-                          (static_cast<uint32_t>(buffer.data()[1]) << 16) |
-                          (static_cast<uint32_t>(buffer.data()[2]) << 8) |
-                          static_cast<uint32_t>(buffer.data()[3]);
+    packet.packet_length = buffer.read_be32(0);
     
     // Validate packet length
-    if (packet.packet_length < 1 || packet.packet_length > 35000) {
+    if (packet.packet_length < 1 || packet.packet_length > kMaxPacketLength) {
         return ParseResult::InvalidFormat;
     }
     
     // Check if we have the complete packet
-    size_t total_packet_size = 4 + packet.packet_length; // 4 bytes for length field
+    const size_t total_packet_size = 4 + static_cast<size_t>(packet.packet_length); // 4 bytes for length field
     if (buffer.size() < total_packet_size) {
         return ParseResult::NeedMoreData;
     }
     
-    // Read padding length
-    packet.padding_length = buffer.data()[4];
-    
     // Validate padding length
+    packet.padding_length = buffer.data()[4];
     if (packet.padding_length < 4 || packet.padding_length >= packet.packet_length) {
         return ParseResult::InvalidFormat;
     }
     
-    // Calculate payload size
-    size_t payload_size = packet.packet_length - 1 - packet.padding_length;
-    
-    // Read payload
-    packet.payload.resize(payload_size);
-    std::memcpy(packet.payload.data(), buffer.data() + 5, payload_size);
-    
-    // Read padding
-    packet.padding.resize(packet.padding_length);
-    std::memcpy(packet.padding.data(), buffer.data() + 5 + payload_size, packet.padding_length);
-    
-    // For now, assume no MAC (would need encryption context to determine)
-    packet.has_mac = false;
+    // Payload stays in the buffer; the MAC (if any) follows the padding
+    const size_t payload_size = packet.packet_length - 1 - packet.padding_length;
+    packet.payload = std::span<const uint8_t>(buffer.data() + 5, payload_size);
+    consumed = total_packet_size;
     
     return parse_ssh_message(packet);
 }
@@ -164,63 +200,72 @@ ParseResult SSHParser::parse_ssh_message(const SSHBinaryPacket& packet) {
     
     SSHMessage message;
     message.type = static_cast<SSHMessageType>(packet.payload[0]);
-    
-    // Copy message data (excluding message type byte)
-    if (packet.payload.size() > 1) {
-        message.data.assign(packet.payload.begin() + 1, packet.payload.end());
-    }
+    message.payload_length = static_cast<uint32_t>(packet.payload.size() - 1);
+    message.direction = direction_;
+    const auto data = packet.payload.subspan(1);
     
     // Parse specific message types
     switch (message.type) {
         case SSHMessageType::SSH_MSG_KEXINIT: {
-            SSHKeyExchangeInit kex_init_msg;
-            ParseResult status = parse_kex_init(packet.payload, kex_init_msg);
-            if (status != ParseResult::Success) {
-                return status;
+            SSHKexInitView kex_init;
+            if (!parse_kex_init(packet.payload, kex_init)) {
+                return ParseResult::InvalidFormat;
+            }
+            const SSHDirection sender = direction_known_ ? direction_
+                : (ssh_connection_.fingerprints.has_client ? SSHDirection::SERVER_TO_CLIENT : SSHDirection::CLIENT_TO_SERVER);
+            message.direction = sender;
+            auto& fingerprints = ssh_connection_.fingerprints;
+            if (sender == SSHDirection::CLIENT_TO_SERVER) {
+                fingerprints.hassh = hassh(kex_init, sender);
+                fingerprints.has_client = true;
+            } else {
+                fingerprints.hassh_server = hassh(kex_init, sender);
+                fingerprints.has_server = true;
             }
-            message.kex_init = kex_init_msg;
             break;
         }
         
         case SSHMessageType::SSH_MSG_DISCONNECT: {
-            if (message.data.size() >= 4) {
-                size_t offset = 0;
-                SSHDisconnectMessage disconnect_msg;
-                disconnect_msg.reason_code = read_uint32(message.data, offset);
-                disconnect_msg.description = read_string(message.data, offset);
-                if (offset < message.data.size()) {
-                    disconnect_msg.language_tag = read_string(message.data, offset);
+            size_t offset = 0;
+            SSHDisconnectMessage disconnect_msg;
+            std::string_view description;
+            std::string_view language_tag;
+            if (read_uint32(data, offset, disconnect_msg.reason_code) && read_string(data, offset, description)) {
+                disconnect_msg.description = description;
+                if (read_string(data, offset, language_tag)) {
+                    disconnect_msg.language_tag = language_tag;
                 }
-                message.disconnect = disconnect_msg;
+                message.disconnect = std::move(disconnect_msg);
                 ssh_connection_.state = SSHConnectionState::DISCONNECTED;
             }
             break;
         }
         
-        case SSHMessageType::SSH_MSG_SERVICE_REQUEST: {
-            if (!message.data.empty()) {
-                size_t offset = 0;
-                SSHServiceMessage service_msg;
-                service_msg.service_name = read_string(message.data, offset);
-                message.service_request = service_msg;
+        case SSHMessageType::SSH_MSG_SERVICE_REQUEST:
+        case SSHMessageType::SSH_MSG_SERVICE_ACCEPT: {
+            size_t offset = 0;
+            std::string_view service_name;
+            if (read_string(data, offset, service_name)) {
+                auto& target = message.type == SSHMessageType::SSH_MSG_SERVICE_REQUEST
+                    ? message.service_request : message.service_accept;
+                target = SSHServiceMessage{std::string(service_name)};
             }
             break;
         }
         
-        case SSHMessageType::SSH_MSG_SERVICE_ACCEPT: {
-            if (!message.data.empty()) {
-                size_t offset = 0;
-                SSHServiceMessage service_msg;
-                service_msg.service_name = read_string(message.data, offset);
-                message.service_accept = service_msg;
+        case SSHMessageType::SSH_MSG_NEWKEYS: {
+            // Everything this side sends from now on is encrypted
+            if (direction_known_) {
+                ssh_connection_.encrypted[index_of(direction_)] = true;
+            } else {
+                ssh_connection_.encrypted.fill(true);
+            }
+            if (ssh_connection_.encrypted[0] && ssh_connection_.encrypted[1]) {
+                ssh_connection_.key_exchange_complete = true;
+                update_connection_state();
             }
             break;
         }
-        
-        case SSHMessageType::SSH_MSG_NEWKEYS:
-            ssh_connection_.key_exchange_complete = true;
-            update_connection_state();
-            break;
             
         case SSHMessageType::SSH_MSG_USERAUTH_SUCCESS:
             ssh_connection_.authentication_complete = true;
@@ -228,59 +273,62 @@ ParseResult SSHParser::parse_ssh_message(const SSHBinaryPacket& packet) {
             break;
             
         default:
-            // For other message types, just store the raw data
             break;
     }
     
-    ssh_connection_.messages.push_back(message);
+    if (ssh_connection_.messages.size() < SSHConnection::kMaxMessages) {
+        ssh_connection_.messages.push_back(std::move(message));
+    } else {
+        ++ssh_connection_.messages_dropped;
+    }
     return ParseResult::Success;
 }
 
-ParseResult SSHParser::parse_kex_init(const std::vector<uint8_t>& payload, SSHKeyExchangeInit& kex_init) {
+bool SSHParser::parse_kex_init(std::span<const uint8_t> payload, SSHKexInitView& out) noexcept {
     if (payload.size() < 17) { // 1 byte msg type + 16 bytes cookie
-        return ParseResult::InvalidFormat;
+        return false;
     }
     
-    size_t offset = 1; // Skip message type
-    
-    // Read cookie (16 bytes)
-    std::memcpy(kex_init.cookie.data(), payload.data() + offset, 16);
-    offset += 16;
-    
-    try {
-        // Read algorithm lists
-        kex_init.kex_algorithms = parse_name_list(payload, offset);
-        kex_init.server_host_key_algorithms = parse_name_list(payload, offset);
-        kex_init.encryption_algorithms_client_to_server = parse_name_list(payload, offset);
-        kex_init.encryption_algorithms_server_to_client = parse_name_list(payload, offset);
-        kex_init.mac_algorithms_client_to_server = parse_name_list(payload, offset);
-        kex_init.mac_algorithms_server_to_client = parse_name_list(payload, offset);
-        kex_init.compression_algorithms_client_to_server = parse_name_list(payload, offset);
-        kex_init.compression_algorithms_server_to_client = parse_name_list(payload, offset);
-        kex_init.languages_client_to_server = parse_name_list(payload, offset);
-        kex_init.languages_server_to_client = parse_name_list(payload, offset);
-        
-        // Read boolean and reserved field
-        if (offset < payload.size()) {
-            kex_init.first_kex_packet_follows = (read_uint8(payload, offset) != 0);
-        }
-        if (offset + 3 < payload.size()) {
-            kex_init.reserved = read_uint32(payload, offset);
+    out.cookie = payload.subspan(1, 16);
+    size_t offset = 17;
+    for (auto& name_list : out.name_lists) {
+        if (!read_string(payload, offset, name_list)) {
+            return false;
         }
-    } catch (...) {
-        return ParseResult::InvalidFormat;
     }
     
-    return ParseResult::Success;
+    // first_kex_packet_follows and reserved are optional for lenient peers
+    if (offset < payload.size()) {
+        out.first_kex_packet_follows = payload[offset++] != 0;
+    }
+    if (!read_uint32(payload, offset, out.reserved)) {
+        out.reserved = 0;
+    }
+    return true;
+}
+
+HASSHDigest SSHParser::hassh(const SSHKexInitView& kex_init, SSHDirection sender) noexcept {
+    const bool client = sender == SSHDirection::CLIENT_TO_SERVER;
+    utils::MD5 md5;
+    md5.update(kex_init.list(SSHNameList::KEX_ALGORITHMS));
+    md5.update(";");
+    md5.update(kex_init.list(client ? SSHNameList::ENCRYPTION_CLIENT_TO_SERVER : SSHNameList::ENCRYPTION_SERVER_TO_CLIENT));
+    md5.update(";");
+    md5.update(kex_init.list(client ? SSHNameList::MAC_CLIENT_TO_SERVER : SSHNameList::MAC_SERVER_TO_CLIENT));
+    md5.update(";");
+    md5.update(kex_init.list(client ? SSHNameList::COMPRESSION_CLIENT_TO_SERVER : SSHNameList::COMPRESSION_SERVER_TO_CLIENT));
+    
+    HASSHDigest result{};
+    utils::to_hex(md5.finalize(), result);
+    return result;
 }
 
 bool SSHParser::is_version_line_complete(const BufferView& buffer) const {
-    std::string data(reinterpret_cast<const char*>(buffer.data()), buffer.size());
-    return data.find('\n') != std::string::npos;
+    return std::memchr(buffer.data(), '\n', buffer.size()) != nullptr;
 }
 
-bool SSHParser::validate_version_string(const std::string& version_str) const {
-    if (version_str.length() < 4 || version_str.substr(0, 4) != "SSH-") {
+bool SSHParser::validate_version_string(std::string_view version_str) const {
+    if (!version_str.starts_with(kVersionPrefix) || version_str.size() > SSHVersionExchange::kMaxLength) {
         return false;
     }
     
@@ -302,72 +350,35 @@ bool SSHParser::validate_ssh_packet(const BufferView& buffer) const {
     // If we're in version exchange, check for SSH version string
     if (ssh_connection_.state == SSHConnectionState::VERSION_EXCHANGE || 
         ssh_connection_.state == SSHConnectionState::UNKNOWN) {
-        std::string data(reinterpret_cast<const char*>(buffer.data()), 
-                        std::min(buffer.size(), size_t(255)));
-        return data.find("SSH-") == 0;
+        const std::string_view data(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+        return data.starts_with(kVersionPrefix);
     }
     
     // For binary packets, basic validation
     return buffer.size() >= 5;
 }
 
-std::vector<std::string> SSHParser::parse_name_list(const std::vector<uint8_t>& data, size_t& offset) const {
-    std::vector<std::string> names;
-    std::string name_list = read_string(data, offset);
-    
-    if (name_list.empty()) {
-        return names;
-    }
-    
-    std::istringstream iss(name_list);
-    std::string name;
-    
-    while (std::getline(iss, name, ',')) {
-        if (!name.empty()) {
-            names.push_back(name);
-        }
-    }
-    
-    return names;
-}
-
-std::string SSHParser::read_string(const std::vector<uint8_t>& data, size_t& offset) const {
-    if (offset + 4 > data.size()) {
-        throw std::runtime_error("Not enough data for string length");
-    }
-    
-    uint32_t length = read_uint32(data, offset);
-    
-    if (offset + length > data.size()) {
-        throw std::runtime_error("Not enough data for string content");
+bool SSHParser::read_string(std::span<const uint8_t> data, size_t& offset, std::string_view& out) noexcept {
+    uint32_t length = 0;
+    size_t position = offset;
+    if (!read_uint32(data, position, length) || length > data.size() - position) {
+        return false;
     }
-    
-    std::string result(reinterpret_cast<const char*>(data.data() + offset), length);
-    offset += length;
-    
-    return result;
+    out = std::string_view(reinterpret_cast<const char*>(data.data() + position), length);
+    offset = position + length;
+    return true;
 }
 
-uint32_t SSHParser::read_uint32(const std::vector<uint8_t>& data, size_t& offset) const {
-    if (offset + 4 > data.size()) {
-        throw std::runtime_error("Not enough data for uint32");
+bool SSHParser::read_uint32(std::span<const uint8_t> data, size_t& offset, uint32_t& out) noexcept {
+    if (offset > data.size() || data.size() - offset < 4) {
+        return false;
     }
-    
-    uint32_t value = (static_cast<uint32_t>(data[offset]) << 24) |
-                    (static_cast<uint32_t>(data[offset + 1]) << 16) |
-                    (static_cast<uint32_t>(data[offset + 2]) << 8) |
-                    static_cast<uint32_t>(data[offset + 3]);
-    
+    out = (static_cast<uint32_t>(data[offset]) << 24) |
+          (static_cast<uint32_t>(data[offset + 1]) << 16) |
+          (static_cast<uint32_t>(data[offset + 2]) << 8) |
+          static_cast<uint32_t>(data[offset + 3]);
     offset += 4;
-    return value;
-}
-
-uint8_t SSHParser::read_uint8(const std::vector<uint8_t>& data, size_t& offset) const {
-    if (offset >= data.size()) {
-        throw std::runtime_error("Not enough data for uint8");
-    }
-    
-    return data[offset++];
+    return true;
 }
 
 bool SSHParser::is_connection_established() const {
@@ -420,7 +431,7 @@ std::string SSHParser::version_to_string(SSHVersion version) const {
     }
 }
 
-SSHVersion SSHParser::string_to_version(const std::string& version_str) const {
+SSHVersion SSHParser::string_to_version(std::string_view version_str) const {
     if (version_str == "1.0") return SSHVersion::SSH_1_0;
     if (version_str == "1.3") return SSHVersion::SSH_1_3;
     if (version_str == "1.5") return SSHVersion::SSH_1_5;
@@ -502,7 +513,9 @@ std::string SSHParser::disconnect_reason_to_string(SSHDisconnectReason reason) c
 
 void SSHParser::reset() noexcept {
     ssh_connection_ = SSHConnection();
-    ssh_connection_.state = SSHConnectionState::VERSION_EXCHANGE;
+    direction_ = SSHDirection::CLIENT_TO_SERVER;
+    direction_known_ = false;
+    now_us_ = 0;
 }
 
 void SSHParser::update_connection_state() {
@@ -0,0 +1,458 @@
+#include "parsers/application/tls_fingerprint.hpp"
+#include "utils/digest.hpp"
+#include <algorithm>
+
+namespace protocol_parser::parsers {
+
+namespace {
+    constexpr uint8_t kClientHello = 1;
+    constexpr uint8_t kServerHello = 2;
+    constexpr uint8_t kHandshakeContentType = 22;
+    constexpr size_t kRandomSize = 32;
+
+    constexpr uint16_t kExtServerName = 0;
+    constexpr uint16_t kExtSupportedGroups = 10;
+    constexpr uint16_t kExtECPointFormats = 11;
+    constexpr uint16_t kExtSignatureAlgorithms = 13;
+    constexpr uint16_t kExtALPN = 16;
+    constexpr uint16_t kExtSupportedVersions = 43;
+
+    inline uint16_t read_u16(std::span<const uint8_t> data, size_t offset) noexcept {
+        return static_cast<uint16_t>((data[offset] << 8) | data[offset + 1]);
+    }
+
+    // Length-prefixed sub-vector; empty span if it overruns
+    inline std::span<const uint8_t> prefixed(std::span<const uint8_t> data, size_t prefix_bytes) noexcept {
+        if (data.size() < prefix_bytes) {
+            return {};
+        }
+        const size_t length = prefix_bytes == 1 ? data[0] : read_u16(data, 0);
+        if (prefix_bytes + length > data.size()) {
+            return {};
+        }
+        return data.subspan(prefix_bytes, length);
+    }
+
+    /**
+     * Streams fingerprint text into a digest through a small stack buffer,
+     * so the JA3/JA4 strings are never materialized.
+     */
+    template <typename Hash>
+    class DigestWriter {
+    public:
+        void put(char c) noexcept {
+            if (used_ == buffer_.size()) {
+                flush();
+            }
+            buffer_[used_++] = static_cast<uint8_t>(c);
+        }
+
+        void put_decimal(uint32_t value) noexcept {
+            char digits[10];
+            size_t count = 0;
+            do {
+                digits[count++] = static_cast<char>('0' + value % 10);
+                value /= 10;
+            } while (value != 0);
+            while (count > 0) {
+                put(digits[--count]);
+            }
+        }
+
+        void put_hex16(uint16_t value) noexcept {
+            static constexpr char kHexDigits[] = "0123456789abcdef";
+            put(kHexDigits[(value >> 12) & 0xF]);
+            put(kHexDigits[(value >> 8) & 0xF]);
+            put(kHexDigits[(value >> 4) & 0xF]);
+            put(kHexDigits[value & 0xF]);
+        }
+
+        typename Hash::Digest finish() noexcept {
+            flush();
+            return hash_.finalize();
+        }
+
+    private:
+        Hash hash_;
+        std::array<uint8_t, 64> buffer_{};
+        size_t used_ = 0;
+
+        void flush() noexcept {
+            hash_.update(std::span<const uint8_t>(buffer_.data(), used_));
+            used_ = 0;
+        }
+    };
+
+    // Dash-separated decimal list of the non-GREASE uint16 entries
+    template <typename Writer>
+    void put_u16_list(Writer& writer, std::span<const uint8_t> list) noexcept {
+        bool first = true;
+        for (size_t offset = 0; offset + 2 <= list.size(); offset += 2) {
+            const uint16_t value = read_u16(list, offset);
+            if (TLSHelloScanner::is_grease(value)) {
+                continue;
+            }
+            if (!first) {
+                writer.put('-');
+            }
+            writer.put_decimal(value);
+            first = false;
+        }
+    }
+
+    template <typename Writer>
+    void put_extension_types(Writer& writer, const TLSHelloView& view) noexcept {
+        bool first = true;
+        view.for_each_extension([&](uint16_t type, std::span<const uint8_t>) {
+            if (TLSHelloScanner::is_grease(type)) {
+                return;
+            }
+            if (!first) {
+                writer.put('-');
+            }
+            writer.put_decimal(type);
+            first = false;
+        });
+    }
+
+    inline void hex_prefix(const utils::SHA256::Digest& digest, char* out) noexcept {
+        utils::to_hex(std::span<const uint8_t>(digest.data(), 6), std::span<char>(out, 12));
+    }
+
+    // Non-GREASE entries of a uint16 list, sorted (JA4 part b)
+    size_t sort_u16(std::span<const uint8_t> list, std::array<uint16_t, TLSHelloScanner::kMaxSortedEntries>& out) noexcept {
+        size_t count = 0;
+        for (size_t offset = 0; offset + 2 <= list.size() && count < out.size(); offset += 2) {
+            const uint16_t value = read_u16(list, offset);
+            if (!TLSHelloScanner::is_grease(value)) {
+                out[count++] = value;
+            }
+        }
+        std::sort(out.begin(), out.begin() + count);
+        return count;
+    }
+
+    void ja4_version(uint16_t version, char* out) noexcept {
+        const char* text = "00";
+        switch (version) {
+            case 0x0304: text = "13"; break;
+            case 0x0303: text = "12"; break;
+            case 0x0302: text = "11"; break;
+            case 0x0301: text = "10"; break;
+            case 0x0300: text = "s3"; break;
+            case 0x0002: text = "s2"; break;
+            case 0xFEFF: text = "d1"; break;
+            case 0xFEFD: text = "d2"; break;
+            case 0xFEFC: text = "d3"; break;
+            default: break;
+        }
+        out[0] = text[0];
+        out[1] = text[1];
+    }
+
+    inline void two_digits(size_t value, char* out) noexcept {
+        value = std::min<size_t>(value, 99);
+        out[0] = static_cast<char>('0' + value / 10);
+        out[1] = static_cast<char>('0' + value % 10);
+    }
+
+    inline bool is_alnum(uint8_t c) noexcept {
+        return (c >= '0' && c <= '9') || (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z');
+    }
+}
+
+std::string_view TLSHelloView::first_alpn() const noexcept {
+    const auto name = prefixed(alpn, 1);
+    return {reinterpret_cast<const char*>(name.data()), name.size()};
+}
+
+bool TLSHelloScanner::scan_extensions(std::span<const uint8_t> block, TLSHelloView& out) noexcept {
+    size_t offset = 0;
+    while (offset < block.size()) {
+        if (offset + 4 > block.size()) {
+            return false;
+        }
+        const uint16_t type = read_u16(block, offset);
+        const size_t length = read_u16(block, offset + 2);
+        if (offset + 4 + length > block.size()) {
+            return false;
+        }
+        const auto data = block.subspan(offset + 4, length);
+        offset += 4 + length;
+        ++out.extension_count;
+
+        // Contents are best effort: a malformed extension body leaves its field empty
+        switch (type) {
+            case kExtServerName: {
+                out.has_server_name = true;
+                const auto list = prefixed(data, 2);
+                for (size_t entry = 0; entry + 3 <= list.size();) {
+                    const auto name = prefixed(list.subspan(entry + 1), 2);
+                    if (list[entry] == 0 && !name.empty()) {
+                        out.server_name = {reinterpret_cast<const char*>(name.data()), name.size()};
+                        break;
+                    }
+                    entry += 3 + read_u16(list, entry + 1);
+                }
+                break;
+            }
+            case kExtALPN:
+                out.alpn = prefixed(data, 2);
+                break;
+            case kExtSupportedGroups:
+                out.supported_groups = prefixed(data, 2);
+                break;
+            case kExtECPointFormats:
+                out.ec_point_formats = prefixed(data, 1);
+                break;
+            case kExtSignatureAlgorithms:
+                out.signature_algorithms = prefixed(data, 2);
+                break;
+            case kExtSupportedVersions:
+                if (out.is_client) {
+                    out.supported_versions = prefixed(data, 1);
+                    uint16_t highest = 0;
+                    for (size_t i = 0; i + 2 <= out.supported_versions.size(); i += 2) {
+                        const uint16_t version = read_u16(out.supported_versions, i);
+                        if (!is_grease(version)) {
+                            highest = std::max(highest, version);
+                        }
+                    }
+                    if (highest != 0) {
+                        out.version = highest;
+                    }
+                } else if (data.size() == 2) {
+                    out.supported_versions = data;
+                    out.version = read_u16(data, 0);
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    return true;
+}
+
+bool TLSHelloScanner::scan_handshake(std::span<const uint8_t> message, TLSHelloView& out) noexcept {
+    out = TLSHelloView{};
+    if (message.size() < kHandshakeHeaderSize) {
+        return false;
+    }
+    const uint8_t type = message[0];
+    if (type != kClientHello && type != kServerHello) {
+        return false;
+    }
+    const size_t length = (static_cast<size_t>(message[1]) << 16) | (static_cast<size_t>(message[2]) << 8) | message[3];
+    if (kHandshakeHeaderSize + length > message.size()) {
+        return false;
+    }
+
+    const auto body = message.subspan(kHandshakeHeaderSize, length);
+    out.is_client = type == kClientHello;
+    if (body.size() < 2 + kRandomSize + 1) {
+        return false;
+    }
+    out.legacy_version = read_u16(body, 0);
+    out.version = out.legacy_version;
+    out.random = body.subspan(2, kRandomSize);
+
+    size_t offset = 2 + kRandomSize;
+    out.session_id = prefixed(body.subspan(offset), 1);
+    if (out.session_id.size() != body[offset]) {
+        return false;
+    }
+    offset += 1 + out.session_id.size();
+
+    if (out.is_client) {
+        if (offset + 2 > body.size()) {
+            return false;
+        }
+        const size_t cipher_length = read_u16(body, offset);
+        if ((cipher_length & 1) != 0 || offset + 2 + cipher_length > body.size()) {
+            return false;
+        }
+        out.cipher_suites = body.subspan(offset + 2, cipher_length);
+        offset += 2 + cipher_length;
+
+        if (offset + 1 > body.size() || offset + 1 + body[offset] > body.size()) {
+            return false;
+        }
+        out.compression_methods = body.subspan(offset + 1, body[offset]);
+        offset += 1 + body[offset];
+    } else {
+        if (offset + 3 > body.size()) {
+            return false;
+        }
+        out.cipher_suite = read_u16(body, offset);
+        out.compression_methods = body.subspan(offset + 2, 1);
+        offset += 3;
+    }
+
+    // Extensions are optional before TLS 1.3
+    if (offset == body.size()) {
+        return true;
+    }
+    if (offset + 2 > body.size()) {
+        return false;
+    }
+    const size_t extensions_length = read_u16(body, offset);
+    if (offset + 2 + extensions_length != body.size()) {
+        return false;
+    }
+    out.extensions = body.subspan(offset + 2, extensions_length);
+    return scan_extensions(out.extensions, out);
+}
+
+bool TLSHelloScanner::scan_record(std::span<const uint8_t> record, TLSHelloView& out) noexcept {
+    if (record.size() < kRecordHeaderSize || record[0] != kHandshakeContentType) {
+        out = TLSHelloView{};
+        return false;
+    }
+    const size_t length = read_u16(record, 3);
+    if (kRecordHeaderSize + length > record.size()) {
+        out = TLSHelloView{};
+        return false;
+    }
+    return scan_handshake(record.subspan(kRecordHeaderSize, length), out);
+}
+
+JA3Digest TLSHelloScanner::ja3(const TLSHelloView& hello) noexcept {
+    // SSLVersion,Ciphers,Extensions,EllipticCurves,EllipticCurvePointFormats
+    DigestWriter<utils::MD5> writer;
+    writer.put_decimal(hello.legacy_version);
+    writer.put(',');
+    put_u16_list(writer, hello.cipher_suites);
+    writer.put(',');
+    put_extension_types(writer, hello);
+    writer.put(',');
+    put_u16_list(writer, hello.supported_groups);
+    writer.put(',');
+    for (size_t i = 0; i < hello.ec_point_formats.size(); ++i) {
+        if (i > 0) {
+            writer.put('-');
+        }
+        writer.put_decimal(hello.ec_point_formats[i]);
+    }
+
+    const auto digest = writer.finish();
+    JA3Digest result;
+    utils::to_hex(digest, result);
+    return result;
+}
+
+JA3Digest TLSHelloScanner::ja3s(const TLSHelloView& hello) noexcept {
+    // SSLVersion,Cipher,Extensions
+    DigestWriter<utils::MD5> writer;
+    writer.put_decimal(hello.legacy_version);
+    writer.put(',');
+    writer.put_decimal(hello.cipher_suite);
+    writer.put(',');
+    put_extension_types(writer, hello);
+
+    const auto digest = writer.finish();
+    JA3Digest result;
+    utils::to_hex(digest, result);
+    return result;
+}
+
+JA4Fingerprint TLSHelloScanner::ja4(const TLSHelloView& hello, char transport) noexcept {
+    JA4Fingerprint result;
+    result.fill('0');
+
+    // Part a: transport, version, SNI, cipher count, extension count, ALPN.
+    // SNI and ALPN count towards part a but are left out of the part c hash
+    size_t extension_count = 0;
+    size_t hashed_extensions = 0;
+    std::array<uint16_t, kMaxSortedEntries> extension_types;
+    hello.for_each_extension([&](uint16_t type, std::span<const uint8_t>) {
+        if (is_grease(type)) {
+            return;
+        }
+        ++extension_count;
+        if (type != kExtServerName && type != kExtALPN && hashed_extensions < extension_types.size()) {
+            extension_types[hashed_extensions++] = type;
+        }
+    });
+
+    std::array<uint16_t, kMaxSortedEntries> ciphers;
+    const size_t cipher_count = sort_u16(hello.cipher_suites, ciphers);
+    result[0] = transport;
+    ja4_version(hello.version, &result[1]);
+    result[3] = hello.has_server_name ? 'd' : 'i';
+    two_digits(cipher_count, &result[4]);
+    two_digits(extension_count, &result[6]);
+
+    const std::string_view alpn = hello.first_alpn();
+    if (!alpn.empty()) {
+        const uint8_t first = static_cast<uint8_t>(alpn.front());
+        const uint8_t last = static_cast<uint8_t>(alpn.back());
+        if (is_alnum(first) && is_alnum(last)) {
+            result[8] = static_cast<char>(first);
+            result[9] = static_cast<char>(last);
+        } else {
+            static constexpr char kHexDigits[] = "0123456789abcdef";
+            result[8] = kHexDigits[first >> 4];
+            result[9] = kHexDigits[last & 0x0F];
+        }
+    }
+    result[10] = '_';
+    result[23] = '_';
+
+    // Part b: sorted cipher suites
+    if (cipher_count > 0) {
+        DigestWriter<utils::SHA256> writer;
+        for (size_t i = 0; i < cipher_count; ++i) {
+            if (i > 0) {
+                writer.put(',');
+            }
+            writer.put_hex16(ciphers[i]);
+        }
+        hex_prefix(writer.finish(), &result[11]);
+    }
+
+    // Part c: sorted extensions, then signature algorithms in wire order
+    if (hashed_extensions > 0) {
+        std::sort(extension_types.begin(), extension_types.begin() + hashed_extensions);
+        DigestWriter<utils::SHA256> writer;
+        for (size_t i = 0; i < hashed_extensions; ++i) {
+            if (i > 0) {
+                writer.put(',');
+            }
+            writer.put_hex16(extension_types[i]);
+        }
+        bool first = true;
+        for (size_t offset = 0; offset + 2 <= hello.signature_algorithms.size(); offset += 2) {
+            const uint16_t algorithm = read_u16(hello.signature_algorithms, offset);
+            if (is_grease(algorithm)) {
+                continue;
+            }
+            writer.put(first ? '_' : ',');
+            writer.put_hex16(algorithm);
+            first = false;
+        }
+        hex_prefix(writer.finish(), &result[24]);
+    }
+
+    return result;
+}
+
+bool TLSHelloScanner::fingerprint(std::span<const uint8_t> message, TLSFingerprints& fingerprints,
+                                  TLSHelloView* view, char transport) noexcept {
+    TLSHelloView local;
+    TLSHelloView& hello = view != nullptr ? *view : local;
+    if (!scan_handshake(message, hello)) {
+        return false;
+    }
+
+    if (hello.is_client) {
+        fingerprints.ja3 = ja3(hello);
+        fingerprints.ja4 = ja4(hello, transport);
+        fingerprints.has_client = true;
+    } else {
+        fingerprints.ja3s = ja3s(hello);
+        fingerprints.has_server = true;
+    }
+    return true;
+}
+
+} // namespace protocol_parser::parsers
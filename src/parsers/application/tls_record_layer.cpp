@@ -0,0 +1,261 @@
+#include "parsers/application/tls_record_layer.hpp"
+#include "parsers/application/tls_fingerprint.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace protocol_parser::parsers {
+
+namespace {
+    constexpr uint8_t kChangeCipherSpec = 20;
+    constexpr uint8_t kAlert = 21;
+    constexpr uint8_t kHandshake = 22;
+    constexpr uint8_t kApplicationData = 23;
+    constexpr uint8_t kHeartbeat = 24;
+
+    constexpr uint8_t kServerHello = 2;
+    constexpr uint16_t kTLS13 = 0x0304;
+
+    // ServerHello.random of a HelloRetryRequest (RFC 8446 section 4.1.3)
+    constexpr std::array<uint8_t, 32> kHelloRetryRandom = {
+        0xCF, 0x21, 0xAD, 0x74, 0xE5, 0x9A, 0x61, 0x11, 0xBE, 0x1D, 0x8C, 0x02, 0x1E, 0x65, 0xB8, 0x91,
+        0xC2, 0xA2, 0x11, 0x16, 0x7A, 0xBB, 0x8C, 0x5E, 0x07, 0x9E, 0x09, 0xE2, 0xC8, 0xA8, 0x33, 0x9C,
+    };
+
+    inline size_t handshake_length(const uint8_t* header) noexcept {
+        return (static_cast<size_t>(header[1]) << 16) | (static_cast<size_t>(header[2]) << 8) | header[3];
+    }
+
+    constexpr size_t kServerDirection = static_cast<size_t>(TLSDirection::SERVER_TO_CLIENT);
+}
+
+TLSRecordLayer::TLSRecordLayer(size_t max_handshake_size)
+    : max_handshake_size_(std::max(max_handshake_size, kHandshakeHeaderSize)) {}
+
+void TLSRecordLayer::reset() {
+    for (auto& state : directions_) {
+        state = DirectionState{};
+    }
+    stats_ = Statistics{};
+    negotiated_version_ = 0;
+    handshake_done_ = false;
+    failed_ = false;
+    error_message_.clear();
+}
+
+bool TLSRecordLayer::fail(std::string message) {
+    failed_ = true;
+    error_message_ = std::move(message);
+    return false;
+}
+
+ParseResult TLSRecordLayer::feed(TLSDirection direction, const BufferView& data) {
+    if (failed_) {
+        return ParseResult::InvalidFormat;
+    }
+
+    auto& state = directions_[static_cast<size_t>(direction)];
+    std::span<const uint8_t> input(data.data(), data.size());
+
+    try {
+        while (!input.empty()) {
+            if (state.header_bytes < kRecordHeaderSize) {
+                const size_t take = std::min(kRecordHeaderSize - state.header_bytes, input.size());
+                std::memcpy(state.header.data() + state.header_bytes, input.data(), take);
+                state.header_bytes += take;
+                input = input.subspan(take);
+                if (state.header_bytes < kRecordHeaderSize) {
+                    break;
+                }
+                if (!begin_record(state)) {
+                    return ParseResult::InvalidFormat;
+                }
+                if (state.record_remaining == 0) {
+                    end_record(direction, state);
+                }
+                continue;
+            }
+
+            const size_t take = std::min(state.record_remaining, input.size());
+            const auto chunk = input.first(take);
+            if (handshake_done_ || state.encrypted) {
+                stats_.skipped_bytes += take;
+            } else if (state.content_type == kHandshake) {
+                consume_handshake(direction, state, chunk);
+            } else if (state.content_type == kAlert) {
+                consume_alert(direction, state, chunk);
+            } else {
+                stats_.skipped_bytes += take;
+            }
+
+            state.record_remaining -= take;
+            input = input.subspan(take);
+            if (state.record_remaining == 0) {
+                end_record(direction, state);
+            }
+        }
+    } catch (const std::bad_alloc&) {
+        (void)fail("Out of memory while reassembling TLS handshake");
+        return ParseResult::InternalError;
+    }
+
+    return ParseResult::Success;
+}
+
+ParseResult TLSRecordLayer::feed(TLSDirection direction, core::TcpReassembler& reassembler) {
+    const BufferView data = reassembler.get_data();
+    if (data.empty()) {
+        return failed_ ? ParseResult::InvalidFormat : ParseResult::Success;
+    }
+    const ParseResult result = feed(direction, data);
+    reassembler.consume(data.size());
+    return result;
+}
+
+bool TLSRecordLayer::begin_record(DirectionState& state) {
+    const auto& header = state.header;
+    const uint8_t content_type = header[0];
+    const size_t length = (static_cast<size_t>(header[3]) << 8) | header[4];
+
+    if (content_type < kChangeCipherSpec || content_type > kHeartbeat) {
+        return fail("Invalid TLS record content type");
+    }
+    if (header[1] != 3 || header[2] > 4) {
+        return fail("Invalid TLS record version");
+    }
+    if (length > kMaxRecordLength) {
+        return fail("TLS record exceeds maximum length");
+    }
+
+    state.content_type = content_type;
+    state.record_remaining = length;
+    ++stats_.records;
+
+    if (content_type == kApplicationData) {
+        ++stats_.application_records;
+        // Application data means the clear-text handshake is over, unless it is client
+        // early data sent before the server has answered
+        if (stats_.handshake_messages == 0 || directions_[kServerDirection].encrypted) {
+            finish_handshake();
+        }
+    }
+    return true;
+}
+
+void TLSRecordLayer::end_record(TLSDirection direction, DirectionState& state) {
+    state.header_bytes = 0;
+
+    if (state.content_type == kChangeCipherSpec && !handshake_done_) {
+        state.change_cipher_spec = true;
+        state.encrypted = true;
+        // A handshake message cut off by the cipher change will never complete
+        state.handshake.clear();
+        state.discard_remaining = 0;
+        const auto& other = directions_[1 - static_cast<size_t>(direction)];
+        if (other.change_cipher_spec) {
+            finish_handshake();
+        }
+    }
+}
+
+void TLSRecordLayer::consume_handshake(TLSDirection direction, DirectionState& state, std::span<const uint8_t> bytes) {
+    while (!bytes.empty() && !handshake_done_ && !state.encrypted) {
+        if (state.discard_remaining > 0) {
+            const size_t take = std::min(state.discard_remaining, bytes.size());
+            state.discard_remaining -= take;
+            stats_.skipped_bytes += take;
+            bytes = bytes.subspan(take);
+            continue;
+        }
+
+        // Complete messages in the input are delivered without copying
+        if (state.handshake.empty() && bytes.size() >= kHandshakeHeaderSize) {
+            const size_t total = kHandshakeHeaderSize + handshake_length(bytes.data());
+            if (total > max_handshake_size_) {
+                ++stats_.oversized_messages;
+                state.discard_remaining = total;
+                continue;
+            }
+            if (total <= bytes.size()) {
+                deliver_handshake(direction, bytes.first(total));
+                bytes = bytes.subspan(total);
+                continue;
+            }
+        }
+
+        // Buffer one message at a time: header first, then exactly its body
+        auto& buffer = state.handshake;
+        const size_t needed = buffer.size() < kHandshakeHeaderSize
+            ? kHandshakeHeaderSize - buffer.size()
+            : kHandshakeHeaderSize + handshake_length(buffer.data()) - buffer.size();
+        const size_t take = std::min(needed, bytes.size());
+        buffer.insert(buffer.end(), bytes.begin(), bytes.begin() + take);
+        bytes = bytes.subspan(take);
+
+        if (buffer.size() < kHandshakeHeaderSize) {
+            continue;
+        }
+        const size_t total = kHandshakeHeaderSize + handshake_length(buffer.data());
+        if (total > max_handshake_size_) {
+            ++stats_.oversized_messages;
+            state.discard_remaining = total - buffer.size();
+            stats_.skipped_bytes += buffer.size();
+            buffer.clear();
+        } else if (buffer.size() == total) {
+            ++stats_.reassembled_messages;
+            deliver_handshake(direction, buffer);
+            buffer.clear();
+        }
+    }
+}
+
+void TLSRecordLayer::consume_alert(TLSDirection direction, DirectionState& state, std::span<const uint8_t> bytes) {
+    for (const uint8_t byte : bytes) {
+        state.alert[state.alert_bytes++] = byte;
+        if (state.alert_bytes == state.alert.size()) {
+            state.alert_bytes = 0;
+            if (handlers_.on_alert) {
+                handlers_.on_alert(direction, state.alert[0], state.alert[1]);
+            }
+        }
+    }
+}
+
+void TLSRecordLayer::deliver_handshake(TLSDirection direction, std::span<const uint8_t> message) {
+    ++stats_.handshake_messages;
+    if (handlers_.on_handshake) {
+        handlers_.on_handshake(direction, message);
+    }
+
+    if (message[0] != kServerHello || direction != TLSDirection::SERVER_TO_CLIENT) {
+        return;
+    }
+    TLSHelloView hello;
+    if (!TLSHelloScanner::scan_handshake(message, hello)) {
+        return;
+    }
+    negotiated_version_ = hello.version;
+
+    // TLS 1.3 encrypts everything after ServerHello; a HelloRetryRequest is followed
+    // by a second clear-text ClientHello
+    const bool retry = std::equal(kHelloRetryRandom.begin(), kHelloRetryRandom.end(), hello.random.begin());
+    if (hello.version == kTLS13 && !retry) {
+        directions_[kServerDirection].encrypted = true;
+        finish_handshake();
+    }
+}
+
+void TLSRecordLayer::finish_handshake() {
+    if (handshake_done_) {
+        return;
+    }
+    handshake_done_ = true;
+    for (auto& state : directions_) {
+        std::vector<uint8_t>().swap(state.handshake);
+        state.discard_remaining = 0;
+    }
+    if (handlers_.on_handshake_done) {
+        handlers_.on_handshake_done(negotiated_version_);
+    }
+}
+
+} // namespace protocol_parser::parsers
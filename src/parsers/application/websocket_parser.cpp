@@ -5,12 +5,6 @@
 #include <cstring>
 #include <regex>
 
-#ifdef _WIN32
-#include <winsock2.h>
-#else
-#include <arpa/inet.h>
-#endif
-
 // 简化的SHA1和Base64实现（生产环境应使用标准库）
 namespace {
     // Base64编码表
@@ -57,7 +51,11 @@ WebSocketParser::WebSocketParser() : BaseParser() {
 }
 
 ParseResult WebSocketParser::parse(ParseContext& context) noexcept {
-    const auto& buffer = context.buffer;
+    if (context.offset > context.buffer.size()) {
+        return ParseResult::InvalidFormat;
+    }
+    // 从 context.offset 开始，成功后前移到帧末尾，同一缓冲区中的连续帧可逐个解析
+    const auto buffer = context.buffer.substr(context.offset);
     
     if (buffer.size() < 2) {
         return ParseResult::NeedMoreData;
@@ -76,8 +74,9 @@ ParseResult WebSocketParser::parse(ParseContext& context) noexcept {
             return result;
         } else if (is_websocket_frame(buffer)) {
             message.is_handshake = false;
-            auto result = parse_frame(buffer, message.frame);
+            auto result = parse_frame(buffer, frame_);
             if (result == ParseResult::Success) {
+                context.offset += frame_.header.header_length + static_cast<size_t>(frame_.header.payload_length);
                 collect_statistics(message);
             }
             return result;
@@ -107,6 +106,25 @@ bool WebSocketParser::can_parse(const BufferView& buffer) const noexcept {
 
 void WebSocketParser::reset() noexcept {
     // 重置解析器状态
+    frame_ = WebSocketFrame{};
+    reset_message();
+    message_ = WebSocketMessageChain{};
+    unmask_buffer_.clear();
+    message_arena_.clear();
+}
+
+void WebSocketParser::reset_message() noexcept {
+    message_in_progress_ = false;
+    pending_fragments_.clear();
+    utf8_validator_.reset();
+}
+
+void WebSocketMessageChain::copy_to(std::vector<uint8_t>& out) const {
+    out.clear();
+    out.reserve(size);
+    for (const auto& fragment : fragments) {
+        out.insert(out.end(), fragment.data(), fragment.data() + fragment.size());
+    }
 }
 
 bool WebSocketParser::is_websocket_handshake(const protocol_parser::core::BufferView& buffer) const {
@@ -114,11 +132,12 @@ bool WebSocketParser::is_websocket_handshake(const protocol_parser::core::Buffer
         return false;
     }
     
-    std::string data(reinterpret_cast<const char*>(buffer.data()), 
-                    std::min(buffer.size(), static_cast<size_t>(200)));
+    // 每个数据帧都会先经过这里，只看前 200 字节且不拷贝
+    const std::string_view data(reinterpret_cast<const char*>(buffer.data()), 
+                                std::min(buffer.size(), static_cast<size_t>(200)));
     
     // 检查HTTP升级请求特征
-    return (data.find("GET ") == 0 || data.find("HTTP/1.1 101") == 0) &&
+    return (data.starts_with("GET ") || data.starts_with("HTTP/1.1 101")) &&
            (data.find("Upgrade: websocket") != std::string::npos ||
             data.find("upgrade: websocket") != std::string::npos ||
             data.find("Connection: Upgrade") != std::string::npos ||
@@ -199,7 +218,26 @@ ParseResult WebSocketParser::parse_handshake(const protocol_parser::core::Buffer
 }
 
 ParseResult WebSocketParser::parse_frame(const protocol_parser::core::BufferView& buffer, 
-                                        WebSocketFrame& frame) const {
+                                        WebSocketFrame& frame) {
+    return decode_frame(buffer, nullptr, frame);
+}
+
+ParseResult WebSocketParser::parse_frame_in_place(std::span<uint8_t> buffer, WebSocketFrame& frame) {
+    return decode_frame(BufferView(buffer.data(), buffer.size()), buffer.data(), frame);
+}
+
+ParseResult WebSocketParser::decode_frame(const protocol_parser::core::BufferView& buffer,
+                                         uint8_t* writable,
+                                         WebSocketFrame& frame) {
+    frame = WebSocketFrame{};
+    if (message_.complete) {
+        message_ = WebSocketMessageChain{};
+    }
+    if (!message_in_progress_) {
+        message_arena_.clear();   // 只被未完成的消息和上一次的结果引用
+    }
+    arena_offset_ = SIZE_MAX;
+
     if (buffer.size() < 2) {
         return ParseResult::NeedMoreData;
     }
@@ -210,43 +248,57 @@ ParseResult WebSocketParser::parse_frame(const protocol_parser::core::BufferView
         return result;
     }
     
+    // 超限的长度直接拒绝，不等待数据
+    if (frame.header.payload_length > MAX_FRAME_SIZE) {
+        return ParseResult::InvalidFormat;
+    }
+
     // 检查数据是否足够
-    size_t total_length = frame.header.header_length + frame.header.payload_length;
-    if (buffer.size() < total_length) {
+    const size_t payload_length = static_cast<size_t>(frame.header.payload_length);
+    if (buffer.size() - frame.header.header_length < payload_length) {
         return ParseResult::NeedMoreData;
     }
     
-    // 提取载荷数据
-    if (frame.header.payload_length > 0) {
-        frame.payload.resize(frame.header.payload_length);
-        memcpy(frame.payload.data(), 
-               buffer.data() + frame.header.header_length, 
-               frame.header.payload_length);
-        
-        // 应用掩码（如果存在）
-        if (frame.header.mask) {
-            apply_mask(frame.payload, frame.header.masking_key);
+    // 载荷：未掩码时直接引用输入；有掩码时一次异或写入目标缓冲区
+    const uint8_t* source = buffer.data() + frame.header.header_length;
+    if (!frame.header.mask || payload_length == 0) {
+        frame.payload = BufferView(source, payload_length);
+    } else {
+        uint8_t* target;
+        const auto opcode = frame.header.opcode;
+        if (writable != nullptr) {
+            target = writable + frame.header.header_length;
+        } else if (opcode == WebSocketOpcode::CONTINUATION ||
+                   (is_data_frame(opcode) && !frame.header.fin)) {
+            // 分片消息的分片写入消息缓冲区，消息完成时再转为视图（缓冲区可能扩容）
+            arena_offset_ = message_arena_.size();
+            message_arena_.resize(arena_offset_ + payload_length);
+            target = message_arena_.data() + arena_offset_;
+        } else {
+            if (unmask_buffer_.size() < payload_length) {
+                unmask_buffer_.resize(payload_length);
+            }
+            target = unmask_buffer_.data();
         }
+        protocol_parser::utils::SIMDUtils::xor_mask(target, source, payload_length, frame.header.masking_key);
+        frame.payload = BufferView(target, payload_length);
     }
     
     // 处理特定帧类型
     switch (frame.header.opcode) {
         case WebSocketOpcode::TEXT:
-            if (!is_valid_utf8(frame.payload)) {
-                return ParseResult::InvalidFormat;
-            }
-            frame.text_data = std::string(frame.payload.begin(), frame.payload.end());
+            frame.text_data = frame.payload.as_string_view();
             break;
             
         case WebSocketOpcode::CLOSE:
             if (frame.payload.size() >= 2) {
-                frame.close_code = static_cast<WebSocketCloseCode>(
-                    ntohs(*reinterpret_cast<const uint16_t*>(frame.payload.data())));
+                frame.close_code = static_cast<WebSocketCloseCode>(frame.payload.read_be16(0));
                 if (frame.payload.size() > 2) {
-                    frame.close_reason = std::string(frame.payload.begin() + 2, frame.payload.end());
-                    if (!is_valid_utf8(std::vector<uint8_t>(frame.payload.begin() + 2, frame.payload.end()))) {
+                    const auto reason = frame.payload.substr(2);
+                    if (!is_valid_utf8(reason.as_span())) {
                         return ParseResult::InvalidFormat;
                     }
+                    frame.close_reason.assign(reason.as_string_view());
                 }
             }
             break;
@@ -259,66 +311,92 @@ ParseResult WebSocketParser::parse_frame(const protocol_parser::core::BufferView
     if (!validate_frame(frame)) {
         return ParseResult::InvalidFormat;
     }
+
+    if (is_data_frame(frame.header.opcode)) {
+        result = reassemble(frame);
+        if (result != ParseResult::Success) {
+            return result;
+        }
+    }
     
     frame.is_valid = true;
     return ParseResult::Success;
 }
 
+ParseResult WebSocketParser::reassemble(const WebSocketFrame& frame) {
+    const auto opcode = frame.header.opcode;
+    const bool text = opcode == WebSocketOpcode::TEXT ||
+                      (opcode == WebSocketOpcode::CONTINUATION && message_.opcode == WebSocketOpcode::TEXT);
+
+    if (opcode == WebSocketOpcode::CONTINUATION) {
+        if (!message_in_progress_) {
+            return ParseResult::InvalidFormat;   // 没有起始帧的继续帧
+        }
+    } else {
+        if (message_in_progress_) {
+            // 上一条消息尚未结束就开始新消息（RFC 6455 5.4）
+            reset_message();
+            return ParseResult::InvalidFormat;
+        }
+        message_ = WebSocketMessageChain{};
+        message_.opcode = opcode;
+
+        if (frame.header.fin) {
+            // 未分片：整帧校验，链中只有一段
+            if (text && !is_valid_utf8(frame.payload.as_span())) {
+                return ParseResult::InvalidFormat;
+            }
+            message_.fragments.push_back(frame.payload);
+            message_.size = frame.payload.size();
+            message_.complete = true;
+            return ParseResult::Success;
+        }
+        message_in_progress_ = true;
+    }
+
+    // 分片：码点可能跨分片，流式校验
+    if (message_.size + frame.payload.size() > MAX_MESSAGE_SIZE ||
+        (text && !utf8_validator_.update(frame.payload.data(), frame.payload.size()))) {
+        reset_message();
+        return ParseResult::InvalidFormat;
+    }
+    pending_fragments_.push_back(PendingFragment{
+        arena_offset_ == SIZE_MAX ? frame.payload : BufferView{}, arena_offset_, frame.payload.size()});
+    message_.size += frame.payload.size();
+
+    if (!frame.header.fin) {
+        return ParseResult::Success;
+    }
+
+    if (text && !utf8_validator_.finish()) {
+        reset_message();
+        return ParseResult::InvalidFormat;
+    }
+    message_.fragments.reserve(pending_fragments_.size());
+    for (const auto& fragment : pending_fragments_) {
+        if (fragment.arena_offset == SIZE_MAX) {
+            message_.fragments.push_back(fragment.view);
+        } else {
+            message_.fragments.emplace_back(message_arena_.data() + fragment.arena_offset, fragment.size);
+        }
+    }
+    message_.complete = true;
+    reset_message();
+    return ParseResult::Success;
+}
+
 std::string WebSocketParser::calculate_accept_key(const std::string& key) const {
     std::string combined = key + WEBSOCKET_GUID;
     auto hash = simple_sha1(combined);
     return base64_encode(hash);
 }
 
-void WebSocketParser::apply_mask(std::vector<uint8_t>& data, uint32_t mask) const {
-    uint8_t mask_bytes[4];
-    mask_bytes[0] = (mask >> 24) & 0xFF;
-    mask_bytes[1] = (mask >> 16) & 0xFF;
-    mask_bytes[2] = (mask >> 8) & 0xFF;
-    mask_bytes[3] = mask & 0xFF;
-    
-    for (size_t i = 0; i < data.size(); ++i) {
-        data[i] ^= mask_bytes[i % 4];
-    }
+void WebSocketParser::apply_mask(std::span<uint8_t> data, uint32_t mask) const {
+    protocol_parser::utils::SIMDUtils::xor_mask(data.data(), data.data(), data.size(), mask);
 }
 
-bool WebSocketParser::is_valid_utf8(const std::vector<uint8_t>& data) const {
-    // 简化的UTF-8验证
-    size_t i = 0;
-    while (i < data.size()) {
-        uint8_t byte = data[i];
-        
-        if (byte < 0x80) {
-            // ASCII字符
-            i++;
-        } else if ((byte & 0xE0) == 0xC0) {
-            // 2字节序列
-            if (i + 1 >= data.size() || (data[i + 1] & 0xC0) != 0x80) {
-                return false;
-            }
-            i += 2;
-        } else if ((byte & 0xF0) == 0xE0) {
-            // 3字节序列
-            if (i + 2 >= data.size() || 
-                (data[i + 1] & 0xC0) != 0x80 || 
-                (data[i + 2] & 0xC0) != 0x80) {
-                return false;
-            }
-            i += 3;
-        } else if ((byte & 0xF8) == 0xF0) {
-            // 4字节序列
-            if (i + 3 >= data.size() || 
-                (data[i + 1] & 0xC0) != 0x80 || 
-                (data[i + 2] & 0xC0) != 0x80 || 
-                (data[i + 3] & 0xC0) != 0x80) {
-                return false;
-            }
-            i += 4;
-        } else {
-            return false;
-        }
-    }
-    return true;
+bool WebSocketParser::is_valid_utf8(std::span<const uint8_t> data) const {
+    return protocol_parser::utils::SIMDUtils::validate_utf8(data.data(), data.size());
 }
 
 std::vector<WebSocketExtension> WebSocketParser::parse_extensions(const std::string& extension_header) const {
@@ -391,7 +469,7 @@ bool WebSocketParser::validate_frame(const WebSocketFrame& frame) const {
             return false; // 关闭码必须是2字节
         }
         if (frame.payload.size() >= 2) {
-            uint16_t code = ntohs(*reinterpret_cast<const uint16_t*>(frame.payload.data()));
+            uint16_t code = frame.payload.read_be16(0);
             // 检查关闭码是否有效
             if (code < 1000 || (code >= 1004 && code <= 1006) || 
                 (code >= 1012 && code <= 1014) || code == 1100) {
@@ -531,18 +609,16 @@ ParseResult WebSocketParser::parse_frame_header(const protocol_parser::core::Buf
     uint8_t payload_len = second_byte & 0x7F;
     
     // 解析载荷长度
-    size_t length_bytes = parse_payload_length(buffer, offset, header.payload_length);
-    if (length_bytes == 0) {
+    if (!parse_payload_length(buffer, offset, header.payload_length)) {
         return ParseResult::NeedMoreData;
     }
-    offset += length_bytes;
     
-    // 如果有掩码，读取掩码键
+    // 如果有掩码，读取掩码键（按线路顺序，最高字节为第一个掩码字节）
     if (header.mask) {
         if (offset + 4 > buffer.size()) {
             return ParseResult::NeedMoreData;
         }
-        header.masking_key = *reinterpret_cast<const uint32_t*>(buffer.data() + offset);
+        header.masking_key = buffer.read_be32(offset);
         offset += 4;
     }
     
@@ -550,32 +626,27 @@ ParseResult WebSocketParser::parse_frame_header(const protocol_parser::core::Buf
     return ParseResult::Success;
 }
 
-size_t WebSocketParser::parse_payload_length(const protocol_parser::core::BufferView& buffer, 
-                                            size_t offset, uint64_t& length) const {
-    if (offset >= buffer.size()) {
-        return 0;
-    }
-    
+bool WebSocketParser::parse_payload_length(const protocol_parser::core::BufferView& buffer, 
+                                          size_t& offset, uint64_t& length) const {
     uint8_t initial_length = buffer[offset - 1] & 0x7F;
     
     if (initial_length < 126) {
         length = initial_length;
-        return 0;
+        return true;
     } else if (initial_length == 126) {
         if (offset + 2 > buffer.size()) {
-            return 0;
+            return false;
         }
-        length = ntohs(*reinterpret_cast<const uint16_t*>(buffer.data() + offset));
-        return 2;
+        length = buffer.read_be16(offset);
+        offset += 2;
+        return true;
     } else { // initial_length == 127
         if (offset + 8 > buffer.size()) {
-            return 0;
+            return false;
         }
-#ifndef be64toh
-#define be64toh(x) _byteswap_uint64(x)
-#endif
-        length = be64toh(*reinterpret_cast<const uint64_t*>(buffer.data() + offset));
-        return 8;
+        length = buffer.read_be64(offset);
+        offset += 8;
+        return true;
     }
 }
 
@@ -0,0 +1,553 @@
+#include "parsers/application/x509_certificate.hpp"
+#include <algorithm>
+#include <bit>
+#include <mutex>
+
+namespace protocol_parser::parsers {
+
+namespace {
+    using OID = std::span<const uint8_t>;
+
+    struct NamedOID {
+        std::span<const uint8_t> oid;
+        std::string_view name;
+    };
+
+    constexpr uint8_t kSHA1WithRSA[] = {0x2A, 0x86, 0x48, 0x86, 0xF7, 0x0D, 0x01, 0x01, 0x05};
+    constexpr uint8_t kSHA256WithRSA[] = {0x2A, 0x86, 0x48, 0x86, 0xF7, 0x0D, 0x01, 0x01, 0x0B};
+    constexpr uint8_t kSHA384WithRSA[] = {0x2A, 0x86, 0x48, 0x86, 0xF7, 0x0D, 0x01, 0x01, 0x0C};
+    constexpr uint8_t kSHA512WithRSA[] = {0x2A, 0x86, 0x48, 0x86, 0xF7, 0x0D, 0x01, 0x01, 0x0D};
+    constexpr uint8_t kMD5WithRSA[] = {0x2A, 0x86, 0x48, 0x86, 0xF7, 0x0D, 0x01, 0x01, 0x04};
+    constexpr uint8_t kRSAPSS[] = {0x2A, 0x86, 0x48, 0x86, 0xF7, 0x0D, 0x01, 0x01, 0x0A};
+    constexpr uint8_t kECDSAWithSHA1[] = {0x2A, 0x86, 0x48, 0xCE, 0x3D, 0x04, 0x01};
+    constexpr uint8_t kECDSAWithSHA256[] = {0x2A, 0x86, 0x48, 0xCE, 0x3D, 0x04, 0x03, 0x02};
+    constexpr uint8_t kECDSAWithSHA384[] = {0x2A, 0x86, 0x48, 0xCE, 0x3D, 0x04, 0x03, 0x03};
+    constexpr uint8_t kECDSAWithSHA512[] = {0x2A, 0x86, 0x48, 0xCE, 0x3D, 0x04, 0x03, 0x04};
+    constexpr uint8_t kEd25519[] = {0x2B, 0x65, 0x70};
+    constexpr uint8_t kEd448[] = {0x2B, 0x65, 0x71};
+
+    constexpr uint8_t kRSAEncryption[] = {0x2A, 0x86, 0x48, 0x86, 0xF7, 0x0D, 0x01, 0x01, 0x01};
+    constexpr uint8_t kECPublicKey[] = {0x2A, 0x86, 0x48, 0xCE, 0x3D, 0x02, 0x01};
+    constexpr uint8_t kDSA[] = {0x2A, 0x86, 0x48, 0xCE, 0x38, 0x04, 0x01};
+
+    constexpr uint8_t kP256[] = {0x2A, 0x86, 0x48, 0xCE, 0x3D, 0x03, 0x01, 0x07};
+    constexpr uint8_t kP384[] = {0x2B, 0x81, 0x04, 0x00, 0x22};
+    constexpr uint8_t kP521[] = {0x2B, 0x81, 0x04, 0x00, 0x23};
+    constexpr uint8_t kSecp256k1[] = {0x2B, 0x81, 0x04, 0x00, 0x0A};
+
+    constexpr NamedOID kSignatureAlgorithms[] = {
+        {kSHA256WithRSA, "sha256WithRSAEncryption"},
+        {kECDSAWithSHA256, "ecdsa-with-SHA256"},
+        {kECDSAWithSHA384, "ecdsa-with-SHA384"},
+        {kSHA384WithRSA, "sha384WithRSAEncryption"},
+        {kSHA512WithRSA, "sha512WithRSAEncryption"},
+        {kRSAPSS, "rsassa-pss"},
+        {kEd25519, "ed25519"},
+        {kEd448, "ed448"},
+        {kECDSAWithSHA512, "ecdsa-with-SHA512"},
+        {kSHA1WithRSA, "sha1WithRSAEncryption"},
+        {kECDSAWithSHA1, "ecdsa-with-SHA1"},
+        {kMD5WithRSA, "md5WithRSAEncryption"},
+    };
+
+    // Short names used by format_name, in X.520 OID order (2.5.4.x)
+    constexpr uint8_t kAttributeCountry[] = {0x55, 0x04, 0x06};
+    constexpr uint8_t kAttributeLocality[] = {0x55, 0x04, 0x07};
+    constexpr uint8_t kAttributeState[] = {0x55, 0x04, 0x08};
+    constexpr uint8_t kAttributeOrganizationalUnit[] = {0x55, 0x04, 0x0B};
+
+    constexpr NamedOID kNameAttributes[] = {
+        {X509CertificateView::kCommonName, "CN"},
+        {X509CertificateView::kOrganization, "O"},
+        {kAttributeOrganizationalUnit, "OU"},
+        {kAttributeCountry, "C"},
+        {kAttributeState, "ST"},
+        {kAttributeLocality, "L"},
+    };
+
+    inline bool same(OID a, OID b) noexcept {
+        return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+    }
+
+    // Bits of an unsigned big-endian INTEGER
+    uint32_t integer_bits(std::span<const uint8_t> value) noexcept {
+        while (!value.empty() && value.front() == 0) {
+            value = value.subspan(1);
+        }
+        if (value.empty()) {
+            return 0;
+        }
+        return static_cast<uint32_t>((value.size() - 1) * 8 + std::bit_width(value.front()));
+    }
+
+    inline bool read_digits(std::string_view text, size_t offset, size_t count, int& out) noexcept {
+        if (offset + count > text.size()) {
+            return false;
+        }
+        out = 0;
+        for (size_t i = 0; i < count; ++i) {
+            const char c = text[offset + i];
+            if (c < '0' || c > '9') {
+                return false;
+            }
+            out = out * 10 + (c - '0');
+        }
+        return true;
+    }
+
+    // Days since 1970-01-01 of a proleptic Gregorian date
+    int64_t days_from_civil(int year, int month, int day) noexcept {
+        year -= month <= 2;
+        const int64_t era = (year >= 0 ? year : year - 399) / 400;
+        const int64_t year_of_era = year - era * 400;
+        const int64_t day_of_year = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+        const int64_t day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+        return era * 146097 + day_of_era - 719468;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// DERReader
+// ---------------------------------------------------------------------------
+
+bool DERReader::read(std::span<const uint8_t>& input, DERElement& out) noexcept {
+    if (input.size() < 2 || (input[0] & 0x1F) == 0x1F) {
+        return false;   // Multi-octet tags do not occur in certificates
+    }
+
+    size_t header = 2;
+    size_t length = input[1];
+    if (length & 0x80) {
+        const size_t octets = length & 0x7F;
+        if (octets == 0 || octets > 4 || input.size() < 2 + octets) {
+            return false;   // Indefinite length is not DER
+        }
+        length = 0;
+        for (size_t i = 0; i < octets; ++i) {
+            length = (length << 8) | input[2 + i];
+        }
+        header += octets;
+    }
+    if (length > input.size() - header) {
+        return false;
+    }
+
+    out.tag = input[0];
+    out.value = input.subspan(header, length);
+    out.encoded = input.first(header + length);
+    input = input.subspan(header + length);
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// X509CertificateView
+// ---------------------------------------------------------------------------
+
+bool X509CertificateView::parse(std::span<const uint8_t> der) noexcept {
+    *this = X509CertificateView{};
+
+    auto input = der;
+    DERElement certificate;
+    if (!DERReader::expect(input, DERReader::kSequence, certificate)) {
+        return false;
+    }
+    der_ = certificate.encoded;
+
+    // Certificate ::= SEQUENCE { tbsCertificate, signatureAlgorithm, signatureValue }
+    auto body = certificate.value;
+    DERElement tbs, signature_algorithm, signature_oid, signature;
+    if (!DERReader::expect(body, DERReader::kSequence, tbs) ||
+        !DERReader::expect(body, DERReader::kSequence, signature_algorithm) ||
+        !DERReader::expect(body, DERReader::kBitString, signature)) {
+        return false;
+    }
+    auto algorithm = signature_algorithm.value;
+    if (!DERReader::expect(algorithm, DERReader::kOID, signature_oid)) {
+        return false;
+    }
+    tbs_ = tbs.encoded;
+    signature_oid_ = signature_oid.value;
+
+    // TBSCertificate: [0] version, serial, signature, issuer, validity, subject, spki, [1] [2] [3] ...
+    auto fields = tbs.value;
+    DERElement element;
+    if (!DERReader::read(fields, element)) {
+        return false;
+    }
+    version_ = 1;
+    if (element.tag == 0xA0) {
+        auto explicit_version = element.value;
+        DERElement version;
+        if (!DERReader::expect(explicit_version, DERReader::kInteger, version) || version.value.size() != 1) {
+            return false;
+        }
+        version_ = static_cast<uint8_t>(version.value[0] + 1);
+        if (!DERReader::read(fields, element)) {
+            return false;
+        }
+    }
+    if (element.tag != DERReader::kInteger) {
+        return false;
+    }
+    serial_ = element.value;
+
+    DERElement inner_signature, issuer, validity, subject, spki;
+    if (!DERReader::expect(fields, DERReader::kSequence, inner_signature) ||
+        !DERReader::expect(fields, DERReader::kSequence, issuer) ||
+        !DERReader::expect(fields, DERReader::kSequence, validity) ||
+        !DERReader::expect(fields, DERReader::kSequence, subject) ||
+        !DERReader::expect(fields, DERReader::kSequence, spki)) {
+        return false;
+    }
+    issuer_ = issuer.encoded;
+    subject_ = subject.encoded;
+
+    auto times = validity.value;
+    if (!DERReader::read(times, not_before_) || !DERReader::read(times, not_after_)) {
+        return false;
+    }
+
+    // SubjectPublicKeyInfo ::= SEQUENCE { AlgorithmIdentifier, BIT STRING }
+    auto key_info = spki.value;
+    DERElement key_algorithm, key_oid, public_key;
+    if (!DERReader::expect(key_info, DERReader::kSequence, key_algorithm) ||
+        !DERReader::expect(key_info, DERReader::kBitString, public_key) || public_key.value.empty()) {
+        return false;
+    }
+    auto key_algorithm_fields = key_algorithm.value;
+    if (!DERReader::expect(key_algorithm_fields, DERReader::kOID, key_oid)) {
+        return false;
+    }
+    key_oid_ = key_oid.value;
+    key_parameters_ = key_algorithm_fields;
+    public_key_ = public_key.value.subspan(1);
+
+    while (!fields.empty()) {
+        if (!DERReader::read(fields, element)) {
+            return false;
+        }
+        if (element.tag == 0xA3) {
+            auto explicit_extensions = element.value;
+            DERElement extensions;
+            if (!DERReader::expect(explicit_extensions, DERReader::kSequence, extensions)) {
+                return false;
+            }
+            extensions_ = extensions.value;
+        }
+    }
+
+    valid_ = true;
+    return true;
+}
+
+std::string_view X509CertificateView::signature_algorithm() const noexcept {
+    for (const auto& entry : kSignatureAlgorithms) {
+        if (same(entry.oid, signature_oid_)) {
+            return entry.name;
+        }
+    }
+    return signature_oid_.empty() ? std::string_view{} : std::string_view("unknown");
+}
+
+X509KeyType X509CertificateView::key_type() const noexcept {
+    if (same(key_oid_, kRSAEncryption)) return X509KeyType::RSA;
+    if (same(key_oid_, kECPublicKey)) return X509KeyType::EC;
+    if (same(key_oid_, kRSAPSS)) return X509KeyType::RSA_PSS;
+    if (same(key_oid_, kEd25519)) return X509KeyType::ED25519;
+    if (same(key_oid_, kEd448)) return X509KeyType::ED448;
+    if (same(key_oid_, kDSA)) return X509KeyType::DSA;
+    return X509KeyType::UNKNOWN;
+}
+
+std::string_view X509CertificateView::key_type_name(X509KeyType type) noexcept {
+    switch (type) {
+        case X509KeyType::RSA: return "RSA";
+        case X509KeyType::RSA_PSS: return "RSA-PSS";
+        case X509KeyType::EC: return "EC";
+        case X509KeyType::ED25519: return "Ed25519";
+        case X509KeyType::ED448: return "Ed448";
+        case X509KeyType::DSA: return "DSA";
+        default: return "Unknown";
+    }
+}
+
+uint32_t X509CertificateView::key_bits() const noexcept {
+    switch (key_type()) {
+        case X509KeyType::RSA:
+        case X509KeyType::RSA_PSS: {
+            // RSAPublicKey ::= SEQUENCE { modulus INTEGER, publicExponent INTEGER }
+            auto input = public_key_;
+            DERElement key, modulus;
+            if (!DERReader::expect(input, DERReader::kSequence, key)) {
+                return 0;
+            }
+            auto numbers = key.value;
+            return DERReader::expect(numbers, DERReader::kInteger, modulus) ? integer_bits(modulus.value) : 0;
+        }
+        case X509KeyType::EC: {
+            auto input = key_parameters_;
+            DERElement curve;
+            if (DERReader::expect(input, DERReader::kOID, curve)) {
+                if (same(curve.value, kP256) || same(curve.value, kSecp256k1)) return 256;
+                if (same(curve.value, kP384)) return 384;
+                if (same(curve.value, kP521)) return 521;
+            }
+            // Unknown curve: size of an uncompressed point's coordinate
+            return public_key_.size() > 1 && public_key_[0] == 0x04
+                ? static_cast<uint32_t>((public_key_.size() - 1) / 2 * 8) : 0;
+        }
+        case X509KeyType::ED25519:
+            return 256;
+        case X509KeyType::ED448:
+            return 456;
+        case X509KeyType::DSA: {
+            // Dss-Parms ::= SEQUENCE { p, q, g }
+            auto input = key_parameters_;
+            DERElement parameters, prime;
+            if (!DERReader::expect(input, DERReader::kSequence, parameters)) {
+                return 0;
+            }
+            auto numbers = parameters.value;
+            return DERReader::expect(numbers, DERReader::kInteger, prime) ? integer_bits(prime.value) : 0;
+        }
+        default:
+            return 0;
+    }
+}
+
+std::string_view X509CertificateView::name_attribute(std::span<const uint8_t> name, std::span<const uint8_t> oid) noexcept {
+    // Name ::= SEQUENCE OF SET OF SEQUENCE { type OID, value ANY }
+    auto input = name;
+    DERElement sequence;
+    if (!DERReader::expect(input, DERReader::kSequence, sequence)) {
+        return {};
+    }
+    auto sets = sequence.value;
+    DERElement set;
+    while (DERReader::expect(sets, DERReader::kSet, set)) {
+        auto attributes = set.value;
+        DERElement attribute;
+        while (DERReader::expect(attributes, DERReader::kSequence, attribute)) {
+            auto pair = attribute.value;
+            DERElement type, value;
+            if (DERReader::expect(pair, DERReader::kOID, type) && DERReader::read(pair, value) && same(type.value, oid)) {
+                return as_text(value.value);
+            }
+        }
+    }
+    return {};
+}
+
+size_t X509CertificateView::format_name(std::span<const uint8_t> name, std::span<char> out) noexcept {
+    size_t written = 0;
+    const auto append = [&](std::string_view text) {
+        const size_t take = std::min(text.size(), out.size() - written);
+        std::copy_n(text.data(), take, out.data() + written);
+        written += take;
+    };
+
+    auto input = name;
+    DERElement sequence;
+    if (!DERReader::expect(input, DERReader::kSequence, sequence)) {
+        return 0;
+    }
+    auto sets = sequence.value;
+    DERElement set;
+    while (DERReader::expect(sets, DERReader::kSet, set)) {
+        auto attributes = set.value;
+        DERElement attribute;
+        while (DERReader::expect(attributes, DERReader::kSequence, attribute)) {
+            auto pair = attribute.value;
+            DERElement type, value;
+            if (!DERReader::expect(pair, DERReader::kOID, type) || !DERReader::read(pair, value)) {
+                continue;
+            }
+            for (const auto& known : kNameAttributes) {
+                if (same(known.oid, type.value)) {
+                    if (written > 0) {
+                        append(", ");
+                    }
+                    append(known.name);
+                    append("=");
+                    append(as_text(value.value));
+                    break;
+                }
+            }
+        }
+    }
+    return written;
+}
+
+std::span<const uint8_t> X509CertificateView::find_extension(std::span<const uint8_t> oid) const noexcept {
+    // Extension ::= SEQUENCE { extnID OID, critical BOOLEAN DEFAULT FALSE, extnValue OCTET STRING }
+    auto input = extensions_;
+    DERElement extension;
+    while (DERReader::expect(input, DERReader::kSequence, extension)) {
+        auto fields = extension.value;
+        DERElement id, element;
+        if (!DERReader::expect(fields, DERReader::kOID, id) || !same(id.value, oid)) {
+            continue;
+        }
+        if (!DERReader::read(fields, element)) {
+            return {};
+        }
+        if (element.tag == DERReader::kBoolean && !DERReader::read(fields, element)) {
+            return {};
+        }
+        return element.tag == DERReader::kOctetString ? element.value : std::span<const uint8_t>{};
+    }
+    return {};
+}
+
+bool X509CertificateView::is_ca() const noexcept {
+    // BasicConstraints ::= SEQUENCE { cA BOOLEAN DEFAULT FALSE, pathLenConstraint INTEGER OPTIONAL }
+    auto input = find_extension(kBasicConstraints);
+    DERElement constraints, ca;
+    if (!DERReader::expect(input, DERReader::kSequence, constraints)) {
+        return false;
+    }
+    auto fields = constraints.value;
+    return DERReader::expect(fields, DERReader::kBoolean, ca) && ca.value.size() == 1 && ca.value[0] != 0;
+}
+
+int64_t X509CertificateView::parse_time(const DERElement& time) noexcept {
+    // UTCTime YYMMDDHHMMSSZ, GeneralizedTime YYYYMMDDHHMMSSZ (RFC 5280 4.1.2.5)
+    const std::string_view text = as_text(time.value);
+    int year = 0;
+    size_t offset = 0;
+    if (time.tag == DERReader::kUTCTime) {
+        if (!read_digits(text, 0, 2, year)) {
+            return 0;
+        }
+        year += year < 50 ? 2000 : 1900;
+        offset = 2;
+    } else if (time.tag == DERReader::kGeneralizedTime) {
+        if (!read_digits(text, 0, 4, year)) {
+            return 0;
+        }
+        offset = 4;
+    } else {
+        return 0;
+    }
+
+    int month = 0, day = 0, hour = 0, minute = 0, second = 0;
+    if (!read_digits(text, offset, 2, month) || !read_digits(text, offset + 2, 2, day) ||
+        !read_digits(text, offset + 4, 2, hour) || !read_digits(text, offset + 6, 2, minute) ||
+        !read_digits(text, offset + 8, 2, second)) {
+        return 0;
+    }
+    if (month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || minute > 59 || second > 60) {
+        return 0;
+    }
+    return days_from_civil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second;
+}
+
+// ---------------------------------------------------------------------------
+// X509CertificateCache
+// ---------------------------------------------------------------------------
+
+X509CertificateCache::X509CertificateCache() : X509CertificateCache(Config{}) {}
+
+X509CertificateCache::X509CertificateCache(const Config& config)
+    : shard_count_(std::max<size_t>(config.shards, 1)),
+      shard_capacity_(std::max<size_t>(config.capacity / std::max<size_t>(config.shards, 1), 1)) {
+    shards_ = std::make_unique<Shard[]>(shard_count_);
+}
+
+std::shared_ptr<const X509CacheEntry> X509CertificateCache::parse_entry(std::span<const uint8_t> der,
+                                                                        const utils::SHA256::Digest& fingerprint) {
+    auto entry = std::make_shared<X509CacheEntry>();
+    entry->fingerprint = fingerprint;
+    entry->der.assign(der.begin(), der.end());
+    (void)entry->view.parse(entry->der);
+    return entry;
+}
+
+std::shared_ptr<const X509CacheEntry> X509CertificateCache::find(const utils::SHA256::Digest& fingerprint) const {
+    Shard& shard = shard_for(fingerprint);
+    std::shared_lock lock(shard.mutex);
+    auto it = shard.entries.find(fingerprint);
+    if (it == shard.entries.end()) {
+        return nullptr;
+    }
+    it->second.referenced.store(true, std::memory_order_relaxed);
+    hits_.fetch_add(1, std::memory_order_relaxed);
+    return it->second.entry;
+}
+
+std::shared_ptr<const X509CacheEntry> X509CertificateCache::get_or_parse(std::span<const uint8_t> der) {
+    const auto fingerprint = utils::SHA256::hash(der);
+    if (auto entry = find(fingerprint)) {
+        return entry;
+    }
+
+    // Decode outside the lock; if another thread wins the race its entry is kept
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    auto entry = parse_entry(der, fingerprint);
+    if (!entry->view.valid()) {
+        parse_failures_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    Shard& shard = shard_for(fingerprint);
+    std::unique_lock lock(shard.mutex);
+    auto it = shard.entries.find(fingerprint);
+    if (it != shard.entries.end()) {
+        return it->second.entry;
+    }
+    insert_locked(shard, fingerprint, entry);
+    return entry;
+}
+
+void X509CertificateCache::insert_locked(Shard& shard, const utils::SHA256::Digest& fingerprint,
+                                         std::shared_ptr<const X509CacheEntry> entry) {
+    if (shard.clock.size() < shard_capacity_) {
+        shard.clock.push_back(fingerprint);
+        shard.entries.try_emplace(fingerprint, std::move(entry));
+        return;
+    }
+
+    // CLOCK: referenced entries get a second chance, the first unreferenced one is replaced
+    while (true) {
+        auto victim = shard.entries.find(shard.clock[shard.hand]);
+        if (victim != shard.entries.end() && victim->second.referenced.exchange(false, std::memory_order_relaxed)) {
+            shard.hand = (shard.hand + 1) % shard.clock.size();
+            continue;
+        }
+        if (victim != shard.entries.end()) {
+            shard.entries.erase(victim);
+            evictions_.fetch_add(1, std::memory_order_relaxed);
+        }
+        shard.clock[shard.hand] = fingerprint;
+        shard.hand = (shard.hand + 1) % shard.clock.size();
+        shard.entries.try_emplace(fingerprint, std::move(entry));
+        return;
+    }
+}
+
+X509CertificateCache::Statistics X509CertificateCache::statistics() const noexcept {
+    Statistics stats;
+    stats.hits = hits_.load(std::memory_order_relaxed);
+    stats.misses = misses_.load(std::memory_order_relaxed);
+    stats.evictions = evictions_.load(std::memory_order_relaxed);
+    stats.parse_failures = parse_failures_.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < shard_count_; ++i) {
+        std::shared_lock lock(shards_[i].mutex);
+        stats.entries += shards_[i].entries.size();
+    }
+    return stats;
+}
+
+void X509CertificateCache::clear() {
+    for (size_t i = 0; i < shard_count_; ++i) {
+        std::unique_lock lock(shards_[i].mutex);
+        shards_[i].entries.clear();
+        shards_[i].clock.clear();
+        shards_[i].hand = 0;
+    }
+    hits_.store(0, std::memory_order_relaxed);
+    misses_.store(0, std::memory_order_relaxed);
+    evictions_.store(0, std::memory_order_relaxed);
+    parse_failures_.store(0, std::memory_order_relaxed);
+}
+
+} // namespace protocol_parser::parsers
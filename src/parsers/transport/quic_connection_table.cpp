@@ -0,0 +1,446 @@
+#include "parsers/transport/quic_connection_table.hpp"
+#include <bit>
+
+namespace protocol_parser::parsers {
+
+namespace {
+    constexpr size_t kMinCapacity = 64;
+    constexpr uint8_t kSpinBit = 0x20;
+
+    inline uint64_t mix64(uint64_t value) noexcept {
+        value ^= value >> 33;
+        value *= 0xff51afd7ed558ccdULL;
+        value ^= value >> 33;
+        value *= 0xc4ceb9fe1a85ec53ULL;
+        value ^= value >> 33;
+        return value;
+    }
+
+    inline QuicEndpoint peer_of(QuicEndpoint endpoint) noexcept {
+        return endpoint == QuicEndpoint::Client ? QuicEndpoint::Server : QuicEndpoint::Client;
+    }
+}
+
+QuicConnectionTable::QuicConnectionTable() : QuicConnectionTable(Config{}) {}
+
+QuicConnectionTable::QuicConnectionTable(const Config& config) : config_(config) {
+    config_.max_connections = std::clamp<size_t>(config_.max_connections, 1, UINT32_MAX - 1);
+    slots_.resize(std::bit_ceil(std::max(config_.id_capacity, kMinCapacity)));
+    mask_ = slots_.size() - 1;
+}
+
+void QuicConnectionTable::clear() {
+    std::fill(slots_.begin(), slots_.end(), IdSlot{});
+    live_ids_ = 0;
+    sweep_cursor_ = 0;
+    connections_.clear();
+    free_connections_.clear();
+    live_connections_ = 0;
+    length_counts_.fill(0);
+    candidate_lengths_.clear();
+    candidates_dirty_ = false;
+    stats_ = Statistics{};
+}
+
+// ============================================================================
+// 连接 ID 槽位
+// ============================================================================
+
+uint64_t QuicConnectionTable::hash_id(std::span<const uint8_t> id) noexcept {
+    // FNV-1a 后再混合一次，连接 ID 可能带有服务端编码的路由信息，低位不一定均匀
+    uint64_t hash = 0xCBF29CE484222325ULL ^ id.size();
+    for (uint8_t byte : id) {
+        hash = (hash ^ byte) * 0x100000001B3ULL;
+    }
+    return mix64(hash);
+}
+
+size_t QuicConnectionTable::find_slot(std::span<const uint8_t> id, uint64_t hash) const noexcept {
+    for (size_t index = hash & mask_;; index = (index + 1) & mask_) {
+        const IdSlot& slot = slots_[index];
+        if (!slot.occupied) {
+            return slots_.size();
+        }
+        if (slot.hash == hash && slot.id.length == id.size() &&
+            std::equal(id.begin(), id.end(), slot.id.bytes.begin())) {
+            return index;
+        }
+    }
+}
+
+void QuicConnectionTable::erase_slot(size_t index) noexcept {
+    --length_counts_[slots_[index].id.length];
+    candidates_dirty_ = true;
+
+    // 后移删除，不留墓碑
+    size_t hole = index;
+    for (size_t next = (hole + 1) & mask_; slots_[next].occupied; next = (next + 1) & mask_) {
+        const size_t home = slots_[next].hash & mask_;
+        // home 循环落在 (hole, next] 内的条目保持不动
+        const bool stays = (hole <= next) ? (home > hole && home <= next) : (home > hole || home <= next);
+        if (!stays) {
+            slots_[hole] = slots_[next];
+            hole = next;
+        }
+    }
+    slots_[hole] = IdSlot{};
+    --live_ids_;
+}
+
+bool QuicConnectionTable::insert_id(uint32_t connection, QuicEndpoint issuer, std::span<const uint8_t> id) {
+    // 零长度连接 ID 无法用于归属
+    if (id.empty() || id.size() > QuicConnectionId::kMaxLength) {
+        return false;
+    }
+
+    const uint64_t hash = hash_id(id);
+    const size_t existing = find_slot(id, hash);
+    if (existing != slots_.size()) {
+        IdSlot& slot = slots_[existing];
+        if (is_live(slot)) {
+            // 已属于本连接；或与另一活动连接冲突，保留先登记者
+            return slot.connection == connection;
+        }
+        slot.connection = connection;
+        slot.generation = connections_[connection].generation;
+        slot.issuer = issuer;
+        ++connections_[connection].info.active_ids;
+        return true;
+    }
+
+    if (live_ids_ >= slots_.size() / 4 * 3) {
+        ++stats_.dropped;
+        return false;
+    }
+
+    size_t index = hash & mask_;
+    while (slots_[index].occupied) {
+        index = (index + 1) & mask_;
+    }
+    IdSlot& slot = slots_[index];
+    slot.hash = hash;
+    slot.id = QuicConnectionId::from(id);
+    slot.connection = connection;
+    slot.generation = connections_[connection].generation;
+    slot.issuer = issuer;
+    slot.occupied = true;
+    ++live_ids_;
+    ++length_counts_[id.size()];
+    candidates_dirty_ = true;
+
+    ++connections_[connection].info.active_ids;
+    ++stats_.ids_added;
+    return true;
+}
+
+bool QuicConnectionTable::is_live(const IdSlot& slot) const noexcept {
+    const Connection& connection = connections_[slot.connection];
+    return connection.live && connection.generation == slot.generation;
+}
+
+bool QuicConnectionTable::is_dead(const IdSlot& slot, uint64_t now_us) {
+    if (!is_live(slot)) {
+        return true;
+    }
+    const Connection& connection = connections_[slot.connection];
+    if (now_us > connection.info.last_seen_us &&
+        now_us - connection.info.last_seen_us > config_.idle_timeout_us) {
+        ++stats_.connections_expired;
+        release_connection(slot.connection);
+        return true;
+    }
+    return false;
+}
+
+uint32_t QuicConnectionTable::resolve(std::span<const uint8_t> id, uint64_t now_us, QuicEndpoint& issuer) {
+    if (id.empty()) {
+        return kNoConnection;
+    }
+    const size_t index = find_slot(id, hash_id(id));
+    if (index == slots_.size()) {
+        return kNoConnection;
+    }
+    if (is_dead(slots_[index], now_us)) {
+        erase_slot(index);
+        return kNoConnection;
+    }
+    issuer = slots_[index].issuer;
+    return slots_[index].connection;
+}
+
+void QuicConnectionTable::refresh_candidates() {
+    candidate_lengths_.clear();
+    for (size_t length = 1; length < length_counts_.size(); ++length) {
+        if (length_counts_[length] > 0) {
+            candidate_lengths_.push_back(static_cast<uint8_t>(length));
+        }
+    }
+    std::stable_sort(candidate_lengths_.begin(), candidate_lengths_.end(), [this](uint8_t a, uint8_t b) {
+        return length_counts_[a] > length_counts_[b];
+    });
+    candidates_dirty_ = false;
+}
+
+void QuicConnectionTable::sweep(uint64_t now_us, size_t budget) {
+    for (size_t step = 0; step < budget && live_ids_ > 0; ++step) {
+        const IdSlot& slot = slots_[sweep_cursor_];
+        if (slot.occupied && is_dead(slot, now_us)) {
+            // 后移删除可能把后继条目移到当前位置，游标不前进
+            erase_slot(sweep_cursor_);
+        } else {
+            sweep_cursor_ = (sweep_cursor_ + 1) & mask_;
+        }
+    }
+}
+
+void QuicConnectionTable::expire(uint64_t now_us) {
+    for (size_t index = 0; index < slots_.size(); ++index) {
+        while (slots_[index].occupied && is_dead(slots_[index], now_us)) {
+            erase_slot(index);
+        }
+    }
+}
+
+// ============================================================================
+// 连接记录
+// ============================================================================
+
+uint32_t QuicConnectionTable::create_connection(uint32_t version, uint64_t now_us) {
+    uint32_t index;
+    if (!free_connections_.empty()) {
+        index = free_connections_.back();
+        free_connections_.pop_back();
+    } else if (connections_.size() < config_.max_connections) {
+        index = static_cast<uint32_t>(connections_.size());
+        connections_.emplace_back();
+    } else {
+        ++stats_.dropped;
+        return kNoConnection;
+    }
+
+    Connection& connection = connections_[index];
+    connection.live = true;
+    connection.info.id = (static_cast<uint64_t>(connection.generation) << 32) | (index + 1);
+    connection.info.version = version;
+    connection.info.first_seen_us = now_us;
+    connection.info.last_seen_us = now_us;
+    ++live_connections_;
+    ++stats_.connections_created;
+    return index;
+}
+
+void QuicConnectionTable::release_connection(uint32_t index) {
+    Connection& connection = connections_[index];
+    const uint32_t generation = connection.generation + 1;
+    connection = Connection{};
+    // 代数递增后，仍指向此槽的旧连接 ID 全部失效，由清扫或查找时删除
+    connection.generation = generation;
+    free_connections_.push_back(index);
+    --live_connections_;
+}
+
+uint32_t QuicConnectionTable::index_of(uint64_t connection) const noexcept {
+    const uint64_t slot = connection & 0xFFFFFFFFULL;
+    if (slot == 0 || slot > connections_.size()) {
+        return kNoConnection;
+    }
+    const auto index = static_cast<uint32_t>(slot - 1);
+    const Connection& entry = connections_[index];
+    if (!entry.live || entry.generation != static_cast<uint32_t>(connection >> 32)) {
+        return kNoConnection;
+    }
+    return index;
+}
+
+const QuicConnectionInfo* QuicConnectionTable::find(uint64_t connection) const noexcept {
+    const uint32_t index = index_of(connection);
+    return index != kNoConnection ? &connections_[index].info : nullptr;
+}
+
+const QuicConnectionInfo* QuicConnectionTable::find_by_id(std::span<const uint8_t> id) const noexcept {
+    if (id.empty() || id.size() > QuicConnectionId::kMaxLength) {
+        return nullptr;
+    }
+    const size_t index = find_slot(id, hash_id(id));
+    if (index == slots_.size() || !is_live(slots_[index])) {
+        return nullptr;
+    }
+    return &connections_[slots_[index].connection].info;
+}
+
+void QuicConnectionTable::set_server_name(uint64_t connection, std::string_view name) {
+    const uint32_t index = index_of(connection);
+    if (index != kNoConnection && !name.empty()) {
+        connections_[index].info.server_name.assign(name);
+    }
+}
+
+bool QuicConnectionTable::add_connection_id(uint64_t connection, QuicEndpoint issuer,
+                                            std::span<const uint8_t> id, uint64_t now_us) {
+    const uint32_t index = index_of(connection);
+    if (index == kNoConnection || !insert_id(index, issuer, id)) {
+        return false;
+    }
+    sweep(now_us, config_.sweep_step);
+    return true;
+}
+
+bool QuicConnectionTable::retire_connection_id(std::span<const uint8_t> id) {
+    if (id.empty() || id.size() > QuicConnectionId::kMaxLength) {
+        return false;
+    }
+    const size_t index = find_slot(id, hash_id(id));
+    if (index == slots_.size()) {
+        return false;
+    }
+
+    const uint32_t connection = slots_[index].connection;
+    const bool live = is_live(slots_[index]);
+    erase_slot(index);
+    if (!live) {
+        return false;
+    }
+    ++stats_.ids_retired;
+    if (--connections_[connection].info.active_ids == 0) {
+        release_connection(connection);
+    }
+    return true;
+}
+
+// ============================================================================
+// 包观察
+// ============================================================================
+
+void QuicConnectionTable::touch(Connection& connection, size_t packet_bytes, uint64_t path_key, uint64_t now_us,
+                                Observation& out) {
+    auto& info = connection.info;
+    ++info.packets;
+    info.bytes += packet_bytes;
+    info.last_seen_us = std::max(info.last_seen_us, now_us);
+
+    if (path_key != 0) {
+        if (info.path_key != 0 && info.path_key != path_key) {
+            // 新路径的 RTT 与旧路径无关，自旋位状态重新开始
+            ++info.path_changes;
+            ++stats_.path_changes;
+            out.path_changed = true;
+            connection.spin = {};
+        }
+        info.path_key = path_key;
+    }
+    out.connection = info.id;
+}
+
+void QuicConnectionTable::update_spin(Connection& connection, QuicEndpoint sender, bool spin, uint64_t now_us,
+                                      Observation& out) {
+    // 同一方向上相邻两次翻转的间隔即一个 RTT（RFC 9312 3.8.2）
+    SpinState& state = connection.spin[static_cast<size_t>(sender)];
+    if (!state.seen) {
+        state.seen = true;
+        state.value = spin;
+        return;
+    }
+    if (state.value == spin) {
+        return;
+    }
+    state.value = spin;
+    if (state.last_edge_us != 0 && now_us > state.last_edge_us) {
+        const uint64_t sample = now_us - state.last_edge_us;
+        auto& info = connection.info;
+        info.latest_rtt_us = sample;
+        info.min_rtt_us = info.rtt_samples == 0 ? sample : std::min(info.min_rtt_us, sample);
+        info.smoothed_rtt_us = info.rtt_samples == 0 ? sample : (info.smoothed_rtt_us * 7 + sample) / 8;
+        ++info.rtt_samples;
+        ++stats_.rtt_samples;
+        out.rtt_sample_us = sample;
+    }
+    state.last_edge_us = now_us;
+}
+
+bool QuicConnectionTable::observe_long_header(uint32_t version, std::span<const uint8_t> dcid,
+                                              std::span<const uint8_t> scid, bool initial, size_t packet_bytes,
+                                              uint64_t path_key, uint64_t now_us, Observation& out) {
+    out = Observation{};
+    if (dcid.size() > QuicConnectionId::kMaxLength || scid.size() > QuicConnectionId::kMaxLength) {
+        return false;
+    }
+
+    // DCID 由接收方发布；SCID 由发送方发布
+    QuicEndpoint issuer = QuicEndpoint::Client;
+    uint32_t index = resolve(dcid, now_us, issuer);
+    if (index != kNoConnection) {
+        out.sender = peer_of(issuer);
+    } else if ((index = resolve(scid, now_us, issuer)) != kNoConnection) {
+        out.sender = issuer;
+    } else {
+        // 只有客户端的首个 Initial/0-RTT 能开启连接；其原始 DCID 之后不会再被服务端使用，
+        // 按"服务端发布"登记，使后续带此 DCID 的包仍判为客户端发出
+        if (!initial || (dcid.empty() && scid.empty())) {
+            sweep(now_us, config_.sweep_step);
+            return false;
+        }
+        index = create_connection(version, now_us);
+        if (index == kNoConnection) {
+            return false;
+        }
+        out.created = true;
+        out.sender = QuicEndpoint::Client;
+    }
+
+    insert_id(index, peer_of(out.sender), dcid);
+    insert_id(index, out.sender, scid);
+
+    Connection& connection = connections_[index];
+    if (connection.info.active_ids == 0) {
+        // 连接 ID 表已满，新连接无从归属
+        release_connection(index);
+        out = Observation{};
+        return false;
+    }
+    if (version != 0) {
+        connection.info.version = version;
+    }
+    touch(connection, packet_bytes, path_key, now_us, out);
+    sweep(now_us, config_.sweep_step);
+    return true;
+}
+
+bool QuicConnectionTable::observe_short_header(std::span<const uint8_t> packet, uint64_t path_key, uint64_t now_us,
+                                               Observation& out) {
+    out = Observation{};
+    if (packet.empty()) {
+        return false;
+    }
+    if (candidates_dirty_) {
+        refresh_candidates();
+    }
+
+    QuicEndpoint issuer = QuicEndpoint::Client;
+    uint32_t index = kNoConnection;
+    for (uint8_t length : candidate_lengths_) {
+        if (packet.size() <= length) {
+            continue;
+        }
+        index = resolve(packet.subspan(1, length), now_us, issuer);
+        if (index != kNoConnection) {
+            out.dcid_length = length;
+            break;
+        }
+    }
+
+    if (index == kNoConnection) {
+        ++stats_.short_header_misses;
+        sweep(now_us, config_.sweep_step);
+        return false;
+    }
+    ++stats_.short_header_hits;
+
+    Connection& connection = connections_[index];
+    out.sender = peer_of(issuer);
+    touch(connection, packet.size(), path_key, now_us, out);
+    update_spin(connection, out.sender, (packet[0] & kSpinBit) != 0, now_us, out);
+    sweep(now_us, config_.sweep_step);
+    return true;
+}
+
+} // namespace protocol_parser::parsers
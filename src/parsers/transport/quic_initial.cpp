@@ -0,0 +1,321 @@
+#include "parsers/transport/quic_initial.hpp"
+#include "utils/digest.hpp"
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+
+namespace protocol_parser::parsers {
+
+namespace {
+    // RFC 9001 5.2
+    constexpr uint8_t kInitialSaltV1[] = {
+        0x38, 0x76, 0x2C, 0xF7, 0xF5, 0x59, 0x34, 0xB3, 0x4D, 0x17,
+        0x9A, 0xE6, 0xA4, 0xC8, 0x0C, 0xAD, 0xCC, 0xBB, 0x7F, 0x0A,
+    };
+
+    // RFC 9369 3.3.1
+    constexpr uint8_t kInitialSaltV2[] = {
+        0x0D, 0xED, 0xE3, 0xDE, 0xF7, 0x00, 0xA6, 0xDB, 0x81, 0x93,
+        0x81, 0xBE, 0x6E, 0x26, 0x9D, 0xCB, 0xF9, 0xBD, 0x2E, 0xD9,
+    };
+
+    constexpr size_t kSampleOffset = 4;       // 采样从包号字段起第 4 字节开始
+    constexpr size_t kSampleSize = 16;
+    constexpr size_t kHandshakeHeaderSize = 4;
+    constexpr uint8_t kClientHello = 1;
+
+    // TLS 1.3 HKDF-Expand-Label（RFC 8446 7.1），上下文为空
+    bool expand_label(std::span<const uint8_t> secret, std::string_view label, std::span<uint8_t> out) noexcept {
+        constexpr std::string_view kPrefix = "tls13 ";
+        uint8_t info[2 + 1 + 255 + 1];
+        size_t length = 0;
+        info[length++] = static_cast<uint8_t>(out.size() >> 8);
+        info[length++] = static_cast<uint8_t>(out.size());
+        info[length++] = static_cast<uint8_t>(kPrefix.size() + label.size());
+        std::memcpy(info + length, kPrefix.data(), kPrefix.size());
+        length += kPrefix.size();
+        std::memcpy(info + length, label.data(), label.size());
+        length += label.size();
+        info[length++] = 0;
+        return utils::hkdf_expand(secret, std::span<const uint8_t>(info, length), out);
+    }
+
+    bool derive_protection(std::span<const uint8_t> secret, bool v2, QuicPacketProtection& out) noexcept {
+        std::array<uint8_t, utils::AES128::kKeySize> key;
+        std::array<uint8_t, utils::AES128::kKeySize> hp;
+        if (!expand_label(secret, v2 ? "quicv2 key" : "quic key", key) ||
+            !expand_label(secret, v2 ? "quicv2 iv" : "quic iv", out.iv) ||
+            !expand_label(secret, v2 ? "quicv2 hp" : "quic hp", hp)) {
+            return false;
+        }
+        out.aead.set_key(key);
+        out.header_protection.set_key(hp);
+        return true;
+    }
+}
+
+// ============================================================================
+// 密钥派生与包保护
+// ============================================================================
+
+bool QuicInitialKeys::derive(uint32_t version, std::span<const uint8_t> dcid, QuicInitialKeys& out) noexcept {
+    std::span<const uint8_t> salt;
+    if (version == kQuicVersion1) {
+        salt = kInitialSaltV1;
+    } else if (version == kQuicVersion2) {
+        salt = kInitialSaltV2;
+    } else {
+        return false;
+    }
+
+    const auto initial_secret = utils::hkdf_extract(salt, dcid);
+    utils::SHA256::Digest client_secret;
+    utils::SHA256::Digest server_secret;
+    if (!expand_label(initial_secret, "client in", client_secret) ||
+        !expand_label(initial_secret, "server in", server_secret)) {
+        return false;
+    }
+
+    const bool v2 = version == kQuicVersion2;
+    return derive_protection(client_secret, v2, out.client) && derive_protection(server_secret, v2, out.server);
+}
+
+bool unprotect_quic_initial(const QuicPacketProtection& keys,
+                            std::span<uint8_t> packet,
+                            size_t pn_offset,
+                            uint64_t& packet_number,
+                            std::span<const uint8_t>& payload) noexcept {
+    if (pn_offset + kSampleOffset + kSampleSize > packet.size()) {
+        return false;
+    }
+
+    // 头部保护（RFC 9001 5.4）：长包头只保护首字节低 4 位与包号
+    utils::AES128::Block mask;
+    keys.header_protection.encrypt_block(packet.data() + pn_offset + kSampleOffset, mask.data());
+    packet[0] ^= mask[0] & 0x0F;
+    const size_t pn_length = (packet[0] & 0x03) + 1;
+
+    packet_number = 0;
+    for (size_t i = 0; i < pn_length; ++i) {
+        packet[pn_offset + i] ^= mask[1 + i];
+        packet_number = (packet_number << 8) | packet[pn_offset + i];
+    }
+
+    // nonce = iv ^ 包号（左侧补零）；Initial 包号从 0 开始，截断值即完整值
+    std::array<uint8_t, utils::AES128GCM::kNonceSize> nonce = keys.iv;
+    for (size_t i = 0; i < 8; ++i) {
+        nonce[nonce.size() - 1 - i] ^= static_cast<uint8_t>(packet_number >> (8 * i));
+    }
+
+    const size_t header_length = pn_offset + pn_length;
+    const auto aad = packet.first(header_length);
+    const auto ciphertext = packet.subspan(header_length);
+    if (ciphertext.size() < utils::AES128GCM::kTagSize ||
+        !keys.aead.decrypt(nonce, aad, ciphertext, ciphertext)) {
+        return false;
+    }
+
+    payload = ciphertext.first(ciphertext.size() - utils::AES128GCM::kTagSize);
+    return true;
+}
+
+// ============================================================================
+// QuicInitialTracker
+// ============================================================================
+
+size_t QuicInitialTracker::ConnectionKeyHash::operator()(const ConnectionKey& key) const noexcept {
+    // FNV-1a
+    uint64_t hash = 0xCBF29CE484222325ULL ^ key.version;
+    for (size_t i = 0; i < key.length; ++i) {
+        hash = (hash ^ key.dcid[i]) * 0x100000001B3ULL;
+    }
+    return static_cast<size_t>(hash);
+}
+
+QuicInitialTracker::QuicInitialTracker() : QuicInitialTracker(Config{}) {}
+
+QuicInitialTracker::QuicInitialTracker(const Config& config) : config_(config) {
+    config_.max_connections = std::max<size_t>(config_.max_connections, 1);
+}
+
+void QuicInitialTracker::clear() {
+    connections_.clear();
+    insertion_order_.clear();
+    stats_ = Statistics{};
+}
+
+bool QuicInitialTracker::read_varint(std::span<const uint8_t> data, size_t& offset, uint64_t& value) noexcept {
+    if (offset >= data.size()) {
+        return false;
+    }
+    const size_t length = size_t{1} << (data[offset] >> 6);
+    if (length > data.size() - offset) {
+        return false;
+    }
+    value = data[offset] & 0x3F;
+    for (size_t i = 1; i < length; ++i) {
+        value = (value << 8) | data[offset + i];
+    }
+    offset += length;
+    return true;
+}
+
+QuicInitialTracker::Connection* QuicInitialTracker::find_or_create(uint32_t version, std::span<const uint8_t> dcid,
+                                                                   bool& created) {
+    created = false;
+    ConnectionKey key;
+    key.version = version;
+    key.length = static_cast<uint8_t>(dcid.size());
+    std::copy(dcid.begin(), dcid.end(), key.dcid.begin());
+
+    auto it = connections_.find(key);
+    if (it != connections_.end()) {
+        ++stats_.key_cache_hits;
+        return it->second.get();
+    }
+
+    auto connection = std::make_unique<Connection>();
+    if (!QuicInitialKeys::derive(version, dcid, connection->keys)) {
+        return nullptr;
+    }
+    ++stats_.key_derivations;
+
+    while (connections_.size() >= config_.max_connections && !insertion_order_.empty()) {
+        if (connections_.erase(insertion_order_.front()) > 0) {
+            ++stats_.evictions;
+        }
+        insertion_order_.pop_front();
+    }
+    insertion_order_.push_back(key);
+    created = true;
+    return connections_.emplace(key, std::move(connection)).first->second.get();
+}
+
+QuicInitialTracker::Status QuicInitialTracker::process(uint32_t version,
+                                                       std::span<const uint8_t> dcid,
+                                                       std::span<uint8_t> packet,
+                                                       size_t pn_offset,
+                                                       uint64_t& packet_number,
+                                                       std::span<const uint8_t>& payload,
+                                                       const QuicClientHello*& hello) {
+    hello = nullptr;
+    if ((version != kQuicVersion1 && version != kQuicVersion2) || dcid.size() > 20) {
+        return Status::Unsupported;
+    }
+
+    bool created;
+    Connection* connection = find_or_create(version, dcid, created);
+    if (connection == nullptr) {
+        return Status::Unsupported;
+    }
+
+    if (!unprotect_quic_initial(connection->keys.client, packet, pn_offset, packet_number, payload)) {
+        ++stats_.decrypt_failures;
+        // 服务端 Initial 或噪声：不留下只派生过密钥的连接
+        if (created) {
+            connections_.erase(insertion_order_.back());
+            insertion_order_.pop_back();
+        }
+        return Status::DecryptFailed;
+    }
+    ++stats_.packets_decrypted;
+
+    if (!connection->complete && !connection->failed) {
+        const bool well_formed = for_each_frame(payload, [&](uint64_t type, uint64_t offset, std::span<const uint8_t> data) {
+            if (type == 0x06 && !connection->failed && !add_crypto(*connection, offset, data)) {
+                connection->failed = true;
+            }
+        });
+        if (well_formed && !connection->failed) {
+            try_complete(*connection);
+        }
+    }
+
+    if (connection->complete) {
+        hello = &connection->hello;
+        return Status::ClientHello;
+    }
+    return Status::NeedMoreData;
+}
+
+bool QuicInitialTracker::add_crypto(Connection& connection, uint64_t offset, std::span<const uint8_t> data) {
+    if (data.empty()) {
+        return true;
+    }
+    if (offset > config_.max_crypto_bytes || data.size() > config_.max_crypto_bytes - offset) {
+        return false;
+    }
+
+    const auto begin = static_cast<uint32_t>(offset);
+    const auto end = static_cast<uint32_t>(offset + data.size());
+    if (connection.crypto.size() < end) {
+        connection.crypto.resize(end);
+    }
+    std::memcpy(connection.crypto.data() + begin, data.data(), data.size());
+
+    auto& ranges = connection.ranges;
+    if (begin > connection.contiguous) {
+        // 乱序到达：插入并合并相交区间
+        auto it = std::lower_bound(ranges.begin(), ranges.end(), begin,
+                                   [](const Range& range, uint32_t value) { return range.begin < value; });
+        it = ranges.insert(it, Range{begin, end});
+        if (it != ranges.begin() && std::prev(it)->end >= it->begin) {
+            --it;
+            it->end = std::max(it->end, std::next(it)->end);
+            ranges.erase(std::next(it));
+        }
+        while (std::next(it) != ranges.end() && std::next(it)->begin <= it->end) {
+            it->end = std::max(it->end, std::next(it)->end);
+            ranges.erase(std::next(it));
+        }
+        return true;
+    }
+
+    connection.contiguous = std::max(connection.contiguous, end);
+    while (!ranges.empty() && ranges.front().begin <= connection.contiguous) {
+        connection.contiguous = std::max(connection.contiguous, ranges.front().end);
+        ranges.erase(ranges.begin());
+    }
+    return true;
+}
+
+void QuicInitialTracker::try_complete(Connection& connection) {
+    if (connection.contiguous < kHandshakeHeaderSize) {
+        return;
+    }
+    const uint8_t* header = connection.crypto.data();
+    const size_t total = kHandshakeHeaderSize +
+        ((static_cast<size_t>(header[1]) << 16) | (static_cast<size_t>(header[2]) << 8) | header[3]);
+    if (header[0] != kClientHello || total > config_.max_crypto_bytes) {
+        connection.failed = true;
+        return;
+    }
+    if (connection.contiguous < total) {
+        return;
+    }
+
+    TLSHelloView view;
+    auto& hello = connection.hello;
+    if (!TLSHelloScanner::fingerprint(std::span<const uint8_t>(connection.crypto).first(total),
+                                      hello.fingerprints, &view, 'q')) {
+        connection.failed = true;
+        return;
+    }
+
+    hello.server_name.assign(view.server_name);
+    for (size_t offset = 0; offset < view.alpn.size();) {
+        const size_t length = view.alpn[offset];
+        if (length == 0 || length > view.alpn.size() - offset - 1) {
+            break;
+        }
+        hello.alpn.emplace_back(reinterpret_cast<const char*>(view.alpn.data() + offset + 1), length);
+        offset += 1 + length;
+    }
+
+    connection.complete = true;
+    std::vector<uint8_t>().swap(connection.crypto);
+    std::vector<Range>().swap(connection.ranges);
+    ++stats_.client_hellos;
+}
+
+} // namespace protocol_parser::parsers
@@ -1,4 +1,5 @@
 #include "parsers/transport/quic_parser.hpp"
+#include <new>
 
 namespace protocol_parser::parsers {
 
@@ -50,8 +51,8 @@ bool QuicParser::is_quic_packet(const BufferView& buffer) noexcept {
 
         // QUIC 版本应该是已知的版本之一
         // v1: 0x00000001
-        // v2: 0x709a50c4 (draft)
-        return (version == 0x00000001 || version == 0x709a50c4);
+        // v2: 0x6b3343cf（RFC 9369），0x709a50c4 为草案版本
+        return (version == kQuicVersion1 || version == kQuicVersion2 || version == 0x709a50c4);
     } else {
         // 短包头：需要检查连接 ID
         // 短包头格式: 0XXXXXXX [Connection ID] [Packet Number] [Payload]
@@ -76,32 +77,57 @@ ParseResult QuicParser::parse(ParseContext& context) noexcept {
         return ParseResult::BufferTooSmall;
     }
 
-    size_t offset = 0;
-    uint8_t first_byte = buffer[offset++];
-
-    // 检查包头格式位
-    bool is_long_header = (first_byte & 0x80) != 0;
-
     result_ = QuicParseResult{};
-    result_.is_long_header = is_long_header;
-
-    if (is_long_header) {
-        if (!parse_long_header(buffer, offset)) {
-            return ParseResult::InvalidFormat;
-        }
-    } else {
-        if (!parse_short_header(buffer, offset)) {
-            return ParseResult::InvalidFormat;
+    packets_.clear();
+
+    try {
+        // 一个数据报可合并多个长包头包，最后一个可以是短包头包（RFC 9000 12.2）
+        size_t start = 0;
+        while (start < buffer.size()) {
+            const BufferView packet = buffer.substr(start);
+            const uint8_t first_byte = packet[0];
+
+            // 合并包之后的填充：Fixed Bit 为 0 的字节不可能是包的开始
+            if (start > 0 && (first_byte & 0x40) == 0) {
+                break;
+            }
+
+            // 检查包头格式位
+            const bool is_long_header = (first_byte & 0x80) != 0;
+
+            result_ = QuicParseResult{};
+            result_.is_long_header = is_long_header;
+
+            size_t offset = 1;
+            size_t packet_end = packet.size();
+            const bool parsed = is_long_header ? parse_long_header(packet, offset, packet_end)
+                                               : parse_short_header(packet, offset);
+            if (!parsed) {
+                if (packets_.empty()) {
+                    return ParseResult::InvalidFormat;
+                }
+                break;   // 之后的字节无法识别，保留已解析的包
+            }
+
+            result_.packet_size = packet_end;
+            packets_.push_back(std::move(result_));
+            start += packet_end;
+
+            if (!is_long_header || packets_.back().long_header.packet_type == QuicPacketType::VersionNegotiation) {
+                break;
+            }
         }
+    } catch (const std::bad_alloc&) {
+        return ParseResult::InternalError;
     }
 
     // 保存结果到上下文
-    context.metadata["quic_result"] = result_;
+    context.metadata["quic_result"] = packets_.front();
 
     return ParseResult::Success;
 }
 
-bool QuicParser::parse_long_header(const BufferView& buffer, size_t& offset) {
+bool QuicParser::parse_long_header(const BufferView& buffer, size_t& offset, size_t& packet_end) {
     // 长包头格式（RFC 9000 Section 17.2）:
     // +====+=========+================================+
     // | 1  | Version | ... (其余字段)                |
@@ -136,9 +162,12 @@ bool QuicParser::parse_long_header(const BufferView& buffer, size_t& offset) {
         return true;  // 版本协商包特殊处理
     }
 
-    // 提取包类型
+    // 提取包类型（v2 重新分配了类型编码，RFC 9369 3.2）
     uint8_t first_byte = buffer[0];
     uint8_t type_bits = (first_byte >> 4) & 0x03;  // bits 5-4
+    if (result_.long_header.version == kQuicVersion2) {
+        type_bits = (type_bits + 3) & 0x03;
+    }
 
     switch (type_bits) {
         case 0x00:
@@ -171,27 +200,82 @@ bool QuicParser::parse_long_header(const BufferView& buffer, size_t& offset) {
         return false;
     }
 
-    // 解析包号（部分包类型有）
-    if (result_.long_header.packet_type == QuicPacketType::Initial ||
-        result_.long_header.packet_type == QuicPacketType::Handshake) {
-        auto packet_number = parse_packet_number(buffer, offset);
-        if (packet_number) {
-            result_.long_header.packet_number = *packet_number;
+    // Retry 包没有 Length 与包号，其余为令牌与完整性标签
+    if (result_.long_header.packet_type == QuicPacketType::Retry) {
+        result_.payload.assign(buffer.data() + offset, buffer.data() + buffer.size());
+        track_long_header(buffer.size());
+        return true;
+    }
+
+    // Initial 包：Token Length (i) + Token
+    if (result_.long_header.packet_type == QuicPacketType::Initial) {
+        auto token_length = parse_varint(buffer, offset);
+        if (!token_length || *token_length > buffer.size() - offset) {
+            return false;
         }
+        result_.long_header.token.assign(buffer.data() + offset, buffer.data() + offset + *token_length);
+        offset += static_cast<size_t>(*token_length);
     }
 
-    // 剩余的是载荷（帧）
-    if (offset < buffer.size()) {
-        size_t payload_size = buffer.size() - offset;
-        result_.payload.assign(buffer.data() + offset, buffer.data() + buffer.size());
+    // Length (i)：包号与载荷的总长度，之后可能合并了下一个包
+    auto length = parse_varint(buffer, offset);
+    if (!length || *length > buffer.size() - offset) {
+        return false;
+    }
+    result_.long_header.length = *length;
+    packet_end = offset + static_cast<size_t>(*length);
 
-        // 尝试解析帧
-        parse_frames(buffer, offset);
+    // 包号受头部保护，只有 Initial 包能用 DCID 派生的密钥解开
+    if (result_.long_header.packet_type == QuicPacketType::Initial) {
+        decrypt_initial(buffer, offset, packet_end);
+    }
+    if (!result_.decrypted) {
+        result_.payload.assign(buffer.data() + offset, buffer.data() + packet_end);
     }
 
+    track_long_header(packet_end);
     return true;
 }
 
+void QuicParser::track_long_header(size_t packet_size) {
+    const auto& header = result_.long_header;
+    const bool opens_connection = header.packet_type == QuicPacketType::Initial ||
+                                  header.packet_type == QuicPacketType::ZeroRTTProtected;
+    auto& observation = result_.connection;
+    if (!connection_table_.observe_long_header(header.version, header.destination_id, header.source_id,
+                                               opens_connection, packet_size, path_key_, timestamp_us_,
+                                               observation)) {
+        return;
+    }
+    if (result_.client_hello && !result_.client_hello->server_name.empty()) {
+        connection_table_.set_server_name(observation.connection, result_.client_hello->server_name);
+    }
+}
+
+void QuicParser::decrypt_initial(const BufferView& buffer, size_t pn_offset, size_t packet_end) {
+    packet_buffer_.assign(buffer.data(), buffer.data() + packet_end);
+
+    uint64_t packet_number = 0;
+    std::span<const uint8_t> payload;
+    const QuicClientHello* client_hello = nullptr;
+    const auto status = initial_tracker_.process(result_.long_header.version,
+                                                 result_.long_header.destination_id,
+                                                 packet_buffer_, pn_offset,
+                                                 packet_number, payload, client_hello);
+    if (status == QuicInitialTracker::Status::Unsupported ||
+        status == QuicInitialTracker::Status::DecryptFailed) {
+        return;
+    }
+
+    result_.decrypted = true;
+    result_.long_header.packet_number = packet_number;
+    result_.payload.assign(payload.begin(), payload.end());
+    (void)parse_frames(payload);
+    if (client_hello != nullptr) {
+        result_.client_hello = *client_hello;
+    }
+}
+
 bool QuicParser::parse_short_header(const BufferView& buffer, size_t& offset) {
     // 短包头格式（RFC 9000 Section 17.3）:
     // 0                   1                   2                   3
@@ -208,9 +292,12 @@ bool QuicParser::parse_short_header(const BufferView& buffer, size_t& offset) {
 
     result_.short_header.header_form = 0;
 
-    // 解析连接 ID（简化：假设 8 字节）
-    // 实际应该根据连接配置确定长度
-    size_t conn_id_len = 8;  // 默认 8 字节
+    // 短包头不携带连接 ID 长度：用连接表中学到的长度查找，未归属的连接按 8 字节处理
+    size_t conn_id_len = 8;
+    if (connection_table_.observe_short_header(std::span<const uint8_t>(buffer.data(), buffer.size()),
+                                               path_key_, timestamp_us_, result_.connection)) {
+        conn_id_len = result_.connection.dcid_length;
+    }
 
     if (offset + conn_id_len > buffer.size()) {
         return false;
@@ -262,43 +349,6 @@ bool QuicParser::parse_connection_id(const BufferView& buffer,
     return true;
 }
 
-std::optional<uint64_t> QuicParser::parse_packet_number(
-    const BufferView& buffer,
-    size_t& offset) {
-
-    if (offset >= buffer.size()) {
-        return std::nullopt;
-    }
-
-    // 包号长度由第一个字节的低 2 位决定
-    // 00 = 1 字节
-    // 01 = 2 字节
-    // 10 = 4 字节
-    // 11 = 8 字节（不常见）
-
-    uint8_t first_byte = buffer[0];
-    uint8_t pn_length = (first_byte & 0x03);
-
-    size_t bytes_to_read = 0;
-    switch (pn_length) {
-        case 0x00: bytes_to_read = 1; break;
-        case 0x01: bytes_to_read = 2; break;
-        case 0x02: bytes_to_read = 4; break;
-        case 0x03: bytes_to_read = 8; break;
-    }
-
-    if (offset + bytes_to_read > buffer.size()) {
-        return std::nullopt;
-    }
-
-    uint64_t packet_number = 0;
-    for (size_t i = 0; i < bytes_to_read; ++i) {
-        packet_number = (packet_number << 8) | buffer[offset++];
-    }
-
-    return packet_number;
-}
-
 std::optional<uint64_t> QuicParser::parse_varint(
     const BufferView& buffer,
     size_t& offset) {
@@ -313,76 +363,29 @@ std::optional<uint64_t> QuicParser::parse_varint(
     // | 11    | 8      | 62          | 11XXXXXX ...*     |
     // +-------+--------+-------------+-------------------+
 
-    if (offset >= buffer.size()) {
-        return std::nullopt;
-    }
-
-    uint8_t first_byte = buffer[offset];
-    uint8_t two_msb = (first_byte >> 6) & 0x03;
-
     uint64_t value = 0;
-    size_t bytes_to_read = 0;
-
-    switch (two_msb) {
-        case 0x00:
-            // 1 字节
-            value = first_byte & 0x3F;
-            offset += 1;
-            return value;
-
-        case 0x01:
-            // 2 字节
-            bytes_to_read = 2;
-            break;
-        case 0x02:
-            // 4 字节
-            bytes_to_read = 4;
-            break;
-        case 0x03:
-            // 8 字节
-            bytes_to_read = 8;
-            break;
-    }
-
-    if (offset + bytes_to_read > buffer.size()) {
+    if (!QuicInitialTracker::read_varint(std::span<const uint8_t>(buffer.data(), buffer.size()), offset, value)) {
         return std::nullopt;
     }
-
-    // 跳过第一个字节
-    offset++;
-
-    // 读取剩余字节
-    for (size_t i = 0; i < bytes_to_read - 1; ++i) {
-        value = (value << 8) | buffer[offset++];
-    }
-
-    // 合并第一个字节的低 6 位
-    value = (value << 6) | (first_byte & 0x3F);
-
     return value;
 }
 
-bool QuicParser::parse_frames(const BufferView& buffer, size_t offset) {
-    // 解析所有帧（简化实现）
-    while (offset < buffer.size()) {
-        auto frame_type = parse_varint(buffer, offset);
-        if (!frame_type) {
-            break;
-        }
-
+bool QuicParser::parse_frames(std::span<const uint8_t> payload) {
+    return QuicInitialTracker::for_each_frame(payload, [this](uint64_t type, uint64_t, std::span<const uint8_t> data) {
         QuicParseResult::Frame frame;
-        frame.type = static_cast<QuicFrameType>(*frame_type);
-
-        // 简化：不解析每种帧的具体内容
-        // 实际应用中需要根据帧类型解析
-        result_.frames.push_back(frame);
-    }
-
-    return true;
+        frame.type = static_cast<QuicFrameType>(type);
+        if (frame.type != QuicFrameType::Padding) {
+            frame.data.assign(data.begin(), data.end());
+        }
+        result_.frames.push_back(std::move(frame));
+    });
 }
 
 void QuicParser::reset() noexcept {
     result_ = QuicParseResult{};
+    packets_.clear();
+    initial_tracker_.clear();
+    connection_table_.clear();
     state_ = ParserState::Initial;
     current_offset_ = 0;
 }
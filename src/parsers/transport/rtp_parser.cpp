@@ -113,18 +113,25 @@ bool RtpParser::can_parse(const BufferView& buffer) const noexcept {
 ParseResult RtpParser::parse(ParseContext& context) noexcept {
     const BufferView& buffer = context.buffer;
 
+    // 绑定只作用于本次解析，提前返回时同样丢弃
+    const std::optional<SipMediaMatch> binding = binding_;
+    binding_.reset();
+
     if (buffer.size() < protocol_info_.min_packet_size) {
         return ParseResult::BufferTooSmall;
     }
 
     reset();
 
-    // 判断是 RTP 还是 RTCP
-    if (is_rtcp_packet(buffer)) {
+    // 判断是 RTP 还是 RTCP；已绑定到 SIP 媒体流时以会话表的判断为准
+    if (binding ? binding->rtcp : is_rtcp_packet(buffer)) {
         is_rtcp_ = true;
         if (!parse_rtcp_packet(buffer)) {
             return ParseResult::InvalidFormat;
         }
+        if (binding) {
+            rtcp_result_.call = binding->dialog;
+        }
         context.metadata["rtcp_result"] = rtcp_result_;
     } else {
         is_rtcp_ = false;
@@ -140,6 +147,13 @@ ParseResult RtpParser::parse(ParseContext& context) noexcept {
                                       buffer.data() + buffer.size());
         }
 
+        if (binding) {
+            rtp_result_.call = binding->dialog;
+            if (binding->media != nullptr) {
+                rtp_result_.clock_rate = binding->media->clock_rate(rtp_result_.payload_type);
+            }
+        }
+
         context.metadata["rtp_result"] = rtp_result_;
     }
 
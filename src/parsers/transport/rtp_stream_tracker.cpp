@@ -0,0 +1,481 @@
+#include "parsers/transport/rtp_stream_tracker.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+namespace protocol_parser::parsers {
+
+namespace {
+    // RFC 3550 A.1
+    constexpr uint32_t kSeqMod = 1U << 16;
+    constexpr uint16_t kMaxDropout = 3000;
+    constexpr uint16_t kMaxMisorder = 100;
+    constexpr uint8_t kMinSequential = 2;
+
+    inline uint64_t mix64(uint64_t value) noexcept {
+        value ^= value >> 33;
+        value *= 0xff51afd7ed558ccdULL;
+        value ^= value >> 33;
+        value *= 0xc4ceb9fe1a85ec53ULL;
+        value ^= value >> 33;
+        return value;
+    }
+
+    inline uint64_t flow_hash(uint64_t flow, uint32_t ssrc) noexcept {
+        return mix64(flow ^ mix64(ssrc));
+    }
+
+    inline uint32_t read_be32(std::span<const uint8_t> data, size_t offset) noexcept {
+        return (static_cast<uint32_t>(data[offset]) << 24) | (static_cast<uint32_t>(data[offset + 1]) << 16) |
+               (static_cast<uint32_t>(data[offset + 2]) << 8) | data[offset + 3];
+    }
+
+    // 微秒 -> NTP 短格式（16.16 定点秒），与 LSR/DLSR 同单位，按 2^32 回绕
+    inline uint32_t ntp_short(uint64_t now_us) noexcept {
+        const uint64_t seconds = now_us / 1'000'000;
+        const uint64_t fraction = ((now_us % 1'000'000) << 16) / 1'000'000;
+        return static_cast<uint32_t>((seconds << 16) + fraction);
+    }
+
+    void init_seq(RtpStreamState& state, uint16_t seq) noexcept {
+        state.base_seq = seq;
+        state.max_seq = seq;
+        state.bad_seq = kSeqMod + 1;
+        state.cycles = 0;
+        state.received = 0;
+        state.history = 1;
+    }
+}
+
+RtpStreamTracker::RtpStreamTracker() : RtpStreamTracker(Config{}) {}
+
+RtpStreamTracker::RtpStreamTracker(const Config& config) : config_(config) {
+    config_.max_streams = std::clamp<size_t>(config_.max_streams, 1, kNone - 1);
+    // 索引负载不超过 3/4
+    const size_t slots = std::bit_ceil(std::max<size_t>(config_.max_streams * 4 / 3 + 1, 64));
+    flow_index_.resize(slots);
+    ssrc_index_.resize(slots);
+    mask_ = slots - 1;
+}
+
+void RtpStreamTracker::clear() {
+    states_.clear();
+    free_states_.clear();
+    live_streams_ = 0;
+    std::fill(flow_index_.begin(), flow_index_.end(), IndexSlot{});
+    std::fill(ssrc_index_.begin(), ssrc_index_.end(), IndexSlot{});
+    sweep_cursor_ = 0;
+    stats_ = Statistics{};
+}
+
+uint64_t RtpStreamTracker::flow_key(const SipMediaEndpoint& source, const SipMediaEndpoint& destination) noexcept {
+    uint64_t words[4];
+    std::memcpy(words, source.address.data(), 16);
+    std::memcpy(words + 2, destination.address.data(), 16);
+    uint64_t hash = mix64(words[0] ^ mix64(words[1]));
+    hash = mix64(hash ^ words[2]);
+    hash = mix64(hash ^ words[3]);
+    return mix64(hash ^ ((static_cast<uint64_t>(source.port) << 16) | destination.port));
+}
+
+uint32_t RtpStreamTracker::static_clock_rate(uint8_t payload_type) noexcept {
+    // RFC 3551 表 4、表 5
+    switch (payload_type) {
+        case 0: case 3: case 4: case 5: case 7: case 8: case 9:
+        case 12: case 13: case 15: case 18:
+            return 8000;
+        case 6: return 16000;
+        case 10: case 11: return 44100;
+        case 16: return 11025;
+        case 17: return 22050;
+        case 14: case 25: case 26: case 28: case 31: case 32: case 33: case 34:
+            return 90000;
+        default:
+            return 0;
+    }
+}
+
+// ============================================================================
+// 索引
+// ============================================================================
+
+size_t RtpStreamTracker::find_flow(uint64_t flow, uint32_t ssrc, uint64_t hash) const noexcept {
+    for (size_t index = hash & mask_;; index = (index + 1) & mask_) {
+        const IndexSlot& slot = flow_index_[index];
+        if (slot.stream == kNone) {
+            return flow_index_.size();
+        }
+        if (slot.hash == hash && states_[slot.stream].flow == flow && states_[slot.stream].ssrc == ssrc) {
+            return index;
+        }
+    }
+}
+
+size_t RtpStreamTracker::find_ssrc(uint32_t ssrc, uint64_t hash) const noexcept {
+    for (size_t index = hash & mask_;; index = (index + 1) & mask_) {
+        const IndexSlot& slot = ssrc_index_[index];
+        if (slot.stream == kNone) {
+            return ssrc_index_.size();
+        }
+        if (slot.hash == hash && states_[slot.stream].ssrc == ssrc) {
+            return index;
+        }
+    }
+}
+
+void RtpStreamTracker::insert_slot(std::vector<IndexSlot>& index, uint64_t hash, uint32_t stream) noexcept {
+    size_t slot = hash & mask_;
+    while (index[slot].stream != kNone) {
+        slot = (slot + 1) & mask_;
+    }
+    index[slot] = IndexSlot{hash, stream};
+}
+
+void RtpStreamTracker::erase_slot(std::vector<IndexSlot>& index, size_t slot) noexcept {
+    // 后移删除，不留墓碑
+    size_t hole = slot;
+    for (size_t next = (hole + 1) & mask_; index[next].stream != kNone; next = (next + 1) & mask_) {
+        const size_t home = index[next].hash & mask_;
+        // home 循环落在 (hole, next] 内的条目保持不动
+        const bool stays = (hole <= next) ? (home > hole && home <= next) : (home > hole || home <= next);
+        if (!stays) {
+            index[hole] = index[next];
+            hole = next;
+        }
+    }
+    index[hole] = IndexSlot{};
+}
+
+const RtpStreamState* RtpStreamTracker::find(uint64_t flow, uint32_t ssrc) const noexcept {
+    const size_t slot = find_flow(flow, ssrc, flow_hash(flow, ssrc));
+    return slot != flow_index_.size() ? &states_[flow_index_[slot].stream] : nullptr;
+}
+
+const RtpStreamState* RtpStreamTracker::find_by_ssrc(uint32_t ssrc) const noexcept {
+    const size_t slot = find_ssrc(ssrc, mix64(ssrc));
+    return slot != ssrc_index_.size() ? &states_[ssrc_index_[slot].stream] : nullptr;
+}
+
+RtpStreamState* RtpStreamTracker::stream_by_ssrc(uint32_t ssrc) noexcept {
+    return const_cast<RtpStreamState*>(find_by_ssrc(ssrc));
+}
+
+// ============================================================================
+// 流的建立与清扫
+// ============================================================================
+
+uint32_t RtpStreamTracker::create_stream(uint64_t flow, uint32_t ssrc, uint64_t now_us) {
+    if (live_streams_ >= config_.max_streams) {
+        ++stats_.dropped;
+        return kNone;
+    }
+
+    uint32_t stream;
+    if (!free_states_.empty()) {
+        stream = free_states_.back();
+        free_states_.pop_back();
+    } else {
+        stream = static_cast<uint32_t>(states_.size());
+        states_.emplace_back();
+    }
+
+    RtpStreamState& state = states_[stream];
+    state = RtpStreamState{};
+    state.flow = flow;
+    state.ssrc = ssrc;
+    state.first_arrival_us = now_us;
+    state.last_arrival_us = now_us;
+    state.flags = RtpStreamState::kLive;
+
+    insert_slot(flow_index_, flow_hash(flow, ssrc), stream);
+    // 同一 SSRC 出现在多条五元组上时，RTCP 归属最近建立的流
+    const uint64_t hash = mix64(ssrc);
+    if (const size_t slot = find_ssrc(ssrc, hash); slot != ssrc_index_.size()) {
+        ssrc_index_[slot].stream = stream;
+    } else {
+        insert_slot(ssrc_index_, hash, stream);
+    }
+
+    ++live_streams_;
+    ++stats_.streams_created;
+    return stream;
+}
+
+void RtpStreamTracker::release_stream(uint32_t stream) noexcept {
+    RtpStreamState& state = states_[stream];
+    if (const size_t slot = find_flow(state.flow, state.ssrc, flow_hash(state.flow, state.ssrc));
+        slot != flow_index_.size()) {
+        erase_slot(flow_index_, slot);
+    }
+    if (const size_t slot = find_ssrc(state.ssrc, mix64(state.ssrc));
+        slot != ssrc_index_.size() && ssrc_index_[slot].stream == stream) {
+        erase_slot(ssrc_index_, slot);
+    }
+    state.flags = 0;
+    free_states_.push_back(stream);
+    --live_streams_;
+}
+
+void RtpStreamTracker::sweep(uint64_t now_us, size_t budget) noexcept {
+    if (states_.empty()) {
+        return;
+    }
+    budget = std::min(budget, states_.size());
+    for (size_t i = 0; i < budget; ++i) {
+        sweep_cursor_ = (sweep_cursor_ + 1) % states_.size();
+        const RtpStreamState& state = states_[sweep_cursor_];
+        if ((state.flags & RtpStreamState::kLive) && now_us >= state.last_arrival_us &&
+            now_us - state.last_arrival_us > config_.idle_timeout_us) {
+            release_stream(static_cast<uint32_t>(sweep_cursor_));
+            ++stats_.streams_expired;
+        }
+    }
+}
+
+void RtpStreamTracker::expire(uint64_t now_us) {
+    sweep(now_us, states_.size());
+}
+
+// ============================================================================
+// RTP
+// ============================================================================
+
+bool RtpStreamTracker::observe(uint64_t flow, const RtpParseResult& rtp, uint64_t now_us, RtpPacketInfo& out) {
+    out = RtpPacketInfo{};
+    sweep(now_us, config_.sweep_step);
+
+    const uint16_t seq = rtp.sequence_number;
+    uint32_t stream;
+    if (const size_t slot = find_flow(flow, rtp.ssrc, flow_hash(flow, rtp.ssrc)); slot != flow_index_.size()) {
+        stream = flow_index_[slot].stream;
+    } else {
+        stream = create_stream(flow, rtp.ssrc, now_us);
+        if (stream == kNone) {
+            return false;
+        }
+        RtpStreamState& state = states_[stream];
+        init_seq(state, seq);
+        state.max_seq = static_cast<uint16_t>(seq - 1);
+        state.probation = kMinSequential;
+        out.new_stream = true;
+    }
+
+    RtpStreamState& state = states_[stream];
+    ++stats_.packets;
+    state.bytes += rtp.payload.size();
+    state.payload_type = rtp.payload_type;
+
+    const uint32_t clock_rate = rtp.clock_rate != 0 ? rtp.clock_rate : static_clock_rate(rtp.payload_type);
+    if (clock_rate != 0 && clock_rate != state.clock_rate) {
+        // 时钟频率变化后旧的传输时延不可比
+        state.clock_rate = clock_rate;
+        state.flags &= ~RtpStreamState::kHasTransit;
+    }
+
+    // RFC 3550 A.1 update_seq，另以到达位图区分重复与乱序
+    const auto udelta = static_cast<uint16_t>(seq - state.max_seq);
+    bool in_order = false;
+    if (state.probation != 0) {
+        if (seq == static_cast<uint16_t>(state.max_seq + 1)) {
+            --state.probation;
+            state.max_seq = seq;
+            if (state.probation == 0) {
+                init_seq(state, seq);
+                ++state.received;
+                out.counted = true;
+                in_order = true;
+            }
+        } else {
+            state.probation = kMinSequential - 1;
+            state.max_seq = seq;
+        }
+    } else if (udelta == 0) {
+        out.duplicate = true;
+    } else if (udelta < kMaxDropout) {
+        if (seq < state.max_seq) {
+            state.cycles += kSeqMod;
+        }
+        state.history = udelta >= 64 ? 1 : ((state.history << udelta) | 1);
+        state.max_seq = seq;
+        ++state.received;
+        out.counted = true;
+        in_order = true;
+    } else if (udelta <= kSeqMod - kMaxMisorder) {
+        // 大跳变：连续两个包确认对端重启了序列号
+        if (seq == state.bad_seq) {
+            init_seq(state, seq);
+            ++state.received;
+            out.counted = true;
+            in_order = true;
+        } else {
+            state.bad_seq = (seq + 1) & (kSeqMod - 1);
+        }
+    } else {
+        const uint32_t back = kSeqMod - udelta;
+        if (back < 64 && ((state.history >> back) & 1) != 0) {
+            out.duplicate = true;
+        } else {
+            if (back < 64) {
+                state.history |= uint64_t{1} << back;
+            }
+            ++state.reordered;
+            ++state.received;
+            out.counted = true;
+            out.reordered = true;
+        }
+    }
+    if (out.duplicate) {
+        ++state.duplicates;
+    }
+
+    if (out.counted && state.clock_rate != 0) {
+        // RFC 3550 A.8：到达时间换算为时间戳单位
+        const uint64_t elapsed_us = now_us >= state.first_arrival_us ? now_us - state.first_arrival_us : 0;
+        const auto arrival = static_cast<uint32_t>(elapsed_us * state.clock_rate / 1'000'000);
+        const auto transit = static_cast<int32_t>(arrival - rtp.timestamp);
+        if (state.flags & RtpStreamState::kHasTransit) {
+            int64_t d = static_cast<int64_t>(transit) - state.transit;
+            if (d < 0) {
+                d = -d;
+            }
+            const int64_t jitter = static_cast<int64_t>(state.jitter) + d - ((state.jitter + 8) >> 4);
+            state.jitter = static_cast<uint32_t>(std::min<int64_t>(jitter, UINT32_MAX));
+        }
+        state.transit = transit;
+        state.flags |= RtpStreamState::kHasTransit;
+    }
+
+    if (in_order && !out.new_stream && state.received > 1) {
+        const auto timestamp_delta = static_cast<int32_t>(rtp.timestamp - state.last_timestamp);
+        if (state.clock_rate != 0) {
+            out.timestamp_delta_us = static_cast<int64_t>(timestamp_delta) * 1'000'000 / state.clock_rate;
+        }
+        out.arrival_delta_us = static_cast<int64_t>(now_us) - static_cast<int64_t>(state.last_arrival_us);
+    }
+    if (in_order) {
+        state.last_timestamp = rtp.timestamp;
+    }
+    state.last_arrival_us = std::max(state.last_arrival_us, now_us);
+
+    out.stream = &state;
+    return true;
+}
+
+// ============================================================================
+// RTCP
+// ============================================================================
+
+bool RtpStreamTracker::apply_report_block(std::span<const uint8_t> block, uint32_t now_ntp) noexcept {
+    // RFC 3550 6.4.1 报告块：SSRC、丢包率、累计丢包（24 位有符号）、
+    // 扩展最高序列号、抖动、LSR、DLSR
+    RtpStreamState* state = stream_by_ssrc(read_be32(block, 0));
+    if (state == nullptr) {
+        return false;
+    }
+
+    state->reported_fraction = block[4];
+    uint32_t lost = (static_cast<uint32_t>(block[5]) << 16) | (static_cast<uint32_t>(block[6]) << 8) | block[7];
+    if (lost & 0x800000) {
+        lost |= 0xFF000000;
+    }
+    state->reported_lost = static_cast<int32_t>(lost);
+    state->reported_max_seq = read_be32(block, 8);
+    state->reported_jitter = read_be32(block, 12);
+
+    // SR 经过观测点 -> 接收端等待 DLSR -> RR 经过观测点
+    const uint32_t lsr = read_be32(block, 16);
+    const uint32_t dlsr = read_be32(block, 20);
+    if (lsr != 0 && (state->flags & RtpStreamState::kHasSenderReport) && lsr == state->sr_ntp) {
+        const uint32_t elapsed = now_ntp - state->sr_arrival;
+        if (elapsed > dlsr) {
+            state->rtt = elapsed - dlsr;
+        }
+    }
+    state->flags |= RtpStreamState::kHasReceiverReport;
+    return true;
+}
+
+size_t RtpStreamTracker::observe_rtcp(std::span<const uint8_t> compound, uint64_t now_us) {
+    ++stats_.rtcp_packets;
+    const uint32_t now_ntp = ntp_short(now_us);
+    size_t matched = 0;
+
+    while (compound.size() >= 4) {
+        if ((compound[0] >> 6) != 2) {
+            break;
+        }
+        const uint8_t count = compound[0] & 0x1F;
+        const uint8_t packet_type = compound[1];
+        const size_t length = ((static_cast<size_t>(compound[2]) << 8 | compound[3]) + 1) * 4;
+        if (length > compound.size()) {
+            break;
+        }
+        const auto packet = compound.first(length);
+        compound = compound.subspan(length);
+
+        size_t blocks = 0;
+        if (packet_type == static_cast<uint8_t>(RtcpPacketType::SR) && length >= 28) {
+            if (RtpStreamState* state = stream_by_ssrc(read_be32(packet, 4))) {
+                // NTP 时间戳（字节 8-15）的中间 32 位即对端 RR 中的 LSR
+                state->sr_ntp = read_be32(packet, 10);
+                state->sr_arrival = now_ntp;
+                state->sender_packets = read_be32(packet, 20);
+                state->flags |= RtpStreamState::kHasSenderReport;
+                ++matched;
+                ++stats_.report_matches;
+            }
+            blocks = 28;
+        } else if (packet_type == static_cast<uint8_t>(RtcpPacketType::RR) && length >= 8) {
+            blocks = 8;
+        } else {
+            continue;
+        }
+
+        for (uint8_t i = 0; i < count && blocks + 24 <= length; ++i, blocks += 24) {
+            ++stats_.report_blocks;
+            if (apply_report_block(packet.subspan(blocks, 24), now_ntp)) {
+                ++matched;
+                ++stats_.report_matches;
+            }
+        }
+    }
+    return matched;
+}
+
+// ============================================================================
+// 质量指标
+// ============================================================================
+
+RtpStreamQuality RtpStreamTracker::quality(const RtpStreamState& state) noexcept {
+    RtpStreamQuality quality;
+    quality.duration_us = state.last_arrival_us - state.first_arrival_us;
+    quality.expected = state.expected();
+    quality.lost = state.lost();
+    if (quality.expected != 0 && quality.lost > 0) {
+        quality.loss_ratio = static_cast<double>(quality.lost) / static_cast<double>(quality.expected);
+    }
+    if (state.clock_rate != 0) {
+        quality.jitter_ms = state.jitter / 16.0 * 1000.0 / state.clock_rate;
+    }
+    quality.rtt_ms = state.rtt * 1000.0 / 65536.0;
+
+    if (state.flags & RtpStreamState::kHasReceiverReport) {
+        quality.has_report = true;
+        quality.downstream_lost = static_cast<int64_t>(state.reported_lost) - quality.lost;
+        if (state.clock_rate != 0) {
+            quality.reported_jitter_ms = state.reported_jitter * 1000.0 / state.clock_rate;
+        }
+    }
+
+    // 有效时延 = 单向时延 + 2 × 抖动 + 10 ms（抖动缓冲与编解码）
+    const double effective_latency = quality.rtt_ms / 2.0 + 2.0 * quality.jitter_ms + 10.0;
+    double r = 93.2;
+    r -= effective_latency < 160.0 ? effective_latency / 40.0 : (effective_latency - 120.0) / 10.0;
+    r -= 2.5 * quality.loss_ratio * 100.0;
+    r = std::clamp(r, 0.0, 100.0);
+    quality.r_factor = r;
+    quality.mos = r <= 0.0 ? 1.0 : 1.0 + 0.035 * r + 7.0e-6 * r * (r - 60.0) * (100.0 - r);
+    return quality;
+}
+
+} // namespace protocol_parser::parsers
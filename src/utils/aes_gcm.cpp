@@ -0,0 +1,333 @@
+#include "utils/aes_gcm.hpp"
+#include <algorithm>
+#include <cstring>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+namespace protocol_parser::utils {
+
+namespace {
+    constexpr uint8_t kSBox[256] = {
+        0x63, 0x7C, 0x77, 0x7B, 0xF2, 0x6B, 0x6F, 0xC5, 0x30, 0x01, 0x67, 0x2B, 0xFE, 0xD7, 0xAB, 0x76,
+        0xCA, 0x82, 0xC9, 0x7D, 0xFA, 0x59, 0x47, 0xF0, 0xAD, 0xD4, 0xA2, 0xAF, 0x9C, 0xA4, 0x72, 0xC0,
+        0xB7, 0xFD, 0x93, 0x26, 0x36, 0x3F, 0xF7, 0xCC, 0x34, 0xA5, 0xE5, 0xF1, 0x71, 0xD8, 0x31, 0x15,
+        0x04, 0xC7, 0x23, 0xC3, 0x18, 0x96, 0x05, 0x9A, 0x07, 0x12, 0x80, 0xE2, 0xEB, 0x27, 0xB2, 0x75,
+        0x09, 0x83, 0x2C, 0x1A, 0x1B, 0x6E, 0x5A, 0xA0, 0x52, 0x3B, 0xD6, 0xB3, 0x29, 0xE3, 0x2F, 0x84,
+        0x53, 0xD1, 0x00, 0xED, 0x20, 0xFC, 0xB1, 0x5B, 0x6A, 0xCB, 0xBE, 0x39, 0x4A, 0x4C, 0x58, 0xCF,
+        0xD0, 0xEF, 0xAA, 0xFB, 0x43, 0x4D, 0x33, 0x85, 0x45, 0xF9, 0x02, 0x7F, 0x50, 0x3C, 0x9F, 0xA8,
+        0x51, 0xA3, 0x40, 0x8F, 0x92, 0x9D, 0x38, 0xF5, 0xBC, 0xB6, 0xDA, 0x21, 0x10, 0xFF, 0xF3, 0xD2,
+        0xCD, 0x0C, 0x13, 0xEC, 0x5F, 0x97, 0x44, 0x17, 0xC4, 0xA7, 0x7E, 0x3D, 0x64, 0x5D, 0x19, 0x73,
+        0x60, 0x81, 0x4F, 0xDC, 0x22, 0x2A, 0x90, 0x88, 0x46, 0xEE, 0xB8, 0x14, 0xDE, 0x5E, 0x0B, 0xDB,
+        0xE0, 0x32, 0x3A, 0x0A, 0x49, 0x06, 0x24, 0x5C, 0xC2, 0xD3, 0xAC, 0x62, 0x91, 0x95, 0xE4, 0x79,
+        0xE7, 0xC8, 0x37, 0x6D, 0x8D, 0xD5, 0x4E, 0xA9, 0x6C, 0x56, 0xF4, 0xEA, 0x65, 0x7A, 0xAE, 0x08,
+        0xBA, 0x78, 0x25, 0x2E, 0x1C, 0xA6, 0xB4, 0xC6, 0xE8, 0xDD, 0x74, 0x1F, 0x4B, 0xBD, 0x8B, 0x8A,
+        0x70, 0x3E, 0xB5, 0x66, 0x48, 0x03, 0xF6, 0x0E, 0x61, 0x35, 0x57, 0xB9, 0x86, 0xC1, 0x1D, 0x9E,
+        0xE1, 0xF8, 0x98, 0x11, 0x69, 0xD9, 0x8E, 0x94, 0x9B, 0x1E, 0x87, 0xE9, 0xCE, 0x55, 0x28, 0xDF,
+        0x8C, 0xA1, 0x89, 0x0D, 0xBF, 0xE6, 0x42, 0x68, 0x41, 0x99, 0x2D, 0x0F, 0xB0, 0x54, 0xBB, 0x16,
+    };
+
+    constexpr uint8_t kRcon[AES128::kRounds] = {0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1B, 0x36};
+
+    // GHASH 4 位查表的约减常量
+    constexpr uint64_t kLast4[16] = {
+        0x0000, 0x1C20, 0x3840, 0x2460, 0x7080, 0x6CA0, 0x48C0, 0x54E0,
+        0xE100, 0xFD20, 0xD940, 0xC560, 0x9180, 0x8DA0, 0xA9C0, 0xB5E0,
+    };
+
+    // AES-NI + PCLMULQDQ + SSE4.1（SSSE3 包含在内）
+    bool detect_hardware() noexcept {
+#ifdef _MSC_VER
+        int cpui[4];
+        __cpuid(cpui, 1);
+        const unsigned int ecx = static_cast<unsigned int>(cpui[2]);
+#else
+        unsigned int eax, ebx, ecx, edx;
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+            return false;
+        }
+#endif
+        return (ecx & (1u << 25)) && (ecx & (1u << 1)) && (ecx & (1u << 19));
+    }
+
+    const bool kHardware = detect_hardware();
+
+    inline uint8_t xtime(uint8_t value) noexcept {
+        return static_cast<uint8_t>((value << 1) ^ ((value & 0x80) ? 0x1B : 0x00));
+    }
+
+    inline uint64_t load_be64(const uint8_t* p) noexcept {
+        uint64_t value = 0;
+        for (size_t i = 0; i < 8; ++i) {
+            value = (value << 8) | p[i];
+        }
+        return value;
+    }
+
+    inline void store_be64(uint8_t* p, uint64_t value) noexcept {
+        for (size_t i = 0; i < 8; ++i) {
+            p[i] = static_cast<uint8_t>(value >> (56 - 8 * i));
+        }
+    }
+
+    inline void store_be32(uint8_t* p, uint32_t value) noexcept {
+        p[0] = static_cast<uint8_t>(value >> 24);
+        p[1] = static_cast<uint8_t>(value >> 16);
+        p[2] = static_cast<uint8_t>(value >> 8);
+        p[3] = static_cast<uint8_t>(value);
+    }
+
+    inline uint32_t load_be32(const uint8_t* p) noexcept {
+        return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+               (static_cast<uint32_t>(p[2]) << 8) | p[3];
+    }
+
+    // 可移植实现：按字节的 SubBytes/ShiftRows/MixColumns
+    void encrypt_block_portable(const uint8_t* round_keys, const uint8_t* in, uint8_t* out) noexcept {
+        uint8_t state[16];
+        for (size_t i = 0; i < 16; ++i) {
+            state[i] = in[i] ^ round_keys[i];
+        }
+
+        for (size_t round = 1; round <= AES128::kRounds; ++round) {
+            // SubBytes + ShiftRows：第 r 行左移 r 列
+            uint8_t shifted[16];
+            for (size_t column = 0; column < 4; ++column) {
+                for (size_t row = 0; row < 4; ++row) {
+                    shifted[row + 4 * column] = kSBox[state[row + 4 * ((column + row) & 3)]];
+                }
+            }
+
+            if (round == AES128::kRounds) {
+                std::memcpy(state, shifted, 16);
+            } else {
+                for (size_t column = 0; column < 4; ++column) {
+                    const uint8_t* a = shifted + 4 * column;
+                    const uint8_t all = a[0] ^ a[1] ^ a[2] ^ a[3];
+                    uint8_t* s = state + 4 * column;
+                    s[0] = a[0] ^ all ^ xtime(a[0] ^ a[1]);
+                    s[1] = a[1] ^ all ^ xtime(a[1] ^ a[2]);
+                    s[2] = a[2] ^ all ^ xtime(a[2] ^ a[3]);
+                    s[3] = a[3] ^ all ^ xtime(a[3] ^ a[0]);
+                }
+            }
+
+            const uint8_t* key = round_keys + round * 16;
+            for (size_t i = 0; i < 16; ++i) {
+                state[i] ^= key[i];
+            }
+        }
+        std::memcpy(out, state, 16);
+    }
+
+    // 可移植 GHASH：X = X * H（4 位 Shoup 表）
+    void gf_multiply_table(const uint64_t* table, uint8_t* x) noexcept {
+        size_t low = x[15] & 0x0F;
+        uint64_t zh = table[2 * low];
+        uint64_t zl = table[2 * low + 1];
+
+        for (int i = 15; i >= 0; --i) {
+            low = x[i] & 0x0F;
+            const size_t high = x[i] >> 4;
+
+            if (i != 15) {
+                const size_t rem = zl & 0x0F;
+                zl = (zh << 60) | (zl >> 4);
+                zh = (zh >> 4) ^ (kLast4[rem] << 48);
+                zh ^= table[2 * low];
+                zl ^= table[2 * low + 1];
+            }
+            const size_t rem = zl & 0x0F;
+            zl = (zh << 60) | (zl >> 4);
+            zh = (zh >> 4) ^ (kLast4[rem] << 48);
+            zh ^= table[2 * high];
+            zl ^= table[2 * high + 1];
+        }
+
+        store_be64(x, zh);
+        store_be64(x + 8, zl);
+    }
+}
+
+// ============================================================================
+// AES128
+// ============================================================================
+
+bool AES128::hardware_accelerated() noexcept {
+    return kHardware;
+}
+
+void AES128::set_key(std::span<const uint8_t, kKeySize> key) noexcept {
+    std::memcpy(round_keys_.data(), key.data(), kKeySize);
+
+    // 密钥扩展：w[i] = w[i-4] ^ f(w[i-1])
+    for (size_t i = 4; i < 4 * (kRounds + 1); ++i) {
+        uint8_t word[4];
+        std::memcpy(word, round_keys_.data() + (i - 1) * 4, 4);
+        if (i % 4 == 0) {
+            const uint8_t first = word[0];
+            word[0] = kSBox[word[1]] ^ kRcon[i / 4 - 1];
+            word[1] = kSBox[word[2]];
+            word[2] = kSBox[word[3]];
+            word[3] = kSBox[first];
+        }
+        for (size_t k = 0; k < 4; ++k) {
+            round_keys_[i * 4 + k] = round_keys_[(i - 4) * 4 + k] ^ word[k];
+        }
+    }
+}
+
+void AES128::encrypt_block(const uint8_t* in, uint8_t* out) const noexcept {
+    if (kHardware) {
+        aes_ni::encrypt_block(round_keys_.data(), in, out);
+    } else {
+        encrypt_block_portable(round_keys_.data(), in, out);
+    }
+}
+
+void AES128::ctr32_xor(const Block& counter, std::span<uint8_t> data) const noexcept {
+    if (kHardware) {
+        aes_ni::ctr32_xor(round_keys_.data(), counter, data);
+        return;
+    }
+
+    uint32_t value = load_be32(counter.data() + 12);
+    uint8_t* p = data.data();
+    size_t remaining = data.size();
+
+    Block block = counter;
+    uint8_t stream[16];
+    while (remaining > 0) {
+        store_be32(block.data() + 12, value++);
+        encrypt_block_portable(round_keys_.data(), block.data(), stream);
+        const size_t take = std::min<size_t>(remaining, 16);
+        for (size_t i = 0; i < take; ++i) {
+            p[i] ^= stream[i];
+        }
+        p += take;
+        remaining -= take;
+    }
+}
+
+// ============================================================================
+// AES128GCM
+// ============================================================================
+
+void AES128GCM::set_key(std::span<const uint8_t, kKeySize> key) noexcept {
+    aes_.set_key(key);
+    hash_key_.fill(0);
+    aes_.encrypt_block(hash_key_.data(), hash_key_.data());
+
+    // Shoup 表：table[i] = i * H（i 为 4 位，高位对应 x^0）
+    uint64_t vh = load_be64(hash_key_.data());
+    uint64_t vl = load_be64(hash_key_.data() + 8);
+    hash_table_.fill(0);
+    hash_table_[16] = vh;
+    hash_table_[17] = vl;
+    for (size_t i = 4; i > 0; i >>= 1) {
+        const uint64_t reduce = (vl & 1) ? 0xE100000000000000ULL : 0;
+        vl = (vh << 63) | (vl >> 1);
+        vh = (vh >> 1) ^ reduce;
+        hash_table_[2 * i] = vh;
+        hash_table_[2 * i + 1] = vl;
+    }
+    for (size_t i = 2; i <= 8; i *= 2) {
+        for (size_t j = 1; j < i; ++j) {
+            hash_table_[2 * (i + j)] = hash_table_[2 * i] ^ hash_table_[2 * j];
+            hash_table_[2 * (i + j) + 1] = hash_table_[2 * i + 1] ^ hash_table_[2 * j + 1];
+        }
+    }
+}
+
+AES128::Block AES128GCM::initial_counter(std::span<const uint8_t, kNonceSize> nonce) const noexcept {
+    AES128::Block counter{};
+    std::memcpy(counter.data(), nonce.data(), kNonceSize);
+    counter[15] = 1;
+    return counter;
+}
+
+AES128::Block AES128GCM::ghash(std::span<const uint8_t> aad, std::span<const uint8_t> ciphertext) const noexcept {
+    uint8_t lengths[16];
+    store_be64(lengths, static_cast<uint64_t>(aad.size()) * 8);
+    store_be64(lengths + 8, static_cast<uint64_t>(ciphertext.size()) * 8);
+
+    AES128::Block result{};
+    if (kHardware) {
+        aes_ni::ghash(hash_key_.data(), aad, ciphertext, lengths, result.data());
+        return result;
+    }
+
+    const auto absorb = [&](std::span<const uint8_t> data) {
+        for (size_t offset = 0; offset < data.size(); offset += 16) {
+            const size_t take = std::min<size_t>(16, data.size() - offset);
+            for (size_t i = 0; i < take; ++i) {
+                result[i] ^= data[offset + i];
+            }
+            gf_multiply_table(hash_table_.data(), result.data());
+        }
+    };
+    absorb(aad);
+    absorb(ciphertext);
+    absorb(lengths);
+    return result;
+}
+
+bool AES128GCM::decrypt(std::span<const uint8_t, kNonceSize> nonce,
+                        std::span<const uint8_t> aad,
+                        std::span<const uint8_t> ciphertext,
+                        std::span<uint8_t> plaintext) const noexcept {
+    if (ciphertext.size() < kTagSize || plaintext.size() < ciphertext.size() - kTagSize) {
+        return false;
+    }
+    const size_t length = ciphertext.size() - kTagSize;
+    const auto body = ciphertext.first(length);
+
+    // 先校验标签，伪造或密钥不匹配的包不做 CTR 解密
+    AES128::Block counter = initial_counter(nonce);
+    AES128::Block tag = ghash(aad, body);
+    AES128::Block mask;
+    aes_.encrypt_block(counter.data(), mask.data());
+    uint8_t difference = 0;
+    for (size_t i = 0; i < kTagSize; ++i) {
+        difference |= static_cast<uint8_t>(tag[i] ^ mask[i] ^ ciphertext[length + i]);
+    }
+    if (difference != 0) {
+        return false;
+    }
+
+    if (length > 0 && plaintext.data() != body.data()) {
+        std::memmove(plaintext.data(), body.data(), length);
+    }
+    counter[15] = 2;
+    aes_.ctr32_xor(counter, plaintext.first(length));
+    return true;
+}
+
+void AES128GCM::encrypt(std::span<const uint8_t, kNonceSize> nonce,
+                        std::span<const uint8_t> aad,
+                        std::span<const uint8_t> plaintext,
+                        std::span<uint8_t> out) const noexcept {
+    const size_t length = plaintext.size();
+    if (out.size() < length + kTagSize) {
+        return;
+    }
+    if (length > 0 && out.data() != plaintext.data()) {
+        std::memmove(out.data(), plaintext.data(), length);
+    }
+
+    AES128::Block counter = initial_counter(nonce);
+    AES128::Block mask;
+    aes_.encrypt_block(counter.data(), mask.data());
+    counter[15] = 2;
+    aes_.ctr32_xor(counter, out.first(length));
+
+    const AES128::Block tag = ghash(aad, out.first(length));
+    for (size_t i = 0; i < kTagSize; ++i) {
+        out[length + i] = tag[i] ^ mask[i];
+    }
+}
+
+} // namespace protocol_parser::utils
@@ -0,0 +1,152 @@
+#include "utils/aes_gcm.hpp"
+#include <algorithm>
+#include <cstring>
+#include <immintrin.h>
+
+// AES-NI/PCLMULQDQ 路径单独成一个编译单元，只有这里以 -maes -mpclmul -msse4.1 编译，
+// 避免编译器在 aes_gcm.cpp 的可移植路径中也生成这些指令
+
+namespace protocol_parser::utils::aes_ni {
+
+namespace {
+    inline uint32_t byte_swap32(uint32_t value) noexcept {
+        return (value >> 24) | ((value >> 8) & 0xFF00) | ((value << 8) & 0xFF0000) | (value << 24);
+    }
+
+    inline uint32_t load_be32(const uint8_t* p) noexcept {
+        return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+               (static_cast<uint32_t>(p[2]) << 8) | p[3];
+    }
+
+    inline __m128i encrypt_block_ni(const __m128i* keys, __m128i block) noexcept {
+        block = _mm_xor_si128(block, keys[0]);
+        for (size_t round = 1; round < AES128::kRounds; ++round) {
+            block = _mm_aesenc_si128(block, keys[round]);
+        }
+        return _mm_aesenclast_si128(block, keys[AES128::kRounds]);
+    }
+
+    inline void load_round_keys(const uint8_t* round_keys, __m128i* keys) noexcept {
+        for (size_t i = 0; i <= AES128::kRounds; ++i) {
+            keys[i] = _mm_load_si128(reinterpret_cast<const __m128i*>(round_keys + i * 16));
+        }
+    }
+
+    // GF(2^128) 乘法（Intel 白皮书 "Carry-Less Multiplication and Its Usage for Computing the GCM Mode" 算法 5）
+    // 输入输出均为字节反转后的 GCM 表示
+    inline __m128i gf_multiply(__m128i a, __m128i b) noexcept {
+        __m128i low = _mm_clmulepi64_si128(a, b, 0x00);
+        __m128i middle = _mm_xor_si128(_mm_clmulepi64_si128(a, b, 0x10), _mm_clmulepi64_si128(a, b, 0x01));
+        __m128i high = _mm_clmulepi64_si128(a, b, 0x11);
+        low = _mm_xor_si128(low, _mm_slli_si128(middle, 8));
+        high = _mm_xor_si128(high, _mm_srli_si128(middle, 8));
+
+        // 整体左移 1 位（GCM 的位反射）
+        __m128i low_carry = _mm_srli_epi32(low, 31);
+        __m128i high_carry = _mm_srli_epi32(high, 31);
+        low = _mm_slli_epi32(low, 1);
+        high = _mm_slli_epi32(high, 1);
+        const __m128i cross = _mm_srli_si128(low_carry, 12);
+        high_carry = _mm_slli_si128(high_carry, 4);
+        low_carry = _mm_slli_si128(low_carry, 4);
+        low = _mm_or_si128(low, low_carry);
+        high = _mm_or_si128(_mm_or_si128(high, high_carry), cross);
+
+        // 模 x^128 + x^7 + x^2 + x + 1 约减
+        __m128i t = _mm_xor_si128(_mm_xor_si128(_mm_slli_epi32(low, 31), _mm_slli_epi32(low, 30)),
+                                  _mm_slli_epi32(low, 25));
+        const __m128i carry = _mm_srli_si128(t, 4);
+        t = _mm_slli_si128(t, 12);
+        low = _mm_xor_si128(low, t);
+        __m128i r = _mm_xor_si128(_mm_xor_si128(_mm_srli_epi32(low, 1), _mm_srli_epi32(low, 2)),
+                                  _mm_srli_epi32(low, 7));
+        r = _mm_xor_si128(r, carry);
+        low = _mm_xor_si128(low, r);
+        return _mm_xor_si128(high, low);
+    }
+
+    inline __m128i byte_reverse(__m128i value) noexcept {
+        return _mm_shuffle_epi8(value, _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+    }
+}
+
+void encrypt_block(const uint8_t* round_keys, const uint8_t* in, uint8_t* out) noexcept {
+    __m128i keys[AES128::kRounds + 1];
+    load_round_keys(round_keys, keys);
+    const __m128i block = encrypt_block_ni(keys, _mm_loadu_si128(reinterpret_cast<const __m128i*>(in)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), block);
+}
+
+void ctr32_xor(const uint8_t* round_keys, const AES128::Block& counter, std::span<uint8_t> data) noexcept {
+    uint32_t value = load_be32(counter.data() + 12);
+    uint8_t* p = data.data();
+    size_t remaining = data.size();
+
+    __m128i keys[AES128::kRounds + 1];
+    load_round_keys(round_keys, keys);
+    const __m128i base = _mm_loadu_si128(reinterpret_cast<const __m128i*>(counter.data()));
+    const auto counter_block = [&](uint32_t n) {
+        return _mm_insert_epi32(base, static_cast<int>(byte_swap32(n)), 3);
+    };
+
+    // 4 个分组交错，隐藏 AESENC 延迟
+    while (remaining >= 64) {
+        __m128i b0 = _mm_xor_si128(counter_block(value), keys[0]);
+        __m128i b1 = _mm_xor_si128(counter_block(value + 1), keys[0]);
+        __m128i b2 = _mm_xor_si128(counter_block(value + 2), keys[0]);
+        __m128i b3 = _mm_xor_si128(counter_block(value + 3), keys[0]);
+        for (size_t round = 1; round < AES128::kRounds; ++round) {
+            b0 = _mm_aesenc_si128(b0, keys[round]);
+            b1 = _mm_aesenc_si128(b1, keys[round]);
+            b2 = _mm_aesenc_si128(b2, keys[round]);
+            b3 = _mm_aesenc_si128(b3, keys[round]);
+        }
+        b0 = _mm_aesenclast_si128(b0, keys[AES128::kRounds]);
+        b1 = _mm_aesenclast_si128(b1, keys[AES128::kRounds]);
+        b2 = _mm_aesenclast_si128(b2, keys[AES128::kRounds]);
+        b3 = _mm_aesenclast_si128(b3, keys[AES128::kRounds]);
+
+        auto* out = reinterpret_cast<__m128i*>(p);
+        _mm_storeu_si128(out, _mm_xor_si128(_mm_loadu_si128(out), b0));
+        _mm_storeu_si128(out + 1, _mm_xor_si128(_mm_loadu_si128(out + 1), b1));
+        _mm_storeu_si128(out + 2, _mm_xor_si128(_mm_loadu_si128(out + 2), b2));
+        _mm_storeu_si128(out + 3, _mm_xor_si128(_mm_loadu_si128(out + 3), b3));
+        value += 4;
+        p += 64;
+        remaining -= 64;
+    }
+    while (remaining > 0) {
+        alignas(16) uint8_t stream[16];
+        _mm_store_si128(reinterpret_cast<__m128i*>(stream), encrypt_block_ni(keys, counter_block(value++)));
+        const size_t take = std::min<size_t>(remaining, 16);
+        for (size_t i = 0; i < take; ++i) {
+            p[i] ^= stream[i];
+        }
+        p += take;
+        remaining -= take;
+    }
+}
+
+void ghash(const uint8_t* hash_key, std::span<const uint8_t> aad, std::span<const uint8_t> ciphertext,
+           std::span<const uint8_t, 16> lengths, uint8_t* out) noexcept {
+    const __m128i h = byte_reverse(_mm_loadu_si128(reinterpret_cast<const __m128i*>(hash_key)));
+    __m128i x = _mm_setzero_si128();
+    const auto absorb = [&](std::span<const uint8_t> data) {
+        size_t offset = 0;
+        for (; offset + 16 <= data.size(); offset += 16) {
+            const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data.data() + offset));
+            x = gf_multiply(_mm_xor_si128(x, byte_reverse(block)), h);
+        }
+        if (offset < data.size()) {
+            alignas(16) uint8_t last[16] = {};
+            std::memcpy(last, data.data() + offset, data.size() - offset);
+            x = gf_multiply(_mm_xor_si128(x, byte_reverse(_mm_load_si128(reinterpret_cast<const __m128i*>(last)))), h);
+        }
+    };
+    absorb(aad);
+    absorb(ciphertext);
+    absorb(lengths);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), byte_reverse(x));
+}
+
+} // namespace protocol_parser::utils::aes_ni
@@ -0,0 +1,238 @@
+#include "utils/byte_statistics.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace protocol_parser::utils {
+
+namespace {
+    inline unsigned int popcount32(uint32_t value) {
+        #ifdef _MSC_VER
+            return static_cast<unsigned int>(__popcnt(value));
+        #else
+            return static_cast<unsigned int>(__builtin_popcount(value));
+        #endif
+    }
+
+    // 调用方保证 value != 0
+    inline unsigned int count_trailing_zeros(uint32_t value) {
+        #ifdef _MSC_VER
+            unsigned long index = 0;
+            _BitScanForward(&index, value);
+            return static_cast<unsigned int>(index);
+        #else
+            return static_cast<unsigned int>(__builtin_ctz(value));
+        #endif
+    }
+
+    // 调用方保证 value != 0
+    inline unsigned int count_leading_zeros(uint32_t value) {
+        #ifdef _MSC_VER
+            unsigned long index = 0;
+            _BitScanReverse(&index, value);
+            return 31u - static_cast<unsigned int>(index);
+        #else
+            return static_cast<unsigned int>(__builtin_clz(value));
+        #endif
+    }
+
+    // 掩码中最长连续 1 的长度
+    inline unsigned int longest_ones(uint32_t mask) {
+        unsigned int length = 0;
+        while (mask != 0) {
+            mask &= mask << 1;
+            ++length;
+        }
+        return length;
+    }
+
+    // 零字节游程跟踪器，按 32 字节块的零字节位掩码推进
+    struct ZeroRunTracker {
+        size_t current = 0;
+        size_t longest = 0;
+
+        void feed_block(uint32_t zero_mask) {
+            if (zero_mask == 0xFFFFFFFFu) {
+                current += 32;
+                return;
+            }
+            if (zero_mask == 0) {
+                longest = std::max(longest, current);
+                current = 0;
+                return;
+            }
+            // 块首的零字节延续上一块的游程
+            longest = std::max(longest, current + count_trailing_zeros(~zero_mask));
+            longest = std::max<size_t>(longest, longest_ones(zero_mask));
+            // 块尾的零字节延续到下一块
+            current = count_leading_zeros(~zero_mask);
+        }
+
+        void feed_byte(uint8_t byte) {
+            if (byte == 0) {
+                ++current;
+            } else {
+                longest = std::max(longest, current);
+                current = 0;
+            }
+        }
+
+        size_t finish() const { return std::max(longest, current); }
+    };
+
+    inline void classify_byte(uint8_t byte, ByteStatistics& out) {
+        if (byte == 0) {
+            out.null_count++;
+        } else if (byte >= 0x20 && byte <= 0x7E) {
+            out.printable_count++;
+        } else if (byte < 0x20 || byte == 0x7F) {
+            out.control_count++;
+        }
+    }
+
+    const std::array<double, ByteStatisticsKernel::kLog2TableSize>& n_log2_n_table() {
+        static const auto table = [] {
+            std::array<double, ByteStatisticsKernel::kLog2TableSize> t{};
+            for (uint32_t n = 1; n < ByteStatisticsKernel::kLog2TableSize; ++n) {
+                t[n] = n * std::log2(static_cast<double>(n));
+            }
+            return t;
+        }();
+        return table;
+    }
+}
+
+// ============================================================================
+// ByteStatistics
+// ============================================================================
+
+double ByteStatistics::entropy() const noexcept {
+    return ByteStatisticsKernel::entropy(histogram, total_bytes);
+}
+
+// ============================================================================
+// ByteStatisticsKernel
+// ============================================================================
+
+void ByteStatisticsKernel::compute(const uint8_t* data, size_t size, ByteStatistics& out) noexcept {
+    out = ByteStatistics{};
+    out.total_bytes = size;
+
+    if (data == nullptr || size == 0) {
+        return;
+    }
+
+    ZeroRunTracker zero_runs;
+
+    // 小包：逐字节同时累加直方图与分类计数
+    if (size < 64) {
+        for (size_t i = 0; i < size; ++i) {
+            out.histogram[data[i]]++;
+            classify_byte(data[i], out);
+            zero_runs.feed_byte(data[i]);
+        }
+        out.longest_zero_run = zero_runs.finish();
+        return;
+    }
+
+    // 大包：4 个子直方图交错累加，避免相邻相同字节的存储冲突；
+    // 直方图与分类计数、零字节游程在同一循环中完成，数据只读一遍
+    uint32_t sub[4][256];
+    std::memset(sub, 0, sizeof(sub));
+    const auto count_word = [&sub](const uint8_t* bytes) {
+        uint32_t word;
+        std::memcpy(&word, bytes, 4);
+        sub[0][word & 0xFF]++;
+        sub[1][(word >> 8) & 0xFF]++;
+        sub[2][(word >> 16) & 0xFF]++;
+        sub[3][word >> 24]++;
+    };
+
+    size_t i = 0;
+
+#ifdef __AVX2__
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i printable_base = _mm256_set1_epi8(0x20);
+    const __m256i printable_span = _mm256_set1_epi8(0x5E);   // 0x7E - 0x20
+    const __m256i control_base = _mm256_set1_epi8(0x01);
+    const __m256i control_span = _mm256_set1_epi8(0x1E);     // 0x1F - 0x01
+    const __m256i del = _mm256_set1_epi8(0x7F);
+
+    while (i + 32 <= size) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+
+        // 无符号区间判断：(v - base) <= span  <=>  min_epu8(v - base, span) == v - base
+        __m256i p = _mm256_sub_epi8(v, printable_base);
+        __m256i is_printable = _mm256_cmpeq_epi8(_mm256_min_epu8(p, printable_span), p);
+
+        __m256i c = _mm256_sub_epi8(v, control_base);
+        __m256i is_control = _mm256_or_si256(
+            _mm256_cmpeq_epi8(_mm256_min_epu8(c, control_span), c),
+            _mm256_cmpeq_epi8(v, del));
+
+        uint32_t null_mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, zero)));
+
+        out.printable_count += popcount32(static_cast<uint32_t>(_mm256_movemask_epi8(is_printable)));
+        out.control_count += popcount32(static_cast<uint32_t>(_mm256_movemask_epi8(is_control)));
+        out.null_count += popcount32(null_mask);
+        zero_runs.feed_block(null_mask);
+
+        // 同一块仍在 L1 中，直接累加直方图
+        for (size_t k = 0; k < 32; k += 4) {
+            count_word(data + i + k);
+        }
+
+        i += 32;
+    }
+#endif
+
+    for (; i + 4 <= size; i += 4) {
+        count_word(data + i);
+        for (size_t k = 0; k < 4; ++k) {
+            classify_byte(data[i + k], out);
+            zero_runs.feed_byte(data[i + k]);
+        }
+    }
+    for (; i < size; ++i) {
+        sub[0][data[i]]++;
+        classify_byte(data[i], out);
+        zero_runs.feed_byte(data[i]);
+    }
+
+    for (size_t b = 0; b < 256; ++b) {
+        out.histogram[b] = sub[0][b] + sub[1][b] + sub[2][b] + sub[3][b];
+    }
+
+    out.longest_zero_run = zero_runs.finish();
+}
+
+double ByteStatisticsKernel::n_log2_n(uint32_t n) noexcept {
+    if (n < kLog2TableSize) {
+        return n_log2_n_table()[n];
+    }
+    return n * std::log2(static_cast<double>(n));
+}
+
+double ByteStatisticsKernel::entropy(const std::array<uint32_t, 256>& histogram,
+                                     size_t total) noexcept {
+    if (total == 0) return 0.0;
+
+    double sum = 0.0;
+    for (uint32_t count : histogram) {
+        sum += n_log2_n(count);
+    }
+
+    const double n = static_cast<double>(total);
+    double result = std::log2(n) - sum / n;
+    return result > 0.0 ? result : 0.0;
+}
+
+} // namespace protocol_parser::utils
@@ -0,0 +1,295 @@
+#include "utils/digest.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+namespace protocol_parser::utils {
+
+namespace {
+    inline uint32_t load_le32(const uint8_t* p) noexcept {
+        return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+               (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+    }
+
+    inline uint32_t load_be32(const uint8_t* p) noexcept {
+        return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+               (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+    }
+
+    inline void store_be32(uint8_t* p, uint32_t v) noexcept {
+        p[0] = static_cast<uint8_t>(v >> 24);
+        p[1] = static_cast<uint8_t>(v >> 16);
+        p[2] = static_cast<uint8_t>(v >> 8);
+        p[3] = static_cast<uint8_t>(v);
+    }
+
+    // 共享的分块缓冲逻辑：凑满 64 字节调用一次压缩函数
+    template <typename Compress>
+    void absorb(std::array<uint8_t, 64>& block, uint64_t& total_bytes, std::span<const uint8_t> data,
+                Compress&& compress) noexcept {
+        size_t used = static_cast<size_t>(total_bytes % 64);
+        total_bytes += data.size();
+
+        size_t offset = 0;
+        if (used > 0) {
+            const size_t take = std::min(data.size(), 64 - used);
+            std::memcpy(block.data() + used, data.data(), take);
+            offset = take;
+            if (used + take < 64) {
+                return;
+            }
+            compress(block.data());
+        }
+        for (; offset + 64 <= data.size(); offset += 64) {
+            compress(data.data() + offset);
+        }
+        if (offset < data.size()) {
+            std::memcpy(block.data(), data.data() + offset, data.size() - offset);
+        }
+    }
+
+    constexpr std::array<uint32_t, 64> kMD5Sines = {
+        0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+        0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+        0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+        0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+        0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+        0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+        0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+        0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391,
+    };
+
+    constexpr std::array<uint8_t, 64> kMD5Shifts = {
+        7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
+        5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20,
+        4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
+        6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21,
+    };
+
+    constexpr std::array<uint32_t, 64> kSHA256Constants = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+    };
+}
+
+// ---------------------------------------------------------------------------
+// MD5
+// ---------------------------------------------------------------------------
+
+void MD5::reset() noexcept {
+    state_ = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476};
+    total_bytes_ = 0;
+}
+
+void MD5::compress(const uint8_t* block) noexcept {
+    uint32_t m[16];
+    for (size_t i = 0; i < 16; ++i) {
+        m[i] = load_le32(block + i * 4);
+    }
+
+    uint32_t a = state_[0], b = state_[1], c = state_[2], d = state_[3];
+    for (uint32_t i = 0; i < 64; ++i) {
+        uint32_t f;
+        uint32_t g;
+        if (i < 16) {
+            f = (b & c) | (~b & d);
+            g = i;
+        } else if (i < 32) {
+            f = (d & b) | (~d & c);
+            g = (5 * i + 1) & 15;
+        } else if (i < 48) {
+            f = b ^ c ^ d;
+            g = (3 * i + 5) & 15;
+        } else {
+            f = c ^ (b | ~d);
+            g = (7 * i) & 15;
+        }
+        const uint32_t rotated = std::rotl(a + f + kMD5Sines[i] + m[g], kMD5Shifts[i]);
+        a = d;
+        d = c;
+        c = b;
+        b += rotated;
+    }
+
+    state_[0] += a;
+    state_[1] += b;
+    state_[2] += c;
+    state_[3] += d;
+}
+
+void MD5::update(std::span<const uint8_t> data) noexcept {
+    absorb(block_, total_bytes_, data, [this](const uint8_t* block) { compress(block); });
+}
+
+MD5::Digest MD5::finalize() noexcept {
+    const uint64_t bit_length = total_bytes_ * 8;
+    static constexpr uint8_t kPadding[64] = {0x80};
+    const size_t used = static_cast<size_t>(total_bytes_ % 64);
+    update(std::span<const uint8_t>(kPadding, used < 56 ? 56 - used : 120 - used));
+
+    uint8_t length_bytes[8];
+    for (size_t i = 0; i < 8; ++i) {
+        length_bytes[i] = static_cast<uint8_t>(bit_length >> (8 * i));
+    }
+    update(length_bytes);
+
+    Digest digest;
+    for (size_t i = 0; i < 4; ++i) {
+        for (size_t k = 0; k < 4; ++k) {
+            digest[i * 4 + k] = static_cast<uint8_t>(state_[i] >> (8 * k));
+        }
+    }
+    return digest;
+}
+
+// ---------------------------------------------------------------------------
+// SHA-256
+// ---------------------------------------------------------------------------
+
+void SHA256::reset() noexcept {
+    state_ = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+    total_bytes_ = 0;
+}
+
+void SHA256::compress(const uint8_t* block) noexcept {
+    uint32_t w[64];
+    for (size_t i = 0; i < 16; ++i) {
+        w[i] = load_be32(block + i * 4);
+    }
+    for (size_t i = 16; i < 64; ++i) {
+        const uint32_t s0 = std::rotr(w[i - 15], 7) ^ std::rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        const uint32_t s1 = std::rotr(w[i - 2], 17) ^ std::rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = state_[0], b = state_[1], c = state_[2], d = state_[3];
+    uint32_t e = state_[4], f = state_[5], g = state_[6], h = state_[7];
+    for (size_t i = 0; i < 64; ++i) {
+        const uint32_t s1 = std::rotr(e, 6) ^ std::rotr(e, 11) ^ std::rotr(e, 25);
+        const uint32_t choose = (e & f) ^ (~e & g);
+        const uint32_t t1 = h + s1 + choose + kSHA256Constants[i] + w[i];
+        const uint32_t s0 = std::rotr(a, 2) ^ std::rotr(a, 13) ^ std::rotr(a, 22);
+        const uint32_t majority = (a & b) ^ (a & c) ^ (b & c);
+        const uint32_t t2 = s0 + majority;
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+
+    state_[0] += a;
+    state_[1] += b;
+    state_[2] += c;
+    state_[3] += d;
+    state_[4] += e;
+    state_[5] += f;
+    state_[6] += g;
+    state_[7] += h;
+}
+
+void SHA256::update(std::span<const uint8_t> data) noexcept {
+    absorb(block_, total_bytes_, data, [this](const uint8_t* block) { compress(block); });
+}
+
+SHA256::Digest SHA256::finalize() noexcept {
+    const uint64_t bit_length = total_bytes_ * 8;
+    static constexpr uint8_t kPadding[64] = {0x80};
+    const size_t used = static_cast<size_t>(total_bytes_ % 64);
+    update(std::span<const uint8_t>(kPadding, used < 56 ? 56 - used : 120 - used));
+
+    uint8_t length_bytes[8];
+    for (size_t i = 0; i < 8; ++i) {
+        length_bytes[i] = static_cast<uint8_t>(bit_length >> (56 - 8 * i));
+    }
+    update(length_bytes);
+
+    Digest digest;
+    for (size_t i = 0; i < 8; ++i) {
+        store_be32(digest.data() + i * 4, state_[i]);
+    }
+    return digest;
+}
+
+// ---------------------------------------------------------------------------
+// HMAC-SHA256 / HKDF
+// ---------------------------------------------------------------------------
+
+HMACSHA256::HMACSHA256(std::span<const uint8_t> key) noexcept {
+    // 长于分组的密钥先做哈希
+    std::array<uint8_t, SHA256::kBlockSize> block{};
+    if (key.size() > SHA256::kBlockSize) {
+        const auto digest = SHA256::hash(key);
+        std::copy(digest.begin(), digest.end(), block.begin());
+    } else {
+        std::copy(key.begin(), key.end(), block.begin());
+    }
+
+    std::array<uint8_t, SHA256::kBlockSize> pad;
+    for (size_t i = 0; i < pad.size(); ++i) {
+        pad[i] = block[i] ^ 0x36;
+    }
+    inner_.update(pad);
+    for (size_t i = 0; i < pad.size(); ++i) {
+        pad[i] = block[i] ^ 0x5C;
+    }
+    outer_.update(pad);
+}
+
+SHA256::Digest HMACSHA256::finalize() noexcept {
+    const auto inner = inner_.finalize();
+    outer_.update(inner);
+    return outer_.finalize();
+}
+
+SHA256::Digest hkdf_extract(std::span<const uint8_t> salt, std::span<const uint8_t> ikm) noexcept {
+    return HMACSHA256::mac(salt, ikm);
+}
+
+bool hkdf_expand(std::span<const uint8_t> prk, std::span<const uint8_t> info, std::span<uint8_t> out) noexcept {
+    if (out.size() > 255 * SHA256::kDigestSize) {
+        return false;
+    }
+
+    // T(i) = HMAC(PRK, T(i-1) | info | i)
+    SHA256::Digest block{};
+    size_t written = 0;
+    for (uint8_t counter = 1; written < out.size(); ++counter) {
+        HMACSHA256 hmac(prk);
+        if (counter > 1) {
+            hmac.update(block);
+        }
+        hmac.update(info);
+        hmac.update(std::span<const uint8_t>(&counter, 1));
+        block = hmac.finalize();
+
+        const size_t take = std::min(block.size(), out.size() - written);
+        std::copy_n(block.begin(), take, out.begin() + written);
+        written += take;
+    }
+    return true;
+}
+
+size_t to_hex(std::span<const uint8_t> data, std::span<char> out) noexcept {
+    static constexpr char kHexDigits[] = "0123456789abcdef";
+    size_t written = 0;
+    for (const uint8_t byte : data) {
+        if (written + 2 > out.size()) {
+            break;
+        }
+        out[written++] = kHexDigits[byte >> 4];
+        out[written++] = kHexDigits[byte & 0x0F];
+    }
+    return written;
+}
+
+} // namespace protocol_parser::utils
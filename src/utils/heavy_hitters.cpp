@@ -0,0 +1,182 @@
+#include "utils/heavy_hitters.hpp"
+#include <algorithm>
+#include <bit>
+#include <functional>
+
+namespace protocol_parser::utils {
+
+namespace {
+    inline uint64_t mix64(uint64_t value) noexcept {
+        value ^= value >> 33;
+        value *= 0xff51afd7ed558ccdULL;
+        value ^= value >> 33;
+        value *= 0xc4ceb9fe1a85ec53ULL;
+        value ^= value >> 33;
+        return value;
+    }
+
+    inline uint64_t hash_key(std::string_view key) noexcept {
+        return mix64(std::hash<std::string_view>{}(key));
+    }
+}
+
+HeavyHitterSketch::HeavyHitterSketch(size_t capacity, size_t max_key_length)
+    : max_key_length_(std::max<size_t>(max_key_length, 1)) {
+    capacity = std::clamp<size_t>(capacity, 1, kEmpty - 1);
+    entries_.resize(capacity);
+    hashes_.resize(capacity);
+    heap_.reserve(capacity);
+    heap_position_.resize(capacity);
+    // 负载不超过 1/2
+    slots_.resize(std::bit_ceil(std::max<size_t>(capacity * 2, 16)));
+    mask_ = slots_.size() - 1;
+}
+
+void HeavyHitterSketch::clear() noexcept {
+    for (auto& entry : entries_) {
+        entry.key.clear();
+        entry.count = 0;
+        entry.error = 0;
+    }
+    std::fill(slots_.begin(), slots_.end(), Slot{});
+    heap_.clear();
+    size_ = 0;
+    total_ = 0;
+}
+
+size_t HeavyHitterSketch::find_slot(std::string_view key, uint64_t hash) const noexcept {
+    for (size_t index = hash & mask_;; index = (index + 1) & mask_) {
+        const Slot& slot = slots_[index];
+        if (slot.entry == kEmpty) {
+            return slots_.size();
+        }
+        if (slot.hash == hash && entries_[slot.entry].key == key) {
+            return index;
+        }
+    }
+}
+
+void HeavyHitterSketch::insert_slot(uint64_t hash, uint32_t entry) noexcept {
+    size_t index = hash & mask_;
+    while (slots_[index].entry != kEmpty) {
+        index = (index + 1) & mask_;
+    }
+    slots_[index] = Slot{hash, entry};
+}
+
+void HeavyHitterSketch::erase_slot(size_t index) noexcept {
+    // 后移删除，不留墓碑
+    size_t hole = index;
+    for (size_t next = (hole + 1) & mask_; slots_[next].entry != kEmpty; next = (next + 1) & mask_) {
+        const size_t home = slots_[next].hash & mask_;
+        // home 循环落在 (hole, next] 内的条目保持不动
+        const bool stays = (hole <= next) ? (home > hole && home <= next) : (home > hole || home <= next);
+        if (!stays) {
+            slots_[hole] = slots_[next];
+            hole = next;
+        }
+    }
+    slots_[hole] = Slot{};
+}
+
+void HeavyHitterSketch::sift_down(size_t position) noexcept {
+    const size_t count = heap_.size();
+    const uint32_t item = heap_[position];
+    const uint64_t value = entries_[item].count;
+    for (;;) {
+        size_t child = 2 * position + 1;
+        if (child >= count) {
+            break;
+        }
+        if (child + 1 < count && entries_[heap_[child + 1]].count < entries_[heap_[child]].count) {
+            ++child;
+        }
+        if (entries_[heap_[child]].count >= value) {
+            break;
+        }
+        heap_[position] = heap_[child];
+        heap_position_[heap_[position]] = static_cast<uint32_t>(position);
+        position = child;
+    }
+    heap_[position] = item;
+    heap_position_[item] = static_cast<uint32_t>(position);
+}
+
+void HeavyHitterSketch::sift_up(size_t position) noexcept {
+    const uint32_t item = heap_[position];
+    const uint64_t value = entries_[item].count;
+    while (position > 0) {
+        const size_t parent = (position - 1) / 2;
+        if (entries_[heap_[parent]].count <= value) {
+            break;
+        }
+        heap_[position] = heap_[parent];
+        heap_position_[heap_[position]] = static_cast<uint32_t>(position);
+        position = parent;
+    }
+    heap_[position] = item;
+    heap_position_[item] = static_cast<uint32_t>(position);
+}
+
+void HeavyHitterSketch::add(std::string_view key, uint64_t weight) {
+    if (weight == 0) {
+        return;
+    }
+    key = clamp(key);
+    total_ += weight;
+
+    const uint64_t hash = hash_key(key);
+    const size_t slot = find_slot(key, hash);
+    if (slot != slots_.size()) {
+        const uint32_t entry = slots_[slot].entry;
+        entries_[entry].count += weight;
+        sift_down(heap_position_[entry]);
+        return;
+    }
+
+    if (size_ < entries_.size()) {
+        const auto entry = static_cast<uint32_t>(size_++);
+        entries_[entry].key.assign(key);
+        entries_[entry].count = weight;
+        entries_[entry].error = 0;
+        hashes_[entry] = hash;
+        insert_slot(hash, entry);
+        heap_.push_back(entry);
+        sift_up(heap_.size() - 1);
+        return;
+    }
+
+    // 顶替计数最小的项；被顶替项的计数成为新键的误差
+    const uint32_t victim = heap_.front();
+    Entry& entry = entries_[victim];
+    erase_slot(find_slot(entry.key, hashes_[victim]));
+    entry.key.assign(key);
+    entry.error = entry.count;
+    entry.count += weight;
+    hashes_[victim] = hash;
+    insert_slot(hash, victim);
+    sift_down(0);
+}
+
+uint64_t HeavyHitterSketch::estimate(std::string_view key) const noexcept {
+    key = clamp(key);
+    const size_t slot = find_slot(key, hash_key(key));
+    return slot != slots_.size() ? entries_[slots_[slot].entry].count : 0;
+}
+
+std::vector<HeavyHitterSketch::Entry> HeavyHitterSketch::top(size_t k) const {
+    std::vector<uint32_t> order(heap_.begin(), heap_.end());
+    k = std::min(k, order.size());
+    std::partial_sort(order.begin(), order.begin() + k, order.end(), [this](uint32_t a, uint32_t b) {
+        return entries_[a].count > entries_[b].count;
+    });
+
+    std::vector<Entry> result;
+    result.reserve(k);
+    for (size_t i = 0; i < k; ++i) {
+        result.push_back(entries_[order[i]]);
+    }
+    return result;
+}
+
+} // namespace protocol_parser::utils
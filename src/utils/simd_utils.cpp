@@ -1,6 +1,10 @@
 #include "utils/simd_utils.hpp"
 #include <algorithm>
+#ifdef _MSC_VER
 #include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
 
 namespace protocol_parser::utils {
 
@@ -41,6 +45,27 @@ namespace {
             return static_cast<unsigned int>(__builtin_ctzll(value));
         #endif
     }
+
+    bool detect_avx2() noexcept {
+    #ifdef _MSC_VER
+        int cpui[4];
+        __cpuid(cpui, 7);
+        return (cpui[1] & (1 << 5)) != 0;
+    #else
+        unsigned int eax, ebx, ecx, edx;
+        return __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) && (ebx & (1 << 5)) != 0;
+    #endif
+    }
+
+    const bool kHasAVX2 = detect_avx2();
+
+    // UTF-8 序列长度（按首字节）；非法首字节返回 1，交由校验报错
+    inline uint8_t utf8_sequence_length(uint8_t lead) noexcept {
+        if (lead >= 0xF0) return 4;
+        if (lead >= 0xE0) return 3;
+        if (lead >= 0xC0) return 2;
+        return 1;
+    }
 }
 
 // ============================================================================
@@ -413,4 +438,263 @@ size_t SIMDUtils::find_multi_pattern_avx2(const uint8_t* data,
     return SIZE_MAX;
 }
 
+// ============================================================================
+// 掩码与 UTF-8 校验
+// ============================================================================
+
+size_t SIMDUtils::xor_mask(uint8_t* dst, const uint8_t* src, size_t size, uint32_t mask, size_t phase) noexcept {
+    // 把掩码旋转到 phase 对齐，之后每个 4 的倍数块都从掩码第 0 字节开始
+    const uint8_t key[4] = {
+        static_cast<uint8_t>(mask >> 24), static_cast<uint8_t>(mask >> 16),
+        static_cast<uint8_t>(mask >> 8), static_cast<uint8_t>(mask),
+    };
+    uint8_t rotated[8];
+    for (size_t i = 0; i < 8; ++i) {
+        rotated[i] = key[(phase + i) & 3];
+    }
+
+    size_t i = 0;
+    if (kHasAVX2 && size >= 32) {
+        int32_t word;
+        std::memcpy(&word, rotated, sizeof(word));
+        const __m256i vmask = _mm256_set1_epi32(word);
+        for (; i + 32 <= size; i += 32) {
+            const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_xor_si256(block, vmask));
+        }
+    }
+
+    uint64_t mask64;
+    std::memcpy(&mask64, rotated, sizeof(mask64));
+    for (; i + 8 <= size; i += 8) {
+        uint64_t block;
+        std::memcpy(&block, src + i, sizeof(block));
+        block ^= mask64;
+        std::memcpy(dst + i, &block, sizeof(block));
+    }
+    for (; i < size; ++i) {
+        dst[i] = src[i] ^ rotated[i & 3];
+    }
+    return (phase + size) & 3;
+}
+
+bool SIMDUtils::validate_utf8(const uint8_t* data, size_t size) noexcept {
+    if (kHasAVX2 && size >= 32) {
+        return validate_utf8_avx2(data, size);
+    }
+    return validate_utf8_scalar(data, size);
+}
+
+bool SIMDUtils::validate_utf8_scalar(const uint8_t* data, size_t size) noexcept {
+    size_t i = 0;
+    while (i < size) {
+        // 8 字节一组跳过 ASCII
+        if (i + 8 <= size) {
+            uint64_t word;
+            std::memcpy(&word, data + i, sizeof(word));
+            if ((word & 0x8080808080808080ULL) == 0) {
+                i += 8;
+                continue;
+            }
+        }
+
+        const uint8_t lead = data[i];
+        if (lead < 0x80) {
+            ++i;
+            continue;
+        }
+
+        // RFC 3629 第 4 节：第二字节的合法范围取决于首字节
+        size_t length;
+        uint8_t low = 0x80, high = 0xBF;
+        if (lead >= 0xC2 && lead <= 0xDF) {
+            length = 2;
+        } else if (lead >= 0xE0 && lead <= 0xEF) {
+            length = 3;
+            if (lead == 0xE0) low = 0xA0;        // 过长编码
+            else if (lead == 0xED) high = 0x9F;  // 代理项 U+D800-DFFF
+        } else if (lead >= 0xF0 && lead <= 0xF4) {
+            length = 4;
+            if (lead == 0xF0) low = 0x90;        // 过长编码
+            else if (lead == 0xF4) high = 0x8F;  // U+10FFFF 以上
+        } else {
+            return false;
+        }
+
+        if (length > size - i || data[i + 1] < low || data[i + 1] > high) {
+            return false;
+        }
+        for (size_t k = 2; k < length; ++k) {
+            if ((data[i + k] & 0xC0) != 0x80) {
+                return false;
+            }
+        }
+        i += length;
+    }
+    return true;
+}
+
+namespace {
+    // 前一块末尾 N 字节与当前块拼接后的错位视图
+    template <int N>
+    inline __m256i prev_bytes(__m256i input, __m256i previous) noexcept {
+        return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(previous, input, 0x21), 16 - N);
+    }
+
+    inline __m256i high_nibbles(__m256i value) noexcept {
+        return _mm256_and_si256(_mm256_srli_epi16(value, 4), _mm256_set1_epi8(0x0F));
+    }
+
+    // 错误位（Keiser & Lemire, "Validating UTF-8 In Less Than One Instruction Per Byte"）
+    constexpr uint8_t kTooShort = 1 << 0;      // 首字节后缺少后续字节
+    constexpr uint8_t kTooLong = 1 << 1;       // ASCII 后出现后续字节
+    constexpr uint8_t kOverlong3 = 1 << 2;
+    constexpr uint8_t kTooLarge = 1 << 3;
+    constexpr uint8_t kSurrogate = 1 << 4;
+    constexpr uint8_t kOverlong2 = 1 << 5;
+    constexpr uint8_t kTooLarge1000 = 1 << 6;
+    constexpr uint8_t kOverlong4 = 1 << 6;
+    constexpr uint8_t kTwoConts = 1 << 7;      // 连续两个后续字节（只在 3/4 字节序列中合法）
+    constexpr uint8_t kCarry = kTooShort | kTooLong | kTwoConts;
+
+    inline __m256i table16(uint8_t v0, uint8_t v1, uint8_t v2, uint8_t v3, uint8_t v4, uint8_t v5,
+                           uint8_t v6, uint8_t v7, uint8_t v8, uint8_t v9, uint8_t v10, uint8_t v11,
+                           uint8_t v12, uint8_t v13, uint8_t v14, uint8_t v15) noexcept {
+        return _mm256_setr_epi8(
+            static_cast<char>(v0), static_cast<char>(v1), static_cast<char>(v2), static_cast<char>(v3),
+            static_cast<char>(v4), static_cast<char>(v5), static_cast<char>(v6), static_cast<char>(v7),
+            static_cast<char>(v8), static_cast<char>(v9), static_cast<char>(v10), static_cast<char>(v11),
+            static_cast<char>(v12), static_cast<char>(v13), static_cast<char>(v14), static_cast<char>(v15),
+            static_cast<char>(v0), static_cast<char>(v1), static_cast<char>(v2), static_cast<char>(v3),
+            static_cast<char>(v4), static_cast<char>(v5), static_cast<char>(v6), static_cast<char>(v7),
+            static_cast<char>(v8), static_cast<char>(v9), static_cast<char>(v10), static_cast<char>(v11),
+            static_cast<char>(v12), static_cast<char>(v13), static_cast<char>(v14), static_cast<char>(v15));
+    }
+
+    struct UTF8Block {
+        __m256i error = _mm256_setzero_si256();
+        __m256i previous = _mm256_setzero_si256();
+        __m256i previous_incomplete = _mm256_setzero_si256();
+
+        void check(__m256i input) noexcept {
+            if (_mm256_movemask_epi8(input) == 0) {
+                // 纯 ASCII：只需确认上一块没有停在序列中间
+                error = _mm256_or_si256(error, previous_incomplete);
+                previous = input;
+                return;
+            }
+
+            // 由 (前一字节高半字节, 前一字节低半字节, 当前字节高半字节) 三次查表得出的错误位取交集
+            const __m256i prev1 = prev_bytes<1>(input, previous);
+            const __m256i byte_1_high = _mm256_shuffle_epi8(table16(
+                kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong,
+                kTwoConts, kTwoConts, kTwoConts, kTwoConts,
+                kTooShort | kOverlong2,
+                kTooShort,
+                kTooShort | kOverlong3 | kSurrogate,
+                kTooShort | kTooLarge | kTooLarge1000 | kOverlong4), high_nibbles(prev1));
+            const __m256i byte_1_low = _mm256_shuffle_epi8(table16(
+                kCarry | kOverlong3 | kOverlong2 | kOverlong4,
+                kCarry | kOverlong2,
+                kCarry,
+                kCarry,
+                kCarry | kTooLarge,
+                kCarry | kTooLarge | kTooLarge1000,
+                kCarry | kTooLarge | kTooLarge1000,
+                kCarry | kTooLarge | kTooLarge1000,
+                kCarry | kTooLarge | kTooLarge1000,
+                kCarry | kTooLarge | kTooLarge1000,
+                kCarry | kTooLarge | kTooLarge1000,
+                kCarry | kTooLarge | kTooLarge1000,
+                kCarry | kTooLarge | kTooLarge1000,
+                kCarry | kTooLarge | kTooLarge1000 | kSurrogate,
+                kCarry | kTooLarge | kTooLarge1000,
+                kCarry | kTooLarge | kTooLarge1000), _mm256_and_si256(prev1, _mm256_set1_epi8(0x0F)));
+            const __m256i byte_2_high = _mm256_shuffle_epi8(table16(
+                kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort,
+                kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge1000 | kOverlong4,
+                kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge,
+                kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,
+                kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,
+                kTooShort, kTooShort, kTooShort, kTooShort), high_nibbles(input));
+            const __m256i special = _mm256_and_si256(_mm256_and_si256(byte_1_high, byte_1_low), byte_2_high);
+
+            // 3/4 字节序列的第 3、4 字节必须是后续字节，恰好抵消 kTwoConts
+            const __m256i is_third = _mm256_subs_epu8(prev_bytes<2>(input, previous), _mm256_set1_epi8(0xE0 - 0x80));
+            const __m256i is_fourth = _mm256_subs_epu8(prev_bytes<3>(input, previous), _mm256_set1_epi8(0xF0 - 0x80));
+            const __m256i must_be_continuation = _mm256_and_si256(_mm256_or_si256(is_third, is_fourth),
+                                                                  _mm256_set1_epi8(static_cast<char>(0x80)));
+            error = _mm256_or_si256(error, _mm256_xor_si256(must_be_continuation, special));
+
+            // 块末尾 3 字节内的多字节首字节意味着序列延续到下一块
+            const __m256i max_value = _mm256_setr_epi8(
+                -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                static_cast<char>(0xF0 - 1), static_cast<char>(0xE0 - 1), static_cast<char>(0xC0 - 1));
+            previous_incomplete = _mm256_subs_epu8(input, max_value);
+            previous = input;
+        }
+    };
+}
+
+bool SIMDUtils::validate_utf8_avx2(const uint8_t* data, size_t size) noexcept {
+    UTF8Block state;
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        state.check(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)));
+    }
+    if (i < size) {
+        // 尾部补零：0 是 ASCII，停在序列中间会被判为 kTooShort
+        alignas(32) uint8_t tail[32] = {};
+        std::memcpy(tail, data + i, size - i);
+        state.check(_mm256_load_si256(reinterpret_cast<const __m256i*>(tail)));
+    }
+    const __m256i error = _mm256_or_si256(state.error, state.previous_incomplete);
+    return _mm256_testz_si256(error, error) != 0;
+}
+
+bool UTF8Validator::update(const uint8_t* data, size_t size) noexcept {
+    if (!valid_) {
+        return false;
+    }
+
+    // 先补全上一段留下的序列
+    size_t offset = 0;
+    if (pending_size_ > 0) {
+        while (pending_size_ < pending_need_ && offset < size) {
+            pending_[pending_size_++] = data[offset++];
+        }
+        if (pending_size_ < pending_need_) {
+            return true;
+        }
+        valid_ = SIMDUtils::validate_utf8(pending_.data(), pending_size_);
+        pending_size_ = 0;
+        if (!valid_) {
+            return false;
+        }
+    }
+
+    // 末尾 3 字节内若有未完整的多字节序列，留到下一段
+    size_t end = size;
+    for (size_t back = 1; back <= 3 && back <= size - offset; ++back) {
+        const uint8_t byte = data[size - back];
+        if ((byte & 0xC0) == 0x80) {
+            continue;
+        }
+        const uint8_t need = utf8_sequence_length(byte);
+        if (need > back) {
+            end = size - back;
+            pending_need_ = need;
+        }
+        break;
+    }
+
+    valid_ = SIMDUtils::validate_utf8(data + offset, end - offset);
+    if (valid_ && end < size) {
+        pending_size_ = static_cast<uint8_t>(size - end);
+        std::memcpy(pending_.data(), data + end, pending_size_);
+    }
+    return valid_;
+}
+
 } // namespace protocol_parser::utils